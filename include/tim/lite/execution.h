@@ -26,6 +26,7 @@
 #define TIM_LITE_EXECUTION_H_
 
 #include <cstdint>
+#include <string>
 #include <vector>
 #include <memory>
 #include "tim/lite/handle.h"
@@ -37,6 +38,12 @@ class Execution {
  public:
   static std::shared_ptr<Execution> Create(const void* executable,
                                            size_t executable_size);
+  /// Load the executable from `path` without reading it into the heap: the
+  /// driver loads the file itself if it can, or gets a read-only mapping
+  static std::shared_ptr<Execution> CreateFromFile(const std::string& path);
+  /// New Execution on the same prepared network, with its own bindings.
+  /// Triggers of the Executions sharing a network are serialized.
+  virtual std::shared_ptr<Execution> Fork() = 0;
   virtual std::shared_ptr<Handle> CreateInputHandle(uint32_t in_idx,
                                                     uint8_t* buffer,
                                                     size_t size) = 0;
@@ -50,6 +57,12 @@ class Execution {
   virtual Execution& UnBindInput(const std::shared_ptr<Handle>& Handle) = 0;
   virtual Execution& UnBindOutput(const std::shared_ptr<Handle>& handle) = 0;
   virtual bool Trigger() = 0;
+  /// Start the network on the bound handles without waiting for it. One
+  /// submission may be pending per Execution, Wait() before the next one
+  /// and before changing the bindings.
+  virtual bool Submit() = 0;
+  /// Wait for the pending Submit(), false if there is none or it failed
+  virtual bool Wait() = 0;
 };
 
 }  // namespace lite
@@ -0,0 +1,71 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_LITE_HANDLE_RING_H_
+#define TIM_LITE_HANDLE_RING_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tim/lite/execution.h"
+
+namespace tim {
+namespace lite {
+
+/// Pre-created input and output handles for frames in flight on one Execution
+///
+/// A producer Acquire()s a free slot, fills its input buffers and Submit()s
+/// it; a consumer Wait()s for slots in submission order, reads the outputs
+/// and Release()s the slot. The next submitted slot is started as soon as the
+/// previous one finishes, so frame N+1 is filled while frame N executes.
+class HandleRing {
+ public:
+  virtual ~HandleRing() {}
+
+  /// `depth` slots with 64 bytes aligned buffers of the given sizes for each
+  /// input and output of `execution`. Return nullptr if a handle can not be
+  /// created.
+  static std::shared_ptr<HandleRing> Create(
+      const std::shared_ptr<Execution>& execution,
+      const std::vector<size_t>& input_sizes,
+      const std::vector<size_t>& output_sizes, uint32_t depth);
+
+  virtual uint32_t Depth() const = 0;
+  virtual uint8_t* InputBuffer(uint32_t slot, uint32_t in_idx) = 0;
+  virtual uint8_t* OutputBuffer(uint32_t slot, uint32_t out_idx) = 0;
+
+  /// Take a free slot, block while all of them are in use
+  virtual uint32_t Acquire() = 0;
+  /// Flush the inputs of `slot` and queue it for execution
+  virtual bool Submit(uint32_t slot) = 0;
+  /// Wait for the oldest submitted slot, with its outputs invalidated.
+  /// Return -1 if nothing is submitted; `ok` is false if the run failed.
+  virtual int32_t Wait(bool* ok = nullptr) = 0;
+  /// Give a slot returned by Wait() back to the producer
+  virtual void Release(uint32_t slot) = 0;
+};
+
+}  // namespace lite
+}  // namespace tim
+#endif
@@ -0,0 +1,130 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_CALIBRATION_H_
+#define TIM_CALIBRATION_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "tim/vx/types.h"
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+    class Tensor;
+}
+
+namespace transform {
+
+/// How the range of an activation is chosen from the calibration values
+enum class CalibrationMethod {
+  /// Smallest and largest value seen
+  MIN_MAX,
+  /// Clip the `percentile` share of values at each end of the distribution
+  PERCENTILE,
+  /// Symmetric threshold minimizing the KL divergence of the int8 histogram
+  KL_DIVERGENCE,
+};
+
+struct CalibrationOptions {
+  /// UINT8 or INT8, asymmetric per tensor
+  vx::DataType data_type{vx::DataType::UINT8};
+  CalibrationMethod method{CalibrationMethod::MIN_MAX};
+  /// Share of the values, in percent, kept inside the range by PERCENTILE
+  float percentile{99.99f};
+  /// Quantize the weights of Conv2d, GroupedConv2d and FullyConnected to
+  /// int8 SYMMETRIC_PER_CHANNEL, bias to int32 per channel
+  bool per_channel_weights{false};
+  /// Keep float32 graph inputs and outputs, converted with DataConvert
+  bool float_io{true};
+  /// Histogram bins per tensor, at least 256
+  uint32_t histogram_bins{2048};
+};
+
+/// Range of real values mapped to the quantized type
+struct TensorRange {
+  float min{0};
+  float max{0};
+};
+
+/**
+ * @brief post-training quantization of a float32 graph
+ *
+ * @detail
+ *   Feed() runs a copy of the source graph, where every float32 tensor is an
+ *   output, on one calibration sample and records the values of each
+ *   tensor. Quantize() then clones the source graph with quantized tensors:
+ *   activations get the range chosen by the calibration method, constant
+ *   weights the range of their data, and the bias of Conv2d, DeConv2d,
+ *   GroupedConv2d and FullyConnected int32 with the product of the input and
+ *   weight scales. Tensors which are not float32 are kept as they are.
+ *
+ *   The source graph is compiled by the first Feed().
+ */
+class Calibrator {
+ public:
+  virtual ~Calibrator() {}
+
+  static std::shared_ptr<Calibrator> Create(
+      const std::shared_ptr<vx::Graph>& float_graph,
+      const std::shared_ptr<vx::Context>& ctx,
+      const CalibrationOptions& options = CalibrationOptions());
+
+  /// Run one sample, a float vector per input of the source graph in order
+  virtual bool Feed(const std::vector<std::vector<float>>& inputs) = 0;
+
+  /// Record values of a source graph tensor computed elsewhere, e.g. by the
+  /// framework the model comes from
+  virtual bool Observe(const std::shared_ptr<vx::Tensor>& tensor,
+                       const float* data, size_t count) = 0;
+
+  /// Number of successful Feed() calls
+  virtual uint32_t SampleCount() const = 0;
+
+  /// Range chosen for a non constant tensor of the source graph, false if
+  /// no value of it was recorded
+  virtual bool GetRange(const std::shared_ptr<vx::Tensor>& tensor,
+                        TensorRange* range) const = 0;
+
+  /**
+   * @brief clone the source graph with quantized tensors
+   *
+   * @return quantized graph and the mapping from source graph tensors to its
+   *   tensors, empty if a float32 tensor has no recorded range. With
+   *   `float_io` the graph inputs and outputs map to float32 tensors.
+   */
+  virtual std::pair<
+      std::shared_ptr<vx::Graph>,
+      std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+  Quantize(std::shared_ptr<vx::Context>& ctx) = 0;
+};
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
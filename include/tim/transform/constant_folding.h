@@ -0,0 +1,74 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_CONSTANT_FOLDING_H_
+#define TIM_CONSTANT_FOLDING_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+    class Tensor;
+}
+
+namespace transform {
+
+/// Operations evaluated on the host and the bytes of constant data bound to
+/// the graph before and after, the difference is what the folding saved
+struct ConstantFoldingReport {
+  uint32_t folded_op_count{0};
+  uint64_t constant_bytes_before{0};
+  uint64_t constant_bytes_after{0};
+};
+
+/**
+ * @brief evaluate operations whose inputs are all CONSTANT on the host
+ *
+ * @detail
+ *   Reshape, Transpose, DataConvert and the binary Add/Sub/Multiply/Div/
+ *   Minimum/Maximum are evaluated when all their inputs are constant, or
+ *   folded, and their output is TRANSIENT. The output becomes a constant
+ *   tensor of the folded graph, which owns its data.
+ *
+ *   A BatchNorm consuming a float Conv2d with constant weights is folded into
+ *   the weights and bias of the Conv2d.
+ *
+ * @param report optional, folded op count and constant bytes
+ * @return folded graph and the mapping from src_graph tensors to its tensors,
+ *   tensors folded away are not in the mapping
+ */
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+ConstantFolding(const std::shared_ptr<vx::Graph>& src_graph,
+                std::shared_ptr<vx::Context>& ctx,
+                ConstantFoldingReport* report = nullptr);
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -24,7 +24,9 @@
 #ifndef TIM_LAYOUT_INFERENCE_H_
 #define TIM_LAYOUT_INFERENCE_H_
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 
 
@@ -38,6 +40,28 @@ namespace vx {
 }
 
 namespace transform {
+
+/// How the Transpose operations inserted by layout inference are optimized
+enum class TransposeOptimization {
+  /// Keep the transposes as inserted for each operation
+  NONE,
+  /// Merge adjacent transposes, drop identity ones and push transposes
+  /// through single elementwise operations
+  LOCAL,
+  /// LOCAL, then pick the layout of every connected region of elementwise
+  /// operations which minimizes the total bytes transposed
+  GLOBAL,
+};
+
+/// Transposes in the inferred graph before and after the optimization;
+/// bytes only cover transposes whose input shape is known
+struct LayoutInferenceReport {
+  uint32_t transpose_count_before{0};
+  uint32_t transpose_count_after{0};
+  uint64_t transpose_bytes_before{0};
+  uint64_t transpose_bytes_after{0};
+};
+
 std::pair<
     /*graph after layout inference*/
     std::shared_ptr<vx::Graph>,
@@ -49,6 +73,14 @@ std::pair<
 LayoutInference(const std::shared_ptr<vx::Graph>& src_graph,
                 std::shared_ptr<vx::Context>& ctx);
 
+/// Same as above with explicit transpose optimization, LOCAL is the default
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+LayoutInference(const std::shared_ptr<vx::Graph>& src_graph,
+                std::shared_ptr<vx::Context>& ctx,
+                TransposeOptimization optimization,
+                LayoutInferenceReport* report = nullptr);
+
 }  // namespace transform
 }  // namespace tim
 
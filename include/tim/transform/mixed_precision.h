@@ -0,0 +1,142 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_MIXED_PRECISION_H_
+#define TIM_MIXED_PRECISION_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+    class Operation;
+    class Tensor;
+}
+
+namespace transform {
+
+/// Precision an operation computes in, cheapest first
+enum class LayerPrecision {
+  /// Tensors of the quantized graph, uint8 or int8
+  QUANTIZED,
+  /// int16 dynamic fixed point, fractional length from the quantized range
+  INT16,
+  FLOAT16,
+};
+
+struct MixedPrecisionOptions {
+  /// Largest output error allowed: the norm of the difference to the float
+  /// graph outputs over the norm of the float graph outputs
+  float error_budget{0.01f};
+};
+
+/// Output error with one layer raised and all the others quantized
+struct LayerPrecisionReport {
+  /// Operation of the float graph
+  std::shared_ptr<vx::Operation> op;
+  float int16_error{0};
+  float float16_error{0};
+  /// Precision chosen for the layer
+  LayerPrecision precision{LayerPrecision::QUANTIZED};
+};
+
+/// Output error and run time of one assignment of precisions
+struct PrecisionTradeoff {
+  uint32_t int16_layers{0};
+  uint32_t float16_layers{0};
+  float error{0};
+  /// Average time of one run
+  double run_ms{0};
+};
+
+struct MixedPrecisionReport {
+  /// Output error with every layer quantized
+  float quantized_error{0};
+  std::vector<LayerPrecisionReport> layers;
+  /// Every layer quantized first, then one entry per layer raised by the
+  /// greedy search, last every layer FLOAT16
+  std::vector<PrecisionTradeoff> tradeoff;
+};
+
+/**
+ * @brief clone the float graph with each operation in its own precision
+ *
+ * @detail
+ *   `precisions` holds one entry per operation of float_graph->OpVector().
+ *   The outputs and constant inputs of an operation take its precision:
+ *   QUANTIZED tensors and constants come from the quantized graph, INT16
+ *   and FLOAT16 ones are converted from the float graph, the bias of
+ *   Conv2d, DeConv2d, GroupedConv2d and FullyConnected being int32 with the
+ *   input and weight fractional lengths added for INT16 and float32 for
+ *   FLOAT16. DataConvert is inserted where a tensor is consumed in another
+ *   precision than it is produced. Graph inputs and outputs are float32.
+ *
+ * @param quantized graph and tensor mapping from Calibrator::Quantize()
+ * @return mixed graph and the mapping from float_graph tensors to its
+ *   tensors, in the precision of their producer
+ */
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+ApplyLayerPrecision(
+    const std::shared_ptr<vx::Graph>& float_graph,
+    const std::pair<std::shared_ptr<vx::Graph>,
+                    std::map<std::shared_ptr<vx::Tensor>,
+                             std::shared_ptr<vx::Tensor>>>& quantized,
+    std::shared_ptr<vx::Context>& ctx,
+    const std::vector<LayerPrecision>& precisions);
+
+/**
+ * @brief choose the cheapest precision of each layer meeting an error budget
+ *
+ * @detail
+ *   Each sample, a float vector per input of float_graph, is run through
+ *   the float graph for reference. The error of raising each layer alone to
+ *   INT16 and FLOAT16 gives its sensitivity. Layers are then raised from the
+ *   most sensitive on, each to INT16 if that meets the budget and to
+ *   FLOAT16 otherwise, until the outputs are within the budget.
+ *
+ * @param report optional, per layer errors and the error and run time of
+ *   each step of the search
+ * @return mixed graph and tensor mapping as ApplyLayerPrecision()
+ */
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+MixedPrecision(
+    const std::shared_ptr<vx::Graph>& float_graph,
+    const std::pair<std::shared_ptr<vx::Graph>,
+                    std::map<std::shared_ptr<vx::Tensor>,
+                             std::shared_ptr<vx::Tensor>>>& quantized,
+    std::shared_ptr<vx::Context>& ctx,
+    const std::vector<std::vector<std::vector<float>>>& samples,
+    const MixedPrecisionOptions& options = MixedPrecisionOptions(),
+    MixedPrecisionReport* report = nullptr);
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -0,0 +1,77 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_OPERATOR_FUSION_H_
+#define TIM_OPERATOR_FUSION_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+    class Tensor;
+}
+
+namespace transform {
+
+/// Operations in the graph before and after the fusion, and how many of each
+/// fused operation were created
+struct OperatorFusionReport {
+  uint32_t op_count_before{0};
+  uint32_t op_count_after{0};
+  uint32_t conv2d_relu{0};
+  uint32_t conv2d_relu_pool2d{0};
+  uint32_t fully_connected_relu{0};
+};
+
+/**
+ * @brief fuse Conv2d/FullyConnected + Relu (+ Pool2d) into the NN engine ops
+ *
+ * @detail
+ *   Conv2d -> Relu [-> Pool2d] becomes ops::Conv2dRelu or
+ *   ops::Conv2dReluPool2d, FullyConnected -> Relu becomes
+ *   ops::FullyConnectedRelu. Relu6 is fused when the quantization of its
+ *   output already clamps to [0, 6]. Only TRANSIENT tensors with a single
+ *   consumer are fused away, weights and bias must be constant.
+ *
+ *   Run it on a graph in WHCN layout (i.e. after LayoutInference) before
+ *   Compile. The fused graph is rebuilt in a new graph of ctx.
+ *
+ * @param report optional, op count before and after
+ * @return fused graph and the mapping from src_graph tensors to its tensors,
+ *   tensors fused away are not in the mapping
+ */
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+OperatorFusion(const std::shared_ptr<vx::Graph>& src_graph,
+               std::shared_ptr<vx::Context>& ctx,
+               OperatorFusionReport* report = nullptr);
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -0,0 +1,84 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_STATIC_BATCHING_H_
+#define TIM_STATIC_BATCHING_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+    class Tensor;
+}
+
+namespace transform {
+
+/// How the operations of the source graph were batched
+struct StaticBatchingReport {
+  /// Operations run once on the whole batch
+  uint32_t batched_op_count{0};
+  /// Operations run once per sample between Slice and Concat
+  uint32_t unrolled_op_count{0};
+};
+
+/**
+ * @brief clone a batch-1 graph into a graph processing `batch_size` samples
+ *   per run
+ *
+ * @detail
+ *   The outermost dimension of every non-constant tensor is multiplied by
+ *   `batch_size`, sample i occupies the i-th block of that dimension.
+ *   Constant tensors are shared by all samples. Every other tensor needs
+ *   its shape set, a graph relying on shape inference is rejected with an
+ *   empty tensor map.
+ *
+ *   Operations working on each sample on its own, with their batch
+ *   dimension outermost and of size 1, are cloned unchanged: elementwise
+ *   and activation operations, Conv2d, DeConv2d, GroupedConv2d, Pool2d,
+ *   BatchNorm, InstanceNormalization and Resize, as well as FullyConnected,
+ *   Softmax, Concat and Transpose if they leave the batch dimension alone.
+ *   Reshape keeping the batch dimension outermost gets its size scaled.
+ *
+ *   Any other operation is unrolled: each sample is sliced out of its
+ *   inputs, runs through its own clone of the operation, and the outputs
+ *   are concatenated again.
+ *
+ * @param report optional, batched and unrolled op counts
+ * @return batched graph and the mapping from src_graph tensors to its
+ *   tensors
+ */
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+StaticBatching(const std::shared_ptr<vx::Graph>& src_graph,
+               std::shared_ptr<vx::Context>& ctx, uint32_t batch_size,
+               StaticBatchingReport* report = nullptr);
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -24,6 +24,7 @@
 #ifndef TIM_VX_CONTEXT_H_
 #define TIM_VX_CONTEXT_H_
 
+#include <cstdint>
 #include <memory>
 
 namespace tim {
@@ -31,11 +32,30 @@ namespace vx {
 
 class Graph;
 
+/// Constant tensors sharing device memory, see Context::EnableConstantPool
+struct ConstantPoolStats {
+  /// Constant tensors created with data while the pool was enabled
+  uint64_t lookups = 0;
+  /// Of them, the tensors sharing the data of an identical constant
+  uint64_t hits = 0;
+  /// Bytes of the distinct constants alive in the pool
+  uint64_t pooled_bytes = 0;
+  /// Bytes not allocated thanks to sharing, since the context was created
+  uint64_t deduplicated_bytes = 0;
+};
+
 class Context {
  public:
   virtual ~Context() {}
   static std::shared_ptr<Context> Create();
   virtual std::shared_ptr<Graph> CreateGraph() = 0;
+  /// Constant tensors with the same spec and data, in any graph of the
+  /// context, share one device tensor. Off by default; writing a shared
+  /// constant with CopyDataToTensor gives it its own tensor again before the
+  /// graph compiles and fails after, a constant nobody shares is written in
+  /// place as without the pool.
+  virtual void EnableConstantPool(bool enable) = 0;
+  virtual ConstantPoolStats GetConstantPoolStats() const = 0;
 };
 
 }  // namespace vx
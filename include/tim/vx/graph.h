@@ -24,9 +24,15 @@
 #ifndef TIM_VX_GRAPH_H_
 #define TIM_VX_GRAPH_H_
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "tim/vx/profile.h"
+#include "tim/vx/types.h"
+
 namespace tim {
 namespace vx {
 
@@ -35,6 +41,51 @@ struct TensorSpec;
 
 class Operation;
 
+/// Conversion of a camera frame into a graph input, see `Graph::AddPreProcess`
+struct PreProcessConfig {
+  ImageFormat format{ImageFormat::RGB};
+  /// Size of the source frame in pixels
+  uint32_t width{0};
+  uint32_t height{0};
+  /// Region of the frame resized to the input, 0 width or height for the
+  /// whole frame
+  uint32_t crop_left{0};
+  uint32_t crop_top{0};
+  uint32_t crop_width{0};
+  uint32_t crop_height{0};
+  /// input = (pixel - mean[channel]) * scale
+  std::array<float, 3> mean{{0.0f, 0.0f, 0.0f}};
+  float scale{1.0f};
+  /// Swap the first and last channel, RGB to BGR
+  bool reverse_channel{false};
+  /// Layout of the graph input, WHCN or CWHN
+  DataLayout layout{DataLayout::WHCN};
+};
+
+/// Conversion of a graph output, see `Graph::AddPostProcess`
+struct PostProcessConfig {
+  /// Transpose of the output, empty to keep its layout
+  std::vector<uint32_t> perm;
+  /// Data type of the converted output, UNKNOWN to keep it
+  DataType datatype{DataType::UNKNOWN};
+};
+
+/// Pending execution of a graph, returned by `Graph::RunAsync`
+class RunHandle {
+ public:
+  virtual ~RunHandle() {}
+
+  /// Block until the execution finished, return whether it succeeded
+  virtual bool Wait() = 0;
+
+  /// Block at most `timeout_ms` milliseconds, return whether the execution
+  /// finished. Use `Wait()` to get its result.
+  virtual bool WaitFor(uint32_t timeout_ms) = 0;
+
+  /// Return whether the execution finished without blocking
+  virtual bool IsReady() = 0;
+};
+
 class Graph {
  public:
   virtual ~Graph() {}
@@ -46,14 +97,68 @@ class Graph {
   /// Create a placeholder tensor for optional inputs of operations
   virtual std::shared_ptr<Tensor> CreateTensorPlaceHolder() = 0;
 
+  /// Feed graph input `input` from camera frames converted on the device
+  ///
+  /// Inserts a pre-processing node converting `config.format` frames into
+  /// `input`, which becomes an internal tensor. Return the UINT8 tensors
+  /// taking the place of `input` in the graph inputs: Y and UV planes for
+  /// NV12, Y, U and V planes for YUV420 and YUV444, the frame otherwise.
+  /// Return an empty vector if `input` is not a graph input or the graph
+  /// is compiled.
+  virtual std::vector<std::shared_ptr<Tensor>> AddPreProcess(
+      const std::shared_ptr<Tensor>& input,
+      const PreProcessConfig& config) = 0;
+
+  /// Transpose or convert graph output `output` on the device
+  ///
+  /// `output` becomes an internal tensor, the returned tensor takes its
+  /// place in the graph outputs. Return nullptr if `output` is not a graph
+  /// output or the graph is compiled.
+  virtual std::shared_ptr<Tensor> AddPostProcess(
+      const std::shared_ptr<Tensor>& output,
+      const PostProcessConfig& config) = 0;
+
   /// Freeze graph
   virtual bool Compile() = 0;
 
   /// Compile to BinaryGraph
   virtual bool CompileToBinary(void* buf, size_t* size) = 0;
 
+  /// Freeze graph, reusing a BinaryGraph cached under `cache_dir`
+  ///
+  /// The cache key is a hash of the graph structure, operation parameters,
+  /// tensor specs, constant data, ovxlib version and hardware config. On a
+  /// hit the cached BinaryGraph is loaded instead of compiling the graph, on
+  /// a miss the graph is compiled and its BinaryGraph stored for next time.
+  /// `cache_hit` reports which path was taken. Falls back to `Compile()` if
+  /// the cache can not be used.
+  virtual bool CompileWithCache(const std::string& cache_dir,
+                                bool* cache_hit = nullptr) = 0;
+
   virtual bool Run() = 0;
 
+  /// Start graph execution and return without waiting for it
+  ///
+  /// Only one execution of a graph is in flight at a time: Run(), RunAsync()
+  /// and copying data to or from the graph's tensors first wait for the
+  /// pending execution. Use several graphs to overlap host-side work on one
+  /// with device execution of another.
+  virtual std::shared_ptr<RunHandle> RunAsync() = 0;
+
+  /// Measure every node of the following executions
+  ///
+  /// Turns on the OpenVX performance counters of the context. Return false
+  /// if the driver refuses to measure.
+  virtual bool EnableProfiling(bool enable) = 0;
+
+  /// Profile of the last Run() or RunAsync(), empty if profiling is off
+  ///
+  /// Node times are the OpenVX node performance counters. Operations
+  /// expanded into several nodes report the sum of their nodes and the
+  /// kernel type of the longest one. A graph compiled from a cached
+  /// BinaryGraph runs as one node.
+  virtual GraphProfile GetProfile() = 0;
+
   template <typename OpType, typename... Params>
   std::shared_ptr<OpType> CreateOperation(Params... parameters) {
     auto op = std::make_shared<OpType>(this, parameters...);
@@ -61,6 +166,11 @@ class Graph {
     return op;
   }
 
+  /// Operations in creation order
+  const std::vector<std::shared_ptr<Operation>>& OpVector() const {
+    return op_vector_;
+  }
+
   virtual const std::vector<std::shared_ptr<Tensor>> InputsTensor() const = 0;
   virtual const std::vector<std::shared_ptr<Tensor>> OutputsTensor() const = 0;
 
@@ -0,0 +1,73 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_INFERENCE_POOL_H_
+#define TIM_VX_INFERENCE_POOL_H_
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace tim {
+namespace vx {
+
+class Context;
+class Graph;
+
+/// Serve one model from several threads
+///
+/// The pool clones a graph into `instance_num` identical graphs with
+/// `Operation::Clone`, compiles the first one and loads its BinaryGraph into
+/// the others, so the model is compiled once. Requests go through a
+/// lock-free queue to `thread_num` worker threads, which take a free
+/// instance from a second lock-free queue, run it and give it back.
+class InferencePool {
+ public:
+  /// Data of each graph input or output, in `Graph::InputsTensor()` or
+  /// `Graph::OutputsTensor()` order
+  using Buffers = std::vector<std::vector<uint8_t>>;
+
+  virtual ~InferencePool() {}
+
+  /// Create a pool serving `graph`, which is only used as a template and
+  /// needs not be compiled. `thread_num` 0 means one worker per instance.
+  /// Return nullptr if an instance can not be cloned or compiled.
+  static std::shared_ptr<InferencePool> Create(
+      const std::shared_ptr<Context>& context,
+      const std::shared_ptr<Graph>& graph, uint32_t instance_num,
+      uint32_t thread_num = 0);
+
+  /// Queue one inference, the future gets the outputs, or no buffers if the
+  /// inputs don't match the graph or the execution failed. Safe to call from
+  /// any thread, blocks only while the request queue is full.
+  virtual std::future<Buffers> Submit(Buffers inputs) = 0;
+
+  virtual uint32_t InstanceNum() const = 0;
+  virtual uint32_t ThreadNum() const = 0;
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_INFERENCE_POOL_H_ */
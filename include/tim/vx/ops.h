@@ -27,21 +27,26 @@
 #include "tim/vx/ops/activations.h"
 #include "tim/vx/ops/addn.h"
 #include "tim/vx/ops/arg.h"
+#include "tim/vx/ops/axis_aligned_bbox_transform.h"
 #include "tim/vx/ops/batch2space.h"
 #include "tim/vx/ops/batchnorm.h"
+#include "tim/vx/ops/box_with_nms_limit.h"
 #include "tim/vx/ops/clip.h"
 #include "tim/vx/ops/concat.h"
 #include "tim/vx/ops/conv1d.h"
 #include "tim/vx/ops/conv2d.h"
-#include "tim/vx/ops/deconv1d.h"
 #include "tim/vx/ops/deconv.h"
+#include "tim/vx/ops/deconv1d.h"
 #include "tim/vx/ops/depth2space.h"
+#include "tim/vx/ops/detection_postprocess.h"
 #include "tim/vx/ops/dropout.h"
 #include "tim/vx/ops/elementwise.h"
 #include "tim/vx/ops/erf.h"
 #include "tim/vx/ops/fullyconnected.h"
+#include "tim/vx/ops/fused_operations.h"
 #include "tim/vx/ops/gather.h"
 #include "tim/vx/ops/gathernd.h"
+#include "tim/vx/ops/generate_proposals.h"
 #include "tim/vx/ops/groupedconv2d.h"
 #include "tim/vx/ops/instancenormalization.h"
 #include "tim/vx/ops/l2normalization.h"
@@ -54,15 +59,19 @@
 #include "tim/vx/ops/maxunpool2d.h"
 #include "tim/vx/ops/moments.h"
 #include "tim/vx/ops/nbg.h"
+#include "tim/vx/ops/nms.h"
 #include "tim/vx/ops/pad.h"
 #include "tim/vx/ops/pool2d.h"
+#include "tim/vx/ops/post_process.h"
+#include "tim/vx/ops/pre_process.h"
 #include "tim/vx/ops/reduce.h"
 #include "tim/vx/ops/relational_operations.h"
 #include "tim/vx/ops/reorg.h"
 #include "tim/vx/ops/reshape.h"
-#include "tim/vx/ops/resize1d.h"
 #include "tim/vx/ops/resize.h"
+#include "tim/vx/ops/resize1d.h"
 #include "tim/vx/ops/reverse.h"
+#include "tim/vx/ops/roi_align.h"
 #include "tim/vx/ops/scatternd.h"
 #include "tim/vx/ops/select.h"
 #include "tim/vx/ops/shuffle_channel.h"
@@ -78,6 +87,7 @@
 #include "tim/vx/ops/stridedslice.h"
 #include "tim/vx/ops/svdf.h"
 #include "tim/vx/ops/tile.h"
+#include "tim/vx/ops/topk.h"
 #include "tim/vx/ops/transpose.h"
 #include "tim/vx/ops/unidirectional_sequence_lstm.h"
 #include "tim/vx/ops/unstack.h"
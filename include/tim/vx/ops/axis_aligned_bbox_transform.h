@@ -0,0 +1,55 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_AXIS_ALIGNED_BBOX_TRANSFORM_H_
+#define TIM_VX_OPS_AXIS_ALIGNED_BBOX_TRANSFORM_H_
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## AxisAlignedBBoxTransform
+ *
+ * Applies per class box deltas to the rois and clips the boxes to the image.
+ * Same as ANEURALNETWORKS_AXIS_ALIGNED_BBOX_TRANSFORM.
+ *
+ * Inputs are rois [4, num_rois] as (x1, y1, x2, y2), deltas
+ * [num_classes * 4, num_rois], the int32 batch index of each roi [num_rois]
+ * and image info [2, batches] as (height, width). The output is
+ * [num_classes * 4, num_rois].
+ */
+
+class AxisAlignedBBoxTransform : public Operation {
+ public:
+  AxisAlignedBBoxTransform(Graph* graph);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_AXIS_ALIGNED_BBOX_TRANSFORM_H_ */
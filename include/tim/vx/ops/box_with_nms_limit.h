@@ -0,0 +1,73 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_BOX_WITH_NMS_LIMIT_H_
+#define TIM_VX_OPS_BOX_WITH_NMS_LIMIT_H_
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## BoxWithNmsLimit
+ *
+ * Greedily selects a subset of bounding boxes in descending order of score,
+ * class by class. Same as ANEURALNETWORKS_BOX_WITH_NMS_LIMIT.
+ *
+ * - score_threshold : boxes scoring below this are dropped before NMS.
+ * - max_num_bbox : maximum number of boxes kept per batch, negative for no
+ * limit.
+ * - nms_kernel_method : 0 for hard, 1 for linear and 2 for gaussian NMS.
+ * - iou_threshold : IoU threshold of hard and linear NMS.
+ * - sigma : sigma of gaussian NMS.
+ * - nms_score_threshold : boxes scoring below this are dropped after soft NMS.
+ *
+ * Inputs are scores [num_classes, num_rois], rois [num_classes * 4, num_rois]
+ * as (x1, y1, x2, y2) and the int32 batch index of each roi [num_rois].
+ * Outputs are scores [n], rois [4, n], int32 classes [n] and int32 batch
+ * indices [n]; give them explicit shapes.
+ */
+
+class BoxWithNmsLimit : public Operation {
+ public:
+  BoxWithNmsLimit(Graph* graph, float score_threshold, int32_t max_num_bbox,
+                  int32_t nms_kernel_method, float iou_threshold, float sigma,
+                  float nms_score_threshold);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+
+ protected:
+  const float score_threshold_;
+  const int32_t max_num_bbox_;
+  const int32_t nms_kernel_method_;
+  const float iou_threshold_;
+  const float sigma_;
+  const float nms_score_threshold_;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_BOX_WITH_NMS_LIMIT_H_ */
@@ -86,6 +86,12 @@ class Conv2d : public Operation {
   std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
 
  protected:
+  /// Create an ovxlib node of operation_id with the parameters of conv,
+  /// used by the fused variants of Conv2d
+  Conv2d(Graph* graph, uint32_t operation_id, const Conv2d& conv);
+
+  void Init();
+
   const uint32_t weights_;
   const PadType padding_;
   const std::array<uint32_t, 2> ksize_;
@@ -0,0 +1,85 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_DETECTION_POSTPROCESS_H_
+#define TIM_VX_OPS_DETECTION_POSTPROCESS_H_
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## DetectionPostprocess
+ *
+ * Decodes box deltas against the anchors and applies NMS to the decoded
+ * boxes, as in the SSD post-processing of TFLite. Same as
+ * ANEURALNETWORKS_DETECTION_POSTPROCESSING.
+ *
+ * - dy / dx / dh / dw : scale factors of the box center and size deltas.
+ * - nms_type : 1 for regular NMS, 0 for the faster class-agnostic one.
+ * - max_num_detections : maximum number of boxes in the output.
+ * - maximum_class_per_detection : classes kept per box in fast NMS.
+ * - maximum_detection_per_class : boxes kept per class in regular NMS.
+ * - score_threshold : boxes scoring below this are dropped.
+ * - iou_threshold : IoU threshold of NMS.
+ * - is_bg_in_label : whether class 0 is the background and included in the
+ * outputs.
+ *
+ * Inputs are scores [num_classes, num_anchors, batches], deltas
+ * [4, num_anchors, batches] and anchors [4, num_anchors] as (ctr_y, ctr_x, h,
+ * w). Outputs are scores [max_num_detections, batches], boxes
+ * [4, max_num_detections, batches] as (y1, x1, y2, x2), int32 classes
+ * [max_num_detections, batches] and int32 detection counts [batches].
+ */
+
+class DetectionPostprocess : public Operation {
+ public:
+  DetectionPostprocess(Graph* graph, float dy, float dx, float dh, float dw,
+                       int32_t nms_type, int32_t max_num_detections,
+                       int32_t maximum_class_per_detection,
+                       int32_t maximum_detection_per_class,
+                       float score_threshold, float iou_threshold,
+                       bool is_bg_in_label);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+
+ protected:
+  const float dy_;
+  const float dx_;
+  const float dh_;
+  const float dw_;
+  const int32_t nms_type_;
+  const int32_t max_num_detections_;
+  const int32_t maximum_class_per_detection_;
+  const int32_t maximum_detection_per_class_;
+  const float score_threshold_;
+  const float iou_threshold_;
+  const bool is_bg_in_label_;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_DETECTION_POSTPROCESS_H_ */
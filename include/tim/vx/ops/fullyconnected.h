@@ -47,6 +47,11 @@ class FullyConnected : public Operation {
   std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
 
  protected:
+  /// Create an ovxlib node of operation_id with the parameters of fc,
+  /// used by the fused variants of FullyConnected
+  FullyConnected(Graph* graph, uint32_t operation_id,
+                 const FullyConnected& fc);
+
   uint32_t axis_;
   uint32_t weights_;
 };
@@ -0,0 +1,106 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_FUSED_OPERATIONS_H_
+#define TIM_VX_OPS_FUSED_OPERATIONS_H_
+
+#include <array>
+
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/fullyconnected.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## Conv2dRelu
+ *
+ * Conv2d followed by Relu, executed as one node of the NN engine. Takes the
+ * same inputs as Conv2d, the bias is required.
+ *
+ * Attribute:
+ * - conv : the Conv2d whose parameters are used.
+ */
+
+class Conv2dRelu : public Conv2d {
+ public:
+  Conv2dRelu(Graph* graph, const Conv2d& conv);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+};
+
+/**
+ * ## Conv2dReluPool2d
+ *
+ * Conv2d followed by Relu and a Pool2d without padding, executed as one node
+ * of the NN engine. Takes the same inputs as Conv2d, the bias is required.
+ *
+ * Attribute:
+ * - conv : the Conv2d whose parameters are used.
+ * - type : pooling type of the Pool2d.
+ * - ksize : kernel size of the Pool2d.
+ * - stride : stride of the Pool2d.
+ * - round_type : how the output size of the Pool2d is rounded.
+ */
+
+class Conv2dReluPool2d : public Conv2d {
+ public:
+  Conv2dReluPool2d(Graph* graph, const Conv2d& conv, PoolType type,
+                   const std::array<uint32_t, 2>& ksize,
+                   const std::array<uint32_t, 2>& stride,
+                   RoundType round_type = RoundType::FLOOR);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+
+ protected:
+  const PoolType pool_type_;
+  const std::array<uint32_t, 2> pool_ksize_;
+  const std::array<uint32_t, 2> pool_stride_;
+  const RoundType round_type_;
+};
+
+/**
+ * ## FullyConnectedRelu
+ *
+ * FullyConnected followed by Relu, executed as one node of the NN engine.
+ * The input is coerced to 2D on its last axis, i.e. the FullyConnected axis
+ * must be rank - 2. Takes the same inputs as FullyConnected, the bias is
+ * required.
+ *
+ * Attribute:
+ * - fc : the FullyConnected whose parameters are used.
+ */
+
+class FullyConnectedRelu : public FullyConnected {
+ public:
+  FullyConnectedRelu(Graph* graph, const FullyConnected& fc);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_FUSED_OPERATIONS_H_ */
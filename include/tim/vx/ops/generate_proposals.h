@@ -0,0 +1,74 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_GENERATE_PROPOSALS_H_
+#define TIM_VX_OPS_GENERATE_PROPOSALS_H_
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## GenerateProposals
+ *
+ * Generates axis-aligned region proposals from anchors and box deltas, as in
+ * the RPN of Faster R-CNN. Same as ANEURALNETWORKS_GENERATE_PROPOSALS.
+ *
+ * - height_stride / width_stride : distance between neighbouring anchors in
+ * the original image.
+ * - pre_nms_top_n : boxes kept before NMS, 0 or negative to keep all.
+ * - post_nms_top_n : boxes kept after NMS, 0 or negative to keep all.
+ * - iou_threshold : IoU threshold of hard NMS.
+ * - min_size : boxes with a side below this are dropped.
+ *
+ * Inputs are scores [W, H, num_anchors, batches], deltas
+ * [W, H, num_anchors * 4, batches] for WHCN, anchors [4, num_anchors] and
+ * image info [2, batches] as (height, width). Outputs are scores [n],
+ * rois [4, n] as (x1, y1, x2, y2) and int32 batch indices [n]; proposals of
+ * all batches are packed at the front and the rest is zero.
+ */
+
+class GenerateProposals : public Operation {
+ public:
+  GenerateProposals(Graph* graph, float height_stride, float width_stride,
+                    int32_t pre_nms_top_n, int32_t post_nms_top_n,
+                    float iou_threshold, float min_size,
+                    DataLayout layout = DataLayout::WHCN);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+
+ protected:
+  const float height_stride_;
+  const float width_stride_;
+  const int32_t pre_nms_top_n_;
+  const int32_t post_nms_top_n_;
+  const float iou_threshold_;
+  const float min_size_;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_GENERATE_PROPOSALS_H_ */
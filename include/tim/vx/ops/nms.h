@@ -0,0 +1,68 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_NMS_H_
+#define TIM_VX_OPS_NMS_H_
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## NonMaxSuppression
+ *
+ * Greedily selects a subset of boxes in descending order of score, pruning
+ * away boxes that have high intersection-over-union with previously selected
+ * boxes. Same as tf.image.non_max_suppression_with_scores.
+ *
+ * - max_output_size : maximum number of boxes to be selected.
+ * - iou_threshold : boxes overlapping a selected one by more than this are
+ * suppressed.
+ * - score_threshold : boxes scoring below this are dropped.
+ * - soft_nms_sigma : sigma of Soft-NMS, 0 for hard NMS.
+ *
+ * Inputs are boxes [4, num_boxes] as (y1, x1, y2, x2) and scores [num_boxes].
+ * Outputs are the int32 selected indices [max_output_size], the selected
+ * scores [max_output_size] and the int32 number of valid outputs [1].
+ */
+
+class NonMaxSuppression : public Operation {
+ public:
+  NonMaxSuppression(Graph* graph, int32_t max_output_size, float iou_threshold,
+                    float score_threshold, float soft_nms_sigma = 0.0f);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+
+ protected:
+  const int32_t max_output_size_;
+  const float iou_threshold_;
+  const float score_threshold_;
+  const float soft_nms_sigma_;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_NMS_H_ */
@@ -0,0 +1,73 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_PRE_PROCESS_H_
+#define TIM_VX_OPS_PRE_PROCESS_H_
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## PreProcess
+ *
+ * Converts a camera frame into a normalized image: crops the frame, resizes
+ * the crop to the output size, converts it to RGB and computes
+ * (pixel - mean) * scale per channel. Usually added by `Graph::AddPreProcess`.
+ *
+ * - config : source format, frame size, crop, mean, scale, channel order and
+ * output layout.
+ * - output_shape : shape of the output, WHCN or CWHN following config.layout.
+ *
+ * Inputs are the UINT8 planes of the frame, shaped as InputShapes().
+ */
+
+class PreProcess : public Operation {
+ public:
+  PreProcess(Graph* graph, const PreProcessConfig& config,
+             const std::vector<uint32_t>& output_shape);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+
+  const PreProcessConfig& Config() const { return config_; }
+  const std::vector<uint32_t>& OutputShape() const { return output_shape_; }
+
+  /// Shapes of the frame planes taken as inputs
+  static std::vector<ShapeType> InputShapes(const PreProcessConfig& config);
+
+ protected:
+  const PreProcessConfig config_;
+  const std::vector<uint32_t> output_shape_;
+  /// Output size handed to ovxlib, which rewrites it for CWHN outputs
+  std::vector<uint32_t> output_size_;
+  /// Content of output_size_ after the rewrite, hashed for the graph cache
+  const std::vector<uint32_t> setup_output_size_;
+  std::vector<uint32_t> perm_;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_PRE_PROCESS_H_ */
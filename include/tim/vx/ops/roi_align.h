@@ -0,0 +1,70 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_ROI_ALIGN_H_
+#define TIM_VX_OPS_ROI_ALIGN_H_
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## RoiAlign
+ *
+ * Extracts a fixed size feature map for each region of interest, sampling
+ * the input with bilinear interpolation. Same as ANEURALNETWORKS_ROI_ALIGN.
+ *
+ * - output_height / output_width : size of the output feature maps.
+ * - height_ratio / width_ratio : ratio from the roi coordinates to the input
+ * height / width.
+ * - height_sample_num / width_sample_num : sampling points per output bin,
+ * 0 for adaptive.
+ *
+ * Inputs are the feature map, rois [4, num_rois] as (x1, y1, x2, y2) and the
+ * int32 batch index of each roi [num_rois]. The output is
+ * [output_width, output_height, channels, num_rois] for WHCN.
+ */
+
+class RoiAlign : public Operation {
+ public:
+  RoiAlign(Graph* graph, int32_t output_height, int32_t output_width,
+           float height_ratio, float width_ratio, int32_t height_sample_num,
+           int32_t width_sample_num, DataLayout layout = DataLayout::WHCN);
+
+  std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
+
+ protected:
+  const int32_t output_height_;
+  const int32_t output_width_;
+  const float height_ratio_;
+  const float width_ratio_;
+  const int32_t height_sample_num_;
+  const int32_t width_sample_num_;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_ROI_ALIGN_H_ */
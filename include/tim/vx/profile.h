@@ -0,0 +1,74 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_PROFILE_H_
+#define TIM_VX_PROFILE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tim {
+namespace vx {
+
+/// Execution of one low-level node, see `Graph::EnableProfiling`
+struct NodeProfile {
+  /// Operation name, e.g. "CONV2D"
+  std::string op_type;
+  /// Node id in the low-level graph, operations are numbered in creation
+  /// order
+  uint32_t uid;
+  /// Kernel the node runs with: "EVIS", "CL", "OPENVX" or "CPU" for kernels
+  /// picked by the kernel selector, "NATIVE" for nodes of the driver's
+  /// built-in OpenVX functions
+  std::string kernel_type;
+  /// Start of the node relative to the first node of the run
+  uint64_t start_ns;
+  uint64_t duration_ns;
+};
+
+/// Time spent in one operation type
+struct OpTypeProfile {
+  std::string op_type;
+  uint32_t count;
+  uint64_t total_ns;
+};
+
+/// Execution profile of the last run of a graph
+struct GraphProfile {
+  /// Time of the whole graph, includes the gaps between nodes
+  uint64_t total_ns{0};
+  /// Nodes in execution order
+  std::vector<NodeProfile> nodes;
+
+  /// Time per operation type, the most expensive type first
+  std::vector<OpTypeProfile> Histogram() const;
+
+  /// Profile in Trace Event Format, open it in chrome://tracing or Perfetto
+  std::string ToChromeTrace() const;
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_PROFILE_H_ */
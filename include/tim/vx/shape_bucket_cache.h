@@ -0,0 +1,119 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_SHAPE_BUCKET_CACHE_H_
+#define TIM_VX_SHAPE_BUCKET_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "tim/vx/tensor.h"
+
+namespace tim {
+namespace vx {
+
+class Context;
+class Graph;
+
+enum class BucketFitMode {
+  /// Keep the input at the origin of the bucket, fill the rest with the
+  /// zero point of the input
+  PAD,
+  /// Nearest neighbor resize of the input to the bucket shape
+  RESIZE,
+};
+
+struct ShapeBucketOptions {
+  BucketFitMode fit_mode = BucketFitMode::PAD;
+  /// Estimated bytes of tensors kept by the compiled graphs, 0 is unlimited.
+  /// The graph just compiled is never evicted.
+  uint64_t memory_budget = 0;
+  /// Compile missing buckets on a background thread, requests are served
+  /// by the smallest compiled bucket that fits meanwhile. Without one the
+  /// request waits for the compilation.
+  bool background_compile = false;
+};
+
+struct ShapeBucketMetrics {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  /// Misses served by a larger compiled bucket
+  uint64_t fallbacks = 0;
+  uint64_t compiles = 0;
+  uint64_t compile_failures = 0;
+  uint64_t evictions = 0;
+  double total_compile_ms = 0;
+  double max_compile_ms = 0;
+  uint64_t memory_bytes = 0;
+  double HitRate() const {
+    return hits + misses == 0
+               ? 0.0
+               : static_cast<double>(hits) / static_cast<double>(hits + misses);
+  }
+};
+
+/// Serve one model at variable input shapes from a few compiled graphs
+///
+/// Tensor shapes are fixed when a graph is built, so the model is built once
+/// per shape bucket by a user callback. A request goes to the smallest bucket
+/// holding its input shape; the input is padded or resized into the bucket on
+/// the host. Graphs are built and compiled on first use and the least recently
+/// used ones are dropped once their estimated footprint exceeds the budget.
+class ShapeBucketCache {
+ public:
+  /// Build the model with `input_shape` as the shape of its only input
+  using Builder = std::function<std::shared_ptr<Graph>(
+      const std::shared_ptr<Context>& context, const ShapeType& input_shape)>;
+  using Buffers = std::vector<std::vector<uint8_t>>;
+
+  virtual ~ShapeBucketCache() {}
+
+  /// `buckets` are input shapes of the same rank. Return nullptr if there is
+  /// no bucket, no builder or the ranks differ.
+  static std::shared_ptr<ShapeBucketCache> Create(
+      const std::shared_ptr<Context>& context, Builder builder,
+      std::vector<ShapeType> buckets,
+      const ShapeBucketOptions& options = ShapeBucketOptions());
+
+  /// Index of the smallest bucket holding `input_shape`, -1 if there is none
+  virtual int32_t FindBucket(const ShapeType& input_shape) const = 0;
+
+  /// Run `input` of `input_shape`, `outputs` get the outputs of the bucket
+  /// graph and `bucket_shape` the shape the input was fit into. Safe to call
+  /// from any thread, requests on the same bucket are serialized.
+  virtual bool Run(const ShapeType& input_shape, const void* input,
+                   Buffers* outputs, ShapeType* bucket_shape = nullptr) = 0;
+
+  /// Compile the bucket of `input_shape` ahead of the first request, in the
+  /// background if enabled
+  virtual bool Prefetch(const ShapeType& input_shape) = 0;
+
+  virtual ShapeBucketMetrics GetMetrics() const = 0;
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_SHAPE_BUCKET_CACHE_H_ */
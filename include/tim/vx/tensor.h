@@ -47,6 +47,8 @@ class Quantization {
         channel_dim_(channel_dim),
         scales_(std::move(scales)),
         zero_points_(std::move(zero_points)) {}
+  /// DYNAMIC_FIXED_POINT, real value = integer value * 2^-fl
+  Quantization(QuantType type, int8_t fl) : type_(type), fl_(fl) {}
 
   QuantType& Type() { return type_; }
   const QuantType& Type() const { return type_; }
@@ -69,6 +71,13 @@ class Quantization {
     return *this;
   }
 
+  int8_t& Fl() { return this->fl_; }
+  const int8_t& Fl() const { return this->fl_; }
+  Quantization& SetFl(int8_t fl) {
+    this->fl_ = fl;
+    return *this;
+  }
+
   std::vector<int32_t>& ZeroPoints() { return this->zero_points_; }
   const std::vector<int32_t>& ZeroPoints() const { return this->zero_points_; }
   Quantization& SetZeroPoints(std::vector<int32_t> zero_points) {
@@ -81,6 +90,7 @@ class Quantization {
   int32_t channel_dim_{-1};
   std::vector<float> scales_;
   std::vector<int32_t> zero_points_;
+  int8_t fl_{0};
 };
 
 struct TensorSpec {
@@ -153,6 +163,41 @@ class Tensor {
   virtual bool IsPlaceHolder() = 0;
   virtual bool IsConstTensor() = 0;
   virtual const void* GetDataRef() const = 0;
+
+  /// Make an INPUT or OUTPUT tensor read and write caller-owned memory
+  /// directly, avoiding the copies of CopyDataToTensor/CopyDataFromTensor.
+  ///
+  /// `buffer` must be aligned to 64 bytes and `size` be at least the tensor
+  /// size rounded up to 4096 bytes, AlignedBuffer satisfies both. The buffer
+  /// must outlive the binding. Passing nullptr restores the tensor's own
+  /// memory.
+  virtual bool BindUserBuffer(void* buffer, size_t size) = 0;
+
+  /// Same as BindUserBuffer, additionally returns the previously bound user
+  /// buffer, or nullptr if the tensor used its own memory.
+  virtual bool SwapHandle(void* buffer, size_t size, void** old_buffer) = 0;
+};
+
+/// Heap memory meeting the alignment rules of `Tensor::BindUserBuffer`
+class AlignedBuffer {
+ public:
+  static constexpr size_t kAddressAlignment = 64;
+  static constexpr size_t kSizeAlignment = 4096;
+
+  /// Allocate zero-initialized memory of at least `size` bytes
+  explicit AlignedBuffer(size_t size);
+  ~AlignedBuffer();
+
+  AlignedBuffer(const AlignedBuffer&) = delete;
+  AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+  void* Data() const { return data_; }
+  /// Allocated size, `size` rounded up to kSizeAlignment
+  size_t Size() const { return size_; }
+
+ private:
+  void* data_;
+  size_t size_;
 };
 
 }  // namespace vx
@@ -40,7 +40,12 @@ enum class DataType {
   BOOL8
 };
 
-enum class QuantType { NONE, ASYMMETRIC, SYMMETRIC_PER_CHANNEL };
+enum class QuantType {
+  NONE,
+  ASYMMETRIC,
+  SYMMETRIC_PER_CHANNEL,
+  DYNAMIC_FIXED_POINT
+};
 
 enum TensorAttribute {
   CONSTANT = 1 << 0,
@@ -62,6 +67,8 @@ enum class RoundingPolicy { TO_ZERO, RTNE };
 
 enum class ResizeType { NEAREST_NEIGHBOR, BILINEAR, AREA };
 
+enum class ImageFormat { GRAY, RGB, RGB888_PLANAR, BGRA, YUV420, YUV444, NV12 };
+
 enum class DataLayout {
   WHCN,
   CWHN,
@@ -0,0 +1,184 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/tensor.h"
+
+// Compare the throughput of blocking Run() with RunAsync() on two
+// double-buffered copies of the same graph, where host-side pre and post
+// processing of one frame overlaps device execution of the other.
+static const uint32_t default_frame_cnt = 100;
+
+struct Model {
+  std::shared_ptr<tim::vx::Graph> graph;
+  std::shared_ptr<tim::vx::Tensor> input;
+  std::shared_ptr<tim::vx::Tensor> output;
+};
+
+static Model CreateModel(std::shared_ptr<tim::vx::Context>& context,
+                         const std::vector<uint8_t>& kernel_data,
+                         const std::vector<int32_t>& bias_data) {
+  const uint32_t w = 224, h = 224, ic = 3, oc = 16, k = 3;
+  tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 1.0f, 0);
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8, {w, h, ic, 1},
+                                 tim::vx::TensorAttribute::INPUT, quant);
+  tim::vx::TensorSpec kernel_spec(tim::vx::DataType::UINT8, {k, k, ic, oc},
+                                  tim::vx::TensorAttribute::CONSTANT, quant);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::INT32, {oc},
+                                tim::vx::TensorAttribute::CONSTANT, quant);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8, {w, h, oc, 1},
+                                  tim::vx::TensorAttribute::OUTPUT, quant);
+
+  Model model;
+  model.graph = context->CreateGraph();
+  model.input = model.graph->CreateTensor(input_spec);
+  auto kernel = model.graph->CreateTensor(kernel_spec, kernel_data.data());
+  auto bias = model.graph->CreateTensor(bias_spec, bias_data.data());
+  model.output = model.graph->CreateTensor(output_spec);
+
+  std::array<uint32_t, 4> pad = {1, 1, 1, 1};
+  std::array<uint32_t, 2> stride = {1, 1};
+  std::array<uint32_t, 2> dilation = {1, 1};
+  auto conv2d = model.graph->CreateOperation<tim::vx::ops::Conv2d>(
+      pad, stride, dilation);
+  (*conv2d).BindInputs({model.input, kernel, bias}).BindOutput(model.output);
+  return model;
+}
+
+// Stand-in for host-side pre-processing, e.g. decoding and normalization
+static void PreProcess(uint32_t frame, std::vector<uint8_t>& buf) {
+  for (size_t i = 0; i < buf.size(); ++i) {
+    buf[i] = static_cast<uint8_t>((i * 7 + frame) % 255);
+  }
+}
+
+// Stand-in for host-side post-processing, e.g. decoding detections
+static uint64_t PostProcess(const std::vector<uint8_t>& buf) {
+  uint64_t sum = 0;
+  for (auto v : buf) {
+    sum += v;
+  }
+  return sum;
+}
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t frame_cnt = default_frame_cnt;
+  if (argc > 1) {
+    frame_cnt = atoi(argv[1]);
+  }
+  if (frame_cnt == 0) {
+    std::cout << "Fatal error: frame count should be greater than 0"
+              << std::endl;
+    return -1;
+  }
+
+  std::vector<uint8_t> kernel_data(3 * 3 * 3 * 16);
+  for (size_t i = 0; i < kernel_data.size(); ++i) {
+    kernel_data[i] = i % 255;
+  }
+  std::vector<int32_t> bias_data(16, 0);
+
+  auto context = tim::vx::Context::Create();
+  std::array<Model, 2> models = {CreateModel(context, kernel_data, bias_data),
+                                 CreateModel(context, kernel_data, bias_data)};
+  for (auto& model : models) {
+    if (!model.graph->Compile()) {
+      std::cout << "Fatal error: compile graph fail" << std::endl;
+      return -1;
+    }
+  }
+
+  std::vector<uint8_t> in_data(224 * 224 * 3);
+  std::vector<uint8_t> out_data(224 * 224 * 16);
+  uint64_t checksum_sync = 0;
+  uint64_t checksum_async = 0;
+
+  // Warm up both graphs
+  for (auto& model : models) {
+    model.graph->Run();
+  }
+
+  auto sync_start = std::chrono::steady_clock::now();
+  for (uint32_t frame = 0; frame < frame_cnt; ++frame) {
+    PreProcess(frame, in_data);
+    models[0].input->CopyDataToTensor(in_data.data(), in_data.size());
+    if (!models[0].graph->Run()) {
+      std::cout << "Fatal error: run graph fail" << std::endl;
+      return -1;
+    }
+    models[0].output->CopyDataFromTensor(out_data.data());
+    checksum_sync += PostProcess(out_data);
+  }
+  double sync_ms = ElapsedMs(sync_start);
+
+  // While the device runs frame N on one graph, the host post-processes
+  // frame N - 1 and pre-processes frame N + 1 on the other.
+  std::array<std::shared_ptr<tim::vx::RunHandle>, 2> pending;
+  auto async_start = std::chrono::steady_clock::now();
+  for (uint32_t frame = 0; frame < frame_cnt + 2; ++frame) {
+    auto& model = models[frame % 2];
+    auto& handle = pending[frame % 2];
+    if (handle) {
+      if (!handle->Wait()) {
+        std::cout << "Fatal error: run graph fail" << std::endl;
+        return -1;
+      }
+      handle.reset();
+      model.output->CopyDataFromTensor(out_data.data());
+      checksum_async += PostProcess(out_data);
+    }
+    if (frame < frame_cnt) {
+      PreProcess(frame, in_data);
+      model.input->CopyDataToTensor(in_data.data(), in_data.size());
+      handle = model.graph->RunAsync();
+    }
+  }
+  double async_ms = ElapsedMs(async_start);
+
+  std::cout << "\n ===========================================================\n";
+  std::cout << "\t frame count: " << frame_cnt << "\n";
+  std::cout << "\t Run() throughput(fps): " << frame_cnt * 1000.0 / sync_ms
+            << "\n";
+  std::cout << "\t double-buffered RunAsync() throughput(fps): "
+            << frame_cnt * 1000.0 / async_ms << "\n";
+  std::cout << "\t results "
+            << (checksum_sync == checksum_async ? "match" : "MISMATCH")
+            << "\n";
+  std::cout << " ===========================================================" << std::endl;
+
+  return checksum_sync == checksum_async ? 0 : -1;
+}
@@ -0,0 +1,246 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "vsi_nn_pub.h"
+#include "utils/vsi_nn_thread_pool.h"
+#include "kernel/cpu/vsi_nn_kernel_cpu_compute.h"
+
+// Compare the CPU fallback kernels with the straightforward loops they
+// replaced. Thread count follows env VSI_NN_CPU_THREADS.
+static const int default_loop_cnt = 10;
+
+static double MeasureMs(int loop, const std::function<void()>& fn) {
+  fn();  // warm up
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < loop; i++) {
+    fn();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / loop;
+}
+
+static float MaxDiff(const std::vector<float>& a, const std::vector<float>& b) {
+  float diff = 0.f;
+  for (size_t i = 0; i < a.size(); i++) {
+    diff = std::max(diff, std::fabs(a[i] - b[i]));
+  }
+  return diff;
+}
+
+static void Report(const char* name, double ref_ms, double opt_ms,
+                   float max_diff) {
+  std::cout << std::left << std::setw(18) << name << std::right << std::fixed
+            << std::setprecision(3) << std::setw(12) << ref_ms
+            << std::setw(12) << opt_ms << std::setw(9)
+            << std::setprecision(2) << ref_ms / opt_ms << "x"
+            << std::scientific << std::setprecision(2) << std::setw(12)
+            << max_diff << std::endl;
+}
+
+static std::vector<float> RandomData(size_t size, std::mt19937& rng) {
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<float> data(size);
+  for (auto& d : data) {
+    d = dist(rng);
+  }
+  return data;
+}
+
+static void BenchMatmul(int loop, std::mt19937& rng) {
+  const size_t M = 256, K = 512, N = 512;
+  auto a = RandomData(M * K, rng);
+  auto b = RandomData(K * N, rng);
+  std::vector<float> ref(M * N), out(M * N);
+
+  double ref_ms = MeasureMs(loop, [&]() {
+    for (size_t i = 0; i < M; i++) {
+      for (size_t j = 0; j < N; j++) {
+        float sum = 0.f;
+        for (size_t k = 0; k < K; k++) {
+          sum += a[i * K + k] * b[k * N + j];
+        }
+        ref[i * N + j] = sum;
+      }
+    }
+  });
+  double opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_kernel_cpu_matmul_f32(a.data(), b.data(), out.data(), M, K, N,
+                                 FALSE, FALSE);
+  });
+  Report("matmul", ref_ms, opt_ms, MaxDiff(ref, out));
+}
+
+static void BenchResize(int loop, std::mt19937& rng) {
+  const size_t in_w = 320, in_h = 240, out_w = 640, out_h = 480, planes = 8;
+  auto in = RandomData(in_w * in_h * planes, rng);
+  std::vector<float> ref(out_w * out_h * planes), out(ref.size());
+  const float w_scale = (float)in_w / out_w;
+  const float h_scale = (float)in_h / out_h;
+
+  double ref_ms = MeasureMs(loop, [&]() {
+    for (size_t p = 0; p < planes; p++) {
+      for (size_t h = 0; h < out_h; h++) {
+        float input_h = ((float)h + 0.5f) * h_scale - 0.5f;
+        size_t h0 = (size_t)(ssize_t)input_h;
+        size_t h1 = input_h < 0 ? 0 : std::min(h0 + 1, in_h - 1);
+        for (size_t w = 0; w < out_w; w++) {
+          float input_w = ((float)w + 0.5f) * w_scale - 0.5f;
+          size_t w0 = (size_t)(ssize_t)input_w;
+          size_t w1 = input_w < 0 ? 0 : std::min(w0 + 1, in_w - 1);
+          const float* src = &in[p * in_w * in_h];
+          float fy = input_h - h0, fx = input_w - w0;
+          ref[(p * out_h + h) * out_w + w] =
+              src[h0 * in_w + w0] * (1 - fy) * (1 - fx) +
+              src[h1 * in_w + w0] * fy * (1 - fx) +
+              src[h0 * in_w + w1] * (1 - fy) * fx +
+              src[h1 * in_w + w1] * fy * fx;
+        }
+      }
+    }
+  });
+  double opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_kernel_cpu_resize_bilinear_f32(in.data(), out.data(), in_w, in_h,
+                                          out_w, out_h, planes, FALSE, TRUE);
+  });
+  Report("resize_bilinear", ref_ms, opt_ms, MaxDiff(ref, out));
+}
+
+static void BenchGather(int loop, std::mt19937& rng) {
+  const size_t block_size = 256, axis_num = 1024, block_num = 8;
+  const size_t indices_num = 2048;
+  auto in = RandomData(block_size * axis_num * block_num, rng);
+  std::uniform_int_distribution<uint32_t> dist(0, axis_num - 1);
+  std::vector<uint32_t> indices(indices_num);
+  for (auto& i : indices) {
+    i = dist(rng);
+  }
+  std::vector<float> ref(block_size * indices_num * block_num),
+      out(ref.size());
+
+  double ref_ms = MeasureMs(loop, [&]() {
+    for (size_t i = 0; i < block_num; i++) {
+      for (size_t j = 0; j < indices_num; j++) {
+        size_t in_index = (i * axis_num + indices[j]) * block_size;
+        size_t out_index = (i * indices_num + j) * block_size;
+        for (size_t k = 0; k < block_size; k++) {
+          ref[out_index + k] = in[in_index + k];
+        }
+      }
+    }
+  });
+  double opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_kernel_cpu_gather(in.data(), in.size(), indices.data(),
+                             indices_num, block_size, block_num, axis_num,
+                             sizeof(float), out.data());
+  });
+  Report("gather", ref_ms, opt_ms, MaxDiff(ref, out));
+}
+
+static void BenchScatter(int loop, std::mt19937& rng) {
+  const size_t block_size = 512, out_blocks = 1024, indices_num = 4096;
+  auto updates = RandomData(block_size * indices_num, rng);
+  std::uniform_int_distribution<vsi_ssize_t> dist(0, out_blocks - 1);
+  std::vector<vsi_ssize_t> offsets(indices_num);
+  for (auto& o : offsets) {
+    o = dist(rng) * block_size;
+  }
+  std::vector<float> ref(block_size * out_blocks), out(ref.size());
+
+  double ref_ms = MeasureMs(loop, [&]() {
+    std::fill(ref.begin(), ref.end(), 0.f);
+    for (size_t i = 0; i < indices_num; i++) {
+      for (size_t k = 0; k < block_size; k++) {
+        ref[offsets[i] + k] += updates[i * block_size + k];
+      }
+    }
+  });
+  double opt_ms = MeasureMs(loop, [&]() {
+    std::fill(out.begin(), out.end(), 0.f);
+    vsi_nn_kernel_cpu_scatter_add_f32(updates.data(), offsets.data(),
+                                      indices_num, block_size, out.data());
+  });
+  Report("scatter_nd", ref_ms, opt_ms, MaxDiff(ref, out));
+}
+
+static void BenchTopk(int loop, std::mt19937& rng) {
+  const size_t rows = 64, row_len = 32000;
+  const uint32_t k = 5;
+  auto in = RandomData(rows * row_len, rng);
+  std::vector<float> ref(rows * k), out(rows * k);
+  std::vector<uint32_t> ref_idx(rows * k), out_idx(rows * k);
+
+  double ref_ms = MeasureMs(loop, [&]() {
+    std::vector<uint32_t> order(row_len);
+    for (size_t r = 0; r < rows; r++) {
+      const float* row = &in[r * row_len];
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(),
+                       [row](uint32_t a, uint32_t b) { return row[a] > row[b]; });
+      for (uint32_t i = 0; i < k; i++) {
+        ref[r * k + i] = row[order[i]];
+        ref_idx[r * k + i] = order[i];
+      }
+    }
+  });
+  double opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_kernel_cpu_topk_f32(in.data(), rows, row_len, k, out.data(),
+                               out_idx.data());
+  });
+  if (ref_idx != out_idx) {
+    std::cout << "topk indices mismatch" << std::endl;
+  }
+  Report("topk", ref_ms, opt_ms, MaxDiff(ref, out));
+}
+
+int main(int argc, char** argv) {
+  int loop = default_loop_cnt;
+  if (argc > 1) {
+    loop = std::max(1, atoi(argv[1]));
+  }
+  std::mt19937 rng(2021);
+
+  std::cout << "threads: " << vsi_nn_parallel_get_thread_num()
+            << ", loops: " << loop << std::endl;
+  std::cout << std::left << std::setw(18) << "kernel" << std::right
+            << std::setw(12) << "ref(ms)" << std::setw(12) << "new(ms)"
+            << std::setw(10) << "speedup" << std::setw(12) << "max diff"
+            << std::endl;
+  BenchMatmul(loop, rng);
+  BenchResize(loop, rng);
+  BenchGather(loop, rng);
+  BenchScatter(loop, rng);
+  BenchTopk(loop, rng);
+  return 0;
+}
@@ -0,0 +1,420 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "vsi_nn_pub.h"
+#include "utils/vsi_nn_thread_pool.h"
+#include "utils/vsi_nn_dtype_bulk.h"
+// The old per element helpers, plain C with unused parameters
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include "utils/vsi_nn_dtype_util_prv.h"
+#pragma GCC diagnostic pop
+
+// Check the bulk dtype conversion against plain C++ references and against
+// its own scalar path, then compare its speed with the per element loops it
+// replaced in vsi_nn_dtype.c. Exits with 1 on any mismatch.
+static const int default_loop_cnt = 10;
+static const size_t bench_size = 4 * 1024 * 1024;
+static int failures = 0;
+
+static double MeasureMs(int loop, const std::function<void()>& fn) {
+  fn();  // warm up
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < loop; i++) {
+    fn();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count() / loop;
+}
+
+static uint32_t FloatBits(float f) {
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+static float BitsFloat(uint32_t u) {
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+static void Check(const char* name, bool ok, size_t index) {
+  if (!ok) {
+    if (failures < 20) {
+      std::cout << "MISMATCH " << name << " at " << index << std::endl;
+    }
+    failures++;
+  }
+}
+
+// References, written for clarity rather than speed.
+static float RefHalfToFloat(uint16_t h) {
+  int exp = (h >> 10) & 0x1f;
+  int mant = h & 0x3ff;
+  float v;
+  if (exp == 0x1f) {
+    v = mant ? std::numeric_limits<float>::quiet_NaN()
+             : std::numeric_limits<float>::infinity();
+  } else if (exp == 0) {
+    v = std::ldexp((float)mant, -24);
+  } else {
+    v = std::ldexp((float)(mant | 0x400), exp - 25);
+  }
+  return (h & 0x8000) ? -v : v;
+}
+
+static bool SameFloat(float a, float b) {
+  return (std::isnan(a) && std::isnan(b)) || FloatBits(a) == FloatBits(b);
+}
+
+template <typename T>
+static T RefQuantize(float x, float scale, int32_t zp) {
+  const float lo = (float)((int32_t)std::numeric_limits<T>::min() - zp);
+  const float hi = (float)((int32_t)std::numeric_limits<T>::max() - zp);
+  float r = std::nearbyint(x / scale);
+  if (std::isnan(r) || r < lo) r = lo;
+  if (r > hi) r = hi;
+  return (T)((int32_t)r + zp);
+}
+
+// The per element loop vsi_nn_dtype.c quantized with before, on the
+// unchanged vsi_rtne() and vsi_clamp() it used.
+template <typename T>
+static void OldQuantize(const float* in, size_t size, float scale,
+                        int32_t zero_point, double min, double max, T* out) {
+  for (size_t i = 0; i < size; i++) {
+    out[i] = (T)vsi_clamp(vsi_rtne(in[i] / scale) + zero_point, min, max);
+  }
+}
+
+static void CheckHalf() {
+  std::vector<uint16_t> all(65536);
+  for (size_t i = 0; i < all.size(); i++) {
+    all[i] = (uint16_t)i;
+  }
+  std::vector<float> f(all.size());
+  vsi_nn_dtype_bulk_fp16_to_fp32(all.data(), all.size(), f.data());
+  for (size_t i = 0; i < all.size(); i++) {
+    Check("fp16->fp32", SameFloat(f[i], RefHalfToFloat(all[i])), i);
+  }
+
+  // Every finite half must round trip, NaN stays NaN, inf saturates.
+  std::vector<uint16_t> h(all.size());
+  vsi_nn_dtype_bulk_fp32_to_fp16(f.data(), f.size(), h.data());
+  for (size_t i = 0; i < all.size(); i++) {
+    uint16_t expect = all[i];
+    if ((expect & 0x7fff) == 0x7c00) {
+      expect = (expect & 0x8000) | 0x7bff;
+    }
+    bool ok = std::isnan(f[i]) ? std::isnan(RefHalfToFloat(h[i]))
+                               : h[i] == expect;
+    Check("fp32->fp16 round trip", ok, i);
+  }
+
+  // Midpoints between neighbours go to the even one, one float ulp off a
+  // midpoint goes to the nearer one.
+  std::vector<float> mid, mid_lo, mid_hi;
+  std::vector<uint16_t> expect_mid, expect_lo, expect_hi;
+  for (uint32_t i = 0; i < 0x7bff; i++) {
+    for (uint32_t sign : {0u, 0x8000u}) {
+      uint16_t a = (uint16_t)(i | sign), b = (uint16_t)((i + 1) | sign);
+      float m = (RefHalfToFloat(a) + RefHalfToFloat(b)) / 2;
+      mid.push_back(m);
+      expect_mid.push_back((i & 1) ? b : a);
+      mid_lo.push_back(std::nextafter(m, RefHalfToFloat(a)));
+      expect_lo.push_back(a);
+      mid_hi.push_back(std::nextafter(m, RefHalfToFloat(b)));
+      expect_hi.push_back(b);
+    }
+  }
+  std::vector<uint16_t> out(mid.size());
+  vsi_nn_dtype_bulk_fp32_to_fp16(mid.data(), mid.size(), out.data());
+  for (size_t i = 0; i < out.size(); i++) {
+    Check("fp32->fp16 tie", out[i] == expect_mid[i], i);
+  }
+  vsi_nn_dtype_bulk_fp32_to_fp16(mid_lo.data(), mid_lo.size(), out.data());
+  for (size_t i = 0; i < out.size(); i++) {
+    Check("fp32->fp16 below tie", out[i] == expect_lo[i], i);
+  }
+  vsi_nn_dtype_bulk_fp32_to_fp16(mid_hi.data(), mid_hi.size(), out.data());
+  for (size_t i = 0; i < out.size(); i++) {
+    Check("fp32->fp16 above tie", out[i] == expect_hi[i], i);
+  }
+}
+
+static void CheckBfloat(std::mt19937& rng) {
+  std::vector<uint16_t> all(65536);
+  for (size_t i = 0; i < all.size(); i++) {
+    all[i] = (uint16_t)i;
+  }
+  std::vector<float> f(all.size());
+  vsi_nn_dtype_bulk_bf16_to_fp32(all.data(), all.size(), f.data());
+  for (size_t i = 0; i < all.size(); i++) {
+    Check("bf16->fp32", FloatBits(f[i]) == (uint32_t)all[i] << 16, i);
+  }
+  // bfp16_to_fp32 flushes -0, subnormals and the lowest exponent to +0, the
+  // bulk conversion keeps them. Every other code converts the same.
+  for (size_t i = 0; i < all.size(); i++) {
+    uint32_t old_bits = FloatBits(bfp16_to_fp32((int16_t)all[i]));
+    bool flushed = (all[i] & 0x7f00) == 0;
+    Check("bf16->fp32 vs bfp16_to_fp32",
+          flushed ? old_bits == 0 : old_bits == FloatBits(f[i]), i);
+  }
+  Check("bf16->fp32 -0", std::signbit(f[0x8000]) && f[0x8000] == 0.0f, 0x8000);
+  Check("bf16->fp32 subnormal", f[0x0001] == std::ldexp(1.0f, -133), 0x0001);
+  Check("bf16->fp32 min normal", f[0x0080] == std::ldexp(1.0f, -126), 0x0080);
+
+  std::uniform_int_distribution<uint32_t> bits;
+  std::vector<float> in(100003);
+  for (auto& v : in) {
+    v = BitsFloat(bits(rng));
+  }
+  std::vector<uint16_t> out(in.size());
+  vsi_nn_dtype_bulk_fp32_to_bf16(in.data(), in.size(), out.data());
+  for (size_t i = 0; i < in.size(); i++) {
+    uint32_t u = FloatBits(in[i]);
+    float back = BitsFloat((uint32_t)out[i] << 16);
+    bool ok;
+    if (std::isnan(in[i])) {
+      ok = std::isnan(back);
+    } else {
+      uint32_t rounded = (u + 0x7fff + ((u >> 16) & 1)) >> 16;
+      ok = out[i] == rounded;
+    }
+    Check("fp32->bf16", ok, i);
+  }
+}
+
+template <typename T>
+static void CheckQuantize(
+    const char* name, std::mt19937& rng,
+    void (*quantize)(const float*, size_t, float, int32_t, T*),
+    void (*dequantize)(const T*, size_t, float, int32_t, float*)) {
+  const float scale = 0.0371f;
+  const int32_t zp = std::is_signed<T>::value ? 3 : 117;
+  std::uniform_real_distribution<float> dist(-200 * scale * sizeof(T) * 4,
+                                             200 * scale * sizeof(T) * 4);
+  std::vector<float> in(100003);
+  for (size_t i = 0; i < in.size(); i++) {
+    // Mix in exact halfway cases
+    in[i] = (i % 3 == 0) ? ((float)(int)dist(rng) + 0.5f) * scale : dist(rng);
+  }
+  in[0] = std::numeric_limits<float>::quiet_NaN();
+  in[1] = std::numeric_limits<float>::infinity();
+  in[2] = -std::numeric_limits<float>::infinity();
+  std::vector<T> q(in.size());
+  quantize(in.data(), in.size(), scale, zp, q.data());
+  for (size_t i = 0; i < in.size(); i++) {
+    Check(name, q[i] == RefQuantize<T>(in[i], scale, zp), i);
+  }
+  std::vector<float> f(q.size());
+  dequantize(q.data(), q.size(), scale, zp, f.data());
+  for (size_t i = 0; i < q.size(); i++) {
+    Check(name, f[i] == (float)((double)((int32_t)q[i] - zp) * scale), i);
+  }
+}
+
+// The SIMD paths must match the scalar path bit for bit, on odd sizes for
+// the tails and on large sizes for the threaded split.
+static void CheckSimdMatchesScalar(std::mt19937& rng) {
+  std::uniform_int_distribution<uint32_t> bits;
+  std::uniform_real_distribution<float> dist(-300.f, 300.f);
+  for (size_t size : {(size_t)1, (size_t)7, (size_t)33, (size_t)1000003}) {
+    std::vector<float> f(size);
+    std::vector<uint16_t> h(size);
+    for (size_t i = 0; i < size; i++) {
+      f[i] = (i % 4 == 0) ? BitsFloat(bits(rng)) : dist(rng);
+      h[i] = (uint16_t)bits(rng);
+    }
+    std::vector<uint8_t> simd_bytes, scalar_bytes;
+    auto run_all = [&](std::vector<uint8_t>& result) {
+      std::vector<float> f_out(size);
+      std::vector<uint16_t> h_out(size);
+      std::vector<uint8_t> u8(size);
+      std::vector<int8_t> i8(size);
+      std::vector<int16_t> i16(size);
+      auto append = [&result](const void* data, size_t bytes) {
+        const uint8_t* p = (const uint8_t*)data;
+        result.insert(result.end(), p, p + bytes);
+      };
+      vsi_nn_dtype_bulk_fp16_to_fp32(h.data(), size, f_out.data());
+      append(f_out.data(), size * 4);
+      vsi_nn_dtype_bulk_bf16_to_fp32(h.data(), size, f_out.data());
+      append(f_out.data(), size * 4);
+      vsi_nn_dtype_bulk_fp32_to_fp16(f.data(), size, h_out.data());
+      append(h_out.data(), size * 2);
+      vsi_nn_dtype_bulk_fp32_to_bf16(f.data(), size, h_out.data());
+      append(h_out.data(), size * 2);
+      vsi_nn_dtype_bulk_quantize_u8(f.data(), size, 0.7f, 128, u8.data());
+      append(u8.data(), size);
+      vsi_nn_dtype_bulk_quantize_i8(f.data(), size, 0.9f, -5, i8.data());
+      append(i8.data(), size);
+      vsi_nn_dtype_bulk_quantize_i16(f.data(), size, 0.01f, 0, i16.data());
+      append(i16.data(), size * 2);
+      vsi_nn_dtype_bulk_dequantize_u8(u8.data(), size, 0.7f, 128, f_out.data());
+      append(f_out.data(), size * 4);
+      vsi_nn_dtype_bulk_dequantize_i8(i8.data(), size, 0.9f, -5, f_out.data());
+      append(f_out.data(), size * 4);
+      vsi_nn_dtype_bulk_dequantize_i16(i16.data(), size, 0.01f, 0,
+                                       f_out.data());
+      append(f_out.data(), size * 4);
+    };
+    run_all(simd_bytes);
+    vsi_nn_dtype_bulk_set_simd_enable(FALSE);
+    run_all(scalar_bytes);
+    vsi_nn_dtype_bulk_set_simd_enable(TRUE);
+    // NaN payloads are the only allowed difference, fp16->fp32 may quiet
+    // them, so compare the float outputs as floats.
+    size_t float_bytes = size * 4 * 2;
+    for (size_t i = 0; i < size * 2; i++) {
+      float a, b;
+      memcpy(&a, &simd_bytes[i * 4], 4);
+      memcpy(&b, &scalar_bytes[i * 4], 4);
+      Check("simd vs scalar", SameFloat(a, b), i);
+    }
+    Check("simd vs scalar",
+          std::equal(simd_bytes.begin() + float_bytes, simd_bytes.end(),
+                     scalar_bytes.begin() + float_bytes),
+          size);
+  }
+}
+
+static void Report(const char* name, double ref_ms, double opt_ms) {
+  std::cout << std::left << std::setw(18) << name << std::right << std::fixed
+            << std::setprecision(3) << std::setw(12) << ref_ms
+            << std::setw(12) << opt_ms << std::setw(9)
+            << std::setprecision(2) << ref_ms / opt_ms << "x" << std::endl;
+}
+
+static void Bench(int loop, std::mt19937& rng) {
+  std::uniform_real_distribution<float> dist(-100.f, 100.f);
+  std::vector<float> f(bench_size), f_out(bench_size);
+  std::vector<uint16_t> h(bench_size);
+  std::vector<uint8_t> u8(bench_size);
+  std::vector<int16_t> i16(bench_size);
+  for (auto& v : f) {
+    v = dist(rng);
+  }
+  const float scale = 0.75f;
+  const int32_t zp = 128;
+
+  double ref_ms = MeasureMs(loop, [&]() {
+    for (size_t i = 0; i < bench_size; i++) h[i] = fp32_to_fp16(f[i]);
+  });
+  double opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_dtype_bulk_fp32_to_fp16(f.data(), bench_size, h.data());
+  });
+  Report("fp32->fp16", ref_ms, opt_ms);
+
+  ref_ms = MeasureMs(loop, [&]() {
+    for (size_t i = 0; i < bench_size; i++) {
+      f_out[i] = fp16_to_fp32((int16_t)h[i]);
+    }
+  });
+  opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_dtype_bulk_fp16_to_fp32(h.data(), bench_size, f_out.data());
+  });
+  Report("fp16->fp32", ref_ms, opt_ms);
+
+  ref_ms = MeasureMs(loop, [&]() {
+    for (size_t i = 0; i < bench_size; i++) h[i] = fp32_to_bfp16(f[i]);
+  });
+  opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_dtype_bulk_fp32_to_bf16(f.data(), bench_size, h.data());
+  });
+  Report("fp32->bf16", ref_ms, opt_ms);
+
+  ref_ms = MeasureMs(loop, [&]() {
+    OldQuantize<uint8_t>(f.data(), bench_size, scale, zp, 0, UCHAR_MAX,
+                         u8.data());
+  });
+  opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_dtype_bulk_quantize_u8(f.data(), bench_size, scale, zp, u8.data());
+  });
+  Report("quantize u8", ref_ms, opt_ms);
+
+  ref_ms = MeasureMs(loop, [&]() {
+    for (size_t i = 0; i < bench_size; i++) {
+      f_out[i] = (float)(((double)u8[i] - (double)zp) * scale);
+    }
+  });
+  opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_dtype_bulk_dequantize_u8(u8.data(), bench_size, scale, zp,
+                                    f_out.data());
+  });
+  Report("dequantize u8", ref_ms, opt_ms);
+
+  ref_ms = MeasureMs(loop, [&]() {
+    OldQuantize<int16_t>(f.data(), bench_size, 0.01f, 0, SHRT_MIN, SHRT_MAX,
+                         i16.data());
+  });
+  opt_ms = MeasureMs(loop, [&]() {
+    vsi_nn_dtype_bulk_quantize_i16(f.data(), bench_size, 0.01f, 0,
+                                   i16.data());
+  });
+  Report("quantize i16", ref_ms, opt_ms);
+}
+
+int main(int argc, char** argv) {
+  int loop = default_loop_cnt;
+  if (argc > 1) {
+    loop = std::max(1, atoi(argv[1]));
+  }
+  std::mt19937 rng(2021);
+  const char* isa_names[] = {"scalar", "neon", "avx2+f16c"};
+
+  std::cout << "isa: " << isa_names[vsi_nn_dtype_bulk_get_isa()]
+            << ", threads: " << vsi_nn_parallel_get_thread_num()
+            << ", loops: " << loop << std::endl;
+  CheckHalf();
+  CheckBfloat(rng);
+  CheckQuantize<uint8_t>("quantize u8", rng, vsi_nn_dtype_bulk_quantize_u8,
+                         vsi_nn_dtype_bulk_dequantize_u8);
+  CheckQuantize<int8_t>("quantize i8", rng, vsi_nn_dtype_bulk_quantize_i8,
+                        vsi_nn_dtype_bulk_dequantize_i8);
+  CheckQuantize<int16_t>("quantize i16", rng, vsi_nn_dtype_bulk_quantize_i16,
+                         vsi_nn_dtype_bulk_dequantize_i16);
+  CheckSimdMatchesScalar(rng);
+  std::cout << "accuracy: " << (failures ? "FAILED" : "bit exact") << std::endl;
+
+  std::cout << std::left << std::setw(18) << "conversion" << std::right
+            << std::setw(12) << "old(ms)" << std::setw(12) << "new(ms)"
+            << std::setw(10) << "speedup" << std::endl;
+  Bench(loop, rng);
+  return failures ? 1 : 0;
+}
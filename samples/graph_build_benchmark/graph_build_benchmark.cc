@@ -0,0 +1,91 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/tensor.h"
+
+// Build a chain of `node_cnt` Relu nodes and report how long graph
+// construction and setup take. Large node counts expose any non-linear
+// cost in tensor/node bookkeeping.
+static const uint32_t default_node_cnt = 10000;
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t node_cnt = default_node_cnt;
+  if (argc > 1) {
+    node_cnt = atoi(argv[1]);
+  }
+  if (node_cnt == 0) {
+    std::cout << "Fatal error: node count should be greater than 0" << std::endl;
+    return -1;
+  }
+
+  tim::vx::ShapeType shape = {4, 4, 4, 1};
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto context = tim::vx::Context::Create();
+  auto graph = context->CreateGraph();
+
+  auto construct_start = std::chrono::steady_clock::now();
+  auto input = graph->CreateTensor(input_spec);
+  for (uint32_t i = 0; i < node_cnt; ++i) {
+    auto output = (i == node_cnt - 1) ? graph->CreateTensor(output_spec)
+                                      : graph->CreateTensor(transient_spec);
+    auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+    (*relu).BindInput(input).BindOutput(output);
+    input = output;
+  }
+  double construct_ms = ElapsedMs(construct_start);
+
+  auto compile_start = std::chrono::steady_clock::now();
+  if (!graph->Compile()) {
+    std::cout << "Fatal error: compile graph fail" << std::endl;
+    return -1;
+  }
+  double compile_ms = ElapsedMs(compile_start);
+
+  std::cout << "\n ===========================================================\n";
+  std::cout << "\t node count: " << node_cnt << "\n";
+  std::cout << "\t construction time(ms): " << construct_ms << "\n";
+  std::cout << "\t setup + verify time(ms): " << compile_ms << "\n";
+  std::cout << " ===========================================================" << std::endl;
+
+  return 0;
+}
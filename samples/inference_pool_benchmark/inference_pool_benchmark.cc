@@ -0,0 +1,191 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/inference_pool.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/tensor.h"
+
+// Serve one model from many client threads with InferencePool, sweeping the
+// number of graph instances and worker threads. Each client submits a
+// request and waits for it before the next one, so the latency is exact.
+static const uint32_t default_request_cnt = 64;
+static const uint32_t w = 64, h = 64, ic = 3, oc = 16, k = 3;
+
+static std::shared_ptr<tim::vx::Graph> CreateModel(
+    const std::shared_ptr<tim::vx::Context>& context,
+    const std::vector<uint8_t>& kernel_data,
+    const std::vector<int32_t>& bias_data) {
+  tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 1.0f, 0);
+  tim::vx::Quantization out_quant(tim::vx::QuantType::ASYMMETRIC, 64.0f, 0);
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8, {w, h, ic, 1},
+                                 tim::vx::TensorAttribute::INPUT, quant);
+  tim::vx::TensorSpec kernel_spec(tim::vx::DataType::UINT8, {k, k, ic, oc},
+                                  tim::vx::TensorAttribute::CONSTANT, quant);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::INT32, {oc},
+                                tim::vx::TensorAttribute::CONSTANT, quant);
+  tim::vx::TensorSpec conv_spec(tim::vx::DataType::UINT8, {w, h, oc, 1},
+                                tim::vx::TensorAttribute::TRANSIENT,
+                                out_quant);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8, {w, h, oc, 1},
+                                  tim::vx::TensorAttribute::OUTPUT,
+                                  out_quant);
+
+  auto graph = context->CreateGraph();
+  auto input = graph->CreateTensor(input_spec);
+  auto kernel = graph->CreateTensor(kernel_spec, kernel_data.data());
+  auto bias = graph->CreateTensor(bias_spec, bias_data.data());
+  auto conv_out = graph->CreateTensor(conv_spec);
+  auto output = graph->CreateTensor(output_spec);
+
+  std::array<uint32_t, 4> pad = {1, 1, 1, 1};
+  std::array<uint32_t, 2> stride = {1, 1};
+  std::array<uint32_t, 2> dilation = {1, 1};
+  auto conv2d =
+      graph->CreateOperation<tim::vx::ops::Conv2d>(pad, stride, dilation);
+  (*conv2d).BindInputs({input, kernel, bias}).BindOutput(conv_out);
+  auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInput(conv_out).BindOutput(output);
+  return graph;
+}
+
+static tim::vx::InferencePool::Buffers MakeInput(uint32_t request) {
+  tim::vx::InferencePool::Buffers inputs(1, std::vector<uint8_t>(w * h * ic));
+  for (size_t i = 0; i < inputs[0].size(); ++i) {
+    inputs[0][i] = static_cast<uint8_t>((i * 7 + request) % 255);
+  }
+  return inputs;
+}
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t request_cnt = default_request_cnt;
+  if (argc > 1) {
+    request_cnt = atoi(argv[1]);
+  }
+  if (request_cnt == 0) {
+    std::cout << "Fatal error: request count should be greater than 0"
+              << std::endl;
+    return -1;
+  }
+
+  std::vector<uint8_t> kernel_data(k * k * ic * oc);
+  for (size_t i = 0; i < kernel_data.size(); ++i) {
+    kernel_data[i] = i % 255;
+  }
+  std::vector<int32_t> bias_data(oc, 0);
+
+  auto context = tim::vx::Context::Create();
+  auto model = CreateModel(context, kernel_data, bias_data);
+
+  // Reference outputs from plain Run() on the template graph
+  if (!model->Compile()) {
+    std::cout << "Fatal error: compile graph fail" << std::endl;
+    return -1;
+  }
+  std::vector<std::vector<uint8_t>> expected(request_cnt);
+  for (uint32_t r = 0; r < request_cnt; ++r) {
+    auto inputs = MakeInput(r);
+    model->InputsTensor()[0]->CopyDataToTensor(inputs[0].data(),
+                                               inputs[0].size());
+    model->Run();
+    expected[r].resize(w * h * oc);
+    model->OutputsTensor()[0]->CopyDataFromTensor(expected[r].data());
+  }
+
+  std::cout << std::setw(10) << "instances" << std::setw(10) << "threads"
+            << std::setw(10) << "clients" << std::setw(12) << "fps"
+            << std::setw(12) << "avg(ms)" << std::setw(12) << "p50(ms)"
+            << std::setw(12) << "p99(ms)" << std::endl;
+  bool all_match = true;
+  for (uint32_t instance_num : {1, 2, 4}) {
+    for (uint32_t thread_num : {1, 2, 4}) {
+      auto pool = tim::vx::InferencePool::Create(context, model, instance_num,
+                                                 thread_num);
+      if (!pool) {
+        std::cout << "Fatal error: create inference pool fail" << std::endl;
+        return -1;
+      }
+      // Enough clients to keep every worker busy
+      const uint32_t client_num = 2 * thread_num;
+      std::vector<double> latency(request_cnt);
+      std::atomic<uint32_t> next_request(0);
+      std::atomic<uint32_t> mismatch(0);
+
+      auto start = std::chrono::steady_clock::now();
+      std::vector<std::thread> clients;
+      for (uint32_t c = 0; c < client_num; ++c) {
+        clients.emplace_back([&]() {
+          for (uint32_t r = next_request++; r < request_cnt;
+               r = next_request++) {
+            auto submit_time = std::chrono::steady_clock::now();
+            auto outputs = pool->Submit(MakeInput(r)).get();
+            latency[r] = ElapsedMs(submit_time);
+            if (outputs.size() != 1 || outputs[0] != expected[r]) {
+              ++mismatch;
+            }
+          }
+        });
+      }
+      for (auto& client : clients) {
+        client.join();
+      }
+      double total_ms = ElapsedMs(start);
+
+      std::sort(latency.begin(), latency.end());
+      double avg = 0;
+      for (auto l : latency) {
+        avg += l;
+      }
+      avg /= request_cnt;
+      std::cout << std::setw(10) << instance_num << std::setw(10)
+                << thread_num << std::setw(10) << client_num << std::fixed
+                << std::setprecision(2) << std::setw(12)
+                << request_cnt * 1000.0 / total_ms << std::setw(12) << avg
+                << std::setw(12) << latency[request_cnt / 2] << std::setw(12)
+                << latency[std::min<size_t>(request_cnt * 99 / 100,
+                                            request_cnt - 1)]
+                << (mismatch ? "  MISMATCH" : "") << std::endl;
+      all_match = all_match && mismatch == 0;
+    }
+  }
+  std::cout << "results " << (all_match ? "match" : "MISMATCH") << std::endl;
+  return all_match ? 0 : -1;
+}
@@ -0,0 +1,191 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tim/lite/execution.h"
+#include "tim/lite/handle_ring.h"
+
+// Sustained FPS of a blocking Trigger() loop against a HandleRing, where a
+// producer thread fills frame N+1 while frame N executes
+//
+// usage: ./lite_fps_benchmark network.nb frame_num in_bytes[,in_bytes...]
+//            out_bytes[,out_bytes...] [depth]
+
+namespace {
+std::vector<size_t> ParseSizes(const std::string& arg) {
+  std::vector<size_t> sizes;
+  std::stringstream ss(arg);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    sizes.push_back(std::strtoul(item.c_str(), nullptr, 10));
+  }
+  return sizes;
+}
+
+// Stands in for decoding or preprocessing a camera frame
+void FillFrame(uint8_t* buffer, size_t size, int frame) {
+  for (size_t i = 0; i < size; ++i) {
+    buffer[i] = static_cast<uint8_t>(frame + i);
+  }
+}
+
+// Stands in for postprocessing the outputs
+uint64_t Consume(const uint8_t* buffer, size_t size) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size; ++i) {
+    sum += buffer[i];
+  }
+  return sum;
+}
+
+#define MEM_ALIGN(x, align) (((x) + ((align)-1)) & ~((align)-1))
+
+double RunSync(const std::shared_ptr<tim::lite::Execution>& exec,
+               const std::vector<size_t>& input_sizes,
+               const std::vector<size_t>& output_sizes, int frame_num,
+               uint64_t* checksum) {
+  std::vector<uint8_t*> buffers;
+  std::vector<std::shared_ptr<tim::lite::Handle>> inputs, outputs;
+  for (size_t i = 0; i < input_sizes.size(); ++i) {
+    buffers.push_back(
+        (uint8_t*)aligned_alloc(64, MEM_ALIGN(input_sizes[i], 64)));
+    inputs.push_back(
+        exec->CreateInputHandle(i, buffers.back(), input_sizes[i]));
+  }
+  for (size_t i = 0; i < output_sizes.size(); ++i) {
+    buffers.push_back(
+        (uint8_t*)aligned_alloc(64, MEM_ALIGN(output_sizes[i], 64)));
+    outputs.push_back(
+        exec->CreateOutputHandle(i, buffers.back(), output_sizes[i]));
+  }
+  exec->BindInputs(inputs);
+  exec->BindOutputs(outputs);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frame_num; ++frame) {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      FillFrame(buffers[i], input_sizes[i], frame);
+      inputs[i]->Flush();
+    }
+    exec->Trigger();
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      outputs[i]->Invalidate();
+      *checksum += Consume(buffers[inputs.size() + i], output_sizes[i]);
+    }
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  for (const auto& handle : inputs) exec->UnBindInput(handle);
+  for (const auto& handle : outputs) exec->UnBindOutput(handle);
+  inputs.clear();
+  outputs.clear();
+  for (auto buffer : buffers) free(buffer);
+  return frame_num / seconds;
+}
+
+double RunPipelined(const std::shared_ptr<tim::lite::Execution>& exec,
+                    const std::vector<size_t>& input_sizes,
+                    const std::vector<size_t>& output_sizes, int frame_num,
+                    uint32_t depth, uint64_t* checksum) {
+  auto ring =
+      tim::lite::HandleRing::Create(exec, input_sizes, output_sizes, depth);
+  if (!ring) {
+    return 0;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::thread producer([&]() {
+    for (int frame = 0; frame < frame_num; ++frame) {
+      uint32_t slot = ring->Acquire();
+      for (size_t i = 0; i < input_sizes.size(); ++i) {
+        FillFrame(ring->InputBuffer(slot, i), input_sizes[i], frame);
+      }
+      ring->Submit(slot);
+    }
+  });
+  for (int frame = 0; frame < frame_num; ++frame) {
+    int32_t slot = -1;
+    // The producer may not have submitted the next frame yet
+    while ((slot = ring->Wait()) < 0) {
+      std::this_thread::yield();
+    }
+    for (size_t i = 0; i < output_sizes.size(); ++i) {
+      *checksum += Consume(ring->OutputBuffer(slot, i), output_sizes[i]);
+    }
+    ring->Release(slot);
+  }
+  producer.join();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return frame_num / seconds;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 5) {
+    std::cout << "usage: " << argv[0]
+              << " network.nb frame_num in_bytes[,...] out_bytes[,...] [depth]"
+              << std::endl;
+    return -1;
+  }
+  int frame_num = std::atoi(argv[2]);
+  auto input_sizes = ParseSizes(argv[3]);
+  auto output_sizes = ParseSizes(argv[4]);
+  uint32_t depth = argc > 5 ? std::atoi(argv[5]) : 3;
+
+  auto exec = tim::lite::Execution::CreateFromFile(argv[1]);
+  if (!exec) {
+    std::cout << "Load executable fail." << std::endl;
+    return -1;
+  }
+
+  uint64_t sync_checksum = 0;
+  uint64_t ring_checksum = 0;
+  double sync_fps =
+      RunSync(exec, input_sizes, output_sizes, frame_num, &sync_checksum);
+  double ring_fps = RunPipelined(exec, input_sizes, output_sizes, frame_num,
+                                 depth, &ring_checksum);
+  std::printf("Trigger loop: %.1f FPS\n", sync_fps);
+  std::printf("HandleRing depth %u: %.1f FPS (%.2fx)\n", depth, ring_fps,
+              ring_fps / sync_fps);
+  if (sync_checksum != ring_checksum) {
+    std::printf("Output mismatch: %llu vs %llu\n",
+                (unsigned long long)sync_checksum,
+                (unsigned long long)ring_checksum);
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tim/lite/execution.h"
+
+// Startup time and memory of loading an NBG with tim::lite: reading it into
+// the heap for Execution::Create(), mapping it with CreateFromFile(), and
+// more Executions forked from the loaded one
+//
+// usage: ./lite_startup_benchmark network.nb [mode] [execution_num]
+//   mode: copy | file, default file
+
+namespace {
+// Resident and peak resident set, in KB
+void ReadRss(long* rss_kb, long* peak_kb) {
+  *rss_kb = 0;
+  *peak_kb = 0;
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmRSS:") == 0) {
+      *rss_kb = std::atol(line.c_str() + 6);
+    } else if (line.compare(0, 6, "VmHWM:") == 0) {
+      *peak_kb = std::atol(line.c_str() + 6);
+    }
+  }
+}
+
+double MsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "usage: " << argv[0]
+              << " network.nb [copy|file] [execution_num]" << std::endl;
+    return -1;
+  }
+  std::string path = argv[1];
+  bool from_file = argc < 3 || std::string(argv[2]) != "copy";
+  int execution_num = argc > 3 ? std::atoi(argv[3]) : 1;
+
+  long rss_kb, peak_kb;
+  ReadRss(&rss_kb, &peak_kb);
+  std::printf("baseline: rss %ld KB, peak %ld KB\n", rss_kb, peak_kb);
+
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<tim::lite::Execution> exec;
+  if (from_file) {
+    exec = tim::lite::Execution::CreateFromFile(path);
+  } else {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    std::vector<char> executable(file.tellg());
+    file.seekg(0);
+    file.read(executable.data(), executable.size());
+    exec = tim::lite::Execution::Create(executable.data(), executable.size());
+  }
+  if (!exec) {
+    std::cout << "Load executable fail." << std::endl;
+    return -1;
+  }
+  double load_ms = MsSince(start);
+  ReadRss(&rss_kb, &peak_kb);
+  std::printf("%s: load %.2f ms, rss %ld KB, peak %ld KB\n",
+              from_file ? "CreateFromFile" : "Create", load_ms, rss_kb,
+              peak_kb);
+
+  std::vector<std::shared_ptr<tim::lite::Execution>> forks;
+  start = std::chrono::steady_clock::now();
+  for (int i = 1; i < execution_num; ++i) {
+    forks.push_back(exec->Fork());
+  }
+  if (execution_num > 1) {
+    double fork_ms = MsSince(start);
+    ReadRss(&rss_kb, &peak_kb);
+    std::printf("Fork x%d: %.3f ms, rss %ld KB, peak %ld KB\n",
+                execution_num - 1, fork_ms, rss_kb, peak_kb);
+  }
+  return 0;
+}
@@ -0,0 +1,162 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <array>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "tim/transform/calibration.h"
+#include "tim/transform/mixed_precision.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/fullyconnected.h"
+#include "tim/vx/ops/reshape.h"
+#include "tim/vx/tensor.h"
+
+// Calibrate a small float classifier to uint8, then let
+// tim::transform::MixedPrecision raise the layers losing most accuracy to
+// int16 or float16 until the outputs are within the error budget. Prints the
+// error of raising each layer and the error and run time of each step.
+static const uint32_t sample_cnt = 16;
+static const uint32_t w = 16, h = 16, c = 8, classes = 10;
+
+static std::shared_ptr<tim::vx::Graph> CreateModel(
+    std::shared_ptr<tim::vx::Context>& context,
+    const std::vector<float>& kernel_data, const std::vector<float>& fc_data) {
+  auto spec = [](const tim::vx::ShapeType& shape,
+                 tim::vx::TensorAttribute attr) {
+    return tim::vx::TensorSpec(tim::vx::DataType::FLOAT32, shape, attr);
+  };
+  const auto transient = tim::vx::TensorAttribute::TRANSIENT;
+
+  auto graph = context->CreateGraph();
+  auto input =
+      graph->CreateTensor(spec({w, h, 1, 1}, tim::vx::TensorAttribute::INPUT));
+  auto kernel = graph->CreateTensor(
+      spec({3, 3, 1, c}, tim::vx::TensorAttribute::CONSTANT),
+      kernel_data.data());
+  auto conv_out = graph->CreateTensor(spec({w, h, c, 1}, transient));
+  auto relu_out = graph->CreateTensor(spec({w, h, c, 1}, transient));
+  auto flat = graph->CreateTensor(spec({w * h * c, 1}, transient));
+  auto fc_weights = graph->CreateTensor(
+      spec({w * h * c, classes}, tim::vx::TensorAttribute::CONSTANT),
+      fc_data.data());
+  auto output = graph->CreateTensor(
+      spec({classes, 1}, tim::vx::TensorAttribute::OUTPUT));
+
+  auto conv = graph->CreateOperation<tim::vx::ops::Conv2d>(
+      c, tim::vx::PadType::SAME, std::array<uint32_t, 2>({3, 3}),
+      std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+  (*conv).BindInputs({input, kernel}).BindOutput(conv_out);
+  auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInput(conv_out).BindOutput(relu_out);
+  auto reshape = graph->CreateOperation<tim::vx::ops::Reshape>(
+      std::vector<uint32_t>({w * h * c, 1}));
+  (*reshape).BindInput(relu_out).BindOutput(flat);
+  auto fc = graph->CreateOperation<tim::vx::ops::FullyConnected>(0, classes);
+  (*fc).BindInputs({flat, fc_weights}).BindOutput(output);
+  return graph;
+}
+
+static const char* PrecisionName(tim::transform::LayerPrecision precision) {
+  switch (precision) {
+    case tim::transform::LayerPrecision::INT16:
+      return "int16";
+    case tim::transform::LayerPrecision::FLOAT16:
+      return "float16";
+    default:
+      return "uint8";
+  }
+}
+
+int main(int argc, char* argv[]) {
+  tim::transform::MixedPrecisionOptions options;
+  if (argc > 1) {
+    options.error_budget = static_cast<float>(atof(argv[1]));
+  }
+
+  std::vector<float> kernel_data(3 * 3 * c);
+  for (size_t i = 0; i < kernel_data.size(); ++i) {
+    kernel_data[i] = static_cast<float>(i % 7) / 7.0f - 0.5f;
+  }
+  std::vector<float> fc_data(w * h * c * classes);
+  for (size_t i = 0; i < fc_data.size(); ++i) {
+    fc_data[i] = static_cast<float>(i % 13) / 130.0f - 0.05f;
+  }
+  std::vector<std::vector<std::vector<float>>> samples;
+  for (uint32_t s = 0; s < sample_cnt; ++s) {
+    std::vector<float> sample(w * h);
+    for (size_t i = 0; i < sample.size(); ++i) {
+      sample[i] = static_cast<float>((i * 31 + s * 17) % 255) / 255.0f;
+    }
+    samples.push_back({sample});
+  }
+
+  auto context = tim::vx::Context::Create();
+  auto model = CreateModel(context, kernel_data, fc_data);
+  auto calibrator = tim::transform::Calibrator::Create(model, context);
+  for (const auto& sample : samples) {
+    if (!calibrator->Feed(sample)) {
+      std::cout << "Fatal error: calibration run fail" << std::endl;
+      return -1;
+    }
+  }
+  auto quantized = calibrator->Quantize(context);
+  if (quantized.second.empty()) {
+    std::cout << "Fatal error: quantization fail" << std::endl;
+    return -1;
+  }
+
+  tim::transform::MixedPrecisionReport report;
+  auto mixed = tim::transform::MixedPrecision(model, quantized, context,
+                                              samples, options, &report);
+  if (mixed.second.empty()) {
+    std::cout << "Fatal error: mixed precision search fail" << std::endl;
+    return -1;
+  }
+
+  std::cout << "\n ===========================================================\n";
+  std::cout << "\t error budget: " << options.error_budget
+            << ", uint8 error: " << report.quantized_error << "\n";
+  std::cout << "\t layer   int16 error   float16 error   chosen\n";
+  for (size_t i = 0; i < report.layers.size(); ++i) {
+    const auto& layer = report.layers[i];
+    std::cout << "\t " << std::setw(5) << i << std::setw(14) << std::fixed
+              << std::setprecision(5) << layer.int16_error << std::setw(16)
+              << layer.float16_error << std::setw(9)
+              << PrecisionName(layer.precision) << "\n";
+  }
+  std::cout << "\t int16   float16   error      ms/run\n";
+  for (const auto& point : report.tradeoff) {
+    std::cout << "\t " << std::setw(5) << point.int16_layers << std::setw(10)
+              << point.float16_layers << std::setw(10)
+              << std::setprecision(5) << point.error << std::setw(10)
+              << std::setprecision(3) << point.run_ms << "\n";
+  }
+  std::cout << " ===========================================================" << std::endl;
+  return 0;
+}
@@ -34,7 +34,12 @@
 #include <map>
 
 #ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
 #include <time.h>
+#include <unistd.h>
 #elif defined(_WIN32)
 #include <windows.h>
 #endif
@@ -98,19 +103,39 @@ int main(int argc, char** argv) {
         return -1;
     }
 
-    ifstream nbg_file((const char*)argv[1]);
+    uint64_t tmS, tmE;
+
+    tmS = get_perf_count();
+#ifdef __linux__
+    // Map the NBG instead of reading it into the heap, large models would
+    // otherwise be resident twice
+    int nbg_fd = open(argv[1], O_RDONLY);
+    assert(nbg_fd >= 0);
+    struct stat nbg_stat;
+    fstat(nbg_fd, &nbg_stat);
+    size_t nbg_size = nbg_stat.st_size;
+    void* nbg_map = mmap(NULL, nbg_size, PROT_READ, MAP_PRIVATE, nbg_fd, 0);
+    close(nbg_fd);
+    assert(nbg_map != MAP_FAILED);
+    char* nbg_data = static_cast<char*>(nbg_map);
+#else
+    ifstream nbg_file((const char*)argv[1], ios::binary);
     assert(nbg_file);
 
     nbg_file.seekg(0, ios::end);
-    int nbg_size = nbg_file.tellg();
+    size_t nbg_size = nbg_file.tellg();
     std::vector<char> nbg_buf(nbg_size);
     nbg_file.seekg(0, ios::beg);
     nbg_file.read( nbg_buf.data(), nbg_size );
     nbg_file.close();
+    char* nbg_data = nbg_buf.data();
+#endif
+    tmE = get_perf_count();
+    printf("Load Time: %ldus\n", (tmE - tmS)/1000);
 
     nbg_parser_data nbg = NBG_NULL;
 
-    nbg_parser_init(nbg_buf.data(), nbg_size, &nbg);
+    nbg_parser_init(nbg_data, nbg_size, &nbg);
 
     // Get Inputs
     int input_count = 0;
@@ -220,7 +245,7 @@ int main(int argc, char** argv) {
     auto ctx = tim::vx::Context::Create();
     auto graph = ctx->CreateGraph();
     auto nbg_node = graph->CreateOperation<tim::vx::ops::NBG>(
-        nbg_buf.data(), input_count, output_count);
+        nbg_data, input_count, output_count);
     for(int i=0; i<input_count; i++) {
         auto input = graph->CreateTensor(input_list[i]);
         (*nbg_node).BindInput(input);
@@ -230,8 +255,6 @@ int main(int argc, char** argv) {
         (*nbg_node).BindOutput(output);
     }
 
-    uint64_t tmS, tmE;
-
     tmS = get_perf_count();
     assert(graph->Compile());
     tmE = get_perf_count();
@@ -242,4 +265,11 @@ int main(int argc, char** argv) {
     tmE = get_perf_count();
     printf("Run Time: %ldus\n", (tmE - tmS)/1000);
 
+#ifdef __linux__
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("Peak RSS: %ldKB\n", usage.ru_maxrss);
+    munmap(nbg_map, nbg_size);
+#endif
+
 }
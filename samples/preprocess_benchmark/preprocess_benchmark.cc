@@ -0,0 +1,208 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/tensor.h"
+
+// Feed 1080p NV12 camera frames to a small conv model, once converted to
+// normalized planar RGB on the host before CopyDataToTensor and once as raw
+// Y and UV planes converted by a PRE_PROCESS node added with
+// Graph::AddPreProcess. Prints the per frame time of each step.
+static const uint32_t frame_w = 1920, frame_h = 1080;
+static const uint32_t w = 224, h = 224, c = 16;
+static const float mean = 127.5f, scale = 1.0f / 127.5f;
+
+struct Model {
+  std::shared_ptr<tim::vx::Graph> graph;
+  std::shared_ptr<tim::vx::Tensor> input;
+  std::shared_ptr<tim::vx::Tensor> output;
+};
+
+static Model CreateModel(std::shared_ptr<tim::vx::Context>& context,
+                         const std::vector<float>& kernel_data) {
+  auto spec = [](const tim::vx::ShapeType& shape,
+                 tim::vx::TensorAttribute attr) {
+    return tim::vx::TensorSpec(tim::vx::DataType::FLOAT32, shape, attr);
+  };
+
+  Model model;
+  model.graph = context->CreateGraph();
+  model.input = model.graph->CreateTensor(
+      spec({w, h, 3, 1}, tim::vx::TensorAttribute::INPUT));
+  auto kernel = model.graph->CreateTensor(
+      spec({3, 3, 3, c}, tim::vx::TensorAttribute::CONSTANT),
+      kernel_data.data());
+  auto conv_out = model.graph->CreateTensor(
+      spec({w, h, c, 1}, tim::vx::TensorAttribute::TRANSIENT));
+  model.output = model.graph->CreateTensor(
+      spec({w, h, c, 1}, tim::vx::TensorAttribute::OUTPUT));
+
+  auto conv = model.graph->CreateOperation<tim::vx::ops::Conv2d>(
+      c, tim::vx::PadType::SAME, std::array<uint32_t, 2>({3, 3}),
+      std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+  (*conv).BindInputs({model.input, kernel}).BindOutput(conv_out);
+  auto relu = model.graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInput(conv_out).BindOutput(model.output);
+  return model;
+}
+
+static uint8_t Clamp(float v) {
+  return static_cast<uint8_t>(std::min(std::max(v, 0.0f), 255.0f));
+}
+
+// Bilinear resize of the luma, nearest chroma, BT.601 to RGB, normalize
+static void HostPreProcess(const std::vector<uint8_t>& y_plane,
+                           const std::vector<uint8_t>& uv_plane,
+                           std::vector<float>& rgb) {
+  const float sx = static_cast<float>(frame_w) / w;
+  const float sy = static_cast<float>(frame_h) / h;
+  for (uint32_t oy = 0; oy < h; ++oy) {
+    float fy = std::max((oy + 0.5f) * sy - 0.5f, 0.0f);
+    uint32_t y0 = static_cast<uint32_t>(fy);
+    uint32_t y1 = std::min(y0 + 1, frame_h - 1);
+    float dy = fy - y0;
+    for (uint32_t ox = 0; ox < w; ++ox) {
+      float fx = std::max((ox + 0.5f) * sx - 0.5f, 0.0f);
+      uint32_t x0 = static_cast<uint32_t>(fx);
+      uint32_t x1 = std::min(x0 + 1, frame_w - 1);
+      float dx = fx - x0;
+      float luma = (y_plane[y0 * frame_w + x0] * (1 - dx) +
+                    y_plane[y0 * frame_w + x1] * dx) * (1 - dy) +
+                   (y_plane[y1 * frame_w + x0] * (1 - dx) +
+                    y_plane[y1 * frame_w + x1] * dx) * dy;
+      size_t chroma = (y0 / 2) * frame_w + (x0 & ~1u);
+      float u = uv_plane[chroma] - 128.0f;
+      float v = uv_plane[chroma + 1] - 128.0f;
+      size_t pixel = oy * w + ox;
+      rgb[pixel] = (Clamp(luma + 1.402f * v) - mean) * scale;
+      rgb[w * h + pixel] =
+          (Clamp(luma - 0.344f * u - 0.714f * v) - mean) * scale;
+      rgb[2 * w * h + pixel] = (Clamp(luma + 1.772f * u) - mean) * scale;
+    }
+  }
+}
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t frame_cnt = 20;
+  if (argc > 1) {
+    frame_cnt = static_cast<uint32_t>(atoi(argv[1]));
+  }
+
+  std::vector<float> kernel_data(3 * 3 * 3 * c);
+  for (size_t i = 0; i < kernel_data.size(); ++i) {
+    kernel_data[i] = static_cast<float>(i % 7) / 7.0f - 0.5f;
+  }
+  std::vector<uint8_t> y_plane(frame_w * frame_h);
+  std::vector<uint8_t> uv_plane(frame_w * frame_h / 2);
+  for (size_t i = 0; i < y_plane.size(); ++i) {
+    y_plane[i] = static_cast<uint8_t>((i * 7) % 251);
+  }
+  for (size_t i = 0; i < uv_plane.size(); ++i) {
+    uv_plane[i] = static_cast<uint8_t>(96 + (i * 13) % 64);
+  }
+
+  auto context = tim::vx::Context::Create();
+  auto host = CreateModel(context, kernel_data);
+  auto device = CreateModel(context, kernel_data);
+
+  tim::vx::PreProcessConfig config;
+  config.format = tim::vx::ImageFormat::NV12;
+  config.width = frame_w;
+  config.height = frame_h;
+  config.mean = {{mean, mean, mean}};
+  config.scale = scale;
+  auto frames = device.graph->AddPreProcess(device.input, config);
+  if (frames.size() != 2 || !host.graph->Compile() ||
+      !device.graph->Compile()) {
+    std::cout << "Fatal error: compile fail" << std::endl;
+    return -1;
+  }
+
+  std::vector<float> rgb(w * h * 3);
+  std::vector<float> out(w * h * c);
+  double host_convert_ms = 0, host_copy_ms = 0, host_run_ms = 0;
+  for (uint32_t frame = 0; frame < frame_cnt; ++frame) {
+    auto start = std::chrono::steady_clock::now();
+    HostPreProcess(y_plane, uv_plane, rgb);
+    host_convert_ms += ElapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    host.input->CopyDataToTensor(rgb.data(), rgb.size() * sizeof(float));
+    host_copy_ms += ElapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    if (!host.graph->Run()) {
+      std::cout << "Fatal error: run fail" << std::endl;
+      return -1;
+    }
+    host.output->CopyDataFromTensor(out.data());
+    host_run_ms += ElapsedMs(start);
+  }
+
+  double device_copy_ms = 0, device_run_ms = 0;
+  for (uint32_t frame = 0; frame < frame_cnt; ++frame) {
+    auto start = std::chrono::steady_clock::now();
+    frames[0]->CopyDataToTensor(y_plane.data(), y_plane.size());
+    frames[1]->CopyDataToTensor(uv_plane.data(), uv_plane.size());
+    device_copy_ms += ElapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    if (!device.graph->Run()) {
+      std::cout << "Fatal error: run fail" << std::endl;
+      return -1;
+    }
+    device.output->CopyDataFromTensor(out.data());
+    device_run_ms += ElapsedMs(start);
+  }
+
+  std::cout << "\n ===========================================================\n";
+  std::cout << "\t " << frame_w << "x" << frame_h << " NV12 to " << w << "x"
+            << h << " RGB, " << frame_cnt << " frames, ms/frame\n";
+  std::cout << "\t           convert      copy       run     total\n";
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "\t host   " << std::setw(10) << host_convert_ms / frame_cnt
+            << std::setw(10) << host_copy_ms / frame_cnt << std::setw(10)
+            << host_run_ms / frame_cnt << std::setw(10)
+            << (host_convert_ms + host_copy_ms + host_run_ms) / frame_cnt
+            << "\n";
+  std::cout << "\t device " << std::setw(10) << 0.0 << std::setw(10)
+            << device_copy_ms / frame_cnt << std::setw(10)
+            << device_run_ms / frame_cnt << std::setw(10)
+            << (device_copy_ms + device_run_ms) / frame_cnt << "\n";
+  std::cout << " ===========================================================" << std::endl;
+  return 0;
+}
@@ -0,0 +1,169 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "tim/transform/static_batching.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/fullyconnected.h"
+#include "tim/vx/ops/pool2d.h"
+#include "tim/vx/ops/reshape.h"
+#include "tim/vx/ops/softmax.h"
+#include "tim/vx/tensor.h"
+
+// Throughput of a small batch-1 classifier rebuilt with
+// tim::transform::StaticBatching for batch sizes 1 to 32. Every batch size
+// processes the same number of samples, so larger batches pay the per-Run
+// dispatch overhead fewer times.
+static const uint32_t default_sample_cnt = 512;
+static const uint32_t w = 28, h = 28, c = 8, classes = 10;
+
+static std::shared_ptr<tim::vx::Graph> CreateModel(
+    std::shared_ptr<tim::vx::Context>& context,
+    const std::vector<float>& kernel_data, const std::vector<float>& fc_data) {
+  auto spec = [](const tim::vx::ShapeType& shape,
+                 tim::vx::TensorAttribute attr) {
+    return tim::vx::TensorSpec(tim::vx::DataType::FLOAT32, shape, attr);
+  };
+  const auto transient = tim::vx::TensorAttribute::TRANSIENT;
+
+  auto graph = context->CreateGraph();
+  auto input =
+      graph->CreateTensor(spec({w, h, 1, 1}, tim::vx::TensorAttribute::INPUT));
+  auto kernel = graph->CreateTensor(
+      spec({3, 3, 1, c}, tim::vx::TensorAttribute::CONSTANT),
+      kernel_data.data());
+  auto conv_out = graph->CreateTensor(spec({w, h, c, 1}, transient));
+  auto relu_out = graph->CreateTensor(spec({w, h, c, 1}, transient));
+  auto pool_out = graph->CreateTensor(spec({w / 2, h / 2, c, 1}, transient));
+  auto flat = graph->CreateTensor(spec({w / 2 * h / 2 * c, 1}, transient));
+  auto fc_weights = graph->CreateTensor(
+      spec({w / 2 * h / 2 * c, classes}, tim::vx::TensorAttribute::CONSTANT),
+      fc_data.data());
+  auto fc_out = graph->CreateTensor(spec({classes, 1}, transient));
+  auto output = graph->CreateTensor(
+      spec({classes, 1}, tim::vx::TensorAttribute::OUTPUT));
+
+  auto conv = graph->CreateOperation<tim::vx::ops::Conv2d>(
+      c, tim::vx::PadType::SAME, std::array<uint32_t, 2>({3, 3}),
+      std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+  (*conv).BindInputs({input, kernel}).BindOutput(conv_out);
+  auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInput(conv_out).BindOutput(relu_out);
+  auto pool = graph->CreateOperation<tim::vx::ops::Pool2d>(
+      tim::vx::PoolType::MAX, tim::vx::PadType::VALID,
+      std::array<uint32_t, 2>({2, 2}), std::array<uint32_t, 2>({2, 2}));
+  (*pool).BindInput(relu_out).BindOutput(pool_out);
+  auto reshape = graph->CreateOperation<tim::vx::ops::Reshape>(
+      std::vector<uint32_t>({w / 2 * h / 2 * c, 1}));
+  (*reshape).BindInput(pool_out).BindOutput(flat);
+  auto fc = graph->CreateOperation<tim::vx::ops::FullyConnected>(0, classes);
+  (*fc).BindInputs({flat, fc_weights}).BindOutput(fc_out);
+  auto softmax = graph->CreateOperation<tim::vx::ops::Softmax>(1.0f, 0);
+  (*softmax).BindInput(fc_out).BindOutput(output);
+  return graph;
+}
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main(int argc, char* argv[]) {
+  uint32_t sample_cnt = default_sample_cnt;
+  if (argc > 1) {
+    sample_cnt = atoi(argv[1]);
+  }
+  if (sample_cnt == 0) {
+    std::cout << "Fatal error: sample count should be greater than 0"
+              << std::endl;
+    return -1;
+  }
+
+  std::vector<float> kernel_data(3 * 3 * c);
+  for (size_t i = 0; i < kernel_data.size(); ++i) {
+    kernel_data[i] = static_cast<float>(i % 7) / 7.0f - 0.5f;
+  }
+  std::vector<float> fc_data(w / 2 * h / 2 * c * classes);
+  for (size_t i = 0; i < fc_data.size(); ++i) {
+    fc_data[i] = static_cast<float>(i % 13) / 130.0f - 0.05f;
+  }
+
+  auto context = tim::vx::Context::Create();
+  auto model = CreateModel(context, kernel_data, fc_data);
+
+  std::cout << "\n ===========================================================\n";
+  std::cout << "\t sample count: " << sample_cnt << "\n";
+  std::cout << "\t batch   ops   unrolled   ms/run   samples/s\n";
+  for (uint32_t batch : {1u, 2u, 4u, 8u, 16u, 32u}) {
+    tim::transform::StaticBatchingReport report;
+    auto batched =
+        tim::transform::StaticBatching(model, context, batch, &report);
+    auto graph = batched.first;
+    auto input = graph->InputsTensor()[0];
+    auto output = graph->OutputsTensor()[0];
+    if (!graph->Compile()) {
+      std::cout << "Fatal error: compile graph fail" << std::endl;
+      return -1;
+    }
+
+    std::vector<float> in_data(w * h * batch);
+    for (size_t i = 0; i < in_data.size(); ++i) {
+      in_data[i] = static_cast<float>(i % 255) / 255.0f;
+    }
+    std::vector<float> out_data(classes * batch);
+    // Warm up
+    input->CopyDataToTensor(in_data.data(), in_data.size() * sizeof(float));
+    graph->Run();
+
+    uint32_t run_cnt = (sample_cnt + batch - 1) / batch;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t run = 0; run < run_cnt; ++run) {
+      input->CopyDataToTensor(in_data.data(), in_data.size() * sizeof(float));
+      if (!graph->Run()) {
+        std::cout << "Fatal error: run graph fail" << std::endl;
+        return -1;
+      }
+      output->CopyDataFromTensor(out_data.data());
+    }
+    double ms = ElapsedMs(start);
+
+    std::cout << "\t " << std::setw(5) << batch << std::setw(6)
+              << graph->OpVector().size() << std::setw(11)
+              << report.unrolled_op_count << std::setw(9) << std::fixed
+              << std::setprecision(3) << ms / run_cnt << std::setw(12)
+              << std::setprecision(1) << run_cnt * batch * 1000.0 / ms
+              << "\n";
+  }
+  std::cout << " ===========================================================" << std::endl;
+  return 0;
+}
@@ -31,6 +31,10 @@
 #include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "handle_private.h"
 
 #include "vip_lite.h"
@@ -38,43 +42,112 @@
 namespace tim {
 namespace lite {
 
-ExecutionImpl::ExecutionImpl(const void* executable, size_t executable_size) {
-    vip_status_e status = VIP_SUCCESS;
+std::shared_ptr<NetworkImage> NetworkImage::CreateFromMemory(
+    const void* executable, size_t executable_size) {
+    std::shared_ptr<NetworkImage> image(new NetworkImage);
+    if (vip_init() != VIP_SUCCESS) {
+        return nullptr;
+    }
+    image->initialized_ = true;
+    // The driver only reads the executable, no need for a private copy
     vip_network network = nullptr;
-    std::vector<uint8_t> data(executable_size);
-    valid_ = false;
-    status = vip_init();
-    if (status != VIP_SUCCESS) {
-        return;
+    vip_status_e status = vip_create_network(const_cast<void*>(executable),
+        executable_size, VIP_CREATE_NETWORK_FROM_MEMORY, &network);
+    if (!image->Prepare(status, network)) {
+        return nullptr;
     }
-    memcpy(data.data(), executable, executable_size);
-    status = vip_create_network(data.data(), data.size(),
-        VIP_CREATE_NETWORK_FROM_MEMORY, &network);
+    return image;
+}
+
+std::shared_ptr<NetworkImage> NetworkImage::CreateFromFile(
+    const std::string& path) {
+    std::shared_ptr<NetworkImage> image(new NetworkImage);
+    if (vip_init() != VIP_SUCCESS) {
+        return nullptr;
+    }
+    image->initialized_ = true;
+    vip_network network = nullptr;
+    vip_status_e status = vip_create_network(
+        const_cast<char*>(path.c_str()), 0, VIP_CREATE_NETWORK_FROM_FILE,
+        &network);
     if (status == VIP_SUCCESS && network) {
-        status = vip_prepare_network(network);
-        if (status == VIP_SUCCESS) {
-            network_ = network;
-            valid_ = true;
-        } else {
-            vip_destroy_network(network);
-        }
+        return image->Prepare(status, network) ? image : nullptr;
     }
-    if (!valid_) {
+
+    // Drivers without file loading get a read-only mapping, so the pages
+    // stay in the page cache instead of a heap copy
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "Open " << path << " failed." << std::endl;
+        return nullptr;
+    }
+    struct stat st;
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cout << "Map " << path << " failed." << std::endl;
+        return nullptr;
+    }
+    madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+    network = nullptr;
+    status = vip_create_network(mapping, st.st_size,
+        VIP_CREATE_NETWORK_FROM_MEMORY, &network);
+    bool prepared = image->Prepare(status, network);
+    munmap(mapping, st.st_size);
+    return prepared ? image : nullptr;
+}
+
+bool NetworkImage::Prepare(vip_status_e status, vip_network network) {
+    if (status != VIP_SUCCESS || !network) {
+        return false;
+    }
+    if (vip_prepare_network(network) != VIP_SUCCESS) {
+        vip_destroy_network(network);
+        return false;
+    }
+    network_ = network;
+    return true;
+}
+
+NetworkImage::~NetworkImage() {
+    if (network_) {
+        vip_finish_network(network_);
+        vip_destroy_network(network_);
+    }
+    if (initialized_) {
         vip_destroy();
     }
 }
 
+ExecutionImpl::ExecutionImpl(const std::shared_ptr<NetworkImage>& image)
+    : image_(image), valid_(image != nullptr),
+      network_(image ? image->network() : nullptr) {}
+
 ExecutionImpl::~ExecutionImpl() {
     if (!valid_) {
         return;
     }
-    if (network_) {
-        vip_finish_network(network_);
-        vip_destroy_network(network_);
+    if (pending_.valid()) {
+        pending_.get();
+    }
+    {
+        std::lock_guard<std::mutex> lock(image_->mutex());
+        if (image_->owner_ == this) {
+            image_->owner_ = nullptr;
+        }
     }
     input_handles_.clear();
     output_handles_.clear();
-    vip_destroy();
+}
+
+std::shared_ptr<Execution> ExecutionImpl::Fork() {
+    if (!IsValid()) {
+        return nullptr;
+    }
+    return std::make_shared<ExecutionImpl>(image_);
 }
 
 std::shared_ptr<Handle> ExecutionImpl::CreateInputHandle(uint32_t in_idx, uint8_t* buffer, size_t size) {
@@ -99,17 +172,25 @@ Execution& ExecutionImpl::BindInputs(const std::vector<std::shared_ptr<Handle>>&
     if (!IsValid()) {
         return *this;
     }
+    std::unique_lock<std::mutex> lock(image_->mutex());
+    WaitBindable(lock);
     for (auto handle : handles) {
-        if (input_handles_.end() == std::find(input_handles_.begin(), input_handles_.end(), handle)) {
-            input_handles_.push_back(handle);
-            auto handle_impl = std::dynamic_pointer_cast<HandleImpl>(handle);
-            vip_status_e status = vip_set_input(network_, handle_impl->Index(), handle_impl->VipHandle());
-            if (status != VIP_SUCCESS) {
-                std::cout << "Set input for network failed." << std::endl;
-                assert(false);
-            }
-        } else {
+        auto handle_impl = std::dynamic_pointer_cast<HandleImpl>(handle);
+        auto& bound = input_handles_[handle_impl->Index()];
+        if (bound == handle) {
             std::cout << "The input handle has been binded, need not bind it again." << std::endl;
+            continue;
+        }
+        // A handle of the same index is replaced
+        bound = handle;
+        if (image_->owner_ != this) {
+            // Set with the other bindings at the next Trigger
+            continue;
+        }
+        vip_status_e status = vip_set_input(network_, handle_impl->Index(), handle_impl->VipHandle());
+        if (status != VIP_SUCCESS) {
+            std::cout << "Set input for network failed." << std::endl;
+            assert(false);
         }
     }
     return *this;
@@ -119,33 +200,51 @@ Execution& ExecutionImpl::BindOutputs(const std::vector<std::shared_ptr<Handle>>
     if (!IsValid()) {
         return *this;
     }
+    std::unique_lock<std::mutex> lock(image_->mutex());
+    WaitBindable(lock);
     for (auto handle : handles) {
-        if (output_handles_.end() == std::find(output_handles_.begin(), output_handles_.end(), handle)) {
-            output_handles_.push_back(handle);
-            auto handle_impl = std::dynamic_pointer_cast<HandleImpl>(handle);
-            vip_status_e status = vip_set_output(network_, handle_impl->Index(), handle_impl->VipHandle());
-            if (status != VIP_SUCCESS) {
-                std::cout << "Set output for network failed." << std::endl;
-                assert(false);
-            }
-        } else {
+        auto handle_impl = std::dynamic_pointer_cast<HandleImpl>(handle);
+        auto& bound = output_handles_[handle_impl->Index()];
+        if (bound == handle) {
             std::cout << "The output handle has been binded, need not bind it again." << std::endl;
+            continue;
+        }
+        bound = handle;
+        if (image_->owner_ != this) {
+            continue;
+        }
+        vip_status_e status = vip_set_output(network_, handle_impl->Index(), handle_impl->VipHandle());
+        if (status != VIP_SUCCESS) {
+            std::cout << "Set output for network failed." << std::endl;
+            assert(false);
         }
     }
     return *this;
 };
 
 Execution& ExecutionImpl::UnBindInput(const std::shared_ptr<Handle>& handle) {
-    auto it = std::find(input_handles_.begin(), input_handles_.end(), handle);
-    if (input_handles_.end() != it) {
+    if (!IsValid()) {
+        return *this;
+    }
+    std::unique_lock<std::mutex> lock(image_->mutex());
+    WaitBindable(lock);
+    auto handle_impl = std::dynamic_pointer_cast<HandleImpl>(handle);
+    auto it = input_handles_.find(handle_impl->Index());
+    if (input_handles_.end() != it && it->second == handle) {
         input_handles_.erase(it);
     }
     return *this;
 }
 
 Execution& ExecutionImpl::UnBindOutput(const std::shared_ptr<Handle>& handle) {
-    auto it = std::find(output_handles_.begin(), output_handles_.end(), handle);
-    if (output_handles_.end() != it) {
+    if (!IsValid()) {
+        return *this;
+    }
+    std::unique_lock<std::mutex> lock(image_->mutex());
+    WaitBindable(lock);
+    auto handle_impl = std::dynamic_pointer_cast<HandleImpl>(handle);
+    auto it = output_handles_.find(handle_impl->Index());
+    if (output_handles_.end() != it && it->second == handle) {
         output_handles_.erase(it);
     }
     return *this;
@@ -155,21 +254,121 @@ bool ExecutionImpl::Trigger() {
     if (!IsValid()) {
         return false;
     }
+    std::unique_lock<std::mutex> lock(image_->mutex());
+    if (!Acquire(lock)) {
+        return false;
+    }
+    lock.unlock();
     vip_status_e status = vip_run_network(network_);
+    Release();
     return status == VIP_SUCCESS;
 };
 
+bool ExecutionImpl::Submit() {
+    if (!IsValid() || pending_.valid()) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(image_->mutex());
+    if (!Acquire(lock)) {
+        return false;
+    }
+    lock.unlock();
+#ifdef TIM_VX_VIPLITE_ASYNC
+    vip_status_e status = vip_trigger_network(network_);
+    if (status != VIP_SUCCESS) {
+        Release();
+        return false;
+    }
+    // Wait on a helper thread, so the network is released as soon as it
+    // finishes even if nobody calls Wait()
+    pending_ = std::async(std::launch::async, [this]() {
+        vip_status_e status = vip_wait_network(network_);
+        Release();
+        return status == VIP_SUCCESS;
+    });
+#else
+    // The driver has no asynchronous trigger, run on a helper thread
+    pending_ = std::async(std::launch::async, [this]() {
+        vip_status_e status = vip_run_network(network_);
+        Release();
+        return status == VIP_SUCCESS;
+    });
+#endif
+    return true;
+}
+
+bool ExecutionImpl::Wait() {
+    if (!pending_.valid()) {
+        return false;
+    }
+    return pending_.get();
+}
+
+bool ExecutionImpl::Acquire(std::unique_lock<std::mutex>& lock) {
+    image_->idle_cond().wait(lock, [this]() { return !image_->running_; });
+    if (!Activate()) {
+        return false;
+    }
+    image_->running_ = true;
+    return true;
+}
+
+void ExecutionImpl::WaitBindable(std::unique_lock<std::mutex>& lock) {
+    image_->idle_cond().wait(lock, [this]() {
+        return image_->owner_ != this || !image_->running_;
+    });
+}
+
+void ExecutionImpl::Release() {
+    std::lock_guard<std::mutex> lock(image_->mutex());
+    image_->running_ = false;
+    image_->idle_cond().notify_all();
+}
+
+bool ExecutionImpl::Activate() {
+    if (image_->owner_ == this) {
+        return true;
+    }
+    for (const auto& bound : input_handles_) {
+        auto handle_impl = std::dynamic_pointer_cast<HandleImpl>(bound.second);
+        if (vip_set_input(network_, bound.first,
+                          handle_impl->VipHandle()) != VIP_SUCCESS) {
+            std::cout << "Set input for network failed." << std::endl;
+            return false;
+        }
+    }
+    for (const auto& bound : output_handles_) {
+        auto handle_impl = std::dynamic_pointer_cast<HandleImpl>(bound.second);
+        if (vip_set_output(network_, bound.first,
+                           handle_impl->VipHandle()) != VIP_SUCCESS) {
+            std::cout << "Set output for network failed." << std::endl;
+            return false;
+        }
+    }
+    image_->owner_ = this;
+    return true;
+}
+
 std::shared_ptr<Execution> Execution::Create(
     const void* executable, size_t executable_size) {
     std::shared_ptr<ExecutionImpl> exec;
     if (executable && executable_size) {
-        exec = std::make_shared<ExecutionImpl>(executable, executable_size);
-        if (!exec->IsValid()) {
-            exec.reset();
+        auto image = NetworkImage::CreateFromMemory(executable, executable_size);
+        if (image) {
+            exec = std::make_shared<ExecutionImpl>(image);
         }
     }
     return exec;
 }
 
+std::shared_ptr<Execution> Execution::CreateFromFile(const std::string& path) {
+    std::shared_ptr<ExecutionImpl> exec;
+    auto image = NetworkImage::CreateFromFile(path);
+    if (image) {
+        exec = std::make_shared<ExecutionImpl>(image);
+    }
+    return exec;
+}
+
 }
 }
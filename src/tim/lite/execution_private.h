@@ -24,9 +24,13 @@
 #ifndef TIM_LITE_EXECUTION_PRIVATE_H_
 #define TIM_LITE_EXECUTION_PRIVATE_H_
 
+#include <condition_variable>
+#include <future>
 #include <vector>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <string>
 
 #include "tim/lite/execution.h"
 #include "handle_private.h"
@@ -35,10 +39,41 @@
 namespace tim {
 namespace lite {
 
+/// Prepared vip_network and the driver reference it holds, shared by the
+/// Executions forked from one another
+class NetworkImage {
+ public:
+  static std::shared_ptr<NetworkImage> CreateFromMemory(
+      const void* executable, size_t executable_size);
+  static std::shared_ptr<NetworkImage> CreateFromFile(const std::string& path);
+  ~NetworkImage();
+
+  vip_network network() { return network_; }
+  /// Guards the bindings set on the network and running_
+  std::mutex& mutex() { return mutex_; }
+  /// Signaled when a submitted execution finishes
+  std::condition_variable& idle_cond() { return idle_cond_; }
+  /// Execution whose bindings are set on the network, guarded by mutex()
+  const void* owner_ = nullptr;
+  /// A submitted execution runs, nobody may touch the bindings
+  bool running_ = false;
+
+ private:
+  NetworkImage() = default;
+  /// Take ownership of a created network and prepare it
+  bool Prepare(vip_status_e status, vip_network network);
+
+  bool initialized_ = false;
+  vip_network network_ = nullptr;
+  std::mutex mutex_;
+  std::condition_variable idle_cond_;
+};
+
 class ExecutionImpl : public Execution {
  public:
-  ExecutionImpl(const void* executable, size_t executable_size);
+  ExecutionImpl(const std::shared_ptr<NetworkImage>& image);
   ~ExecutionImpl();
+  std::shared_ptr<Execution> Fork() override;
   std::shared_ptr<Handle> CreateInputHandle(uint32_t in_idx, uint8_t* buffer,
                                             size_t size) override;
   std::shared_ptr<Handle> CreateOutputHandle(uint32_t out_idx, uint8_t* buffer,
@@ -50,12 +85,29 @@ class ExecutionImpl : public Execution {
   Execution& UnBindInput(const std::shared_ptr<Handle>& Handle) override;
   Execution& UnBindOutput(const std::shared_ptr<Handle>& handle) override;
   bool Trigger() override;
+  bool Submit() override;
+  bool Wait() override;
   bool IsValid() const { return valid_; };
   vip_network network() { return network_; };
 
  private:
-  std::vector<std::shared_ptr<Handle>> input_handles_;
-  std::vector<std::shared_ptr<Handle>> output_handles_;
+  /// Set the bindings of this Execution on the shared network if another
+  /// Execution set its own, call with the image mutex held
+  bool Activate();
+  /// Wait for the network to be idle and take it, `lock` holds the image
+  /// mutex
+  bool Acquire(std::unique_lock<std::mutex>& lock);
+  void Release();
+  /// Wait until the network doesn't run with the bindings of this
+  /// Execution, `lock` holds the image mutex
+  void WaitBindable(std::unique_lock<std::mutex>& lock);
+
+  /// Bound handles by input or output index
+  std::map<uint32_t, std::shared_ptr<Handle>> input_handles_;
+  std::map<uint32_t, std::shared_ptr<Handle>> output_handles_;
+  std::shared_ptr<NetworkImage> image_;
+  /// Result of the pending Submit()
+  std::future<bool> pending_;
   bool valid_;
   vip_network network_;
 };
@@ -0,0 +1,198 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "handle_ring_private.h"
+
+#include <iostream>
+
+namespace tim {
+namespace lite {
+
+namespace {
+constexpr size_t kBufferAlign = 64;
+}
+
+std::shared_ptr<HandleRing> HandleRing::Create(
+    const std::shared_ptr<Execution>& execution,
+    const std::vector<size_t>& input_sizes,
+    const std::vector<size_t>& output_sizes, uint32_t depth) {
+    if (!execution || depth == 0) {
+        return nullptr;
+    }
+    auto ring = std::make_shared<HandleRingImpl>(execution);
+    if (!ring->Init(input_sizes, output_sizes, depth)) {
+        return nullptr;
+    }
+    return ring;
+}
+
+HandleRingImpl::HandleRingImpl(const std::shared_ptr<Execution>& execution)
+    : execution_(execution) {}
+
+HandleRingImpl::~HandleRingImpl() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    queued_.clear();
+    cond_.wait(lock, [this]() { return !reaping_; });
+    if (running_ >= 0) {
+        execution_->Wait();
+    }
+    if (bound_ >= 0) {
+        for (const auto& handle : slots_[bound_].inputs) {
+            execution_->UnBindInput(handle);
+        }
+        for (const auto& handle : slots_[bound_].outputs) {
+            execution_->UnBindOutput(handle);
+        }
+    }
+}
+
+bool HandleRingImpl::Init(const std::vector<size_t>& input_sizes,
+                          const std::vector<size_t>& output_sizes,
+                          uint32_t depth) {
+    auto alloc = [](size_t size) {
+        size = (size + kBufferAlign - 1) / kBufferAlign * kBufferAlign;
+        return std::unique_ptr<uint8_t, FreeDeleter>(
+            static_cast<uint8_t*>(aligned_alloc(kBufferAlign, size)));
+    };
+    slots_.resize(depth);
+    for (uint32_t i = 0; i < depth; ++i) {
+        Slot& slot = slots_[i];
+        for (uint32_t in = 0; in < input_sizes.size(); ++in) {
+            slot.buffers.push_back(alloc(input_sizes[in]));
+            auto handle = execution_->CreateInputHandle(
+                in, slot.buffers.back().get(), input_sizes[in]);
+            if (!handle) {
+                std::cout << "Create input handle " << in << " failed." << std::endl;
+                return false;
+            }
+            slot.inputs.push_back(handle);
+        }
+        for (uint32_t out = 0; out < output_sizes.size(); ++out) {
+            slot.buffers.push_back(alloc(output_sizes[out]));
+            auto handle = execution_->CreateOutputHandle(
+                out, slot.buffers.back().get(), output_sizes[out]);
+            if (!handle) {
+                std::cout << "Create output handle " << out << " failed." << std::endl;
+                return false;
+            }
+            slot.outputs.push_back(handle);
+        }
+        free_.push_back(i);
+    }
+    return true;
+}
+
+uint8_t* HandleRingImpl::InputBuffer(uint32_t slot, uint32_t in_idx) {
+    return slots_[slot].buffers[in_idx].get();
+}
+
+uint8_t* HandleRingImpl::OutputBuffer(uint32_t slot, uint32_t out_idx) {
+    return slots_[slot].buffers[slots_[slot].inputs.size() + out_idx].get();
+}
+
+uint32_t HandleRingImpl::Acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return !free_.empty(); });
+    uint32_t slot = free_.front();
+    free_.pop_front();
+    return slot;
+}
+
+bool HandleRingImpl::Submit(uint32_t slot) {
+    for (const auto& handle : slots_[slot].inputs) {
+        if (!handle->Flush()) {
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_.push_back(slot);
+    Start();
+    cond_.notify_all();
+    return true;
+}
+
+int32_t HandleRingImpl::Wait(bool* ok) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (!done_.empty()) {
+            auto done = done_.front();
+            done_.pop_front();
+            if (ok) {
+                *ok = done.second;
+            }
+            return done.first;
+        }
+        if (running_ < 0 && queued_.empty()) {
+            return -1;
+        }
+        if (running_ >= 0 && !reaping_) {
+            reaping_ = true;
+            uint32_t slot = running_;
+            lock.unlock();
+            bool result = execution_->Wait();
+            for (const auto& handle : slots_[slot].outputs) {
+                result = handle->Invalidate() && result;
+            }
+            lock.lock();
+            reaping_ = false;
+            running_ = -1;
+            done_.emplace_back(slot, result);
+            Start();
+            cond_.notify_all();
+            continue;
+        }
+        cond_.wait(lock);
+    }
+}
+
+void HandleRingImpl::Release(uint32_t slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(slot);
+    cond_.notify_all();
+}
+
+void HandleRingImpl::Start() {
+    while (running_ < 0 && !queued_.empty()) {
+        uint32_t slot = queued_.front();
+        queued_.pop_front();
+        Bind(slot);
+        if (execution_->Submit()) {
+            running_ = slot;
+        } else {
+            done_.emplace_back(slot, false);
+        }
+    }
+}
+
+void HandleRingImpl::Bind(uint32_t slot) {
+    if (bound_ == static_cast<int32_t>(slot)) {
+        return;
+    }
+    // Handles of the same index replace the ones of the previous slot
+    execution_->BindInputs(slots_[slot].inputs);
+    execution_->BindOutputs(slots_[slot].outputs);
+    bound_ = slot;
+}
+
+}  // namespace lite
+}  // namespace tim
@@ -0,0 +1,86 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_LITE_HANDLE_RING_PRIVATE_H_
+#define TIM_LITE_HANDLE_RING_PRIVATE_H_
+
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+#include "tim/lite/handle_ring.h"
+
+namespace tim {
+namespace lite {
+
+class HandleRingImpl : public HandleRing {
+ public:
+  HandleRingImpl(const std::shared_ptr<Execution>& execution);
+  ~HandleRingImpl();
+
+  bool Init(const std::vector<size_t>& input_sizes,
+            const std::vector<size_t>& output_sizes, uint32_t depth);
+
+  uint32_t Depth() const override { return slots_.size(); }
+  uint8_t* InputBuffer(uint32_t slot, uint32_t in_idx) override;
+  uint8_t* OutputBuffer(uint32_t slot, uint32_t out_idx) override;
+  uint32_t Acquire() override;
+  bool Submit(uint32_t slot) override;
+  int32_t Wait(bool* ok) override;
+  void Release(uint32_t slot) override;
+
+ private:
+  struct FreeDeleter {
+    void operator()(uint8_t* buffer) const { free(buffer); }
+  };
+  struct Slot {
+    // Declared first, so the handles go before their buffers
+    std::vector<std::unique_ptr<uint8_t, FreeDeleter>> buffers;
+    std::vector<std::shared_ptr<Handle>> inputs;
+    std::vector<std::shared_ptr<Handle>> outputs;
+  };
+
+  /// Bind and submit the next queued slot if the execution is idle, call
+  /// with mutex_ held
+  void Start();
+  void Bind(uint32_t slot);
+
+  std::shared_ptr<Execution> execution_;
+  std::vector<Slot> slots_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<uint32_t> free_;
+  std::deque<uint32_t> queued_;
+  /// Finished slots and whether their run succeeded, in submission order
+  std::deque<std::pair<uint32_t, bool>> done_;
+  int32_t running_ = -1;
+  int32_t bound_ = -1;
+  /// A consumer waits for the running slot outside mutex_
+  bool reaping_ = false;
+};
+
+}  // namespace lite
+}  // namespace tim
+#endif
@@ -0,0 +1,672 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/transform/calibration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "graph_private.h"
+#include "operation_private.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/simple_operations.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+
+using TensorMap =
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>;
+using SpecMap = std::map<std::shared_ptr<vx::Tensor>, vx::TensorSpec>;
+
+// Quantized bins of the KL_DIVERGENCE reference distribution
+constexpr uint32_t kEntropyBins = 128;
+
+size_t ElementCount(const vx::ShapeType& shape) {
+  return std::accumulate(shape.begin(), shape.end(), static_cast<size_t>(1),
+                         std::multiplies<size_t>());
+}
+
+// Values recorded for one tensor, the histogram covers [-range, range] and
+// doubles its range when a larger value comes
+struct TensorStats {
+  float min{std::numeric_limits<float>::max()};
+  float max{std::numeric_limits<float>::lowest()};
+  float range{0};
+  std::vector<uint64_t> histogram;
+
+  void Update(const float* data, size_t count, uint32_t bins);
+  // Value below which the share `q` of the recorded values lies
+  float Quantile(double q) const;
+  // Symmetric threshold minimizing the KL divergence to kEntropyBins bins
+  float EntropyThreshold() const;
+};
+
+void TensorStats::Update(const float* data, size_t count, uint32_t bins) {
+  float absmax = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (!std::isfinite(data[i])) continue;
+    min = std::min(min, data[i]);
+    max = std::max(max, data[i]);
+    absmax = std::max(absmax, std::fabs(data[i]));
+  }
+  if (histogram.empty()) {
+    histogram.assign(bins, 0);
+    range = absmax > 0 ? absmax : 1e-6f;
+  }
+  while (absmax > range) {
+    // Bin j of [-range, range] falls into bin bins/4 + j/2 of the doubled one
+    std::vector<uint64_t> merged(bins, 0);
+    for (uint32_t j = 0; j < bins; ++j) {
+      merged[bins / 4 + j / 2] += histogram[j];
+    }
+    histogram.swap(merged);
+    range *= 2;
+  }
+  const double width = 2.0 * range / bins;
+  for (size_t i = 0; i < count; ++i) {
+    if (!std::isfinite(data[i])) continue;
+    int64_t bin = static_cast<int64_t>(std::floor((data[i] + range) / width));
+    bin = std::min<int64_t>(std::max<int64_t>(bin, 0), bins - 1);
+    ++histogram[bin];
+  }
+}
+
+float TensorStats::Quantile(double q) const {
+  const double total = std::accumulate(histogram.begin(), histogram.end(), 0.0);
+  const double target = q * total;
+  const double width = 2.0 * range / histogram.size();
+  double cumulated = 0;
+  for (size_t i = 0; i < histogram.size(); ++i) {
+    if (histogram[i] > 0 && cumulated + histogram[i] >= target) {
+      double fraction = (target - cumulated) / histogram[i];
+      return static_cast<float>(-range + (i + fraction) * width);
+    }
+    cumulated += histogram[i];
+  }
+  return range;
+}
+
+float TensorStats::EntropyThreshold() const {
+  const uint32_t half = histogram.size() / 2;
+  std::vector<double> folded(half);
+  for (uint32_t k = 0; k < half; ++k) {
+    folded[k] = histogram[half + k] + histogram[half - 1 - k];
+  }
+
+  double best_divergence = std::numeric_limits<double>::max();
+  uint32_t best_bins = half;
+  std::vector<double> p, q;
+  for (uint32_t bins = kEntropyBins; bins <= half; ++bins) {
+    // Reference: the first `bins` bins, values beyond are clipped into the
+    // last one
+    p.assign(folded.begin(), folded.begin() + bins);
+    p.back() = std::accumulate(folded.begin() + bins - 1, folded.end(), 0.0);
+
+    // Candidate: the same bins merged into kEntropyBins and spread back over
+    // the bins which were not empty
+    q.assign(bins, 0);
+    for (uint32_t b = 0; b < kEntropyBins; ++b) {
+      uint32_t begin = b * bins / kEntropyBins;
+      uint32_t end = (b + 1) * bins / kEntropyBins;
+      double sum = 0;
+      uint32_t used = 0;
+      for (uint32_t j = begin; j < end; ++j) {
+        sum += folded[j];
+        used += folded[j] > 0 ? 1 : 0;
+      }
+      for (uint32_t j = begin; j < end && used > 0; ++j) {
+        if (folded[j] > 0) q[j] = sum / used;
+      }
+    }
+
+    const double p_sum = std::accumulate(p.begin(), p.end(), 0.0);
+    const double q_sum = std::accumulate(q.begin(), q.end(), 0.0);
+    if (p_sum == 0 || q_sum == 0) continue;
+    double divergence = 0;
+    for (uint32_t j = 0; j < bins; ++j) {
+      if (p[j] == 0) continue;
+      double pj = p[j] / p_sum;
+      double qj = std::max(q[j] / q_sum, 1e-10);
+      divergence += pj * std::log(pj / qj);
+    }
+    if (divergence < best_divergence) {
+      best_divergence = divergence;
+      best_bins = bins;
+    }
+  }
+  return static_cast<float>(best_bins * (static_cast<double>(range) / half));
+}
+
+void QuantLimits(vx::DataType type, int64_t* qmin, int64_t* qmax) {
+  switch (type) {
+    case vx::DataType::INT8:
+      *qmin = std::numeric_limits<int8_t>::min();
+      *qmax = std::numeric_limits<int8_t>::max();
+      break;
+    case vx::DataType::INT32:
+      *qmin = std::numeric_limits<int32_t>::min();
+      *qmax = std::numeric_limits<int32_t>::max();
+      break;
+    default:
+      *qmin = std::numeric_limits<uint8_t>::min();
+      *qmax = std::numeric_limits<uint8_t>::max();
+      break;
+  }
+}
+
+// Asymmetric quantization of [min, max], widened to hold 0 exactly
+vx::Quantization AsymmetricQuant(float min, float max, vx::DataType type) {
+  int64_t qmin, qmax;
+  QuantLimits(type, &qmin, &qmax);
+  min = std::min(min, 0.0f);
+  max = std::max(max, 0.0f);
+  float scale = (max - min) / static_cast<float>(qmax - qmin);
+  if (!(scale > 0)) scale = 1.0f;
+  int64_t zero_point = static_cast<int64_t>(std::round(qmin - min / scale));
+  zero_point = std::min(std::max(zero_point, qmin), qmax);
+  return vx::Quantization(vx::QuantType::ASYMMETRIC, scale,
+                          static_cast<int32_t>(zero_point));
+}
+
+// Elements of a channel are `inner` apart and channels repeat every
+// `inner * channels` elements
+void ChannelLayout(const vx::ShapeType& shape, const vx::Quantization& quant,
+                   size_t* inner, size_t* channels) {
+  *inner = 1;
+  *channels = 1;
+  if (quant.Type() == vx::QuantType::SYMMETRIC_PER_CHANNEL) {
+    for (int32_t d = 0; d < quant.ChannelDim(); ++d) *inner *= shape[d];
+    *channels = shape[quant.ChannelDim()];
+  }
+}
+
+// Int8 symmetric quantization of each channel along `channel_dim`
+vx::Quantization PerChannelQuant(const float* data, const vx::ShapeType& shape,
+                                 int32_t channel_dim) {
+  vx::Quantization quant(vx::QuantType::SYMMETRIC_PER_CHANNEL, channel_dim,
+                         {}, {});
+  size_t inner, channels;
+  ChannelLayout(shape, quant, &inner, &channels);
+  std::vector<float> absmax(channels, 0);
+  for (size_t i = 0; i < ElementCount(shape); ++i) {
+    size_t c = (i / inner) % channels;
+    absmax[c] = std::max(absmax[c], std::fabs(data[i]));
+  }
+  for (auto& m : absmax) m = m > 0 ? m / 127.0f : 1.0f;
+  quant.SetScales(absmax);
+  quant.SetZeroPoints(std::vector<int32_t>(channels, 0));
+  return quant;
+}
+
+std::vector<uint8_t> QuantizeData(const float* data,
+                                  const vx::TensorSpec& spec) {
+  int64_t qmin, qmax;
+  QuantLimits(spec.datatype_, &qmin, &qmax);
+  size_t inner, channels;
+  ChannelLayout(spec.shape_, spec.quantization_, &inner, &channels);
+  const auto& scales = spec.quantization_.Scales();
+  const auto& zero_points = spec.quantization_.ZeroPoints();
+  const size_t count = ElementCount(spec.shape_);
+  const size_t element_size = spec.datatype_ == vx::DataType::INT32 ? 4 : 1;
+
+  std::vector<uint8_t> bytes(count * element_size);
+  for (size_t i = 0; i < count; ++i) {
+    size_t c = (i / inner) % channels;
+    int64_t value = std::llround(data[i] / scales[c]) + zero_points[c];
+    value = std::min(std::max(value, qmin), qmax);
+    if (spec.datatype_ == vx::DataType::INT32) {
+      int32_t v = static_cast<int32_t>(value);
+      memcpy(bytes.data() + i * element_size, &v, sizeof(v));
+    } else if (spec.datatype_ == vx::DataType::INT8) {
+      bytes[i] = static_cast<uint8_t>(static_cast<int8_t>(value));
+    } else {
+      bytes[i] = static_cast<uint8_t>(value);
+    }
+  }
+  return bytes;
+}
+
+// Constant operands whose quantization depends on the operation they feed
+struct ConstRole {
+  enum Kind { WEIGHT, BIAS } kind;
+  std::shared_ptr<vx::Tensor> input;
+  std::shared_ptr<vx::Tensor> weight;
+  // Output channel dimension of the weights, -1 if only per tensor
+  int32_t channel_dim;
+};
+
+std::map<std::shared_ptr<vx::Tensor>, ConstRole> ConstRoles(
+    const std::shared_ptr<vx::Graph>& graph) {
+  std::map<std::shared_ptr<vx::Tensor>, ConstRole> roles;
+  for (const auto& op : graph->OpVector()) {
+    const auto& impl = op->impl();
+    auto inputs = impl->InputsTensor();
+    if (inputs.size() < 2 || !inputs[1]->IsConstTensor()) continue;
+    const int32_t last_dim =
+        static_cast<int32_t>(inputs[1]->GetShape().size()) - 1;
+    int32_t channel_dim = -1;
+    switch (impl->operation_id_) {
+      case VSI_NN_OP_CONV2D:
+        // Depthwise kernels are WHOI, others WHIO
+        channel_dim =
+            impl->node()->nn_param.conv2d.multiplier > 0 ? 2 : last_dim;
+        break;
+      case VSI_NN_OP_GROUPED_CONV2D:
+      case VSI_NN_OP_FCL2:
+        channel_dim = last_dim;
+        break;
+      case VSI_NN_OP_DECONVOLUTION:
+        break;
+      default:
+        continue;
+    }
+    roles[inputs[1]] = {ConstRole::WEIGHT, inputs[0], inputs[1], channel_dim};
+    if (inputs.size() > 2 && inputs[2]->IsConstTensor()) {
+      roles[inputs[2]] = {ConstRole::BIAS, inputs[0], inputs[1], channel_dim};
+    }
+  }
+  return roles;
+}
+
+class CalibratorImpl : public Calibrator {
+ public:
+  CalibratorImpl(const std::shared_ptr<vx::Graph>& graph,
+                 const std::shared_ptr<vx::Context>& ctx,
+                 const CalibrationOptions& options)
+      : src_graph_(graph), ctx_(ctx), options_(options) {
+    options_.histogram_bins =
+        std::max<uint32_t>(options_.histogram_bins, 2 * kEntropyBins) / 4 * 4;
+    options_.percentile =
+        std::min(std::max(options_.percentile, 50.0f), 100.0f);
+  }
+
+  bool Feed(const std::vector<std::vector<float>>& inputs) override;
+  bool Observe(const std::shared_ptr<vx::Tensor>& tensor, const float* data,
+               size_t count) override;
+  uint32_t SampleCount() const override { return samples_; }
+  bool GetRange(const std::shared_ptr<vx::Tensor>& tensor,
+                TensorRange* range) const override;
+  std::pair<std::shared_ptr<vx::Graph>, TensorMap> Quantize(
+      std::shared_ptr<vx::Context>& ctx) override;
+
+ private:
+  // Build the graph reporting every float32 tensor of the source graph
+  bool Prepare();
+  bool QuantizedSpec(
+      const std::shared_ptr<vx::Tensor>& tensor,
+      const std::map<std::shared_ptr<vx::Tensor>, ConstRole>& roles,
+      SpecMap& specs, vx::TensorSpec* spec) const;
+
+  std::shared_ptr<vx::Graph> src_graph_;
+  std::shared_ptr<vx::Context> ctx_;
+  CalibrationOptions options_;
+  std::shared_ptr<vx::Graph> probe_;
+  std::vector<std::shared_ptr<vx::Tensor>> probe_inputs_;
+  // Source tensor and the probe tensor holding its values
+  std::vector<std::pair<std::shared_ptr<vx::Tensor>,
+                        std::shared_ptr<vx::Tensor>>> observed_;
+  std::map<std::shared_ptr<vx::Tensor>, TensorStats> stats_;
+  uint32_t samples_{0};
+};
+
+bool CalibratorImpl::Prepare() {
+  if (probe_) {
+    return true;
+  }
+  if (!src_graph_->Compile()) {
+    VSILOGE("Fail to compile the source graph");
+    return false;
+  }
+  vsi_nn_graph_t* src =
+      reinterpret_cast<vx::GraphImpl*>(src_graph_.get())->graph();
+  auto probe = ctx_->CreateGraph();
+  TensorMap tensor_map;
+  std::vector<std::pair<std::shared_ptr<vx::Tensor>,
+                        std::shared_ptr<vx::Tensor>>> observed;
+  auto tensor_of = [&](const std::shared_ptr<vx::Tensor>& t) {
+    auto it = tensor_map.find(t);
+    if (it != tensor_map.end()) {
+      return it->second;
+    }
+    std::shared_ptr<vx::Tensor> dst;
+    if (t->IsPlaceHolder()) {
+      dst = probe->CreateTensorPlaceHolder();
+    } else if (t->IsConstTensor()) {
+      dst = probe->CreateTensor(t->GetSpec(), t->GetDataRef());
+    } else if (t->GetSpec().datatype_ == vx::DataType::FLOAT32) {
+      auto spec = t->GetSpec();
+      if (spec.attr_ == vx::TensorAttribute::TRANSIENT) {
+        // Shape inferred by the compiled source graph
+        vsi_nn_tensor_t* inferred = vsi_nn_GetTensor(src, t->GetId());
+        if (inferred) {
+          spec.shape_.assign(inferred->attr.size,
+                             inferred->attr.size + inferred->attr.dim_num);
+        }
+        spec.attr_ = vx::TensorAttribute::OUTPUT;
+      }
+      dst = probe->CreateTensor(spec);
+      observed.emplace_back(t, dst);
+    } else {
+      dst = probe->CreateTensor(t->GetSpec());
+    }
+    tensor_map[t] = dst;
+    return dst;
+  };
+  std::vector<std::shared_ptr<vx::Tensor>> inputs;
+  for (const auto& t : src_graph_->InputsTensor()) {
+    inputs.push_back(tensor_of(t));
+  }
+  for (const auto& op : src_graph_->OpVector()) {
+    auto cloned = op->Clone(probe);
+    std::vector<std::shared_ptr<vx::Tensor>> op_inputs, op_outputs;
+    for (const auto& t : op->impl()->InputsTensor()) {
+      op_inputs.push_back(tensor_of(t));
+    }
+    for (const auto& t : op->impl()->OutputsTensor()) {
+      op_outputs.push_back(tensor_of(t));
+    }
+    cloned->BindInputs(op_inputs).BindOutputs(op_outputs);
+  }
+  if (!probe->Compile()) {
+    VSILOGE("Fail to compile the calibration graph");
+    return false;
+  }
+  probe_ = probe;
+  probe_inputs_ = inputs;
+  observed_ = observed;
+  return true;
+}
+
+bool CalibratorImpl::Feed(const std::vector<std::vector<float>>& inputs) {
+  if (inputs.size() != src_graph_->InputsTensor().size()) {
+    VSILOGE("Expect %zu inputs, got %zu", src_graph_->InputsTensor().size(),
+            inputs.size());
+    return false;
+  }
+  if (!Prepare()) {
+    return false;
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    size_t count = ElementCount(probe_inputs_[i]->GetShape());
+    if (inputs[i].size() != count) {
+      VSILOGE("Input %zu holds %zu values, expect %zu", i, inputs[i].size(),
+              count);
+      return false;
+    }
+    if (!probe_inputs_[i]->CopyDataToTensor(inputs[i].data(),
+                                            count * sizeof(float))) {
+      return false;
+    }
+  }
+  if (!probe_->Run()) {
+    VSILOGE("Fail to run the calibration graph");
+    return false;
+  }
+  std::vector<float> values;
+  for (const auto& o : observed_) {
+    values.resize(ElementCount(o.second->GetShape()));
+    if (!o.second->CopyDataFromTensor(values.data())) {
+      return false;
+    }
+    stats_[o.first].Update(values.data(), values.size(),
+                           options_.histogram_bins);
+  }
+  ++samples_;
+  return true;
+}
+
+bool CalibratorImpl::Observe(const std::shared_ptr<vx::Tensor>& tensor,
+                             const float* data, size_t count) {
+  if (!tensor || !data || count == 0) {
+    VSILOGE("Nothing to observe");
+    return false;
+  }
+  stats_[tensor].Update(data, count, options_.histogram_bins);
+  return true;
+}
+
+bool CalibratorImpl::GetRange(const std::shared_ptr<vx::Tensor>& tensor,
+                              TensorRange* range) const {
+  auto it = stats_.find(tensor);
+  if (it == stats_.end() || it->second.min > it->second.max) {
+    return false;
+  }
+  const TensorStats& stats = it->second;
+  range->min = stats.min;
+  range->max = stats.max;
+  switch (options_.method) {
+    case CalibrationMethod::PERCENTILE: {
+      double share = options_.percentile / 100.0;
+      range->min = std::max(stats.min, stats.Quantile(1.0 - share));
+      range->max = std::min(stats.max, stats.Quantile(share));
+      break;
+    }
+    case CalibrationMethod::KL_DIVERGENCE: {
+      float threshold = stats.EntropyThreshold();
+      range->min = std::max(stats.min, -threshold);
+      range->max = std::min(stats.max, threshold);
+      break;
+    }
+    default:
+      break;
+  }
+  return true;
+}
+
+bool CalibratorImpl::QuantizedSpec(
+    const std::shared_ptr<vx::Tensor>& tensor,
+    const std::map<std::shared_ptr<vx::Tensor>, ConstRole>& roles,
+    SpecMap& specs, vx::TensorSpec* spec) const {
+  auto found = specs.find(tensor);
+  if (found != specs.end()) {
+    *spec = found->second;
+    return true;
+  }
+  *spec = tensor->GetSpec();
+  if (spec->datatype_ != vx::DataType::FLOAT32) {
+    specs[tensor] = *spec;
+    return true;
+  }
+
+  const vx::DataType type = options_.data_type;
+  auto role = roles.find(tensor);
+  if (!tensor->IsConstTensor()) {
+    TensorRange range;
+    if (!GetRange(tensor, &range)) {
+      VSILOGE("No calibration values for tensor %u", tensor->GetId());
+      return false;
+    }
+    spec->datatype_ = type;
+    spec->quantization_ = AsymmetricQuant(range.min, range.max, type);
+  } else if (role != roles.end() && role->second.kind == ConstRole::BIAS) {
+    vx::TensorSpec input_spec, weight_spec;
+    if (!QuantizedSpec(role->second.input, roles, specs, &input_spec) ||
+        !QuantizedSpec(role->second.weight, roles, specs, &weight_spec)) {
+      return false;
+    }
+    const float input_scale = input_spec.quantization_.Scales().empty()
+                                  ? 1.0f
+                                  : input_spec.quantization_.Scales()[0];
+    std::vector<float> scales = weight_spec.quantization_.Scales();
+    for (auto& s : scales) s *= input_scale;
+    spec->datatype_ = vx::DataType::INT32;
+    if (scales.size() > 1) {
+      spec->quantization_ = vx::Quantization(
+          vx::QuantType::SYMMETRIC_PER_CHANNEL, 0, scales,
+          std::vector<int32_t>(scales.size(), 0));
+    } else {
+      spec->quantization_ = vx::Quantization(
+          vx::QuantType::ASYMMETRIC, scales.empty() ? 1.0f : scales[0], 0);
+    }
+  } else {
+    const float* data = static_cast<const float*>(tensor->GetDataRef());
+    const size_t count = ElementCount(spec->shape_);
+    if (role != roles.end() && options_.per_channel_weights &&
+        role->second.channel_dim >= 0) {
+      spec->datatype_ = vx::DataType::INT8;
+      spec->quantization_ =
+          PerChannelQuant(data, spec->shape_, role->second.channel_dim);
+    } else {
+      auto minmax = std::minmax_element(data, data + count);
+      spec->datatype_ = type;
+      spec->quantization_ =
+          count > 0 ? AsymmetricQuant(*minmax.first, *minmax.second, type)
+                    : AsymmetricQuant(0, 0, type);
+    }
+  }
+  specs[tensor] = *spec;
+  return true;
+}
+
+std::pair<std::shared_ptr<vx::Graph>, TensorMap> CalibratorImpl::Quantize(
+    std::shared_ptr<vx::Context>& ctx) {
+  auto graph = ctx->CreateGraph();
+  auto graph_impl = reinterpret_cast<vx::GraphImpl*>(graph.get());
+  auto roles = ConstRoles(src_graph_);
+  SpecMap specs;
+  TensorMap tensor_map;
+  // Tensors bound to the cloned operations, the quantized side of float io
+  TensorMap bound;
+  bool ok = true;
+
+  auto tensor_of = [&](const std::shared_ptr<vx::Tensor>& t) {
+    auto it = bound.find(t);
+    if (it != bound.end()) {
+      return it->second;
+    }
+    std::shared_ptr<vx::Tensor> dst;
+    vx::TensorSpec spec;
+    if (t->IsPlaceHolder()) {
+      dst = graph->CreateTensorPlaceHolder();
+    } else if (!QuantizedSpec(t, roles, specs, &spec)) {
+      ok = false;
+      return dst;
+    } else if (t->IsConstTensor() &&
+               t->GetSpec().datatype_ == vx::DataType::FLOAT32) {
+      const void* data = graph_impl->HoldConstData(QuantizeData(
+          static_cast<const float*>(t->GetDataRef()), spec));
+      dst = graph->CreateTensor(spec, data);
+    } else if (t->IsConstTensor()) {
+      dst = graph->CreateTensor(spec, t->GetDataRef());
+    } else {
+      dst = graph->CreateTensor(spec);
+    }
+    bound[t] = dst;
+    tensor_map[t] = dst;
+    return dst;
+  };
+
+  // Float graph io converted from and to its quantized tensor
+  auto float_io = [&](const std::shared_ptr<vx::Tensor>& t,
+                      std::shared_ptr<vx::Tensor>* quantized) {
+    vx::TensorSpec spec;
+    if (!QuantizedSpec(t, roles, specs, &spec)) {
+      ok = false;
+      return;
+    }
+    spec.attr_ = vx::TensorAttribute::TRANSIENT;
+    *quantized = graph->CreateTensor(spec);
+    bound[t] = *quantized;
+    tensor_map[t] = graph->CreateTensor(t->GetSpec());
+  };
+  std::vector<std::shared_ptr<vx::Tensor>> converted_outputs;
+  for (const auto& t : src_graph_->InputsTensor()) {
+    if (options_.float_io && t->GetSpec().datatype_ == vx::DataType::FLOAT32) {
+      std::shared_ptr<vx::Tensor> quantized;
+      float_io(t, &quantized);
+      if (!ok) break;
+      graph->CreateOperation<vx::ops::DataConvert>()
+          ->BindInput(tensor_map[t])
+          .BindOutput(quantized);
+    } else {
+      tensor_of(t);
+    }
+  }
+  for (const auto& t : src_graph_->OutputsTensor()) {
+    if (!ok) break;
+    if (options_.float_io && t->GetSpec().datatype_ == vx::DataType::FLOAT32) {
+      std::shared_ptr<vx::Tensor> quantized;
+      float_io(t, &quantized);
+      converted_outputs.push_back(t);
+    } else {
+      tensor_of(t);
+    }
+  }
+
+  for (const auto& op : src_graph_->OpVector()) {
+    if (!ok) break;
+    std::vector<std::shared_ptr<vx::Tensor>> inputs, outputs;
+    for (const auto& t : op->impl()->InputsTensor()) {
+      inputs.push_back(tensor_of(t));
+    }
+    for (const auto& t : op->impl()->OutputsTensor()) {
+      outputs.push_back(tensor_of(t));
+    }
+    if (!ok) break;
+    op->Clone(graph)->BindInputs(inputs).BindOutputs(outputs);
+  }
+  if (!ok) {
+    return std::make_pair(graph, TensorMap());
+  }
+  for (const auto& t : converted_outputs) {
+    graph->CreateOperation<vx::ops::DataConvert>()
+        ->BindInput(bound[t])
+        .BindOutput(tensor_map[t]);
+  }
+  return std::make_pair(graph, tensor_map);
+}
+
+}  // namespace
+
+std::shared_ptr<Calibrator> Calibrator::Create(
+    const std::shared_ptr<vx::Graph>& float_graph,
+    const std::shared_ptr<vx::Context>& ctx,
+    const CalibrationOptions& options) {
+  if (!float_graph || !ctx) {
+    VSILOGE("Calibration needs a graph and its context");
+    return nullptr;
+  }
+  if (options.data_type != vx::DataType::UINT8 &&
+      options.data_type != vx::DataType::INT8) {
+    VSILOGE("Only UINT8 and INT8 quantization is supported");
+    return nullptr;
+  }
+  for (const auto& t : float_graph->InputsTensor()) {
+    if (t->GetSpec().datatype_ != vx::DataType::FLOAT32) {
+      VSILOGE("Graph input %u is not float32", t->GetId());
+      return nullptr;
+    }
+  }
+  return std::make_shared<CalibratorImpl>(float_graph, ctx, options);
+}
+
+}  // namespace transform
+}  // namespace tim
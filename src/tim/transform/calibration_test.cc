@@ -0,0 +1,202 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/transform/calibration.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+std::shared_ptr<tim::vx::Tensor> CreateFloatTensor(
+    const std::shared_ptr<tim::vx::Graph>& graph,
+    tim::vx::TensorAttribute attr, const tim::vx::ShapeType& shape,
+    const void* data = nullptr) {
+  tim::vx::TensorSpec spec(tim::vx::DataType::FLOAT32, shape, attr);
+  return graph->CreateTensor(spec, data);
+}
+
+// input -> Relu -> output
+struct ReluGraph {
+  explicit ReluGraph(const std::shared_ptr<tim::vx::Context>& ctx,
+                     uint32_t size) {
+    graph = ctx->CreateGraph();
+    input = CreateFloatTensor(graph, tim::vx::TensorAttribute::INPUT, {size});
+    output =
+        CreateFloatTensor(graph, tim::vx::TensorAttribute::OUTPUT, {size});
+    auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+    (*relu).BindInputs({input}).BindOutputs({output});
+  }
+  std::shared_ptr<tim::vx::Graph> graph;
+  std::shared_ptr<tim::vx::Tensor> input;
+  std::shared_ptr<tim::vx::Tensor> output;
+};
+}  // namespace
+
+TEST(Calibration, range_methods) {
+  auto ctx = tim::vx::Context::Create();
+  ReluGraph src(ctx, 8);
+  // Most values in [-1, 1], a few far outliers
+  std::vector<float> values;
+  for (int i = 0; i < 10000; ++i) {
+    values.push_back(std::sin(i * 0.37f));
+  }
+  values.push_back(-50.0f);
+  values.push_back(100.0f);
+
+  tim::transform::CalibrationOptions options;
+  tim::transform::TensorRange range;
+  auto min_max = tim::transform::Calibrator::Create(src.graph, ctx, options);
+  ASSERT_TRUE(min_max);
+  EXPECT_FALSE(min_max->GetRange(src.input, &range));
+  // Chunks make the histogram grow its range on the way
+  EXPECT_TRUE(min_max->Observe(src.input, values.data(), 5000));
+  EXPECT_TRUE(min_max->Observe(src.input, values.data() + 5000,
+                               values.size() - 5000));
+  EXPECT_TRUE(min_max->GetRange(src.input, &range));
+  EXPECT_EQ(range.min, -50.0f);
+  EXPECT_EQ(range.max, 100.0f);
+
+  options.method = tim::transform::CalibrationMethod::PERCENTILE;
+  options.percentile = 99.9f;
+  auto percentile = tim::transform::Calibrator::Create(src.graph, ctx, options);
+  EXPECT_TRUE(percentile->Observe(src.input, values.data(), values.size()));
+  EXPECT_TRUE(percentile->GetRange(src.input, &range));
+  EXPECT_LT(range.min, -0.5f);
+  EXPECT_GT(range.min, -2.0f);
+  EXPECT_GT(range.max, 0.5f);
+  EXPECT_LT(range.max, 2.0f);
+
+  options.method = tim::transform::CalibrationMethod::KL_DIVERGENCE;
+  auto entropy = tim::transform::Calibrator::Create(src.graph, ctx, options);
+  values[values.size() - 2] = -5.0f;
+  values[values.size() - 1] = 10.0f;
+  EXPECT_TRUE(entropy->Observe(src.input, values.data(), values.size()));
+  EXPECT_TRUE(entropy->GetRange(src.input, &range));
+  EXPECT_EQ(range.min, -range.max);
+  EXPECT_GT(range.max, 0.5f);
+  EXPECT_LT(range.max, 5.0f);
+}
+
+TEST(Calibration, quantize_conv_per_channel) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  std::vector<float> weights_data = {1.0f, -1.0f, 0.5f, 0.25f,
+                                     -0.5f, 2.0f, 1.0f, 0.0f};
+  std::vector<float> bias_data = {0.5f, -1.0f};
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {3, 3, 1, 1});
+  auto weights =
+      CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                        {2, 2, 1, 2}, weights_data.data());
+  auto bias = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                                {2}, bias_data.data());
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {2, 2, 2, 1});
+  auto conv = src_graph->CreateOperation<tim::vx::ops::Conv2d>(
+      2, tim::vx::PadType::VALID, std::array<uint32_t, 2>({2, 2}),
+      std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+  (*conv).BindInputs({input, weights, bias}).BindOutputs({output});
+
+  tim::transform::CalibrationOptions options;
+  options.per_channel_weights = true;
+  auto calibrator =
+      tim::transform::Calibrator::Create(src_graph, ctx, options);
+  std::vector<float> input_values = {-1.0f, 3.0f};
+  std::vector<float> output_values = {-4.0f, 6.0f};
+  EXPECT_TRUE(calibrator->Observe(input, input_values.data(), 2));
+  EXPECT_TRUE(calibrator->Observe(output, output_values.data(), 2));
+
+  auto quantized = calibrator->Quantize(ctx);
+  ASSERT_FALSE(quantized.second.empty());
+  // DataConvert on each side of the Conv2d
+  EXPECT_EQ(quantized.first->OpVector().size(), 3u);
+  EXPECT_EQ(quantized.second[input]->GetSpec().datatype_,
+            tim::vx::DataType::FLOAT32);
+  EXPECT_EQ(quantized.second[output]->GetSpec().datatype_,
+            tim::vx::DataType::FLOAT32);
+
+  auto q_weights = quantized.second[weights]->GetSpec();
+  EXPECT_EQ(q_weights.datatype_, tim::vx::DataType::INT8);
+  EXPECT_EQ(q_weights.quantization_.Type(),
+            tim::vx::QuantType::SYMMETRIC_PER_CHANNEL);
+  EXPECT_EQ(q_weights.quantization_.ChannelDim(), 3);
+  std::vector<float> weight_scales = {1.0f / 127, 2.0f / 127};
+  EXPECT_TRUE(ArraysMatch(weight_scales, q_weights.quantization_.Scales(),
+                          1e-6f));
+  std::vector<int8_t> q_weights_data(8);
+  memcpy(q_weights_data.data(), quantized.second[weights]->GetDataRef(), 8);
+  EXPECT_EQ(q_weights_data,
+            std::vector<int8_t>({127, -127, 64, 32, -32, 127, 64, 0}));
+
+  // uint8 input over [-1, 3]
+  const float input_scale = 4.0f / 255;
+  auto q_bias = quantized.second[bias]->GetSpec();
+  EXPECT_EQ(q_bias.datatype_, tim::vx::DataType::INT32);
+  std::vector<float> bias_scales = {input_scale * weight_scales[0],
+                                    input_scale * weight_scales[1]};
+  EXPECT_TRUE(
+      ArraysMatch(bias_scales, q_bias.quantization_.Scales(), 1e-9f));
+  std::vector<int32_t> q_bias_data(2);
+  memcpy(q_bias_data.data(), quantized.second[bias]->GetDataRef(), 8);
+  EXPECT_EQ(q_bias_data[0], std::lround(0.5f / bias_scales[0]));
+  EXPECT_EQ(q_bias_data[1], std::lround(-1.0f / bias_scales[1]));
+}
+
+TEST(Calibration, quantize_without_range) {
+  auto ctx = tim::vx::Context::Create();
+  ReluGraph src(ctx, 4);
+  auto calibrator = tim::transform::Calibrator::Create(src.graph, ctx);
+  std::vector<float> values = {-1.0f, 1.0f};
+  EXPECT_TRUE(calibrator->Observe(src.input, values.data(), values.size()));
+  // Relu output was never seen
+  EXPECT_TRUE(calibrator->Quantize(ctx).second.empty());
+
+  tim::transform::CalibrationOptions options;
+  options.data_type = tim::vx::DataType::FLOAT16;
+  EXPECT_FALSE(tim::transform::Calibrator::Create(src.graph, ctx, options));
+}
+
+TEST(Calibration, feed_and_run_int8) {
+  auto ctx = tim::vx::Context::Create();
+  ReluGraph src(ctx, 4);
+  tim::transform::CalibrationOptions options;
+  options.data_type = tim::vx::DataType::INT8;
+  options.float_io = false;
+  auto calibrator = tim::transform::Calibrator::Create(src.graph, ctx, options);
+  EXPECT_TRUE(calibrator->Feed({{-2.0f, -1.0f, 0.5f, 1.0f}}));
+  EXPECT_TRUE(calibrator->Feed({{0.0f, 2.0f, 0.25f, -0.5f}}));
+  EXPECT_EQ(calibrator->SampleCount(), 2u);
+  tim::transform::TensorRange range;
+  EXPECT_TRUE(calibrator->GetRange(src.output, &range));
+  EXPECT_EQ(range.min, 0.0f);
+  EXPECT_EQ(range.max, 2.0f);
+
+  auto quantized = calibrator->Quantize(ctx);
+  ASSERT_FALSE(quantized.second.empty());
+  auto input = quantized.second[src.input];
+  auto output = quantized.second[src.output];
+  EXPECT_EQ(input->GetSpec().datatype_, tim::vx::DataType::INT8);
+  EXPECT_TRUE(quantized.first->Compile());
+  auto in_quant = input->GetSpec().quantization_;
+  std::vector<float> in_data = {-2.0f, -1.0f, 1.0f, 2.0f};
+  std::vector<int8_t> in_q;
+  for (float v : in_data) {
+    in_q.push_back(static_cast<int8_t>(std::lround(
+        v / in_quant.Scales()[0] + in_quant.ZeroPoints()[0])));
+  }
+  EXPECT_TRUE(input->CopyDataToTensor(in_q.data(), in_q.size()));
+  EXPECT_TRUE(quantized.first->Run());
+  std::vector<int8_t> out_q(4);
+  EXPECT_TRUE(output->CopyDataFromTensor(out_q.data()));
+  auto out_quant = output->GetSpec().quantization_;
+  std::vector<float> out;
+  for (int8_t q : out_q) {
+    out.push_back((q - out_quant.ZeroPoints()[0]) * out_quant.Scales()[0]);
+  }
+  std::vector<float> expect = {0.0f, 0.0f, 1.0f, 2.0f};
+  EXPECT_TRUE(ArraysMatch(expect, out, out_quant.Scales()[0]));
+}
@@ -0,0 +1,567 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/transform/constant_folding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "graph_private.h"
+#include "operation_private.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/conv2d.h"
+#include "type_utils.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+
+using TensorMap =
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>;
+
+// Constant known on the host, spec always carries the shape
+struct HostTensor {
+  vx::TensorSpec spec;
+  const uint8_t* data{nullptr};
+  std::shared_ptr<std::vector<uint8_t>> folded;
+};
+
+size_t ElementCount(const vx::ShapeType& shape) {
+  size_t count = 1;
+  for (auto s : shape) count *= s;
+  return count;
+}
+
+size_t ByteSize(const vx::TensorSpec& spec) {
+  return ElementCount(spec.shape_) *
+         vsi_nn_GetTypeBytes(vx::TranslateDataType(spec.datatype_));
+}
+
+// Per-tensor quantization (or none) converts through float32
+bool IsFloatConvertible(const vx::TensorSpec& spec) {
+  return spec.quantization_.Type() != vx::QuantType::SYMMETRIC_PER_CHANNEL &&
+         vsi_nn_GetTypeBytes(vx::TranslateDataType(spec.datatype_)) > 0;
+}
+
+std::vector<float> ToFloat(const HostTensor& t) {
+  vx::TensorSpec spec = t.spec;
+  vsi_nn_dtype_t dtype;
+  memset(&dtype, 0, sizeof(dtype));
+  vx::PackTensorDtype(spec, &dtype);
+  std::vector<float> out(ElementCount(spec.shape_));
+  vsi_nn_DtypeConvertRawDataToFloat32(const_cast<uint8_t*>(t.data),
+                                      ByteSize(spec), &dtype, out.data(),
+                                      out.size());
+  return out;
+}
+
+HostTensor FromFloat(std::vector<float>& values, vx::TensorSpec spec) {
+  HostTensor t;
+  t.spec = spec;
+  t.folded = std::make_shared<std::vector<uint8_t>>(ByteSize(spec));
+  vsi_nn_dtype_t dtype;
+  memset(&dtype, 0, sizeof(dtype));
+  vx::PackTensorDtype(spec, &dtype);
+  vsi_nn_DtypeConvertFloat32ToRawData(values.data(), values.size(),
+                                      t.folded->data(), t.folded->size(),
+                                      &dtype);
+  t.data = t.folded->data();
+  return t;
+}
+
+HostTensor FromBytes(std::vector<uint8_t> bytes, vx::TensorSpec spec) {
+  HostTensor t;
+  t.spec = spec;
+  t.folded = std::make_shared<std::vector<uint8_t>>(std::move(bytes));
+  t.data = t.folded->data();
+  return t;
+}
+
+// Output spec with the computed shape, the shape given by the user has to
+// agree with it
+bool OutputSpec(const std::shared_ptr<vx::Tensor>& output,
+                const vx::ShapeType& shape, vx::TensorSpec& spec) {
+  spec = output->GetSpec();
+  if (!spec.shape_.empty() &&
+      ElementCount(spec.shape_) != ElementCount(shape)) {
+    return false;
+  }
+  if (spec.shape_.empty()) {
+    spec.shape_ = shape;
+  }
+  spec.attr_ = vx::TensorAttribute::CONSTANT;
+  return true;
+}
+
+bool FoldReshape(const std::shared_ptr<vx::Operation>& op,
+                 const std::vector<const HostTensor*>& inputs,
+                 const std::shared_ptr<vx::Tensor>& output, HostTensor& out) {
+  const auto& in = *inputs[0];
+  const auto& param = op->impl()->node()->nn_param.reshape;
+  vx::ShapeType shape(param.size, param.size + param.dim_num);
+  // One dimension may be left for the reshape to infer
+  size_t known = 1;
+  int32_t infer_dim = -1;
+  for (uint32_t i = 0; i < shape.size(); ++i) {
+    if (shape[i] == static_cast<uint32_t>(-1) || shape[i] == 0) {
+      infer_dim = i;
+    } else {
+      known *= shape[i];
+    }
+  }
+  if (infer_dim >= 0 && known > 0) {
+    shape[infer_dim] = ElementCount(in.spec.shape_) / known;
+  }
+  vx::TensorSpec spec;
+  if (!OutputSpec(output, shape, spec) ||
+      ElementCount(spec.shape_) != ElementCount(in.spec.shape_) ||
+      spec.datatype_ != in.spec.datatype_) {
+    return false;
+  }
+  out = in;
+  out.spec = spec;
+  return true;
+}
+
+bool FoldTranspose(const std::shared_ptr<vx::Operation>& op,
+                   const std::vector<const HostTensor*>& inputs,
+                   const std::shared_ptr<vx::Tensor>& output,
+                   HostTensor& out) {
+  const auto& in = *inputs[0];
+  const auto& param = op->impl()->node()->nn_param.permute;
+  const uint32_t rank = in.spec.shape_.size();
+  if (param.dim_num != rank) {
+    return false;
+  }
+  // vsi_nn_Transpose takes shapes outermost dimension first
+  std::vector<vsi_size_t> shape(rank), perm(rank);
+  vx::ShapeType out_shape(rank);
+  for (uint32_t i = 0; i < rank; ++i) {
+    shape[i] = in.spec.shape_[rank - 1 - i];
+    perm[i] = rank - 1 - param.perm[rank - 1 - i];
+    out_shape[i] = in.spec.shape_[param.perm[i]];
+  }
+  vx::TensorSpec spec;
+  if (!OutputSpec(output, out_shape, spec) ||
+      spec.datatype_ != in.spec.datatype_) {
+    return false;
+  }
+  spec.shape_ = out_shape;
+  std::vector<uint8_t> bytes(ByteSize(in.spec));
+  if (rank < 2) {
+    std::copy(in.data, in.data + bytes.size(), bytes.begin());
+  } else {
+    vsi_nn_Transpose(bytes.data(), const_cast<uint8_t*>(in.data),
+                     shape.data(), rank, perm.data(),
+                     vx::TranslateDataType(in.spec.datatype_));
+  }
+  out = FromBytes(std::move(bytes), spec);
+  return true;
+}
+
+bool FoldDataConvert(const std::vector<const HostTensor*>& inputs,
+                     const std::shared_ptr<vx::Tensor>& output,
+                     HostTensor& out) {
+  const auto& in = *inputs[0];
+  vx::TensorSpec spec;
+  if (!OutputSpec(output, in.spec.shape_, spec) ||
+      !IsFloatConvertible(in.spec) || !IsFloatConvertible(spec)) {
+    return false;
+  }
+  auto values = ToFloat(in);
+  out = FromFloat(values, spec);
+  return true;
+}
+
+// ovxlib broadcasts from the innermost dimension, missing outer ones are 1
+bool BroadcastShape(const vx::ShapeType& a, const vx::ShapeType& b,
+                    vx::ShapeType& shape) {
+  shape.assign(std::max(a.size(), b.size()), 1);
+  for (size_t i = 0; i < shape.size(); ++i) {
+    uint32_t da = i < a.size() ? a[i] : 1;
+    uint32_t db = i < b.size() ? b[i] : 1;
+    if (da != db && da != 1 && db != 1) {
+      return false;
+    }
+    shape[i] = std::max(da, db);
+  }
+  return true;
+}
+
+size_t BroadcastIndex(const vx::ShapeType& shape, const vx::ShapeType& from,
+                      size_t index) {
+  size_t offset = 0;
+  size_t stride = 1;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    uint32_t coord = index % shape[i];
+    index /= shape[i];
+    uint32_t dim = i < from.size() ? from[i] : 1;
+    offset += (dim == 1 ? 0 : coord) * stride;
+    stride *= dim;
+  }
+  return offset;
+}
+
+bool FoldBinary(const std::shared_ptr<vx::Operation>& op,
+                const std::vector<const HostTensor*>& inputs,
+                const std::shared_ptr<vx::Tensor>& output, HostTensor& out) {
+  const auto& a = *inputs[0];
+  const auto& b = *inputs[1];
+  vx::ShapeType shape;
+  vx::TensorSpec spec;
+  if (!IsFloatConvertible(a.spec) || !IsFloatConvertible(b.spec) ||
+      !BroadcastShape(a.spec.shape_, b.spec.shape_, shape) ||
+      !OutputSpec(output, shape, spec) || !IsFloatConvertible(spec)) {
+    return false;
+  }
+  auto* node = op->impl()->node();
+  auto va = ToFloat(a);
+  auto vb = ToFloat(b);
+  std::vector<float> result(ElementCount(shape));
+  for (size_t i = 0; i < result.size(); ++i) {
+    float x = va[BroadcastIndex(shape, a.spec.shape_, i)];
+    float y = vb[BroadcastIndex(shape, b.spec.shape_, i)];
+    switch (op->impl()->operation_id_) {
+      case VSI_NN_OP_ADD:
+        result[i] = x + y;
+        break;
+      case VSI_NN_OP_SUBTRACT:
+        result[i] = x - y;
+        break;
+      case VSI_NN_OP_MULTIPLY:
+        result[i] = x * y * node->nn_param.multiply.scale;
+        break;
+      case VSI_NN_OP_DIVIDE:
+        result[i] = x / y * node->nn_param.divide.scale;
+        break;
+      case VSI_NN_OP_MINIMUM:
+        result[i] = std::min(x, y);
+        break;
+      case VSI_NN_OP_MAXIMUM:
+        result[i] = std::max(x, y);
+        break;
+    }
+  }
+  out = FromFloat(result, spec);
+  return true;
+}
+
+bool Evaluate(const std::shared_ptr<vx::Operation>& op,
+              const std::vector<const HostTensor*>& inputs,
+              const std::shared_ptr<vx::Tensor>& output, HostTensor& out) {
+  switch (op->impl()->operation_id_) {
+    case VSI_NN_OP_RESHAPE:
+      return inputs.size() == 1 && FoldReshape(op, inputs, output, out);
+    case VSI_NN_OP_PERMUTE:
+      return inputs.size() == 1 && FoldTranspose(op, inputs, output, out);
+    case VSI_NN_OP_DATACONVERT:
+      return inputs.size() == 1 && FoldDataConvert(inputs, output, out);
+    case VSI_NN_OP_ADD:
+    case VSI_NN_OP_SUBTRACT:
+    case VSI_NN_OP_MULTIPLY:
+    case VSI_NN_OP_DIVIDE:
+    case VSI_NN_OP_MINIMUM:
+    case VSI_NN_OP_MAXIMUM:
+      return inputs.size() == 2 && FoldBinary(op, inputs, output, out);
+    default:
+      return false;
+  }
+}
+
+bool IsFloat(const HostTensor& t) {
+  return (t.spec.datatype_ == vx::DataType::FLOAT32 ||
+          t.spec.datatype_ == vx::DataType::FLOAT16) &&
+         t.spec.quantization_.Type() == vx::QuantType::NONE;
+}
+
+class ConstantFolder {
+ public:
+  explicit ConstantFolder(const std::shared_ptr<vx::Graph>& graph);
+
+  void FoldOperations();
+  void FoldBatchNorm();
+  std::shared_ptr<vx::Graph> Emit(std::shared_ptr<vx::Context>& ctx,
+                                  TensorMap& tensor_map,
+                                  ConstantFoldingReport& report) const;
+
+  uint32_t FoldedCount() const { return folded_ops_.size(); }
+
+ private:
+  const HostTensor* Known(const std::shared_ptr<vx::Tensor>& t) const {
+    auto it = known_.find(t);
+    return it == known_.end() ? nullptr : &it->second;
+  }
+
+  struct ConvBatchNorm {
+    std::shared_ptr<vx::Operation> conv;
+    HostTensor weights;
+    HostTensor bias;
+  };
+
+  std::shared_ptr<vx::Tensor> CreateConstant(
+      const std::shared_ptr<vx::Graph>& graph, const HostTensor& host,
+      ConstantFoldingReport& report) const;
+
+  const std::shared_ptr<vx::Graph>& graph_;
+  std::unordered_map<std::shared_ptr<vx::Tensor>, HostTensor> known_;
+  std::unordered_map<std::shared_ptr<vx::Tensor>,
+                     std::shared_ptr<vx::Operation>>
+      producer_;
+  std::unordered_set<std::shared_ptr<vx::Operation>> folded_ops_;
+  /// BatchNorm -> the Conv2d it is folded into, with the new constants
+  std::unordered_map<std::shared_ptr<vx::Operation>, ConvBatchNorm>
+      batch_norms_;
+  std::unordered_set<std::shared_ptr<vx::Operation>> folded_convs_;
+};
+
+ConstantFolder::ConstantFolder(const std::shared_ptr<vx::Graph>& graph)
+    : graph_(graph) {
+  for (const auto& op : graph_->OpVector()) {
+    for (const auto& t : op->impl()->InputsTensor()) {
+      if (t->IsConstTensor() && t->GetDataRef() && !known_.count(t)) {
+        HostTensor host;
+        host.spec = t->GetSpec();
+        host.data = static_cast<const uint8_t*>(t->GetDataRef());
+        known_[t] = host;
+      }
+    }
+    for (const auto& t : op->impl()->OutputsTensor()) {
+      producer_[t] = op;
+    }
+  }
+}
+
+void ConstantFolder::FoldOperations() {
+  std::deque<std::shared_ptr<vx::Operation>> queue(
+      graph_->OpVector().begin(), graph_->OpVector().end());
+  while (!queue.empty()) {
+    auto op = queue.front();
+    queue.pop_front();
+    auto outputs = op->impl()->OutputsTensor();
+    if (folded_ops_.count(op) || outputs.size() != 1 ||
+        outputs[0]->GetSpec().attr_ != vx::TensorAttribute::TRANSIENT) {
+      continue;
+    }
+    std::vector<const HostTensor*> inputs;
+    for (const auto& t : op->impl()->InputsTensor()) {
+      inputs.push_back(Known(t));
+      if (!inputs.back()) break;
+    }
+    if (inputs.empty() || !inputs.back()) {
+      continue;
+    }
+    HostTensor out;
+    if (!Evaluate(op, inputs, outputs[0], out)) {
+      continue;
+    }
+    known_[outputs[0]] = out;
+    folded_ops_.insert(op);
+    for (const auto& consumer : graph_->GetConsumersOp(outputs[0])) {
+      queue.push_back(consumer);
+    }
+  }
+}
+
+// BN(conv(x, w, b)) = conv(x, w * s, (b - mean) * s + beta),
+// s = gamma / sqrt(variance + eps) per output channel
+void ConstantFolder::FoldBatchNorm() {
+  for (const auto& bn : graph_->OpVector()) {
+    if (bn->impl()->operation_id_ != VSI_NN_OP_BATCH_NORM ||
+        folded_ops_.count(bn)) {
+      continue;
+    }
+    auto bn_inputs = bn->impl()->InputsTensor();
+    if (bn_inputs.size() != 5) {
+      continue;
+    }
+    auto producer = producer_.find(bn_inputs[0]);
+    if (producer == producer_.end() ||
+        bn_inputs[0]->GetSpec().attr_ != vx::TensorAttribute::TRANSIENT ||
+        graph_->GetConsumersOp(bn_inputs[0]).size() != 1) {
+      continue;
+    }
+    auto conv_op = producer->second;
+    auto conv = std::dynamic_pointer_cast<vx::ops::Conv2d>(conv_op);
+    if (!conv || conv_op->impl()->operation_id_ != VSI_NN_OP_CONV2D ||
+        conv->KernelDataLayout() != vx::DataLayout::WHIcOc ||
+        conv_op->impl()->node()->nn_param.conv2d.multiplier > 0) {
+      continue;
+    }
+    auto conv_inputs = conv_op->impl()->InputsTensor();
+    const HostTensor* weights =
+        conv_inputs.size() > 1 ? Known(conv_inputs[1]) : nullptr;
+    const HostTensor* bias =
+        conv_inputs.size() > 2 ? Known(conv_inputs[2]) : nullptr;
+    if (!weights || !IsFloat(*weights) || weights->spec.shape_.size() != 4 ||
+        (conv_inputs.size() > 2 && (!bias || !IsFloat(*bias)))) {
+      continue;
+    }
+    const uint32_t channels = weights->spec.shape_[3];
+    std::vector<std::vector<float>> params;
+    for (size_t i = 1; i < 5; ++i) {
+      const HostTensor* p = Known(bn_inputs[i]);
+      if (!p || !IsFloatConvertible(p->spec) ||
+          ElementCount(p->spec.shape_) != channels) {
+        break;
+      }
+      params.push_back(ToFloat(*p));
+    }
+    if (params.size() != 4) {
+      continue;
+    }
+    const auto& mean = params[0];
+    const auto& variance = params[1];
+    const auto& gamma = params[2];
+    const auto& beta = params[3];
+    float eps = bn->impl()->node()->nn_param.batch_norm.eps;
+
+    auto w = ToFloat(*weights);
+    std::vector<float> b =
+        bias ? ToFloat(*bias) : std::vector<float>(channels, 0.0f);
+    const size_t per_channel = w.size() / channels;
+    for (uint32_t c = 0; c < channels; ++c) {
+      float scale = gamma[c] / std::sqrt(variance[c] + eps);
+      for (size_t i = 0; i < per_channel; ++i) {
+        w[c * per_channel + i] *= scale;
+      }
+      b[c] = (b[c] - mean[c]) * scale + beta[c];
+    }
+
+    vx::TensorSpec w_spec = weights->spec;
+    w_spec.attr_ = vx::TensorAttribute::CONSTANT;
+    vx::TensorSpec b_spec(vx::DataType::FLOAT32, {channels},
+                          vx::TensorAttribute::CONSTANT);
+    if (bias) {
+      b_spec = bias->spec;
+      b_spec.attr_ = vx::TensorAttribute::CONSTANT;
+    }
+    ConvBatchNorm fold;
+    fold.conv = conv_op;
+    fold.weights = FromFloat(w, w_spec);
+    fold.bias = FromFloat(b, b_spec);
+    batch_norms_[bn] = fold;
+    folded_convs_.insert(conv_op);
+    folded_ops_.insert(bn);
+  }
+}
+
+std::shared_ptr<vx::Tensor> ConstantFolder::CreateConstant(
+    const std::shared_ptr<vx::Graph>& graph, const HostTensor& host,
+    ConstantFoldingReport& report) const {
+  const void* data = host.data;
+  if (host.folded) {
+    data = reinterpret_cast<vx::GraphImpl*>(graph.get())
+               ->HoldConstData(*host.folded);
+  }
+  report.constant_bytes_after += ByteSize(host.spec);
+  return graph->CreateTensor(host.spec, data);
+}
+
+std::shared_ptr<vx::Graph> ConstantFolder::Emit(
+    std::shared_ptr<vx::Context>& ctx, TensorMap& tensor_map,
+    ConstantFoldingReport& report) const {
+  auto graph = ctx->CreateGraph();
+  auto tensor_of = [&](const std::shared_ptr<vx::Tensor>& t) {
+    auto it = tensor_map.find(t);
+    if (it != tensor_map.end()) {
+      return it->second;
+    }
+    std::shared_ptr<vx::Tensor> dst;
+    const HostTensor* host = Known(t);
+    if (host) {
+      dst = CreateConstant(graph, *host, report);
+    } else if (t->IsPlaceHolder()) {
+      dst = graph->CreateTensorPlaceHolder();
+    } else {
+      dst = graph->CreateTensor(t->GetSpec());
+    }
+    tensor_map[t] = dst;
+    return dst;
+  };
+  // Keep the io order of the source graph
+  for (const auto& t : graph_->InputsTensor()) tensor_of(t);
+  for (const auto& t : graph_->OutputsTensor()) tensor_of(t);
+
+  for (const auto& op : graph_->OpVector()) {
+    if (folded_convs_.count(op)) continue;
+    auto bn = batch_norms_.find(op);
+    if (bn != batch_norms_.end()) {
+      const auto& fold = bn->second;
+      auto conv = fold.conv->Clone(graph);
+      conv->BindInput(tensor_of(fold.conv->impl()->InputsTensor()[0]));
+      conv->BindInput(CreateConstant(graph, fold.weights, report));
+      conv->BindInput(CreateConstant(graph, fold.bias, report));
+      conv->BindOutput(tensor_of(op->impl()->OutputsTensor()[0]));
+      continue;
+    }
+    if (folded_ops_.count(op)) continue;
+    auto cloned = op->Clone(graph);
+    for (const auto& t : op->impl()->InputsTensor()) {
+      cloned->BindInput(tensor_of(t));
+    }
+    for (const auto& t : op->impl()->OutputsTensor()) {
+      cloned->BindOutput(tensor_of(t));
+    }
+  }
+  return graph;
+}
+
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+ConstantFolding(const std::shared_ptr<vx::Graph>& src_graph,
+                std::shared_ptr<vx::Context>& ctx,
+                ConstantFoldingReport* report) {
+  ConstantFoldingReport stats;
+  std::unordered_set<std::shared_ptr<vx::Tensor>> constants;
+  for (const auto& op : src_graph->OpVector()) {
+    for (const auto& t : op->impl()->InputsTensor()) {
+      if (t->IsConstTensor() && constants.insert(t).second) {
+        stats.constant_bytes_before += ByteSize(t->GetSpec());
+      }
+    }
+  }
+
+  ConstantFolder folder(src_graph);
+  folder.FoldOperations();
+  folder.FoldBatchNorm();
+  TensorMap tensor_map;
+  auto graph = folder.Emit(ctx, tensor_map, stats);
+  stats.folded_op_count = folder.FoldedCount();
+  if (report) {
+    *report = stats;
+  }
+  return std::make_pair(graph, tensor_map);
+}
+
+}  // namespace transform
+}  // namespace tim
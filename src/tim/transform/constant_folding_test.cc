@@ -0,0 +1,195 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/batchnorm.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/ops/reshape.h"
+#include "tim/vx/ops/simple_operations.h"
+#include "tim/vx/ops/transpose.h"
+#include "tim/transform/constant_folding.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+std::shared_ptr<tim::vx::Tensor> CreateFloatTensor(
+    const std::shared_ptr<tim::vx::Graph>& graph,
+    tim::vx::TensorAttribute attr, const tim::vx::ShapeType& shape,
+    const void* data = nullptr) {
+  tim::vx::TensorSpec spec(tim::vx::DataType::FLOAT32, shape, attr);
+  return graph->CreateTensor(spec, data);
+}
+
+template <typename T>
+std::vector<T> ConstData(const std::shared_ptr<tim::vx::Tensor>& tensor,
+                         size_t size) {
+  std::vector<T> data(size);
+  if (!tensor || !tensor->GetDataRef()) {
+    return {};
+  }
+  memcpy(data.data(), tensor->GetDataRef(), size * sizeof(T));
+  return data;
+}
+}  // namespace
+
+// x + Transpose(a) * s, the weight side is evaluated on the host
+TEST(ConstantFolding, transpose_multiply) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  std::vector<float> a_data = {1, 2, 3, 4, 5, 6};
+  std::vector<float> s_data = {2};
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {3, 2});
+  auto a = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                             {2, 3}, a_data.data());
+  auto s = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                             {1}, s_data.data());
+  auto a_t = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::TRANSIENT,
+                               {3, 2});
+  auto scaled = CreateFloatTensor(src_graph,
+                                  tim::vx::TensorAttribute::TRANSIENT, {3, 2});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {3, 2});
+  auto transpose = src_graph->CreateOperation<tim::vx::ops::Transpose>(
+      std::vector<uint32_t>({1, 0}));
+  (*transpose).BindInputs({a}).BindOutputs({a_t});
+  auto mul = src_graph->CreateOperation<tim::vx::ops::Multiply>();
+  (*mul).BindInputs({a_t, s}).BindOutputs({scaled});
+  auto add = src_graph->CreateOperation<tim::vx::ops::Add>();
+  (*add).BindInputs({input, scaled}).BindOutputs({output});
+
+  tim::transform::ConstantFoldingReport report;
+  auto folded = tim::transform::ConstantFolding(src_graph, ctx, &report);
+  EXPECT_EQ(report.folded_op_count, 2u);
+  EXPECT_EQ(report.constant_bytes_before, 28u);
+  EXPECT_EQ(report.constant_bytes_after, 24u);
+  EXPECT_EQ(folded.first->OpVector().size(), 1u);
+  EXPECT_EQ(folded.second.count(a_t), 0u);
+
+  std::vector<float> expect = {2, 6, 10, 4, 8, 12};
+  EXPECT_EQ(ConstData<float>(folded.second[scaled], 6), expect);
+}
+
+// Reshape(DataConvert(c)) folds to a quantized constant
+TEST(ConstantFolding, data_convert_reshape) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 0.5f, 10);
+  tim::vx::TensorSpec u8_spec(tim::vx::DataType::UINT8, {2, 2},
+                              tim::vx::TensorAttribute::INPUT, quant);
+  std::vector<float> c_data = {0.0f, 0.5f, 1.0f, 2.0f};
+  auto c = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                             {4}, c_data.data());
+  auto input = src_graph->CreateTensor(u8_spec);
+  auto converted = src_graph->CreateTensor(
+      tim::vx::TensorSpec(tim::vx::DataType::UINT8, {4},
+                          tim::vx::TensorAttribute::TRANSIENT, quant));
+  auto reshaped = src_graph->CreateTensor(u8_spec.AsTransientSpec());
+  auto output = src_graph->CreateTensor(
+      tim::vx::TensorSpec(tim::vx::DataType::UINT8, {2, 2},
+                          tim::vx::TensorAttribute::OUTPUT, quant));
+  auto convert = src_graph->CreateOperation<tim::vx::ops::DataConvert>();
+  (*convert).BindInputs({c}).BindOutputs({converted});
+  auto reshape = src_graph->CreateOperation<tim::vx::ops::Reshape>(
+      std::vector<uint32_t>({2, 2}));
+  (*reshape).BindInputs({converted}).BindOutputs({reshaped});
+  auto add = src_graph->CreateOperation<tim::vx::ops::Add>();
+  (*add).BindInputs({input, reshaped}).BindOutputs({output});
+
+  tim::transform::ConstantFoldingReport report;
+  auto folded = tim::transform::ConstantFolding(src_graph, ctx, &report);
+  EXPECT_EQ(report.folded_op_count, 2u);
+  EXPECT_EQ(report.constant_bytes_before, 16u);
+  EXPECT_EQ(report.constant_bytes_after, 4u);
+  ASSERT_EQ(folded.first->OpVector().size(), 1u);
+
+  auto constant = folded.second[reshaped];
+  ASSERT_TRUE(constant);
+  EXPECT_EQ(constant->GetShape(), tim::vx::ShapeType({2, 2}));
+  std::vector<uint8_t> expect = {10, 11, 12, 14};
+  EXPECT_EQ(ConstData<uint8_t>(constant, 4), expect);
+}
+
+// BatchNorm after a Conv2d goes into the conv weights and bias
+TEST(ConstantFolding, conv2d_batchnorm) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  std::vector<float> weights_data = {1.0f, -1.0f, 0.5f, 2.0f};
+  std::vector<float> bias_data = {0.5f, -1.0f};
+  std::vector<float> mean_data = {1.0f, -2.0f};
+  std::vector<float> variance_data = {4.0f, 0.25f};
+  std::vector<float> gamma_data = {2.0f, 1.0f};
+  std::vector<float> beta_data = {0.0f, 3.0f};
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {2, 2, 2, 1});
+  auto weights = CreateFloatTensor(src_graph,
+                                   tim::vx::TensorAttribute::CONSTANT,
+                                   {1, 1, 2, 2}, weights_data.data());
+  auto bias = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                                {2}, bias_data.data());
+  auto mean = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                                {2}, mean_data.data());
+  auto variance = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::CONSTANT, {2}, variance_data.data());
+  auto gamma = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                                 {2}, gamma_data.data());
+  auto beta = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                                {2}, beta_data.data());
+  auto conv_out = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::TRANSIENT, {2, 2, 2, 1});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {2, 2, 2, 1});
+  auto conv = src_graph->CreateOperation<tim::vx::ops::Conv2d>(
+      2, tim::vx::PadType::VALID, std::array<uint32_t, 2>({1, 1}),
+      std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+  (*conv).BindInputs({input, weights, bias}).BindOutputs({conv_out});
+  auto bn = src_graph->CreateOperation<tim::vx::ops::BatchNorm>(0.0f);
+  (*bn).BindInputs({conv_out, mean, variance, gamma, beta})
+      .BindOutputs({output});
+
+  tim::transform::ConstantFoldingReport report;
+  auto folded = tim::transform::ConstantFolding(src_graph, ctx, &report);
+  EXPECT_EQ(report.folded_op_count, 1u);
+  EXPECT_EQ(report.constant_bytes_before, 56u);
+  EXPECT_EQ(report.constant_bytes_after, 24u);
+  ASSERT_EQ(folded.first->OpVector().size(), 1u);
+  EXPECT_TRUE(std::dynamic_pointer_cast<tim::vx::ops::Conv2d>(
+      folded.first->OpVector()[0]));
+
+  std::vector<float> input_data = {1, 2, 3, 4, -1, 0, 1, 2};
+  // scale = {1, 2}: channel 0 = (x0 - x1 + 0.5) - 1,
+  // channel 1 = 2 (0.5 x0 + 2 x1 - 1 + 2) + 3
+  std::vector<float> expect = {1.5f, 1.5f, 1.5f, 1.5f, 2.0f, 7.0f, 12.0f,
+                               17.0f};
+  std::vector<float> out(8);
+  auto new_input = folded.second[input];
+  auto new_output = folded.second[output];
+  ASSERT_TRUE(folded.first->Compile());
+  ASSERT_TRUE(new_input->CopyDataToTensor(input_data.data(),
+                                          input_data.size() * sizeof(float)));
+  ASSERT_TRUE(folded.first->Run());
+  ASSERT_TRUE(new_output->CopyDataFromTensor(out.data()));
+  EXPECT_TRUE(ArraysMatch(expect, out, 1e-5f));
+}
+
+// Graph outputs stay computed by the device even with constant inputs
+TEST(ConstantFolding, keeps_graph_outputs) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  std::vector<float> a_data = {1, 2, 3, 4};
+  auto a = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                             {2, 2}, a_data.data());
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {2, 2});
+  auto transpose = src_graph->CreateOperation<tim::vx::ops::Transpose>(
+      std::vector<uint32_t>({1, 0}));
+  (*transpose).BindInputs({a}).BindOutputs({output});
+
+  tim::transform::ConstantFoldingReport report;
+  auto folded = tim::transform::ConstantFolding(src_graph, ctx, &report);
+  EXPECT_EQ(report.folded_op_count, 0u);
+  EXPECT_EQ(report.constant_bytes_before, report.constant_bytes_after);
+  EXPECT_EQ(folded.first->OpVector().size(), 1u);
+}
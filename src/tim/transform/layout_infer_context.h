@@ -1,7 +1,11 @@
 #ifndef TIM_VX_LAYOUT_INFER_CONTEXT_H_
 #define TIM_VX_LAYOUT_INFER_CONTEXT_H_
+#include <unordered_map>
+#include <unordered_set>
+
 #include "permute_vector.h"
 #include "tim/transform/layout_inference.h"
+#include "tim/vx/tensor.h"
 
 namespace tim {
 namespace transform {
@@ -9,8 +13,7 @@ namespace layout_inference_impl {
 class LayoutInferContext {
  public:
   LayoutInferContext(const std::shared_ptr<vx::Graph>& src_graph,
-                     std::shared_ptr<vx::Graph>& infer_graph)
-      : src_graph_(src_graph), infer_graph_(infer_graph) {}
+                     std::shared_ptr<vx::Graph>& infer_graph);
   void SetPermuteVector(std::shared_ptr<vx::Tensor> tensor,
                         std::shared_ptr<IPermuteVector> pv);
   const std::shared_ptr<IPermuteVector> GetPermuteVector(
@@ -31,15 +34,28 @@ class LayoutInferContext {
     return graph_input_map_;
   }
 
+  // Tensors only reference the data given at creation, the infer graph keeps
+  // the data of constants generated during inference
+  const void* HoldConstData(std::vector<uint8_t> data);
+
+  // Shape of every mapped tensor in infer graph, derived from the shape and
+  // permute vector of its source tensor
+  std::unordered_map<std::shared_ptr<vx::Tensor>, vx::ShapeType>
+  InferredShapes() const;
+
   const std::shared_ptr<vx::Graph>& src_graph_;
   std::shared_ptr<vx::Graph>& infer_graph_;
 
  private:
-  std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<IPermuteVector>>
+  std::unordered_map<std::shared_ptr<vx::Tensor>,
+                     std::shared_ptr<IPermuteVector>>
       tensor_pv_;
-  std::vector<std::shared_ptr<vx::Operation>> visited_op_;
+  std::unordered_set<std::shared_ptr<vx::Operation>> visited_op_;
+  // op -> number of its non-constant inputs without permute vector, an
+  // operation is ready for inference when it drops to zero
+  std::unordered_map<std::shared_ptr<vx::Operation>, int32_t> pending_inputs_;
   // tensor_in_src -> tensor_in_layout
-  std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>
+  std::unordered_map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>
       tensor_map_;
   std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>
       graph_input_map_;
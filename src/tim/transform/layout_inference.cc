@@ -24,6 +24,8 @@
 
 #include "permute_vector.h"
 #include "layout_infer_context.h"
+#include "transpose_optimizer.h"
+#include "graph_private.h"
 
 #include "tim/transform/layout_inference.h"
 #include "ops/conv2d_layout_inference.h"
@@ -57,6 +59,8 @@
 #include "ops/logical_layout_inference.h"
 #include "ops/arg_layout_inference.h"
 #include "ops/deconv2d_layout_inference.h"
+#include "ops/pre_post_process_layout_inference.h"
+#include "ops/detection_layout_inference.h"
 #include "ops/default_layout_inference.h"
 
 #include <algorithm>
@@ -75,12 +79,36 @@ std::vector<std::shared_ptr<vx::Tensor>> HandleLayoutInfer(
     const std::shared_ptr<vx::Operation>& op);
 
 // Implemention for LayoutInferContext
+LayoutInferContext::LayoutInferContext(
+    const std::shared_ptr<vx::Graph>& src_graph,
+    std::shared_ptr<vx::Graph>& infer_graph)
+    : src_graph_(src_graph), infer_graph_(infer_graph) {
+  for (const auto& op : src_graph_->OpVector()) {
+    int32_t pending = 0;
+    for (const auto& tensor : op->impl()->InputsTensor()) {
+      if (!tensor->IsConstTensor()) {
+        ++pending;
+      }
+    }
+    pending_inputs_[op] = pending;
+  }
+}
+
 void LayoutInferContext::SetPermuteVector(std::shared_ptr<vx::Tensor> tensor,
                                           std::shared_ptr<IPermuteVector> pv) {
-  if (tensor_pv_.end() != tensor_pv_.find(tensor)) {
+  auto pv_it = tensor_pv_.find(tensor);
+  if (tensor_pv_.end() != pv_it) {
     VSILOGD("Tensor PermuteVector has been setted.");
+    pv_it->second = pv;
+    return;
   }
   tensor_pv_[tensor] = pv;
+  if (!tensor->IsConstTensor()) {
+    // A consumer is listed once for every input it binds the tensor to
+    for (const auto& op : src_graph_->GetConsumersOp(tensor)) {
+      --pending_inputs_[op];
+    }
+  }
 }
 
 const std::shared_ptr<IPermuteVector> LayoutInferContext::GetPermuteVector(
@@ -97,32 +125,19 @@ const std::shared_ptr<IPermuteVector> LayoutInferContext::GetPermuteVector(
 }
 
 void LayoutInferContext::MarkVisited(const std::shared_ptr<vx::Operation>& op) {
-  if (visited_op_.end() !=
-      std::find(visited_op_.begin(), visited_op_.end(), op)) {
+  if (!visited_op_.insert(op).second) {
     VSILOGW("The operation has been mark as visited.");
-  } else {
-    visited_op_.push_back(op);
   }
 }
 
 bool LayoutInferContext::IsVisited(const std::shared_ptr<vx::Operation>& op) const {
-  if (visited_op_.end() !=
-      std::find(visited_op_.begin(), visited_op_.end(), op)) {
-    return true;
-  } else {
-    return false;
-  }
+  return visited_op_.end() != visited_op_.find(op);
 }
 
 bool LayoutInferContext::IsReadyForInfer(
     const std::shared_ptr<vx::Operation>& op) const {
-  for (const auto& tensor : op->impl()->InputsTensor()) {
-    if (!tensor->IsConstTensor() &&
-        (tensor_pv_.end() == tensor_pv_.find(tensor))) {
-      return false;
-    }
-  }
-  return true;
+  auto it = pending_inputs_.find(op);
+  return it != pending_inputs_.end() && it->second <= 0;
 }
 
 void LayoutInferContext::UpdateTensorMap(
@@ -149,6 +164,30 @@ void LayoutInferContext::UpdateGraphInputMap(const std::shared_ptr<vx::Tensor>&
   graph_input_map_[i_src] = i_layout;
 }
 
+const void* LayoutInferContext::HoldConstData(std::vector<uint8_t> data) {
+  return reinterpret_cast<vx::GraphImpl*>(infer_graph_.get())
+      ->HoldConstData(std::move(data));
+}
+
+std::unordered_map<std::shared_ptr<vx::Tensor>, vx::ShapeType>
+LayoutInferContext::InferredShapes() const {
+  std::unordered_map<std::shared_ptr<vx::Tensor>, vx::ShapeType> shapes;
+  for (const auto& t : tensor_map_) {
+    auto pv_it = tensor_pv_.find(t.first);
+    const auto& src_shape = t.first->GetShape();
+    if (pv_it == tensor_pv_.end() || src_shape.empty() ||
+        pv_it->second->Rank() != src_shape.size()) {
+      continue;
+    }
+    vx::ShapeType shape(src_shape.size());
+    for (uint32_t i = 0; i < shape.size(); ++i) {
+      shape[i] = src_shape[pv_it->second->At(i)];
+    }
+    shapes[t.second] = shape;
+  }
+  return shapes;
+}
+
 #define REGIST_LAYOUT_INFERENCE(op_idx, name)                     \
   case op_idx: {                                                  \
     auto op_infer = std::make_shared<name##LayoutInfer>(op, ctx); \
@@ -250,6 +289,15 @@ std::vector<std::shared_ptr<vx::Tensor>> HandleLayoutInfer(
     REGIST_LAYOUT_INFERENCE(VSI_NN_OP_ARGMAX, Arg);
     REGIST_LAYOUT_INFERENCE(VSI_NN_OP_ARGMIN, Arg);
     REGIST_LAYOUT_INFERENCE(VSI_NN_OP_DECONVOLUTION, DeConv2d);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_PRE_PROCESS, PreProcess);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_POST_PROCESS, PostProcess);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_TOPK, Detection);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_NMS, Detection);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_BOX_WITH_NMS_LIMIT, Detection);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_DETECTION_POSTPROCESS, Detection);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_AXIS_ALIGNED_BBOX_TRANSFORM, Detection);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_ROI_ALIGN, RoiAlign);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_GENERATE_PROPOSALS, GenerateProposals);
     REGIST_LOGICAL_LAYOUT_INFERENCE(VSI_NN_OP_LOGICAL_OPS);
     REGIST_REDUCE_LAYOUT_INFERENCE(VSI_NN_OP_REDUCE);
     // use default layout inference
@@ -269,6 +317,16 @@ std::pair<std::shared_ptr<vx::Graph>,
                    std::shared_ptr<vx::Tensor>>> LayoutInference(
     const std::shared_ptr<vx::Graph>& src_graph,
     std::shared_ptr<vx::Context>& ctx) {
+  return LayoutInference(src_graph, ctx, TransposeOptimization::LOCAL);
+}
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>,
+                   std::shared_ptr<vx::Tensor>>> LayoutInference(
+    const std::shared_ptr<vx::Graph>& src_graph,
+    std::shared_ptr<vx::Context>& ctx,
+    TransposeOptimization optimization,
+    LayoutInferenceReport* report) {
   std::shared_ptr<vx::Graph> infer_graph = ctx->CreateGraph();
   std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>
       graph_io_map;
@@ -288,7 +346,7 @@ std::pair<std::shared_ptr<vx::Graph>,
   }
 
   while (!tensor_queue.empty()) {
-    const auto& tensor = tensor_queue.front();
+    auto tensor = tensor_queue.front();
     tensor_queue.pop_front();
     const auto& consumers = src_graph->GetConsumersOp(tensor);
     for (const auto& op : consumers) {
@@ -308,6 +366,17 @@ std::pair<std::shared_ptr<vx::Graph>,
   for (const auto& out_src : src_graph->OutputsTensor()) {
     graph_io_map[out_src] = layout_infer_ctx->GetMapedTensor(out_src);
   }
+
+  layout_inference_impl::TensorMap optimized_map;
+  auto optimized_graph = layout_inference_impl::OptimizeTranspose(
+      infer_graph, ctx, layout_infer_ctx->InferredShapes(), optimization,
+      optimized_map, report);
+  if (optimized_graph != infer_graph) {
+    for (auto& io : graph_io_map) {
+      io.second = optimized_map[io.second];
+    }
+    infer_graph = optimized_graph;
+  }
   return std::make_pair(infer_graph, graph_io_map);
 }
 
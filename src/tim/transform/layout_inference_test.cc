@@ -1,8 +1,16 @@
 #include "tim/vx/context.h"
 #include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
 #include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/ops/roi_align.h"
+#include "tim/vx/ops/topk.h"
+#include "tim/vx/ops/transpose.h"
 #include "tim/transform/layout_inference.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "gtest/gtest.h"
 
 TEST(LayoutInference, simple_conv2d) {
@@ -58,4 +66,466 @@ TEST(LayoutInference, simple_conv2d) {
                           sizeof(float) * out_data.size()));
   tim::vx::ShapeType expect_shape({1, 2, 2, 1});
   EXPECT_EQ(infer_out_shape, expect_shape);
-}
\ No newline at end of file
+}
+
+namespace {
+// 1x1 CWHN convolution with identity weights, i.e. output equals input
+struct IdentityConv2d {
+  IdentityConv2d(const std::shared_ptr<tim::vx::Graph>& graph,
+                 uint32_t channels)
+      : kernel_data(channels * channels, 0.0f), bias_data(channels, 0.0f) {
+    for (uint32_t c = 0; c < channels; ++c) {
+      kernel_data[c * channels + c] = 1.0f;
+    }
+    tim::vx::TensorSpec kernel_spec(tim::vx::DataType::FLOAT32,
+                                    {channels, 1, 1, channels},
+                                    tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {channels},
+                                  tim::vx::TensorAttribute::CONSTANT);
+    kernel = graph->CreateTensor(kernel_spec, kernel_data.data());
+    bias = graph->CreateTensor(bias_spec, bias_data.data());
+    op = graph->CreateOperation<tim::vx::ops::Conv2d>(
+        channels, tim::vx::PadType::VALID, std::array<uint32_t, 2>({1, 1}),
+        std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({0, 0}),
+        std::array<uint32_t, 4>({0, 0, 0, 0}), 0, tim::vx::DataLayout::CWHN);
+  }
+
+  void Bind(const std::shared_ptr<tim::vx::Tensor>& input,
+            const std::shared_ptr<tim::vx::Tensor>& output) {
+    (*op).BindInputs({input, kernel, bias}).BindOutput(output);
+  }
+
+  std::vector<float> kernel_data;
+  std::vector<float> bias_data;
+  std::shared_ptr<tim::vx::Tensor> kernel;
+  std::shared_ptr<tim::vx::Tensor> bias;
+  std::shared_ptr<tim::vx::Operation> op;
+};
+
+std::shared_ptr<tim::vx::Tensor> CreateFloatTensor(
+    const std::shared_ptr<tim::vx::Graph>& graph,
+    tim::vx::TensorAttribute attr,
+    const tim::vx::ShapeType& shape = {2, 2, 2, 1}) {
+  tim::vx::TensorSpec spec(tim::vx::DataType::FLOAT32, shape, attr);
+  return graph->CreateTensor(spec);
+}
+
+std::vector<float> RunInferGraph(
+    const std::shared_ptr<tim::vx::Graph>& infer_graph,
+    const std::vector<std::shared_ptr<tim::vx::Tensor>>& inputs,
+    const std::vector<std::vector<float>>& input_data,
+    const std::shared_ptr<tim::vx::Tensor>& output, size_t output_size) {
+  std::vector<float> out_data(output_size);
+  if (!infer_graph->Compile()) {
+    return {};
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    inputs[i]->CopyDataToTensor(input_data[i].data(),
+                                input_data[i].size() * sizeof(float));
+  }
+  if (!infer_graph->Run() || !output->CopyDataFromTensor(out_data.data())) {
+    return {};
+  }
+  return out_data;
+}
+}  // namespace
+
+// y + conv(x) feeding a conv: the add follows the layout of y, so the conv
+// output is transposed back and the sum forth again.
+TEST(LayoutInference, transpose_cancellation_residual_add) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input0 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT);
+  auto input1 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT);
+  auto conv_out =
+      CreateFloatTensor(src_graph, tim::vx::TensorAttribute::TRANSIENT);
+  auto sum = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::TRANSIENT);
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT);
+
+  IdentityConv2d conv0(src_graph, 2);
+  IdentityConv2d conv1(src_graph, 2);
+  conv0.Bind(input0, conv_out);
+  src_graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs({input1, conv_out})
+      .BindOutput(sum);
+  conv1.Bind(sum, output);
+
+  tim::transform::LayoutInferenceReport none_report;
+  tim::transform::LayoutInference(src_graph, ctx,
+                                  tim::transform::TransposeOptimization::NONE,
+                                  &none_report);
+  EXPECT_EQ(none_report.transpose_count_before,
+            none_report.transpose_count_after);
+
+  tim::transform::LayoutInferenceReport report;
+  auto transform = tim::transform::LayoutInference(
+      src_graph, ctx, tim::transform::TransposeOptimization::LOCAL, &report);
+  EXPECT_EQ(report.transpose_count_before, 4u);
+  EXPECT_EQ(report.transpose_count_after, 3u);
+  EXPECT_EQ(report.transpose_bytes_before, 4u * 8 * sizeof(float));
+  EXPECT_EQ(report.transpose_bytes_after, 3u * 8 * sizeof(float));
+  // conv, add, conv and the transposes left
+  EXPECT_EQ(transform.first->OpVector().size(), 6u);
+
+  std::vector<float> input0_data = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<float> input1_data = {8, 7, 6, 5, 4, 3, 2, 1};
+  auto out_data = RunInferGraph(
+      transform.first, {transform.second[input0], transform.second[input1]},
+      {input0_data, input1_data}, transform.second[output],
+      input0_data.size());
+  std::vector<float> expect_output(8, 9.0f);
+  EXPECT_EQ(out_data, expect_output);
+}
+
+// A graph output also consumed by a conv is transposed back for the output
+// and forth again for the consumer.
+TEST(LayoutInference, transpose_cancellation_intermediate_output) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT);
+  auto output0 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT);
+  auto output1 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT);
+
+  IdentityConv2d conv0(src_graph, 2);
+  IdentityConv2d conv1(src_graph, 2);
+  conv0.Bind(input, output0);
+  conv1.Bind(output0, output1);
+
+  tim::transform::LayoutInferenceReport report;
+  auto transform = tim::transform::LayoutInference(
+      src_graph, ctx, tim::transform::TransposeOptimization::LOCAL, &report);
+  EXPECT_EQ(report.transpose_count_before, 4u);
+  EXPECT_EQ(report.transpose_count_after, 3u);
+  EXPECT_EQ(report.transpose_bytes_before, 4u * 8 * sizeof(float));
+  EXPECT_EQ(report.transpose_bytes_after, 3u * 8 * sizeof(float));
+
+  std::vector<float> input_data = {1, 2, 3, 4, 5, 6, 7, 8};
+  auto out_data =
+      RunInferGraph(transform.first, {transform.second[input]}, {input_data},
+                    transform.second[output1], input_data.size());
+  EXPECT_EQ(out_data, input_data);
+}
+
+// The add and the multiply only save transposes when both change layout:
+// sum = y + conv(x) feeds a conv and sum * conv(z), a graph output.
+TEST(LayoutInference, transpose_cancellation_global) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input0 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT);
+  auto input1 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT);
+  auto input2 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT);
+  auto conv0_out =
+      CreateFloatTensor(src_graph, tim::vx::TensorAttribute::TRANSIENT);
+  auto conv2_out =
+      CreateFloatTensor(src_graph, tim::vx::TensorAttribute::TRANSIENT);
+  auto sum = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::TRANSIENT);
+  auto output0 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT);
+  auto output1 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT);
+
+  IdentityConv2d conv0(src_graph, 2);
+  IdentityConv2d conv1(src_graph, 2);
+  IdentityConv2d conv2(src_graph, 2);
+  conv0.Bind(input0, conv0_out);
+  conv2.Bind(input2, conv2_out);
+  src_graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs({input1, conv0_out})
+      .BindOutput(sum);
+  conv1.Bind(sum, output0);
+  src_graph->CreateOperation<tim::vx::ops::Multiply>()
+      ->BindInputs({sum, conv2_out})
+      .BindOutput(output1);
+
+  tim::transform::LayoutInferenceReport local_report;
+  tim::transform::LayoutInference(src_graph, ctx,
+                                  tim::transform::TransposeOptimization::LOCAL,
+                                  &local_report);
+  EXPECT_EQ(local_report.transpose_count_before, 6u);
+  EXPECT_EQ(local_report.transpose_count_after, 6u);
+
+  tim::transform::LayoutInferenceReport report;
+  auto transform = tim::transform::LayoutInference(
+      src_graph, ctx, tim::transform::TransposeOptimization::GLOBAL, &report);
+  EXPECT_EQ(report.transpose_count_before, 6u);
+  EXPECT_EQ(report.transpose_count_after, 5u);
+  EXPECT_EQ(report.transpose_bytes_before, 6u * 8 * sizeof(float));
+  EXPECT_EQ(report.transpose_bytes_after, 5u * 8 * sizeof(float));
+
+  std::vector<float> input0_data = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<float> input1_data = {1, 1, 1, 1, 1, 1, 1, 1};
+  std::vector<float> input2_data = {1, 1, 2, 2, 3, 3, 4, 4};
+  auto out_data = RunInferGraph(
+      transform.first,
+      {transform.second[input0], transform.second[input1],
+       transform.second[input2]},
+      {input0_data, input1_data, input2_data}, transform.second[output1],
+      input0_data.size());
+  std::vector<float> expect_output = {2, 3, 8, 10, 18, 21, 32, 36};
+  EXPECT_EQ(out_data, expect_output);
+}
+
+// Flipping the layout of (y + conv(x)) * c permutes the constant c
+TEST(LayoutInference, transpose_cancellation_constant_operand) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input0 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT);
+  auto input1 = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT);
+  auto conv_out =
+      CreateFloatTensor(src_graph, tim::vx::TensorAttribute::TRANSIENT);
+  auto sum = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::TRANSIENT);
+  auto product =
+      CreateFloatTensor(src_graph, tim::vx::TensorAttribute::TRANSIENT);
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT);
+  std::vector<float> scale_data = {1, 2, 3, 4, 5, 6, 7, 8};
+  tim::vx::TensorSpec scale_spec(tim::vx::DataType::FLOAT32, {2, 2, 2, 1},
+                                 tim::vx::TensorAttribute::CONSTANT);
+  auto scale = src_graph->CreateTensor(scale_spec, scale_data.data());
+
+  IdentityConv2d conv0(src_graph, 2);
+  IdentityConv2d conv1(src_graph, 2);
+  conv0.Bind(input0, conv_out);
+  src_graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs({input1, conv_out})
+      .BindOutput(sum);
+  src_graph->CreateOperation<tim::vx::ops::Multiply>()
+      ->BindInputs({sum, scale})
+      .BindOutput(product);
+  conv1.Bind(product, output);
+
+  tim::transform::LayoutInferenceReport local_report;
+  tim::transform::LayoutInference(src_graph, ctx,
+                                  tim::transform::TransposeOptimization::LOCAL,
+                                  &local_report);
+  EXPECT_EQ(local_report.transpose_count_before, 4u);
+  EXPECT_EQ(local_report.transpose_count_after, 4u);
+
+  tim::transform::LayoutInferenceReport report;
+  auto transform = tim::transform::LayoutInference(
+      src_graph, ctx, tim::transform::TransposeOptimization::GLOBAL, &report);
+  EXPECT_EQ(report.transpose_count_before, 4u);
+  EXPECT_EQ(report.transpose_count_after, 3u);
+
+  std::vector<float> input0_data = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<float> input1_data = {1, 1, 1, 1, 1, 1, 1, 1};
+  auto out_data = RunInferGraph(
+      transform.first, {transform.second[input0], transform.second[input1]},
+      {input0_data, input1_data}, transform.second[output],
+      input0_data.size());
+  std::vector<float> expect_output = {2, 6, 12, 20, 30, 42, 56, 72};
+  EXPECT_EQ(out_data, expect_output);
+}
+
+TEST(LayoutInference, transpose_cancellation_inverse_pair) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {2, 3, 4});
+  auto transposed = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::TRANSIENT, {3, 4, 2});
+  auto restored = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::TRANSIENT, {2, 3, 4});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {2, 3, 4});
+  src_graph->CreateOperation<tim::vx::ops::Transpose>(
+      std::vector<uint32_t>({1, 2, 0}))
+      ->BindInput(input)
+      .BindOutput(transposed);
+  src_graph->CreateOperation<tim::vx::ops::Transpose>(
+      std::vector<uint32_t>({2, 0, 1}))
+      ->BindInput(transposed)
+      .BindOutput(restored);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()
+      ->BindInput(restored)
+      .BindOutput(output);
+
+  tim::transform::LayoutInferenceReport report;
+  auto transform = tim::transform::LayoutInference(
+      src_graph, ctx, tim::transform::TransposeOptimization::LOCAL, &report);
+  EXPECT_EQ(report.transpose_count_before, 2u);
+  EXPECT_EQ(report.transpose_count_after, 0u);
+  EXPECT_EQ(transform.first->OpVector().size(), 1u);
+
+  std::vector<float> input_data(24);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = static_cast<float>(i) - 12.0f;
+  }
+  auto out_data =
+      RunInferGraph(transform.first, {transform.second[input]}, {input_data},
+                    transform.second[output], input_data.size());
+  std::vector<float> expect_output(24);
+  for (size_t i = 0; i < expect_output.size(); ++i) {
+    expect_output[i] = std::max(input_data[i], 0.0f);
+  }
+  EXPECT_EQ(out_data, expect_output);
+}
+
+// Pre-processing produces the WHCN image the conv needs and post-processing
+// folds the transpose back to CWHN, so no transpose is inserted.
+TEST(LayoutInference, pre_post_process_absorb_transposes) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {3, 2, 2, 1});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {3, 2, 2, 1});
+  IdentityConv2d conv(src_graph, 3);
+  conv.Bind(input, output);
+
+  tim::vx::PreProcessConfig pre_config;
+  pre_config.format = tim::vx::ImageFormat::RGB;
+  pre_config.width = 2;
+  pre_config.height = 2;
+  pre_config.layout = tim::vx::DataLayout::CWHN;
+  auto frames = src_graph->AddPreProcess(input, pre_config);
+  ASSERT_EQ(frames.size(), 1u);
+  auto converted =
+      src_graph->AddPostProcess(output, tim::vx::PostProcessConfig());
+  ASSERT_NE(converted, nullptr);
+
+  tim::transform::LayoutInferenceReport report;
+  auto transform = tim::transform::LayoutInference(
+      src_graph, ctx, tim::transform::TransposeOptimization::NONE, &report);
+  EXPECT_EQ(report.transpose_count_before, 0u);
+  // pre-processing, conv and post-processing
+  EXPECT_EQ(transform.first->OpVector().size(), 3u);
+  auto infer_frame = transform.second[frames[0]];
+  auto infer_output = transform.second[converted];
+  ASSERT_NE(infer_frame, nullptr);
+  ASSERT_NE(infer_output, nullptr);
+  EXPECT_EQ(infer_frame->GetShape(), tim::vx::ShapeType({6, 2, 1, 1}));
+  EXPECT_EQ(infer_output->GetShape(), tim::vx::ShapeType({3, 2, 2, 1}));
+
+  // Interleaved RGB pixels come out as the same CWHN values
+  std::vector<uint8_t> rgb(12);
+  std::vector<float> expect_output(12);
+  for (size_t i = 0; i < rgb.size(); ++i) {
+    rgb[i] = static_cast<uint8_t>(i * 10);
+    expect_output[i] = static_cast<float>(rgb[i]);
+  }
+  std::vector<float> out_data(expect_output.size());
+  EXPECT_TRUE(transform.first->Compile());
+  EXPECT_TRUE(infer_frame->CopyDataToTensor(rgb.data(), rgb.size()));
+  EXPECT_TRUE(transform.first->Run());
+  EXPECT_TRUE(infer_output->CopyDataFromTensor(out_data.data()));
+  EXPECT_EQ(out_data, expect_output);
+}
+
+TEST(LayoutInference, detection_ops_keep_feature_layout) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {2, 4, 4, 1});
+  auto feature = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::TRANSIENT, {2, 4, 4, 1});
+  auto rois =
+      CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT, {4, 1});
+  tim::vx::TensorSpec batch_spec(tim::vx::DataType::INT32, {1},
+                                 tim::vx::TensorAttribute::INPUT);
+  auto batch = src_graph->CreateTensor(batch_spec);
+  auto pooled = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {2, 2, 2, 1});
+  auto values = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {1, 4, 4, 1});
+  tim::vx::TensorSpec indices_spec(tim::vx::DataType::INT32, {1, 4, 4, 1},
+                                   tim::vx::TensorAttribute::OUTPUT);
+  auto indices = src_graph->CreateTensor(indices_spec);
+
+  IdentityConv2d conv(src_graph, 2);
+  conv.Bind(input, feature);
+  src_graph
+      ->CreateOperation<tim::vx::ops::RoiAlign>(2, 2, 1.0f, 1.0f, 2, 2,
+                                                tim::vx::DataLayout::CWHN)
+      ->BindInputs({feature, rois, batch})
+      .BindOutput(pooled);
+  // TopK runs on the channels of the CWHN feature
+  src_graph->CreateOperation<tim::vx::ops::TopK>(1)
+      ->BindInput(feature)
+      .BindOutputs({values, indices});
+
+  auto transform = tim::transform::LayoutInference(
+      src_graph, ctx, tim::transform::TransposeOptimization::NONE);
+  // RoiAlign reads the WHCN conv output directly, only the conv input, the
+  // RoiAlign output and the TopK input are transposed
+  EXPECT_EQ(transform.first->OpVector().size(), 6u);
+  auto infer_pooled = transform.second[pooled];
+  auto infer_values = transform.second[values];
+  ASSERT_NE(infer_pooled, nullptr);
+  ASSERT_NE(infer_values, nullptr);
+  EXPECT_EQ(infer_pooled->GetShape(), tim::vx::ShapeType({2, 2, 2, 1}));
+  EXPECT_EQ(infer_values->GetShape(), tim::vx::ShapeType({1, 4, 4, 1}));
+}
+
+namespace {
+// Residual CWHN blocks x -> conv -> relu -> add(x), three operations each
+std::shared_ptr<tim::vx::Graph> CreateResidualChain(
+    const std::shared_ptr<tim::vx::Context>& ctx, uint32_t op_num,
+    std::vector<float>& kernel_data, std::vector<float>& bias_data) {
+  const uint32_t channels = 4;
+  kernel_data.assign(channels * channels, 0.0f);
+  bias_data.assign(channels, 0.0f);
+  auto graph = ctx->CreateGraph();
+  tim::vx::ShapeType shape({channels, 8, 8, 1});
+  tim::vx::TensorSpec kernel_spec(tim::vx::DataType::FLOAT32,
+                                  {channels, 1, 1, channels},
+                                  tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {channels},
+                                tim::vx::TensorAttribute::CONSTANT);
+  auto kernel = graph->CreateTensor(kernel_spec, kernel_data.data());
+  auto bias = graph->CreateTensor(bias_spec, bias_data.data());
+
+  auto x = CreateFloatTensor(graph, tim::vx::TensorAttribute::INPUT, shape);
+  for (uint32_t block = 0; block < op_num / 3; ++block) {
+    auto conv_out =
+        CreateFloatTensor(graph, tim::vx::TensorAttribute::TRANSIENT, shape);
+    auto relu_out =
+        CreateFloatTensor(graph, tim::vx::TensorAttribute::TRANSIENT, shape);
+    auto sum = CreateFloatTensor(graph,
+                                 block + 1 == op_num / 3
+                                     ? tim::vx::TensorAttribute::OUTPUT
+                                     : tim::vx::TensorAttribute::TRANSIENT,
+                                 shape);
+    graph
+        ->CreateOperation<tim::vx::ops::Conv2d>(
+            channels, tim::vx::PadType::VALID, std::array<uint32_t, 2>({1, 1}),
+            std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({0, 0}),
+            std::array<uint32_t, 4>({0, 0, 0, 0}), 0,
+            tim::vx::DataLayout::CWHN)
+        ->BindInputs({x, kernel, bias})
+        .BindOutput(conv_out);
+    graph->CreateOperation<tim::vx::ops::Relu>()
+        ->BindInput(conv_out)
+        .BindOutput(relu_out);
+    graph->CreateOperation<tim::vx::ops::Add>()
+        ->BindInputs({relu_out, x})
+        .BindOutput(sum);
+    x = sum;
+  }
+  return graph;
+}
+}  // namespace
+
+TEST(LayoutInference, benchmark_large_graph) {
+  auto ctx = tim::vx::Context::Create();
+  std::vector<int64_t> elapsed_us;
+  for (uint32_t op_num : {1000u, 10000u}) {
+    std::vector<float> kernel_data, bias_data;
+    auto src_graph = CreateResidualChain(ctx, op_num, kernel_data, bias_data);
+
+    auto start = std::chrono::steady_clock::now();
+    tim::transform::LayoutInferenceReport report;
+    auto transform = tim::transform::LayoutInference(
+        src_graph, ctx, tim::transform::TransposeOptimization::LOCAL, &report);
+    auto end = std::chrono::steady_clock::now();
+    elapsed_us.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+            .count());
+
+    // The chain is CWHN end to end, only its input and output are transposed
+    EXPECT_EQ(report.transpose_count_before, 2u);
+    EXPECT_EQ(report.transpose_count_after, 2u);
+    EXPECT_EQ(transform.first->OpVector().size(),
+              src_graph->OpVector().size() + 2);
+    EXPECT_EQ(transform.second.size(), 2u);
+  }
+  // Ten times the ops, the cost grows about linearly rather than by 100x
+  EXPECT_LT(elapsed_us[1], 40 * std::max<int64_t>(elapsed_us[0], 1000));
+}
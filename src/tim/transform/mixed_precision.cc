@@ -0,0 +1,479 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/transform/mixed_precision.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_set>
+#include <vector>
+
+#include "graph_private.h"
+#include "operation_private.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/simple_operations.h"
+#include "type_utils.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+
+using TensorMap =
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>;
+using QuantizedGraph = std::pair<std::shared_ptr<vx::Graph>, TensorMap>;
+using Samples = std::vector<std::vector<std::vector<float>>>;
+
+// Precision of graph io and of tensors which are not float32
+constexpr int kFloat32 = -1;
+
+// Operations whose third input is a bias scaled by the input and weights
+const std::unordered_set<uint32_t> kWeightedOps = {
+    VSI_NN_OP_CONV2D, VSI_NN_OP_DECONVOLUTION, VSI_NN_OP_GROUPED_CONV2D,
+    VSI_NN_OP_FCL2,
+};
+
+size_t ElementCount(const vx::ShapeType& shape) {
+  return std::accumulate(shape.begin(), shape.end(), static_cast<size_t>(1),
+                         std::multiplies<size_t>());
+}
+
+bool IsFloat(const std::shared_ptr<vx::Tensor>& t) {
+  return t->GetSpec().datatype_ == vx::DataType::FLOAT32;
+}
+
+// Tensor of the quantized graph holding the values of `t`, looking through
+// the DataConvert of float graph io
+std::shared_ptr<vx::Tensor> QuantizedTensor(
+    const QuantizedGraph& quantized, const std::shared_ptr<vx::Tensor>& t) {
+  auto it = quantized.second.find(t);
+  if (it == quantized.second.end()) {
+    return nullptr;
+  }
+  auto q = it->second;
+  if (q->GetSpec().datatype_ != vx::DataType::FLOAT32) {
+    return q;
+  }
+  for (const auto& op : quantized.first->OpVector()) {
+    const auto& impl = op->impl();
+    if (impl->operation_id_ != VSI_NN_OP_DATACONVERT) continue;
+    if (impl->InputsTensor()[0] == q) return impl->OutputsTensor()[0];
+    if (impl->OutputsTensor()[0] == q) return impl->InputsTensor()[0];
+  }
+  return q;
+}
+
+// Largest magnitude of a tensor: from the data of constants, from the
+// quantized range otherwise
+float AbsMax(const QuantizedGraph& quantized,
+             const std::shared_ptr<vx::Tensor>& t) {
+  if (t->IsConstTensor()) {
+    const float* data = static_cast<const float*>(t->GetDataRef());
+    float absmax = 0;
+    for (size_t i = 0; data && i < ElementCount(t->GetShape()); ++i) {
+      absmax = std::max(absmax, std::fabs(data[i]));
+    }
+    return absmax;
+  }
+  auto q = QuantizedTensor(quantized, t);
+  if (!q || q->GetSpec().quantization_.Type() != vx::QuantType::ASYMMETRIC) {
+    return 0;
+  }
+  const auto& quant = q->GetSpec().quantization_;
+  double max_range, min_range;
+  vsi_nn_TypeGetRange(vx::TranslateDataType(q->GetSpec().datatype_),
+                      &max_range, &min_range);
+  const double scale = quant.Scales()[0];
+  const double zero_point = quant.ZeroPoints()[0];
+  return static_cast<float>(
+      std::max(std::fabs((min_range - zero_point) * scale),
+               std::fabs((max_range - zero_point) * scale)));
+}
+
+int8_t FractionalLength(float absmax, vx::DataType type) {
+  int8_t fl = 0;
+  if (absmax > 0) {
+    vsi_nn_QuantDFPCalParam(vx::TranslateDataType(type), absmax, -absmax, &fl);
+  }
+  return fl;
+}
+
+// Clone of the float graph with each operation in its own precision
+class MixedGraphBuilder {
+ public:
+  MixedGraphBuilder(const std::shared_ptr<vx::Graph>& src,
+                    const QuantizedGraph& quantized,
+                    std::shared_ptr<vx::Context>& ctx)
+      : src_(src), quantized_(quantized), graph_(ctx->CreateGraph()) {}
+
+  std::pair<std::shared_ptr<vx::Graph>, TensorMap> Build(
+      const std::vector<LayerPrecision>& precisions);
+
+ private:
+  vx::TensorSpec SpecOf(const std::shared_ptr<vx::Tensor>& t, int precision);
+  std::shared_ptr<vx::Tensor> Constant(const std::shared_ptr<vx::Operation>& op,
+                                       uint32_t index, int precision);
+  // Version of an activation in `precision`, converted from the precision
+  // of its producer if they differ
+  std::shared_ptr<vx::Tensor> Activation(const std::shared_ptr<vx::Tensor>& t,
+                                         int precision);
+
+  std::shared_ptr<vx::Graph> src_;
+  const QuantizedGraph& quantized_;
+  std::shared_ptr<vx::Graph> graph_;
+  std::map<std::shared_ptr<vx::Tensor>, int> produced_;
+  std::map<std::pair<std::shared_ptr<vx::Tensor>, int>,
+           std::shared_ptr<vx::Tensor>> versions_;
+};
+
+vx::TensorSpec MixedGraphBuilder::SpecOf(const std::shared_ptr<vx::Tensor>& t,
+                                         int precision) {
+  vx::TensorSpec spec(t->GetSpec());
+  if (!IsFloat(t) || precision == kFloat32) {
+    return spec;
+  }
+  if (spec.attr_ & (vx::TensorAttribute::INPUT | vx::TensorAttribute::OUTPUT)) {
+    spec.attr_ = vx::TensorAttribute::TRANSIENT;
+  }
+  switch (static_cast<LayerPrecision>(precision)) {
+    case LayerPrecision::QUANTIZED: {
+      auto q = QuantizedTensor(quantized_, t);
+      if (q) {
+        spec.datatype_ = q->GetSpec().datatype_;
+        spec.quantization_ = q->GetSpec().quantization_;
+      }
+      break;
+    }
+    case LayerPrecision::INT16:
+      spec.datatype_ = vx::DataType::INT16;
+      spec.quantization_ = vx::Quantization(
+          vx::QuantType::DYNAMIC_FIXED_POINT,
+          FractionalLength(AbsMax(quantized_, t), vx::DataType::INT16));
+      break;
+    case LayerPrecision::FLOAT16:
+      spec.datatype_ = vx::DataType::FLOAT16;
+      spec.quantization_ = vx::Quantization();
+      break;
+  }
+  return spec;
+}
+
+std::shared_ptr<vx::Tensor> MixedGraphBuilder::Constant(
+    const std::shared_ptr<vx::Operation>& op, uint32_t index, int precision) {
+  const auto& impl = op->impl();
+  auto t = impl->InputsTensor()[index];
+  if (!IsFloat(t)) precision = kFloat32;
+  auto key = std::make_pair(t, precision);
+  auto it = versions_.find(key);
+  if (it != versions_.end()) {
+    return it->second;
+  }
+
+  std::shared_ptr<vx::Tensor> dst;
+  const bool is_bias = index == 2 && kWeightedOps.count(impl->operation_id_);
+  vx::TensorSpec spec = SpecOf(t, precision);
+  if (precision == kFloat32) {
+    dst = graph_->CreateTensor(spec, t->GetDataRef());
+  } else if (precision == static_cast<int>(LayerPrecision::QUANTIZED)) {
+    auto q = QuantizedTensor(quantized_, t);
+    dst = graph_->CreateTensor(spec, q ? q->GetDataRef() : nullptr);
+  } else if (is_bias &&
+             precision == static_cast<int>(LayerPrecision::FLOAT16)) {
+    // Float16 Conv2d and FullyConnected take a float32 bias
+    dst = graph_->CreateTensor(t->GetSpec(), t->GetDataRef());
+  } else {
+    if (is_bias) {
+      auto inputs = impl->InputsTensor();
+      spec.datatype_ = vx::DataType::INT32;
+      spec.quantization_.SetFl(
+          FractionalLength(AbsMax(quantized_, inputs[0]), vx::DataType::INT16) +
+          FractionalLength(AbsMax(quantized_, inputs[1]), vx::DataType::INT16));
+    }
+    vsi_nn_dtype_t dtype;
+    memset(&dtype, 0, sizeof(dtype));
+    vx::PackTensorDtype(spec, &dtype);
+    const size_t count = ElementCount(spec.shape_);
+    std::vector<uint8_t> bytes(count * vsi_nn_TypeGetBytes(dtype.vx_type));
+    vsi_nn_DtypeConvertFloat32ToRawData(
+        static_cast<float*>(const_cast<void*>(t->GetDataRef())), count,
+        bytes.data(), bytes.size(), &dtype);
+    auto graph_impl = reinterpret_cast<vx::GraphImpl*>(graph_.get());
+    dst = graph_->CreateTensor(spec,
+                               graph_impl->HoldConstData(std::move(bytes)));
+  }
+  versions_[key] = dst;
+  return dst;
+}
+
+std::shared_ptr<vx::Tensor> MixedGraphBuilder::Activation(
+    const std::shared_ptr<vx::Tensor>& t, int precision) {
+  if (!IsFloat(t)) precision = kFloat32;
+  auto key = std::make_pair(t, precision);
+  auto it = versions_.find(key);
+  if (it != versions_.end()) {
+    return it->second;
+  }
+  auto produced = produced_.find(t);
+  const int produced_precision =
+      produced == produced_.end() ? kFloat32 : produced->second;
+  auto dst = graph_->CreateTensor(SpecOf(t, precision));
+  if (precision != produced_precision) {
+    graph_->CreateOperation<vx::ops::DataConvert>()
+        ->BindInput(Activation(t, produced_precision))
+        .BindOutput(dst);
+  }
+  versions_[key] = dst;
+  return dst;
+}
+
+std::pair<std::shared_ptr<vx::Graph>, TensorMap> MixedGraphBuilder::Build(
+    const std::vector<LayerPrecision>& precisions) {
+  const auto& ops = src_->OpVector();
+  if (precisions.size() != ops.size()) {
+    VSILOGE("Expect a precision for each of the %zu operations", ops.size());
+    return std::make_pair(graph_, TensorMap());
+  }
+  std::map<vx::Operation*, int> precision_of;
+  for (size_t i = 0; i < ops.size(); ++i) {
+    precision_of[ops[i].get()] = static_cast<int>(precisions[i]);
+    for (const auto& t : ops[i]->impl()->OutputsTensor()) {
+      produced_[t] = IsFloat(t) ? static_cast<int>(precisions[i]) : kFloat32;
+    }
+  }
+
+  // Keep the input order of the source graph
+  for (const auto& t : src_->InputsTensor()) {
+    Activation(t, kFloat32);
+    for (const auto& consumer : src_->GetConsumersOp(t)) {
+      Activation(t, precision_of[consumer.get()]);
+    }
+  }
+  for (size_t i = 0; i < ops.size(); ++i) {
+    const int precision = static_cast<int>(precisions[i]);
+    auto src_inputs = ops[i]->impl()->InputsTensor();
+    std::vector<std::shared_ptr<vx::Tensor>> inputs, outputs;
+    for (uint32_t j = 0; j < src_inputs.size(); ++j) {
+      const auto& t = src_inputs[j];
+      if (t->IsPlaceHolder()) {
+        inputs.push_back(graph_->CreateTensorPlaceHolder());
+      } else if (t->IsConstTensor()) {
+        inputs.push_back(Constant(ops[i], j, precision));
+      } else {
+        inputs.push_back(Activation(t, precision));
+      }
+    }
+    for (const auto& t : ops[i]->impl()->OutputsTensor()) {
+      outputs.push_back(Activation(t, precision));
+    }
+    ops[i]->Clone(graph_)->BindInputs(inputs).BindOutputs(outputs);
+  }
+  for (const auto& t : src_->OutputsTensor()) {
+    Activation(t, kFloat32);
+  }
+
+  // Constants used in several precisions map to their lowest one
+  TensorMap tensor_map;
+  for (const auto& version : versions_) {
+    const auto& t = version.first.first;
+    if (t->IsConstTensor()) {
+      tensor_map.emplace(t, version.second);
+      continue;
+    }
+    auto produced = produced_.find(t);
+    const bool is_io = t->GetSpec().attr_ & (vx::TensorAttribute::INPUT |
+                                             vx::TensorAttribute::OUTPUT);
+    if (version.first.second == (is_io || produced == produced_.end()
+                                     ? kFloat32
+                                     : produced->second)) {
+      tensor_map[t] = version.second;
+    }
+  }
+  return std::make_pair(graph_, tensor_map);
+}
+
+// Run every sample, the outputs of each sample are appended to `results`
+bool RunSamples(const std::shared_ptr<vx::Graph>& graph,
+                const std::vector<std::shared_ptr<vx::Tensor>>& inputs,
+                const std::vector<std::shared_ptr<vx::Tensor>>& outputs,
+                const Samples& samples, std::vector<float>* results,
+                double* run_ms) {
+  if (!graph->Compile()) {
+    return false;
+  }
+  double total_ms = 0;
+  results->clear();
+  for (const auto& sample : samples) {
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (sample.size() != inputs.size() ||
+          sample[i].size() != ElementCount(inputs[i]->GetShape()) ||
+          !inputs[i]->CopyDataToTensor(sample[i].data(),
+                                       sample[i].size() * sizeof(float))) {
+        VSILOGE("Sample does not fit input %zu", i);
+        return false;
+      }
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (!graph->Run()) {
+      return false;
+    }
+    total_ms += std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    for (const auto& output : outputs) {
+      std::vector<float> values(ElementCount(output->GetShape()));
+      if (!output->CopyDataFromTensor(values.data())) {
+        return false;
+      }
+      results->insert(results->end(), values.begin(), values.end());
+    }
+  }
+  *run_ms = total_ms / samples.size();
+  return true;
+}
+
+float RelativeError(const std::vector<float>& reference,
+                    const std::vector<float>& values) {
+  double diff = 0, norm = 0;
+  for (size_t i = 0; i < reference.size() && i < values.size(); ++i) {
+    diff += (values[i] - reference[i]) * (values[i] - reference[i]);
+    norm += reference[i] * reference[i];
+  }
+  return static_cast<float>(std::sqrt(diff / std::max(norm, 1e-12)));
+}
+
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>, TensorMap> ApplyLayerPrecision(
+    const std::shared_ptr<vx::Graph>& float_graph,
+    const QuantizedGraph& quantized, std::shared_ptr<vx::Context>& ctx,
+    const std::vector<LayerPrecision>& precisions) {
+  return MixedGraphBuilder(float_graph, quantized, ctx).Build(precisions);
+}
+
+std::pair<std::shared_ptr<vx::Graph>, TensorMap> MixedPrecision(
+    const std::shared_ptr<vx::Graph>& float_graph,
+    const QuantizedGraph& quantized, std::shared_ptr<vx::Context>& ctx,
+    const Samples& samples, const MixedPrecisionOptions& options,
+    MixedPrecisionReport* report) {
+  const size_t op_count = float_graph->OpVector().size();
+  std::vector<LayerPrecision> precisions(op_count, LayerPrecision::QUANTIZED);
+  std::vector<float> reference;
+  double float_ms = 0;
+  if (samples.empty() ||
+      !RunSamples(float_graph, float_graph->InputsTensor(),
+                  float_graph->OutputsTensor(), samples, &reference,
+                  &float_ms)) {
+    VSILOGE("Fail to run the float graph on the samples");
+    return std::make_pair(ctx->CreateGraph(), TensorMap());
+  }
+
+  auto evaluate = [&](const std::vector<LayerPrecision>& candidate) {
+    PrecisionTradeoff point;
+    for (auto p : candidate) {
+      point.int16_layers += p == LayerPrecision::INT16 ? 1 : 0;
+      point.float16_layers += p == LayerPrecision::FLOAT16 ? 1 : 0;
+    }
+    auto mixed = ApplyLayerPrecision(float_graph, quantized, ctx, candidate);
+    std::vector<std::shared_ptr<vx::Tensor>> inputs, outputs;
+    for (const auto& t : float_graph->InputsTensor()) {
+      inputs.push_back(mixed.second[t]);
+    }
+    for (const auto& t : float_graph->OutputsTensor()) {
+      outputs.push_back(mixed.second[t]);
+    }
+    std::vector<float> values;
+    if (mixed.second.empty() ||
+        !RunSamples(mixed.first, inputs, outputs, samples, &values,
+                    &point.run_ms)) {
+      VSILOGW("Fail to run %u int16 and %u float16 layers", point.int16_layers,
+              point.float16_layers);
+      point.error = std::numeric_limits<float>::max();
+      return point;
+    }
+    point.error = RelativeError(reference, values);
+    return point;
+  };
+
+  MixedPrecisionReport stats;
+  auto quantized_point = evaluate(precisions);
+  stats.quantized_error = quantized_point.error;
+  stats.tradeoff.push_back(quantized_point);
+
+  // Sensitivity of each layer raised on its own
+  for (size_t i = 0; i < op_count; ++i) {
+    LayerPrecisionReport layer;
+    layer.op = float_graph->OpVector()[i];
+    precisions[i] = LayerPrecision::INT16;
+    layer.int16_error = evaluate(precisions).error;
+    precisions[i] = LayerPrecision::FLOAT16;
+    layer.float16_error = evaluate(precisions).error;
+    precisions[i] = LayerPrecision::QUANTIZED;
+    stats.layers.push_back(layer);
+  }
+
+  std::vector<size_t> order(op_count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&stats](size_t a, size_t b) {
+    return stats.layers[a].float16_error < stats.layers[b].float16_error;
+  });
+  float error = stats.quantized_error;
+  for (size_t i : order) {
+    if (error <= options.error_budget) break;
+    precisions[i] = LayerPrecision::INT16;
+    auto point = evaluate(precisions);
+    if (point.error > options.error_budget) {
+      precisions[i] = LayerPrecision::FLOAT16;
+      auto float16_point = evaluate(precisions);
+      // Keep int16 if float16 does not help either
+      if (float16_point.error < point.error) {
+        point = float16_point;
+      } else {
+        precisions[i] = LayerPrecision::INT16;
+      }
+    }
+    error = point.error;
+    stats.tradeoff.push_back(point);
+  }
+  for (size_t i = 0; i < op_count; ++i) {
+    stats.layers[i].precision = precisions[i];
+  }
+  stats.tradeoff.push_back(
+      evaluate(std::vector<LayerPrecision>(op_count, LayerPrecision::FLOAT16)));
+  if (error > options.error_budget) {
+    VSILOGW("Error %f stays above the budget %f", error, options.error_budget);
+  }
+
+  if (report) {
+    *report = stats;
+  }
+  return ApplyLayerPrecision(float_graph, quantized, ctx, precisions);
+}
+
+}  // namespace transform
+}  // namespace tim
@@ -0,0 +1,158 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/transform/calibration.h"
+#include "tim/transform/mixed_precision.h"
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+std::shared_ptr<tim::vx::Tensor> CreateFloatTensor(
+    const std::shared_ptr<tim::vx::Graph>& graph,
+    tim::vx::TensorAttribute attr, const tim::vx::ShapeType& shape,
+    const void* data = nullptr) {
+  tim::vx::TensorSpec spec(tim::vx::DataType::FLOAT32, shape, attr);
+  return graph->CreateTensor(spec, data);
+}
+
+// input -> Conv2d -> Relu -> output
+struct ConvReluGraph {
+  explicit ConvReluGraph(const std::shared_ptr<tim::vx::Context>& ctx) {
+    graph = ctx->CreateGraph();
+    input = CreateFloatTensor(graph, tim::vx::TensorAttribute::INPUT,
+                              {3, 3, 1, 1});
+    weights = CreateFloatTensor(graph, tim::vx::TensorAttribute::CONSTANT,
+                                {2, 2, 1, 2}, weights_data.data());
+    bias = CreateFloatTensor(graph, tim::vx::TensorAttribute::CONSTANT, {2},
+                             bias_data.data());
+    conv_out = CreateFloatTensor(graph, tim::vx::TensorAttribute::TRANSIENT,
+                                 {2, 2, 2, 1});
+    output = CreateFloatTensor(graph, tim::vx::TensorAttribute::OUTPUT,
+                               {2, 2, 2, 1});
+    auto conv = graph->CreateOperation<tim::vx::ops::Conv2d>(
+        2, tim::vx::PadType::VALID, std::array<uint32_t, 2>({2, 2}),
+        std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+    (*conv).BindInputs({input, weights, bias}).BindOutputs({conv_out});
+    auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+    (*relu).BindInputs({conv_out}).BindOutputs({output});
+  }
+  std::vector<float> weights_data = {1.0f, -1.0f, 0.5f, 0.25f,
+                                     -0.5f, 2.0f, 1.0f, 0.0f};
+  std::vector<float> bias_data = {0.5f, -1.0f};
+  std::shared_ptr<tim::vx::Graph> graph;
+  std::shared_ptr<tim::vx::Tensor> input, weights, bias, conv_out, output;
+};
+
+std::pair<std::shared_ptr<tim::vx::Graph>,
+          std::map<std::shared_ptr<tim::vx::Tensor>,
+                   std::shared_ptr<tim::vx::Tensor>>>
+QuantizeWithRanges(const ConvReluGraph& src,
+                   std::shared_ptr<tim::vx::Context>& ctx) {
+  auto calibrator = tim::transform::Calibrator::Create(src.graph, ctx);
+  std::vector<float> input_range = {-1.0f, 3.0f};
+  std::vector<float> conv_range = {-4.0f, 6.0f};
+  std::vector<float> output_range = {0.0f, 6.0f};
+  calibrator->Observe(src.input, input_range.data(), 2);
+  calibrator->Observe(src.conv_out, conv_range.data(), 2);
+  calibrator->Observe(src.output, output_range.data(), 2);
+  return calibrator->Quantize(ctx);
+}
+}  // namespace
+
+TEST(MixedPrecision, all_quantized_matches_quantized_graph) {
+  auto ctx = tim::vx::Context::Create();
+  ConvReluGraph src(ctx);
+  auto quantized = QuantizeWithRanges(src, ctx);
+  ASSERT_FALSE(quantized.second.empty());
+
+  auto mixed = tim::transform::ApplyLayerPrecision(
+      src.graph, quantized, ctx,
+      {tim::transform::LayerPrecision::QUANTIZED,
+       tim::transform::LayerPrecision::QUANTIZED});
+  ASSERT_FALSE(mixed.second.empty());
+  // DataConvert at the float input and output only
+  EXPECT_EQ(mixed.first->OpVector().size(), 4u);
+  EXPECT_EQ(mixed.second[src.input]->GetSpec().datatype_,
+            tim::vx::DataType::FLOAT32);
+  EXPECT_EQ(mixed.second[src.output]->GetSpec().datatype_,
+            tim::vx::DataType::FLOAT32);
+  auto conv_out = mixed.second[src.conv_out]->GetSpec();
+  auto q_conv_out = quantized.second[src.conv_out]->GetSpec();
+  EXPECT_EQ(conv_out.datatype_, tim::vx::DataType::UINT8);
+  EXPECT_EQ(conv_out.quantization_.Scales(), q_conv_out.quantization_.Scales());
+  EXPECT_EQ(mixed.second[src.weights]->GetDataRef(),
+            quantized.second[src.weights]->GetDataRef());
+}
+
+TEST(MixedPrecision, int16_conv_float16_relu) {
+  auto ctx = tim::vx::Context::Create();
+  ConvReluGraph src(ctx);
+  auto quantized = QuantizeWithRanges(src, ctx);
+  ASSERT_FALSE(quantized.second.empty());
+
+  auto mixed = tim::transform::ApplyLayerPrecision(
+      src.graph, quantized, ctx,
+      {tim::transform::LayerPrecision::INT16,
+       tim::transform::LayerPrecision::FLOAT16});
+  ASSERT_FALSE(mixed.second.empty());
+  // float32 -> int16 -> Conv2d -> float16 -> Relu -> float32
+  EXPECT_EQ(mixed.first->OpVector().size(), 5u);
+
+  // Weights up to 2 keep 14 fractional bits, the uint8 input range up to
+  // about 3 keeps 13
+  auto weights = mixed.second[src.weights]->GetSpec();
+  EXPECT_EQ(weights.datatype_, tim::vx::DataType::INT16);
+  EXPECT_EQ(weights.quantization_.Type(),
+            tim::vx::QuantType::DYNAMIC_FIXED_POINT);
+  EXPECT_EQ(weights.quantization_.Fl(), 14);
+  std::vector<int16_t> weights_data(8);
+  memcpy(weights_data.data(), mixed.second[src.weights]->GetDataRef(), 16);
+  EXPECT_EQ(weights_data[0], 1 << 14);
+  EXPECT_EQ(weights_data[2], 1 << 13);
+
+  auto conv_out = mixed.second[src.conv_out]->GetSpec();
+  EXPECT_EQ(conv_out.datatype_, tim::vx::DataType::INT16);
+  EXPECT_EQ(conv_out.quantization_.Type(),
+            tim::vx::QuantType::DYNAMIC_FIXED_POINT);
+  auto bias = mixed.second[src.bias]->GetSpec();
+  EXPECT_EQ(bias.datatype_, tim::vx::DataType::INT32);
+  EXPECT_EQ(bias.quantization_.Fl(), 13 + 14);
+  std::vector<int32_t> bias_data(2);
+  memcpy(bias_data.data(), mixed.second[src.bias]->GetDataRef(), 8);
+  EXPECT_EQ(bias_data[0], 1 << 26);
+
+  EXPECT_EQ(mixed.second[src.output]->GetSpec().datatype_,
+            tim::vx::DataType::FLOAT32);
+}
+
+TEST(MixedPrecision, search_within_budget) {
+  auto ctx = tim::vx::Context::Create();
+  ConvReluGraph src(ctx);
+  auto quantized = QuantizeWithRanges(src, ctx);
+  ASSERT_FALSE(quantized.second.empty());
+
+  std::vector<std::vector<std::vector<float>>> samples;
+  for (int s = 0; s < 4; ++s) {
+    std::vector<float> sample(9);
+    for (size_t i = 0; i < sample.size(); ++i) {
+      sample[i] = static_cast<float>((i * 5 + s) % 9) * 0.4f - 0.8f;
+    }
+    samples.push_back({sample});
+  }
+  tim::transform::MixedPrecisionOptions options;
+  options.error_budget = 0.001f;
+  tim::transform::MixedPrecisionReport report;
+  auto mixed = tim::transform::MixedPrecision(src.graph, quantized, ctx,
+                                              samples, options, &report);
+  ASSERT_FALSE(mixed.second.empty());
+  EXPECT_EQ(report.layers.size(), 2u);
+  // All quantized, at least one raised layer, all float16
+  EXPECT_GE(report.tradeoff.size(), 3u);
+  EXPECT_LE(report.tradeoff[report.tradeoff.size() - 2].error,
+            report.quantized_error);
+  EXPECT_LT(report.layers[0].float16_error, report.quantized_error);
+}
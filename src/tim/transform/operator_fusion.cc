@@ -0,0 +1,337 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/transform/operator_fusion.h"
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "operation_private.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/fullyconnected.h"
+#include "tim/vx/ops/fused_operations.h"
+#include "type_utils.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+
+using TensorMap =
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>;
+
+// Conv2d/FullyConnected -> Relu [-> Pool2d] replaced by one fused operation
+struct FusionGroup {
+  std::shared_ptr<vx::Operation> root;
+  std::shared_ptr<vx::Operation> pool;
+  std::shared_ptr<vx::Tensor> output;
+};
+
+uint32_t OpId(const std::shared_ptr<vx::Operation>& op) {
+  return op->impl()->operation_id_;
+}
+
+// Consumer of tensor if it can be fused away: transient and only used once
+std::shared_ptr<vx::Operation> FusableConsumer(
+    const std::shared_ptr<vx::Graph>& graph,
+    const std::shared_ptr<vx::Tensor>& tensor) {
+  if (tensor->GetSpec().attr_ != vx::TensorAttribute::TRANSIENT) {
+    return nullptr;
+  }
+  auto consumers = graph->GetConsumersOp(tensor);
+  return consumers.size() == 1 ? consumers[0] : nullptr;
+}
+
+// The fused ops run on the NN engine, which takes float16/float32 or
+// asymmetric uint8 for input, weight and output alike
+bool IsNNDataType(const vx::TensorSpec& input, const vx::TensorSpec& weight,
+                  const vx::TensorSpec& output) {
+  if (input.datatype_ != weight.datatype_ ||
+      input.datatype_ != output.datatype_) {
+    return false;
+  }
+  switch (input.datatype_) {
+    case vx::DataType::FLOAT16:
+    case vx::DataType::FLOAT32:
+      return input.quantization_.Type() == vx::QuantType::NONE &&
+             weight.quantization_.Type() == vx::QuantType::NONE &&
+             output.quantization_.Type() == vx::QuantType::NONE;
+    case vx::DataType::UINT8:
+      return input.quantization_.Type() == vx::QuantType::ASYMMETRIC &&
+             weight.quantization_.Type() == vx::QuantType::ASYMMETRIC &&
+             output.quantization_.Type() == vx::QuantType::ASYMMETRIC;
+    default:
+      return false;
+  }
+}
+
+// Relu6 equals Relu when the output can not represent values above 6
+bool SaturatesAtSix(const vx::TensorSpec& spec) {
+  const auto& quant = spec.quantization_;
+  if (spec.datatype_ != vx::DataType::UINT8 ||
+      quant.Type() != vx::QuantType::ASYMMETRIC || quant.Scales().empty() ||
+      quant.ZeroPoints().empty()) {
+    return false;
+  }
+  return quant.Scales()[0] * (255 - quant.ZeroPoints()[0]) <= 6.0f + 1e-5f;
+}
+
+std::shared_ptr<vx::Operation> FusableRelu(
+    const std::shared_ptr<vx::Graph>& graph,
+    const std::shared_ptr<vx::Tensor>& tensor) {
+  auto op = FusableConsumer(graph, tensor);
+  if (!op || op->impl()->OutputsTensor().size() != 1) {
+    return nullptr;
+  }
+  if (OpId(op) == VSI_NN_OP_RELU) {
+    return op;
+  }
+  if (OpId(op) == VSI_NN_OP_RELU6 &&
+      SaturatesAtSix(op->impl()->OutputsTensor()[0]->GetSpec())) {
+    return op;
+  }
+  return nullptr;
+}
+
+// The NN engine pools 2x2 or 3x3 windows with stride 2 and no padding
+std::shared_ptr<vx::Operation> FusablePool(
+    const std::shared_ptr<vx::Graph>& graph,
+    const std::shared_ptr<vx::Tensor>& tensor) {
+  auto op = FusableConsumer(graph, tensor);
+  if (!op || OpId(op) != VSI_NN_OP_POOL ||
+      op->impl()->OutputsTensor().size() != 1) {
+    return nullptr;
+  }
+  const auto& pool = op->impl()->node()->nn_param.pool;
+  bool fusable = pool.type == VX_CONVOLUTIONAL_NETWORK_POOLING_MAX &&
+                 pool.round_type == VSI_NN_ROUND_FLOOR &&
+                 pool.pad_type != VSI_NN_PAD_SAME &&
+                 pool.ksize[0] == pool.ksize[1] &&
+                 (pool.ksize[0] == 2 || pool.ksize[0] == 3) &&
+                 pool.stride[0] == 2 && pool.stride[1] == 2 &&
+                 pool.pad[0] == 0 && pool.pad[1] == 0 && pool.pad[2] == 0 &&
+                 pool.pad[3] == 0;
+  return fusable ? op : nullptr;
+}
+
+// Weights and bias are baked into the NN command at compile time
+bool HasConstWeights(const std::shared_ptr<vx::Operation>& op) {
+  auto inputs = op->impl()->InputsTensor();
+  if (inputs.size() < 2 || inputs.size() > 3 ||
+      op->impl()->OutputsTensor().size() != 1) {
+    return false;
+  }
+  for (size_t i = 1; i < inputs.size(); ++i) {
+    if (!inputs[i]->IsConstTensor()) return false;
+  }
+  return IsNNDataType(inputs[0]->GetSpec(), inputs[1]->GetSpec(),
+                      op->impl()->OutputsTensor()[0]->GetSpec());
+}
+
+bool MatchConv2d(const std::shared_ptr<vx::Graph>& graph,
+                 const std::shared_ptr<vx::Operation>& op, FusionGroup& group) {
+  auto conv = std::dynamic_pointer_cast<vx::ops::Conv2d>(op);
+  if (!conv || OpId(op) != VSI_NN_OP_CONV2D || !HasConstWeights(op) ||
+      conv->KernelDataLayout() != vx::DataLayout::WHIcOc ||
+      op->impl()->InputsTensor()[1]->GetShape().size() != 4) {
+    return false;
+  }
+  auto relu = FusableRelu(graph, op->impl()->OutputsTensor()[0]);
+  if (!relu) {
+    return false;
+  }
+  group.root = op;
+  group.output = relu->impl()->OutputsTensor()[0];
+  // The fused node only resolves SAME padding of the convolution when it
+  // also computes the output shape, keep it to explicit padding
+  if (op->impl()->node()->nn_param.conv2d.pad_type != VSI_NN_PAD_SAME) {
+    group.pool = FusablePool(graph, group.output);
+    if (group.pool) {
+      group.output = group.pool->impl()->OutputsTensor()[0];
+    }
+  }
+  return true;
+}
+
+bool MatchFullyConnected(const std::shared_ptr<vx::Graph>& graph,
+                         const std::shared_ptr<vx::Operation>& op,
+                         FusionGroup& group) {
+  if (!std::dynamic_pointer_cast<vx::ops::FullyConnected>(op) ||
+      OpId(op) != VSI_NN_OP_FCL2 || !HasConstWeights(op)) {
+    return false;
+  }
+  // FCL_RELU coerces the input to 2D on its last axis only
+  auto input_rank = op->impl()->InputsTensor()[0]->GetShape().size();
+  auto axis = op->impl()->node()->nn_param.fcl.axis;
+  if (input_rank < 2 || input_rank > 4 || axis + 2 != input_rank ||
+      op->impl()->InputsTensor()[1]->GetShape().size() != 2) {
+    return false;
+  }
+  auto relu = FusableRelu(graph, op->impl()->OutputsTensor()[0]);
+  if (!relu) {
+    return false;
+  }
+  group.root = op;
+  group.output = relu->impl()->OutputsTensor()[0];
+  return true;
+}
+
+// The fused ops need a bias; zero buffers are shared, one per size
+const void* ZeroData(size_t bytes) {
+  static std::mutex mutex;
+  static std::unordered_map<size_t, std::vector<uint8_t>> buffers;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& buffer = buffers[bytes];
+  buffer.resize(bytes, 0);
+  return buffer.data();
+}
+
+std::shared_ptr<vx::Tensor> CreateZeroBias(
+    const std::shared_ptr<vx::Graph>& graph, const vx::TensorSpec& input,
+    const vx::TensorSpec& weight, uint32_t channels) {
+  vx::TensorSpec spec(vx::DataType::FLOAT32, {channels},
+                      vx::TensorAttribute::CONSTANT);
+  if (input.datatype_ == vx::DataType::UINT8) {
+    float scale =
+        input.quantization_.Scales()[0] * weight.quantization_.Scales()[0];
+    spec = vx::TensorSpec(
+        vx::DataType::INT32, {channels}, vx::TensorAttribute::CONSTANT,
+        vx::Quantization(vx::QuantType::ASYMMETRIC, scale, 0));
+  }
+  return graph->CreateTensor(spec, ZeroData(channels * sizeof(int32_t)));
+}
+
+std::shared_ptr<vx::Operation> CreateFusedOp(
+    const std::shared_ptr<vx::Graph>& graph, const FusionGroup& group,
+    OperatorFusionReport& report) {
+  auto conv = std::dynamic_pointer_cast<vx::ops::Conv2d>(group.root);
+  if (!conv) {
+    ++report.fully_connected_relu;
+    auto fc = std::dynamic_pointer_cast<vx::ops::FullyConnected>(group.root);
+    return graph->CreateOperation<vx::ops::FullyConnectedRelu>(std::cref(*fc));
+  }
+  if (!group.pool) {
+    ++report.conv2d_relu;
+    return graph->CreateOperation<vx::ops::Conv2dRelu>(std::cref(*conv));
+  }
+  ++report.conv2d_relu_pool2d;
+  const auto& pool = group.pool->impl()->node()->nn_param.pool;
+  return graph->CreateOperation<vx::ops::Conv2dReluPool2d>(
+      std::cref(*conv), vx::PoolType::MAX,
+      std::array<uint32_t, 2>({pool.ksize[0], pool.ksize[1]}),
+      std::array<uint32_t, 2>({pool.stride[0], pool.stride[1]}),
+      vx::RoundType::FLOOR);
+}
+
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+OperatorFusion(const std::shared_ptr<vx::Graph>& src_graph,
+               std::shared_ptr<vx::Context>& ctx,
+               OperatorFusionReport* report) {
+  OperatorFusionReport stats;
+  std::unordered_map<std::shared_ptr<vx::Operation>, FusionGroup> groups;
+  std::unordered_set<std::shared_ptr<vx::Operation>> fused_away;
+  for (const auto& op : src_graph->OpVector()) {
+    FusionGroup group;
+    if (MatchConv2d(src_graph, op, group) ||
+        MatchFullyConnected(src_graph, op, group)) {
+      for (const auto& consumer :
+           src_graph->GetConsumersOp(op->impl()->OutputsTensor()[0])) {
+        fused_away.insert(consumer);
+      }
+      if (group.pool) {
+        fused_away.insert(group.pool);
+      }
+      groups[op] = group;
+    }
+  }
+
+  auto graph = ctx->CreateGraph();
+  TensorMap tensor_map;
+  auto tensor_of = [&graph, &tensor_map](const std::shared_ptr<vx::Tensor>& t) {
+    auto it = tensor_map.find(t);
+    if (it != tensor_map.end()) {
+      return it->second;
+    }
+    std::shared_ptr<vx::Tensor> dst;
+    if (t->IsPlaceHolder()) {
+      dst = graph->CreateTensorPlaceHolder();
+    } else if (t->IsConstTensor()) {
+      dst = graph->CreateTensor(t->GetSpec(), t->GetDataRef());
+    } else {
+      dst = graph->CreateTensor(t->GetSpec());
+    }
+    tensor_map[t] = dst;
+    return dst;
+  };
+  // Keep the io order of the source graph
+  for (const auto& t : src_graph->InputsTensor()) tensor_of(t);
+  for (const auto& t : src_graph->OutputsTensor()) tensor_of(t);
+
+  for (const auto& op : src_graph->OpVector()) {
+    if (fused_away.count(op)) continue;
+    auto group = groups.find(op);
+    if (group == groups.end()) {
+      auto cloned = op->Clone(graph);
+      for (const auto& t : op->impl()->InputsTensor()) {
+        cloned->BindInput(tensor_of(t));
+      }
+      for (const auto& t : op->impl()->OutputsTensor()) {
+        cloned->BindOutput(tensor_of(t));
+      }
+      continue;
+    }
+    auto fused = CreateFusedOp(graph, group->second, stats);
+    auto inputs = op->impl()->InputsTensor();
+    for (const auto& t : inputs) {
+      fused->BindInput(tensor_of(t));
+    }
+    if (inputs.size() == 2) {
+      auto weight = inputs[1]->GetShape();
+      uint32_t channels =
+          (OpId(op) == VSI_NN_OP_CONV2D) ? weight[3] : weight[1];
+      fused->BindInput(CreateZeroBias(graph, inputs[0]->GetSpec(),
+                                      inputs[1]->GetSpec(), channels));
+    }
+    fused->BindOutput(tensor_of(group->second.output));
+  }
+
+  stats.op_count_before = src_graph->OpVector().size();
+  stats.op_count_after = graph->OpVector().size();
+  if (report) {
+    *report = stats;
+  }
+  return std::make_pair(graph, tensor_map);
+}
+
+}  // namespace transform
+}  // namespace tim
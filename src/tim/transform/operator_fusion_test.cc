@@ -0,0 +1,334 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/fullyconnected.h"
+#include "tim/vx/ops/fused_operations.h"
+#include "tim/vx/ops/pool2d.h"
+#include "tim/transform/operator_fusion.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+using Ksize = std::array<uint32_t, 2>;
+
+std::shared_ptr<tim::vx::Tensor> CreateFloatTensor(
+    const std::shared_ptr<tim::vx::Graph>& graph,
+    tim::vx::TensorAttribute attr, const tim::vx::ShapeType& shape,
+    const void* data = nullptr) {
+  tim::vx::TensorSpec spec(tim::vx::DataType::FLOAT32, shape, attr);
+  return graph->CreateTensor(spec, data);
+}
+
+std::vector<float> Ramp(size_t size, float step) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = (static_cast<int>(i % 7) - 3) * step;
+  }
+  return data;
+}
+
+std::vector<float> RunGraph(const std::shared_ptr<tim::vx::Graph>& graph,
+                            const std::shared_ptr<tim::vx::Tensor>& input,
+                            const std::vector<float>& input_data,
+                            const std::shared_ptr<tim::vx::Tensor>& output,
+                            size_t output_size) {
+  std::vector<float> out_data(output_size);
+  if (!graph->Compile() ||
+      !input->CopyDataToTensor(input_data.data(),
+                               input_data.size() * sizeof(float)) ||
+      !graph->Run() || !output->CopyDataFromTensor(out_data.data())) {
+    return {};
+  }
+  return out_data;
+}
+
+// conv(1x1, 2 -> 2) -> relu, with or without a 2x2 max pool
+struct ConvReluModel {
+  ConvReluModel(const std::shared_ptr<tim::vx::Graph>& graph, bool with_pool)
+      : weights_data({1.0f, -1.0f, 0.5f, 2.0f}), bias_data({0.5f, -1.0f}) {
+    input = CreateFloatTensor(graph, tim::vx::TensorAttribute::INPUT,
+                              {4, 4, 2, 1});
+    auto weights = CreateFloatTensor(graph, tim::vx::TensorAttribute::CONSTANT,
+                                     {1, 1, 2, 2}, weights_data.data());
+    auto bias = CreateFloatTensor(graph, tim::vx::TensorAttribute::CONSTANT,
+                                  {2}, bias_data.data());
+    auto conv_out = CreateFloatTensor(
+        graph, tim::vx::TensorAttribute::TRANSIENT, {4, 4, 2, 1});
+    output = CreateFloatTensor(graph,
+                               with_pool ? tim::vx::TensorAttribute::TRANSIENT
+                                         : tim::vx::TensorAttribute::OUTPUT,
+                               {4, 4, 2, 1});
+    auto conv = graph->CreateOperation<tim::vx::ops::Conv2d>(
+        2, tim::vx::PadType::VALID, Ksize({1, 1}), Ksize({1, 1}),
+        Ksize({1, 1}));
+    (*conv).BindInputs({input, weights, bias}).BindOutputs({conv_out});
+    auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+    (*relu).BindInputs({conv_out}).BindOutputs({output});
+    if (with_pool) {
+      auto pool_out = CreateFloatTensor(
+          graph, tim::vx::TensorAttribute::OUTPUT, {2, 2, 2, 1});
+      auto pool = graph->CreateOperation<tim::vx::ops::Pool2d>(
+          tim::vx::PoolType::MAX, tim::vx::PadType::VALID, Ksize({2, 2}),
+          Ksize({2, 2}));
+      (*pool).BindInputs({output}).BindOutputs({pool_out});
+      output = pool_out;
+    }
+  }
+
+  std::vector<float> weights_data;
+  std::vector<float> bias_data;
+  std::shared_ptr<tim::vx::Tensor> input;
+  std::shared_ptr<tim::vx::Tensor> output;
+};
+}  // namespace
+
+TEST(OperatorFusion, conv2d_relu) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  ConvReluModel model(src_graph, false);
+
+  tim::transform::OperatorFusionReport report;
+  auto fused = tim::transform::OperatorFusion(src_graph, ctx, &report);
+  EXPECT_EQ(report.op_count_before, 2u);
+  EXPECT_EQ(report.op_count_after, 1u);
+  EXPECT_EQ(report.conv2d_relu, 1u);
+  ASSERT_EQ(fused.first->OpVector().size(), 1u);
+  EXPECT_TRUE(std::dynamic_pointer_cast<tim::vx::ops::Conv2dRelu>(
+      fused.first->OpVector()[0]));
+
+  auto input_data = Ramp(32, 0.5f);
+  auto expect = RunGraph(src_graph, model.input, input_data, model.output, 32);
+  auto out = RunGraph(fused.first, fused.second[model.input], input_data,
+                      fused.second[model.output], 32);
+  ASSERT_EQ(out.size(), 32u);
+  EXPECT_TRUE(ArraysMatch(expect, out, 1e-5f));
+}
+
+TEST(OperatorFusion, conv2d_relu_pool2d) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  ConvReluModel model(src_graph, true);
+
+  tim::transform::OperatorFusionReport report;
+  auto fused = tim::transform::OperatorFusion(src_graph, ctx, &report);
+  EXPECT_EQ(report.op_count_before, 3u);
+  EXPECT_EQ(report.op_count_after, 1u);
+  EXPECT_EQ(report.conv2d_relu_pool2d, 1u);
+  ASSERT_EQ(fused.first->OpVector().size(), 1u);
+  EXPECT_TRUE(std::dynamic_pointer_cast<tim::vx::ops::Conv2dReluPool2d>(
+      fused.first->OpVector()[0]));
+
+  auto input_data = Ramp(32, 0.5f);
+  auto expect = RunGraph(src_graph, model.input, input_data, model.output, 8);
+  auto out = RunGraph(fused.first, fused.second[model.input], input_data,
+                      fused.second[model.output], 8);
+  ASSERT_EQ(out.size(), 8u);
+  EXPECT_TRUE(ArraysMatch(expect, out, 1e-5f));
+}
+
+// No bias on the FullyConnected: the fused op gets a zero one
+TEST(OperatorFusion, fully_connected_relu) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {4, 2});
+  std::vector<float> weights_data = Ramp(12, 0.25f);
+  auto weights = CreateFloatTensor(src_graph,
+                                   tim::vx::TensorAttribute::CONSTANT, {4, 3},
+                                   weights_data.data());
+  auto fc_out = CreateFloatTensor(src_graph,
+                                  tim::vx::TensorAttribute::TRANSIENT, {3, 2});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {3, 2});
+  auto fc = src_graph->CreateOperation<tim::vx::ops::FullyConnected>(0, 3);
+  (*fc).BindInputs({input, weights}).BindOutputs({fc_out});
+  auto relu = src_graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInputs({fc_out}).BindOutputs({output});
+
+  tim::transform::OperatorFusionReport report;
+  auto fused = tim::transform::OperatorFusion(src_graph, ctx, &report);
+  EXPECT_EQ(report.op_count_after, 1u);
+  EXPECT_EQ(report.fully_connected_relu, 1u);
+  ASSERT_EQ(fused.first->OpVector().size(), 1u);
+  EXPECT_TRUE(std::dynamic_pointer_cast<tim::vx::ops::FullyConnectedRelu>(
+      fused.first->OpVector()[0]));
+
+  auto input_data = Ramp(8, 1.0f);
+  auto expect = RunGraph(src_graph, input, input_data, output, 6);
+  auto out = RunGraph(fused.first, fused.second[input], input_data,
+                      fused.second[output], 6);
+  ASSERT_EQ(out.size(), 6u);
+  EXPECT_TRUE(ArraysMatch(expect, out, 1e-5f));
+}
+
+// A conv output that is also a graph output has to stay, so does a float
+// Relu6 which the NN engine can not clamp
+TEST(OperatorFusion, unfusable_patterns) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  std::vector<float> weights_data = {1.0f, -1.0f, 0.5f, 2.0f};
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {4, 4, 2, 1});
+  auto weights = CreateFloatTensor(src_graph,
+                                   tim::vx::TensorAttribute::CONSTANT,
+                                   {1, 1, 2, 2}, weights_data.data());
+  auto conv0_out = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::OUTPUT, {4, 4, 2, 1});
+  auto relu_out = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::TRANSIENT, {4, 4, 2, 1});
+  auto conv1_out = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::TRANSIENT, {4, 4, 2, 1});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {4, 4, 2, 1});
+  auto conv0 = src_graph->CreateOperation<tim::vx::ops::Conv2d>(
+      2, tim::vx::PadType::VALID, Ksize({1, 1}), Ksize({1, 1}), Ksize({1, 1}));
+  (*conv0).BindInputs({input, weights}).BindOutputs({conv0_out});
+  auto relu = src_graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInputs({conv0_out}).BindOutputs({relu_out});
+  auto conv1 = src_graph->CreateOperation<tim::vx::ops::Conv2d>(
+      2, tim::vx::PadType::VALID, Ksize({1, 1}), Ksize({1, 1}), Ksize({1, 1}));
+  (*conv1).BindInputs({relu_out, weights}).BindOutputs({conv1_out});
+  auto relu6 = src_graph->CreateOperation<tim::vx::ops::Relu6>();
+  (*relu6).BindInputs({conv1_out}).BindOutputs({output});
+
+  tim::transform::OperatorFusionReport report;
+  auto fused = tim::transform::OperatorFusion(src_graph, ctx, &report);
+  EXPECT_EQ(report.op_count_before, 4u);
+  EXPECT_EQ(report.op_count_after, 4u);
+  EXPECT_EQ(fused.second.size(), 6u);
+}
+
+// Relu6 on a uint8 output with range [0, 6] is clamped by the quantization
+TEST(OperatorFusion, conv2d_relu6_saturating_quantization) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  tim::vx::Quantization input_quant(tim::vx::QuantType::ASYMMETRIC, 0.5f, 128);
+  tim::vx::Quantization weights_quant(tim::vx::QuantType::ASYMMETRIC, 0.5f,
+                                      128);
+  tim::vx::Quantization output_quant(tim::vx::QuantType::ASYMMETRIC,
+                                     6.0f / 255, 0);
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8, {4, 4, 2, 1},
+                                 tim::vx::TensorAttribute::INPUT, input_quant);
+  tim::vx::TensorSpec weights_spec(tim::vx::DataType::UINT8, {1, 1, 2, 2},
+                                   tim::vx::TensorAttribute::CONSTANT,
+                                   weights_quant);
+  tim::vx::TensorSpec conv_spec(tim::vx::DataType::UINT8, {4, 4, 2, 1},
+                                tim::vx::TensorAttribute::TRANSIENT,
+                                output_quant);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8, {4, 4, 2, 1},
+                                  tim::vx::TensorAttribute::OUTPUT,
+                                  output_quant);
+  std::vector<uint8_t> weights_data = {130, 126, 129, 132};
+  auto input = src_graph->CreateTensor(input_spec);
+  auto weights = src_graph->CreateTensor(weights_spec, weights_data.data());
+  auto conv_out = src_graph->CreateTensor(conv_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+  auto conv = src_graph->CreateOperation<tim::vx::ops::Conv2d>(
+      2, tim::vx::PadType::VALID, Ksize({1, 1}), Ksize({1, 1}), Ksize({1, 1}));
+  (*conv).BindInputs({input, weights}).BindOutputs({conv_out});
+  auto relu6 = src_graph->CreateOperation<tim::vx::ops::Relu6>();
+  (*relu6).BindInputs({conv_out}).BindOutputs({output});
+
+  tim::transform::OperatorFusionReport report;
+  auto fused = tim::transform::OperatorFusion(src_graph, ctx, &report);
+  EXPECT_EQ(report.op_count_after, 1u);
+  EXPECT_EQ(report.conv2d_relu, 1u);
+}
+
+// Three conv-relu-conv-relu-pool stages and a fc-relu head, reports node
+// count and latency before and after the fusion
+TEST(OperatorFusion, benchmark_small_convnet) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  const uint32_t channels = 8;
+  std::vector<float> conv_weights = Ramp(3 * 3 * channels * channels, 0.05f);
+  std::vector<float> conv_bias(channels, 0.1f);
+  std::vector<float> fc_weights = Ramp(4 * 4 * channels * 16, 0.01f);
+  std::vector<float> fc_bias(16, 0.0f);
+
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {32, 32, channels, 1});
+  auto weights =
+      CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                        {3, 3, channels, channels}, conv_weights.data());
+  auto bias = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                                {channels}, conv_bias.data());
+  auto x = input;
+  auto conv_relu = [&](uint32_t size) {
+    auto conv_out = CreateFloatTensor(
+        src_graph, tim::vx::TensorAttribute::TRANSIENT,
+        {size, size, channels, 1});
+    auto relu_out = CreateFloatTensor(
+        src_graph, tim::vx::TensorAttribute::TRANSIENT,
+        {size, size, channels, 1});
+    auto conv = src_graph->CreateOperation<tim::vx::ops::Conv2d>(
+        channels, tim::vx::PadType::AUTO, Ksize({3, 3}), Ksize({1, 1}),
+        Ksize({1, 1}), std::array<uint32_t, 4>({1, 1, 1, 1}));
+    (*conv).BindInputs({x, weights, bias}).BindOutputs({conv_out});
+    auto relu = src_graph->CreateOperation<tim::vx::ops::Relu>();
+    (*relu).BindInputs({conv_out}).BindOutputs({relu_out});
+    x = relu_out;
+  };
+  for (uint32_t size = 32; size > 4; size /= 2) {
+    conv_relu(size);
+    conv_relu(size);
+    auto pool_out = CreateFloatTensor(
+        src_graph, tim::vx::TensorAttribute::TRANSIENT,
+        {size / 2, size / 2, channels, 1});
+    auto pool = src_graph->CreateOperation<tim::vx::ops::Pool2d>(
+        tim::vx::PoolType::MAX, tim::vx::PadType::VALID, Ksize({2, 2}),
+        Ksize({2, 2}));
+    (*pool).BindInputs({x}).BindOutputs({pool_out});
+    x = pool_out;
+  }
+  auto fc_w = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                                {4 * 4 * channels, 16}, fc_weights.data());
+  auto fc_b = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                                {16}, fc_bias.data());
+  auto fc_out = CreateFloatTensor(src_graph,
+                                  tim::vx::TensorAttribute::TRANSIENT, {16, 1});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {16, 1});
+  auto fc = src_graph->CreateOperation<tim::vx::ops::FullyConnected>(2, 16);
+  (*fc).BindInputs({x, fc_w, fc_b}).BindOutputs({fc_out});
+  auto relu = src_graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInputs({fc_out}).BindOutputs({output});
+
+  tim::transform::OperatorFusionReport report;
+  auto fused = tim::transform::OperatorFusion(src_graph, ctx, &report);
+  EXPECT_EQ(report.op_count_before, 17u);
+  EXPECT_EQ(report.op_count_after, 7u);
+  EXPECT_EQ(report.conv2d_relu, 3u);
+  EXPECT_EQ(report.conv2d_relu_pool2d, 3u);
+  EXPECT_EQ(report.fully_connected_relu, 1u);
+
+  auto input_data = Ramp(32 * 32 * channels, 0.1f);
+  auto latency = [&input_data](const std::shared_ptr<tim::vx::Graph>& graph,
+                               const std::shared_ptr<tim::vx::Tensor>& in,
+                               const std::shared_ptr<tim::vx::Tensor>& out,
+                               std::vector<float>& result) {
+    const int runs = 10;
+    result = RunGraph(graph, in, input_data, out, 16);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) {
+      graph->Run();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+               .count() / runs;
+  };
+  std::vector<float> expect, out;
+  auto before_us = latency(src_graph, input, output, expect);
+  auto after_us = latency(fused.first, fused.second[input],
+                          fused.second[output], out);
+  std::cout << "ops " << report.op_count_before << " -> "
+            << report.op_count_after << ", latency " << before_us << " us -> "
+            << after_us << " us" << std::endl;
+  ASSERT_EQ(out.size(), 16u);
+  EXPECT_TRUE(ArraysMatch(expect, out, 1e-3f));
+}
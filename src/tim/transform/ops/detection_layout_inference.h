@@ -0,0 +1,159 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_LAYOUT_INFER_DETECTION_LAYOUT_INFERENCE_H_
+#define TIM_LAYOUT_INFER_DETECTION_LAYOUT_INFERENCE_H_
+
+#include "tim/vx/ops/generate_proposals.h"
+#include "tim/vx/ops/roi_align.h"
+
+#include "ops/op_layout_inference.h"
+#include "permute_vector.h"
+#include "operation_private.h"
+
+namespace tim {
+namespace transform {
+// Boxes, scores and indices carry no layout and are fed in their source
+// layout. Only the feature maps of RoiAlign and GenerateProposals follow the
+// layout of the op, they are brought to WHCN.
+class DetectionLayoutInfer : public OpLayoutInfer {
+ public:
+  DetectionLayoutInfer(
+      const std::shared_ptr<vx::Operation> op,
+      std::shared_ptr<layout_inference_impl::LayoutInferContext>& context)
+      : OpLayoutInfer(op, context) {}
+
+  void OnInputs(
+      std::vector<std::shared_ptr<vx::Tensor>>& next_tensors) override {
+    AlignInputs(0, nullptr);
+    auto cloned_op = op_->Clone(context_->infer_graph_);
+    BindInputsAndOutputs(cloned_op, nullptr, next_tensors);
+  }
+
+ protected:
+  // Permute the first feature_cnt inputs to feature_pv and the others back
+  // to their source layout
+  void AlignInputs(uint32_t feature_cnt,
+                   std::shared_ptr<IPermuteVector> feature_pv) {
+    uint32_t idx = 0;
+    for (const auto& i_src : op_->impl()->InputsTensor()) {
+      auto required_pv = idx++ < feature_cnt
+                             ? feature_pv
+                             : MakeShared(i_src->GetShape().size());
+      std::shared_ptr<vx::Tensor> perm_out;
+      if (i_src->IsConstTensor()) {
+        perm_out = required_pv->IsAligned()
+                       ? context_->infer_graph_->CreateTensor(
+                             i_src->GetSpec(), i_src->GetDataRef())
+                       : PermuteConstTensor(i_src, required_pv);
+      } else {
+        auto final_pv =
+            context_->GetPermuteVector(i_src)->Reverse()->Add(required_pv);
+        perm_out = final_pv->IsAligned()
+                       ? context_->GetMapedTensor(i_src)
+                       : InsertPermute(context_->GetMapedTensor(i_src),
+                                       final_pv);
+      }
+      context_->UpdateTensorMap(i_src, perm_out);
+      context_->SetPermuteVector(i_src, required_pv);
+    }
+  }
+
+  // The first output takes feature_pv when given, the others are left in
+  // their source layout
+  void BindInputsAndOutputs(
+      const std::shared_ptr<vx::Operation>& infer_op,
+      std::shared_ptr<IPermuteVector> feature_pv,
+      std::vector<std::shared_ptr<vx::Tensor>>& next_tensors) {
+    for (const auto& i_src : op_->impl()->InputsTensor()) {
+      (*infer_op).BindInput(context_->GetMapedTensor(i_src));
+    }
+    std::vector<std::shared_ptr<IPermuteVector>> required_pv_lst;
+    for (const auto& out_tensor : op_->impl()->OutputsTensor()) {
+      required_pv_lst.push_back(
+          required_pv_lst.empty() && feature_pv
+              ? feature_pv
+              : MakeShared(out_tensor->GetShape().size()));
+    }
+    auto out_infer = CreateOutputsTensor(required_pv_lst);
+    (*infer_op).BindOutputs(out_infer);
+    uint32_t i = 0;
+    for (const auto& out_tensor : op_->impl()->OutputsTensor()) {
+      context_->SetPermuteVector(out_tensor, required_pv_lst[i++]);
+      next_tensors.push_back(out_tensor);
+    }
+  }
+};
+
+class RoiAlignLayoutInfer : public DetectionLayoutInfer {
+ public:
+  RoiAlignLayoutInfer(
+      const std::shared_ptr<vx::Operation> op,
+      std::shared_ptr<layout_inference_impl::LayoutInferContext>& context)
+      : DetectionLayoutInfer(op, context) {}
+
+  void OnInputs(
+      std::vector<std::shared_ptr<vx::Tensor>>& next_tensors) override {
+    auto required_pv = MakeShared(4);
+    if (op_->impl()->layout_ == vx::DataLayout::CWHN) {
+      required_pv = std::make_shared<PermuteVector<4>>(kCWHN2WHCN);
+    }
+    AlignInputs(1, required_pv);
+
+    auto& param = op_->impl()->node()->nn_param.roi_align;
+    auto roi_align = context_->infer_graph_->CreateOperation<vx::ops::RoiAlign>(
+        param.output_height, param.output_width, param.height_ratio,
+        param.width_ratio, param.height_sample_num, param.width_sample_num);
+    BindInputsAndOutputs(roi_align, required_pv, next_tensors);
+  }
+};
+
+class GenerateProposalsLayoutInfer : public DetectionLayoutInfer {
+ public:
+  GenerateProposalsLayoutInfer(
+      const std::shared_ptr<vx::Operation> op,
+      std::shared_ptr<layout_inference_impl::LayoutInferContext>& context)
+      : DetectionLayoutInfer(op, context) {}
+
+  // Scores and deltas are feature maps, the proposals have no layout
+  void OnInputs(
+      std::vector<std::shared_ptr<vx::Tensor>>& next_tensors) override {
+    auto required_pv = MakeShared(4);
+    if (op_->impl()->layout_ == vx::DataLayout::CWHN) {
+      required_pv = std::make_shared<PermuteVector<4>>(kCWHN2WHCN);
+    }
+    AlignInputs(2, required_pv);
+
+    auto& param = op_->impl()->node()->nn_param.generate_proposals;
+    auto generate_proposals =
+        context_->infer_graph_->CreateOperation<vx::ops::GenerateProposals>(
+            param.height_stride, param.width_stride, param.pre_nms_top_n,
+            param.post_nms_top_n, param.iou_threshold, param.min_size);
+    BindInputsAndOutputs(generate_proposals, nullptr, next_tensors);
+  }
+};
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
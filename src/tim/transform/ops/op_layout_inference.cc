@@ -349,7 +349,8 @@ std::shared_ptr<vx::Tensor> OpLayoutInfer::PermuteConstTensor(
     dst_spec.quantization_.SetChannelDim(
         MapAxis(pv->AsStdVec(), dst_spec.quantization_.ChannelDim()));
   }
-  return context_->infer_graph_->CreateTensor(dst_spec, data.data());
+  return context_->infer_graph_->CreateTensor(
+      dst_spec, context_->HoldConstData(std::move(data)));
 }
 
 std::vector<uint32_t> OpLayoutInfer::MapMultipleAxis(
@@ -0,0 +1,107 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_LAYOUT_INFER_PRE_POST_PROCESS_LAYOUT_INFERENCE_H_
+#define TIM_LAYOUT_INFER_PRE_POST_PROCESS_LAYOUT_INFERENCE_H_
+
+#include "tim/vx/ops/post_process.h"
+#include "tim/vx/ops/pre_process.h"
+
+#include "ops/op_layout_inference.h"
+#include "permute_vector.h"
+#include "operation_private.h"
+
+namespace tim {
+namespace transform {
+class PreProcessLayoutInfer : public OpLayoutInfer {
+ public:
+  PreProcessLayoutInfer(
+      const std::shared_ptr<vx::Operation> op,
+      std::shared_ptr<layout_inference_impl::LayoutInferContext>& context)
+      : OpLayoutInfer(op, context) {}
+
+  // The frames are graph inputs in their own format, a CWHN image is
+  // produced as WHCN directly instead of being transposed back later
+  void OnInputs(
+      std::vector<std::shared_ptr<vx::Tensor>>& next_tensors) override {
+    auto src_pre_process = std::static_pointer_cast<vx::ops::PreProcess>(op_);
+    auto config = src_pre_process->Config();
+    auto output_shape = src_pre_process->OutputShape();
+    auto required_pv = MakeShared(4);
+    if (config.layout == vx::DataLayout::CWHN) {
+      required_pv = std::make_shared<PermuteVector<4>>(kCWHN2WHCN);
+      config.layout = vx::DataLayout::WHCN;
+      output_shape = {output_shape[1], output_shape[2], output_shape[0],
+                      output_shape[3]};
+    }
+
+    auto pre_process =
+        context_->infer_graph_->CreateOperation<vx::ops::PreProcess>(
+            config, output_shape);
+    for (const auto& i_src : op_->impl()->InputsTensor()) {
+      (*pre_process).BindInput(context_->GetMapedTensor(i_src));
+    }
+    auto out_infer = CreateOutputsTensor(required_pv);
+    (*pre_process).BindOutput(out_infer[0]);
+    context_->SetPermuteVector(op_->impl()->OutputsTensor()[0], required_pv);
+    next_tensors.push_back(op_->impl()->OutputsTensor()[0]);
+  }
+};
+
+class PostProcessLayoutInfer : public OpLayoutInfer {
+ public:
+  PostProcessLayoutInfer(
+      const std::shared_ptr<vx::Operation> op,
+      std::shared_ptr<layout_inference_impl::LayoutInferContext>& context)
+      : OpLayoutInfer(op, context) {}
+
+  // Fold the permute applied on the input into the transpose of the node
+  void OnInputs(
+      std::vector<std::shared_ptr<vx::Tensor>>& next_tensors) override {
+    assert(op_->impl()->InputsTensor().size() == 1);
+    auto src_post_process =
+        std::static_pointer_cast<vx::ops::PostProcess>(op_);
+    auto i_src = op_->impl()->InputsTensor()[0];
+    auto input_pv = context_->GetPermuteVector(i_src);
+    auto perm = MakeShared(input_pv->Rank());
+    for (uint32_t i = 0; i < perm->Rank(); i++) {
+      perm->At(i) = src_post_process->Perm()[i];
+    }
+    auto final_perm = input_pv->Reverse()->Add(perm);
+
+    auto post_process =
+        context_->infer_graph_->CreateOperation<vx::ops::PostProcess>(
+            final_perm->AsStdVec());
+    auto required_pv = MakeShared(input_pv->Rank());
+    auto out_infer = CreateOutputsTensor(required_pv);
+    (*post_process).BindInput(context_->GetMapedTensor(i_src));
+    (*post_process).BindOutput(out_infer[0]);
+    context_->SetPermuteVector(op_->impl()->OutputsTensor()[0], required_pv);
+    next_tensors.push_back(op_->impl()->OutputsTensor()[0]);
+  }
+};
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -0,0 +1,273 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/transform/static_batching.h"
+
+#include <unordered_set>
+#include <vector>
+
+#include "operation_private.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/concat.h"
+#include "tim/vx/ops/reshape.h"
+#include "tim/vx/ops/slice.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+
+using TensorMap =
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>;
+
+// Operations computing each sample on its own, whatever their parameters
+const std::unordered_set<uint32_t> kPerSampleOps = {
+    VSI_NN_OP_ADD,           VSI_NN_OP_SUBTRACT,
+    VSI_NN_OP_MULTIPLY,      VSI_NN_OP_DIVIDE,
+    VSI_NN_OP_MINIMUM,       VSI_NN_OP_MAXIMUM,
+    VSI_NN_OP_POW,           VSI_NN_OP_FLOORDIV,
+    VSI_NN_OP_RELU,          VSI_NN_OP_RELU1,
+    VSI_NN_OP_RELU6,         VSI_NN_OP_ELU,
+    VSI_NN_OP_SIGMOID,       VSI_NN_OP_MISH,
+    VSI_NN_OP_HARD_SIGMOID,  VSI_NN_OP_SOFTRELU,
+    VSI_NN_OP_SWISH,         VSI_NN_OP_TANH,
+    VSI_NN_OP_LEAKY_RELU,    VSI_NN_OP_LINEAR,
+    VSI_NN_OP_GELU,          VSI_NN_OP_CLIP,
+    VSI_NN_OP_DATACONVERT,   VSI_NN_OP_NEG,
+    VSI_NN_OP_ABS,           VSI_NN_OP_SIN,
+    VSI_NN_OP_EXP,           VSI_NN_OP_LOG,
+    VSI_NN_OP_SQRT,          VSI_NN_OP_RSQRT,
+    VSI_NN_OP_SQUARE,        VSI_NN_OP_LOGICAL_NOT,
+    VSI_NN_OP_FLOOR,         VSI_NN_OP_CAST,
+    VSI_NN_OP_CONV2D,        VSI_NN_OP_DECONVOLUTION,
+    VSI_NN_OP_GROUPED_CONV2D, VSI_NN_OP_POOL,
+    VSI_NN_OP_BATCH_NORM,    VSI_NN_OP_INSTANCE_NORM,
+    VSI_NN_OP_RESIZE,
+};
+
+// Batch dimension outermost and of size 1
+bool HasBatchDim(const std::shared_ptr<vx::Tensor>& tensor) {
+  auto shape = tensor->GetShape();
+  return !shape.empty() && shape.back() == 1;
+}
+
+// Weights and bias shared by all samples
+bool OnlyFirstInputBatched(
+    const std::vector<std::shared_ptr<vx::Tensor>>& inputs) {
+  for (size_t i = 1; i < inputs.size(); ++i) {
+    if (!inputs[i]->IsPlaceHolder() && !inputs[i]->IsConstTensor()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether op can run once on the whole batch, unchanged but for Reshape
+bool IsBatchable(const std::shared_ptr<vx::Operation>& op) {
+  const auto& impl = op->impl();
+  auto inputs = impl->InputsTensor();
+  auto outputs = impl->OutputsTensor();
+  bool has_batched_input = false;
+  for (const auto& t : inputs) {
+    if (t->IsPlaceHolder() || t->IsConstTensor()) continue;
+    if (!HasBatchDim(t)) return false;
+    has_batched_input = true;
+  }
+  if (!has_batched_input) return false;
+  for (const auto& t : outputs) {
+    if (!HasBatchDim(t)) return false;
+  }
+
+  const vsi_nn_nn_param_t& param = impl->node()->nn_param;
+  const uint32_t batch_axis = inputs[0]->GetShape().size() - 1;
+  switch (impl->operation_id_) {
+    case VSI_NN_OP_CONV2D:
+    case VSI_NN_OP_DECONVOLUTION:
+    case VSI_NN_OP_GROUPED_CONV2D:
+      return OnlyFirstInputBatched(inputs);
+    case VSI_NN_OP_FCL2:
+      return OnlyFirstInputBatched(inputs) &&
+             static_cast<uint32_t>(param.fcl.axis) < batch_axis;
+    case VSI_NN_OP_SOFTMAX:
+      return static_cast<uint32_t>(param.softmax.axis) != batch_axis;
+    case VSI_NN_OP_CONCAT:
+      for (const auto& t : inputs) {
+        if (t->IsConstTensor()) return false;
+      }
+      return param.concat.axis != batch_axis;
+    case VSI_NN_OP_PERMUTE:
+      return param.permute.dim_num == batch_axis + 1 &&
+             param.permute.perm[batch_axis] == batch_axis;
+    case VSI_NN_OP_RESHAPE:
+      return true;
+    default:
+      // Batched operands must keep the same rank to broadcast per sample
+      for (const auto& t : inputs) {
+        if (!t->IsPlaceHolder() && !t->IsConstTensor() &&
+            t->GetShape().size() != outputs[0]->GetShape().size()) {
+          return false;
+        }
+      }
+      return kPerSampleOps.count(impl->operation_id_) > 0;
+  }
+}
+
+// A tensor left to ovxlib's shape inference has no batch dimension to scale
+bool HasUnknownShape(const std::shared_ptr<vx::Graph>& graph) {
+  for (const auto& op : graph->OpVector()) {
+    for (const auto& tensors :
+         {op->impl()->InputsTensor(), op->impl()->OutputsTensor()}) {
+      for (const auto& t : tensors) {
+        if (!t->IsPlaceHolder() && !t->IsConstTensor() &&
+            t->GetShape().empty()) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+vx::TensorSpec BatchedSpec(const vx::TensorSpec& spec, uint32_t batch_size) {
+  vx::TensorSpec batched(spec);
+  batched.shape_.back() *= batch_size;
+  return batched;
+}
+
+// Sample `index` of a batched tensor, shaped like the source tensor
+std::shared_ptr<vx::Tensor> SliceSample(
+    const std::shared_ptr<vx::Graph>& graph,
+    const std::shared_ptr<vx::Tensor>& src,
+    const std::shared_ptr<vx::Tensor>& batched, uint32_t index) {
+  auto spec = src->GetSpec().AsTransientSpec();
+  spec.shape_ = src->GetShape();
+  std::vector<int32_t> start(spec.shape_.size(), 0);
+  std::vector<int32_t> length(spec.shape_.begin(), spec.shape_.end());
+  start.back() = index * spec.shape_.back();
+  auto sample = graph->CreateTensor(spec);
+  auto slice = graph->CreateOperation<vx::ops::Slice>(
+      static_cast<uint32_t>(spec.shape_.size()), start, length);
+  (*slice).BindInput(batched).BindOutput(sample);
+  return sample;
+}
+
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>, TensorMap> StaticBatching(
+    const std::shared_ptr<vx::Graph>& src_graph,
+    std::shared_ptr<vx::Context>& ctx, uint32_t batch_size,
+    StaticBatchingReport* report) {
+  StaticBatchingReport stats;
+  auto graph = ctx->CreateGraph();
+  TensorMap tensor_map;
+  if (batch_size == 0) {
+    VSILOGE("Batch size must be positive");
+    return std::make_pair(graph, tensor_map);
+  }
+  if (HasUnknownShape(src_graph)) {
+    VSILOGE("Static batching needs the shape of every non constant tensor");
+    return std::make_pair(graph, tensor_map);
+  }
+
+  auto tensor_of = [&graph, &tensor_map, batch_size](
+                       const std::shared_ptr<vx::Tensor>& t) {
+    auto it = tensor_map.find(t);
+    if (it != tensor_map.end()) {
+      return it->second;
+    }
+    std::shared_ptr<vx::Tensor> dst;
+    if (t->IsPlaceHolder()) {
+      dst = graph->CreateTensorPlaceHolder();
+    } else if (t->IsConstTensor()) {
+      dst = graph->CreateTensor(t->GetSpec(), t->GetDataRef());
+    } else {
+      dst = graph->CreateTensor(BatchedSpec(t->GetSpec(), batch_size));
+    }
+    tensor_map[t] = dst;
+    return dst;
+  };
+  // Keep the io order of the source graph
+  for (const auto& t : src_graph->InputsTensor()) tensor_of(t);
+  for (const auto& t : src_graph->OutputsTensor()) tensor_of(t);
+
+  for (const auto& op : src_graph->OpVector()) {
+    auto inputs = op->impl()->InputsTensor();
+    auto outputs = op->impl()->OutputsTensor();
+    if (batch_size == 1 || IsBatchable(op)) {
+      std::shared_ptr<vx::Operation> batched;
+      if (op->impl()->operation_id_ == VSI_NN_OP_RESHAPE && batch_size > 1) {
+        auto size = outputs[0]->GetShape();
+        size.back() = batch_size;
+        batched = graph->CreateOperation<vx::ops::Reshape>(size);
+      } else {
+        batched = op->Clone(graph);
+      }
+      for (const auto& t : inputs) {
+        batched->BindInput(tensor_of(t));
+      }
+      for (const auto& t : outputs) {
+        batched->BindOutput(tensor_of(t));
+      }
+      stats.batched_op_count++;
+      continue;
+    }
+
+    // Run each sample through its own clone, then stack the outputs
+    std::vector<std::vector<std::shared_ptr<vx::Tensor>>> samples(
+        outputs.size());
+    for (uint32_t i = 0; i < batch_size; ++i) {
+      auto cloned = op->Clone(graph);
+      for (const auto& t : inputs) {
+        if (t->IsPlaceHolder() || t->IsConstTensor()) {
+          cloned->BindInput(tensor_of(t));
+        } else {
+          cloned->BindInput(SliceSample(graph, t, tensor_of(t), i));
+        }
+      }
+      for (size_t j = 0; j < outputs.size(); ++j) {
+        auto spec = outputs[j]->GetSpec().AsTransientSpec();
+        spec.shape_ = outputs[j]->GetShape();
+        auto sample = graph->CreateTensor(spec);
+        cloned->BindOutput(sample);
+        samples[j].push_back(sample);
+      }
+    }
+    for (size_t j = 0; j < outputs.size(); ++j) {
+      auto concat = graph->CreateOperation<vx::ops::Concat>(
+          static_cast<uint32_t>(outputs[j]->GetShape().size() - 1),
+          static_cast<int>(batch_size));
+      (*concat).BindInputs(samples[j]).BindOutput(tensor_of(outputs[j]));
+    }
+    stats.unrolled_op_count++;
+  }
+
+  if (report) {
+    *report = stats;
+  }
+  return std::make_pair(graph, tensor_map);
+}
+
+}  // namespace transform
+}  // namespace tim
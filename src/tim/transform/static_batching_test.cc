@@ -0,0 +1,179 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/ops/fullyconnected.h"
+#include "tim/vx/ops/reshape.h"
+#include "tim/vx/ops/softmax.h"
+#include "tim/transform/static_batching.h"
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+namespace {
+std::shared_ptr<tim::vx::Tensor> CreateFloatTensor(
+    const std::shared_ptr<tim::vx::Graph>& graph,
+    tim::vx::TensorAttribute attr, const tim::vx::ShapeType& shape,
+    const void* data = nullptr) {
+  tim::vx::TensorSpec spec(tim::vx::DataType::FLOAT32, shape, attr);
+  return graph->CreateTensor(spec, data);
+}
+
+std::vector<float> RunGraph(const std::shared_ptr<tim::vx::Graph>& graph,
+                            const std::shared_ptr<tim::vx::Tensor>& input,
+                            const std::shared_ptr<tim::vx::Tensor>& output,
+                            const std::vector<float>& in_data,
+                            size_t out_size) {
+  std::vector<float> out(out_size);
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_TRUE(
+      input->CopyDataToTensor(in_data.data(), in_data.size() * sizeof(float)));
+  EXPECT_TRUE(graph->Run());
+  EXPECT_TRUE(output->CopyDataFromTensor(out.data()));
+  return out;
+}
+}  // namespace
+
+// Conv2d -> Relu -> Reshape -> FullyConnected -> Softmax batches as a whole
+TEST(StaticBatching, conv_relu_reshape_fc_softmax) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  std::vector<float> weights_data = {1.0f, -1.0f, 0.5f, 0.25f,
+                                     -0.5f, 2.0f, 1.0f, 0.0f};
+  std::vector<float> fc_data = {0.1f, 0.2f, -0.3f, 0.4f, 0.5f, -0.6f,
+                                0.7f, 0.8f, 0.9f, -1.0f, 1.1f, 1.2f,
+                                -0.1f, 0.3f, 0.2f, 0.1f};
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {3, 3, 1, 1});
+  auto weights = CreateFloatTensor(src_graph,
+                                   tim::vx::TensorAttribute::CONSTANT,
+                                   {2, 2, 1, 2}, weights_data.data());
+  auto conv_out = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::TRANSIENT, {2, 2, 2, 1});
+  auto relu_out = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::TRANSIENT, {2, 2, 2, 1});
+  auto flat = CreateFloatTensor(src_graph,
+                                tim::vx::TensorAttribute::TRANSIENT, {8, 1});
+  auto fc_weights = CreateFloatTensor(
+      src_graph, tim::vx::TensorAttribute::CONSTANT, {8, 2}, fc_data.data());
+  auto fc_out = CreateFloatTensor(src_graph,
+                                  tim::vx::TensorAttribute::TRANSIENT, {2, 1});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {2, 1});
+  auto conv = src_graph->CreateOperation<tim::vx::ops::Conv2d>(
+      2, tim::vx::PadType::VALID, std::array<uint32_t, 2>({2, 2}),
+      std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+  (*conv).BindInputs({input, weights}).BindOutputs({conv_out});
+  auto relu = src_graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInputs({conv_out}).BindOutputs({relu_out});
+  auto reshape = src_graph->CreateOperation<tim::vx::ops::Reshape>(
+      std::vector<uint32_t>({8, 1}));
+  (*reshape).BindInputs({relu_out}).BindOutputs({flat});
+  auto fc = src_graph->CreateOperation<tim::vx::ops::FullyConnected>(0, 2);
+  (*fc).BindInputs({flat, fc_weights}).BindOutputs({fc_out});
+  auto softmax = src_graph->CreateOperation<tim::vx::ops::Softmax>(1.0f, 0);
+  (*softmax).BindInputs({fc_out}).BindOutputs({output});
+
+  const uint32_t batch = 4;
+  tim::transform::StaticBatchingReport report;
+  auto batched = tim::transform::StaticBatching(src_graph, ctx, batch, &report);
+  EXPECT_EQ(report.batched_op_count, 5u);
+  EXPECT_EQ(report.unrolled_op_count, 0u);
+  EXPECT_EQ(batched.first->OpVector().size(), 5u);
+  auto new_input = batched.second[input];
+  auto new_output = batched.second[output];
+  EXPECT_EQ(new_input->GetShape(), tim::vx::ShapeType({3, 3, 1, batch}));
+  EXPECT_EQ(new_output->GetShape(), tim::vx::ShapeType({2, batch}));
+  EXPECT_EQ(batched.second[flat]->GetShape(), tim::vx::ShapeType({8, batch}));
+  EXPECT_EQ(batched.second[weights]->GetShape(),
+            tim::vx::ShapeType({2, 2, 1, 2}));
+
+  std::vector<float> in_data(9 * batch);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>((i * 7) % 11) - 5.0f;
+  }
+  std::vector<float> expect;
+  for (uint32_t i = 0; i < batch; ++i) {
+    std::vector<float> sample(in_data.begin() + i * 9,
+                              in_data.begin() + (i + 1) * 9);
+    auto out = RunGraph(src_graph, input, output, sample, 2);
+    expect.insert(expect.end(), out.begin(), out.end());
+  }
+  auto out = RunGraph(batched.first, new_input, new_output, in_data, 2 * batch);
+  EXPECT_TRUE(ArraysMatch(expect, out, 1e-5f));
+}
+
+// Reshape folding the batch away and the op after it run once per sample
+TEST(StaticBatching, unroll_unbatchable_ops) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  std::vector<float> bias_data = {1.0f, 2.0f, 3.0f, 4.0f};
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {4, 1});
+  auto bias = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::CONSTANT,
+                                {4}, bias_data.data());
+  auto flat = CreateFloatTensor(src_graph,
+                                tim::vx::TensorAttribute::TRANSIENT, {4});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {4});
+  auto reshape = src_graph->CreateOperation<tim::vx::ops::Reshape>(
+      std::vector<uint32_t>({4}));
+  (*reshape).BindInputs({input}).BindOutputs({flat});
+  auto add = src_graph->CreateOperation<tim::vx::ops::Add>();
+  (*add).BindInputs({flat, bias}).BindOutputs({output});
+
+  const uint32_t batch = 3;
+  tim::transform::StaticBatchingReport report;
+  auto batched = tim::transform::StaticBatching(src_graph, ctx, batch, &report);
+  EXPECT_EQ(report.batched_op_count, 0u);
+  EXPECT_EQ(report.unrolled_op_count, 2u);
+  // Each op: a Slice and a clone per sample, one Concat
+  EXPECT_EQ(batched.first->OpVector().size(), 2u * (2 * batch + 1));
+  auto new_input = batched.second[input];
+  auto new_output = batched.second[output];
+  EXPECT_EQ(new_input->GetShape(), tim::vx::ShapeType({4, batch}));
+  EXPECT_EQ(new_output->GetShape(), tim::vx::ShapeType({4 * batch}));
+
+  std::vector<float> in_data = {0, 1, 2, 3, 10, 11, 12, 13, 20, 21, 22, 23};
+  std::vector<float> expect = {1, 3, 5, 7, 11, 13, 15, 17, 21, 23, 25, 27};
+  auto out = RunGraph(batched.first, new_input, new_output, in_data, 4 * batch);
+  EXPECT_TRUE(ArraysMatch(expect, out, 1e-5f));
+}
+
+TEST(StaticBatching, batch_size_one_is_a_clone) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {4});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {4});
+  auto relu = src_graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInputs({input}).BindOutputs({output});
+
+  tim::transform::StaticBatchingReport report;
+  auto batched = tim::transform::StaticBatching(src_graph, ctx, 1, &report);
+  EXPECT_EQ(report.batched_op_count, 1u);
+  EXPECT_EQ(report.unrolled_op_count, 0u);
+  EXPECT_EQ(batched.second[input]->GetShape(), tim::vx::ShapeType({4}));
+}
+
+TEST(StaticBatching, reject_inferred_shapes) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  auto input = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::INPUT,
+                                 {4, 1});
+  auto hidden = CreateFloatTensor(src_graph,
+                                  tim::vx::TensorAttribute::TRANSIENT, {});
+  auto output = CreateFloatTensor(src_graph, tim::vx::TensorAttribute::OUTPUT,
+                                  {4, 1});
+  auto relu = src_graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInputs({input}).BindOutputs({hidden});
+  auto tanh = src_graph->CreateOperation<tim::vx::ops::Tanh>();
+  (*tanh).BindInputs({hidden}).BindOutputs({output});
+
+  for (uint32_t batch : {1u, 2u}) {
+    auto batched = tim::transform::StaticBatching(src_graph, ctx, batch);
+    EXPECT_TRUE(batched.second.empty());
+  }
+}
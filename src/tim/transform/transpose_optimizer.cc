@@ -0,0 +1,746 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "transpose_optimizer.h"
+
+#include <algorithm>
+#include <set>
+#include <tuple>
+
+#include "operation_private.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+#include "tim/vx/ops/transpose.h"
+#include "type_utils.h"
+
+namespace tim {
+namespace transform {
+namespace layout_inference_impl {
+
+namespace {
+
+using Perm = std::vector<uint32_t>;
+using ShapeHints =
+    std::unordered_map<std::shared_ptr<vx::Tensor>, vx::ShapeType>;
+
+// ovxlib permute: output dim i is input dim perm[i]
+vx::ShapeType PermuteShape(const vx::ShapeType& shape, const Perm& perm) {
+  vx::ShapeType out(perm.size());
+  for (uint32_t i = 0; i < perm.size(); ++i) {
+    out[i] = shape[perm[i]];
+  }
+  return out;
+}
+
+// Transpose(a) followed by Transpose(b) equals Transpose(Compose(a, b))
+Perm Compose(const Perm& a, const Perm& b) {
+  Perm r(b.size());
+  for (uint32_t i = 0; i < b.size(); ++i) {
+    r[i] = a[b[i]];
+  }
+  return r;
+}
+
+Perm Inverse(const Perm& perm) {
+  Perm r(perm.size());
+  for (uint32_t i = 0; i < perm.size(); ++i) {
+    r[perm[i]] = i;
+  }
+  return r;
+}
+
+bool IsIdentity(const Perm& perm) {
+  for (uint32_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] != i) return false;
+  }
+  return true;
+}
+
+uint32_t ElementBytes(vx::DataType dtype) {
+  return vsi_nn_GetTypeBytes(vx::TranslateDataType(dtype));
+}
+
+void TransposeData(const uint8_t* in, const vx::ShapeType& in_shape,
+                   const Perm& perm, uint32_t element_bytes, uint8_t* out) {
+  const uint32_t rank = in_shape.size();
+  std::vector<size_t> in_strides(rank, 1);
+  for (uint32_t i = 1; i < rank; ++i) {
+    in_strides[i] = in_strides[i - 1] * in_shape[i - 1];
+  }
+  auto out_shape = PermuteShape(in_shape, perm);
+  std::vector<uint32_t> coord(rank, 0);
+  size_t total = 1;
+  for (auto s : in_shape) total *= s;
+  for (size_t n = 0; n < total; ++n) {
+    size_t offset = 0;
+    for (uint32_t i = 0; i < rank; ++i) {
+      offset += coord[i] * in_strides[perm[i]];
+    }
+    std::copy(in + offset * element_bytes, in + (offset + 1) * element_bytes,
+              out + n * element_bytes);
+    for (uint32_t i = 0; i < rank && ++coord[i] == out_shape[i]; ++i) {
+      coord[i] = 0;
+    }
+  }
+}
+
+enum class ElementWise { NONE, UNARY, BINARY };
+
+// Operations which compute every output element from the input elements at
+// the same coordinate, so they run the same in any layout
+ElementWise ElementWiseKind(uint32_t op_id) {
+  switch (op_id) {
+    case VSI_NN_OP_RELU:
+    case VSI_NN_OP_RELU1:
+    case VSI_NN_OP_RELU6:
+    case VSI_NN_OP_ELU:
+    case VSI_NN_OP_SIGMOID:
+    case VSI_NN_OP_MISH:
+    case VSI_NN_OP_HARD_SIGMOID:
+    case VSI_NN_OP_SOFTRELU:
+    case VSI_NN_OP_SWISH:
+    case VSI_NN_OP_TANH:
+    case VSI_NN_OP_LEAKY_RELU:
+    case VSI_NN_OP_CLIP:
+    case VSI_NN_OP_DATACONVERT:
+    case VSI_NN_OP_NEG:
+    case VSI_NN_OP_ABS:
+    case VSI_NN_OP_SIN:
+    case VSI_NN_OP_EXP:
+    case VSI_NN_OP_LOG:
+    case VSI_NN_OP_SQRT:
+    case VSI_NN_OP_RSQRT:
+    case VSI_NN_OP_SQUARE:
+    case VSI_NN_OP_LOGICAL_NOT:
+      return ElementWise::UNARY;
+    case VSI_NN_OP_ADD:
+    case VSI_NN_OP_SUBTRACT:
+    case VSI_NN_OP_MULTIPLY:
+    case VSI_NN_OP_DIVIDE:
+    case VSI_NN_OP_POW:
+    case VSI_NN_OP_MINIMUM:
+    case VSI_NN_OP_MAXIMUM:
+      return ElementWise::BINARY;
+    default:
+      return ElementWise::NONE;
+  }
+}
+
+struct Cost {
+  uint64_t bytes{0};
+  uint32_t count{0};
+
+  bool operator<(const Cost& other) const {
+    return std::tie(bytes, count) < std::tie(other.bytes, other.count);
+  }
+  bool operator==(const Cost& other) const {
+    return bytes == other.bytes && count == other.count;
+  }
+};
+
+struct Value {
+  // tensor of the input graph, null for values created by the optimizer
+  std::shared_ptr<vx::Tensor> tensor;
+  vx::TensorSpec spec;
+  // empty if unknown
+  vx::ShapeType shape;
+  int32_t rank{-1};
+  // data of constants created by the optimizer
+  std::shared_ptr<const std::vector<uint8_t>> data;
+  int32_t producer{-1};
+  // a consumer is listed once for every input it binds the value to
+  std::vector<int32_t> consumers;
+
+  bool IsConst() const {
+    return tensor ? tensor->IsConstTensor() : data != nullptr;
+  }
+  bool IsGraphInput() const { return spec.attr_ & vx::TensorAttribute::INPUT; }
+  bool IsGraphOutput() const {
+    return spec.attr_ & vx::TensorAttribute::OUTPUT;
+  }
+  const void* Data() const { return tensor ? tensor->GetDataRef() : data->data(); }
+};
+
+struct Node {
+  // operation of the input graph, null for transposes
+  std::shared_ptr<vx::Operation> op;
+  Perm perm;
+  std::vector<int32_t> inputs;
+  std::vector<int32_t> outputs;
+  bool removed{false};
+
+  bool IsTranspose() const { return !op; }
+};
+
+// Dataflow graph of values and nodes where transposes are plain nodes which
+// can be rewired, copied cheaply to evaluate a rewrite before taking it.
+class TransposeGraph {
+ public:
+  TransposeGraph(const std::shared_ptr<vx::Graph>& graph,
+                 const ShapeHints& shape_hints);
+
+  Cost GetCost() const;
+  bool Changed() const { return changed_; }
+
+  // Rewrite until no transpose can be merged, dropped or deduplicated
+  void Canonicalize();
+
+  // Single elementwise nodes, or connected regions of them if `global`
+  std::vector<std::vector<int32_t>> ElementWiseRegions(bool global) const;
+
+  // Layouts worth trying for a region: the ones which cancel a transpose on
+  // its boundary
+  std::vector<Perm> FlipCandidates(const std::vector<int32_t>& region) const;
+
+  // True if the node has non constant inputs and all of them come from
+  // Transpose(perm)
+  bool InputsTransposedBy(int32_t node, const Perm& perm) const;
+
+  // Run the region in the layout Transpose(Inverse(perm)) of the current one,
+  // boundary transposes are inserted and left to Canonicalize()
+  bool Flip(const std::vector<int32_t>& region, const Perm& perm);
+
+  std::shared_ptr<vx::Graph> Emit(const std::shared_ptr<vx::Graph>& graph,
+                                  std::shared_ptr<vx::Context>& ctx,
+                                  TensorMap& tensor_map) const;
+
+ private:
+  int32_t AddValue(Value value);
+  int32_t AddTranspose(int32_t input, const Perm& perm, int32_t output = -1);
+  void SetInput(int32_t node, uint32_t index, int32_t value);
+  void ReplaceUses(int32_t from, int32_t to);
+  void RemoveNode(int32_t node);
+  bool IsElementWise(int32_t node) const;
+  void InferShapes();
+
+  std::vector<Value> values_;
+  std::vector<Node> nodes_;
+  std::unordered_map<std::shared_ptr<vx::Tensor>, int32_t> tensor_values_;
+  bool changed_{false};
+};
+
+TransposeGraph::TransposeGraph(const std::shared_ptr<vx::Graph>& graph,
+                               const ShapeHints& shape_hints) {
+  auto value_of = [this, &shape_hints](const std::shared_ptr<vx::Tensor>& t) {
+    auto it = tensor_values_.find(t);
+    if (it != tensor_values_.end()) {
+      return it->second;
+    }
+    Value value;
+    value.tensor = t;
+    value.spec = t->GetSpec();
+    auto hint = shape_hints.find(t);
+    if (hint != shape_hints.end()) {
+      value.shape = hint->second;
+    } else if (!t->IsPlaceHolder() &&
+               !(value.spec.attr_ & vx::TensorAttribute::TRANSIENT)) {
+      value.shape = value.spec.shape_;
+    }
+    if (!value.shape.empty()) {
+      value.rank = value.shape.size();
+    }
+    int32_t id = AddValue(value);
+    tensor_values_[t] = id;
+    return id;
+  };
+
+  for (const auto& t : graph->InputsTensor()) value_of(t);
+  for (const auto& t : graph->OutputsTensor()) value_of(t);
+  for (const auto& op : graph->OpVector()) {
+    Node node;
+    if (op->impl()->operation_id_ == VSI_NN_OP_PERMUTE) {
+      const auto& param = op->impl()->node()->nn_param.permute;
+      node.perm.assign(param.perm, param.perm + param.dim_num);
+    } else {
+      node.op = op;
+    }
+    int32_t id = nodes_.size();
+    for (const auto& t : op->impl()->InputsTensor()) {
+      int32_t v = value_of(t);
+      node.inputs.push_back(v);
+      values_[v].consumers.push_back(id);
+    }
+    for (const auto& t : op->impl()->OutputsTensor()) {
+      int32_t v = value_of(t);
+      node.outputs.push_back(v);
+      values_[v].producer = id;
+    }
+    nodes_.push_back(node);
+  }
+  InferShapes();
+}
+
+int32_t TransposeGraph::AddValue(Value value) {
+  values_.push_back(std::move(value));
+  return values_.size() - 1;
+}
+
+int32_t TransposeGraph::AddTranspose(int32_t input, const Perm& perm,
+                                     int32_t output) {
+  if (output < 0) {
+    const auto& in = values_[input];
+    Value value;
+    value.spec = in.spec.AsTransientSpec();
+    if (!in.shape.empty()) {
+      value.shape = PermuteShape(in.shape, perm);
+    }
+    value.rank = perm.size();
+    output = AddValue(value);
+  }
+  Node node;
+  node.perm = perm;
+  node.inputs.push_back(input);
+  node.outputs.push_back(output);
+  int32_t id = nodes_.size();
+  nodes_.push_back(node);
+  values_[input].consumers.push_back(id);
+  values_[output].producer = id;
+  changed_ = true;
+  return id;
+}
+
+void TransposeGraph::SetInput(int32_t node, uint32_t index, int32_t value) {
+  int32_t old = nodes_[node].inputs[index];
+  auto& consumers = values_[old].consumers;
+  consumers.erase(std::find(consumers.begin(), consumers.end(), node));
+  nodes_[node].inputs[index] = value;
+  values_[value].consumers.push_back(node);
+  changed_ = true;
+}
+
+void TransposeGraph::ReplaceUses(int32_t from, int32_t to) {
+  auto consumers = values_[from].consumers;
+  for (int32_t node : consumers) {
+    auto& inputs = nodes_[node].inputs;
+    for (uint32_t i = 0; i < inputs.size(); ++i) {
+      if (inputs[i] == from) SetInput(node, i, to);
+    }
+  }
+}
+
+void TransposeGraph::RemoveNode(int32_t node) {
+  auto& n = nodes_[node];
+  for (int32_t v : n.inputs) {
+    auto& consumers = values_[v].consumers;
+    consumers.erase(std::find(consumers.begin(), consumers.end(), node));
+  }
+  for (int32_t v : n.outputs) {
+    values_[v].producer = -1;
+  }
+  n.inputs.clear();
+  n.outputs.clear();
+  n.removed = true;
+  changed_ = true;
+}
+
+bool TransposeGraph::IsElementWise(int32_t node) const {
+  const auto& n = nodes_[node];
+  if (n.removed || n.IsTranspose() || n.outputs.size() != 1) {
+    return false;
+  }
+  switch (ElementWiseKind(n.op->impl()->operation_id_)) {
+    case ElementWise::UNARY:
+      return n.inputs.size() == 1;
+    case ElementWise::BINARY:
+      return n.inputs.size() == 2;
+    default:
+      return false;
+  }
+}
+
+void TransposeGraph::InferShapes() {
+  bool updated = true;
+  while (updated) {
+    updated = false;
+    auto update = [&updated](Value& v, const vx::ShapeType& shape) {
+      if (v.shape.empty() && !shape.empty()) {
+        v.shape = shape;
+        v.rank = shape.size();
+        updated = true;
+      }
+    };
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+      const auto& n = nodes_[i];
+      if (n.IsTranspose()) {
+        auto& in = values_[n.inputs[0]];
+        auto& out = values_[n.outputs[0]];
+        in.rank = out.rank = n.perm.size();
+        if (!in.shape.empty()) update(out, PermuteShape(in.shape, n.perm));
+        if (!out.shape.empty()) {
+          update(in, PermuteShape(out.shape, Inverse(n.perm)));
+        }
+      } else if (IsElementWise(i) && n.inputs.size() == 1) {
+        auto& in = values_[n.inputs[0]];
+        auto& out = values_[n.outputs[0]];
+        update(out, in.shape);
+        update(in, out.shape);
+      } else if (IsElementWise(i)) {
+        const auto& a = values_[n.inputs[0]].shape;
+        const auto& b = values_[n.inputs[1]].shape;
+        if (!a.empty() && a.size() == b.size()) {
+          vx::ShapeType shape(a.size());
+          for (uint32_t d = 0; d < a.size(); ++d) {
+            shape[d] = std::max(a[d], b[d]);
+          }
+          update(values_[n.outputs[0]], shape);
+        }
+      }
+    }
+  }
+}
+
+Cost TransposeGraph::GetCost() const {
+  Cost cost;
+  for (const auto& n : nodes_) {
+    if (n.removed || !n.IsTranspose()) continue;
+    const auto& in = values_[n.inputs[0]];
+    uint64_t elements = in.shape.empty() ? 0 : 1;
+    for (auto s : in.shape) elements *= s;
+    cost.bytes += elements * ElementBytes(in.spec.datatype_);
+    cost.count++;
+  }
+  return cost;
+}
+
+void TransposeGraph::Canonicalize() {
+  bool updated = true;
+  while (updated) {
+    updated = false;
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+      if (nodes_[i].removed || !nodes_[i].IsTranspose()) continue;
+      int32_t in = nodes_[i].inputs[0];
+      int32_t out = nodes_[i].outputs[0];
+
+      // Dead transpose
+      if (values_[out].consumers.empty() && !values_[out].IsGraphOutput()) {
+        RemoveNode(i);
+        updated = true;
+        continue;
+      }
+
+      // Transpose(a) -> Transpose(b) => Transpose(Compose(a, b)), the first
+      // one is dropped once it has no consumer left
+      int32_t producer = values_[in].producer;
+      if (producer >= 0 && nodes_[producer].IsTranspose()) {
+        nodes_[i].perm = Compose(nodes_[producer].perm, nodes_[i].perm);
+        SetInput(i, 0, nodes_[producer].inputs[0]);
+        updated = true;
+        continue;
+      }
+
+      if (IsIdentity(nodes_[i].perm)) {
+        auto& in_value = values_[in];
+        if (!values_[out].IsGraphOutput()) {
+          ReplaceUses(out, in);
+          RemoveNode(i);
+          updated = true;
+        } else if (in_value.producer >= 0 && !in_value.IsGraphOutput() &&
+                   !in_value.IsGraphInput()) {
+          // Let the producer write the graph output directly
+          int32_t in_producer = in_value.producer;
+          RemoveNode(i);
+          ReplaceUses(in, out);
+          auto& outputs = nodes_[in_producer].outputs;
+          std::replace(outputs.begin(), outputs.end(), in, out);
+          values_[in].producer = -1;
+          values_[out].producer = in_producer;
+          updated = true;
+        }
+        continue;
+      }
+
+      // Same transpose of the same value computed twice
+      for (int32_t other : values_[in].consumers) {
+        if (other != static_cast<int32_t>(i) && nodes_[other].IsTranspose() &&
+            nodes_[other].perm == nodes_[i].perm &&
+            !values_[out].IsGraphOutput()) {
+          ReplaceUses(out, nodes_[other].outputs[0]);
+          RemoveNode(i);
+          updated = true;
+          break;
+        }
+      }
+    }
+  }
+}
+
+std::vector<std::vector<int32_t>> TransposeGraph::ElementWiseRegions(
+    bool global) const {
+  std::vector<std::vector<int32_t>> regions;
+  std::vector<bool> assigned(nodes_.size(), false);
+  for (uint32_t i = 0; i < nodes_.size(); ++i) {
+    if (assigned[i] || !IsElementWise(i)) continue;
+    std::vector<int32_t> region;
+    std::vector<int32_t> stack = {static_cast<int32_t>(i)};
+    assigned[i] = true;
+    while (!stack.empty()) {
+      int32_t n = stack.back();
+      stack.pop_back();
+      region.push_back(n);
+      if (!global) break;
+      std::vector<int32_t> neighbours;
+      for (int32_t v : nodes_[n].inputs) {
+        neighbours.push_back(values_[v].producer);
+      }
+      for (int32_t v : nodes_[n].outputs) {
+        neighbours.insert(neighbours.end(), values_[v].consumers.begin(),
+                          values_[v].consumers.end());
+      }
+      for (int32_t m : neighbours) {
+        if (m >= 0 && !assigned[m] && IsElementWise(m)) {
+          assigned[m] = true;
+          stack.push_back(m);
+        }
+      }
+    }
+    std::sort(region.begin(), region.end());
+    regions.push_back(region);
+  }
+  return regions;
+}
+
+std::vector<Perm> TransposeGraph::FlipCandidates(
+    const std::vector<int32_t>& region) const {
+  std::set<Perm> candidates;
+  for (int32_t n : region) {
+    for (int32_t v : nodes_[n].inputs) {
+      int32_t producer = values_[v].producer;
+      if (producer >= 0 && nodes_[producer].IsTranspose()) {
+        candidates.insert(nodes_[producer].perm);
+      }
+    }
+    for (int32_t v : nodes_[n].outputs) {
+      for (int32_t consumer : values_[v].consumers) {
+        if (nodes_[consumer].IsTranspose()) {
+          candidates.insert(Inverse(nodes_[consumer].perm));
+        }
+      }
+    }
+  }
+  return std::vector<Perm>(candidates.begin(), candidates.end());
+}
+
+bool TransposeGraph::InputsTransposedBy(int32_t node, const Perm& perm) const {
+  bool transposed = false;
+  for (int32_t v : nodes_[node].inputs) {
+    if (values_[v].IsConst()) continue;
+    int32_t producer = values_[v].producer;
+    if (producer < 0 || !nodes_[producer].IsTranspose() ||
+        nodes_[producer].perm != perm) {
+      return false;
+    }
+    transposed = true;
+  }
+  return transposed;
+}
+
+bool TransposeGraph::Flip(const std::vector<int32_t>& region,
+                          const Perm& perm) {
+  const int32_t rank = perm.size();
+  auto in_region = [&region](int32_t n) {
+    return std::binary_search(region.begin(), region.end(), n);
+  };
+  for (int32_t n : region) {
+    for (const auto& ids : {nodes_[n].inputs, nodes_[n].outputs}) {
+      for (int32_t v : ids) {
+        const auto& value = values_[v];
+        if (value.rank != rank || value.spec.quantization_.Type() ==
+                                      vx::QuantType::SYMMETRIC_PER_CHANNEL) {
+          return false;
+        }
+        if (value.IsConst() &&
+            (value.shape.empty() || !value.Data() ||
+             ElementBytes(value.spec.datatype_) == 0)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  const Perm inverse = Inverse(perm);
+  std::map<int32_t, int32_t> permuted_inputs;
+  for (int32_t n : region) {
+    for (uint32_t i = 0; i < nodes_[n].inputs.size(); ++i) {
+      int32_t v = nodes_[n].inputs[i];
+      if (values_[v].producer >= 0 && in_region(values_[v].producer)) continue;
+      auto it = permuted_inputs.find(v);
+      if (it == permuted_inputs.end()) {
+        int32_t permuted;
+        if (values_[v].IsConst()) {
+          const auto& src = values_[v];
+          uint32_t element_bytes = ElementBytes(src.spec.datatype_);
+          size_t elements = 1;
+          for (auto s : src.shape) elements *= s;
+          auto data = std::make_shared<std::vector<uint8_t>>(elements *
+                                                             element_bytes);
+          TransposeData(static_cast<const uint8_t*>(src.Data()), src.shape,
+                        inverse, element_bytes, data->data());
+          Value value;
+          value.spec = src.spec;
+          value.shape = PermuteShape(src.shape, inverse);
+          value.spec.shape_ = value.shape;
+          value.rank = rank;
+          value.data = data;
+          permuted = AddValue(value);
+        } else {
+          permuted = nodes_[AddTranspose(v, inverse)].outputs[0];
+        }
+        it = permuted_inputs.emplace(v, permuted).first;
+      }
+      SetInput(n, i, it->second);
+    }
+  }
+
+  for (int32_t n : region) {
+    for (uint32_t i = 0; i < nodes_[n].outputs.size(); ++i) {
+      int32_t v = nodes_[n].outputs[i];
+      Value value;
+      value.spec = values_[v].spec.AsTransientSpec();
+      if (!values_[v].shape.empty()) {
+        value.shape = PermuteShape(values_[v].shape, inverse);
+      }
+      value.rank = rank;
+      int32_t flipped = AddValue(value);
+      nodes_[n].outputs[i] = flipped;
+      values_[flipped].producer = n;
+      values_[v].producer = -1;
+      auto consumers = values_[v].consumers;
+      for (int32_t consumer : consumers) {
+        if (!in_region(consumer)) continue;
+        auto& inputs = nodes_[consumer].inputs;
+        for (uint32_t k = 0; k < inputs.size(); ++k) {
+          if (inputs[k] == v) SetInput(consumer, k, flipped);
+        }
+      }
+      if (!values_[v].consumers.empty() || values_[v].IsGraphOutput()) {
+        AddTranspose(flipped, perm, v);
+      }
+    }
+  }
+  changed_ = true;
+  return true;
+}
+
+std::shared_ptr<vx::Graph> TransposeGraph::Emit(
+    const std::shared_ptr<vx::Graph>& graph, std::shared_ptr<vx::Context>& ctx,
+    TensorMap& tensor_map) const {
+  auto dst = ctx->CreateGraph();
+  std::vector<std::shared_ptr<vx::Tensor>> tensors(values_.size());
+  auto tensor_of = [this, &dst, &tensors](int32_t v) {
+    if (tensors[v]) {
+      return tensors[v];
+    }
+    const auto& value = values_[v];
+    if (value.tensor && value.tensor->IsPlaceHolder()) {
+      tensors[v] = dst->CreateTensorPlaceHolder();
+    } else if (value.IsConst()) {
+      tensors[v] = dst->CreateTensor(value.spec, value.Data());
+    } else {
+      tensors[v] = dst->CreateTensor(value.spec);
+    }
+    return tensors[v];
+  };
+  // Keep the io order of the source graph
+  for (const auto& t : graph->InputsTensor()) tensor_of(tensor_values_.at(t));
+  for (const auto& t : graph->OutputsTensor()) tensor_of(tensor_values_.at(t));
+
+  for (const auto& n : nodes_) {
+    if (n.removed) continue;
+    std::shared_ptr<vx::Operation> op =
+        n.IsTranspose() ? dst->CreateOperation<vx::ops::Transpose>(n.perm)
+                        : n.op->Clone(dst);
+    for (int32_t v : n.inputs) op->BindInput(tensor_of(v));
+    for (int32_t v : n.outputs) op->BindOutput(tensor_of(v));
+  }
+  for (const auto& t : tensor_values_) {
+    if (tensors[t.second]) tensor_map[t.first] = tensors[t.second];
+  }
+  return dst;
+}
+
+}  // namespace
+
+std::shared_ptr<vx::Graph> OptimizeTranspose(
+    const std::shared_ptr<vx::Graph>& graph, std::shared_ptr<vx::Context>& ctx,
+    const ShapeHints& shape_hints, TransposeOptimization optimization, TensorMap& tensor_map,
+    LayoutInferenceReport* report) {
+  TransposeGraph transpose_graph(graph, shape_hints);
+  Cost before = transpose_graph.GetCost();
+
+  if (optimization != TransposeOptimization::NONE) {
+    transpose_graph.Canonicalize();
+    // A flip is taken when it lowers the cost; pushing transposes down
+    // through a node is free and lets them meet the ones they cancel with.
+    // Every accepted flip either lowers the cost or moves transposes towards
+    // the graph outputs, the bound is only a safety net.
+    size_t max_rounds = 4 * graph->OpVector().size() + 1;
+    bool local_done = false;
+    for (size_t round = 0; round < max_rounds; ++round) {
+      bool global = local_done &&
+                    optimization == TransposeOptimization::GLOBAL;
+      bool flipped = false;
+      // Regions are disjoint, flipping one keeps the others valid
+      for (const auto& region : transpose_graph.ElementWiseRegions(global)) {
+        auto candidates = transpose_graph.FlipCandidates(region);
+        if (candidates.empty()) continue;
+        Cost current = transpose_graph.GetCost();
+        for (const auto& perm : candidates) {
+          TransposeGraph trial = transpose_graph;
+          if (!trial.Flip(region, perm)) continue;
+          trial.Canonicalize();
+          Cost cost = trial.GetCost();
+          bool push_down = region.size() == 1 && cost == current &&
+                           transpose_graph.InputsTransposedBy(region[0], perm);
+          if (cost < current || (!global && push_down)) {
+            transpose_graph = std::move(trial);
+            flipped = true;
+            break;
+          }
+        }
+      }
+      if (!flipped) {
+        if (local_done || optimization != TransposeOptimization::GLOBAL) {
+          break;
+        }
+        local_done = true;
+      }
+    }
+  }
+
+  Cost after = transpose_graph.GetCost();
+  if (report) {
+    report->transpose_count_before = before.count;
+    report->transpose_count_after = after.count;
+    report->transpose_bytes_before = before.bytes;
+    report->transpose_bytes_after = after.bytes;
+  }
+  if (!transpose_graph.Changed()) {
+    return graph;
+  }
+  return transpose_graph.Emit(graph, ctx, tensor_map);
+}
+
+}  // namespace layout_inference_impl
+}  // namespace transform
+}  // namespace tim
@@ -0,0 +1,65 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_LAYOUT_INFER_TRANSPOSE_OPTIMIZER_H_
+#define TIM_LAYOUT_INFER_TRANSPOSE_OPTIMIZER_H_
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#include "tim/transform/layout_inference.h"
+#include "tim/vx/tensor.h"
+
+namespace tim {
+namespace transform {
+namespace layout_inference_impl {
+
+using TensorMap =
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>;
+
+/**
+ * @brief remove redundant Transpose operations from a layout inferred graph
+ *
+ * @detail
+ *   Operations can not be removed from a vx::Graph, the optimized graph is
+ *   rebuilt in a new graph of ctx with Operation::Clone.
+ *
+ * @param graph graph after layout inference, not compiled
+ * @param shape_hints shape of tensors whose spec does not carry one
+ * @param tensor_map filled with graph tensor -> optimized graph tensor
+ * @param report optional, transpose count and bytes before and after
+ * @return the optimized graph, or graph itself if nothing changed
+ */
+std::shared_ptr<vx::Graph> OptimizeTranspose(
+    const std::shared_ptr<vx::Graph>& graph, std::shared_ptr<vx::Context>& ctx,
+    const std::unordered_map<std::shared_ptr<vx::Tensor>, vx::ShapeType>&
+        shape_hints,
+    TransposeOptimization optimization, TensorMap& tensor_map,
+    LayoutInferenceReport* report);
+
+}  // namespace layout_inference_impl
+}  // namespace transform
+}  // namespace tim
+
+#endif
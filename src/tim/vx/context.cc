@@ -23,6 +23,10 @@
 *****************************************************************************/
 #include "tim/vx/context.h"
 
+#include <cstring>
+#include <tuple>
+#include <vector>
+
 #include "context_private.h"
 #include "graph_private.h"
 #include "tim/vx/graph.h"
@@ -31,6 +35,47 @@
 namespace tim {
 namespace vx {
 
+namespace {
+// Two independently mixed 64-bit lanes over 8 byte words, fast enough for
+// weights of hundreds of MB. Only a lookup key, hits are compared byte by
+// byte before sharing.
+class ConstantHasher {
+ public:
+  void Update(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, bytes + i, sizeof(word));
+      Mix(word);
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, bytes + i, size - i);
+    Mix(tail);
+    Mix(size);
+  }
+
+  template <typename T>
+  void Update(const std::vector<T>& values) {
+    Update(values.data(), values.size() * sizeof(T));
+  }
+
+  uint64_t Lo() const { return lo_; }
+  uint64_t Hi() const { return hi_; }
+
+ private:
+  void Mix(uint64_t word) {
+    lo_ = (lo_ ^ word) * 0x9e3779b97f4a7c15ULL;
+    lo_ ^= lo_ >> 32;
+    hi_ += word * 0xc2b2ae3d27d4eb4fULL;
+    hi_ = ((hi_ << 31) | (hi_ >> 33)) * 0x165667b19e3779f9ULL;
+  }
+
+  uint64_t lo_{0xcbf29ce484222325ULL};
+  uint64_t hi_{0x84222325cbf29ce4ULL};
+};
+}  // namespace
+
 ContextImpl::ContextImpl() : context_(vsi_nn_CreateContext()) {}
 
 ContextImpl::~ContextImpl() {
@@ -48,5 +93,92 @@ std::shared_ptr<Context> Context::Create() {
 std::shared_ptr<Graph> ContextImpl::CreateGraph() {
   return std::make_shared<GraphImpl>(this);
 }
+
+void ContextImpl::EnableConstantPool(bool enable) {
+  std::lock_guard<std::mutex> lock(constant_mutex_);
+  constant_pool_enabled_ = enable;
+}
+
+ConstantPoolStats ContextImpl::GetConstantPoolStats() const {
+  std::lock_guard<std::mutex> lock(constant_mutex_);
+  return constant_stats_;
+}
+
+bool ContextImpl::ConstantKey::operator<(const ConstantKey& other) const {
+  return std::tie(hash[0], hash[1], bytes) <
+         std::tie(other.hash[0], other.hash[1], other.bytes);
+}
+
+ContextImpl::ConstantKey ContextImpl::HashConstant(const TensorSpec& spec,
+                                                   const void* data,
+                                                   uint64_t bytes) {
+  ConstantHasher hasher;
+  int32_t header[] = {static_cast<int32_t>(spec.datatype_),
+                      static_cast<int32_t>(spec.quantization_.Type()),
+                      spec.quantization_.ChannelDim(),
+                      spec.quantization_.Fl()};
+  hasher.Update(header, sizeof(header));
+  hasher.Update(spec.shape_);
+  hasher.Update(spec.quantization_.Scales());
+  hasher.Update(spec.quantization_.ZeroPoints());
+  hasher.Update(data, bytes);
+  return ConstantKey{{hasher.Lo(), hasher.Hi()}, bytes};
+}
+
+bool ContextImpl::ConstantPoolEnabled() const {
+  std::lock_guard<std::mutex> lock(constant_mutex_);
+  return constant_pool_enabled_;
+}
+
+vx_tensor ContextImpl::AcquireConstant(
+    const ConstantKey& key, const std::function<bool(vx_tensor)>& same_data) {
+  std::lock_guard<std::mutex> lock(constant_mutex_);
+  ++constant_stats_.lookups;
+  auto it = constants_.find(key);
+  if (it == constants_.end() || !same_data(it->second.tensor)) {
+    return nullptr;
+  }
+  ++it->second.users;
+  ++constant_stats_.hits;
+  constant_stats_.deduplicated_bytes += key.bytes;
+  vxRetainReference(reinterpret_cast<vx_reference>(it->second.tensor));
+  return it->second.tensor;
+}
+
+bool ContextImpl::AddConstant(const ConstantKey& key, vx_tensor tensor) {
+  std::lock_guard<std::mutex> lock(constant_mutex_);
+  if (constants_.find(key) != constants_.end()) {
+    // Created concurrently by another graph or a different content with the
+    // same hash, the caller keeps its own tensor
+    return false;
+  }
+  vxRetainReference(reinterpret_cast<vx_reference>(tensor));
+  constants_[key] = PooledConstant{tensor, 1};
+  constant_stats_.pooled_bytes += key.bytes;
+  return true;
+}
+
+void ContextImpl::ReleaseConstant(const ConstantKey& key) {
+  std::lock_guard<std::mutex> lock(constant_mutex_);
+  auto it = constants_.find(key);
+  if (it == constants_.end() || --it->second.users > 0) {
+    return;
+  }
+  vxReleaseTensor(&it->second.tensor);
+  constant_stats_.pooled_bytes -= key.bytes;
+  constants_.erase(it);
+}
+
+bool ContextImpl::DetachConstant(const ConstantKey& key) {
+  std::lock_guard<std::mutex> lock(constant_mutex_);
+  auto it = constants_.find(key);
+  if (it == constants_.end() || it->second.users > 1) {
+    return false;
+  }
+  vxReleaseTensor(&it->second.tensor);
+  constant_stats_.pooled_bytes -= key.bytes;
+  constants_.erase(it);
+  return true;
+}
 }  // namespace vx
 }  // namespace tim
\ No newline at end of file
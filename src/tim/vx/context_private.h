@@ -24,6 +24,12 @@
 #ifndef TIM_VX_CONTEXT_PRIVATE_H_
 #define TIM_VX_CONTEXT_PRIVATE_H_
 #include "tim/vx/context.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include "tim/vx/tensor.h"
 #include "vsi_nn_pub.h"
 
 namespace tim {
@@ -35,9 +41,46 @@ class ContextImpl : public Context {
   ~ContextImpl();
   vsi_nn_context_t context();
   std::shared_ptr<Graph> CreateGraph() override;
-  
+  void EnableConstantPool(bool enable) override;
+  ConstantPoolStats GetConstantPoolStats() const override;
+
+  /// Content of a constant tensor, 128 bits of hash over its spec and data
+  struct ConstantKey {
+    uint64_t hash[2];
+    uint64_t bytes;
+    bool operator<(const ConstantKey& other) const;
+  };
+  static ConstantKey HashConstant(const TensorSpec& spec, const void* data,
+                                  uint64_t bytes);
+
+  bool ConstantPoolEnabled() const;
+  /// Reference of the pooled tensor with the content of `key` owned by the
+  /// caller, nullptr if there is none. `same_data` compares the bytes of the
+  /// pooled tensor with the caller's, a hash hit alone is never trusted.
+  vx_tensor AcquireConstant(const ConstantKey& key,
+                            const std::function<bool(vx_tensor)>& same_data);
+  /// Pool `tensor`, which holds the content of `key`, with the caller as its
+  /// first user. False if `key` is pooled already, the caller keeps its
+  /// tensor to itself then.
+  bool AddConstant(const ConstantKey& key, vx_tensor tensor);
+  /// Drop a user of the pooled `key`, the pool lets the tensor go with the
+  /// last one
+  void ReleaseConstant(const ConstantKey& key);
+  /// Take `key` out of the pool if the caller is its only user, the caller
+  /// keeps the tensor to itself then
+  bool DetachConstant(const ConstantKey& key);
+
  protected:
+  struct PooledConstant {
+    vx_tensor tensor;
+    uint32_t users;
+  };
+
   vsi_nn_context_t context_;
+  mutable std::mutex constant_mutex_;
+  std::map<ConstantKey, PooledConstant> constants_;
+  ConstantPoolStats constant_stats_;
+  bool constant_pool_enabled_{false};
 };
 
 }  // namespace vx
@@ -22,12 +22,268 @@
 *
 *****************************************************************************/
 #include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/addn.h"
+#include "tim/vx/ops/elementwise.h"
+#include "context_private.h"
+#include "vsi_nn_pub.h"
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <vector>
+
 TEST(Context, create) {
     auto ctx0 = tim::vx::Context::Create();
     {auto ctx0 = tim::vx::Context::Create();}
     auto ctx1 = tim::vx::Context::Create();
     EXPECT_TRUE(nullptr != ctx0);
     EXPECT_TRUE(nullptr != ctx1);
-}
\ No newline at end of file
+}
+namespace {
+std::shared_ptr<tim::vx::Graph> BuildAddConstGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx,
+    const tim::vx::ShapeType& shape,
+    const std::vector<const float*>& constants) {
+    tim::vx::TensorSpec io_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::TRANSIENT);
+
+    auto graph = ctx->CreateGraph();
+    auto x = graph->CreateTensor(io_spec);
+    for (size_t i = 0; i < constants.size(); ++i) {
+        auto y = i + 1 == constants.size() ? graph->CreateTensor(output_spec)
+                                           : graph->CreateTensor(transient_spec);
+        auto add = graph->CreateOperation<tim::vx::ops::Add>();
+        (*add).BindInputs({x, graph->CreateTensor(const_spec, constants[i])})
+            .BindOutputs({y});
+        x = y;
+    }
+    return graph;
+}
+
+// Resident set of the process in KB
+long ResidentKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return std::atol(line.c_str() + 6);
+        }
+    }
+    return 0;
+}
+}  // namespace
+
+TEST(Context, constant_pool_stats) {
+    auto ctx = tim::vx::Context::Create();
+    ctx->EnableConstantPool(true);
+    // Same content in different buffers
+    std::vector<float> w0(16, 0.5f), w1(16, 0.5f), w2(16, 2.0f);
+    const uint64_t bytes = 16 * sizeof(float);
+    {
+        auto g0 = BuildAddConstGraph(ctx, {16}, {w0.data(), w1.data()});
+        auto g1 = BuildAddConstGraph(ctx, {16}, {w1.data(), w2.data()});
+
+        auto stats = ctx->GetConstantPoolStats();
+        EXPECT_EQ(stats.lookups, 4u);
+        EXPECT_EQ(stats.hits, 2u);
+        EXPECT_EQ(stats.pooled_bytes, 2 * bytes);
+        EXPECT_EQ(stats.deduplicated_bytes, 2 * bytes);
+    }
+    EXPECT_EQ(ctx->GetConstantPoolStats().pooled_bytes, 0u)
+        << "Pooled constants are released with the last graph using them";
+
+    ctx->EnableConstantPool(false);
+    auto g2 = BuildAddConstGraph(ctx, {16}, {w0.data(), w1.data()});
+    EXPECT_EQ(ctx->GetConstantPoolStats().lookups, 4u);
+}
+
+TEST(Context, constant_pool_reduces_rss) {
+    // 32MB of weights, used by two graphs
+    const tim::vx::ShapeType shape({1024, 1024, 8});
+    std::vector<float> weights(1024 * 1024 * 8, 0.25f);
+    const long weights_kb = weights.size() * sizeof(float) / 1024;
+
+    long growth_kb[2];
+    for (int pooled = 0; pooled < 2; ++pooled) {
+        auto ctx = tim::vx::Context::Create();
+        ctx->EnableConstantPool(pooled == 1);
+        auto g0 = BuildAddConstGraph(ctx, shape, {weights.data()});
+        EXPECT_TRUE(g0->Compile());
+        long before_kb = ResidentKb();
+        auto g1 = BuildAddConstGraph(ctx, shape, {weights.data()});
+        EXPECT_TRUE(g1->Compile());
+        growth_kb[pooled] = ResidentKb() - before_kb;
+    }
+    // The second graph allocates its own weights only without the pool
+    EXPECT_GT(growth_kb[0] - growth_kb[1], weights_kb / 2);
+}
+
+TEST(Context, constant_pool_write) {
+    auto ctx = tim::vx::Context::Create();
+    ctx->EnableConstantPool(true);
+    const tim::vx::ShapeType shape({16});
+    std::vector<float> w0(16, 0.5f), w1(16, 2.0f);
+    tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, shape,
+                                   tim::vx::TensorAttribute::CONSTANT);
+    auto g0 = BuildAddConstGraph(ctx, shape, {w0.data()});
+
+    auto g1 = ctx->CreateGraph();
+    auto before_compile = g1->CreateTensor(const_spec, w0.data());
+    auto after_compile = g1->CreateTensor(const_spec, w0.data());
+    EXPECT_EQ(ctx->GetConstantPoolStats().hits, 2u);
+
+    // Moves to a tensor of its own, g0 keeps the pooled one
+    EXPECT_TRUE(before_compile->CopyDataToTensor(w1.data()));
+    EXPECT_EQ(ctx->GetConstantPoolStats().pooled_bytes, w0.size() * sizeof(float));
+
+    tim::vx::TensorSpec io_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::OUTPUT);
+    auto x = g1->CreateTensor(io_spec);
+    auto y = g1->CreateTensor(output_spec);
+    g1->CreateOperation<tim::vx::ops::AddN>(3)
+        ->BindInputs({x, before_compile, after_compile})
+        .BindOutputs({y});
+    g1->Compile();
+    EXPECT_TRUE(before_compile->CopyDataToTensor(w0.data()));
+    EXPECT_FALSE(after_compile->CopyDataToTensor(w1.data()))
+        << "The compiled node keeps the pooled tensor, the write must not be"
+           " silently dropped";
+}
+
+TEST(Context, constant_write_after_compile) {
+    const tim::vx::ShapeType shape({16});
+    std::vector<float> w0(16, 0.5f), w1(16, 2.0f);
+    tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, shape,
+                                   tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec io_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::OUTPUT);
+
+    // Default context, then a pooled constant nobody else shares
+    for (int pooled = 0; pooled < 2; ++pooled) {
+        auto ctx = tim::vx::Context::Create();
+        if (pooled) {
+            ctx->EnableConstantPool(true);
+        }
+        auto graph = ctx->CreateGraph();
+        auto x = graph->CreateTensor(io_spec);
+        auto w = graph->CreateTensor(const_spec, w0.data());
+        auto y = graph->CreateTensor(output_spec);
+        graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({x, w}).BindOutputs({y});
+        EXPECT_TRUE(graph->Compile());
+
+        EXPECT_TRUE(w->CopyDataToTensor(w1.data())) << "pooled: " << pooled;
+        EXPECT_EQ(ctx->GetConstantPoolStats().pooled_bytes, 0u);
+    }
+}
+
+TEST(Context, program_cache_hit_miss) {
+    auto ctx = tim::vx::Context::Create();
+    vsi_nn_context_t vsi_ctx =
+        std::static_pointer_cast<tim::vx::ContextImpl>(ctx)->context();
+    auto build = [&](const tim::vx::ShapeType& in0_shape,
+                     const tim::vx::ShapeType& in1_shape) {
+        tim::vx::TensorSpec in0_spec(tim::vx::DataType::FLOAT16, in0_shape, tim::vx::TensorAttribute::INPUT);
+        tim::vx::TensorSpec in1_spec(tim::vx::DataType::FLOAT16, in1_shape, tim::vx::TensorAttribute::INPUT);
+        tim::vx::TensorSpec out_spec(tim::vx::DataType::FLOAT16, in0_shape, tim::vx::TensorAttribute::OUTPUT);
+        auto graph = ctx->CreateGraph();
+        graph->CreateOperation<tim::vx::ops::Maximum>()
+            ->BindInputs({graph->CreateTensor(in0_spec), graph->CreateTensor(in1_spec)})
+            .BindOutputs({graph->CreateTensor(out_spec)});
+        graph->Compile();
+        return graph;
+    };
+
+    uint32_t hit = 0, disk_hit = 0, miss = 0;
+    auto g0 = build({16, 4}, {16, 4});
+    vsi_nn_GetProgramCacheStats(vsi_ctx, &hit, &disk_hit, &miss);
+    ASSERT_GT(miss, 0u) << "First build of a program must be a miss";
+
+    // The broadcast can not be folded to 2D, it selects the 3D kernel of the
+    // same program. Kernels already registered in the vx context do not
+    // look the cache up again, so this is the case the cache is for.
+    auto g1 = build({16, 4, 2}, {16, 1, 2});
+    uint32_t hit1 = 0, miss1 = 0;
+    vsi_nn_GetProgramCacheStats(vsi_ctx, &hit1, &disk_hit, &miss1);
+    EXPECT_EQ(miss1, miss);
+    EXPECT_GT(hit1, hit);
+}
+
+namespace {
+std::set<std::string> TuningDbKeys(const std::string& path, size_t* lines) {
+    std::ifstream db(path);
+    std::set<std::string> keys;
+    std::string line;
+    *lines = 0;
+    while (std::getline(db, line)) {
+        keys.insert(line.substr(0, line.find(' ')));
+        ++*lines;
+    }
+    return keys;
+}
+
+// Tuning DB options are read when a context is created
+struct ScopedTuningDb {
+    explicit ScopedTuningDb(const std::string& db_path) : path(db_path) {
+        std::remove(path.c_str());
+        setenv("VSI_NN_TUNING_DB", path.c_str(), 1);
+        setenv("VSI_NN_ENABLE_AUTOTUNE", "1", 1);
+    }
+    ~ScopedTuningDb() {
+        unsetenv("VSI_NN_TUNING_DB");
+        unsetenv("VSI_NN_ENABLE_AUTOTUNE");
+        std::remove(path.c_str());
+    }
+    std::string path;
+};
+}  // namespace
+
+TEST(Context, tuning_db_reload) {
+    ScopedTuningDb db(::testing::TempDir() + "context_tuning_db.txt");
+
+    const tim::vx::ShapeType shape({16, 4});
+    tim::vx::TensorSpec in_spec(tim::vx::DataType::FLOAT16, shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec out_spec(tim::vx::DataType::FLOAT16, shape, tim::vx::TensorAttribute::OUTPUT);
+    auto compile = [&](const std::shared_ptr<tim::vx::Context>& ctx) {
+        auto graph = ctx->CreateGraph();
+        graph->CreateOperation<tim::vx::ops::Maximum>()
+            ->BindInputs({graph->CreateTensor(in_spec), graph->CreateTensor(in_spec)})
+            .BindOutputs({graph->CreateTensor(out_spec)});
+        graph->Compile();
+    };
+    auto stats = [](const std::shared_ptr<tim::vx::Context>& ctx,
+                    uint32_t* hit, uint32_t* tuned) {
+        vsi_nn_GetTuningDBStats(
+            std::static_pointer_cast<tim::vx::ContextImpl>(ctx)->context(), hit, tuned);
+    };
+
+    uint32_t hit = 0, tuned = 0;
+    size_t lines = 0;
+    {
+        auto ctx = tim::vx::Context::Create();
+        compile(ctx);
+        stats(ctx, &hit, &tuned);
+    }
+    auto stored = TuningDbKeys(db.path, &lines);
+    ASSERT_GT(tuned, 0u) << "No kernel of maximum was measured";
+    EXPECT_EQ(hit, 0u);
+    EXPECT_EQ(lines, tuned);
+    EXPECT_EQ(stored.size(), tuned);
+
+    // A new context loads the file, the same signatures must give the same
+    // keys and nothing is measured or appended again
+    {
+        auto ctx = tim::vx::Context::Create();
+        compile(ctx);
+        stats(ctx, &hit, &tuned);
+    }
+    size_t reloaded_lines = 0;
+    EXPECT_EQ(tuned, 0u);
+    EXPECT_EQ(hit, stored.size());
+    EXPECT_EQ(TuningDbKeys(db.path, &reloaded_lines), stored);
+    EXPECT_EQ(reloaded_lines, lines);
+}
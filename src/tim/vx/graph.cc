@@ -23,6 +23,11 @@
 *****************************************************************************/
 #include "tim/vx/graph.h"
 #include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
 
 #include "context_private.h"
 #include "graph_private.h"
@@ -30,7 +35,117 @@
 #include "tensor_private.h"
 #include "tim/vx/context.h"
 #include "tim/vx/ops/nbg.h"
+#include "tim/vx/ops/post_process.h"
+#include "tim/vx/ops/pre_process.h"
 #include "vsi_nn_pub.h"
+#include "vsi_nn_internal_node.h"
+#include "kernel/vsi_nn_kernel.h"
+
+namespace {
+
+// 64-bit FNV-1a
+class Fnv1aHasher {
+ public:
+  void Update(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+      hash_ ^= bytes[i];
+      hash_ *= 0x100000001b3ULL;
+    }
+  }
+
+  template <typename T>
+  void Update(const T& value) {
+    Update(&value, sizeof(value));
+  }
+
+  template <typename T>
+  void Update(const std::vector<T>& values) {
+    Update(values.size());
+    if (!values.empty()) {
+      Update(values.data(), values.size() * sizeof(T));
+    }
+  }
+
+  uint64_t Value() const { return hash_; }
+
+ private:
+  uint64_t hash_{0xcbf29ce484222325ULL};
+};
+
+// Hash the op parameters which differ from the op's defaults. Pointer words
+// referring to arrays registered by the op are hashed by content, so an op
+// keeping an array in nn_param must register it with RegisterParamArray.
+// Every other word is hashed as a plain value.
+void HashNodeParam(const tim::vx::OperationImpl* op, Fnv1aHasher& hasher) {
+  const vsi_nn_node_t* node = op->node_;
+  const uint8_t* param = reinterpret_cast<const uint8_t*>(&node->nn_param);
+  const size_t param_size = sizeof(node->nn_param);
+  const size_t word = sizeof(uintptr_t);
+
+  for (size_t offset = 0; offset < param_size; offset += word) {
+    size_t size = std::min(word, param_size - offset);
+    if (offset + size <= op->param_baseline_.size() &&
+        0 == memcmp(param + offset, op->param_baseline_.data() + offset,
+                    size)) {
+      continue;
+    }
+    hasher.Update(offset);
+    uintptr_t value = 0;
+    memcpy(&value, param + offset, size);
+    auto array = std::find_if(
+        op->param_arrays_.begin(), op->param_arrays_.end(),
+        [value](const tim::vx::OperationImpl::ParamArray& it) {
+          return reinterpret_cast<uintptr_t>(it.address) == value;
+        });
+    if (size == word && array != op->param_arrays_.end()) {
+      hasher.Update(array->bytes);
+      hasher.Update(array->content, array->bytes);
+    } else {
+      hasher.Update(param + offset, size);
+    }
+  }
+}
+
+// OpenVX nodes created for `node`, including those of its internal nodes
+void CollectVxNodes(vsi_nn_node_t* node, std::vector<vx_node>& vx_nodes) {
+  if (node->n &&
+      std::find(vx_nodes.begin(), vx_nodes.end(), node->n) == vx_nodes.end()) {
+    vx_nodes.push_back(node->n);
+  }
+  auto wksp =
+      reinterpret_cast<vsi_nn_internal_node_wksp_t*>(node->internal_node_wksp);
+  if (!wksp) {
+    return;
+  }
+  for (auto curr = wksp->nodes; curr;
+       curr = reinterpret_cast<vsi_nn_internal_node_t*>(vsi_nn_LinkListNext(
+           reinterpret_cast<vsi_nn_link_list_t*>(curr)))) {
+    if (curr->node) {
+      CollectVxNodes(curr->node, vx_nodes);
+    }
+  }
+}
+
+class RunHandleImpl : public tim::vx::RunHandle {
+ public:
+  explicit RunHandleImpl(std::shared_future<bool> result)
+      : result_(std::move(result)) {}
+
+  bool Wait() override { return result_.get(); }
+
+  bool WaitFor(uint32_t timeout_ms) override {
+    return std::future_status::ready ==
+           result_.wait_for(std::chrono::milliseconds(timeout_ms));
+  }
+
+  bool IsReady() override { return WaitFor(0); }
+
+ private:
+  std::shared_future<bool> result_;
+};
+
+}  // namespace
 
 namespace tim {
 namespace vx {
@@ -40,7 +155,16 @@ GraphImpl::GraphImpl(ContextImpl* context)
       graph_(vsi_nn_CreateGraph(context_->context(), 0, 0)),
       tensor_placeholder_(nullptr) {}
 
-GraphImpl::~GraphImpl() { vsi_nn_ReleaseGraph(&graph_); }
+GraphImpl::~GraphImpl() {
+  WaitIdle();
+  if (nbg_graph_) {
+    vsi_nn_ReleaseGraph(&nbg_graph_);
+  }
+  vsi_nn_ReleaseGraph(&graph_);
+  for (const auto& key : pooled_constants_) {
+    context_->ReleaseConstant(key);
+  }
+}
 
 vsi_nn_graph_t* GraphImpl::graph() { return graph_; }
 
@@ -80,9 +204,11 @@ const std::vector<std::shared_ptr<Tensor>> GraphImpl::OutputsTensor() const {
 
 void GraphImpl::UpdateTensorConsumersMap(const std::shared_ptr<Tensor>& tensor,
                                          const Operation* op) {
-  for (const auto& added_op : op_vector_) {
-    if (added_op.get() == op) {
-      tensor_consumers_[tensor].push_back(added_op);
+  // Inputs are usually bound right after the operation is created
+  for (auto it = op_vector_.rbegin(); it != op_vector_.rend(); ++it) {
+    if (it->get() == op) {
+      tensor_consumers_[tensor].push_back(*it);
+      break;
     }
   }
 }
@@ -113,7 +239,112 @@ std::shared_ptr<Tensor> GraphImpl::CreateTensorPlaceHolder() {
   return tensor_placeholder_;
 }
 
+std::vector<std::shared_ptr<Tensor>> GraphImpl::AddPreProcess(
+    const std::shared_ptr<Tensor>& input, const PreProcessConfig& config) {
+  auto it = std::find(inputs_tensor_.begin(), inputs_tensor_.end(), input);
+  if (io_frozen_ || nbg_graph_ || inputs_tensor_.end() == it) {
+    VSILOGE("Pre-processing needs an input of a graph not compiled yet");
+    return {};
+  }
+  auto shape = input->GetShape();
+  uint32_t channel_dim = config.layout == DataLayout::CWHN ? 0 : 2;
+  uint32_t channels = config.format == ImageFormat::GRAY ? 1 : 3;
+  if ((config.layout != DataLayout::WHCN &&
+       config.layout != DataLayout::CWHN) ||
+      shape.size() != 4 || shape[channel_dim] != channels || shape[3] != 1) {
+    VSILOGE("Pre-processing needs a %u channel image input", channels);
+    return {};
+  }
+  if (config.width == 0 || config.height == 0 ||
+      config.crop_left + config.crop_width > config.width ||
+      config.crop_top + config.crop_height > config.height ||
+      config.crop_left >= config.width || config.crop_top >= config.height) {
+    VSILOGE("Crop %ux%u+%u+%u is not inside the %ux%u frame",
+            config.crop_width, config.crop_height, config.crop_left,
+            config.crop_top, config.width, config.height);
+    return {};
+  }
+
+  // The frame planes take the place of the input in the graph inputs
+  size_t index = it - inputs_tensor_.begin();
+  inputs_tensor_.erase(it);
+  inputs_.erase(inputs_.begin() + index);
+  input->GetSpec().SetAttribute(TensorAttribute::TRANSIENT);
+
+  std::vector<std::shared_ptr<Tensor>> frames;
+  for (const auto& plane : ops::PreProcess::InputShapes(config)) {
+    frames.push_back(CreateTensor(
+        TensorSpec(DataType::UINT8, plane, TensorAttribute::INPUT)));
+  }
+  auto pre_process = CreateOperation<ops::PreProcess>(config, shape);
+  (*pre_process).BindInputs(frames).BindOutput(input);
+
+  std::rotate(inputs_.begin() + index, inputs_.end() - frames.size(),
+              inputs_.end());
+  std::rotate(inputs_tensor_.begin() + index,
+              inputs_tensor_.end() - frames.size(), inputs_tensor_.end());
+  return frames;
+}
+
+std::shared_ptr<Tensor> GraphImpl::AddPostProcess(
+    const std::shared_ptr<Tensor>& output, const PostProcessConfig& config) {
+  auto it = std::find(outputs_tensor_.begin(), outputs_tensor_.end(), output);
+  if (io_frozen_ || nbg_graph_ || outputs_tensor_.end() == it) {
+    VSILOGE("Post-processing needs an output of a graph not compiled yet");
+    return nullptr;
+  }
+  auto shape = output->GetShape();
+  std::vector<uint32_t> perm = config.perm;
+  if (perm.empty()) {
+    for (uint32_t i = 0; i < shape.size(); i++) {
+      perm.push_back(i);
+    }
+  }
+  std::vector<bool> seen(shape.size(), false);
+  for (auto axis : perm) {
+    if (perm.size() != shape.size() || axis >= shape.size() || seen[axis]) {
+      VSILOGE("Perm is not a permutation of the %u output dimensions",
+              static_cast<uint32_t>(shape.size()));
+      return nullptr;
+    }
+    seen[axis] = true;
+  }
+
+  TensorSpec spec = output->GetSpec();
+  ShapeType out_shape;
+  for (auto axis : perm) {
+    out_shape.push_back(shape[axis]);
+  }
+  spec.SetShape(out_shape);
+  if (config.datatype != DataType::UNKNOWN &&
+      config.datatype != spec.datatype_) {
+    spec.datatype_ = config.datatype;
+    if (config.datatype == DataType::FLOAT32 ||
+        config.datatype == DataType::FLOAT16) {
+      spec.quantization_ = Quantization();
+    }
+  }
+  spec.SetAttribute(TensorAttribute::OUTPUT);
+
+  size_t index = it - outputs_tensor_.begin();
+  outputs_tensor_.erase(it);
+  outputs_.erase(outputs_.begin() + index);
+  output->GetSpec().SetAttribute(TensorAttribute::TRANSIENT);
+
+  auto result = CreateTensor(spec);
+  auto post_process = CreateOperation<ops::PostProcess>(perm);
+  (*post_process).BindInput(output).BindOutput(result);
+
+  std::rotate(outputs_.begin() + index, outputs_.end() - 1, outputs_.end());
+  std::rotate(outputs_tensor_.begin() + index, outputs_tensor_.end() - 1,
+              outputs_tensor_.end());
+  return result;
+}
+
 bool GraphImpl::Compile() {
+  if (nbg_graph_) {
+    return true;
+  }
   bool status = true;
 
   auto major = vsi_nn_GetVersionMajor();
@@ -123,6 +354,7 @@ bool GraphImpl::Compile() {
   vsi_nn_SetGraphVersion(graph_, major, minor, patch);
 
   std::call_once(setio_once_, [&status, this]() {
+    this->io_frozen_ = true;
     status = (vsi_nn_SetGraphInputs(this->graph_, this->inputs_.data(),
                                     this->inputs_.size()) &&
               vsi_nn_SetGraphOutputs(this->graph_, this->outputs_.data(),
@@ -141,8 +373,19 @@ bool GraphImpl::Compile() {
 }
 
 bool GraphImpl::CompileToBinary(void* buf, size_t* size) {
+  if (nbg_graph_) {
+    if (buf) {
+      if (*size < nbg_binary_.size()) {
+        return false;
+      }
+      memcpy(buf, nbg_binary_.data(), nbg_binary_.size());
+    }
+    *size = nbg_binary_.size();
+    return true;
+  }
   bool status = true;
   std::call_once(setio_once_, [&status, this]() {
+    this->io_frozen_ = true;
     status = (vsi_nn_SetGraphInputs(this->graph_, this->inputs_.data(),
                                     this->inputs_.size()) &&
               vsi_nn_SetGraphOutputs(this->graph_, this->outputs_.data(),
@@ -156,8 +399,418 @@ bool GraphImpl::CompileToBinary(void* buf, size_t* size) {
   return ((status) && (VSI_SUCCESS == vsi_nn_GenerateNBG(graph_, buf, size)));
 }
 
+bool GraphImpl::CompileWithCache(const std::string& cache_dir,
+                                 bool* cache_hit) {
+  if (cache_hit) {
+    *cache_hit = false;
+  }
+  if (nbg_graph_) {
+    if (cache_hit) {
+      *cache_hit = true;
+    }
+    return true;
+  }
+
+  uint64_t hash = Hash();
+  char name[32];
+  snprintf(name, sizeof(name), "%016" PRIx64 ".nbg", hash);
+  std::string path = cache_dir + "/" + name;
+
+  FILE* fp = fopen(path.c_str(), "rb");
+  if (fp) {
+    std::vector<char> binary;
+    if (0 == fseek(fp, 0, SEEK_END)) {
+      long size = ftell(fp);
+      if (size > 0 && 0 == fseek(fp, 0, SEEK_SET)) {
+        binary.resize(size);
+        if (fread(binary.data(), 1, size, fp) != static_cast<size_t>(size)) {
+          binary.clear();
+        }
+      }
+    }
+    fclose(fp);
+    if (!binary.empty() && LoadBinary(std::move(binary))) {
+      if (cache_hit) {
+        *cache_hit = true;
+      }
+      return true;
+    }
+    VSILOGW("Ignore invalid graph cache %s", path.c_str());
+  }
+
+  size_t size = 0;
+  if (CompileToBinary(nullptr, &size) && size > 0) {
+    std::vector<char> binary(size);
+    if (CompileToBinary(binary.data(), &size)) {
+      // Write to a temporary file first so that concurrent readers never
+      // see a partial binary.
+      std::string tmp_path = path + ".tmp";
+      fp = fopen(tmp_path.c_str(), "wb");
+      if (fp) {
+        bool written = (fwrite(binary.data(), 1, size, fp) == size);
+        written = (0 == fclose(fp)) && written;
+        if (!written || 0 != rename(tmp_path.c_str(), path.c_str())) {
+          remove(tmp_path.c_str());
+          VSILOGW("Write graph cache %s fail", path.c_str());
+        }
+      } else {
+        VSILOGW("Open graph cache %s fail", tmp_path.c_str());
+      }
+    }
+  }
+
+  return Compile();
+}
+
+bool GraphImpl::CompileFromBinary(std::vector<char> binary) {
+  if (nbg_graph_) {
+    return true;
+  }
+  return !binary.empty() && LoadBinary(std::move(binary));
+}
+
+const void* GraphImpl::HoldConstData(std::vector<uint8_t> data) {
+  const_data_.push_back(std::move(data));
+  return const_data_.back().data();
+}
+
+void GraphImpl::AddPooledConstant(const ContextImpl::ConstantKey& key) {
+  pooled_constants_.push_back(key);
+}
+
+void GraphImpl::ReleasePooledConstant(const ContextImpl::ConstantKey& key) {
+  for (auto it = pooled_constants_.begin(); it != pooled_constants_.end();
+       ++it) {
+    if (!(*it < key) && !(key < *it)) {
+      pooled_constants_.erase(it);
+      context_->ReleaseConstant(key);
+      return;
+    }
+  }
+}
+
+bool GraphImpl::DetachPooledConstant(const ContextImpl::ConstantKey& key) {
+  for (auto it = pooled_constants_.begin(); it != pooled_constants_.end();
+       ++it) {
+    if (!(*it < key) && !(key < *it)) {
+      if (!context_->DetachConstant(key)) {
+        return false;
+      }
+      pooled_constants_.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t GraphImpl::Hash() const {
+  Fnv1aHasher hasher;
+  hasher.Update(vsi_nn_GetVersionMajor());
+  hasher.Update(vsi_nn_GetVersionMinor());
+  hasher.Update(vsi_nn_GetVersionPatch());
+
+  const vsi_nn_hw_config_t& config = context_->context()->config;
+  hasher.Update(config.target_name, strlen(config.target_name));
+  hasher.Update(config.evis.ver);
+  hasher.Update(config.use_40bits_va);
+
+  // Tensors are identified by the order they are first used so that the hash
+  // doesn't depend on ids or addresses.
+  std::unordered_map<const Tensor*, uint32_t> tensor_index;
+  auto hash_tensor = [this, &hasher, &tensor_index](
+                         const std::shared_ptr<Tensor>& tensor) {
+    auto it = tensor_index.find(tensor.get());
+    if (it != tensor_index.end()) {
+      hasher.Update(it->second);
+      return;
+    }
+    uint32_t index = tensor_index.size();
+    tensor_index[tensor.get()] = index;
+    hasher.Update(index);
+    if (tensor->IsPlaceHolder()) {
+      hasher.Update(VSI_NN_TENSOR_ID_NA);
+      return;
+    }
+
+    const TensorSpec& spec = tensor->GetSpec();
+    hasher.Update(spec.datatype_);
+    hasher.Update(spec.shape_);
+    hasher.Update(spec.attr_);
+    hasher.Update(spec.quantization_.Type());
+    hasher.Update(spec.quantization_.ChannelDim());
+    hasher.Update(spec.quantization_.Fl());
+    hasher.Update(spec.quantization_.Scales());
+    hasher.Update(spec.quantization_.ZeroPoints());
+
+    if (spec.attr_ & TensorAttribute::CONSTANT) {
+      vsi_nn_tensor_t* t = vsi_nn_GetTensor(graph_, tensor->GetId());
+      uint8_t* data = t ? vsi_nn_ConvertTensorToData(graph_, t) : nullptr;
+      if (data) {
+        hasher.Update(data, vsi_nn_GetTensorSize(t->attr.size, t->attr.dim_num,
+                                                 t->attr.dtype.vx_type));
+        free(data);
+      }
+    }
+  };
+
+  hasher.Update(op_vector_.size());
+  for (const auto& op : op_vector_) {
+    const auto& impl = op->impl();
+    hasher.Update(impl->operation_id_);
+    hasher.Update(impl->layout_);
+    hasher.Update(&impl->node_->vx_param, sizeof(impl->node_->vx_param));
+    HashNodeParam(impl.get(), hasher);
+    hasher.Update(impl->inputs_tensor_.size());
+    for (const auto& tensor : impl->inputs_tensor_) {
+      hash_tensor(tensor);
+    }
+    hasher.Update(impl->outputs_tensor_.size());
+    for (const auto& tensor : impl->outputs_tensor_) {
+      hash_tensor(tensor);
+    }
+  }
+
+  // Graph io order is the io order of the binary graph
+  for (const auto& io : {&inputs_tensor_, &outputs_tensor_}) {
+    hasher.Update(io->size());
+    for (const auto& tensor : *io) {
+      auto it = tensor_index.find(tensor.get());
+      hasher.Update(it == tensor_index.end() ? UINT32_MAX : it->second);
+    }
+  }
+
+  return hasher.Value();
+}
+
+bool GraphImpl::LoadBinary(std::vector<char> binary) {
+  vsi_nn_graph_t* nbg_graph = vsi_nn_CreateGraph(context_->context(), 0, 0);
+  if (!nbg_graph) {
+    return false;
+  }
+
+  // The io tensors of the binary graph wrap the handles of graph_'s io
+  // tensors, so that data copied through tim::vx::Tensor reaches them.
+  auto share_tensor = [this, nbg_graph](vsi_nn_tensor_id_t id) {
+    vsi_nn_tensor_t* tensor = vsi_nn_GetTensor(graph_, id);
+    void* ptr = nullptr;
+    if (!tensor || VSI_SUCCESS != vsi_nn_GetTensorHandle(tensor, &ptr) ||
+        !ptr) {
+      return static_cast<vsi_nn_tensor_id_t>(VSI_NN_TENSOR_ID_NA);
+    }
+    vsi_nn_tensor_attr_t attr = tensor->attr;
+    return vsi_nn_AddTensorFromHandle(nbg_graph, VSI_NN_TENSOR_ID_AUTO, &attr,
+                                      static_cast<uint8_t*>(ptr));
+  };
+
+  bool status = true;
+  std::vector<vsi_nn_tensor_id_t> nbg_inputs;
+  std::vector<vsi_nn_tensor_id_t> nbg_outputs;
+  for (auto id : inputs_) {
+    nbg_inputs.push_back(share_tensor(id));
+    status = status && VSI_NN_TENSOR_ID_NA != nbg_inputs.back();
+  }
+  for (auto id : outputs_) {
+    nbg_outputs.push_back(share_tensor(id));
+    status = status && VSI_NN_TENSOR_ID_NA != nbg_outputs.back();
+  }
+
+  vsi_nn_node_t* node =
+      status ? vsi_nn_AddNode(nbg_graph, VSI_NN_OP_NBG, nbg_inputs.size(),
+                              nbg_outputs.size(), NULL)
+             : nullptr;
+  if (node) {
+    node->nn_param.nbg.type = VSI_NN_NBG_POINTER;
+    node->nn_param.nbg.url = binary.data();
+    std::copy(nbg_inputs.begin(), nbg_inputs.end(), node->input.tensors);
+    std::copy(nbg_outputs.begin(), nbg_outputs.end(), node->output.tensors);
+
+    vsi_nn_SetGraphVersion(nbg_graph, vsi_nn_GetVersionMajor(),
+                           vsi_nn_GetVersionMinor(), vsi_nn_GetVersionPatch());
+    status = vsi_nn_SetGraphInputs(nbg_graph, nbg_inputs.data(),
+                                   nbg_inputs.size()) &&
+             vsi_nn_SetGraphOutputs(nbg_graph, nbg_outputs.data(),
+                                    nbg_outputs.size()) &&
+             VSI_SUCCESS == vsi_nn_SetupGraph(nbg_graph, true) &&
+             VSI_SUCCESS == vsi_nn_VerifyGraph(nbg_graph);
+  } else {
+    status = false;
+  }
+
+  if (!status) {
+    vsi_nn_ReleaseGraph(&nbg_graph);
+    return false;
+  }
+  nbg_graph_ = nbg_graph;
+  nbg_binary_ = std::move(binary);
+  for (size_t i = 0; i < inputs_.size(); i++) {
+    nbg_io_[inputs_[i]] = nbg_inputs[i];
+  }
+  for (size_t i = 0; i < outputs_.size(); i++) {
+    nbg_io_[outputs_[i]] = nbg_outputs[i];
+  }
+  return true;
+}
+
+void GraphImpl::SwapIoHandle(vsi_nn_tensor_id_t id, void* handle) {
+  auto it = nbg_io_.find(id);
+  if (nbg_graph_ && it != nbg_io_.end()) {
+    vsi_nn_SwapHandle(vsi_nn_GetTensor(nbg_graph_, it->second), handle,
+                      nullptr);
+  }
+}
+
+void GraphImpl::FlushUserBuffers() {
+  for (const auto& tensor : inputs_tensor_) {
+    auto impl = std::static_pointer_cast<TensorImpl>(tensor);
+    if (impl->user_buffer_) {
+      vsi_nn_FlushHandle(vsi_nn_GetTensor(graph_, impl->GetId()));
+    }
+  }
+}
+
 bool GraphImpl::Run() {
-  return ((Compile()) && (VSI_SUCCESS == vsi_nn_RunGraph(graph_)));
+  if (!Compile()) {
+    return false;
+  }
+  auto lock = WaitIdle();
+  FlushUserBuffers();
+  auto start = std::chrono::steady_clock::now();
+  bool status =
+      VSI_SUCCESS == vsi_nn_RunGraph(nbg_graph_ ? nbg_graph_ : graph_);
+  last_run_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  return status;
+}
+
+std::shared_ptr<RunHandle> GraphImpl::RunAsync() {
+  std::shared_future<bool> result;
+  if (Compile()) {
+    auto lock = WaitIdle();
+    FlushUserBuffers();
+    vsi_nn_graph_t* graph = nbg_graph_ ? nbg_graph_ : graph_;
+    if (VSI_SUCCESS == vsi_nn_AsyncRunGraph(graph)) {
+      // OpenVX only offers a blocking wait, so wait on a helper thread to
+      // support polling and timeouts.
+      auto start = std::chrono::steady_clock::now();
+      result = std::async(std::launch::async, [this, graph, start]() {
+                 bool status = VSI_SUCCESS == vsi_nn_AsyncRunWait(graph);
+                 last_run_ns_ =
+                     std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+                 return status;
+               }).share();
+      pending_run_ = result;
+    }
+  }
+
+  if (!result.valid()) {
+    std::promise<bool> failed;
+    failed.set_value(false);
+    result = failed.get_future().share();
+  }
+  return std::make_shared<RunHandleImpl>(result);
+}
+
+bool GraphImpl::EnableProfiling(bool enable) {
+  vx_status status = vxDirective(
+      reinterpret_cast<vx_reference>(context_->context()->c),
+      enable ? VX_DIRECTIVE_ENABLE_PERFORMANCE
+             : VX_DIRECTIVE_DISABLE_PERFORMANCE);
+  if (enable && VX_SUCCESS != status) {
+    VSILOGW("Driver does not support performance counters");
+    return false;
+  }
+  profiling_ = enable;
+  return true;
+}
+
+GraphProfile GraphImpl::GetProfile() {
+  GraphProfile profile;
+  if (!profiling_) {
+    return profile;
+  }
+  auto lock = WaitIdle();
+  vsi_nn_graph_t* graph = nbg_graph_ ? nbg_graph_ : graph_;
+  if (!graph->g) {
+    return profile;
+  }
+
+  vx_perf_t perf;
+  memset(&perf, 0, sizeof(perf));
+  vxQueryGraph(graph->g, VX_GRAPH_PERFORMANCE, &perf, sizeof(perf));
+  profile.total_ns = perf.tmp ? perf.tmp : last_run_ns_;
+
+  std::vector<uint64_t> begins;
+  vsi_nn_node_id_t* order = vsi_nn_SortGraphNode(graph);
+  for (uint32_t i = 0; i < graph->node_num; ++i) {
+    vsi_nn_node_t* node = vsi_nn_GetNode(graph, order ? order[i] : i);
+    std::vector<vx_node> vx_nodes;
+    if (node) {
+      CollectVxNodes(node, vx_nodes);
+    }
+    if (vx_nodes.empty()) {
+      continue;
+    }
+
+    const char* name = vsi_nn_OpGetName(node->op);
+    NodeProfile node_profile{name ? name : "", node->uid, "NATIVE", 0, 0};
+    uint64_t begin = 0;
+    uint64_t longest = 0;
+    for (auto vx_node : vx_nodes) {
+      memset(&perf, 0, sizeof(perf));
+      if (VX_SUCCESS != vxQueryNode(vx_node, VX_NODE_PERFORMANCE, &perf,
+                                    sizeof(perf))) {
+        continue;
+      }
+      node_profile.duration_ns += perf.tmp;
+      if (perf.beg && (!begin || perf.beg < begin)) {
+        begin = perf.beg;
+      }
+      if (perf.tmp >= longest) {
+        longest = perf.tmp;
+        vsi_nn_kernel_type_e type = vsi_nn_kernel_node_type(graph, vx_node);
+        if (VSI_NN_KERNEL_TYPE_NONE != type) {
+          node_profile.kernel_type = vsi_nn_kernel_type_str(type);
+        }
+      }
+    }
+    profile.nodes.push_back(node_profile);
+    begins.push_back(begin);
+  }
+  free(order);
+
+  // Place nodes on the timeline by their start stamps if the driver gives
+  // them, back to back in execution order otherwise.
+  bool has_begin = std::none_of(begins.begin(), begins.end(),
+                                [](uint64_t begin) { return begin == 0; });
+  if (has_begin && !begins.empty()) {
+    uint64_t first = *std::min_element(begins.begin(), begins.end());
+    for (size_t i = 0; i < begins.size(); ++i) {
+      profile.nodes[i].start_ns = begins[i] - first;
+    }
+    std::stable_sort(profile.nodes.begin(), profile.nodes.end(),
+                     [](const NodeProfile& a, const NodeProfile& b) {
+                       return a.start_ns < b.start_ns;
+                     });
+  } else {
+    uint64_t start = 0;
+    for (auto& node_profile : profile.nodes) {
+      node_profile.start_ns = start;
+      start += node_profile.duration_ns;
+    }
+  }
+  return profile;
+}
+
+std::unique_lock<std::mutex> GraphImpl::WaitIdle() {
+  std::unique_lock<std::mutex> lock(run_mutex_);
+  if (pending_run_.valid()) {
+    pending_run_.wait();
+    pending_run_ = std::shared_future<bool>();
+  }
+  return lock;
 }
 
 }  // namespace vx
@@ -25,10 +25,15 @@
 #define TIM_VX_GRAPH_PRIVATE_H_
 #include "tim/vx/graph.h"
 
+#include <atomic>
+#include <future>
+#include <list>
 #include <vector>
 #include <mutex>
 #include <utility>
 #include <map>
+#include <string>
+#include <unordered_map>
 
 #include "tim/vx/tensor.h"
 #include "context_private.h"
@@ -63,23 +68,83 @@ class GraphImpl : public Graph {
    std::shared_ptr<Tensor> CreateTensor(const TensorSpec& spec,
                                        const void* data = nullptr) override;
    std::shared_ptr<Tensor> CreateTensorPlaceHolder() override;
+   std::vector<std::shared_ptr<Tensor>> AddPreProcess(
+       const std::shared_ptr<Tensor>& input,
+       const PreProcessConfig& config) override;
+   std::shared_ptr<Tensor> AddPostProcess(
+       const std::shared_ptr<Tensor>& output,
+       const PostProcessConfig& config) override;
     bool Compile() override;
 
    bool CompileToBinary(void* buf, size_t* size) override;
+   bool CompileWithCache(const std::string& cache_dir,
+                         bool* cache_hit = nullptr) override;
    bool Run() override;
+   std::shared_ptr<RunHandle> RunAsync() override;
+   bool EnableProfiling(bool enable) override;
+   GraphProfile GetProfile() override;
+
+   /// Wait for the pending execution, the returned lock keeps new executions
+   /// from starting until it is released
+   std::unique_lock<std::mutex> WaitIdle();
+
+   /// Follow a handle swap of io tensor `id` in the cached BinaryGraph
+   void SwapIoHandle(vsi_nn_tensor_id_t id, void* handle);
+
+   /// Hash of everything that affects the compiled BinaryGraph
+   uint64_t Hash() const;
+
+   /// Freeze graph with the BinaryGraph compiled from an identical graph
+   bool CompileFromBinary(std::vector<char> binary);
+
+   /// Keep data computed for a constant tensor as long as the graph, for
+   /// transforms creating constants nobody else owns
+   const void* HoldConstData(std::vector<uint8_t> data);
+
+   /// Compilation started, the vx nodes hold the tensors from here on
+   bool IoFrozen() const { return io_frozen_; }
+
+   ContextImpl* context() { return context_; }
+   /// Keep a user of the pooled constant `key` until the graph is released
+   void AddPooledConstant(const ContextImpl::ConstantKey& key);
+   void ReleasePooledConstant(const ContextImpl::ConstantKey& key);
+   /// Stop pooling `key` if this graph holds its only user
+   bool DetachPooledConstant(const ContextImpl::ConstantKey& key);
 
  protected:
+  /// Replace compilation with a cached BinaryGraph sharing the io handles
+  bool LoadBinary(std::vector<char> binary);
+  /// Flush CPU writes to the user buffers bound to input tensors
+  void FlushUserBuffers();
+
+
   ContextImpl* context_;
   vsi_nn_graph_t* graph_;
   std::shared_ptr<Tensor> tensor_placeholder_;
   std::once_flag setio_once_;
   std::once_flag setup_once_;
   std::once_flag verify_graph_once_;
+  /// Graph inputs and outputs were handed to ovxlib
+  std::atomic<bool> io_frozen_{false};
   std::vector<vsi_nn_tensor_id_t> inputs_;
   std::vector<vsi_nn_tensor_id_t> outputs_;
   std::vector<std::shared_ptr<Tensor>> inputs_tensor_;
   std::vector<std::shared_ptr<Tensor>> outputs_tensor_;
-  std::map<std::shared_ptr<Tensor>, std::vector<std::shared_ptr<Operation>>> tensor_consumers_;
+  std::unordered_map<std::shared_ptr<Tensor>,
+                     std::vector<std::shared_ptr<Operation>>>
+      tensor_consumers_;
+  /// Graph wrapping the cached BinaryGraph, runs in place of graph_ if set
+  vsi_nn_graph_t* nbg_graph_{nullptr};
+  std::vector<char> nbg_binary_;
+  /// io tensor id of graph_ to the tensor id sharing its handle in nbg_graph_
+  std::map<vsi_nn_tensor_id_t, vsi_nn_tensor_id_t> nbg_io_;
+  std::mutex run_mutex_;
+  std::shared_future<bool> pending_run_;
+  std::list<std::vector<uint8_t>> const_data_;
+  std::vector<ContextImpl::ConstantKey> pooled_constants_;
+  bool profiling_{false};
+  /// Host-side time of the last Run(), if the graph has no counter
+  uint64_t last_run_ns_{0};
 };
 
 }  // namespace vx
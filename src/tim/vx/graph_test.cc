@@ -25,9 +25,19 @@
 #include "tim/vx/graph.h"
 #include "tim/vx/ops/elementwise.h"
 #include "tim/vx/ops/nbg.h"
+#include "tim/vx/ops/pre_process.h"
+#include "tim/vx/ops/transpose.h"
+#include "tim/vx/profile.h"
+#include "graph_private.h"
+#include "operation_private.h"
 
 #include "gtest/gtest.h"
 
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
 #include <vector>
 
 TEST(graph, gen_binary_graph_with_empty_graph) {
@@ -90,3 +100,337 @@ TEST(graph, gen_binary_graph_with_simple_add) {
     EXPECT_TRUE(nbg_out->CopyDataFromTensor(&output));
     EXPECT_EQ(output, expected_out);
 }
+
+namespace {
+void BuildSimpleAddGraph(std::shared_ptr<tim::vx::Graph>& graph, bool with_mul,
+                         std::shared_ptr<tim::vx::Tensor>& input,
+                         std::shared_ptr<tim::vx::Tensor>& output) {
+    tim::vx::ShapeType io_shape({1,1,1,1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::CONSTANT);
+    float one = 1.0f;
+    input = graph->CreateTensor(input_spec);
+    output = graph->CreateTensor(output_spec);
+    auto const_t = graph->CreateTensor(const_spec, &one);
+
+    if (with_mul) {
+        auto mul = graph->CreateOperation<tim::vx::ops::Multiply>();
+        (*mul).BindInputs({input, const_t}).BindOutputs({output});
+    } else {
+        auto add = graph->CreateOperation<tim::vx::ops::Add>();
+        (*add).BindInputs({input, const_t}).BindOutputs({output});
+    }
+}
+
+// Fresh cache directory, removed with everything stored in it
+struct ScopedCacheDir {
+    ScopedCacheDir() {
+        std::string tmpl = ::testing::TempDir() + "tim_vx_graph_cache_XXXXXX";
+        std::vector<char> dir(tmpl.begin(), tmpl.end());
+        dir.push_back('\0');
+        if (mkdtemp(dir.data())) {
+            path = dir.data();
+        }
+    }
+    ~ScopedCacheDir() {
+        if (path.empty()) {
+            return;
+        }
+        if (DIR* d = opendir(path.c_str())) {
+            while (struct dirent* entry = readdir(d)) {
+                std::string name(entry->d_name);
+                if (name != "." && name != "..") {
+                    unlink((path + "/" + name).c_str());
+                }
+            }
+            closedir(d);
+        }
+        rmdir(path.c_str());
+    }
+    std::string path;
+};
+}  // namespace
+
+TEST(graph, compile_with_cache) {
+    ScopedCacheDir dir;
+    ASSERT_FALSE(dir.path.empty());
+    const std::string& cache_dir = dir.path;
+
+    auto ctx = tim::vx::Context::Create();
+    float in = 2.0f;
+    float expected_out = 3.0f;
+    std::shared_ptr<tim::vx::Tensor> input, output;
+
+    auto graph = ctx->CreateGraph();
+    BuildSimpleAddGraph(graph, false, input, output);
+    bool cache_hit = true;
+    EXPECT_TRUE(graph->CompileWithCache(cache_dir, &cache_hit));
+    EXPECT_FALSE(cache_hit) << "Cache directory is empty";
+
+    // Same graph built again loads the binary graph from cache
+    auto cached_graph = ctx->CreateGraph();
+    BuildSimpleAddGraph(cached_graph, false, input, output);
+    EXPECT_TRUE(cached_graph->CompileWithCache(cache_dir, &cache_hit));
+    EXPECT_TRUE(cache_hit);
+
+    EXPECT_TRUE(input->CopyDataToTensor(&in, sizeof(in)));
+    EXPECT_TRUE(cached_graph->Run());
+    float out = 0.0f;
+    EXPECT_TRUE(output->CopyDataFromTensor(&out));
+    EXPECT_EQ(out, expected_out);
+
+    // Different graph doesn't hit the cache
+    auto other_graph = ctx->CreateGraph();
+    BuildSimpleAddGraph(other_graph, true, input, output);
+    EXPECT_TRUE(other_graph->CompileWithCache(cache_dir, &cache_hit));
+    EXPECT_FALSE(cache_hit);
+
+    EXPECT_TRUE(input->CopyDataToTensor(&in, sizeof(in)));
+    EXPECT_TRUE(other_graph->Run());
+    EXPECT_TRUE(output->CopyDataFromTensor(&out));
+    EXPECT_EQ(out, in);
+}
+
+TEST(graph, hash_param_array_content) {
+    auto ctx = tim::vx::Context::Create();
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {2, 2}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {2, 2}, tim::vx::TensorAttribute::OUTPUT);
+    auto hash = [&](const std::vector<uint32_t>& perm) {
+        auto graph = ctx->CreateGraph();
+        auto transpose = graph->CreateOperation<tim::vx::ops::Transpose>(perm);
+        transpose->BindInputs({graph->CreateTensor(input_spec)})
+            .BindOutputs({graph->CreateTensor(output_spec)});
+        return std::static_pointer_cast<tim::vx::GraphImpl>(graph)->Hash();
+    };
+
+    // The op's copy of perm lives at a different address in each graph
+    EXPECT_EQ(hash({1, 0}), hash({1, 0}));
+    EXPECT_NE(hash({1, 0}), hash({0, 1}));
+}
+
+TEST(graph, hash_pre_process_cwhn) {
+    auto ctx = tim::vx::Context::Create();
+    tim::vx::PreProcessConfig config;
+    config.format = tim::vx::ImageFormat::RGB;
+    config.width = 4;
+    config.height = 2;
+    config.layout = tim::vx::DataLayout::CWHN;
+    auto build = [&](const std::vector<uint32_t>& output_shape) {
+        auto graph = ctx->CreateGraph();
+        auto op = graph->CreateOperation<tim::vx::ops::PreProcess>(config, output_shape);
+        tim::vx::TensorSpec frame_spec(tim::vx::DataType::UINT8,
+            tim::vx::ops::PreProcess::InputShapes(config)[0], tim::vx::TensorAttribute::INPUT);
+        tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, output_shape,
+            tim::vx::TensorAttribute::OUTPUT);
+        op->BindInputs({graph->CreateTensor(frame_spec)})
+            .BindOutputs({graph->CreateTensor(output_spec)});
+        return graph;
+    };
+    auto hash = [](const std::shared_ptr<tim::vx::Graph>& graph) {
+        return std::static_pointer_cast<tim::vx::GraphImpl>(graph)->Hash();
+    };
+
+    auto graph = build({3, 4, 2, 1});
+    uint64_t before_setup = hash(graph);
+    size_t size = 0;
+    // Sets the graph up, ovxlib rewrites the output size to WHCN in place
+    graph->CompileToBinary(nullptr, &size);
+    EXPECT_EQ(hash(graph), before_setup);
+    EXPECT_NE(hash(build({3, 2, 4, 1})), before_setup);
+}
+
+TEST(graph, run_async) {
+    auto ctx = tim::vx::Context::Create();
+    std::shared_ptr<tim::vx::Tensor> input, output;
+    auto graph = ctx->CreateGraph();
+    BuildSimpleAddGraph(graph, false, input, output);
+    EXPECT_TRUE(graph->Compile());
+
+    float expected_out[] = {2.0f, 3.0f};
+    for (float in : {1.0f, 2.0f}) {
+        EXPECT_TRUE(input->CopyDataToTensor(&in, sizeof(in)));
+        auto handle = graph->RunAsync();
+        ASSERT_NE(handle, nullptr);
+        EXPECT_TRUE(handle->Wait());
+        EXPECT_TRUE(handle->IsReady());
+        EXPECT_TRUE(handle->WaitFor(0));
+
+        float out = 0.0f;
+        EXPECT_TRUE(output->CopyDataFromTensor(&out));
+        EXPECT_EQ(out, expected_out[static_cast<int>(in) - 1]);
+    }
+
+    // Copying output waits for a pending execution
+    float in = 5.0f;
+    EXPECT_TRUE(input->CopyDataToTensor(&in, sizeof(in)));
+    auto handle = graph->RunAsync();
+    float out = 0.0f;
+    EXPECT_TRUE(output->CopyDataFromTensor(&out));
+    EXPECT_TRUE(handle->IsReady());
+    EXPECT_TRUE(handle->Wait());
+    EXPECT_EQ(out, 6.0f);
+}
+
+TEST(graph, profiling) {
+    auto ctx = tim::vx::Context::Create();
+    std::shared_ptr<tim::vx::Tensor> input, output;
+    auto graph = ctx->CreateGraph();
+    BuildSimpleAddGraph(graph, false, input, output);
+    EXPECT_TRUE(graph->GetProfile().nodes.empty());
+    ASSERT_TRUE(graph->EnableProfiling(true));
+    EXPECT_TRUE(graph->Compile());
+
+    float in = 1.0f;
+    EXPECT_TRUE(input->CopyDataToTensor(&in, sizeof(in)));
+    EXPECT_TRUE(graph->Run());
+
+    auto profile = graph->GetProfile();
+    ASSERT_EQ(profile.nodes.size(), 1u);
+    EXPECT_EQ(profile.nodes[0].op_type, "ADD");
+    EXPECT_FALSE(profile.nodes[0].kernel_type.empty());
+    EXPECT_GT(profile.total_ns, 0u);
+
+    auto histogram = profile.Histogram();
+    ASSERT_EQ(histogram.size(), 1u);
+    EXPECT_EQ(histogram[0].count, 1u);
+    EXPECT_EQ(histogram[0].total_ns, profile.nodes[0].duration_ns);
+}
+
+TEST(graph, profile_histogram_and_chrome_trace) {
+    tim::vx::GraphProfile profile;
+    profile.total_ns = 5000;
+    profile.nodes = {{"CONV2D", 0, "NATIVE", 0, 1500},
+                     {"RELU", 1, "EVIS", 1500, 250},
+                     {"CONV2D", 2, "NATIVE", 1750, 2500},
+                     {"SOFTMAX", 3, "CL", 4250, 750}};
+
+    auto histogram = profile.Histogram();
+    ASSERT_EQ(histogram.size(), 3u);
+    EXPECT_EQ(histogram[0].op_type, "CONV2D");
+    EXPECT_EQ(histogram[0].count, 2u);
+    EXPECT_EQ(histogram[0].total_ns, 4000u);
+    EXPECT_EQ(histogram[1].op_type, "SOFTMAX");
+    EXPECT_EQ(histogram[2].op_type, "RELU");
+
+    auto trace = profile.ToChromeTrace();
+    EXPECT_EQ(trace.find("{\"traceEvents\":["), 0u);
+    EXPECT_NE(trace.find("{\"name\":\"RELU\",\"cat\":\"EVIS\",\"ph\":\"X\","
+                         "\"pid\":0,\"tid\":0,\"ts\":1.500,\"dur\":0.250,"
+                         "\"args\":{\"uid\":1,\"kernel\":\"EVIS\"}}"),
+              std::string::npos);
+    EXPECT_NE(trace.find("\"total_us\":5.000"), std::string::npos);
+}
+
+TEST(graph, add_pre_process_nv12) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType image_shape({4, 4, 3, 1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, image_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, image_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto other_input = graph->CreateTensor(input_spec);
+    auto image = graph->CreateTensor(input_spec);
+    auto output = graph->CreateTensor(output_spec);
+    auto add = graph->CreateOperation<tim::vx::ops::Add>();
+    (*add).BindInputs({other_input, image}).BindOutputs({output});
+
+    tim::vx::PreProcessConfig gray;
+    gray.format = tim::vx::ImageFormat::GRAY;
+    gray.width = 8;
+    gray.height = 6;
+    EXPECT_TRUE(graph->AddPreProcess(image, gray).empty()) << "Gray frames need a 1 channel input";
+
+    tim::vx::PreProcessConfig nv12;
+    nv12.format = tim::vx::ImageFormat::NV12;
+    nv12.width = 8;
+    nv12.height = 6;
+    nv12.crop_left = 6;
+    nv12.crop_width = 4;
+    EXPECT_TRUE(graph->AddPreProcess(image, nv12).empty()) << "Crop outside of the frame";
+
+    nv12.crop_left = 2;
+    nv12.mean = {{127.5f, 127.5f, 127.5f}};
+    nv12.scale = 1.0f / 127.5f;
+    auto frames = graph->AddPreProcess(image, nv12);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0]->GetShape(), tim::vx::ShapeType({8, 6, 1, 1}));
+    EXPECT_EQ(frames[1]->GetShape(), tim::vx::ShapeType({8, 3, 1, 1}));
+    EXPECT_EQ(frames[0]->GetDataType(), tim::vx::DataType::UINT8);
+    EXPECT_EQ(image->GetSpec().attr_, tim::vx::TensorAttribute::TRANSIENT);
+
+    // The planes take the place of the image in the graph inputs
+    auto inputs = graph->InputsTensor();
+    ASSERT_EQ(inputs.size(), 3u);
+    EXPECT_EQ(inputs[0], other_input);
+    EXPECT_EQ(inputs[1], frames[0]);
+    EXPECT_EQ(inputs[2], frames[1]);
+
+    EXPECT_TRUE(graph->AddPreProcess(image, nv12).empty()) << "Image is no graph input any more";
+}
+
+TEST(graph, add_post_process) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({2, 3, 4, 1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input = graph->CreateTensor(input_spec);
+    auto output0 = graph->CreateTensor(output_spec);
+    auto output1 = graph->CreateTensor(output_spec);
+    graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({input, input}).BindOutputs({output0});
+    graph->CreateOperation<tim::vx::ops::Multiply>()->BindInputs({input, input}).BindOutputs({output1});
+
+    tim::vx::PostProcessConfig config;
+    config.perm = {2, 0, 0, 3};
+    EXPECT_EQ(graph->AddPostProcess(output0, config), nullptr) << "Perm is no permutation";
+
+    config.perm = {2, 0, 1, 3};
+    config.datatype = tim::vx::DataType::FLOAT16;
+    auto converted = graph->AddPostProcess(output0, config);
+    ASSERT_NE(converted, nullptr);
+    EXPECT_EQ(converted->GetShape(), tim::vx::ShapeType({4, 2, 3, 1}));
+    EXPECT_EQ(converted->GetDataType(), tim::vx::DataType::FLOAT16);
+    EXPECT_EQ(output0->GetSpec().attr_, tim::vx::TensorAttribute::TRANSIENT);
+
+    auto outputs = graph->OutputsTensor();
+    ASSERT_EQ(outputs.size(), 2u);
+    EXPECT_EQ(outputs[0], converted);
+    EXPECT_EQ(outputs[1], output1);
+    EXPECT_EQ(graph->AddPostProcess(input, config), nullptr) << "Input is no graph output";
+}
+
+TEST(graph, pre_process_rgb) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType image_shape({2, 1, 3, 1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, image_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, image_shape, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, {1, 1, 1, 1}, tim::vx::TensorAttribute::CONSTANT);
+    float zero = 0.0f;
+    auto image = graph->CreateTensor(input_spec);
+    auto output = graph->CreateTensor(output_spec);
+    auto const_t = graph->CreateTensor(const_spec, &zero);
+    graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({image, const_t}).BindOutputs({output});
+
+    tim::vx::PreProcessConfig config;
+    config.format = tim::vx::ImageFormat::RGB;
+    config.width = 2;
+    config.height = 1;
+    config.mean = {{10.0f, 20.0f, 30.0f}};
+    config.scale = 0.5f;
+    auto frames = graph->AddPreProcess(image, config);
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_TRUE(graph->Compile());
+
+    // Interleaved RGB pixels to normalized planes
+    std::vector<uint8_t> rgb = {30, 40, 50, 70, 80, 90};
+    std::vector<float> expected_out = {10, 30, 10, 30, 10, 30};
+    EXPECT_TRUE(frames[0]->CopyDataToTensor(rgb.data(), rgb.size()));
+    EXPECT_TRUE(graph->Run());
+    std::vector<float> out(expected_out.size());
+    EXPECT_TRUE(output->CopyDataFromTensor(out.data()));
+    EXPECT_EQ(out, expected_out);
+}
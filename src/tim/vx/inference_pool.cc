@@ -0,0 +1,264 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/inference_pool.h"
+
+#include <map>
+
+#include "graph_private.h"
+#include "inference_pool_private.h"
+#include "operation_private.h"
+#include "tim/vx/context.h"
+#include "tim/vx/operation.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+
+namespace {
+constexpr size_t kMaxPendingRequests = 1024;
+
+using TensorMap = std::map<std::shared_ptr<Tensor>, std::shared_ptr<Tensor>>;
+
+// Rebuild `src` in `dst` with Operation::Clone. Graph io tensors are created
+// first, in the same order, so that every clone has the io layout of `src`.
+void CloneGraph(const std::shared_ptr<Graph>& src, std::shared_ptr<Graph>& dst,
+                TensorMap& tensor_map) {
+  for (const auto& input : src->InputsTensor()) {
+    tensor_map[input] = dst->CreateTensor(input->GetSpec());
+  }
+  for (const auto& output : src->OutputsTensor()) {
+    tensor_map[output] = dst->CreateTensor(output->GetSpec());
+  }
+
+  auto map_tensor = [&dst, &tensor_map](const std::shared_ptr<Tensor>& t) {
+    auto it = tensor_map.find(t);
+    if (it != tensor_map.end()) {
+      return it->second;
+    }
+    std::shared_ptr<Tensor> cloned;
+    if (t->IsPlaceHolder()) {
+      cloned = dst->CreateTensorPlaceHolder();
+    } else if (t->IsConstTensor()) {
+      cloned = dst->CreateTensor(t->GetSpec(), t->GetDataRef());
+    } else {
+      cloned = dst->CreateTensor(t->GetSpec());
+    }
+    tensor_map[t] = cloned;
+    return cloned;
+  };
+
+  // ovxlib sorts the nodes at setup, creation order is good enough here
+  for (const auto& op : src->OpVector()) {
+    auto cloned_op = op->Clone(dst);
+    for (const auto& input : op->impl()->InputsTensor()) {
+      cloned_op->BindInput(map_tensor(input));
+    }
+    for (const auto& output : op->impl()->OutputsTensor()) {
+      cloned_op->BindOutput(map_tensor(output));
+    }
+  }
+}
+
+size_t TensorBytes(const std::shared_ptr<Graph>& graph,
+                   const std::shared_ptr<Tensor>& tensor) {
+  auto graph_impl = std::static_pointer_cast<GraphImpl>(graph);
+  vsi_nn_tensor_t* t = vsi_nn_GetTensor(graph_impl->graph(), tensor->GetId());
+  if (!t) {
+    return 0;
+  }
+  return vsi_nn_GetTensorSize(t->attr.size, t->attr.dim_num,
+                              t->attr.dtype.vx_type);
+}
+}  // namespace
+
+std::shared_ptr<InferencePool> InferencePool::Create(
+    const std::shared_ptr<Context>& context,
+    const std::shared_ptr<Graph>& graph, uint32_t instance_num,
+    uint32_t thread_num) {
+  auto pool = std::make_shared<InferencePoolImpl>();
+  if (!pool->Init(context, graph, instance_num, thread_num)) {
+    return nullptr;
+  }
+  return pool;
+}
+
+InferencePoolImpl::InferencePoolImpl()
+    : free_instances_(kMaxPendingRequests), requests_(kMaxPendingRequests) {}
+
+InferencePoolImpl::~InferencePoolImpl() {
+  stop_.store(true);
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cond_.notify_all();
+  }
+  // Workers drain the queued requests before they exit
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+bool InferencePoolImpl::Init(const std::shared_ptr<Context>& context,
+                             const std::shared_ptr<Graph>& graph,
+                             uint32_t instance_num, uint32_t thread_num) {
+  if (!context || !graph || instance_num == 0 ||
+      instance_num > free_instances_.Capacity()) {
+    VSILOGE("Invalid inference pool arguments");
+    return false;
+  }
+
+  std::vector<char> binary;
+  for (uint32_t i = 0; i < instance_num; ++i) {
+    std::unique_ptr<Instance> instance(new Instance);
+    instance->graph = context->CreateGraph();
+    TensorMap tensor_map;
+    CloneGraph(graph, instance->graph, tensor_map);
+    for (const auto& input : graph->InputsTensor()) {
+      instance->inputs.push_back(tensor_map[input]);
+      instance->input_bytes.push_back(
+          TensorBytes(instance->graph, tensor_map[input]));
+    }
+    for (const auto& output : graph->OutputsTensor()) {
+      instance->outputs.push_back(tensor_map[output]);
+      instance->output_bytes.push_back(
+          TensorBytes(instance->graph, tensor_map[output]));
+    }
+
+    if (i == 0) {
+      // Compile the model once, the other instances load the BinaryGraph
+      size_t size = 0;
+      if (instance->graph->CompileToBinary(nullptr, &size) && size > 0) {
+        binary.resize(size);
+        if (!instance->graph->CompileToBinary(binary.data(), &size)) {
+          binary.clear();
+        }
+      }
+      if (!instance->graph->Compile()) {
+        VSILOGE("Compile inference pool instance fail");
+        return false;
+      }
+    } else {
+      auto graph_impl = std::static_pointer_cast<GraphImpl>(instance->graph);
+      if (!graph_impl->CompileFromBinary(binary)) {
+        VSILOGW("Load BinaryGraph fail, compile instance %u", i);
+        if (!instance->graph->Compile()) {
+          VSILOGE("Compile inference pool instance fail");
+          return false;
+        }
+      }
+    }
+    free_instances_.TryPush(instance.get());
+    instances_.push_back(std::move(instance));
+  }
+
+  if (thread_num == 0) {
+    thread_num = instance_num;
+  }
+  for (uint32_t i = 0; i < thread_num; ++i) {
+    workers_.emplace_back(&InferencePoolImpl::Worker, this);
+  }
+  return true;
+}
+
+std::future<InferencePool::Buffers> InferencePoolImpl::Submit(Buffers inputs) {
+  auto request = new Request;
+  request->inputs = std::move(inputs);
+  auto result = request->result.get_future();
+  while (!requests_.TryPush(request)) {
+    std::this_thread::yield();
+  }
+  // Pairs with the increment of sleeping_ in NextRequest(): either the
+  // worker sees the request or this sees the sleeping worker.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cond_.notify_one();
+  }
+  return result;
+}
+
+InferencePoolImpl::Request* InferencePoolImpl::NextRequest() {
+  Request* request = nullptr;
+  if (requests_.TryPop(&request)) {
+    return request;
+  }
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  sleeping_.fetch_add(1);
+  while (!requests_.TryPop(&request)) {
+    if (stop_.load()) {
+      request = nullptr;
+      break;
+    }
+    sleep_cond_.wait(lock);
+  }
+  sleeping_.fetch_sub(1);
+  return request;
+}
+
+void InferencePoolImpl::Worker() {
+  while (Request* request = NextRequest()) {
+    // More workers than instances wait here for one to be given back
+    Instance* instance = nullptr;
+    while (!free_instances_.TryPop(&instance)) {
+      std::this_thread::yield();
+    }
+    Buffers outputs;
+    if (!Execute(instance, request->inputs, &outputs)) {
+      outputs.clear();
+    }
+    free_instances_.TryPush(instance);
+    request->result.set_value(std::move(outputs));
+    delete request;
+  }
+}
+
+bool InferencePoolImpl::Execute(Instance* instance, const Buffers& inputs,
+                                Buffers* outputs) {
+  if (inputs.size() != instance->inputs.size()) {
+    VSILOGE("Expect %zu inputs, got %zu", instance->inputs.size(),
+            inputs.size());
+    return false;
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (inputs[i].size() != instance->input_bytes[i] ||
+        !instance->inputs[i]->CopyDataToTensor(inputs[i].data(),
+                                               inputs[i].size())) {
+      VSILOGE("Copy input %zu fail", i);
+      return false;
+    }
+  }
+  if (!instance->graph->Run()) {
+    return false;
+  }
+  outputs->resize(instance->outputs.size());
+  for (size_t i = 0; i < instance->outputs.size(); ++i) {
+    (*outputs)[i].resize(instance->output_bytes[i]);
+    if (!instance->outputs[i]->CopyDataFromTensor((*outputs)[i].data())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,87 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_INFERENCE_POOL_PRIVATE_H_
+#define TIM_VX_INFERENCE_POOL_PRIVATE_H_
+#include "tim/vx/inference_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "mpmc_queue.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/tensor.h"
+
+namespace tim {
+namespace vx {
+
+class InferencePoolImpl : public InferencePool {
+ public:
+  InferencePoolImpl();
+  ~InferencePoolImpl();
+
+  /// Clone and compile the instances, start the workers
+  bool Init(const std::shared_ptr<Context>& context,
+            const std::shared_ptr<Graph>& graph, uint32_t instance_num,
+            uint32_t thread_num);
+
+  std::future<Buffers> Submit(Buffers inputs) override;
+  uint32_t InstanceNum() const override { return instances_.size(); }
+  uint32_t ThreadNum() const override { return workers_.size(); }
+
+ protected:
+  struct Instance {
+    std::shared_ptr<Graph> graph;
+    std::vector<std::shared_ptr<Tensor>> inputs;
+    std::vector<std::shared_ptr<Tensor>> outputs;
+    std::vector<size_t> input_bytes;
+    std::vector<size_t> output_bytes;
+  };
+
+  struct Request {
+    Buffers inputs;
+    std::promise<Buffers> result;
+  };
+
+  void Worker();
+  /// Pop a request, sleep while there is none, return nullptr on shutdown
+  Request* NextRequest();
+  bool Execute(Instance* instance, const Buffers& inputs, Buffers* outputs);
+
+  std::vector<std::unique_ptr<Instance>> instances_;
+  MpmcQueue<Instance*> free_instances_;
+  MpmcQueue<Request*> requests_;
+  std::vector<std::thread> workers_;
+  std::atomic<bool> stop_{false};
+  /// Workers are only put to sleep when the request queue is empty
+  std::atomic<uint32_t> sleeping_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cond_;
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_INFERENCE_POOL_PRIVATE_H_ */
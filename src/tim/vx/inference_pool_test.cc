@@ -0,0 +1,176 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/inference_pool.h"
+#include "tim/vx/ops/elementwise.h"
+#include "mpmc_queue.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+
+TEST(mpmc_queue, push_pop_in_order) {
+    tim::vx::MpmcQueue<int> queue(3);
+    EXPECT_EQ(queue.Capacity(), 4u);
+
+    int value = -1;
+    EXPECT_FALSE(queue.TryPop(&value));
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.TryPush(i));
+    }
+    EXPECT_FALSE(queue.TryPush(4)) << "Queue is full";
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.TryPop(&value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.TryPop(&value));
+}
+
+TEST(mpmc_queue, multi_producer_multi_consumer) {
+    const int thread_num = 4;
+    const int item_num = 20000;
+    tim::vx::MpmcQueue<int> queue(64);
+    std::atomic<long long> sum(0);
+    std::atomic<int> popped(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_num; ++t) {
+        threads.emplace_back([&queue, t]() {
+            for (int i = 1; i <= item_num; ++i) {
+                while (!queue.TryPush(t * item_num + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&queue, &sum, &popped]() {
+            int value;
+            while (popped.load() < thread_num * item_num) {
+                if (queue.TryPop(&value)) {
+                    sum += value;
+                    ++popped;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    long long n = thread_num * item_num;
+    EXPECT_EQ(sum.load(), n * (n + 1) / 2);
+}
+
+namespace {
+std::shared_ptr<tim::vx::Graph> BuildAddOneGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx) {
+    tim::vx::ShapeType io_shape({4, 1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::CONSTANT);
+    static const float one[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+
+    auto graph = ctx->CreateGraph();
+    auto input = graph->CreateTensor(input_spec);
+    auto output = graph->CreateTensor(output_spec);
+    auto const_t = graph->CreateTensor(const_spec, one);
+    auto add = graph->CreateOperation<tim::vx::ops::Add>();
+    (*add).BindInputs({input, const_t}).BindOutputs({output});
+    return graph;
+}
+
+tim::vx::InferencePool::Buffers MakeInput(float value) {
+    std::vector<float> data(4, value);
+    tim::vx::InferencePool::Buffers inputs(1);
+    inputs[0].resize(data.size() * sizeof(float));
+    memcpy(inputs[0].data(), data.data(), inputs[0].size());
+    return inputs;
+}
+}  // namespace
+
+TEST(inference_pool, submit_from_many_threads) {
+    auto ctx = tim::vx::Context::Create();
+    auto model = BuildAddOneGraph(ctx);
+    auto pool = tim::vx::InferencePool::Create(ctx, model, 2, 3);
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(pool->InstanceNum(), 2u);
+    EXPECT_EQ(pool->ThreadNum(), 3u);
+
+    const int client_num = 4;
+    const int request_num = 25;
+    std::atomic<int> mismatch(0);
+    std::vector<std::thread> clients;
+    for (int c = 0; c < client_num; ++c) {
+        clients.emplace_back([&pool, &mismatch, c]() {
+            std::vector<std::future<tim::vx::InferencePool::Buffers>> results;
+            for (int r = 0; r < request_num; ++r) {
+                results.push_back(pool->Submit(MakeInput(c * 100.0f + r)));
+            }
+            for (int r = 0; r < request_num; ++r) {
+                auto outputs = results[r].get();
+                if (outputs.size() != 1 ||
+                    outputs[0].size() != 4 * sizeof(float)) {
+                    ++mismatch;
+                    continue;
+                }
+                const float* out =
+                    reinterpret_cast<const float*>(outputs[0].data());
+                for (int i = 0; i < 4; ++i) {
+                    if (out[i] != c * 100.0f + r + 1.0f) {
+                        ++mismatch;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    EXPECT_EQ(mismatch.load(), 0);
+}
+
+TEST(inference_pool, reject_wrong_inputs) {
+    auto ctx = tim::vx::Context::Create();
+    auto model = BuildAddOneGraph(ctx);
+    auto pool = tim::vx::InferencePool::Create(ctx, model, 1);
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(pool->ThreadNum(), 1u);
+
+    tim::vx::InferencePool::Buffers short_input(1, std::vector<uint8_t>(3));
+    EXPECT_TRUE(pool->Submit(short_input).get().empty());
+    EXPECT_TRUE(pool->Submit({}).get().empty());
+    EXPECT_EQ(pool->Submit(MakeInput(1.0f)).get().size(), 1u);
+}
+
+TEST(inference_pool, invalid_arguments) {
+    auto ctx = tim::vx::Context::Create();
+    auto model = BuildAddOneGraph(ctx);
+    EXPECT_EQ(tim::vx::InferencePool::Create(ctx, model, 0), nullptr);
+    EXPECT_EQ(tim::vx::InferencePool::Create(ctx, nullptr, 1), nullptr);
+}
@@ -0,0 +1,129 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef _VSI_NN_KERNEL_CPU_COMPUTE_H
+#define _VSI_NN_KERNEL_CPU_COMPUTE_H
+
+/*
+ * Multi-threaded compute routines shared by the cpu kernels.
+ * They work on plain host buffers so they can also be benchmarked
+ * without a device.
+ */
+
+#include <stdint.h>
+#include "vsi_nn_types.h"
+
+#if defined(__cplusplus)
+extern "C"{
+#endif
+
+/**
+ * Matrix multiply
+ * c(M x N) = a(M x K) * b(K x N), all row major. If trans_a is set a is
+ * stored as K x M, if trans_b is set b is stored as N x K.
+ */
+OVXLIB_API void vsi_nn_kernel_cpu_matmul_f32
+    (
+    const float * a,
+    const float * b,
+    float       * c,
+    vsi_size_t    M,
+    vsi_size_t    K,
+    vsi_size_t    N,
+    vsi_bool      trans_a,
+    vsi_bool      trans_b
+    );
+
+/**
+ * Bilinear resize
+ * Resize `planes` planes of in_w x in_h to out_w x out_h.
+ */
+OVXLIB_API void vsi_nn_kernel_cpu_resize_bilinear_f32
+    (
+    const float * in,
+    float       * out,
+    vsi_size_t    in_w,
+    vsi_size_t    in_h,
+    vsi_size_t    out_w,
+    vsi_size_t    out_h,
+    vsi_size_t    planes,
+    vsi_bool      align_corners,
+    vsi_bool      half_pixel_centers
+    );
+
+/**
+ * Gather
+ * For each of block_num outer blocks copy the indices_num inner blocks of
+ * block_size elements selected by `indices` out of axis_num. Elements are
+ * element_bytes wide.
+ *
+ * @return VSI_FAILURE if an index is out of range, VSI_SUCCESS otherwise.
+ */
+OVXLIB_API vsi_status vsi_nn_kernel_cpu_gather
+    (
+    const void     * in,
+    vsi_size_t       in_elements,
+    const uint32_t * indices,
+    vsi_size_t       indices_num,
+    vsi_size_t       block_size,
+    vsi_size_t       block_num,
+    vsi_size_t       axis_num,
+    vsi_size_t       element_bytes,
+    void           * out
+    );
+
+/**
+ * Scatter add
+ * out[offsets[i] + j] += updates[i * block_size + j], updates with a
+ * negative offset are skipped. Accumulation order matches a serial loop.
+ */
+OVXLIB_API void vsi_nn_kernel_cpu_scatter_add_f32
+    (
+    const float       * updates,
+    const vsi_ssize_t * offsets,
+    vsi_size_t          indices_num,
+    vsi_size_t          block_size,
+    float             * out
+    );
+
+/**
+ * Top k
+ * Find the k largest values of each row in descending order, ties are
+ * ordered by index. Each row of the outputs holds k entries, those past
+ * row_len are -FLT_MAX with index 0.
+ */
+OVXLIB_API void vsi_nn_kernel_cpu_topk_f32
+    (
+    const float * in,
+    vsi_size_t    rows,
+    vsi_size_t    row_len,
+    uint32_t      k,
+    float       * values,
+    uint32_t    * indices
+    );
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
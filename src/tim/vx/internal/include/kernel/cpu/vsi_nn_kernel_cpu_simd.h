@@ -0,0 +1,182 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef _VSI_NN_KERNEL_CPU_SIMD_H
+#define _VSI_NN_KERNEL_CPU_SIMD_H
+
+/*
+ * Small SIMD helpers for cpu kernels.
+ * AVX2 is used when the build enables it (-mavx2 -mfma), otherwise SSE2 on
+ * x86 and NEON on arm, with a scalar fallback for other targets and tails.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define VSI_NN_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VSI_NN_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VSI_NN_SIMD_NEON
+#endif
+
+#if defined(__cplusplus)
+extern "C"{
+#endif
+
+/* y[i] += a * x[i] */
+static inline void vsi_nn_simd_axpy_f32
+    (
+    float       * y,
+    const float * x,
+    float         a,
+    size_t        n
+    )
+{
+    size_t i = 0;
+#if defined(VSI_NN_SIMD_AVX2)
+    __m256 va = _mm256_set1_ps( a );
+    for( ; i + 8 <= n; i += 8 )
+    {
+        _mm256_storeu_ps( y + i, _mm256_fmadd_ps( va, _mm256_loadu_ps( x + i ),
+            _mm256_loadu_ps( y + i ) ) );
+    }
+#elif defined(VSI_NN_SIMD_SSE2)
+    __m128 va = _mm_set1_ps( a );
+    for( ; i + 4 <= n; i += 4 )
+    {
+        _mm_storeu_ps( y + i, _mm_add_ps( _mm_loadu_ps( y + i ),
+            _mm_mul_ps( va, _mm_loadu_ps( x + i ) ) ) );
+    }
+#elif defined(VSI_NN_SIMD_NEON)
+    float32x4_t va = vdupq_n_f32( a );
+    for( ; i + 4 <= n; i += 4 )
+    {
+        vst1q_f32( y + i, vmlaq_f32( vld1q_f32( y + i ), va, vld1q_f32( x + i ) ) );
+    }
+#endif
+    for( ; i < n; i++ )
+    {
+        y[i] += a * x[i];
+    }
+} /* vsi_nn_simd_axpy_f32() */
+
+/* sum(a[i] * b[i]) */
+static inline float vsi_nn_simd_dot_f32
+    (
+    const float * a,
+    const float * b,
+    size_t        n
+    )
+{
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(VSI_NN_SIMD_AVX2)
+    __m256 acc = _mm256_setzero_ps();
+    __m128 acc4;
+    for( ; i + 8 <= n; i += 8 )
+    {
+        acc = _mm256_fmadd_ps( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ), acc );
+    }
+    acc4 = _mm_add_ps( _mm256_castps256_ps128( acc ), _mm256_extractf128_ps( acc, 1 ) );
+    acc4 = _mm_add_ps( acc4, _mm_movehl_ps( acc4, acc4 ) );
+    acc4 = _mm_add_ss( acc4, _mm_shuffle_ps( acc4, acc4, 1 ) );
+    sum = _mm_cvtss_f32( acc4 );
+#elif defined(VSI_NN_SIMD_SSE2)
+    __m128 acc = _mm_setzero_ps();
+    for( ; i + 4 <= n; i += 4 )
+    {
+        acc = _mm_add_ps( acc, _mm_mul_ps( _mm_loadu_ps( a + i ), _mm_loadu_ps( b + i ) ) );
+    }
+    acc = _mm_add_ps( acc, _mm_movehl_ps( acc, acc ) );
+    acc = _mm_add_ss( acc, _mm_shuffle_ps( acc, acc, 1 ) );
+    sum = _mm_cvtss_f32( acc );
+#elif defined(VSI_NN_SIMD_NEON)
+    float32x4_t acc = vdupq_n_f32( 0.0f );
+    float32x2_t acc2;
+    for( ; i + 4 <= n; i += 4 )
+    {
+        acc = vmlaq_f32( acc, vld1q_f32( a + i ), vld1q_f32( b + i ) );
+    }
+    acc2 = vadd_f32( vget_low_f32( acc ), vget_high_f32( acc ) );
+    sum = vget_lane_f32( vpadd_f32( acc2, acc2 ), 0 );
+#endif
+    for( ; i < n; i++ )
+    {
+        sum += a[i] * b[i];
+    }
+    return sum;
+} /* vsi_nn_simd_dot_f32() */
+
+/* dst[i] = a[i] * wa + b[i] * wb */
+static inline void vsi_nn_simd_blend_f32
+    (
+    float       * dst,
+    const float * a,
+    const float * b,
+    float         wa,
+    float         wb,
+    size_t        n
+    )
+{
+    size_t i = 0;
+#if defined(VSI_NN_SIMD_AVX2)
+    __m256 vwa = _mm256_set1_ps( wa );
+    __m256 vwb = _mm256_set1_ps( wb );
+    for( ; i + 8 <= n; i += 8 )
+    {
+        _mm256_storeu_ps( dst + i, _mm256_fmadd_ps( _mm256_loadu_ps( b + i ), vwb,
+            _mm256_mul_ps( _mm256_loadu_ps( a + i ), vwa ) ) );
+    }
+#elif defined(VSI_NN_SIMD_SSE2)
+    __m128 vwa = _mm_set1_ps( wa );
+    __m128 vwb = _mm_set1_ps( wb );
+    for( ; i + 4 <= n; i += 4 )
+    {
+        _mm_storeu_ps( dst + i, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( a + i ), vwa ),
+            _mm_mul_ps( _mm_loadu_ps( b + i ), vwb ) ) );
+    }
+#elif defined(VSI_NN_SIMD_NEON)
+    float32x4_t vwa = vdupq_n_f32( wa );
+    float32x4_t vwb = vdupq_n_f32( wb );
+    for( ; i + 4 <= n; i += 4 )
+    {
+        vst1q_f32( dst + i, vmlaq_f32( vmulq_f32( vld1q_f32( a + i ), vwa ),
+            vld1q_f32( b + i ), vwb ) );
+    }
+#endif
+    for( ; i < n; i++ )
+    {
+        dst[i] = a[i] * wa + b[i] * wb;
+    }
+} /* vsi_nn_simd_blend_f32() */
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -250,6 +250,12 @@ vsi_bool vsi_nn_kernel_param_add_const_buffer
 const void * vsi_nn_kernel_param_get_const_buffer
     ( const vsi_nn_kernel_param_t * params, const char * key, size_t * size);
 
+/**
+ * Fold the keys and values of params into a 64-bit FNV-1a hash.
+ */
+uint64_t vsi_nn_kernel_param_hash
+    ( const vsi_nn_kernel_param_t * params, uint64_t hash );
+
 /** Kernel register */
 #define REGISTER_KERNEL_BACKEND(kernel_name, kernel_type, func)   \
         _INITIALIZER(_register_kernel_##kernel_name##_##kernel_type) \
@@ -738,6 +744,22 @@ vsi_status vsi_nn_kernel_tensor_write
     size_t size
     );
 
+/*
+ * Record the host memory a cpu kernel saved by keeping the given tensors
+ * in their own dtype instead of float buffers.
+ */
+void vsi_nn_kernel_cpu_add_bytes_saved
+    (
+    const char * kernel_name,
+    const vsi_nn_kernel_tensor_attr_t * const * attrs,
+    size_t attr_num
+    );
+
+/*
+ * Total host memory saved by cpu kernels in this process.
+ */
+OVXLIB_API uint64_t vsi_nn_kernel_cpu_get_bytes_saved( void );
+
 static inline vsi_size_t vsi_nn_kernel_tensor_attr_get_size
     ( const vsi_nn_kernel_tensor_attr_t * attr )
 {
@@ -783,6 +805,106 @@ static inline vsi_bool vsi_nn_kernel_tensor_attr_is_quantized
             && attr->dtype != F64 );
 } /* vsi_nn_kernel_tensor_attr_is_quantized() */
 
+/*
+ * Whether raw data of tensor a can be stored into tensor b as is,
+ * e.g. both are uint8 with the same scale and zero point.
+ */
+static inline vsi_bool vsi_nn_kernel_tensor_attr_is_raw_compatible
+    (
+    const vsi_nn_kernel_tensor_attr_t * a,
+    const vsi_nn_kernel_tensor_attr_t * b
+    )
+{
+    vsi_bool quantized;
+    if( !a || !b || a->dtype != b->dtype )
+    {
+        return FALSE;
+    }
+    quantized = vsi_nn_kernel_tensor_attr_is_quantized( a );
+    if( quantized != vsi_nn_kernel_tensor_attr_is_quantized( b ) )
+    {
+        return FALSE;
+    }
+    if( !quantized )
+    {
+        return TRUE;
+    }
+    if( a->quant != b->quant )
+    {
+        return FALSE;
+    }
+    switch( a->quant )
+    {
+        case VSI_NN_KERNEL_QUANT_DFP:
+            return a->dfp.fl == b->dfp.fl;
+        case VSI_NN_KERNEL_QUANT_ASYMM:
+            return a->asymm.scale == b->asymm.scale
+                && a->asymm.zero_point == b->asymm.zero_point;
+        default:
+            break;
+    }
+    return FALSE;
+} /* vsi_nn_kernel_tensor_attr_is_raw_compatible() */
+
+static inline vsi_bool vsi_nn_kernel_dtype_is_integer
+    (
+    vsi_nn_kernel_dtype_e dtype
+    )
+{
+    switch( dtype )
+    {
+        case I8:
+        case I16:
+        case I32:
+        case I64:
+        case U8:
+        case U16:
+        case U32:
+        case U64:
+        case BOOL8:
+            return TRUE;
+        default:
+            break;
+    }
+    return FALSE;
+} /* vsi_nn_kernel_dtype_is_integer() */
+
+/*
+ * Load element `index` of an integer buffer. With identical scale and
+ * zero point, raw values keep the order of the real values.
+ */
+static inline int64_t vsi_nn_kernel_raw_load_int
+    (
+    const void * buffer,
+    vsi_nn_kernel_dtype_e dtype,
+    vsi_size_t index
+    )
+{
+    switch( dtype )
+    {
+        case I8:
+            return ((const int8_t *)buffer)[index];
+        case U8:
+        case BOOL8:
+            return ((const uint8_t *)buffer)[index];
+        case I16:
+            return ((const int16_t *)buffer)[index];
+        case U16:
+            return ((const uint16_t *)buffer)[index];
+        case I32:
+            return ((const int32_t *)buffer)[index];
+        case U32:
+            return ((const uint32_t *)buffer)[index];
+        case I64:
+        case U64:
+            return ((const int64_t *)buffer)[index];
+        default:
+            VSILOGE("Error data type %d", dtype);
+            break;
+    }
+    return 0;
+} /* vsi_nn_kernel_raw_load_int() */
+
 //TODO: Make vsi_nn_kernel_dtype_e to public and move dtype functions to vsi_nn_dtype.h
 vsi_bool vsi_nn_dtype_convert_float_to_dtype
     (
@@ -888,6 +1010,26 @@ vsi_nn_tensor_t* vsi_nn_merge_input_zeropoint_to_bias
     vsi_nn_tensor_t * bias
     );
 
+/**
+ * Kernel type instanced by vsi_nn_kernel_selector() for a vx node.
+ *
+ * @param[in] graph Graph handle.
+ * @param[in] node Vx node created in the graph.
+ *
+ * @return Kernel type, or VSI_NN_KERNEL_TYPE_NONE if the node was not
+ *         created by the kernel selector.
+ */
+vsi_nn_kernel_type_e vsi_nn_kernel_node_type
+    (
+    vsi_nn_graph_t * graph,
+    vx_node node
+    );
+
+void vsi_nn_kernel_release_node_records
+    (
+    vsi_nn_graph_t * graph
+    );
+
 static inline const char* vsi_nn_kernel_type_str
     (
     vsi_nn_kernel_type_e type
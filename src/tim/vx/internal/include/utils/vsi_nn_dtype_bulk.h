@@ -0,0 +1,152 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef _VSI_NN_DTYPE_BULK_H
+#define _VSI_NN_DTYPE_BULK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "vsi_nn_types.h"
+
+#if defined(__cplusplus)
+extern "C"{
+#endif
+
+/*
+ * Bulk dtype conversion
+ *
+ * Convert whole buffers between float32 and the 16 bit float and 8/16 bit
+ * quantized formats. The instruction set is picked at runtime: AVX2+F16C on
+ * x86, NEON on aarch64, plain C otherwise. Every path gives bit-exact
+ * results to the scalar path:
+ *  - float16 and bfloat16 are rounded to nearest even, float16 overflow
+ *    saturates to the largest finite value, NaN stays NaN.
+ *  - Quantization is clamp(rint(x / scale) + zero_point), with rint rounding
+ *    halfway cases to even, NaN maps to the lower bound.
+ *  - Dequantization is (q - zero_point) * scale.
+ * Buffers larger than VSI_NN_DTYPE_BULK_PARALLEL_SIZE elements are split on
+ * the CPU kernel thread pool.
+ *
+ * SIMD can be turned off with env VSI_NN_DTYPE_SIMD=0.
+ */
+
+#define VSI_NN_DTYPE_BULK_PARALLEL_SIZE   (64 * 1024)
+
+typedef enum
+{
+    VSI_NN_DTYPE_BULK_ISA_SCALAR = 0,
+    VSI_NN_DTYPE_BULK_ISA_NEON,
+    VSI_NN_DTYPE_BULK_ISA_AVX2_F16C,
+} vsi_nn_dtype_bulk_isa_e;
+
+/**
+ * Get instruction set
+ * Get the instruction set used by the bulk conversion.
+ *
+ * @return Instruction set.
+ */
+OVXLIB_API vsi_nn_dtype_bulk_isa_e vsi_nn_dtype_bulk_get_isa
+    ( void );
+
+/**
+ * Enable SIMD
+ * Turn the SIMD paths on or off, used to compare with the scalar path.
+ *
+ * @param[in] enable FALSE to use the scalar path only.
+ */
+OVXLIB_API void vsi_nn_dtype_bulk_set_simd_enable
+    (
+    vsi_bool enable
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_fp16_to_fp32
+    (
+    const uint16_t * buffer, size_t size,
+    float * out_buffer
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_fp32_to_fp16
+    (
+    const float * buffer, size_t size,
+    uint16_t * out_buffer
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_bf16_to_fp32
+    (
+    const uint16_t * buffer, size_t size,
+    float * out_buffer
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_fp32_to_bf16
+    (
+    const float * buffer, size_t size,
+    uint16_t * out_buffer
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_dequantize_u8
+    (
+    const uint8_t * buffer, size_t size,
+    float scale, int32_t zero_point,
+    float * out_buffer
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_dequantize_i8
+    (
+    const int8_t * buffer, size_t size,
+    float scale, int32_t zero_point,
+    float * out_buffer
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_dequantize_i16
+    (
+    const int16_t * buffer, size_t size,
+    float scale, int32_t zero_point,
+    float * out_buffer
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_quantize_u8
+    (
+    const float * buffer, size_t size,
+    float scale, int32_t zero_point,
+    uint8_t * out_buffer
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_quantize_i8
+    (
+    const float * buffer, size_t size,
+    float scale, int32_t zero_point,
+    int8_t * out_buffer
+    );
+
+OVXLIB_API void vsi_nn_dtype_bulk_quantize_i16
+    (
+    const float * buffer, size_t size,
+    float scale, int32_t zero_point,
+    int16_t * out_buffer
+    );
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
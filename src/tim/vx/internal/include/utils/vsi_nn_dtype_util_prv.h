@@ -327,6 +327,53 @@ static inline uint16_t fp32_to_fp16
     return (uint16_t) fp16;
 } /* fp32_to_fp16() */
 
+static inline uint16_t fp32_to_fp16_rtne
+    (
+    float in
+    )
+{
+    /*
+    Convert a float point to float16, with round-nearest-to-even as rounding method.
+    Denormals are kept, overflow saturates to the largest finite value like
+    fp32_to_fp16() and NaN becomes a quiet NaN.
+    */
+    const _fp32_t f16max = { (127 + 16) << 23 };
+    const _fp32_t denorm_magic = { ((127 - 15) + (23 - 10) + 1) << 23 };
+    _fp32_t f;
+    uint32_t sign;
+    uint32_t out;
+
+    f.f = in;
+    sign = f.u & 0x80000000u;
+    f.u ^= sign;
+    if( f.u > VSI_NN_FLOAT32_INF )
+    {
+        out = 0x7e00;
+    }
+    else if( f.u >= f16max.u )
+    {
+        out = 0x7c00;
+    }
+    else if( f.u < ( 113 << 23 ) )
+    {
+        /* Let the fpu round the denormal */
+        f.f += denorm_magic.f;
+        out = f.u - denorm_magic.u;
+    }
+    else
+    {
+        uint32_t mant_odd = ( f.u >> 13 ) & 1;
+        f.u += ( (uint32_t)( 15 - 127 ) << 23 ) + 0xfff;
+        f.u += mant_odd;
+        out = f.u >> 13;
+    }
+    if( out == 0x7c00 )
+    {
+        out = 0x7bff;
+    }
+    return (uint16_t)( out | ( sign >> 16 ) );
+} /* fp32_to_fp16_rtne() */
+
 static inline uint16_t fp32_to_bfp16
     (
     float in
@@ -353,9 +400,10 @@ static inline uint16_t fp32_to_bfp16_rtne
     uint32_t lsb = (fp32 >> 16) & 1;    /* Least significant bit of resulting bfloat. */
     uint32_t rounding_bias = 0x7fff + lsb;
 
-    if ( VSI_NN_FLOAT32_NAN == in )
+    if ( ( fp32 & 0x7fffffff ) > VSI_NN_FLOAT32_INF )
     {
-        out = 0x7fc0;
+        /* Keep NaN a quiet NaN, rounding could carry it to infinity */
+        out = (uint16_t)( ( fp32 >> 16 ) | 0x0040 );
     }
     else
     {
@@ -40,11 +40,25 @@ typedef struct _vsi_nn_map_key_list
     vsi_nn_map_key_t     val;
 } vsi_nn_map_key_list_t;
 
+/**
+ * Keys in [0, VSI_NN_MAP_DENSE_KEY_LIMIT) are stored in a dense table
+ * indexed by key, other keys fall back to the binary tree.
+ */
+#define VSI_NN_MAP_DENSE_KEY_LIMIT  (1 << 24)
+
 typedef struct _vsi_nn_map
 {
     int size;
+    /** Keys out of the dense range */
     vsi_nn_map_key_list_t * keys;
+    /** Values out of the dense range */
     vsi_nn_binary_tree_t  * values;
+    /** Dense value table, NULL slot means no value */
+    struct
+    {
+        void   ** items;
+        size_t    capacity;
+    } dense;
 } vsi_nn_map_t;
 
 OVXLIB_API void vsi_nn_MapInit
@@ -52,6 +66,11 @@ OVXLIB_API void vsi_nn_MapInit
     vsi_nn_map_t * map
     );
 
+OVXLIB_API void vsi_nn_MapDeinit
+    (
+    vsi_nn_map_t * map
+    );
+
 OVXLIB_API void * vsi_nn_MapGet
     (
     vsi_nn_map_t      * map,
@@ -0,0 +1,80 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef _VSI_NN_MUTEX_H
+#define _VSI_NN_MUTEX_H
+
+#include "vsi_nn_types.h"
+
+#if defined(__cplusplus)
+extern "C"{
+#endif
+
+/**
+ * Mutex
+ * Plain non recursive mutex, pthread or Win32 critical section.
+ */
+typedef struct _vsi_nn_mutex * vsi_nn_mutex_t;
+
+/**
+ * Create mutex
+ *
+ * @return Mutex handle on success, or NULL otherwise.
+ */
+vsi_nn_mutex_t vsi_nn_mutex_create
+    ( void );
+
+/**
+ * Release mutex
+ * The mutex must not be locked, the handle is reset to NULL.
+ *
+ * @param[in] mutex Pointer to mutex handle.
+ */
+void vsi_nn_mutex_release
+    (
+    vsi_nn_mutex_t * mutex
+    );
+
+/**
+ * Lock mutex
+ * No-op if mutex is NULL.
+ */
+void vsi_nn_mutex_lock
+    (
+    vsi_nn_mutex_t mutex
+    );
+
+/**
+ * Unlock mutex
+ * No-op if mutex is NULL.
+ */
+void vsi_nn_mutex_unlock
+    (
+    vsi_nn_mutex_t mutex
+    );
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
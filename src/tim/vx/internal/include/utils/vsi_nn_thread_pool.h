@@ -0,0 +1,87 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef _VSI_NN_THREAD_POOL_H
+#define _VSI_NN_THREAD_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "vsi_nn_types.h"
+
+#if defined(__cplusplus)
+extern "C"{
+#endif
+
+/**
+ * Parallel task
+ * Process items [start, end) of a task.
+ *
+ * @param[in] data User data passed to vsi_nn_parallel_for().
+ * @param[in] start First item.
+ * @param[in] end One past the last item.
+ */
+typedef void (* vsi_nn_parallel_func_t)
+    (
+    void  * data,
+    size_t  start,
+    size_t  end
+    );
+
+/**
+ * Parallel for
+ * Split items [0, total) into chunks of at least `grain` items and run
+ * them on the shared CPU kernel thread pool, the caller thread takes part.
+ * Returns after all items are processed. Runs serially in the caller if
+ * the task is small, the pool has a single thread or is busy with another
+ * task, so nested calls are safe.
+ *
+ * The pool is created on first use with one thread per online CPU, which
+ * can be overridden with env VSI_NN_CPU_THREADS.
+ *
+ * @param[in] total Number of items.
+ * @param[in] grain Minimum number of items per chunk.
+ * @param[in] func Task function.
+ * @param[in] data User data passed to func.
+ */
+OVXLIB_API void vsi_nn_parallel_for
+    (
+    size_t                  total,
+    size_t                  grain,
+    vsi_nn_parallel_func_t  func,
+    void                  * data
+    );
+
+/**
+ * Get thread count
+ * Get the number of threads running parallel tasks, including the caller.
+ *
+ * @return Thread count.
+ */
+OVXLIB_API uint32_t vsi_nn_parallel_get_thread_num
+    ( void );
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
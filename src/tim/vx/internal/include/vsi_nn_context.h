@@ -26,6 +26,8 @@
 #define _VSI_NN_CONTEXT_H
 
 #include "vsi_nn_platform.h"
+#include "utils/vsi_nn_hashmap.h"
+#include "utils/vsi_nn_mutex.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +35,7 @@ extern "C" {
 
 /** Max size of HW target name */
 #define VSI_NN_MAX_TARGET_NAME 32
+#define VSI_NN_TUNING_DB_KEY_LEN (17)
 
 /**
  * Hardware evis version.
@@ -73,6 +76,44 @@ typedef struct _vsi_nn_runtime_option_t
     int32_t enable_concat_optimize;
 } vsi_nn_runtime_option_t;
 
+/**
+ * Built shader program cache.
+ * Programs are keyed on source hash, build options and hardware config,
+ * and shared by all graphs of a context.
+ */
+typedef struct _vsi_nn_program_cache_t
+{
+    /** Map from cache key to vx_program */
+    vsi_nn_hashmap_t * programs;
+    /** Optional directory to look up prebuilt program binaries,
+     * set by env VSI_NN_PROGRAM_CACHE_DIR */
+    char * dir;
+    uint32_t hit;
+    uint32_t disk_hit;
+    uint32_t miss;
+} vsi_nn_program_cache_t;
+
+/**
+ * Kernel tuning DB.
+ * Fastest kernel type measured for a kernel signature: kernel name, tensor
+ * dtypes and shapes, params and hardware config. Loaded from and appended
+ * to the file set by env VSI_NN_TUNING_DB, the kernel selector tries the
+ * recorded type before its static priorities. Signatures missing from the
+ * DB are measured if env VSI_NN_ENABLE_AUTOTUNE is set.
+ */
+typedef struct _vsi_nn_tuning_db_t
+{
+    /** Map from signature key to kernel type + 1 */
+    vsi_nn_hashmap_t * entries;
+    /** DB file, NULL to keep the measurements in memory */
+    char * path;
+    int32_t enable_autotune;
+    /** Selections taken from the DB */
+    uint32_t hit;
+    /** Signatures measured */
+    uint32_t tuned;
+} vsi_nn_tuning_db_t;
+
 /**
  * Ovxlib NN runtime context.
  */
@@ -81,6 +122,11 @@ typedef struct _vsi_nn_context_t
     vx_context c;
     vsi_nn_hw_config_t config;
     vsi_nn_runtime_option_t options;
+    vsi_nn_program_cache_t program_cache;
+    vsi_nn_tuning_db_t tuning_db;
+    /** Guards program_cache and tuning_db, graphs of a context may be
+     * compiled from several threads */
+    vsi_nn_mutex_t lock;
 } *vsi_nn_context_t;
 
 /**
@@ -100,6 +146,38 @@ OVXLIB_API vsi_nn_context_t vsi_nn_CreateContext
 OVXLIB_API void vsi_nn_ReleaseContext
     ( vsi_nn_context_t * ctx );
 
+/**
+ * Get program cache statistics
+ * Query how many shader programs were reused from the in-process cache,
+ * loaded from the cache directory, or built from source.
+ *
+ * @param[in] ctx Context handle.
+ * @param[out] hit Programs reused from memory, can be NULL.
+ * @param[out] disk_hit Programs loaded from the cache directory, can be NULL.
+ * @param[out] miss Programs built, can be NULL.
+ */
+OVXLIB_API void vsi_nn_GetProgramCacheStats
+    (
+    vsi_nn_context_t ctx,
+    uint32_t * hit,
+    uint32_t * disk_hit,
+    uint32_t * miss
+    );
+
+/**
+ * Get kernel tuning DB statistics
+ *
+ * @param[in] ctx Context handle.
+ * @param[out] hit Kernel selections taken from the tuning DB, can be NULL.
+ * @param[out] tuned Kernel signatures measured by autotuning, can be NULL.
+ */
+OVXLIB_API void vsi_nn_GetTuningDBStats
+    (
+    vsi_nn_context_t ctx,
+    uint32_t * hit,
+    uint32_t * tuned
+    );
+
 #ifdef __cplusplus
 }
 #endif
@@ -167,6 +167,15 @@ struct _vsi_nn_graph
     } complete_signal;
 
     vsi_bool isAllowFastMode;
+
+    /** Tensor producer/consumer index, updated as nodes are added, removed
+     * or rewired.
+     * @see vsi_nn_update_tensor_adjacency */
+    struct _vsi_nn_graph_adjacency * adjacency;
+
+    /** Kernel types instanced by the kernel selector for each vx node.
+     * @see vsi_nn_kernel_node_type */
+    struct _vsi_nn_kernel_node_records * kernel_node_records;
 };
 
 /**
@@ -699,6 +708,33 @@ void vsi_nn_get_tensor_provider
     vsi_nn_node_t** node
     );
 
+/**
+ * Update tensor adjacency
+ * Relink a node in the tensor producer/consumer index after its inputs or
+ * outputs were rewired. Nodes wired right after vsi_nn_AddNode() don't need
+ * it, they are linked on the next query.
+ *
+ * @param[in] graph Graph handle.
+ * @param[in] node Rewired node.
+ */
+void vsi_nn_update_tensor_adjacency
+    (
+    vsi_nn_graph_t* graph,
+    vsi_nn_node_t* node
+    );
+
+/**
+ * Invalidate tensor adjacency
+ * Drop the whole tensor producer/consumer index, it will be rebuilt on the
+ * next query. Prefer vsi_nn_update_tensor_adjacency().
+ *
+ * @param[in] graph Graph handle.
+ */
+void vsi_nn_invalidate_tensor_adjacency
+    (
+    vsi_nn_graph_t* graph
+    );
+
 OVXLIB_API vsi_status vsi_nn_SetGraphPreloadSize
     (
     vsi_nn_graph_t* graph,
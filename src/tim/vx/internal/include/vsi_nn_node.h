@@ -96,6 +96,8 @@ struct _vsi_nn_node
     /** Node's internal node wksp */
     void* internal_node_wksp;
     vsi_nn_node_attr_t attr;
+    /** Id in the graph, VSI_NN_NODE_ID_NA if not added to a graph */
+    vsi_nn_node_id_t id;
 };
 
 /*------------------------------------
@@ -76,6 +76,18 @@ static vsi_ssize_t _expand_offset
     return offset;
 }
 
+#define _COMPARE( _val1, _val2, _operation, _data ) \
+    switch (_operation) \
+    { \
+    case COMP_GREAT: _data = _val1 > _val2; break; \
+    case COMP_GREAT_EQUAL: _data = _val1 >= _val2; break; \
+    case COMP_LESS: _data = _val1 < _val2; break; \
+    case COMP_LESS_EQUAL: _data = _val1 <= _val2; break; \
+    case COMP_EQUAL: _data = _val1 == _val2; break; \
+    case COMP_NOT_EQUAL: _data = _val1 != _val2; break; \
+    default: break; \
+    }
+
 DEF_KERNEL_EXECUTOR(_comparisons_exec)
     (
     vsi_nn_kernel_node_t node,
@@ -91,6 +103,8 @@ DEF_KERNEL_EXECUTOR(_comparisons_exec)
     vsi_size_t stride_size[_CPU_INPUT_NUM][VSI_NN_MAX_DIM_NUM] = {{0}};
     int32_t i = 0;
     int32_t operation = 0;
+    vsi_bool raw_input = FALSE;
+    vsi_bool raw_output = FALSE;
 
     tensors[0]  = (vsi_nn_kernel_tensor_t)param[0];
     tensors[1]  = (vsi_nn_kernel_tensor_t)param[1];
@@ -112,22 +126,25 @@ DEF_KERNEL_EXECUTOR(_comparisons_exec)
 
     out_elements = vsi_nn_kernel_tensor_attr_get_size( attr[2] );
 
-    buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
+    /* With identical integer quantization raw values compare like real values */
+    raw_input = vsi_nn_kernel_dtype_is_integer( attr[0]->dtype )
+        && vsi_nn_kernel_tensor_attr_is_raw_compatible( attr[0], attr[1] );
+    /* Bool output is written as 0 or 1 bytes */
+    raw_output = BOOL8 == attr[2]->dtype && !vsi_nn_kernel_tensor_attr_is_quantized( attr[2] );
+
+    buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], !raw_input );
     CHECK_PTR_FAIL_GOTO( buffer[0], "Create input0 buffer fail.", final );
 
-    buffer[1] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[1], attr[1], TRUE );
+    buffer[1] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[1], attr[1], !raw_input );
     CHECK_PTR_FAIL_GOTO( buffer[1], "Create input1 buffer fail.", final );
 
-    buffer[2] = (float *)malloc( out_elements * sizeof(float) );
+    buffer[2] = (float *)malloc( out_elements * ( raw_output ? sizeof(uint8_t) : sizeof(float) ) );
     CHECK_PTR_FAIL_GOTO( buffer[2], "Create output buffer fail.", final );
-    memset( buffer[2], 0, out_elements * sizeof(float) );
 
     for (i = 0; i < (int32_t)out_elements; i++)
     {
         vsi_ssize_t in0_offset = 0;
         vsi_ssize_t in1_offset = 0;
-        float val1 = 0.f;
-        float val2 = 0.f;
         vsi_bool data = 0;
 
         in0_offset = _expand_offset( i, attr[0]->shape->data, (vsi_size_t)attr[0]->shape->size,
@@ -135,39 +152,57 @@ DEF_KERNEL_EXECUTOR(_comparisons_exec)
         in1_offset = _expand_offset( i, attr[1]->shape->data, (vsi_size_t)attr[1]->shape->size,
                 stride_size[1], attr[2]->shape->data );
 
-        val1 = buffer[0][in0_offset];
-        val2 = buffer[1][in1_offset];
+        if (raw_input)
+        {
+            int64_t val1 = vsi_nn_kernel_raw_load_int( buffer[0], attr[0]->dtype, in0_offset );
+            int64_t val2 = vsi_nn_kernel_raw_load_int( buffer[1], attr[1]->dtype, in1_offset );
+            _COMPARE( val1, val2, operation, data );
+        }
+        else
+        {
+            float val1 = buffer[0][in0_offset];
+            float val2 = buffer[1][in1_offset];
+            _COMPARE( val1, val2, operation, data );
+        }
 
-        switch (operation)
+        if (raw_output)
+        {
+            ((uint8_t *)buffer[2])[i] = (uint8_t)data;
+        }
+        else
         {
-        case COMP_GREAT:
-            data = val1 > val2;
-            break;
-        case COMP_GREAT_EQUAL:
-            data = val1 >= val2;
-            break;
-        case COMP_LESS:
-            data = val1 < val2;
-            break;
-        case COMP_LESS_EQUAL:
-            data = val1 <= val2;
-            break;
-        case COMP_EQUAL:
-            data = val1 == val2;
-            break;
-        case COMP_NOT_EQUAL:
-            data = val1 != val2;
-            break;
-        default:
-            break;
+            buffer[2][i] = (float)data;
         }
-        buffer[2][i] = (float)data;
     }
 
-    status = vsi_nn_kernel_tensor_write_from_float( tensors[2], attr[2],
-            buffer[2], out_elements );
+    if (raw_output)
+    {
+        status = vsi_nn_kernel_tensor_write( tensors[2], attr[2],
+                buffer[2], out_elements );
+    }
+    else
+    {
+        status = vsi_nn_kernel_tensor_write_from_float( tensors[2], attr[2],
+                buffer[2], out_elements );
+    }
     CHECK_STATUS_FAIL_GOTO( status, final );
 
+    if (raw_input || raw_output)
+    {
+        const vsi_nn_kernel_tensor_attr_t * raw_attrs[_CPU_IO_NUM] = { NULL };
+        size_t raw_num = 0;
+        if (raw_input)
+        {
+            raw_attrs[raw_num++] = attr[0];
+            raw_attrs[raw_num++] = attr[1];
+        }
+        if (raw_output)
+        {
+            raw_attrs[raw_num++] = attr[2];
+        }
+        vsi_nn_kernel_cpu_add_bytes_saved( _KERNEL_NAME, raw_attrs, raw_num );
+    }
+
 final:
     if (attr[0])
     {
@@ -79,6 +79,27 @@ static vsi_ssize_t _expand_offset
     return offset;
 }
 
+static float _floordiv_int
+    (
+    int64_t in0,
+    int64_t in1
+    )
+{
+    int64_t quotient;
+
+    if( 0 == in1 )
+    {
+        /* Same inf or nan as the float path */
+        return (float)floor((float)in0 / (float)in1);
+    }
+    quotient = in0 / in1;
+    if( quotient * in1 != in0 && ( in0 < 0 ) != ( in1 < 0 ) )
+    {
+        quotient --;
+    }
+    return (float)quotient;
+} /* _floordiv_int() */
+
 /*
  * Kernel function
  */
@@ -100,6 +121,8 @@ DEF_KERNEL_EXECUTOR(_compute)
     vsi_size_t   out_stride_size[_OUTPUT_NUM][VSI_NN_MAX_DIM_NUM] = {{1}};
     vsi_size_t   out_elements[_OUTPUT_NUM] = {0};
     vsi_size_t   out_bytes[_OUTPUT_NUM] = {0};
+    vsi_bool     raw_compute = FALSE;
+    int64_t      zero_point = 0;
     uint32_t  i;
 
     /* prepare data */
@@ -108,9 +131,21 @@ DEF_KERNEL_EXECUTOR(_compute)
         input[i] = (vsi_nn_kernel_tensor_t)param[i];
         in_attr[i] = vsi_nn_kernel_tensor_attr_create( input[i] );
         vsi_nn_kernel_tensor_attr_get_stride( in_attr[i], in_stride_size[i] );
-        f32_in_buffer[i] = (float*)vsi_nn_kernel_tensor_create_buffer( input[i], in_attr[i], TRUE );
-        CHECK_PTR_FAIL_GOTO( f32_in_buffer[i], "Create input0 buffer fail.", final );
+    }
 
+    /* With identical integer quantization the scales cancel, so the
+     * quotient only needs the raw values minus the zero point */
+    raw_compute = vsi_nn_kernel_dtype_is_integer( in_attr[0]->dtype )
+        && vsi_nn_kernel_tensor_attr_is_raw_compatible( in_attr[0], in_attr[1] );
+    if( raw_compute && VSI_NN_KERNEL_QUANT_ASYMM == in_attr[0]->quant )
+    {
+        zero_point = in_attr[0]->asymm.zero_point;
+    }
+
+    for(i = 0; i < _INPUT_NUM; i ++)
+    {
+        f32_in_buffer[i] = (float*)vsi_nn_kernel_tensor_create_buffer( input[i], in_attr[i], !raw_compute );
+        CHECK_PTR_FAIL_GOTO( f32_in_buffer[i], "Create input0 buffer fail.", final );
     }
     for(i = 0; i < _OUTPUT_NUM; i ++)
     {
@@ -135,6 +170,13 @@ DEF_KERNEL_EXECUTOR(_compute)
                 in_stride_size[0], out_attr[0]->shape->data );
         in1_offset = _expand_offset( i, in_attr[1]->shape->data, (vsi_size_t)in_attr[1]->shape->size,
                 in_stride_size[1], out_attr[0]->shape->data );
+        if( raw_compute )
+        {
+            f32_out_buffer[0][i] = _floordiv_int(
+                vsi_nn_kernel_raw_load_int( f32_in_buffer[0], in_attr[0]->dtype, in0_offset ) - zero_point,
+                vsi_nn_kernel_raw_load_int( f32_in_buffer[1], in_attr[1]->dtype, in1_offset ) - zero_point );
+            continue;
+        }
         in0 = f32_in_buffer[0][in0_offset];
         in1 = f32_in_buffer[1][in1_offset];
         f32_out_buffer[0][i] = (float)floor(in0 / in1);
@@ -148,6 +190,12 @@ DEF_KERNEL_EXECUTOR(_compute)
         CHECK_STATUS_FAIL_GOTO( status, final );
     }
 
+    if( raw_compute )
+    {
+        const vsi_nn_kernel_tensor_attr_t * raw_attrs[] = { in_attr[0], in_attr[1] };
+        vsi_nn_kernel_cpu_add_bytes_saved( _KERNEL_NAME, raw_attrs, _cnt_of_array( raw_attrs ) );
+    }
+
 final:
     for (i = 0; i < _INPUT_NUM; i++)
     {
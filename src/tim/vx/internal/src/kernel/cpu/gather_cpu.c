@@ -35,6 +35,7 @@
 #include "vsi_nn_error.h"
 #include "utils/vsi_nn_util.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "kernel/cpu/vsi_nn_kernel_cpu_compute.h"
 #include "libnnext/vsi_nn_vxkernel.h"
 
 __BEGIN_DECLS
@@ -58,11 +59,13 @@ DEF_KERNEL_EXECUTOR(_gather_exec)
 {
     vsi_status status = VX_FAILURE;
     vsi_nn_kernel_tensor_t tensors[_CPU_IO_NUM] = { NULL };
-    float * buffer[2] = { NULL };
+    void * buffer[2] = { NULL };
     uint32_t* buffer_idx = NULL;
+    vsi_bool raw_copy = FALSE;
+    size_t element_bytes = sizeof(float);
     size_t in_elements = 0, out_elements = 0;
     vsi_nn_kernel_tensor_attr_t * attr[_CPU_IO_NUM] = { NULL };
-    vsi_size_t i = 0, j = 0;
+    vsi_size_t i = 0;
     int32_t block_size = 1, block_num = 1, axis_num = 0;
     vsi_size_t indices_num = 1;
 
@@ -87,15 +90,21 @@ DEF_KERNEL_EXECUTOR(_gather_exec)
     status = vsi_nn_kernel_scalar_read_int32((vsi_nn_kernel_scalar_t)param[5], &axis_num);
     CHECK_STATUS_FAIL_GOTO(status, final );
 
-    buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
+    /* Gather only moves data, copy raw elements if no requantization is needed */
+    raw_copy = vsi_nn_kernel_tensor_attr_is_raw_compatible( attr[0], attr[2] );
+    if( raw_copy )
+    {
+        element_bytes = vsi_nn_kernel_dtype_get_bytes( attr[0]->dtype );
+    }
+
+    buffer[0] = vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], !raw_copy );
     CHECK_PTR_FAIL_GOTO( buffer[0], "Create input0 buffer fail.", final );
 
     buffer_idx = (uint32_t*)vsi_nn_kernel_tensor_create_buffer( tensors[1], attr[1], FALSE );
     CHECK_PTR_FAIL_GOTO( buffer_idx, "Create input1 buffer fail.", final );
 
-    buffer[1] = (float *)malloc( out_elements * sizeof(float) );
+    buffer[1] = malloc( out_elements * element_bytes );
     CHECK_PTR_FAIL_GOTO( buffer[1], "Create output buffer fail.", final );
-    memset( buffer[1], 0, out_elements * sizeof(float) );
 
     {
         for(i = 0; i < attr[1]->shape->size; ++i)
@@ -103,29 +112,25 @@ DEF_KERNEL_EXECUTOR(_gather_exec)
             indices_num *= attr[1]->shape->data[i];
         }
 
-        for(i = 0; i < (vsi_size_t)block_num; i++)
-        {
-            for(j = 0; j < indices_num; j++)
-            {
-                uint32_t indice = buffer_idx[j];
-                vsi_size_t in_index = (i * axis_num + indice) * block_size;
-                if(in_index < in_elements)
-                {
-                    vsi_size_t out_index = (i * indices_num + j) * block_size;
-                    memcpy(&(buffer[1][out_index]), &(buffer[0][in_index]), block_size * sizeof(float));
-                }
-                else
-                {
-                    status = VX_FAILURE;
-                    CHECK_STATUS_FAIL_GOTO( status, final );
-                }
-            }
-        }
+        status = vsi_nn_kernel_cpu_gather( buffer[0], in_elements, buffer_idx, indices_num,
+            block_size, block_num, axis_num, element_bytes, buffer[1] );
+        CHECK_STATUS_FAIL_GOTO( status, final );
     }
 
-    status = vsi_nn_kernel_tensor_write_from_float( tensors[2], attr[2],
-            buffer[1], out_elements );
-    CHECK_STATUS_FAIL_GOTO( status, final );
+    if( raw_copy )
+    {
+        const vsi_nn_kernel_tensor_attr_t * raw_attrs[] = { attr[0], attr[2] };
+        status = vsi_nn_kernel_tensor_write( tensors[2], attr[2],
+                buffer[1], out_elements * element_bytes );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+        vsi_nn_kernel_cpu_add_bytes_saved( _KERNEL_NAME, raw_attrs, _cnt_of_array( raw_attrs ) );
+    }
+    else
+    {
+        status = vsi_nn_kernel_tensor_write_from_float( tensors[2], attr[2],
+                (float *)buffer[1], out_elements );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+    }
 
 final:
     if( buffer_idx )
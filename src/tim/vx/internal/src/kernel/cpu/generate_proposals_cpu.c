@@ -0,0 +1,398 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "vsi_nn_types.h"
+#include "vsi_nn_tensor.h"
+#include "vsi_nn_graph.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_error.h"
+#include "vsi_nn_prv.h"
+#include "vsi_nn_tensor_util.h"
+#include "utils/vsi_nn_util.h"
+#include "kernel/vsi_nn_kernel.h"
+
+__BEGIN_DECLS
+
+/*
+ * Define kernel meta.
+ */
+#define _INPUT_NUM          (4)
+#define _OUTPUT_NUM         (3)
+#define _KERNEL_NAME        CVIVANTE_NAMESPACE("cpu.generate_proposals")
+
+/*
+ * Kernel params
+ */
+static vx_param_description_t _generate_proposals_kernel_param_def[] =
+{
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+};
+#define _GENERATE_PROPOSALS_PARAM_NUM  _cnt_of_array( _generate_proposals_kernel_param_def )
+#define HEIGHT_STRIDE           (7)
+#define WIDTH_STRIDE            (8)
+#define PRE_NMS_TOP_N           (9)
+#define POST_NMS_TOP_N          (10)
+#define IOU_THRESHOLD           (11)
+#define MIN_SIZE                (12)
+
+typedef struct
+{
+    float score;
+    uint32_t index;
+} _proposal_candidate;
+
+static int _candidate_comp
+    (
+    const void* left,
+    const void* right
+    )
+{
+    const _proposal_candidate* lhs = (const _proposal_candidate*)left;
+    const _proposal_candidate* rhs = (const _proposal_candidate*)right;
+    if (lhs->score != rhs->score)
+    {
+        return lhs->score > rhs->score ? -1 : 1;
+    }
+    return lhs->index < rhs->index ? -1 : (lhs->index > rhs->index);
+}
+
+static float _proposal_iou
+    (
+    const float* roi1,
+    const float* roi2
+    )
+{
+    const float area1 = (roi1[2] - roi1[0]) * (roi1[3] - roi1[1]);
+    const float area2 = (roi2[2] - roi2[0]) * (roi2[3] - roi2[1]);
+    const float x1 = vsi_nn_max(roi1[0], roi2[0]);
+    const float x2 = vsi_nn_min(roi1[2], roi2[2]);
+    const float y1 = vsi_nn_max(roi1[1], roi2[1]);
+    const float y2 = vsi_nn_min(roi1[3], roi2[3]);
+    const float w = vsi_nn_max(x2 - x1, 0.0f);
+    const float h = vsi_nn_max(y2 - y1, 0.0f);
+    const float areaIntersect = w * h;
+    const float areaUnion = area1 + area2 - areaIntersect;
+    return areaUnion > 0.0f ? areaIntersect / areaUnion : 0.0f;
+}
+
+/*
+ * Kernel function
+ *
+ * scores [W, H, A, N], deltas [W, H, A * 4, N], anchors [4, A] and
+ * image_info [2, N] holding height and width. Boxes are x1, y1, x2, y2.
+ * Proposals of all batches are written one after another, the remaining
+ * outputs stay zero.
+ */
+DEF_KERNEL_EXECUTOR(_compute)
+    (
+    vsi_nn_kernel_node_t                node,
+    const vsi_nn_kernel_node_param_t  * param,
+    size_t                              param_size
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_tensor_t input[_INPUT_NUM] = {NULL};
+    vsi_nn_kernel_tensor_t output[_OUTPUT_NUM] = {NULL};
+    float *f32_in_buffer[_INPUT_NUM] = {NULL};
+    float *f32_out_buffer[_OUTPUT_NUM] = {NULL};
+    vsi_nn_kernel_tensor_attr_t *in_attr[_INPUT_NUM] = {NULL};
+    vsi_nn_kernel_tensor_attr_t *out_attr[_OUTPUT_NUM] = {NULL};
+    vsi_size_t   out_elements[_OUTPUT_NUM] = {0};
+    vsi_size_t   out_bytes[_OUTPUT_NUM] = {0};
+    uint32_t  i = 0;
+    float height_stride = 0;
+    float width_stride = 0;
+    int32_t pre_nms_top_n = 0;
+    int32_t post_nms_top_n = 0;
+    float iou_threshold = 0;
+    float min_size = 0;
+    const uint32_t kRoiDim = 4;
+    uint32_t width = 0, height = 0, num_anchors = 0, num_batches = 0;
+    uint32_t num_boxes = 0;
+    uint32_t max_output = 0;
+    uint32_t out_index = 0;
+    uint32_t b = 0, a = 0, h = 0, w = 0, c = 0;
+    float* rois = NULL;
+    _proposal_candidate* candidates = NULL;
+    uint8_t* suppressed = NULL;
+
+    /* prepare data */
+    for (i = 0; i < _INPUT_NUM; i ++)
+    {
+        input[i] = (vsi_nn_kernel_tensor_t)param[i];
+        in_attr[i] = vsi_nn_kernel_tensor_attr_create( input[i] );
+        f32_in_buffer[i] = (float*)vsi_nn_kernel_tensor_create_buffer( input[i], in_attr[i], TRUE );
+        CHECK_PTR_FAIL_GOTO( f32_in_buffer[i], "Create input buffer fail.", final );
+    }
+
+    for (i = 0; i < _OUTPUT_NUM; i ++)
+    {
+        output[i] = (vsi_nn_kernel_tensor_t)param[i + _INPUT_NUM];
+        out_attr[i] = vsi_nn_kernel_tensor_attr_create( output[i] );
+        out_elements[i] = vsi_nn_kernel_tensor_attr_get_size( out_attr[i] );
+        out_bytes[i] = out_elements[i] * sizeof(float);
+        f32_out_buffer[i] = (float *)malloc( out_bytes[i] );
+        CHECK_PTR_FAIL_GOTO( f32_out_buffer[i], "Create output buffer fail.", final );
+        memset( f32_out_buffer[i], 0, out_bytes[i] );
+    }
+
+#define VSI_NN_KERNEL_READ_SCALAR(type, idx, pointer) \
+    vsi_nn_kernel_scalar_read_##type((vsi_nn_kernel_scalar_t)param[idx], pointer)
+
+    status   = VSI_NN_KERNEL_READ_SCALAR(float32, HEIGHT_STRIDE, &height_stride);
+    status  |= VSI_NN_KERNEL_READ_SCALAR(float32, WIDTH_STRIDE, &width_stride);
+    status  |= VSI_NN_KERNEL_READ_SCALAR(int32, PRE_NMS_TOP_N, &pre_nms_top_n);
+    status  |= VSI_NN_KERNEL_READ_SCALAR(int32, POST_NMS_TOP_N, &post_nms_top_n);
+    status  |= VSI_NN_KERNEL_READ_SCALAR(float32, IOU_THRESHOLD, &iou_threshold);
+    status  |= VSI_NN_KERNEL_READ_SCALAR(float32, MIN_SIZE, &min_size);
+    CHECK_STATUS_FAIL_GOTO(status, final );
+#undef VSI_NN_KERNEL_READ_SCALAR
+
+    width = (uint32_t)in_attr[0]->shape->data[0];
+    height = (uint32_t)in_attr[0]->shape->data[1];
+    num_anchors = (uint32_t)in_attr[0]->shape->data[2];
+    num_batches = in_attr[0]->shape->size > 3 ? (uint32_t)in_attr[0]->shape->data[3] : 1;
+    num_boxes = width * height * num_anchors;
+    max_output = (uint32_t)out_elements[0];
+
+    rois = (float*)malloc(num_boxes * kRoiDim * sizeof(float));
+    CHECK_PTR_FAIL_GOTO( rois, "Create rois buffer fail.", final );
+    candidates = (_proposal_candidate*)malloc(num_boxes * sizeof(_proposal_candidate));
+    CHECK_PTR_FAIL_GOTO( candidates, "Create candidates buffer fail.", final );
+    suppressed = (uint8_t*)malloc(num_boxes * sizeof(uint8_t));
+    CHECK_PTR_FAIL_GOTO( suppressed, "Create suppressed buffer fail.", final );
+
+    for (b = 0; b < num_batches && out_index < max_output; b++)
+    {
+        const float image_height = f32_in_buffer[3][b * 2];
+        const float image_width = f32_in_buffer[3][b * 2 + 1];
+        uint32_t num_candidates = 0;
+        uint32_t num_selected = 0;
+
+        /* Shift the anchors over the feature map and apply the deltas */
+        for (a = 0; a < num_anchors; a++)
+        {
+            for (h = 0; h < height; h++)
+            {
+                for (w = 0; w < width; w++)
+                {
+                    uint32_t box = (a * height + h) * width + w;
+                    const float* anchor = &f32_in_buffer[2][a * kRoiDim];
+                    float delta[4];
+                    float x1 = anchor[0] + w * width_stride;
+                    float y1 = anchor[1] + h * height_stride;
+                    float x2 = anchor[2] + w * width_stride;
+                    float y2 = anchor[3] + h * height_stride;
+                    float box_w = x2 - x1;
+                    float box_h = y2 - y1;
+                    float ctr_x = x1 + box_w / 2;
+                    float ctr_y = y1 + box_h / 2;
+                    float* roi = &rois[box * kRoiDim];
+
+                    for (c = 0; c < kRoiDim; c++)
+                    {
+                        delta[c] = f32_in_buffer[1][
+                            (((b * num_anchors + a) * kRoiDim + c) * height + h) * width + w];
+                    }
+                    ctr_x += delta[0] * box_w;
+                    ctr_y += delta[1] * box_h;
+                    box_w *= (float)exp(delta[2]);
+                    box_h *= (float)exp(delta[3]);
+                    roi[0] = vsi_nn_min(vsi_nn_max(ctr_x - box_w / 2, 0.0f), image_width);
+                    roi[1] = vsi_nn_min(vsi_nn_max(ctr_y - box_h / 2, 0.0f), image_height);
+                    roi[2] = vsi_nn_min(vsi_nn_max(ctr_x + box_w / 2, 0.0f), image_width);
+                    roi[3] = vsi_nn_min(vsi_nn_max(ctr_y + box_h / 2, 0.0f), image_height);
+
+                    if (roi[2] - roi[0] >= min_size && roi[3] - roi[1] >= min_size)
+                    {
+                        candidates[num_candidates].score =
+                            f32_in_buffer[0][b * num_boxes + box];
+                        candidates[num_candidates].index = box;
+                        num_candidates++;
+                    }
+                }
+            }
+        }
+
+        if (num_candidates > 0)
+        {
+            qsort(candidates, num_candidates, sizeof(_proposal_candidate), _candidate_comp);
+        }
+        if (pre_nms_top_n > 0 && num_candidates > (uint32_t)pre_nms_top_n)
+        {
+            num_candidates = (uint32_t)pre_nms_top_n;
+        }
+
+        /* Hard NMS in score order */
+        memset(suppressed, 0, num_candidates * sizeof(uint8_t));
+        for (i = 0; i < num_candidates && out_index < max_output; i++)
+        {
+            uint32_t j = 0;
+            const float* roi = &rois[candidates[i].index * kRoiDim];
+            if (suppressed[i])
+            {
+                continue;
+            }
+            if (post_nms_top_n > 0 && num_selected >= (uint32_t)post_nms_top_n)
+            {
+                break;
+            }
+            f32_out_buffer[0][out_index] = candidates[i].score;
+            memcpy(&f32_out_buffer[1][out_index * kRoiDim], roi, kRoiDim * sizeof(float));
+            f32_out_buffer[2][out_index] = (float)b;
+            out_index++;
+            num_selected++;
+            for (j = i + 1; j < num_candidates; j++)
+            {
+                if (!suppressed[j] &&
+                    _proposal_iou(roi, &rois[candidates[j].index * kRoiDim]) >= iou_threshold)
+                {
+                    suppressed[j] = 1;
+                }
+            }
+        }
+    }
+
+    /* save data */
+    for (i = 0; i < _OUTPUT_NUM; i++)
+    {
+        status = vsi_nn_kernel_tensor_write_from_float( output[i], out_attr[i],
+                f32_out_buffer[i], out_elements[i] );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+    }
+
+final:
+    vsi_nn_safe_free(rois);
+    vsi_nn_safe_free(candidates);
+    vsi_nn_safe_free(suppressed);
+    for (i = 0; i < _INPUT_NUM; i++)
+    {
+        vsi_nn_safe_free(f32_in_buffer[i]);
+        if (in_attr[i])
+        {
+            vsi_nn_kernel_tensor_attr_release( &in_attr[i] );
+        }
+    }
+    for (i = 0; i < _OUTPUT_NUM; i++)
+    {
+        vsi_nn_safe_free(f32_out_buffer[i]);
+        if (out_attr[i])
+        {
+            vsi_nn_kernel_tensor_attr_release( &out_attr[i] );
+        }
+    }
+
+    return status;
+} /* _compute() */
+
+
+/*
+ * Query kernel
+ */
+static vsi_status _query_kernel
+    (
+    vsi_nn_kernel_t * kernel,
+    vsi_nn_tensor_t * const * const inputs,
+    vsi_nn_tensor_t * const * const outputs
+    )
+{
+    vsi_status status = VSI_SUCCESS;
+    snprintf( kernel->info.name, VX_MAX_KERNEL_NAME, "%s",  _KERNEL_NAME );
+    kernel->info.function    = _compute;
+    kernel->info.parameters  = _generate_proposals_kernel_param_def;
+    kernel->info.numParams   = _cnt_of_array( _generate_proposals_kernel_param_def );
+
+    return status;
+} /* _query_kernel() */
+
+
+static vsi_nn_kernel_node_t _setup
+    (
+    vsi_nn_graph_t              * graph,
+    vsi_nn_tensor_t            ** inputs,
+    size_t                        input_num,
+    vsi_nn_tensor_t            ** outputs,
+    size_t                        output_num,
+    const vsi_nn_kernel_param_t * params,
+    vsi_nn_kernel_t             * kernel
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_node_param_t node_params[_GENERATE_PROPOSALS_PARAM_NUM] = {NULL};
+    vsi_nn_kernel_node_t node = NULL;
+    float height_stride  = vsi_nn_kernel_param_get_float32( params, "height_stride" );
+    float width_stride  = vsi_nn_kernel_param_get_float32( params, "width_stride" );
+    int32_t pre_nms_top_n  = vsi_nn_kernel_param_get_int32( params, "pre_nms_top_n" );
+    int32_t post_nms_top_n  = vsi_nn_kernel_param_get_int32( params, "post_nms_top_n" );
+    float iou_threshold  = vsi_nn_kernel_param_get_float32( params, "iou_threshold" );
+    float min_size  = vsi_nn_kernel_param_get_float32( params, "min_size" );
+
+    status = _query_kernel( kernel, inputs, outputs );
+    if ( VSI_SUCCESS == status )
+    {
+        node = vsi_nn_kernel_create_node( graph, kernel );
+        if ( node )
+        {
+            /* Set inputs and outputs */
+            vsi_nn_kernel_node_pack_io( node_params, _GENERATE_PROPOSALS_PARAM_NUM,
+                    inputs, input_num, outputs, output_num );
+            node_params[HEIGHT_STRIDE] = vsi_nn_kernel_scalar_create( graph, F32, &height_stride );
+            node_params[WIDTH_STRIDE] = vsi_nn_kernel_scalar_create( graph, F32, &width_stride );
+            node_params[PRE_NMS_TOP_N] = vsi_nn_kernel_scalar_create( graph, I32, &pre_nms_top_n );
+            node_params[POST_NMS_TOP_N] = vsi_nn_kernel_scalar_create( graph, I32, &post_nms_top_n );
+            node_params[IOU_THRESHOLD] = vsi_nn_kernel_scalar_create( graph, F32, &iou_threshold );
+            node_params[MIN_SIZE] = vsi_nn_kernel_scalar_create( graph, F32, &min_size );
+            /* Pass parameters to node. */
+            status  = vsi_nn_kernel_node_pass_param( node, node_params, _GENERATE_PROPOSALS_PARAM_NUM );
+            vsi_nn_kernel_scalar_release( &node_params[HEIGHT_STRIDE] );
+            vsi_nn_kernel_scalar_release( &node_params[WIDTH_STRIDE] );
+            vsi_nn_kernel_scalar_release( &node_params[PRE_NMS_TOP_N] );
+            vsi_nn_kernel_scalar_release( &node_params[POST_NMS_TOP_N] );
+            vsi_nn_kernel_scalar_release( &node_params[IOU_THRESHOLD] );
+            vsi_nn_kernel_scalar_release( &node_params[MIN_SIZE] );
+        }
+    }
+
+    return node;
+} /* _setup() */
+
+__END_DECLS
+
+REGISTER_BACKEND_CPU( generate_proposals, _setup )
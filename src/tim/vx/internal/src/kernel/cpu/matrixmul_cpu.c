@@ -35,6 +35,7 @@
 #include "vsi_nn_error.h"
 #include "utils/vsi_nn_util.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "kernel/cpu/vsi_nn_kernel_cpu_compute.h"
 #include "libnnext/vsi_nn_vxkernel.h"
 
 __BEGIN_DECLS
@@ -64,7 +65,6 @@ DEF_KERNEL_EXECUTOR(_matrixmul_exec)
     vsi_size_t i = 0;
     vsi_size_t M = 0, K = 0, N = 0;
     int32_t transposeA = 0, transposeB = 0;
-    size_t strides0[2] = {0, 0}, strides1[2] = {0, 0};
 
     tensors[0]  = (vsi_nn_kernel_tensor_t)param[0];
     tensors[1]  = (vsi_nn_kernel_tensor_t)param[1];
@@ -92,7 +92,6 @@ DEF_KERNEL_EXECUTOR(_matrixmul_exec)
 
     buffer[2] = (float *)malloc( out_elements * sizeof(float) );
     CHECK_PTR_FAIL_GOTO( buffer[2], "Create output buffer fail.", final );
-    memset( buffer[2], 0, out_elements * sizeof(float) );
 
     K = attr[0]->shape->data[0];
     M = attr[2]->shape->data[1];
@@ -103,18 +102,12 @@ DEF_KERNEL_EXECUTOR(_matrixmul_exec)
         K = attr[0]->shape->data[1];
     }
 
-    strides0[0] = transposeA? 1:K;
-    strides0[1] = transposeA? M:1;
-
-    strides1[0] = transposeB? 1:N;
-    strides1[1] = transposeB? K:1;
-
     {
         vsi_size_t batch   = attr[2]->shape->size > 3 ? attr[2]->shape->data[3] : 1;
         vsi_size_t depth   = attr[2]->shape->size > 2 ? attr[2]->shape->data[2] : 1;
         vsi_size_t a_depth = attr[0]->shape->size > 2 ? attr[0]->shape->data[2] : 1;
         vsi_size_t b_depth = attr[1]->shape->size > 2 ? attr[1]->shape->data[2] : 1;
-        vsi_size_t b = 0, c = 0, j = 0, y = 0;
+        vsi_size_t b = 0, c = 0;
         vsi_size_t offsetA = 0, offsetB = 0, offsetD = 0;
         vsi_size_t ac2zero = 1;
         vsi_size_t bc2zero = 1;
@@ -139,21 +132,8 @@ DEF_KERNEL_EXECUTOR(_matrixmul_exec)
                 offsetA = c * M * K * ac2zero + b * M * K * a_depth;
                 offsetB = c * N * K * bc2zero + b * N * K * b_depth;
                 offsetD = c * M * N + b * M * N * depth;
-                for(i = 0 ; i < M; i++)
-                {
-                    for(j = 0; j < N; j++)
-                    {
-                        float sum = 0;
-                        for(y = 0; y < K; y++)
-                        {
-                            float dataA = buffer[0][i * strides0[0] + y * strides0[1] + offsetA];
-                            float dataB = buffer[1][y * strides1[0] + j * strides1[1] + offsetB];
-
-                            sum += dataA * dataB;
-                        }
-                        buffer[2][j + i * N + offsetD] = sum;
-                    }
-                }
+                vsi_nn_kernel_cpu_matmul_f32( buffer[0] + offsetA, buffer[1] + offsetB,
+                    buffer[2] + offsetD, M, K, N, (vsi_bool)transposeA, (vsi_bool)transposeB );
             }
         }
     }
@@ -79,6 +79,7 @@ DEF_KERNEL_EXECUTOR(_maximum_exec)
     vsi_nn_kernel_tensor_t tensors[_CPU_IO_NUM] = { NULL };
     float * buffer[_CPU_IO_NUM] = { NULL };
     vsi_size_t out_elements = 0;
+    vsi_bool raw_compute = FALSE;
     vsi_size_t stride_size[_CPU_INPUT_NUM][VSI_NN_MAX_DIM_NUM] = {{0}};
     vsi_nn_kernel_tensor_attr_t * attr[_CPU_IO_NUM] = { NULL };
     uint32_t i;
@@ -96,12 +97,50 @@ DEF_KERNEL_EXECUTOR(_maximum_exec)
 
     out_elements = vsi_nn_kernel_tensor_attr_get_size( attr[2] );
 
-    buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
+    /* With identical integer quantization the maximum of raw values is exact */
+    raw_compute = vsi_nn_kernel_dtype_is_integer( attr[2]->dtype )
+        && vsi_nn_kernel_tensor_attr_is_raw_compatible( attr[0], attr[2] )
+        && vsi_nn_kernel_tensor_attr_is_raw_compatible( attr[1], attr[2] );
+
+    buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], !raw_compute );
     CHECK_PTR_FAIL_GOTO( buffer[0], "Create input0 buffer fail.", final );
 
-    buffer[1] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[1], attr[1], TRUE );
+    buffer[1] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[1], attr[1], !raw_compute );
     CHECK_PTR_FAIL_GOTO( buffer[1], "Create input1 buffer fail.", final );
 
+    if( raw_compute )
+    {
+        vsi_nn_kernel_dtype_e dtype = attr[2]->dtype;
+        size_t element_bytes = vsi_nn_kernel_dtype_get_bytes( dtype );
+        const vsi_nn_kernel_tensor_attr_t * raw_attrs[] = { attr[0], attr[1], attr[2] };
+        uint8_t * out_ptr = NULL;
+
+        buffer[2] = (float *)malloc( out_elements * element_bytes );
+        CHECK_PTR_FAIL_GOTO( buffer[2], "Create output buffer fail.", final );
+        out_ptr = (uint8_t *)buffer[2];
+
+        for( i = 0; i < out_elements; i ++ )
+        {
+            vsi_ssize_t in0_offset = _expand_offset( i, attr[0]->shape->data,
+                    (vsi_size_t)attr[0]->shape->size, stride_size[0], attr[2]->shape->data );
+            vsi_ssize_t in1_offset = _expand_offset( i, attr[1]->shape->data,
+                    (vsi_size_t)attr[1]->shape->size, stride_size[1], attr[2]->shape->data );
+            int64_t val1 = vsi_nn_kernel_raw_load_int( buffer[0], dtype, in0_offset );
+            int64_t val2 = vsi_nn_kernel_raw_load_int( buffer[1], dtype, in1_offset );
+            const uint8_t * src = val1 >= val2 ?
+                (const uint8_t *)buffer[0] + in0_offset * element_bytes :
+                (const uint8_t *)buffer[1] + in1_offset * element_bytes;
+
+            memcpy( out_ptr + i * element_bytes, src, element_bytes );
+        }
+
+        status = vsi_nn_kernel_tensor_write( tensors[2], attr[2],
+                buffer[2], out_elements * element_bytes );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+        vsi_nn_kernel_cpu_add_bytes_saved( _KERNEL_NAME, raw_attrs, _cnt_of_array( raw_attrs ) );
+        goto final;
+    }
+
     buffer[2] = (float *)malloc( out_elements * sizeof(float) );
     CHECK_PTR_FAIL_GOTO( buffer[2], "Create output buffer fail.", final );
     memset( buffer[2], 0, out_elements * sizeof(float) );
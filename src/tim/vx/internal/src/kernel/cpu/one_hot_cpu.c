@@ -68,6 +68,35 @@ static vx_param_description_t _one_hot_kernel_param_def[] =
 #define _ONE_HOT_PARAM_NUM  _cnt_of_array( _one_hot_kernel_param_def )
 
 
+/*
+ * Convert a float to the dtype of attr, fail on per channel quantization.
+ */
+static vsi_status _convert_from_float
+    (
+    float value,
+    const vsi_nn_kernel_tensor_attr_t * attr,
+    void * out
+    )
+{
+    vsi_bool ret = FALSE;
+
+    if ( !vsi_nn_kernel_tensor_attr_is_quantized( attr ) )
+    {
+        ret = vsi_nn_dtype_convert_float_to_dtype( &value, 1, attr->dtype, out );
+    }
+    else if ( VSI_NN_KERNEL_QUANT_DFP == attr->quant )
+    {
+        ret = vsi_nn_dtype_convert_float_to_quantize_dfp( &value, 1, attr->dtype,
+            attr->dfp.fl, out );
+    }
+    else if ( VSI_NN_KERNEL_QUANT_ASYMM == attr->quant )
+    {
+        ret = vsi_nn_dtype_convert_float_to_quantize_asymm( &value, 1, attr->dtype,
+            attr->asymm.scale, attr->asymm.zero_point, out );
+    }
+    return ret ? VSI_SUCCESS : VSI_FAILURE;
+} /* _convert_from_float() */
+
 /*
  * Kernel function
  */
@@ -81,12 +110,17 @@ DEF_KERNEL_EXECUTOR(_compute)
     vsi_status status = VSI_FAILURE;
     vsi_nn_kernel_tensor_t tensors[_IO_NUM] = { NULL };
     float * buffer[_IO_NUM] = { NULL };
+    uint8_t * out_ptr = NULL;
     size_t out_elements = 0;
+    size_t element_bytes = sizeof(float);
+    vsi_bool raw_output = FALSE;
+    /* on and off values in the output dtype */
+    uint8_t on_raw[8] = { 0 };
+    uint8_t off_raw[8] = { 0 };
     vsi_nn_kernel_tensor_attr_t * attr[_IO_NUM] = { NULL };
     vsi_size_t i = 0;
     int32_t j = 0, m = 0;
     vsi_size_t k = 0;
-    int32_t index = 0;
     int32_t depth = 0;
     float on_value = 0;
     float off_value = 0;
@@ -113,10 +147,22 @@ DEF_KERNEL_EXECUTOR(_compute)
     buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
     CHECK_PTR_FAIL_GOTO( buffer[0], "Create input buffer fail.", final );
 
+    /* The output only holds on and off values, fill it in its own dtype */
+    element_bytes = vsi_nn_kernel_dtype_get_bytes( attr[1]->dtype );
+    raw_output = element_bytes <= sizeof(on_raw)
+        && VSI_SUCCESS == _convert_from_float( on_value, attr[1], on_raw )
+        && VSI_SUCCESS == _convert_from_float( off_value, attr[1], off_raw );
+    if ( !raw_output )
+    {
+        element_bytes = sizeof(float);
+        memcpy( on_raw, &on_value, sizeof(float) );
+        memcpy( off_raw, &off_value, sizeof(float) );
+    }
+
     out_elements = vsi_nn_kernel_tensor_attr_get_size( attr[1] );
-    buffer[1] = (float *)malloc( out_elements * sizeof(float) );
+    buffer[1] = (float *)malloc( out_elements * element_bytes );
     CHECK_PTR_FAIL_GOTO( buffer[1], "Create output buffer fail.", final );
-    memset( buffer[1], 0, out_elements * sizeof(float) );
+    out_ptr = (uint8_t *)buffer[1];
 
     axis = axis == -1 ? (int32_t)attr[0]->shape->size : (int32_t)attr[0]->shape->size - axis;
 
@@ -134,14 +180,26 @@ DEF_KERNEL_EXECUTOR(_compute)
             for (k = 0; k < suffix_dim_size; k++)
             {
                 int32_t value = (int32_t)buffer[0][i * suffix_dim_size + k];
-                buffer[1][index ++] = value == j ? on_value : off_value;
+                memcpy( out_ptr, value == j ? on_raw : off_raw, element_bytes );
+                out_ptr += element_bytes;
             }
         }
     }
 
-    status = vsi_nn_kernel_tensor_write_from_float( tensors[1], attr[1],
-            buffer[1], out_elements );
-    CHECK_STATUS_FAIL_GOTO( status, final );
+    if ( raw_output )
+    {
+        status = vsi_nn_kernel_tensor_write( tensors[1], attr[1],
+                buffer[1], out_elements * element_bytes );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+        vsi_nn_kernel_cpu_add_bytes_saved( _KERNEL_NAME,
+            (const vsi_nn_kernel_tensor_attr_t * const *)&attr[1], 1 );
+    }
+    else
+    {
+        status = vsi_nn_kernel_tensor_write_from_float( tensors[1], attr[1],
+                buffer[1], out_elements );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+    }
 final:
 #define SAFE_FREE_TENSOR_ATTR(_PTR) if ( _PTR ) { vsi_nn_kernel_tensor_attr_release( &_PTR ); _PTR = NULL; }
     SAFE_FREE_TENSOR_ATTR(attr[0]);
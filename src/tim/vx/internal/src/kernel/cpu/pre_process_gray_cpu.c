@@ -32,6 +32,7 @@
 #include "vsi_nn_prv.h"
 #include "vsi_nn_error.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "utils/vsi_nn_thread_pool.h"
 #include "libnnext/vsi_nn_vxkernel.h"
 
 __BEGIN_DECLS
@@ -45,6 +46,101 @@ __BEGIN_DECLS
 
 #define DESCALE(x) (((x) + (1<<19)) >> 20)
 
+typedef struct
+{
+    const float * src;
+    float * dst;
+    int32_t src_width;
+    int32_t dst_width;
+    int32_t xRatio;
+    int32_t yRatio;
+    int32_t xOffset;
+    int32_t yOffset;
+    float mean;
+    float scale;
+} _pre_process_gray_task_t;
+
+static void _pre_process_gray_rows
+    (
+    void * data,
+    size_t start,
+    size_t end
+    )
+{
+    const _pre_process_gray_task_t * t = (const _pre_process_gray_task_t *)data;
+    const float * src = t->src;
+    float * dst = t->dst;
+    int32_t line1[2], line2[2];
+    int32_t dx = 0, dy = 0;
+    int32_t src_width = t->src_width;
+    int32_t dst_width = t->dst_width;
+    int32_t xRatio = t->xRatio, yRatio = t->yRatio;
+    int32_t xOffset = t->xOffset, yOffset = t->yOffset;
+    float mean = t->mean, scale = t->scale;
+    uint8_t result = 0;
+
+    for ( dy = (int32_t)start; dy < (int32_t)end; dy ++)
+    {
+        for ( dx = 0; dx < (int32_t)dst_width; dx ++)
+        {
+            int32_t source_index = 0;
+            int32_t output_index = dx + dy * dst_width;
+            float finalVal = 0.0f;
+
+            if(xRatio != (1 << 15) || yRatio != (1 << 15))
+            {
+                int32_t fx = (dx * xRatio + (xRatio >> 1)) - (1 << 14);
+                int32_t sx = fx & 0xffff8000; // Floor
+                int32_t fy = 0, sy = 0;
+                int32_t temp1 = 0;
+                int32_t temp2 = 0;
+
+                fx -= sx;
+                sx = sx >> 15;
+
+                sx = sx < 0 ? 0 : sx;
+                sx = sx > src_width ? src_width - 1: sx;
+
+                fx = (fx +(1 << 4)) >> 5;
+
+                // for y
+                fy = (dy * yRatio + (yRatio >> 1)) - (1<< 14);
+                sy = fy & 0xffff8000; // Floor
+                fy -= sy;
+                sy = sy >> 15;
+
+                sy = sy < 0 ? 0 : sy;
+                fy = fy < 0 ? 0 : fy;
+
+                fy = (fy + (1<< 4)) >> 5;
+
+                sx += xOffset;
+                sy += yOffset;
+                source_index = (sx + sy * src_width);
+
+                line1[0] = (int32_t)src[source_index];
+                line1[1] = (int32_t)src[source_index + 1];
+                line2[0] = (int32_t)src[source_index + src_width];
+                line2[1] = (int32_t)src[source_index + src_width + 1];
+
+                temp1 = fx * (line1[1] - line1[0]) + (line1[0] << 10);
+                temp2 = fx * (line2[1] - line2[0]) + (line2[0] << 10);
+                temp1 = fy * (temp2 - temp1) + (temp1 << 10);
+                result = (uint8_t)(DESCALE(temp1));
+                finalVal = (result - mean) * scale;
+                dst[output_index] = finalVal;
+            }
+            else
+            {
+                int32_t offset = xOffset + yOffset * src_width;
+                source_index = dx + dy * src_width + offset;
+                finalVal = (src[source_index] - mean) * scale;
+                dst[output_index] = finalVal;
+            }
+        }
+    }
+} /* _pre_process_gray_rows() */
+
 DEF_KERNEL_EXECUTOR(_pre_process_gray_exec)
     (
     vsi_nn_kernel_node_t node,
@@ -93,77 +189,21 @@ DEF_KERNEL_EXECUTOR(_pre_process_gray_exec)
     memset( buffer[1], 0, out_elements * sizeof(float) );
 
     {
-        int32_t line1[2], line2[2];
-        int32_t dx = 0, dy = 0, dz = 0;
-        int32_t src_width = (int32_t)attr[0]->shape->data[0];
-        int32_t src_height = (int32_t)attr[0]->shape->data[1];
-        int32_t dst_width = (int32_t)attr[1]->shape->data[0];
+        _pre_process_gray_task_t task;
         int32_t dst_height = (int32_t)attr[1]->shape->data[1];
-        uint8_t result = 0;
 
-        for ( dz = 0; dz < 1; dz ++)
-        {
-            for ( dy = 0; dy < (int32_t)dst_height; dy ++)
-            {
-                for ( dx = 0; dx < (int32_t)dst_width; dx ++)
-                {
-                    int32_t source_index = 0;
-                    int32_t output_index = dx + dy * dst_width;
-                    float finalVal = 0.0f;
-
-                    if(xRatio != (1 << 15) || yRatio != (1 << 15))
-                    {
-                        int32_t fx = (dx * xRatio + (xRatio >> 1)) - (1 << 14);
-                        int32_t sx = fx & 0xffff8000; // Floor
-                        int32_t fy = 0, sy = 0;
-                        int32_t temp1 = 0;
-                        int32_t temp2 = 0;
-
-                        fx -= sx;
-                        sx = sx >> 15;
-
-                        sx = sx < 0 ? 0 : sx;
-                        sx = sx > src_width ? src_width - 1: sx;
-
-                        fx = (fx +(1 << 4)) >> 5;
-
-                        // for y
-                        fy = (dy * yRatio + (yRatio >> 1)) - (1<< 14);
-                        sy = fy & 0xffff8000; // Floor
-                        fy -= sy;
-                        sy = sy >> 15;
-
-                        sy = sy < 0 ? 0 : sy;
-                        fy = fy < 0 ? 0 : fy;
-
-                        fy = (fy + (1<< 4)) >> 5;
-
-                        sx += xOffset;
-                        sy += yOffset;
-                        source_index = (sx + sy * src_width + dz * src_width * src_height);
-
-                        line1[0] = (int32_t)buffer[0][source_index];
-                        line1[1] = (int32_t)buffer[0][source_index + 1];
-                        line2[0] = (int32_t)buffer[0][source_index + src_width];
-                        line2[1] = (int32_t)buffer[0][source_index + src_width + 1];
-
-                        temp1 = fx * (line1[1] - line1[0]) + (line1[0] << 10);
-                        temp2 = fx * (line2[1] - line2[0]) + (line2[0] << 10);
-                        temp1 = fy * (temp2 - temp1) + (temp1 << 10);
-                        result = (uint8_t)(DESCALE(temp1));
-                        finalVal = (result - mean) * scale;
-                        buffer[1][output_index] = finalVal;
-                    }
-                    else
-                    {
-                        int32_t offset = xOffset + yOffset * src_width;
-                        source_index = dx + dy * src_width + offset;
-                        finalVal = (buffer[0][source_index] - mean) * scale;
-                        buffer[1][output_index] = finalVal;
-                    }
-                }
-            }
-        }
+        task.src = buffer[0];
+        task.dst = buffer[1];
+        task.src_width = (int32_t)attr[0]->shape->data[0];
+        task.dst_width = (int32_t)attr[1]->shape->data[0];
+        task.xRatio = xRatio;
+        task.yRatio = yRatio;
+        task.xOffset = xOffset;
+        task.yOffset = yOffset;
+        task.mean = mean;
+        task.scale = scale;
+        /* Output rows are independent */
+        vsi_nn_parallel_for( (size_t)dst_height, 1, _pre_process_gray_rows, &task );
     }
 
     status = vsi_nn_kernel_tensor_write_from_float( tensors[1], attr[1],
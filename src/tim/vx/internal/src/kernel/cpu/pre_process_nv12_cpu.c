@@ -32,6 +32,7 @@
 #include "vsi_nn_prv.h"
 #include "vsi_nn_error.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "utils/vsi_nn_thread_pool.h"
 #include "libnnext/vsi_nn_vxkernel.h"
 
 __BEGIN_DECLS
@@ -45,6 +46,102 @@ __BEGIN_DECLS
 
 #define DESCALE(x) (((x) + (1<<19)) >> 20)
 
+typedef struct
+{
+    const float * src_y;
+    const float * src_uv;
+    float * dst;
+    int32_t src_width;
+    int32_t dst_width;
+    int32_t rOffset;
+    int32_t gOffset;
+    int32_t bOffset;
+    uint32_t xrIntFloat_16;
+    uint32_t yrIntFloat_16;
+    int32_t xOffset;
+    int32_t yOffset;
+    float rMean;
+    float gMean;
+    float bMean;
+    float var;
+    float min;
+    float max;
+} _pre_process_nv12_task_t;
+
+static void _pre_process_nv12_rows
+    (
+    void * data,
+    size_t start,
+    size_t end
+    )
+{
+    const _pre_process_nv12_task_t * t = (const _pre_process_nv12_task_t *)data;
+    const float * src_y = t->src_y;
+    const float * src_uv = t->src_uv;
+    float * dst = t->dst;
+    int32_t dx, dy;
+    int32_t src_width = t->src_width;
+    int32_t dst_width = t->dst_width;
+    int32_t rOffset = t->rOffset, gOffset = t->gOffset, bOffset = t->bOffset;
+    uint32_t xrIntFloat_16 = t->xrIntFloat_16, yrIntFloat_16 = t->yrIntFloat_16;
+    int32_t xOffset = t->xOffset, yOffset = t->yOffset;
+    float rMean = t->rMean, gMean = t->gMean, bMean = t->bMean, var = t->var;
+    float D, E;
+    float R, G, B;
+    float min = t->min;
+    float max = t->max;
+    const float* src_y_slice = NULL;
+    const float* src_uv_yScanline = NULL;
+    uint32_t srcy = 0, srcx = 0;
+
+    for ( dy = (int32_t)start; dy < (int32_t)end; dy ++)
+    {
+        srcy = (((uint32_t)dy * yrIntFloat_16) >> 16) + yOffset;
+        src_y_slice = src_y + (srcy) * src_width;
+        src_uv_yScanline = src_uv + (srcy / 2) * src_width;
+
+        for ( dx = 0; dx < (int32_t)dst_width; dx ++)
+        {
+            float finalVal = 0;
+            int32_t output_index = 0;
+            int32_t dstR_idx = 0, dstG_idx = 0, dstB_idx = 0;
+            float tmpY = 0.0f;
+            float tmpU = 0.0f;
+            float tmpV = 0.0f;
+
+            srcx = (((uint32_t)dx * xrIntFloat_16) >> 16) + xOffset;
+            tmpY = src_y_slice[srcx];
+            tmpU = src_uv_yScanline[(srcx / 2) * 2];
+            tmpV = src_uv_yScanline[(srcx / 2) * 2 + 1];
+
+            D = (tmpU - 128);
+            E = (tmpV - 128);
+
+            // B
+            B = (float)vsi_clamp((tmpY + (1.7790 * D)), min, max);
+            //G
+            G = (float)vsi_clamp((tmpY - 0.3455 * D - 0.7169 * E), min, max);
+            //R
+            R = (float)vsi_clamp((tmpY + 1.4065 * E), min, max);
+
+            output_index = dx + dy * dst_width;
+
+            dstR_idx = output_index + rOffset;
+            dstG_idx = output_index + gOffset;
+            dstB_idx = output_index + bOffset;
+
+            finalVal = (B - bMean) * var;
+            dst[dstB_idx] = finalVal;
+
+            finalVal = (G - gMean) * var;
+            dst[dstG_idx] = finalVal;
+
+            finalVal = (R - rMean) * var;
+            dst[dstR_idx] = finalVal;
+        }
+    }
+} /* _pre_process_nv12_rows() */
+
 DEF_KERNEL_EXECUTOR(_pre_process_nv12_exec)
     (
     vsi_nn_kernel_node_t node,
@@ -116,93 +213,45 @@ DEF_KERNEL_EXECUTOR(_pre_process_nv12_exec)
     }
 
     {
-        int32_t dx, dy, dz;
-        int32_t src_width = (int32_t)attr[0]->shape->data[0];
+        _pre_process_nv12_task_t task;
         int32_t dst_width = (int32_t)(trans ? attr[2]->shape->data[1] : attr[2]->shape->data[0]);
         int32_t dst_height = (int32_t)(trans ? attr[2]->shape->data[2] : attr[2]->shape->data[1]);
         int32_t stride = (int32_t)(dst_width * dst_height);
-        int32_t rOffset = 0;
-        int32_t gOffset = 1 * stride;
-        int32_t bOffset = 2 * stride;
-        float D, E;
-        float R, G, B;
-        float min = 0;
-        float max = 255;
-        float* src_y_slice = NULL;
-        float* src_uv_yScanline = NULL;
-
         uint32_t roi_width = (xRatio * dst_width) >> 15;
         uint32_t roi_height = (yRatio * dst_height) >> 15;
-        uint32_t xrIntFloat_16 = (roi_width << 16) / dst_width + 1;
-        uint32_t yrIntFloat_16 = (roi_height << 16) / dst_height + 1;
-        uint32_t srcy = 0, srcx = 0;
+
+        task.src_y = buffer[0];
+        task.src_uv = buffer[1];
+        task.dst = buffer[2];
+        task.src_width = (int32_t)attr[0]->shape->data[0];
+        task.dst_width = dst_width;
+        task.rOffset = order ? 2 * stride : 0;
+        task.gOffset = 1 * stride;
+        task.bOffset = order ? 0 : 2 * stride;
+        task.xrIntFloat_16 = (roi_width << 16) / dst_width + 1;
+        task.yrIntFloat_16 = (roi_height << 16) / dst_height + 1;
+        task.xOffset = xOffset;
+        task.yOffset = yOffset;
+        task.rMean = rMean;
+        task.gMean = gMean;
+        task.bMean = bMean;
+        task.var = var;
+        task.min = 0;
+        task.max = 255;
 
         if(attr[2]->dtype == I8)
         {
-            min = -128;
-            max = 127;
+            task.min = -128;
+            task.max = 127;
         }
         else if(attr[2]->dtype == I16 || attr[2]->dtype == F16)
         {
-            min = -65536;
-            max = 65535;
-        }
-
-        if(order)
-        {
-            rOffset = 2 * stride;
-            bOffset = 0;
+            task.min = -65536;
+            task.max = 65535;
         }
 
-        for ( dz = 0; dz < 1; dz ++)
-        {
-            for ( dy = 0; dy < (int32_t)dst_height; dy ++)
-            {
-                srcy = (((uint32_t)dy * yrIntFloat_16) >> 16) + yOffset;
-                src_y_slice = buffer[0] + (srcy) * src_width;
-                src_uv_yScanline = buffer[1] + (srcy / 2) * src_width;
-
-                for ( dx = 0; dx < (int32_t)dst_width; dx ++)
-                {
-                    float finalVal = 0;
-                    int32_t output_index = 0;
-                    int32_t dstR_idx = 0, dstG_idx = 0, dstB_idx = 0;
-                    float tmpY = 0.0f;
-                    float tmpU = 0.0f;
-                    float tmpV = 0.0f;
-
-                    srcx = (((uint32_t)dx * xrIntFloat_16) >> 16) + xOffset;
-                    tmpY = src_y_slice[srcx];
-                    tmpU = src_uv_yScanline[(srcx / 2) * 2];
-                    tmpV = src_uv_yScanline[(srcx / 2) * 2 + 1];
-
-                    D = (tmpU - 128);
-                    E = (tmpV - 128);
-
-                    // B
-                    B = (float)vsi_clamp((tmpY + (1.7790 * D)), min, max);
-                    //G
-                    G = (float)vsi_clamp((tmpY - 0.3455 * D - 0.7169 * E), min, max);
-                    //R
-                    R = (float)vsi_clamp((tmpY + 1.4065 * E), min, max);
-
-                    output_index = dx + dy * dst_width;
-
-                    dstR_idx = output_index + rOffset;
-                    dstG_idx = output_index + gOffset;
-                    dstB_idx = output_index + bOffset;
-
-                    finalVal = (B - bMean) * var;
-                    buffer[2][dstB_idx] = finalVal;
-
-                    finalVal = (G - gMean) * var;
-                    buffer[2][dstG_idx] = finalVal;
-
-                    finalVal = (R - rMean) * var;
-                    buffer[2][dstR_idx] = finalVal;
-                }
-            }
-        }
+        /* Output rows are independent */
+        vsi_nn_parallel_for( (size_t)dst_height, 1, _pre_process_nv12_rows, &task );
     }
 
     if(trans)
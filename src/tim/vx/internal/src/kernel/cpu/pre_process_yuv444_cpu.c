@@ -32,6 +32,7 @@
 #include "vsi_nn_prv.h"
 #include "vsi_nn_error.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "utils/vsi_nn_thread_pool.h"
 #include "libnnext/vsi_nn_vxkernel.h"
 
 __BEGIN_DECLS
@@ -45,6 +46,178 @@ __BEGIN_DECLS
 
 #define DESCALE(x) (((x) + (1<<19)) >> 20)
 
+typedef struct
+{
+    const float * src_y;
+    const float * src_u;
+    const float * src_v;
+    float * dst;
+    int32_t src_width;
+    int32_t dst_width;
+    int32_t rOffset;
+    int32_t gOffset;
+    int32_t bOffset;
+    int32_t xRatio;
+    int32_t yRatio;
+    int32_t xOffset;
+    int32_t yOffset;
+    float rMean;
+    float gMean;
+    float bMean;
+    float var;
+} _pre_process_yuv444_task_t;
+
+static void _pre_process_yuv444_rows
+    (
+    void * data,
+    size_t start,
+    size_t end
+    )
+{
+    const _pre_process_yuv444_task_t * t = (const _pre_process_yuv444_task_t *)data;
+    const float * src_y = t->src_y;
+    const float * src_u = t->src_u;
+    const float * src_v = t->src_v;
+    float * dst = t->dst;
+    uint8_t rline1[2], rline2[2];
+    uint8_t gline1[2], gline2[2];
+    uint8_t bline1[2], bline2[2];
+    int32_t dx, dy;
+    int32_t src_width = t->src_width;
+    int32_t dst_width = t->dst_width;
+    int32_t rOffset = t->rOffset, gOffset = t->gOffset, bOffset = t->bOffset;
+    int32_t xRatio = t->xRatio, yRatio = t->yRatio;
+    int32_t xOffset = t->xOffset, yOffset = t->yOffset;
+    float rMean = t->rMean, gMean = t->gMean, bMean = t->bMean, var = t->var;
+    int32_t C, D, E;
+    uint8_t R, G, B;
+    int32_t min = 0;
+    int32_t max = 255;
+
+    for ( dy = (int32_t)start; dy < (int32_t)end; dy ++)
+    {
+        for ( dx = 0; dx < (int32_t)dst_width; dx ++)
+        {
+            int32_t source_index = 0;
+            int32_t output_index = dx + dy * dst_width;
+            int32_t dstR_idx = output_index + rOffset;
+            int32_t dstG_idx = output_index + gOffset;
+            int32_t dstB_idx = output_index + bOffset;
+            float finalVal = 0;
+
+            if(xRatio != (1 << 15) || yRatio != (1 << 15))
+            {
+                int32_t fx = (dx * xRatio + (xRatio >> 1)) - (1 << 14);
+                int32_t sx = fx & 0xffff8000; // Floor
+                int32_t fy = 0, sy = 0;
+                int32_t temp1 = 0, temp2 = 0;
+
+                fx -= sx;
+                sx = sx >> 15;
+
+                sx = sx < 0 ? 0 : sx;
+                sx = sx > src_width ? src_width - 1: sx;
+
+                fx = (fx +(1 << 4)) >> 5;
+
+                // for y
+                fy = (dy * yRatio + (yRatio >> 1)) - (1<< 14);
+                sy = fy & 0xffff8000; // Floor
+                fy -= sy;
+                sy = sy >> 15;
+
+                sy = sy < 0 ? 0 : sy;
+                fy = fy < 0 ? 0 : fy;
+
+                fy = (fy + (1<< 4)) >> 5;
+
+                sx += xOffset;
+                sy += yOffset;
+                source_index = (sx + sy * src_width + 0);
+
+                /*C = ySrc[source_index] - 16;
+                D = uSrc[subIdx] - 128;
+                E = vSrc[subIdx] - 128;*/
+                C = (int)src_y[source_index] - 16;
+                D = (int)src_u[source_index] - 128;
+                E = (int)src_v[source_index] - 128;
+
+                rline1[0]            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
+                gline1[0]            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
+                bline1[0]            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
+
+                // right
+                C = (int)src_y[source_index + 1] - 16;
+                D = (int)src_u[source_index + 1] - 128;
+                E = (int)src_v[source_index + 1] - 128;
+
+                rline1[1]            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
+                gline1[1]            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
+                bline1[1]            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
+
+                // below
+                C = (int)src_y[source_index + src_width] - 16;
+                D = (int)src_u[source_index + src_width] - 128;
+                E = (int)src_v[source_index + src_width] - 128;
+
+                rline2[0]            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
+                gline2[0]            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
+                bline2[0]            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
+
+                // below right
+                //C = ySrc[source_index + src_width + 1] - 16;
+                C = (int)src_y[source_index + src_width + 1] - 16;
+                D = (int)src_u[source_index + src_width + 1] - 128;
+                E = (int)src_v[source_index + src_width + 1] - 128;
+
+                rline2[1]            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
+                gline2[1]            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
+                bline2[1]            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
+
+                //B
+                temp1 = fx * (bline1[1] - bline1[0]) + (bline1[0] << 10);
+                temp2 = fx * (bline2[1] - bline2[0]) + (bline2[0] << 10);
+                temp1 = fy * (temp2 - temp1) + (temp1 << 10);
+                B = (uint8_t)(DESCALE(temp1));
+                finalVal = (B - bMean) * var;
+                dst[dstB_idx] = finalVal;
+
+                //G
+                temp1 = fx * (gline1[1] - gline1[0]) + (gline1[0] << 10);
+                temp2 = fx * (gline2[1] - gline2[0]) + (gline2[0] << 10);
+                temp1 = fy * (temp2 - temp1) + (temp1 << 10);
+
+                G = (uint8_t)(DESCALE(temp1));
+                finalVal = (G - gMean) * var;
+                dst[dstG_idx] = finalVal;
+
+                // R
+                temp1 = fx * (rline1[1] - rline1[0]) + (rline1[0] << 10);
+                temp2 = fx * (rline2[1] - rline2[0]) + (rline2[0] << 10);
+                temp1 = fy * (temp2 - temp1) + (temp1 << 10);
+                R = (uint8_t)(DESCALE(temp1));
+                finalVal = (R - rMean) * var;
+                dst[dstR_idx] = finalVal;
+            }
+            else
+            {
+                // do conversion
+                C = (int)src_y[source_index] - 16;
+                D = (int)src_u[source_index] - 128;
+                E = (int)src_v[source_index] - 128;
+
+                R            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
+                G            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
+                B            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
+
+                dst[dstB_idx] = (B - bMean) * var;
+                dst[dstG_idx] = (G - gMean) * var;
+                dst[dstR_idx] = (R - rMean) * var;
+            }
+        }
+    }
+} /* _pre_process_yuv444_rows() */
+
 DEF_KERNEL_EXECUTOR(_pre_process_yuv444_exec)
     (
     vsi_nn_kernel_node_t node,
@@ -122,154 +295,30 @@ DEF_KERNEL_EXECUTOR(_pre_process_yuv444_exec)
     }
 
     {
-        uint8_t rline1[2], rline2[2];
-        uint8_t gline1[2], gline2[2];
-        uint8_t bline1[2], bline2[2];
-        int32_t dx, dy, dz;
-        int32_t src_width = (int32_t)attr[0]->shape->data[0];
-        int32_t src_height = (int32_t)attr[0]->shape->data[1];
+        _pre_process_yuv444_task_t task;
         int32_t dst_width = (int32_t)(trans ? attr[3]->shape->data[1] : attr[3]->shape->data[0]);
         int32_t dst_height = (int32_t)(trans ? attr[3]->shape->data[2] : attr[3]->shape->data[1]);
         int32_t stride = dst_width * dst_height;
-        int32_t rOffset = 0;
-        int32_t gOffset = 1 * stride;
-        int32_t bOffset = 2 * stride;
-        int32_t C, D, E;
-        uint8_t R, G, B;
-        int32_t min = 0;
-        int32_t max = 255;
-
-        if(order)
-        {
-            rOffset = 2 * stride;
-            bOffset = 0;
-        }
 
-        for ( dz = 0; dz < 1; dz ++)
-        {
-            for ( dy = 0; dy < (int32_t)dst_height; dy ++)
-            {
-                for ( dx = 0; dx < (int32_t)dst_width; dx ++)
-                {
-                    int32_t source_index = 0;
-                    int32_t output_index = dx + dy * dst_width;
-                    int32_t dstR_idx = output_index + rOffset;
-                    int32_t dstG_idx = output_index + gOffset;
-                    int32_t dstB_idx = output_index + bOffset;
-                    float finalVal = 0;
-
-                    if(xRatio != (1 << 15) || yRatio != (1 << 15))
-                    {
-                        int32_t fx = (dx * xRatio + (xRatio >> 1)) - (1 << 14);
-                        int32_t sx = fx & 0xffff8000; // Floor
-                        int32_t fy = 0, sy = 0;
-                        int32_t temp1 = 0, temp2 = 0;
-
-                        fx -= sx;
-                        sx = sx >> 15;
-
-                        sx = sx < 0 ? 0 : sx;
-                        sx = sx > src_width ? src_width - 1: sx;
-
-                        fx = (fx +(1 << 4)) >> 5;
-
-                        // for y
-                        fy = (dy * yRatio + (yRatio >> 1)) - (1<< 14);
-                        sy = fy & 0xffff8000; // Floor
-                        fy -= sy;
-                        sy = sy >> 15;
-
-                        sy = sy < 0 ? 0 : sy;
-                        fy = fy < 0 ? 0 : fy;
-
-                        fy = (fy + (1<< 4)) >> 5;
-
-                        sx += xOffset;
-                        sy += yOffset;
-                        source_index = (sx + sy * src_width + dz * src_width * src_height + 0);
-
-                        /*C = ySrc[source_index] - 16;
-                        D = uSrc[subIdx] - 128;
-                        E = vSrc[subIdx] - 128;*/
-                        C = (int)buffer[0][source_index] - 16;
-                        D = (int)buffer[1][source_index] - 128;
-                        E = (int)buffer[2][source_index] - 128;
-
-                        rline1[0]            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
-                        gline1[0]            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
-                        bline1[0]            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
-
-                        // right
-                        C = (int)buffer[0][source_index + 1] - 16;
-                        D = (int)buffer[1][source_index + 1] - 128;
-                        E = (int)buffer[2][source_index + 1] - 128;
-
-                        rline1[1]            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
-                        gline1[1]            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
-                        bline1[1]            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
-
-                        // below
-                        C = (int)buffer[0][source_index + src_width] - 16;
-                        D = (int)buffer[1][source_index + src_width] - 128;
-                        E = (int)buffer[2][source_index + src_width] - 128;
-
-                        rline2[0]            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
-                        gline2[0]            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
-                        bline2[0]            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
-
-                        // below right
-                        //C = ySrc[source_index + src_width + 1] - 16;
-                        C = (int)buffer[0][source_index + src_width + 1] - 16;
-                        D = (int)buffer[1][source_index + src_width + 1] - 128;
-                        E = (int)buffer[2][source_index + src_width + 1] - 128;
-
-                        rline2[1]            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
-                        gline2[1]            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
-                        bline2[1]            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
-
-                        //B
-                        temp1 = fx * (bline1[1] - bline1[0]) + (bline1[0] << 10);
-                        temp2 = fx * (bline2[1] - bline2[0]) + (bline2[0] << 10);
-                        temp1 = fy * (temp2 - temp1) + (temp1 << 10);
-                        B = (uint8_t)(DESCALE(temp1));
-                        finalVal = (B - bMean) * var;
-                        buffer[3][dstB_idx] = finalVal;
-
-                        //G
-                        temp1 = fx * (gline1[1] - gline1[0]) + (gline1[0] << 10);
-                        temp2 = fx * (gline2[1] - gline2[0]) + (gline2[0] << 10);
-                        temp1 = fy * (temp2 - temp1) + (temp1 << 10);
-
-                        G = (uint8_t)(DESCALE(temp1));
-                        finalVal = (G - gMean) * var;
-                        buffer[3][dstG_idx] = finalVal;
-
-                        // R
-                        temp1 = fx * (rline1[1] - rline1[0]) + (rline1[0] << 10);
-                        temp2 = fx * (rline2[1] - rline2[0]) + (rline2[0] << 10);
-                        temp1 = fy * (temp2 - temp1) + (temp1 << 10);
-                        R = (uint8_t)(DESCALE(temp1));
-                        finalVal = (R - rMean) * var;
-                        buffer[3][dstR_idx] = finalVal;
-                    }
-                    else
-                    {
-                        // do conversion
-                        C = (int)buffer[0][source_index] - 16;
-                        D = (int)buffer[1][source_index] - 128;
-                        E = (int)buffer[2][source_index] - 128;
-
-                        R            = (uint8_t)vsi_clamp((298 * C + 409 * E + 128) >> 8, min, max);
-                        G            = (uint8_t)vsi_clamp((298 * C - 100* D - 208 * E + 128) >> 8, min, max);
-                        B            = (uint8_t)vsi_clamp((298 * C + 516 * D + 128) >> 8, min, max);
-
-                        buffer[3][dstB_idx] = (B - bMean) * var;
-                        buffer[3][dstG_idx] = (G - gMean) * var;
-                        buffer[3][dstR_idx] = (R - rMean) * var;
-                    }
-                }
-            }
-        }
+        task.src_y = buffer[0];
+        task.src_u = buffer[1];
+        task.src_v = buffer[2];
+        task.dst = buffer[3];
+        task.src_width = (int32_t)attr[0]->shape->data[0];
+        task.dst_width = dst_width;
+        task.rOffset = order ? 2 * stride : 0;
+        task.gOffset = 1 * stride;
+        task.bOffset = order ? 0 : 2 * stride;
+        task.xRatio = xRatio;
+        task.yRatio = yRatio;
+        task.xOffset = xOffset;
+        task.yOffset = yOffset;
+        task.rMean = rMean;
+        task.gMean = gMean;
+        task.bMean = bMean;
+        task.var = var;
+        /* Output rows are independent */
+        vsi_nn_parallel_for( (size_t)dst_height, 1, _pre_process_yuv444_rows, &task );
     }
 
     if(trans)
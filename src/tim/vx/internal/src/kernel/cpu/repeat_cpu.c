@@ -58,13 +58,17 @@ DEF_KERNEL_EXECUTOR(_repeat_exec)
 {
     vsi_status status = VSI_FAILURE;
     vsi_nn_kernel_tensor_t tensors[_CPU_IO_NUM] = { NULL };
-    float * buffer[_CPU_IO_NUM] = { NULL };
+    void * buffer[_CPU_IO_NUM] = { NULL };
+    uint8_t * in_ptr = NULL;
+    uint8_t * out_ptr = NULL;
+    float * repeats = NULL;
     size_t out_elements = 0;
+    vsi_bool raw_copy = FALSE;
+    vsi_ssize_t element_bytes = sizeof(float);
     vsi_nn_kernel_tensor_attr_t * attr[_CPU_IO_NUM] = { NULL };
     vsi_ssize_t i = 0, j = 0, b = 0, c = 0;
     int32_t axis = 0;
     vsi_ssize_t outerSize = 1;
-    vsi_ssize_t outIdx = 0;
     vsi_ssize_t width = 0, height = 0, channel = 0, batch = 0;
     vsi_ssize_t spatial = 0, vol = 0;
 
@@ -84,15 +88,26 @@ DEF_KERNEL_EXECUTOR(_repeat_exec)
     status = vsi_nn_kernel_scalar_read_int32((vsi_nn_kernel_scalar_t)param[3], &axis);
     CHECK_STATUS_FAIL_GOTO(status, final );
 
-    buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
+    /* Repeat only moves data, copy raw elements if no requantization is needed */
+    raw_copy = vsi_nn_kernel_tensor_attr_is_raw_compatible( attr[0], attr[2] );
+    if( raw_copy )
+    {
+        element_bytes = (vsi_ssize_t)vsi_nn_kernel_dtype_get_bytes( attr[0]->dtype );
+    }
+
+    buffer[0] = vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], !raw_copy );
     CHECK_PTR_FAIL_GOTO( buffer[0], "Create input0 buffer fail.", final );
 
-    buffer[1] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[1], attr[1], TRUE );
+    buffer[1] = vsi_nn_kernel_tensor_create_buffer( tensors[1], attr[1], TRUE );
     CHECK_PTR_FAIL_GOTO( buffer[1], "Create input0 buffer fail.", final );
 
-    buffer[2] = (float *)malloc( out_elements * sizeof(float) );
+    buffer[2] = malloc( out_elements * element_bytes );
     CHECK_PTR_FAIL_GOTO( buffer[2], "Create output buffer fail.", final );
-    memset( buffer[2], 0, out_elements * sizeof(float) );
+    memset( buffer[2], 0, out_elements * element_bytes );
+
+    in_ptr = (uint8_t *)buffer[0];
+    out_ptr = (uint8_t *)buffer[2];
+    repeats = (float *)buffer[1];
 
     width   = attr[0]->shape->data[0];
     height  = attr[0]->shape->data[1];
@@ -110,11 +125,11 @@ DEF_KERNEL_EXECUTOR(_repeat_exec)
     {
         for(i = 0; i < width; i++)
         {
-            float data = buffer[0][i];
-            int32_t len = (int32_t)buffer[1][i];
+            int32_t len = (int32_t)repeats[i];
             for(j = 0; j < len; j++)
             {
-                buffer[2][outIdx] = data;
+                memcpy(out_ptr, in_ptr + i * element_bytes, element_bytes);
+                out_ptr += element_bytes;
             }
         }
     }
@@ -126,12 +141,12 @@ DEF_KERNEL_EXECUTOR(_repeat_exec)
             {
                 for(i = 0; i < height; i++)
                 {
-                    vsi_ssize_t len = (int32_t)buffer[1][i];
+                    vsi_ssize_t len = (int32_t)repeats[i];
                     vsi_ssize_t offset = i * width + c * spatial + b * vol;
                     for(j = 0; j < len; j++)
                     {
-                        memcpy(buffer[2] + outIdx, buffer[0] + offset, sizeof(float) * width);
-                        outIdx += width;
+                        memcpy(out_ptr, in_ptr + offset * element_bytes, element_bytes * width);
+                        out_ptr += element_bytes * width;
                     }
                 }
             }
@@ -148,12 +163,13 @@ DEF_KERNEL_EXECUTOR(_repeat_exec)
                     vsi_ssize_t offset = i * width + c * spatial + b * vol;
                     for(j = 0; j < width; j++)
                     {
-                        vsi_ssize_t len = (vsi_ssize_t)buffer[1][j];
-                        float data = buffer[0][offset + j];
+                        vsi_ssize_t len = (vsi_ssize_t)repeats[j];
+                        const uint8_t * data = in_ptr + (offset + j) * element_bytes;
                         vsi_ssize_t k = 0;
                         for(k = 0; k < len; k++)
                         {
-                            buffer[2][outIdx++] = data;
+                            memcpy(out_ptr, data, element_bytes);
+                            out_ptr += element_bytes;
                         }
                     }
                 }
@@ -166,13 +182,13 @@ DEF_KERNEL_EXECUTOR(_repeat_exec)
         {
             for(c = 0; c < channel; c++)
             {
-                vsi_ssize_t len = (vsi_ssize_t)buffer[1][c];
+                vsi_ssize_t len = (vsi_ssize_t)repeats[c];
                 vsi_ssize_t offset = c * spatial + b * vol;
 
                 for(j = 0; j < len; j++)
                 {
-                    memcpy(buffer[2] + outIdx, buffer[0] + offset, sizeof(float) * spatial);
-                    outIdx += spatial;
+                    memcpy(out_ptr, in_ptr + offset * element_bytes, element_bytes * spatial);
+                    out_ptr += element_bytes * spatial;
                 }
             }
         }
@@ -184,9 +200,20 @@ DEF_KERNEL_EXECUTOR(_repeat_exec)
         goto final;
     }
 
-    status = vsi_nn_kernel_tensor_write_from_float( tensors[2], attr[2],
-            buffer[2], out_elements );
-    CHECK_STATUS_FAIL_GOTO( status, final );
+    if( raw_copy )
+    {
+        const vsi_nn_kernel_tensor_attr_t * raw_attrs[] = { attr[0], attr[2] };
+        status = vsi_nn_kernel_tensor_write( tensors[2], attr[2],
+                buffer[2], out_elements * element_bytes );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+        vsi_nn_kernel_cpu_add_bytes_saved( _KERNEL_NAME, raw_attrs, _cnt_of_array( raw_attrs ) );
+    }
+    else
+    {
+        status = vsi_nn_kernel_tensor_write_from_float( tensors[2], attr[2],
+                (float *)buffer[2], out_elements );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+    }
 
 final:
     for( i = 0; i < _CPU_IO_NUM; i ++ )
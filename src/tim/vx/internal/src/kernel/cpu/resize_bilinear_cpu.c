@@ -35,6 +35,7 @@
 #include "vsi_nn_tensor_util.h"
 #include "utils/vsi_nn_util.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "kernel/cpu/vsi_nn_kernel_cpu_compute.h"
 #include "libnnext/vx_lib_nnext.h"
 
 __BEGIN_DECLS
@@ -85,17 +86,10 @@ DEF_KERNEL_EXECUTOR(_compute)
     uint32_t i;
     int32_t  align_corners;
     int32_t  half_pixel_centers;
-    float    width_scale;
-    float    height_scale;
     vsi_size_t input_width, output_width, input_height, output_height;
-    vsi_size_t b = 0, d = 0, w = 0, h = 0;
-    vsi_size_t output_depth, input_depth;
+    vsi_size_t output_depth;
     vsi_size_t output_batch;
-    vsi_size_t output_dims, input_dims;
-    float    data00 = .0f, data01 = .0f, data10 = .0f, data11 = .0f, interpolation = .0f;
-    vsi_size_t input_width_orig;
-    vsi_size_t output_width_orig;
-    vsi_size_t index;
+    vsi_size_t output_dims;
 
     /* prepare data */
     for(i = 0; i < _INPUT_NUM; i ++)
@@ -115,7 +109,6 @@ DEF_KERNEL_EXECUTOR(_compute)
         out_bytes[i] = out_elements[i] * sizeof(float);
         f32_out_buffer[i] = (float *)malloc( out_bytes[i] );
         CHECK_PTR_FAIL_GOTO( f32_out_buffer[i], "Create output buffer fail.", final );
-        memset( f32_out_buffer[i], 0, out_bytes[i] );
     }
 
     vsi_nn_kernel_scalar_read_int32((vsi_nn_kernel_scalar_t)param[SCALAR_ALIGN_CORNERS], &(align_corners));
@@ -127,90 +120,10 @@ DEF_KERNEL_EXECUTOR(_compute)
     output_dims       = (vsi_size_t)out_attr[0]->shape->size;
     output_depth      = output_dims > 2 ? out_attr[0]->shape->data[2] : 1;
     output_batch      = output_dims > 3 ? out_attr[0]->shape->data[3] : 1;
-    input_dims        = (vsi_size_t)in_attr[0]->shape->size;
-    input_depth       = input_dims > 2 ? in_attr[0]->shape->data[2] : 1;
-    input_width_orig  = input_width;
-    output_width_orig = output_width;
-
-    if (align_corners && output_width > 1)
-    {
-        width_scale = ((vx_float32)(input_width - 1) * 1.0f) / (vx_float32)(output_width - 1);
-    }
-    else
-    {
-        width_scale = ((vx_float32)input_width * 1.0f) / (vx_float32)output_width;
-    }
-
-    if (align_corners && output_height > 1)
-    {
-        height_scale = ((vx_float32)(input_height - 1) * 1.0f) / (vx_float32)(output_height - 1);
-    }
-    else
-    {
-        height_scale = ((vx_float32)input_height * 1.0f) / (vx_float32)output_height;
-    }
-
-    for (b = 0; b < output_batch; b ++)
-    {
-        for (d = 0; d < output_depth; d ++)
-        {
-            vsi_ssize_t input_base = b * input_depth * input_width_orig * input_height \
-            + d * input_width_orig * input_height;
-            vsi_ssize_t output_base = b * output_depth * output_width_orig * output_height \
-            + d * output_width_orig * output_height;
-
-            for (h = 0; h < output_height; h ++)
-            {
-                vx_float32 input_h = h * height_scale;
-                vsi_size_t h0;
-                vsi_size_t h1;
-
-                if (half_pixel_centers)
-                {
-                    input_h = ((vx_float32)h + 0.5f) * height_scale - 0.5f;
-                }
-                else
-                {
-                    input_h = h * height_scale;
-                }
-                h0 = (vsi_size_t)input_h;
-                h1 = input_h < 0 ? 0 : vsi_nn_min(h0 + 1, input_height - 1);
-                for (w = 0; w < output_width; w ++)
-                {
-                    vx_float32 input_w;
-                    vsi_ssize_t w0;
-                    vsi_ssize_t w1;
-                    if (half_pixel_centers)
-                    {
-                        input_w = ((vx_float32)w + 0.5f) * width_scale - 0.5f;
-                    }
-                    else
-                    {
-                        input_w = w * width_scale;
-                    }
-                    w0 = (vsi_ssize_t)input_w;
-                    w1 = input_w < 0 ? 0 : vsi_nn_min(w0 + 1, (vsi_ssize_t)(input_width - 1));
-                    index = input_base + h0 * input_width_orig + w0;
-                    data00 = f32_in_buffer[0][index];
-                    index = input_base + h0 * input_width_orig + w1;
-                    data01 = f32_in_buffer[0][index];
-                    index = input_base + h1 * input_width_orig + w0;
-                    data10 = f32_in_buffer[0][index];
-                    index = input_base + h1 * input_width_orig + w1;
-                    data11 = f32_in_buffer[0][index];
-
-                    interpolation = data00 * (1 - (input_h - h0)) * (1 - (input_w - w0)) +
-                                    data10 * (input_h - h0) * (1 - (input_w - w0)) +
-                                    data01 * (1 - (input_h - h0)) * (input_w - w0) +
-                                    data11 * (input_h - h0) * (input_w - w0);
-                    index = output_base + h * output_width_orig + w;
-                    f32_out_buffer[0][index] = interpolation;
-                }
-            }
-        }
-    }
-
 
+    vsi_nn_kernel_cpu_resize_bilinear_f32( f32_in_buffer[0], f32_out_buffer[0],
+        input_width, input_height, output_width, output_height,
+        output_batch * output_depth, (vsi_bool)align_corners, (vsi_bool)half_pixel_centers );
 
     /* save data */
     for(i = 0; i < _OUTPUT_NUM; i++)
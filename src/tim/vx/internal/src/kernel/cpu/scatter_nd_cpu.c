@@ -35,6 +35,7 @@
 #include "vsi_nn_error.h"
 #include "utils/vsi_nn_util.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "kernel/cpu/vsi_nn_kernel_cpu_compute.h"
 #include "libnnext/vsi_nn_vxkernel.h"
 
 __BEGIN_DECLS
@@ -65,6 +66,7 @@ DEF_KERNEL_EXECUTOR(_scatter_nd_exec)
     int32_t i = 0, j = 0;
     int32_t block_size = 1, indices_num = 1;
     int32_t coord_dim = 1;
+    vsi_ssize_t * offsets = NULL;
 
     tensors[0]  = (vsi_nn_kernel_tensor_t)param[0]; // idx    int
     tensors[1]  = (vsi_nn_kernel_tensor_t)param[1]; // update
@@ -112,10 +114,11 @@ DEF_KERNEL_EXECUTOR(_scatter_nd_exec)
             stride[i] = stride[i - 1] * new_shape[i];
         }
 
+        offsets = (vsi_ssize_t *)malloc( indices_num * sizeof(vsi_ssize_t) );
+        CHECK_PTR_FAIL_GOTO( offsets, "Create offset buffer fail.", final );
+
         for(i = 0; i < indices_num; i++)
         {
-            uint32_t in_index = i * block_size;
-            vsi_size_t out_index = 0;
             uint32_t coord[3] = {0};
             int32_t byd_flg = 0;
 
@@ -128,17 +131,12 @@ DEF_KERNEL_EXECUTOR(_scatter_nd_exec)
                     break;
                 }
             }
-            if(byd_flg)
-            {
-                continue;
-            }
-
-            out_index = (coord[2] * stride[1] + coord[1] * stride[0] + coord[0]) * block_size;
-            for(j = 0; j < block_size; j++)
-            {
-                buffer[1][out_index + j] += buffer[0][in_index + j];
-            }
+            /* Out of range indices are skipped */
+            offsets[i] = byd_flg ? -1 :
+                (coord[2] * stride[1] + coord[1] * stride[0] + coord[0]) * block_size;
         }
+
+        vsi_nn_kernel_cpu_scatter_add_f32( buffer[0], offsets, indices_num, block_size, buffer[1] );
     }
     else
     {
@@ -151,6 +149,7 @@ DEF_KERNEL_EXECUTOR(_scatter_nd_exec)
     CHECK_STATUS_FAIL_GOTO( status, final );
 
 final:
+    vsi_nn_safe_free( offsets );
     if( para_buffer[0] )
     {
         free( para_buffer[0] );
@@ -73,16 +73,14 @@ DEF_KERNEL_EXECUTOR(_compute)
     vsi_status status = VSI_FAILURE;
     vsi_nn_kernel_tensor_t input[_INPUT_NUM] = {NULL};
     vsi_nn_kernel_tensor_t output[_OUTPUT_NUM] = {NULL};
-    float *f32_in_buffer[_INPUT_NUM] = {NULL};
-    float *f32_out_buffer[_OUTPUT_NUM] = {NULL};
-    vsi_nn_kernel_tensor_attr_t *in_attr[_INPUT_NUM];
-    vsi_nn_kernel_tensor_attr_t *out_attr[_OUTPUT_NUM];
-    vsi_size_t   out_stride_size[_OUTPUT_NUM][VSI_NN_MAX_DIM_NUM] = {{1}};
+    void *in_buffer[_INPUT_NUM] = {NULL};
+    void *out_buffer[_OUTPUT_NUM] = {NULL};
+    vsi_nn_kernel_tensor_attr_t *in_attr[_INPUT_NUM] = {NULL};
+    vsi_nn_kernel_tensor_attr_t *out_attr[_OUTPUT_NUM] = {NULL};
     vsi_size_t   out_elements[_OUTPUT_NUM] = {0};
     vsi_size_t   out_bytes[_OUTPUT_NUM] = {0};
     int32_t  rank = 0;
     int32_t  i = 0;
-    vsi_ssize_t  in_w = 0;
     vsi_ssize_t  in_h = 0;
     vsi_ssize_t  in_c = 0;
     vsi_ssize_t  in_b = 0;
@@ -90,29 +88,45 @@ DEF_KERNEL_EXECUTOR(_compute)
     vsi_ssize_t stop[4] = {0};
     vsi_ssize_t in_size[4] = {1, 1, 1, 1};
     vsi_ssize_t out_size[4] = {1, 1, 1, 1};
-    float *input_ptr = NULL;
-    float *output_ptr = NULL;
-    int32_t dstIdx = 0;
+    float *start_ptr = NULL;
+    uint8_t *input_ptr = NULL;
+    uint8_t *output_ptr = NULL;
+    vsi_bool raw_copy = FALSE;
+    size_t element_bytes = sizeof(float);
+    size_t row_bytes = 0;
 
-    /* prepare data */
     for (i = 0; i < _INPUT_NUM; i ++)
     {
         input[i] = (vsi_nn_kernel_tensor_t)param[i];
         in_attr[i] = vsi_nn_kernel_tensor_attr_create( input[i] );
-        f32_in_buffer[i] = (float*)vsi_nn_kernel_tensor_create_buffer( input[i], in_attr[i], TRUE );
-        CHECK_PTR_FAIL_GOTO( f32_in_buffer[i], "Create input0 buffer fail.", final );
+        CHECK_PTR_FAIL_GOTO( in_attr[i], "Create tensor attr buffer fail.", final );
     }
-
     for (i = 0; i < _OUTPUT_NUM; i ++)
     {
         output[i] = (vsi_nn_kernel_tensor_t)param[i + _INPUT_NUM];
         out_attr[i] = vsi_nn_kernel_tensor_attr_create( output[i] );
-        vsi_nn_kernel_tensor_attr_get_stride( out_attr[i], out_stride_size[i] );
+        CHECK_PTR_FAIL_GOTO( out_attr[i], "Create tensor attr buffer fail.", final );
+    }
+
+    /* Slice only moves data, copy raw elements if no requantization is needed */
+    raw_copy = vsi_nn_kernel_tensor_attr_is_raw_compatible( in_attr[0], out_attr[0] );
+    if (raw_copy)
+    {
+        element_bytes = vsi_nn_kernel_dtype_get_bytes( in_attr[0]->dtype );
+    }
+
+    /* prepare data */
+    in_buffer[0] = vsi_nn_kernel_tensor_create_buffer( input[0], in_attr[0], !raw_copy );
+    CHECK_PTR_FAIL_GOTO( in_buffer[0], "Create input0 buffer fail.", final );
+    in_buffer[1] = vsi_nn_kernel_tensor_create_buffer( input[1], in_attr[1], TRUE );
+    CHECK_PTR_FAIL_GOTO( in_buffer[1], "Create input1 buffer fail.", final );
+
+    for (i = 0; i < _OUTPUT_NUM; i ++)
+    {
         out_elements[i] = vsi_nn_kernel_tensor_attr_get_size( out_attr[i] );
-        out_bytes[i] = out_elements[i] * sizeof(float);
-        f32_out_buffer[i] = (float *)malloc( out_bytes[i] );
-        CHECK_PTR_FAIL_GOTO( f32_out_buffer[i], "Create output buffer fail.", final );
-        memset( f32_out_buffer[i], 0, out_bytes[i] );
+        out_bytes[i] = out_elements[i] * element_bytes;
+        out_buffer[i] = malloc( out_bytes[i] );
+        CHECK_PTR_FAIL_GOTO( out_buffer[i], "Create output buffer fail.", final );
     }
 
     rank = (int32_t)out_attr[0]->shape->size;
@@ -123,16 +137,18 @@ DEF_KERNEL_EXECUTOR(_compute)
         out_size[i] = out_attr[0]->shape->data[i];
     }
 
-    start[0] = (vsi_ssize_t)f32_in_buffer[1][0];
+    start_ptr = (float *)in_buffer[1];
+    start[0] = (vsi_ssize_t)start_ptr[0];
     stop[0] = start[0] + out_attr[0]->shape->data[0];
-    start[1] = rank < 2 ? 0 : (vsi_ssize_t)f32_in_buffer[1][1];
+    start[1] = rank < 2 ? 0 : (vsi_ssize_t)start_ptr[1];
     stop[1] = rank < 2 ? 1 : start[1] + out_size[1];
-    start[2] = rank < 3 ? 0 : (vsi_ssize_t)f32_in_buffer[1][2];
+    start[2] = rank < 3 ? 0 : (vsi_ssize_t)start_ptr[2];
     stop[2] = rank < 3 ? 1 : start[2] + out_size[2];
-    start[3] = rank < 4 ? 0 : (vsi_ssize_t)f32_in_buffer[1][3];
+    start[3] = rank < 4 ? 0 : (vsi_ssize_t)start_ptr[3];
     stop[3] = rank < 4 ? 1 : start[3] + out_size[3];
-    input_ptr = f32_in_buffer[0];
-    output_ptr = f32_out_buffer[0];
+    input_ptr = (uint8_t *)in_buffer[0];
+    output_ptr = (uint8_t *)out_buffer[0];
+    row_bytes = (stop[0] - start[0]) * element_bytes;
 
     for (in_b = start[3]; in_b < stop[3]; ++in_b)
     {
@@ -140,30 +156,36 @@ DEF_KERNEL_EXECUTOR(_compute)
         {
             for (in_h = start[1]; in_h < stop[1]; ++in_h)
             {
-                for (in_w = start[0]; in_w < stop[0]; ++in_w)
-                {
-                    vsi_ssize_t srcIdx = ((in_b * in_size[2] + in_c) * in_size[1] + in_h) * in_size[0] + in_w;
-                    output_ptr[dstIdx ++] = input_ptr[srcIdx];
-                }
+                vsi_ssize_t srcIdx = ((in_b * in_size[2] + in_c) * in_size[1] + in_h) * in_size[0] + start[0];
+                memcpy( output_ptr, input_ptr + srcIdx * element_bytes, row_bytes );
+                output_ptr += row_bytes;
             }
         }
     }
 
     /* save data */
-    for(i = 0; i < _OUTPUT_NUM; i++)
+    if (raw_copy)
+    {
+        const vsi_nn_kernel_tensor_attr_t * raw_attrs[] = { in_attr[0], out_attr[0] };
+        status = vsi_nn_kernel_tensor_write( output[0], out_attr[0],
+            out_buffer[0], out_bytes[0] );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+        vsi_nn_kernel_cpu_add_bytes_saved( _KERNEL_NAME, raw_attrs, _cnt_of_array( raw_attrs ) );
+    }
+    else
     {
-        status = vsi_nn_kernel_tensor_write_from_float( output[i], out_attr[i],
-            f32_out_buffer[i], out_elements[i] );
+        status = vsi_nn_kernel_tensor_write_from_float( output[0], out_attr[0],
+            (float *)out_buffer[0], out_elements[0] );
         CHECK_STATUS_FAIL_GOTO( status, final );
     }
 
 final:
     for (i = 0; i < _INPUT_NUM; i++)
     {
-        if (f32_in_buffer[i])
+        if (in_buffer[i])
         {
-            free(f32_in_buffer[i]);
-            f32_in_buffer[i] = NULL;
+            free(in_buffer[i]);
+            in_buffer[i] = NULL;
         }
         if (in_attr[i])
         {
@@ -172,10 +194,10 @@ final:
     }
     for (i = 0; i < _OUTPUT_NUM; i++)
     {
-        if (f32_out_buffer[i])
+        if (out_buffer[i])
         {
-            free(f32_out_buffer[i]);
-            f32_out_buffer[i] = NULL;
+            free(out_buffer[i]);
+            out_buffer[i] = NULL;
         }
         if (out_attr[i])
         {
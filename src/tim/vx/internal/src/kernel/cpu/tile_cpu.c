@@ -43,39 +43,40 @@ __BEGIN_DECLS
 #define _CPU_PARAM_NUM          (_CPU_ARG_NUM + _CPU_IO_NUM)
 #define _KERNEL_NAME            CVIVANTE_NAMESPACE("tile_sw")
 
-void copyMultipleTimes(const float* in_data, vsi_size_t in_size, int32_t multiplier, float* out_data)
+void copyMultipleTimes(const uint8_t* in_data, vsi_size_t in_size, int32_t multiplier, uint8_t* out_data)
 {
     int i = 0;
 
     for ( i = 0; i < multiplier; ++i)
     {
-        memcpy(out_data, in_data, in_size * sizeof(float));
+        memcpy(out_data, in_data, in_size);
         out_data += in_size;
     }
 }
 
-void tileOneDimension(const vsi_size_array_t* input_shape, const float* in_data,
-                      const uint32_t* multipliers, float* out_data, int dimension,
-                      vsi_size_t *stride_size, vsi_size_t *tiled_stride_size)
+/* Sizes and strides are in bytes, the innermost dimension is scaled by element_bytes */
+void tileOneDimension(const vsi_size_array_t* input_shape, const uint8_t* in_data,
+                      const uint32_t* multipliers, uint8_t* out_data, int dimension,
+                      size_t element_bytes, vsi_size_t *stride_size, vsi_size_t *tiled_stride_size)
 {
     vsi_size_t i = 0;
     const vsi_size_t dimension_size = input_shape->data[dimension];
     vsi_ssize_t total_stride_size = 0, total_tiled_stride_size = 0;
-    const float* copy_from_data = in_data;
-    float* copy_to_data = out_data;
+    const uint8_t* copy_from_data = in_data;
+    uint8_t* copy_to_data = out_data;
 
     if (dimension == 0)
     {
-        copyMultipleTimes(in_data, dimension_size, multipliers[dimension], out_data);
-        *stride_size = dimension_size;
-        *tiled_stride_size = dimension_size * multipliers[dimension];
+        copyMultipleTimes(in_data, dimension_size * element_bytes, multipliers[dimension], out_data);
+        *stride_size = dimension_size * element_bytes;
+        *tiled_stride_size = dimension_size * element_bytes * multipliers[dimension];
         return ;
     }
 
     for (i = 0; i < dimension_size; ++i)
     {
-        tileOneDimension(
-                input_shape, copy_from_data, multipliers, copy_to_data, dimension - 1, stride_size, tiled_stride_size);
+        tileOneDimension(input_shape, copy_from_data, multipliers, copy_to_data,
+                dimension - 1, element_bytes, stride_size, tiled_stride_size);
         copy_from_data += *stride_size;
         copy_to_data += *tiled_stride_size;
         total_stride_size += *stride_size;
@@ -100,8 +101,10 @@ DEF_KERNEL_EXECUTOR(_tile_exec)
 {
     vsi_status status = VX_SUCCESS;
     vsi_nn_kernel_tensor_t tensors[_CPU_IO_NUM] = { NULL };
-    float * buffer[_CPU_IO_NUM] = { NULL };
+    void * buffer[_CPU_IO_NUM] = { NULL };
     size_t out_elements = 0;
+    vsi_bool raw_copy = FALSE;
+    size_t element_bytes = sizeof(float);
     vsi_nn_kernel_tensor_attr_t * attr[_CPU_IO_NUM] = { NULL };
     vsi_size_t i = 0;
     uint32_t multiples[VSI_NN_MAX_DIM_NUM] = {0};
@@ -116,24 +119,41 @@ DEF_KERNEL_EXECUTOR(_tile_exec)
 
     out_elements = vsi_nn_kernel_tensor_attr_get_size( attr[1] );
 
-    buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
+    /* Tile only moves data, copy raw elements if no requantization is needed */
+    raw_copy = vsi_nn_kernel_tensor_attr_is_raw_compatible( attr[0], attr[1] );
+    if( raw_copy )
+    {
+        element_bytes = vsi_nn_kernel_dtype_get_bytes( attr[0]->dtype );
+    }
+
+    buffer[0] = vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], !raw_copy );
     CHECK_PTR_FAIL_GOTO( buffer[0], "Create input0 buffer fail.", final );
 
-    buffer[1] = (float *)malloc( out_elements * sizeof(float) );
+    buffer[1] = malloc( out_elements * element_bytes );
     CHECK_PTR_FAIL_GOTO( buffer[1], "Create output buffer fail.", final );
-    memset( buffer[1], 0, out_elements * sizeof(float) );
 
     for (i = 0; i < attr[0]->shape->size; i++)
     {
         multiples[i] = (uint32_t)(attr[1]->shape->data[i] / attr[0]->shape->data[i]);
     }
 
-    tileOneDimension(attr[0]->shape, buffer[0], multiples, buffer[1],
-        (int32_t)attr[0]->shape->size - 1, &stride_size, &tiled_stride_size);
+    tileOneDimension(attr[0]->shape, (const uint8_t *)buffer[0], multiples, (uint8_t *)buffer[1],
+        (int32_t)attr[0]->shape->size - 1, element_bytes, &stride_size, &tiled_stride_size);
 
-    status = vsi_nn_kernel_tensor_write_from_float( tensors[1], attr[1],
-            buffer[1], out_elements );
-    CHECK_STATUS_FAIL_GOTO( status, final );
+    if( raw_copy )
+    {
+        const vsi_nn_kernel_tensor_attr_t * raw_attrs[] = { attr[0], attr[1] };
+        status = vsi_nn_kernel_tensor_write( tensors[1], attr[1],
+                buffer[1], out_elements * element_bytes );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+        vsi_nn_kernel_cpu_add_bytes_saved( _KERNEL_NAME, raw_attrs, _cnt_of_array( raw_attrs ) );
+    }
+    else
+    {
+        status = vsi_nn_kernel_tensor_write_from_float( tensors[1], attr[1],
+                (float *)buffer[1], out_elements );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+    }
 
 final:
     for( i = 0; i < _CPU_IO_NUM; i ++ )
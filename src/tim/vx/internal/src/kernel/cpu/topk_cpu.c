@@ -35,6 +35,7 @@
 #include "vsi_nn_tensor_util.h"
 #include "utils/vsi_nn_util.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "kernel/cpu/vsi_nn_kernel_cpu_compute.h"
 #include "libnnext/vx_lib_nnext.h"
 
 __BEGIN_DECLS
@@ -60,61 +61,6 @@ static vx_param_description_t _topk_kernel_param_def[] =
 };
 #define _TOPK_PARAM_NUM  _cnt_of_array( _topk_kernel_param_def )
 
-static uint32_t _max_comp_func(void* data, int32_t left, int32_t right)
-{
-    float* fdata = (float*)data;
-    if (fdata[left] >= fdata[right])
-    {
-        return TRUE;
-    }
-    else
-    {
-        return FALSE;
-    }
-}
-
-static void _find_top_k_1d
-(
-    float* input,
-    uint32_t input_len,
-    uint32_t k,
-    float* value,
-    uint32_t* indices
-)
-{
-    int32_t low = 0;
-    int32_t high = input_len - 1;
-    int32_t j;
-
-    for (j = 0; j < (int32_t)input_len; j++)
-    {
-        indices[j] = j;
-    }
-
-    j = vsi_nn_partition(input, low, high, _max_comp_func, FALSE, indices);
-
-    //part_sort
-    while (j != (int32_t)k)
-    {
-        if ((int32_t)k > j)
-        {
-            low = j + 1;
-        }
-        else
-        {
-            high = j;
-        }
-        j = vsi_nn_partition(input, low, high, _max_comp_func, FALSE, indices);
-    }
-    //all_sort
-    vsi_nn_partition(input, 0, k - 1, _max_comp_func, TRUE, indices);
-
-    for (j = 0; j < (int32_t)k; j++)
-    {
-        value[j] = input[indices[j]];
-    }
-}
-
 /*
  * Kernel function
  */
@@ -136,7 +82,6 @@ DEF_KERNEL_EXECUTOR(_compute)
     vsi_size_t   out_elements[_OUTPUT_NUM] = {0};
     vsi_size_t   out_bytes[_OUTPUT_NUM] = {0};
     uint32_t  i = 0;
-    int32_t  j = 0;
     int32_t  top_k = 0;
     uint32_t block_num = 0;
     uint32_t block_size = 0;
@@ -166,32 +111,21 @@ DEF_KERNEL_EXECUTOR(_compute)
     status = vsi_nn_kernel_scalar_read_int32( param[3], &top_k );
     CHECK_STATUS_FAIL_GOTO(status, final );
 
-    block_num = (uint32_t)in_attr[0]->shape->data[1];
     block_size = (uint32_t)in_attr[0]->shape->data[0];
-    indices_ptr = (uint32_t*)malloc(block_size * sizeof(uint32_t));
-    CHECK_PTR_FAIL_GOTO( indices_ptr, "Create indices buffer fail.", final );
-
-    for(i = 0; i < block_num; i++)
+    // Every dimension above the first one is a block
+    block_num = 1;
+    for (i = 1; i < (uint32_t)in_attr[0]->shape->size; i++)
     {
-        uint32_t in_index = i * block_size;
-        uint32_t out_index = i * top_k;
-        _find_top_k_1d(&(f32_in_buffer[0][in_index]),
-            block_size, top_k, &(f32_out_buffer[0][out_index]), indices_ptr);
-
-        for (j = 0; j < top_k; j++)
-        {
-            f32_out_buffer[1][out_index + j] = (float)indices_ptr[j];
-        }
+        block_num *= (uint32_t)in_attr[0]->shape->data[i];
     }
-    // Handle the 1D input
-    if (!block_num)
+    indices_ptr = (uint32_t*)malloc(block_num * top_k * sizeof(uint32_t));
+    CHECK_PTR_FAIL_GOTO( indices_ptr, "Create indices buffer fail.", final );
+
+    vsi_nn_kernel_cpu_topk_f32( f32_in_buffer[0], block_num, block_size, top_k,
+        f32_out_buffer[0], indices_ptr );
+    for (i = 0; i < block_num * (uint32_t)top_k; i++)
     {
-        _find_top_k_1d(&(f32_in_buffer[0][0]),
-            block_size, top_k, &(f32_out_buffer[0][0]), indices_ptr);
-        for (j = 0; j < top_k; j++)
-        {
-            f32_out_buffer[1][j] = (float)indices_ptr[j];
-        }
+        f32_out_buffer[1][i] = (float)indices_ptr[i];
     }
 
     /* save data */
@@ -0,0 +1,588 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <float.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vsi_nn_types.h"
+#include "vsi_nn_prv.h"
+#include "vsi_nn_log.h"
+#include "utils/vsi_nn_math.h"
+#include "utils/vsi_nn_util.h"
+#include "utils/vsi_nn_thread_pool.h"
+#include "kernel/cpu/vsi_nn_kernel_cpu_compute.h"
+#include "kernel/cpu/vsi_nn_kernel_cpu_simd.h"
+
+/* Minimum multiply-adds per parallel chunk */
+#define _MIN_CHUNK_OPS      (32 * 1024)
+/* Minimum bytes copied per parallel chunk */
+#define _MIN_CHUNK_BYTES    (16 * 1024)
+/* Matmul blocking, a block of b (_MATMUL_KB x _MATMUL_NB) stays in L2 */
+#define _MATMUL_KB          (128)
+#define _MATMUL_NB          (512)
+
+static size_t _grain
+    (
+    size_t min_work,
+    size_t work_per_item
+    )
+{
+    if( work_per_item >= min_work || 0 == work_per_item )
+    {
+        return 1;
+    }
+    return min_work / work_per_item;
+} /* _grain() */
+
+/*
+ * Matmul
+ */
+typedef struct
+{
+    const float * a;
+    const float * b;
+    float * c;
+    vsi_size_t M;
+    vsi_size_t K;
+    vsi_size_t N;
+    vsi_bool trans_a;
+    vsi_bool trans_b;
+} _matmul_task_t;
+
+static void _matmul_rows
+    (
+    void * data,
+    size_t start,
+    size_t end
+    )
+{
+    const _matmul_task_t * t = (const _matmul_task_t *)data;
+    vsi_size_t M = t->M, K = t->K, N = t->N;
+    size_t i, k, j;
+
+    if( !t->trans_b )
+    {
+        /* c[i, :] += a[i, k] * b[k, :], b rows are contiguous */
+        size_t jb, kb;
+        memset( t->c + start * N, 0, ( end - start ) * N * sizeof( float ) );
+        for( jb = 0; jb < N; jb += _MATMUL_NB )
+        {
+            size_t nb = vsi_nn_min( (size_t)_MATMUL_NB, N - jb );
+            for( kb = 0; kb < K; kb += _MATMUL_KB )
+            {
+                size_t ke = vsi_nn_min( kb + _MATMUL_KB, (size_t)K );
+                for( i = start; i < end; i++ )
+                {
+                    float * c_row = t->c + i * N + jb;
+                    for( k = kb; k < ke; k++ )
+                    {
+                        float a = t->trans_a ? t->a[k * M + i] : t->a[i * K + k];
+                        vsi_nn_simd_axpy_f32( c_row, t->b + k * N + jb, a, nb );
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        /* c[i, j] = dot(a[i, :], b[j, :]) */
+        float * a_row = NULL;
+        if( t->trans_a )
+        {
+            a_row = (float *)malloc( K * sizeof( float ) );
+            if( NULL == a_row )
+            {
+                VSILOGE( "Create matmul buffer fail." );
+                return;
+            }
+        }
+        for( i = start; i < end; i++ )
+        {
+            const float * a = t->a + i * K;
+            if( t->trans_a )
+            {
+                for( k = 0; k < K; k++ )
+                {
+                    a_row[k] = t->a[k * M + i];
+                }
+                a = a_row;
+            }
+            for( j = 0; j < N; j++ )
+            {
+                t->c[i * N + j] = vsi_nn_simd_dot_f32( a, t->b + j * K, K );
+            }
+        }
+        vsi_nn_safe_free( a_row );
+    }
+} /* _matmul_rows() */
+
+void vsi_nn_kernel_cpu_matmul_f32
+    (
+    const float * a,
+    const float * b,
+    float       * c,
+    vsi_size_t    M,
+    vsi_size_t    K,
+    vsi_size_t    N,
+    vsi_bool      trans_a,
+    vsi_bool      trans_b
+    )
+{
+    _matmul_task_t task;
+
+    task.a = a;
+    task.b = b;
+    task.c = c;
+    task.M = M;
+    task.K = K;
+    task.N = N;
+    task.trans_a = trans_a;
+    task.trans_b = trans_b;
+    vsi_nn_parallel_for( M, _grain( _MIN_CHUNK_OPS, (size_t)K * N ),
+        _matmul_rows, &task );
+} /* vsi_nn_kernel_cpu_matmul_f32() */
+
+/*
+ * Resize bilinear
+ */
+typedef struct
+{
+    const float * in;
+    float * out;
+    vsi_size_t in_w;
+    vsi_size_t in_h;
+    vsi_size_t out_w;
+    vsi_size_t out_h;
+    float height_scale;
+    vsi_bool half_pixel_centers;
+    const vsi_size_t * x0;
+    const vsi_size_t * x1;
+    const float * fx;
+} _resize_task_t;
+
+static void _resize_bilinear_rows
+    (
+    void * data,
+    size_t start,
+    size_t end
+    )
+{
+    const _resize_task_t * t = (const _resize_task_t *)data;
+    float * top = (float *)malloc( t->out_w * 2 * sizeof( float ) );
+    float * bottom = top + t->out_w;
+    size_t row, w;
+
+    if( NULL == top )
+    {
+        VSILOGE( "Create resize buffer fail." );
+        return;
+    }
+
+    for( row = start; row < end; row++ )
+    {
+        size_t plane = row / t->out_h;
+        size_t h = row % t->out_h;
+        const float * in = t->in + plane * t->in_w * t->in_h;
+        float input_h;
+        vsi_size_t h0, h1;
+        const float * in0;
+        const float * in1;
+        float fy;
+
+        if( t->half_pixel_centers )
+        {
+            input_h = ( (float)h + 0.5f ) * t->height_scale - 0.5f;
+        }
+        else
+        {
+            input_h = h * t->height_scale;
+        }
+        /* Truncate toward zero like the reference kernel */
+        h0 = (vsi_size_t)(vsi_ssize_t)input_h;
+        h1 = input_h < 0 ? 0 : vsi_nn_min( h0 + 1, t->in_h - 1 );
+        fy = input_h - (float)h0;
+        in0 = in + h0 * t->in_w;
+        in1 = in + h1 * t->in_w;
+
+        for( w = 0; w < t->out_w; w++ )
+        {
+            top[w] = in0[t->x0[w]] * ( 1 - t->fx[w] ) + in0[t->x1[w]] * t->fx[w];
+            bottom[w] = in1[t->x0[w]] * ( 1 - t->fx[w] ) + in1[t->x1[w]] * t->fx[w];
+        }
+        vsi_nn_simd_blend_f32( t->out + row * t->out_w, top, bottom,
+            1 - fy, fy, t->out_w );
+    }
+    free( top );
+} /* _resize_bilinear_rows() */
+
+void vsi_nn_kernel_cpu_resize_bilinear_f32
+    (
+    const float * in,
+    float       * out,
+    vsi_size_t    in_w,
+    vsi_size_t    in_h,
+    vsi_size_t    out_w,
+    vsi_size_t    out_h,
+    vsi_size_t    planes,
+    vsi_bool      align_corners,
+    vsi_bool      half_pixel_centers
+    )
+{
+    _resize_task_t task;
+    vsi_size_t * x0 = NULL;
+    vsi_size_t * x1 = NULL;
+    float * fx = NULL;
+    float width_scale;
+    vsi_size_t w;
+
+    if( align_corners && out_w > 1 )
+    {
+        width_scale = (float)( in_w - 1 ) / (float)( out_w - 1 );
+    }
+    else
+    {
+        width_scale = (float)in_w / (float)out_w;
+    }
+    if( align_corners && out_h > 1 )
+    {
+        task.height_scale = (float)( in_h - 1 ) / (float)( out_h - 1 );
+    }
+    else
+    {
+        task.height_scale = (float)in_h / (float)out_h;
+    }
+
+    /* Source columns and weights are shared by all rows */
+    x0 = (vsi_size_t *)malloc( out_w * sizeof( vsi_size_t ) );
+    x1 = (vsi_size_t *)malloc( out_w * sizeof( vsi_size_t ) );
+    fx = (float *)malloc( out_w * sizeof( float ) );
+    if( NULL == x0 || NULL == x1 || NULL == fx )
+    {
+        VSILOGE( "Create resize buffer fail." );
+        goto final;
+    }
+    for( w = 0; w < out_w; w++ )
+    {
+        float input_w;
+        if( half_pixel_centers )
+        {
+            input_w = ( (float)w + 0.5f ) * width_scale - 0.5f;
+        }
+        else
+        {
+            input_w = w * width_scale;
+        }
+        x0[w] = (vsi_size_t)(vsi_ssize_t)input_w;
+        x1[w] = input_w < 0 ? 0 : vsi_nn_min( x0[w] + 1, in_w - 1 );
+        fx[w] = input_w - (float)x0[w];
+    }
+
+    task.in = in;
+    task.out = out;
+    task.in_w = in_w;
+    task.in_h = in_h;
+    task.out_w = out_w;
+    task.out_h = out_h;
+    task.half_pixel_centers = half_pixel_centers;
+    task.x0 = x0;
+    task.x1 = x1;
+    task.fx = fx;
+    vsi_nn_parallel_for( (size_t)planes * out_h, _grain( _MIN_CHUNK_OPS, out_w * 8 ),
+        _resize_bilinear_rows, &task );
+
+final:
+    vsi_nn_safe_free( x0 );
+    vsi_nn_safe_free( x1 );
+    vsi_nn_safe_free( fx );
+} /* vsi_nn_kernel_cpu_resize_bilinear_f32() */
+
+/*
+ * Gather
+ */
+typedef struct
+{
+    const uint8_t * in;
+    const uint32_t * indices;
+    vsi_size_t indices_num;
+    vsi_size_t axis_num;
+    size_t block_bytes;
+    uint8_t * out;
+} _gather_task_t;
+
+static void _gather_blocks
+    (
+    void * data,
+    size_t start,
+    size_t end
+    )
+{
+    const _gather_task_t * t = (const _gather_task_t *)data;
+    size_t n;
+
+    for( n = start; n < end; n++ )
+    {
+        size_t i = n / t->indices_num;
+        size_t j = n % t->indices_num;
+        size_t in_block = i * t->axis_num + t->indices[j];
+        memcpy( t->out + n * t->block_bytes, t->in + in_block * t->block_bytes,
+            t->block_bytes );
+    }
+} /* _gather_blocks() */
+
+vsi_status vsi_nn_kernel_cpu_gather
+    (
+    const void     * in,
+    vsi_size_t       in_elements,
+    const uint32_t * indices,
+    vsi_size_t       indices_num,
+    vsi_size_t       block_size,
+    vsi_size_t       block_num,
+    vsi_size_t       axis_num,
+    vsi_size_t       element_bytes,
+    void           * out
+    )
+{
+    _gather_task_t task;
+    vsi_size_t j;
+    uint32_t max_index = 0;
+
+    if( 0 == block_num || 0 == indices_num )
+    {
+        return VSI_SUCCESS;
+    }
+    /* The last outer block reads furthest */
+    for( j = 0; j < indices_num; j++ )
+    {
+        max_index = vsi_nn_max( max_index, indices[j] );
+    }
+    if( ( ( block_num - 1 ) * axis_num + max_index ) * block_size >= in_elements )
+    {
+        VSILOGE( "Gather index %u is out of range.", max_index );
+        return VSI_FAILURE;
+    }
+
+    task.in = (const uint8_t *)in;
+    task.indices = indices;
+    task.indices_num = indices_num;
+    task.axis_num = axis_num;
+    task.block_bytes = block_size * element_bytes;
+    task.out = (uint8_t *)out;
+    vsi_nn_parallel_for( (size_t)block_num * indices_num,
+        _grain( _MIN_CHUNK_BYTES, task.block_bytes ), _gather_blocks, &task );
+    return VSI_SUCCESS;
+} /* vsi_nn_kernel_cpu_gather() */
+
+/*
+ * Scatter add
+ */
+typedef struct
+{
+    const float * updates;
+    const vsi_ssize_t * offsets;
+    vsi_size_t indices_num;
+    vsi_size_t block_size;
+    float * out;
+} _scatter_task_t;
+
+/* Split along the block so that duplicated indices never race */
+static void _scatter_add_columns
+    (
+    void * data,
+    size_t start,
+    size_t end
+    )
+{
+    const _scatter_task_t * t = (const _scatter_task_t *)data;
+    size_t i;
+
+    for( i = 0; i < t->indices_num; i++ )
+    {
+        if( t->offsets[i] >= 0 )
+        {
+            vsi_nn_simd_axpy_f32( t->out + t->offsets[i] + start,
+                t->updates + i * t->block_size + start, 1.0f, end - start );
+        }
+    }
+} /* _scatter_add_columns() */
+
+void vsi_nn_kernel_cpu_scatter_add_f32
+    (
+    const float       * updates,
+    const vsi_ssize_t * offsets,
+    vsi_size_t          indices_num,
+    vsi_size_t          block_size,
+    float             * out
+    )
+{
+    _scatter_task_t task;
+
+    task.updates = updates;
+    task.offsets = offsets;
+    task.indices_num = indices_num;
+    task.block_size = block_size;
+    task.out = out;
+    vsi_nn_parallel_for( block_size, _grain( _MIN_CHUNK_OPS, indices_num ),
+        _scatter_add_columns, &task );
+} /* vsi_nn_kernel_cpu_scatter_add_f32() */
+
+/*
+ * Top k
+ */
+typedef struct
+{
+    const float * in;
+    vsi_size_t row_len;
+    uint32_t k;
+    uint32_t stride;
+    float * values;
+    uint32_t * indices;
+} _topk_task_t;
+
+/* Whether element a ranks below element b */
+static vsi_bool _topk_less
+    (
+    const float * data,
+    uint32_t a,
+    uint32_t b
+    )
+{
+    return data[a] < data[b] || ( data[a] == data[b] && a > b );
+} /* _topk_less() */
+
+/* Restore the min-heap property below `pos` */
+static void _topk_sift_down
+    (
+    const float * data,
+    uint32_t * heap,
+    uint32_t size,
+    uint32_t pos
+    )
+{
+    for( ;; )
+    {
+        uint32_t smallest = pos;
+        uint32_t left = pos * 2 + 1;
+        uint32_t right = left + 1;
+        uint32_t tmp;
+
+        if( left < size && _topk_less( data, heap[left], heap[smallest] ) )
+        {
+            smallest = left;
+        }
+        if( right < size && _topk_less( data, heap[right], heap[smallest] ) )
+        {
+            smallest = right;
+        }
+        if( smallest == pos )
+        {
+            break;
+        }
+        tmp = heap[pos];
+        heap[pos] = heap[smallest];
+        heap[smallest] = tmp;
+        pos = smallest;
+    }
+} /* _topk_sift_down() */
+
+static void _topk_rows
+    (
+    void * data,
+    size_t start,
+    size_t end
+    )
+{
+    const _topk_task_t * t = (const _topk_task_t *)data;
+    size_t row;
+
+    for( row = start; row < end; row++ )
+    {
+        const float * in = t->in + row * t->row_len;
+        uint32_t * heap = t->indices + row * t->stride;
+        float * values = t->values + row * t->stride;
+        uint32_t k = t->k;
+        uint32_t i;
+
+        /* Keep the k largest in a min-heap, the smallest of them on top */
+        for( i = 0; i < k; i++ )
+        {
+            heap[i] = i;
+        }
+        for( i = k / 2; i > 0; i-- )
+        {
+            _topk_sift_down( in, heap, k, i - 1 );
+        }
+        for( i = k; i < t->row_len; i++ )
+        {
+            if( _topk_less( in, heap[0], i ) )
+            {
+                heap[0] = i;
+                _topk_sift_down( in, heap, k, 0 );
+            }
+        }
+
+        /* Heap sort into descending order */
+        for( i = k; i > 1; i-- )
+        {
+            uint32_t tmp = heap[0];
+            heap[0] = heap[i - 1];
+            heap[i - 1] = tmp;
+            _topk_sift_down( in, heap, i - 1, 0 );
+        }
+        for( i = 0; i < k; i++ )
+        {
+            values[i] = in[heap[i]];
+        }
+        for( i = k; i < t->stride; i++ )
+        {
+            values[i] = -FLT_MAX;
+            heap[i] = 0;
+        }
+    }
+} /* _topk_rows() */
+
+void vsi_nn_kernel_cpu_topk_f32
+    (
+    const float * in,
+    vsi_size_t    rows,
+    vsi_size_t    row_len,
+    uint32_t      k,
+    float       * values,
+    uint32_t    * indices
+    )
+{
+    _topk_task_t task;
+
+    if( 0 == k )
+    {
+        return;
+    }
+    task.in = in;
+    task.row_len = row_len;
+    task.k = k > row_len ? (uint32_t)row_len : k;
+    task.stride = k;
+    task.values = values;
+    task.indices = indices;
+    vsi_nn_parallel_for( rows, _grain( _MIN_CHUNK_OPS, row_len ),
+        _topk_rows, &task );
+} /* vsi_nn_kernel_cpu_topk_f32() */
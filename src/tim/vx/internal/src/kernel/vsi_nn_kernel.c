@@ -26,14 +26,19 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stdio.h>
+#include <time.h>
+#include <inttypes.h>
 #include "vsi_nn_context.h"
 #include "vsi_nn_prv.h"
 #include "vsi_nn_types.h"
 #include "vsi_nn_graph.h"
 #include "vsi_nn_log.h"
 #include "vsi_nn_error.h"
+#include "vsi_nn_tensor_util.h"
 #include "kernel/vsi_nn_kernel.h"
 #include "utils/vsi_nn_math.h"
+#include "utils/vsi_nn_util.h"
 
 #include "libnnext/vsi_nn_libnnext_resource.h"
 #if VSI_USE_VXC_BINARY
@@ -48,6 +53,8 @@ typedef struct
     void* reserve_mem;
 } kernel_program_info_t;
 
+#define VSI_NN_PROGRAM_CACHE_KEY_LEN    (17)
+
 static vsi_status _kernel_init_obj
     (
     vx_kernel_description_t* info,
@@ -69,13 +76,14 @@ static vsi_status _gpu_register
 static vx_program _create_program_from_executable
     (
     vsi_nn_graph_t* graph,
-    vsi_nn_kernel_t* kernel
+    kernel_program_info_t* program_info
     );
 
 static vx_program _create_program_from_code
     (
     vsi_nn_graph_t* graph,
-    vsi_nn_kernel_t* kernel
+    kernel_program_info_t* program_info,
+    size_t num
     );
 
 static const void* _load_internal_executable
@@ -319,23 +327,49 @@ static vx_program _create_program
     return program;
 } /* _create_program() */
 
-static vx_program _create_program_from_code
+static void _release_program_info
     (
-    vsi_nn_graph_t* graph,
-    vsi_nn_kernel_t* kernel
+    kernel_program_info_t* program_info,
+    size_t num
+    )
+{
+    size_t i;
+    if( !program_info )
+    {
+        return;
+    }
+    for( i = 0; i < num; i ++ )
+    {
+        if( program_info[i].reserve_mem )
+        {
+            free( program_info[i].reserve_mem );
+        }
+    }
+    free( program_info );
+} /* _release_program_info() */
+
+static kernel_program_info_t* _load_program_info
+    (
+    vsi_nn_kernel_t* kernel,
+    vsi_nn_gpu_source_fmt_e fmt,
+    size_t* num
     )
 {
     const vsi_nn_kernel_source_info_t* source_info;
     kernel_program_info_t* program_info;
     size_t i;
-    vx_program program = NULL;
-    source_info = &kernel->gpu.sources[VSI_NN_GPU_SOURCE_FMT_CODE];
+    source_info = &kernel->gpu.sources[fmt];
 
+    *num = 0;
     if( source_info->num == 0 )
     {
         VSILOGE("Not executable source found in kernel.");
         return NULL;
     }
+    if( VSI_NN_GPU_SOURCE_FMT_EXECUTABLE == fmt )
+    {
+        VSI_ASSERT( source_info->num == 1 );
+    }
     program_info = (kernel_program_info_t*)malloc(
             source_info->num * sizeof(kernel_program_info_t) );
     if( !program_info )
@@ -347,6 +381,12 @@ static vx_program _create_program_from_code
 
     for( i = 0; i < source_info->num; i ++ )
     {
+        if( VSI_NN_GPU_SOURCE_FMT_EXECUTABLE == fmt )
+        {
+            program_info[i].data = _load_internal_executable(
+                    source_info->data[i], &program_info[i].size );
+            continue;
+        }
         program_info[i].data = (const void*)vsi_nn_resource_load_source_code(
                 source_info->data[i], &program_info[i].size, kernel->type );
         if( !program_info[i].data )
@@ -356,47 +396,134 @@ static vx_program _create_program_from_code
             program_info[i].data = (const void*)program_info[i].reserve_mem;
         }
     }
-    program = _create_program( graph->ctx->c, program_info, source_info->num );
-    if( program_info )
+    *num = source_info->num;
+    return program_info;
+} /* _load_program_info() */
+
+static vx_program _create_program_from_code
+    (
+    vsi_nn_graph_t* graph,
+    kernel_program_info_t* program_info,
+    size_t num
+    )
+{
+    return _create_program( graph->ctx->c, program_info, num );
+} /* _create_program_from_code() */
+
+static vx_program _create_program_from_executable
+    (
+    vsi_nn_graph_t* graph,
+    kernel_program_info_t* program_info
+    )
+{
+    return vxCreateProgramWithBinary( graph->ctx->c,
+            (const vx_uint8 *)program_info->data, program_info->size );
+} /* _create_program_from_executable() */
+
+static uint64_t _fnv1a_hash
+    (
+    uint64_t hash,
+    const void* data,
+    size_t size
+    )
+{
+    size_t i;
+    const uint8_t* ptr = (const uint8_t*)data;
+    for( i = 0; i < size; i ++ )
+    {
+        hash ^= (uint64_t)ptr[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+} /* _fnv1a_hash() */
+
+/*
+ * Program cache key is the hash of the program sources, the build options
+ * and the hardware config used to build it.
+ */
+static void _get_program_cache_key
+    (
+    const vsi_nn_context_t context,
+    vsi_nn_gpu_source_fmt_e fmt,
+    const kernel_program_info_t* program_info,
+    size_t num,
+    const char* build_option,
+    char key[VSI_NN_PROGRAM_CACHE_KEY_LEN]
+    )
+{
+    size_t i;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    uint32_t config[3];
+
+    config[0] = (uint32_t)fmt;
+    config[1] = (uint32_t)context->config.evis.ver;
+    config[2] = context->config.use_40bits_va;
+    hash = _fnv1a_hash( hash, config, sizeof( config ) );
+    for( i = 0; i < num; i ++ )
     {
-        for( i = 0; i < source_info->num; i ++ )
+        hash = _fnv1a_hash( hash, &program_info[i].size, sizeof( size_t ) );
+        if( program_info[i].data )
         {
-            if( program_info[i].reserve_mem )
-            {
-                free( program_info[i].reserve_mem );
-            }
+            hash = _fnv1a_hash( hash, program_info[i].data, program_info[i].size );
         }
-        free( program_info );
     }
-    return program;
-} /* _create_program_from_code() */
+    hash = _fnv1a_hash( hash, build_option, strlen( build_option ) );
+    snprintf( key, VSI_NN_PROGRAM_CACHE_KEY_LEN, "%08x%08x",
+            (uint32_t)( hash >> 32 ), (uint32_t)hash );
+} /* _get_program_cache_key() */
 
-static vx_program _create_program_from_executable
+static vx_program _create_program_from_cache_dir
     (
     vsi_nn_graph_t* graph,
-    vsi_nn_kernel_t* kernel
+    const char* dir,
+    const char* key
     )
 {
-    const vsi_nn_kernel_source_info_t* source_info;
-    kernel_program_info_t program_info;
+    char path[VSI_NN_MAX_PATH];
+    FILE* fp;
+    char* binary = NULL;
+    long size = 0;
     vx_program program = NULL;
-    source_info = &kernel->gpu.sources[VSI_NN_GPU_SOURCE_FMT_EXECUTABLE];
 
-    if( source_info->num == 0 )
+    if( !dir )
     {
-        VSILOGE("Not executable source found in kernel.");
         return NULL;
     }
-
-    VSI_ASSERT( source_info->num == 1 );
-    memset( &program_info, 0, sizeof( kernel_program_info_t ) );
-
-    program_info.data = _load_internal_executable(
-            source_info->data[0], &program_info.size);
-    program = vxCreateProgramWithBinary( graph->ctx->c,
-            (const vx_uint8 *)program_info.data, program_info.size );
+    snprintf( path, VSI_NN_MAX_PATH, "%s/%s.bin", dir, key );
+    /* A missing binary is the common case, read it here instead of through
+     * _load_source_code_from_file() which reports it as an error. */
+    fp = fopen( path, "rb" );
+    if( NULL == fp )
+    {
+        return NULL;
+    }
+    fseek( fp, 0, SEEK_END );
+    size = ftell( fp );
+    fseek( fp, 0, SEEK_SET );
+    if( size > 0 )
+    {
+        binary = (char*)malloc( size );
+    }
+    if( binary && (size_t)size != fread( binary, 1, size, fp ) )
+    {
+        VSILOGW("Read %s fail.", path);
+        free( binary );
+        binary = NULL;
+    }
+    fclose( fp );
+    if( binary )
+    {
+        program = vxCreateProgramWithBinary( graph->ctx->c,
+                (const vx_uint8 *)binary, size );
+        if( VSI_SUCCESS != vxGetStatus( (vx_reference)program ) )
+        {
+            VSILOGW("Create program from %s fail.", path);
+            program = NULL;
+        }
+        free( binary );
+    }
     return program;
-} /* _create_program_from_executable() */
+} /* _create_program_from_cache_dir() */
 
 static vsi_status _gpu_register
     (
@@ -408,7 +535,12 @@ static vsi_status _gpu_register
     vx_kernel_description_t* info;
     vx_kernel obj;
     vsi_nn_context_t context;
+    vsi_nn_program_cache_t* cache;
     vx_program program = NULL;
+    vsi_bool cached = FALSE;
+    kernel_program_info_t* program_info = NULL;
+    size_t program_num = 0;
+    char key[VSI_NN_PROGRAM_CACHE_KEY_LEN] = { 0 };
     const vsi_nn_gpu_source_fmt_e active_fmt = kernel->gpu.active_source_fmt;
 
 #define MAX_BUILDPROGRAM_LEN 1024
@@ -417,24 +549,15 @@ static vsi_status _gpu_register
 
     memset( cmd, 0, sizeof(char) * MAX_BUILDPROGRAM_LEN );
     context = graph->ctx;
+    cache = &context->program_cache;
 
     status = VSI_FAILURE;
     info = &(kernel->info);
 
-    switch( active_fmt )
-    {
-        case VSI_NN_GPU_SOURCE_FMT_CODE:
-            program = _create_program_from_code( graph, kernel );
-            break;
-        case VSI_NN_GPU_SOURCE_FMT_EXECUTABLE:
-            program = _create_program_from_executable( graph, kernel );
-            break;
-        default:
-            VSILOGE("Unknown source format %d", kernel->gpu.active_source_fmt);
-            break;
-    }
-    if( NULL == program )
+    if( VSI_NN_GPU_SOURCE_FMT_CODE != active_fmt
+        && VSI_NN_GPU_SOURCE_FMT_EXECUTABLE != active_fmt )
     {
+        VSILOGE("Unknown source format %d", kernel->gpu.active_source_fmt);
         return status;
     }
 
@@ -470,13 +593,80 @@ static vsi_status _gpu_register
         }
     }
 
-    status = vxBuildProgram( program, cmd );
-
-    if( VSI_SUCCESS != status )
+    program_info = _load_program_info( kernel, active_fmt, &program_num );
+    if( NULL == program_info )
     {
-        VSILOGE("Build program fail.");
         return status;
     }
+    _get_program_cache_key( context, active_fmt, program_info, program_num, cmd, key );
+
+    /* Programs built by other kernels or graphs of this context are reused. */
+    vsi_nn_mutex_lock( context->lock );
+    program = (vx_program)vsi_nn_hashmap_get( cache->programs, key );
+    if( program )
+    {
+        cache->hit ++;
+        cached = TRUE;
+    }
+    vsi_nn_mutex_unlock( context->lock );
+    if( NULL == program )
+    {
+        /* Built without the lock, a thread building the same program at the
+         * same time is resolved on insert. */
+        program = _create_program_from_cache_dir( graph, cache->dir, key );
+        if( program )
+        {
+            vsi_nn_mutex_lock( context->lock );
+            cache->disk_hit ++;
+            vsi_nn_mutex_unlock( context->lock );
+        }
+        else
+        {
+            VSILOGD("Program cache miss %s for kernel %s.", key, info->name);
+            vsi_nn_mutex_lock( context->lock );
+            cache->miss ++;
+            vsi_nn_mutex_unlock( context->lock );
+            if( VSI_NN_GPU_SOURCE_FMT_CODE == active_fmt )
+            {
+                program = _create_program_from_code( graph, program_info, program_num );
+            }
+            else
+            {
+                program = _create_program_from_executable( graph, program_info );
+            }
+        }
+        if( NULL == program )
+        {
+            goto final;
+        }
+
+        status = vxBuildProgram( program, cmd );
+
+        if( VSI_SUCCESS != status )
+        {
+            VSILOGE("Build program fail.");
+            vxReleaseProgram( &program );
+            goto final;
+        }
+        if( cache->programs )
+        {
+            vx_program built = NULL;
+            vsi_nn_mutex_lock( context->lock );
+            built = (vx_program)vsi_nn_hashmap_get( cache->programs, key );
+            if( built )
+            {
+                /* Another thread cached it first, keep a single copy */
+                vxReleaseProgram( &program );
+                program = built;
+            }
+            else
+            {
+                vsi_nn_hashmap_add( cache->programs, key, (void*)program );
+            }
+            vsi_nn_mutex_unlock( context->lock );
+            cached = TRUE;
+        }
+    }
 
     obj = vxAddKernelInProgram(
         program,
@@ -495,12 +685,16 @@ static vsi_status _gpu_register
     }
     else
     {
+        status = VSI_FAILURE;
         VSILOGE( "Add kernel %s fail.", info->name );
     }
-    if( program )
+    if( program && !cached )
     {
         vxReleaseProgram( &program );
     }
+
+final:
+    _release_program_info( program_info, program_num );
     return status;
 } /* _gpu_register() */
 
@@ -877,6 +1071,380 @@ void vsi_nn_kernel_reset
     }
 } /* vsi_nn_kernel_reset() */
 
+#define VSI_NN_AUTOTUNE_WARMUP_RUNS     (1)
+#define VSI_NN_AUTOTUNE_RUNS            (10)
+
+static uint64_t _hash_tensor_attr
+    (
+    uint64_t hash,
+    const vsi_nn_tensor_t * tensor
+    )
+{
+    const vsi_nn_tensor_attr_t * attr;
+    vsi_bool exists = NULL != tensor;
+    hash = _fnv1a_hash( hash, &exists, sizeof( exists ) );
+    if( !exists )
+    {
+        return hash;
+    }
+    attr = &tensor->attr;
+    hash = _fnv1a_hash( hash, &attr->dim_num, sizeof( attr->dim_num ) );
+    hash = _fnv1a_hash( hash, attr->size, attr->dim_num * sizeof( vsi_size_t ) );
+    hash = _fnv1a_hash( hash, &attr->is_const, sizeof( attr->is_const ) );
+    hash = _fnv1a_hash( hash, &attr->dtype.vx_type, sizeof( attr->dtype.vx_type ) );
+    hash = _fnv1a_hash( hash, &attr->dtype.qnt_type, sizeof( attr->dtype.qnt_type ) );
+    switch( attr->dtype.qnt_type )
+    {
+        case VSI_NN_QNT_TYPE_DFP:
+            hash = _fnv1a_hash( hash, &attr->dtype.fl, sizeof( attr->dtype.fl ) );
+            break;
+        case VSI_NN_QNT_TYPE_AFFINE_ASYMMETRIC:
+            hash = _fnv1a_hash( hash, &attr->dtype.zero_point,
+                    sizeof( attr->dtype.zero_point ) );
+            hash = _fnv1a_hash( hash, &attr->dtype.scale, sizeof( attr->dtype.scale ) );
+            break;
+#ifdef VSI_PERCHANNEL_QUANTIZATION_SUPPORT
+        case VSI_NN_QNT_TYPE_AFFINE_PERCHANNEL_SYMMETRIC:
+            hash = _fnv1a_hash( hash, &attr->dtype.channel_dim,
+                    sizeof( attr->dtype.channel_dim ) );
+            break;
+#endif
+        default:
+            break;
+    }
+    return hash;
+} /* _hash_tensor_attr() */
+
+/*
+ * Tuning DB key is the hash of the kernel name, the io tensors, the kernel
+ * params and the hardware config the kernels run on.
+ */
+static void _get_tuning_db_key
+    (
+    const vsi_nn_graph_t * graph,
+    const char * kernel_name,
+    vsi_nn_tensor_t ** inputs,
+    size_t input_num,
+    vsi_nn_tensor_t ** outputs,
+    size_t output_num,
+    const vsi_nn_kernel_param_t * params,
+    char key[VSI_NN_TUNING_DB_KEY_LEN]
+    )
+{
+    size_t i;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const vsi_nn_hw_config_t * config = &graph->ctx->config;
+
+    hash = _fnv1a_hash( hash, kernel_name, strlen( kernel_name ) + 1 );
+    hash = _fnv1a_hash( hash, config->target_name,
+            strnlen( config->target_name, VSI_NN_MAX_TARGET_NAME ) );
+    hash = _fnv1a_hash( hash, &config->evis.ver, sizeof( config->evis.ver ) );
+    hash = _fnv1a_hash( hash, &config->use_40bits_va, sizeof( config->use_40bits_va ) );
+    hash = _fnv1a_hash( hash, &input_num, sizeof( size_t ) );
+    for( i = 0; i < input_num; i ++ )
+    {
+        hash = _hash_tensor_attr( hash, inputs[i] );
+    }
+    hash = _fnv1a_hash( hash, &output_num, sizeof( size_t ) );
+    for( i = 0; i < output_num; i ++ )
+    {
+        hash = _hash_tensor_attr( hash, outputs[i] );
+    }
+    hash = vsi_nn_kernel_param_hash( params, hash );
+    snprintf( key, VSI_NN_TUNING_DB_KEY_LEN, "%08x%08x",
+            (uint32_t)( hash >> 32 ), (uint32_t)hash );
+} /* _get_tuning_db_key() */
+
+/* Called with the context lock held. */
+static void _tuning_db_store
+    (
+    vsi_nn_tuning_db_t * db,
+    const char * key,
+    const char * kernel_name,
+    vsi_nn_kernel_type_e type
+    )
+{
+    FILE * fp;
+    vsi_nn_hashmap_add( db->entries, key, (void*)(uintptr_t)( type + 1 ) );
+    if( NULL == db->path )
+    {
+        return;
+    }
+    /* Append, so graphs tuned concurrently by other processes are kept. */
+    fp = fopen( db->path, "a" );
+    if( NULL == fp )
+    {
+        VSILOGW("Write tuning DB %s fail.", db->path);
+        return;
+    }
+    fprintf( fp, "%s %s %s\n", key, vsi_nn_kernel_type_str( type ), kernel_name );
+    fclose( fp );
+} /* _tuning_db_store() */
+
+static uint64_t _get_time_us
+    ( void )
+{
+#ifdef _WIN32
+    return (uint64_t)clock() * 1000000 / CLOCKS_PER_SEC;
+#else
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+#endif
+} /* _get_time_us() */
+
+/*
+ * Time one kernel type in a graph of its own. Virtual io tensors are scoped
+ * to their graph, so non-const tensors are replaced by real tensors with the
+ * same attributes; const tensors are shared since kernels may read them.
+ * Return UINT64_MAX if the kernel can not be instanced or run.
+ */
+static uint64_t _measure_kernel
+    (
+    vsi_nn_graph_t * graph,
+    const vsi_nn_kernel_backend_t * backend,
+    vsi_nn_kernel_type_e type,
+    vsi_nn_tensor_t ** inputs,
+    size_t input_num,
+    vsi_nn_tensor_t ** outputs,
+    size_t output_num,
+    const vsi_nn_kernel_param_t * params
+    )
+{
+    uint64_t elapsed = UINT64_MAX;
+    uint64_t start;
+    size_t i;
+    int32_t run;
+    vsi_nn_graph_t * tmp_graph = NULL;
+    vsi_nn_tensor_t ** tensors = NULL;
+    vsi_nn_tensor_t ** tmp_tensors = NULL;
+    vsi_nn_tensor_attr_t attr;
+    vsi_nn_kernel_t * kernel = NULL;
+    vsi_nn_kernel_node_t node = NULL;
+    vsi_bool tensors_ready = TRUE;
+    size_t tensor_num = input_num + output_num;
+
+    tmp_graph = vsi_nn_CreateGraph( graph->ctx, 0, 0 );
+    kernel = vsi_nn_kernel_create( type );
+    if( tensor_num > 0 )
+    {
+        tensors = (vsi_nn_tensor_t **)malloc( tensor_num * sizeof( vsi_nn_tensor_t * ) );
+        tmp_tensors = (vsi_nn_tensor_t **)malloc( tensor_num * sizeof( vsi_nn_tensor_t * ) );
+    }
+    if( NULL == tmp_graph || NULL == kernel
+        || ( tensor_num > 0 && ( NULL == tensors || NULL == tmp_tensors ) ) )
+    {
+        goto final;
+    }
+    memset( tmp_tensors, 0, tensor_num * sizeof( vsi_nn_tensor_t * ) );
+    for( i = 0; i < tensor_num; i ++ )
+    {
+        vsi_nn_tensor_t * tensor = i < input_num ? inputs[i] : outputs[i - input_num];
+        tensors[i] = tensor;
+        if( NULL == tensor || tensor->attr.is_const )
+        {
+            continue;
+        }
+        memcpy( &attr, &tensor->attr, sizeof( vsi_nn_tensor_attr_t ) );
+        attr.vtl = FALSE;
+        attr.is_created_from_handle = FALSE;
+        tmp_tensors[i] = vsi_nn_CreateTensor( tmp_graph, &attr );
+        tensors[i] = tmp_tensors[i];
+        if( NULL == tmp_tensors[i] )
+        {
+            tensors_ready = FALSE;
+        }
+    }
+    if( !tensors_ready )
+    {
+        goto final;
+    }
+
+    vsi_nn_kernel_reset( kernel, type );
+    kernel->unique_id = KERNEL_ID_OVXLIB_START + backend->unique_id;
+    node = backend->setup[type]( tmp_graph, tensors, input_num,
+            tensors + input_num, output_num, params, kernel );
+    if( NULL == node || VSI_SUCCESS != vxVerifyGraph( tmp_graph->g ) )
+    {
+        goto final;
+    }
+    for( run = 0; run < VSI_NN_AUTOTUNE_WARMUP_RUNS; run ++ )
+    {
+        if( VSI_SUCCESS != vxProcessGraph( tmp_graph->g ) )
+        {
+            goto final;
+        }
+    }
+    start = _get_time_us();
+    for( run = 0; run < VSI_NN_AUTOTUNE_RUNS; run ++ )
+    {
+        if( VSI_SUCCESS != vxProcessGraph( tmp_graph->g ) )
+        {
+            goto final;
+        }
+    }
+    elapsed = ( _get_time_us() - start ) / VSI_NN_AUTOTUNE_RUNS;
+
+final:
+    if( node )
+    {
+        vxReleaseNode( (vx_node*)&node );
+    }
+    if( tmp_tensors )
+    {
+        for( i = 0; i < tensor_num; i ++ )
+        {
+            if( tmp_tensors[i] )
+            {
+                vsi_nn_ReleaseTensor( &tmp_tensors[i] );
+            }
+        }
+    }
+    vsi_nn_safe_free( tmp_tensors );
+    vsi_nn_safe_free( tensors );
+    if( kernel )
+    {
+        vsi_nn_kernel_release( &kernel );
+    }
+    if( tmp_graph )
+    {
+        vsi_nn_ReleaseGraph( &tmp_graph );
+    }
+    return elapsed;
+} /* _measure_kernel() */
+
+/*
+ * Measure every candidate kernel type, return the fastest one or
+ * VSI_NN_KERNEL_TYPE_NONE if none of them runs.
+ */
+static vsi_nn_kernel_type_e _autotune_kernel
+    (
+    vsi_nn_graph_t * graph,
+    const vsi_nn_kernel_backend_t * backend,
+    const char * kernel_name,
+    const vsi_nn_kernel_type_e * types,
+    uint32_t type_num,
+    vsi_nn_tensor_t ** inputs,
+    size_t input_num,
+    vsi_nn_tensor_t ** outputs,
+    size_t output_num,
+    const vsi_nn_kernel_param_t * params
+    )
+{
+    uint32_t i;
+    uint64_t elapsed;
+    uint64_t best_elapsed = UINT64_MAX;
+    vsi_nn_kernel_type_e best = VSI_NN_KERNEL_TYPE_NONE;
+
+    for( i = 0; i < type_num; i ++ )
+    {
+        elapsed = _measure_kernel( graph, backend, types[i],
+                inputs, input_num, outputs, output_num, params );
+        if( UINT64_MAX == elapsed )
+        {
+            VSILOGD("Autotune \"%s\": %s not runnable",
+                kernel_name, vsi_nn_kernel_type_str( types[i] ));
+            continue;
+        }
+        VSILOGD("Autotune \"%s\": %s %"PRIu64" us",
+            kernel_name, vsi_nn_kernel_type_str( types[i] ), elapsed);
+        if( elapsed < best_elapsed )
+        {
+            best_elapsed = elapsed;
+            best = types[i];
+        }
+    }
+    return best;
+} /* _autotune_kernel() */
+
+typedef struct _vsi_nn_kernel_node_record
+{
+    vx_node node;
+    vsi_nn_kernel_type_e type;
+} vsi_nn_kernel_node_record_t;
+
+struct _vsi_nn_kernel_node_records
+{
+    vsi_nn_kernel_node_record_t * records;
+    uint32_t num;
+    uint32_t capacity;
+};
+
+static void _record_node_type
+    (
+    vsi_nn_graph_t * graph,
+    vx_node node,
+    vsi_nn_kernel_type_e type
+    )
+{
+    struct _vsi_nn_kernel_node_records * records;
+    records = graph->kernel_node_records;
+    if( NULL == records )
+    {
+        records = (struct _vsi_nn_kernel_node_records *)malloc(
+            sizeof( struct _vsi_nn_kernel_node_records ) );
+        if( NULL == records )
+        {
+            return;
+        }
+        memset( records, 0, sizeof( struct _vsi_nn_kernel_node_records ) );
+        graph->kernel_node_records = records;
+    }
+    if( records->num == records->capacity )
+    {
+        uint32_t capacity = records->capacity ? records->capacity * 2 : 64;
+        vsi_nn_kernel_node_record_t * ptr;
+        ptr = (vsi_nn_kernel_node_record_t *)realloc( records->records,
+            capacity * sizeof( vsi_nn_kernel_node_record_t ) );
+        if( NULL == ptr )
+        {
+            return;
+        }
+        records->records = ptr;
+        records->capacity = capacity;
+    }
+    records->records[records->num].node = node;
+    records->records[records->num].type = type;
+    records->num ++;
+} /* _record_node_type() */
+
+vsi_nn_kernel_type_e vsi_nn_kernel_node_type
+    (
+    vsi_nn_graph_t * graph,
+    vx_node node
+    )
+{
+    uint32_t i;
+    struct _vsi_nn_kernel_node_records * records;
+    if( NULL == graph || NULL == node || NULL == graph->kernel_node_records )
+    {
+        return VSI_NN_KERNEL_TYPE_NONE;
+    }
+    records = graph->kernel_node_records;
+    /* Search from the back, a released node's handle may be reused. */
+    for( i = records->num; i > 0; i -- )
+    {
+        if( records->records[i - 1].node == node )
+        {
+            return records->records[i - 1].type;
+        }
+    }
+    return VSI_NN_KERNEL_TYPE_NONE;
+} /* vsi_nn_kernel_node_type() */
+
+void vsi_nn_kernel_release_node_records
+    (
+    vsi_nn_graph_t * graph
+    )
+{
+    if( NULL == graph || NULL == graph->kernel_node_records )
+    {
+        return;
+    }
+    vsi_nn_safe_free( graph->kernel_node_records->records );
+    vsi_nn_safe_free( graph->kernel_node_records );
+} /* vsi_nn_kernel_release_node_records() */
+
 vsi_nn_kernel_node_t vsi_nn_kernel_selector
     (
     vsi_nn_graph_t* graph,
@@ -939,8 +1507,13 @@ vsi_nn_kernel_node_t vsi_nn_kernel_selector
 
     {
         uint32_t i;
+        uint32_t type_num = 0;
         vsi_nn_kernel_type_e type;
-        vsi_nn_kernel_setup_func_t kernel_func = NULL;;
+        vsi_nn_kernel_type_e types[VSI_NN_KERNEL_TYPE_NUM];
+        vsi_nn_kernel_type_e tuned = VSI_NN_KERNEL_TYPE_NONE;
+        vsi_nn_tuning_db_t * db = &graph->ctx->tuning_db;
+        char key[VSI_NN_TUNING_DB_KEY_LEN] = { 0 };
+        void * entry = NULL;
         for( i = 0; i < (uint32_t)selector.allow_kernel_num; i ++ )
         {
             type = selector.pirority[i].kernel_type;
@@ -957,21 +1530,70 @@ vsi_nn_kernel_node_t vsi_nn_kernel_selector
             {
                 continue;
             }
-            kernel_func = backend->setup[type];
             // Skip no kernel func
-            if( NULL == kernel_func )
+            if( NULL == backend->setup[type] )
             {
                 continue;
             }
+            types[type_num ++] = type;
+        }
+
+        // Try the fastest type measured for this signature first
+        if( type_num > 1 && db->entries && ( db->path || db->enable_autotune ) )
+        {
+            _get_tuning_db_key( graph, kernel_name, inputs, input_num,
+                    outputs, output_num, params, key );
+            vsi_nn_mutex_lock( graph->ctx->lock );
+            entry = vsi_nn_hashmap_get( db->entries, key );
+            vsi_nn_mutex_unlock( graph->ctx->lock );
+            if( entry )
+            {
+                tuned = (vsi_nn_kernel_type_e)( (uintptr_t)entry - 1 );
+            }
+            else if( db->enable_autotune )
+            {
+                /* Measured without the lock, the candidates build programs
+                 * through the same context. */
+                tuned = _autotune_kernel( graph, backend, kernel_name, types, type_num,
+                        inputs, input_num, outputs, output_num, params );
+                if( VSI_NN_KERNEL_TYPE_NONE != tuned )
+                {
+                    vsi_nn_mutex_lock( graph->ctx->lock );
+                    db->tuned ++;
+                    _tuning_db_store( db, key, kernel_name, tuned );
+                    vsi_nn_mutex_unlock( graph->ctx->lock );
+                }
+            }
+            for( i = 0; i < type_num; i ++ )
+            {
+                if( types[i] == tuned )
+                {
+                    if( entry )
+                    {
+                        vsi_nn_mutex_lock( graph->ctx->lock );
+                        db->hit ++;
+                        vsi_nn_mutex_unlock( graph->ctx->lock );
+                    }
+                    memmove( &types[1], &types[0], i * sizeof( vsi_nn_kernel_type_e ) );
+                    types[0] = tuned;
+                    break;
+                }
+            }
+        }
+
+        for( i = 0; i < type_num; i ++ )
+        {
+            type = types[i];
             vsi_nn_kernel_reset( kernel, type );
             kernel->unique_id = KERNEL_ID_OVXLIB_START + backend->unique_id;
-            node = kernel_func( graph, inputs, input_num,
+            node = backend->setup[type]( graph, inputs, input_num,
                     outputs, output_num, params, kernel );
             // If node created, break the loop
             if( node )
             {
                 VSILOGD("Instance %s node with kernel \"%s\" ",
                     vsi_nn_kernel_type_str(type), kernel_name);
+                _record_node_type( graph, (vx_node)node, type );
                 break;
             }
         }
@@ -237,3 +237,76 @@ void vsi_nn_kernel_param_clear( vsi_nn_kernel_param_t * params )
     }
 } /* vsi_nn_kernel_param_clear() */
 
+
+static uint64_t _hash_bytes
+    (
+    uint64_t hash,
+    const void * data,
+    size_t size
+    )
+{
+    size_t i;
+    const uint8_t * ptr = (const uint8_t *)data;
+    for( i = 0; i < size; i ++ )
+    {
+        hash ^= (uint64_t)ptr[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+} /* _hash_bytes() */
+
+uint64_t vsi_nn_kernel_param_hash
+    (
+    const vsi_nn_kernel_param_t * params,
+    uint64_t hash
+    )
+{
+    vsi_nn_hashmap_t * hashmap = (vsi_nn_hashmap_t *)params;
+    vsi_nn_hashmap_item_t * item = NULL;
+    _param_type * p;
+    if( NULL == params )
+    {
+        return hash;
+    }
+    while( ( item = vsi_nn_hashmap_iter( hashmap, item ) ) != NULL )
+    {
+        p = (_param_type *)item->data;
+        hash = _hash_bytes( hash, item->hash_key, strlen( item->hash_key ) + 1 );
+        if( NULL == p )
+        {
+            continue;
+        }
+        hash = _hash_bytes( hash, &p->type, sizeof( p->type ) );
+        switch( p->type )
+        {
+            case _PARAM_I32:
+                hash = _hash_bytes( hash, &p->value.int32, sizeof( int32_t ) );
+                break;
+            case _PARAM_I64:
+                hash = _hash_bytes( hash, &p->value.int64, sizeof( int64_t ) );
+                break;
+            case _PARAM_F32:
+                hash = _hash_bytes( hash, &p->value.float32, sizeof( float ) );
+                break;
+            case _PARAM_STR:
+                if( p->value.str )
+                {
+                    hash = _hash_bytes( hash, p->value.str, p->size );
+                }
+                break;
+            case _PARAM_BUFFER:
+            case _PARAM_CONST_BUFFER:
+                /* Some callers count the size in elements, so only the
+                 * first size bytes are known to be readable. */
+                hash = _hash_bytes( hash, &p->size, sizeof( size_t ) );
+                if( p->value.const_buffer )
+                {
+                    hash = _hash_bytes( hash, p->value.const_buffer, p->size );
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return hash;
+} /* vsi_nn_kernel_param_hash() */
@@ -239,6 +239,41 @@ vsi_status vsi_nn_kernel_tensor_write
             (void*)buffer, size );
 } /* vsi_nn_kernel_tensor_write() */
 
+static uint64_t s_cpu_bytes_saved = 0;
+
+void vsi_nn_kernel_cpu_add_bytes_saved
+    (
+    const char * kernel_name,
+    const vsi_nn_kernel_tensor_attr_t * const * attrs,
+    size_t attr_num
+    )
+{
+    uint64_t bytes = 0;
+    size_t i;
+
+    /* The float path allocates a float copy of every non float tensor
+     * on top of the raw buffer */
+    for( i = 0; i < attr_num; i++ )
+    {
+        if( F32 != attrs[i]->dtype )
+        {
+            bytes += vsi_nn_kernel_tensor_attr_get_size( attrs[i] ) * sizeof(float);
+        }
+    }
+#if defined(__GNUC__)
+    __sync_fetch_and_add( &s_cpu_bytes_saved, bytes );
+#else
+    s_cpu_bytes_saved += bytes;
+#endif
+    VSILOGD("%s keeps native dtype, %llu bytes saved, %llu in total.",
+        kernel_name, (unsigned long long)bytes, (unsigned long long)s_cpu_bytes_saved);
+} /* vsi_nn_kernel_cpu_add_bytes_saved() */
+
+uint64_t vsi_nn_kernel_cpu_get_bytes_saved( void )
+{
+    return s_cpu_bytes_saved;
+} /* vsi_nn_kernel_cpu_get_bytes_saved() */
+
 vsi_status vsi_nn_kernel_tensor_write_from_float
     (
     vsi_nn_kernel_tensor_t tensor,
@@ -59,7 +59,7 @@ static vsi_status op_compute
     vsi_nn_kernel_param_add_float32( param, "iou_threshold", self->nn_param.generate_proposals.iou_threshold );
     vsi_nn_kernel_param_add_float32( param, "min_size", self->nn_param.generate_proposals.min_size );
 
-    self->n = (vx_node)vsi_nn_kernel_selector( self->graph, "cpu beckend conv2d",
+    self->n = (vx_node)vsi_nn_kernel_selector( self->graph, "generate_proposals",
         inputs, _INPUT_NUM, outputs, _OUTPUT_NUM, param );
 
     if( self->n )
@@ -27,6 +27,7 @@
 #include <limits.h>
 #include "vsi_nn_error.h"
 #include "utils/vsi_nn_dtype_util_prv.h"
+#include "utils/vsi_nn_dtype_bulk.h"
 #include "utils/vsi_nn_math.h"
 #include "kernel/vsi_nn_kernel.h"
 
@@ -67,11 +68,7 @@ static inline void _convert_float16_to_float
     float * out_buffer
     )
 {
-    uint32_t i;
-    for( i = 0; i < size; i ++ )
-    {
-        out_buffer[i] = fp16_to_fp32( (int16_t)buffer[i] );
-    }
+    vsi_nn_dtype_bulk_fp16_to_fp32( buffer, size, out_buffer );
 } /* _convert_float16_to_float */
 
 static inline void _convert_float_to_float16
@@ -81,11 +78,7 @@ static inline void _convert_float_to_float16
     vsi_float16 * out_buffer
     )
 {
-    uint32_t i;
-    for( i = 0; i < size; i ++ )
-    {
-        out_buffer[i] = (vsi_float16)fp32_to_fp16( buffer[i] );
-    }
+    vsi_nn_dtype_bulk_fp32_to_fp16( buffer, size, out_buffer );
 } /* _convert_float_to_float16 */
 
 static inline void _convert_bfloat16_to_float
@@ -95,11 +88,7 @@ static inline void _convert_bfloat16_to_float
     float * out_buffer
     )
 {
-    uint32_t i;
-    for( i = 0; i < size; i ++ )
-    {
-        out_buffer[i] = bfp16_to_fp32( (int16_t)buffer[i] );
-    }
+    vsi_nn_dtype_bulk_bf16_to_fp32( buffer, size, out_buffer );
 } /* _convert_bfloat16_to_float */
 
 static inline void _convert_float_to_bfloat16
@@ -109,11 +98,7 @@ static inline void _convert_float_to_bfloat16
     vsi_bfloat16 * out_buffer
     )
 {
-    uint32_t i;
-    for( i = 0; i < size; i ++ )
-    {
-        out_buffer[i] = (vsi_bfloat16)fp32_to_bfp16( buffer[i] );
-    }
+    vsi_nn_dtype_bulk_fp32_to_bf16( buffer, size, out_buffer );
 } /* _convert_float_to_bfloat16 */
 
 #define DEF_DTYPE_CONVERT_QUANTIZE( SRC_NAME, SRC_DTYPE, ROUND, MIN, MAX ) \
@@ -156,15 +141,50 @@ static inline void _convert_float_to_bfloat16
         return TRUE; \
     }
 
-DEF_DTYPE_CONVERT_QUANTIZE( symm8,   int8_t,   vsi_rtne, SCHAR_MIN, SCHAR_MAX )
-DEF_DTYPE_CONVERT_QUANTIZE( symm16,  int16_t,  vsi_rtne, SHRT_MIN,  SHRT_MAX  )
 DEF_DTYPE_CONVERT_QUANTIZE( symm32,  int32_t,  vsi_rtne, INT_MIN,   INT_MAX   )
 DEF_DTYPE_CONVERT_QUANTIZE( symm64,  int64_t,  vsi_rtne, LLONG_MIN, LLONG_MAX )
-DEF_DTYPE_CONVERT_QUANTIZE( asymm8,  uint8_t,  vsi_rtne, 0,         UCHAR_MAX )
 //DEF_DTYPE_CONVERT_QUANTIZE( asymm16, uint16_t, vsi_rtne, 0,         USHRT_MAX )
 //DEF_DTYPE_CONVERT_QUANTIZE( asymm32, uint32_t, vsi_rtne, 0,         UINT_MAX  )
 #undef DEF_DTYPE_CONVERT_QUANTIZE
 
+/* 8 and 16 bit types go through the vectorized bulk conversion */
+#define DEF_DTYPE_CONVERT_QUANTIZE_BULK( SRC_NAME, SRC_DTYPE, BULK_NAME ) \
+    vsi_bool vsi_nn_dtype_convert_quantize_##SRC_NAME##_to_float \
+        ( \
+        const SRC_DTYPE * buffer, size_t size, \
+        float scale, int32_t zero_point, \
+        float * out_buffer \
+        ) \
+    { \
+        if( !buffer || !out_buffer ) \
+        { \
+            return FALSE; \
+        } \
+        vsi_nn_dtype_bulk_dequantize_##BULK_NAME( buffer, size, \
+                scale, zero_point, out_buffer ); \
+        return TRUE; \
+    } \
+    vsi_bool vsi_nn_dtype_convert_float_to_quantize_##SRC_NAME \
+        ( \
+        const float * buffer, size_t size, \
+        float scale, int32_t zero_point, \
+        SRC_DTYPE * out_buffer \
+        ) \
+    { \
+        if( !buffer || !out_buffer ) \
+        { \
+            return FALSE; \
+        } \
+        vsi_nn_dtype_bulk_quantize_##BULK_NAME( buffer, size, \
+                scale, zero_point, out_buffer ); \
+        return TRUE; \
+    }
+
+DEF_DTYPE_CONVERT_QUANTIZE_BULK( symm8,  int8_t,  i8  )
+DEF_DTYPE_CONVERT_QUANTIZE_BULK( symm16, int16_t, i16 )
+DEF_DTYPE_CONVERT_QUANTIZE_BULK( asymm8, uint8_t, u8  )
+#undef DEF_DTYPE_CONVERT_QUANTIZE_BULK
+
 vsi_bool vsi_nn_dtype_convert_float_to_quantize_symm8_perchannel
     (
     const float * buffer, size_t size,
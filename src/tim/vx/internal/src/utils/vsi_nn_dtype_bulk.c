@@ -0,0 +1,836 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <stdlib.h>
+#include <math.h>
+#include "vsi_nn_types.h"
+#include "utils/vsi_nn_dtype_bulk.h"
+#include "utils/vsi_nn_dtype_util_prv.h"
+#include "utils/vsi_nn_thread_pool.h"
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#define VSI_NN_DTYPE_BULK_ONCE
+#endif
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#include <immintrin.h>
+#include <cpuid.h>
+#define VSI_NN_DTYPE_BULK_AVX2
+#define _AVX2_FUNC __attribute__((target("avx2,f16c")))
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define VSI_NN_DTYPE_BULK_NEON
+#endif
+
+/* Elements per thread pool chunk */
+#define _PARALLEL_GRAIN     (16 * 1024)
+
+typedef enum
+{
+    _FP16_TO_FP32 = 0,
+    _FP32_TO_FP16,
+    _BF16_TO_FP32,
+    _FP32_TO_BF16,
+    _DEQUANTIZE_U8,
+    _DEQUANTIZE_I8,
+    _DEQUANTIZE_I16,
+    _QUANTIZE_U8,
+    _QUANTIZE_I8,
+    _QUANTIZE_I16,
+    _OP_NUM
+} _bulk_op_e;
+
+typedef void (* _bulk_func_t)
+    (
+    const void * in,
+    size_t size,
+    float scale,
+    int32_t zero_point,
+    void * out
+    );
+
+typedef struct
+{
+    _bulk_func_t func;
+    const uint8_t * in;
+    size_t in_bytes;
+    uint8_t * out;
+    size_t out_bytes;
+    float scale;
+    int32_t zero_point;
+} _bulk_task_t;
+
+static const size_t s_in_bytes[_OP_NUM] =
+    { 2, 4, 2, 4, 1, 1, 2, 4, 4, 4 };
+static const size_t s_out_bytes[_OP_NUM] =
+    { 4, 2, 4, 2, 4, 4, 4, 1, 1, 2 };
+
+/*
+ * Scalar kernels, these define the results of every SIMD path and
+ * process the SIMD tails.
+ */
+static void _fp16_to_fp32_scalar
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const uint16_t * src = (const uint16_t *)in;
+    float * dst = (float *)out;
+    size_t i;
+    for( i = 0; i < size; i ++ )
+    {
+        dst[i] = fp16_to_fp32( (int16_t)src[i] );
+    }
+} /* _fp16_to_fp32_scalar() */
+
+static void _fp32_to_fp16_scalar
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const float * src = (const float *)in;
+    uint16_t * dst = (uint16_t *)out;
+    size_t i;
+    for( i = 0; i < size; i ++ )
+    {
+        dst[i] = fp32_to_fp16_rtne( src[i] );
+    }
+} /* _fp32_to_fp16_scalar() */
+
+static void _bf16_to_fp32_scalar
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const uint16_t * src = (const uint16_t *)in;
+    uint32_t * dst = (uint32_t *)out;
+    size_t i;
+    for( i = 0; i < size; i ++ )
+    {
+        dst[i] = (uint32_t)src[i] << 16;
+    }
+} /* _bf16_to_fp32_scalar() */
+
+static void _fp32_to_bf16_scalar
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const float * src = (const float *)in;
+    uint16_t * dst = (uint16_t *)out;
+    size_t i;
+    for( i = 0; i < size; i ++ )
+    {
+        dst[i] = fp32_to_bfp16_rtne( src[i] );
+    }
+} /* _fp32_to_bf16_scalar() */
+
+#define DEF_DEQUANTIZE_SCALAR( NAME, SRC_DTYPE ) \
+static void _dequantize_##NAME##_scalar \
+    ( \
+    const void * in, size_t size, float scale, int32_t zero_point, void * out \
+    ) \
+{ \
+    const SRC_DTYPE * src = (const SRC_DTYPE *)in; \
+    float * dst = (float *)out; \
+    size_t i; \
+    for( i = 0; i < size; i ++ ) \
+    { \
+        dst[i] = (float)( (int32_t)src[i] - zero_point ) * scale; \
+    } \
+}
+
+/*
+ * The clamp is done before adding zero point, so it stays in float, and
+ * `r > lo ? r : lo` sends NaN to the lower bound like SIMD max does.
+ */
+#define DEF_QUANTIZE_SCALAR( NAME, DST_DTYPE, MIN, MAX ) \
+static void _quantize_##NAME##_scalar \
+    ( \
+    const void * in, size_t size, float scale, int32_t zero_point, void * out \
+    ) \
+{ \
+    const float * src = (const float *)in; \
+    DST_DTYPE * dst = (DST_DTYPE *)out; \
+    const float lo = (float)( (MIN) - zero_point ); \
+    const float hi = (float)( (MAX) - zero_point ); \
+    size_t i; \
+    for( i = 0; i < size; i ++ ) \
+    { \
+        float r = rintf( src[i] / scale ); \
+        r = r > lo ? r : lo; \
+        r = r < hi ? r : hi; \
+        dst[i] = (DST_DTYPE)( (int32_t)r + zero_point ); \
+    } \
+}
+
+DEF_DEQUANTIZE_SCALAR( u8,  uint8_t )
+DEF_DEQUANTIZE_SCALAR( i8,  int8_t )
+DEF_DEQUANTIZE_SCALAR( i16, int16_t )
+DEF_QUANTIZE_SCALAR( u8,  uint8_t, 0,    255 )
+DEF_QUANTIZE_SCALAR( i8,  int8_t,  -128, 127 )
+DEF_QUANTIZE_SCALAR( i16, int16_t, -32768, 32767 )
+#undef DEF_DEQUANTIZE_SCALAR
+#undef DEF_QUANTIZE_SCALAR
+
+static const _bulk_func_t s_scalar_funcs[_OP_NUM] =
+{
+    _fp16_to_fp32_scalar,
+    _fp32_to_fp16_scalar,
+    _bf16_to_fp32_scalar,
+    _fp32_to_bf16_scalar,
+    _dequantize_u8_scalar,
+    _dequantize_i8_scalar,
+    _dequantize_i16_scalar,
+    _quantize_u8_scalar,
+    _quantize_i8_scalar,
+    _quantize_i16_scalar,
+};
+
+#ifdef VSI_NN_DTYPE_BULK_AVX2
+
+_AVX2_FUNC static void _fp16_to_fp32_avx2
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const uint16_t * src = (const uint16_t *)in;
+    float * dst = (float *)out;
+    size_t i = 0;
+    for( ; i + 8 <= size; i += 8 )
+    {
+        __m128i h = _mm_loadu_si128( (const __m128i *)( src + i ) );
+        _mm256_storeu_ps( dst + i, _mm256_cvtph_ps( h ) );
+    }
+    _fp16_to_fp32_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _fp16_to_fp32_avx2() */
+
+_AVX2_FUNC static void _fp32_to_fp16_avx2
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const float * src = (const float *)in;
+    uint16_t * dst = (uint16_t *)out;
+    const __m128i abs_mask = _mm_set1_epi16( 0x7fff );
+    const __m128i sign_mask = _mm_set1_epi16( (short)0x8000 );
+    const __m128i inf = _mm_set1_epi16( 0x7c00 );
+    const __m128i max_finite = _mm_set1_epi16( 0x7bff );
+    const __m128i qnan = _mm_set1_epi16( 0x7e00 );
+    size_t i = 0;
+    for( i = 0; i + 8 <= size; i += 8 )
+    {
+        __m128i h = _mm256_cvtps_ph( _mm256_loadu_ps( src + i ),
+                _MM_FROUND_TO_NEAREST_INT );
+        __m128i m = _mm_and_si128( h, abs_mask );
+        __m128i sign = _mm_and_si128( h, sign_mask );
+        /* Saturate infinity, canonicalize NaN */
+        h = _mm_blendv_epi8( h, _mm_or_si128( sign, max_finite ),
+                _mm_cmpeq_epi16( m, inf ) );
+        h = _mm_blendv_epi8( h, _mm_or_si128( sign, qnan ),
+                _mm_cmpgt_epi16( m, inf ) );
+        _mm_storeu_si128( (__m128i *)( dst + i ), h );
+    }
+    _fp32_to_fp16_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _fp32_to_fp16_avx2() */
+
+_AVX2_FUNC static void _bf16_to_fp32_avx2
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const uint16_t * src = (const uint16_t *)in;
+    uint32_t * dst = (uint32_t *)out;
+    size_t i = 0;
+    for( ; i + 8 <= size; i += 8 )
+    {
+        __m256i v = _mm256_cvtepu16_epi32(
+                _mm_loadu_si128( (const __m128i *)( src + i ) ) );
+        _mm256_storeu_si256( (__m256i *)( dst + i ),
+                _mm256_slli_epi32( v, 16 ) );
+    }
+    _bf16_to_fp32_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _bf16_to_fp32_avx2() */
+
+_AVX2_FUNC static void _fp32_to_bf16_avx2
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const float * src = (const float *)in;
+    uint16_t * dst = (uint16_t *)out;
+    const __m256i one = _mm256_set1_epi32( 1 );
+    const __m256i bias = _mm256_set1_epi32( 0x7fff );
+    const __m256i abs_mask = _mm256_set1_epi32( 0x7fffffff );
+    const __m256i inf = _mm256_set1_epi32( VSI_NN_FLOAT32_INF );
+    const __m256i quiet = _mm256_set1_epi32( 0x0040 );
+    size_t i = 0;
+    for( ; i + 8 <= size; i += 8 )
+    {
+        __m256i u = _mm256_loadu_si256( (const __m256i *)( src + i ) );
+        __m256i hi = _mm256_srli_epi32( u, 16 );
+        __m256i r = _mm256_add_epi32( u,
+                _mm256_add_epi32( bias, _mm256_and_si256( hi, one ) ) );
+        __m256i is_nan = _mm256_cmpgt_epi32(
+                _mm256_and_si256( u, abs_mask ), inf );
+        r = _mm256_srli_epi32( r, 16 );
+        r = _mm256_blendv_epi8( r, _mm256_or_si256( hi, quiet ), is_nan );
+        /* Values fit in 16 bits, packus keeps them, then undo lane split */
+        r = _mm256_permute4x64_epi64( _mm256_packus_epi32( r, r ), 0xD8 );
+        _mm_storeu_si128( (__m128i *)( dst + i ),
+                _mm256_castsi256_si128( r ) );
+    }
+    _fp32_to_bf16_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _fp32_to_bf16_avx2() */
+
+_AVX2_FUNC static void _dequantize_u8_avx2
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const uint8_t * src = (const uint8_t *)in;
+    float * dst = (float *)out;
+    const __m256i zp = _mm256_set1_epi32( zero_point );
+    const __m256 s = _mm256_set1_ps( scale );
+    size_t i = 0;
+    for( ; i + 8 <= size; i += 8 )
+    {
+        __m256i q = _mm256_cvtepu8_epi32(
+                _mm_loadl_epi64( (const __m128i *)( src + i ) ) );
+        q = _mm256_sub_epi32( q, zp );
+        _mm256_storeu_ps( dst + i,
+                _mm256_mul_ps( _mm256_cvtepi32_ps( q ), s ) );
+    }
+    _dequantize_u8_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _dequantize_u8_avx2() */
+
+_AVX2_FUNC static void _dequantize_i8_avx2
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const int8_t * src = (const int8_t *)in;
+    float * dst = (float *)out;
+    const __m256i zp = _mm256_set1_epi32( zero_point );
+    const __m256 s = _mm256_set1_ps( scale );
+    size_t i = 0;
+    for( ; i + 8 <= size; i += 8 )
+    {
+        __m256i q = _mm256_cvtepi8_epi32(
+                _mm_loadl_epi64( (const __m128i *)( src + i ) ) );
+        q = _mm256_sub_epi32( q, zp );
+        _mm256_storeu_ps( dst + i,
+                _mm256_mul_ps( _mm256_cvtepi32_ps( q ), s ) );
+    }
+    _dequantize_i8_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _dequantize_i8_avx2() */
+
+_AVX2_FUNC static void _dequantize_i16_avx2
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const int16_t * src = (const int16_t *)in;
+    float * dst = (float *)out;
+    const __m256i zp = _mm256_set1_epi32( zero_point );
+    const __m256 s = _mm256_set1_ps( scale );
+    size_t i = 0;
+    for( ; i + 8 <= size; i += 8 )
+    {
+        __m256i q = _mm256_cvtepi16_epi32(
+                _mm_loadu_si128( (const __m128i *)( src + i ) ) );
+        q = _mm256_sub_epi32( q, zp );
+        _mm256_storeu_ps( dst + i,
+                _mm256_mul_ps( _mm256_cvtepi32_ps( q ), s ) );
+    }
+    _dequantize_i16_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _dequantize_i16_avx2() */
+
+/* rint(x / scale) clamped to [lo, hi], then zero point added */
+_AVX2_FUNC static inline __m256i _quantize_8_avx2
+    (
+    const float * src, __m256 s, __m256 lo, __m256 hi, __m256i zp
+    )
+{
+    __m256 r = _mm256_div_ps( _mm256_loadu_ps( src ), s );
+    r = _mm256_round_ps( r, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC );
+    r = _mm256_min_ps( _mm256_max_ps( r, lo ), hi );
+    return _mm256_add_epi32( _mm256_cvttps_epi32( r ), zp );
+} /* _quantize_8_avx2() */
+
+#define DEF_QUANTIZE_AVX2( NAME, DST_DTYPE, MIN, MAX, PACK32, PACK16 ) \
+_AVX2_FUNC static void _quantize_##NAME##_avx2 \
+    ( \
+    const void * in, size_t size, float scale, int32_t zero_point, void * out \
+    ) \
+{ \
+    const float * src = (const float *)in; \
+    DST_DTYPE * dst = (DST_DTYPE *)out; \
+    const __m256 s = _mm256_set1_ps( scale ); \
+    const __m256 lo = _mm256_set1_ps( (float)( (MIN) - zero_point ) ); \
+    const __m256 hi = _mm256_set1_ps( (float)( (MAX) - zero_point ) ); \
+    const __m256i zp = _mm256_set1_epi32( zero_point ); \
+    size_t i = 0; \
+    for( ; i + 8 <= size; i += 8 ) \
+    { \
+        __m256i q = _quantize_8_avx2( src + i, s, lo, hi, zp ); \
+        __m128i q16 = PACK32( _mm256_castsi256_si128( q ), \
+                _mm256_extracti128_si256( q, 1 ) ); \
+        if( sizeof( DST_DTYPE ) == 1 ) \
+        { \
+            _mm_storel_epi64( (__m128i *)( dst + i ), PACK16( q16, q16 ) ); \
+        } \
+        else \
+        { \
+            _mm_storeu_si128( (__m128i *)( dst + i ), q16 ); \
+        } \
+    } \
+    _quantize_##NAME##_scalar( src + i, size - i, scale, zero_point, dst + i ); \
+}
+
+/* Clamped values fit the target type, so saturating packs are exact */
+DEF_QUANTIZE_AVX2( u8,  uint8_t, 0,      255,   _mm_packs_epi32, _mm_packus_epi16 )
+DEF_QUANTIZE_AVX2( i8,  int8_t,  -128,   127,   _mm_packs_epi32, _mm_packs_epi16 )
+DEF_QUANTIZE_AVX2( i16, int16_t, -32768, 32767, _mm_packs_epi32, _mm_packs_epi16 )
+#undef DEF_QUANTIZE_AVX2
+
+static const _bulk_func_t s_avx2_funcs[_OP_NUM] =
+{
+    _fp16_to_fp32_avx2,
+    _fp32_to_fp16_avx2,
+    _bf16_to_fp32_avx2,
+    _fp32_to_bf16_avx2,
+    _dequantize_u8_avx2,
+    _dequantize_i8_avx2,
+    _dequantize_i16_avx2,
+    _quantize_u8_avx2,
+    _quantize_i8_avx2,
+    _quantize_i16_avx2,
+};
+
+static vsi_bool _cpu_has_avx2_f16c( void )
+{
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    __builtin_cpu_init();
+    if( !__builtin_cpu_supports( "avx2" ) )
+    {
+        return FALSE;
+    }
+    if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) )
+    {
+        return FALSE;
+    }
+    return ( ecx & bit_F16C ) ? TRUE : FALSE;
+} /* _cpu_has_avx2_f16c() */
+
+#endif /* VSI_NN_DTYPE_BULK_AVX2 */
+
+#ifdef VSI_NN_DTYPE_BULK_NEON
+
+static void _fp16_to_fp32_neon
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const uint16_t * src = (const uint16_t *)in;
+    float * dst = (float *)out;
+    size_t i = 0;
+    for( ; i + 4 <= size; i += 4 )
+    {
+        float16x4_t h = vreinterpret_f16_u16( vld1_u16( src + i ) );
+        vst1q_f32( dst + i, vcvt_f32_f16( h ) );
+    }
+    _fp16_to_fp32_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _fp16_to_fp32_neon() */
+
+static void _fp32_to_fp16_neon
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const float * src = (const float *)in;
+    uint16_t * dst = (uint16_t *)out;
+    const uint16x4_t abs_mask = vdup_n_u16( 0x7fff );
+    const uint16x4_t sign_mask = vdup_n_u16( 0x8000 );
+    const uint16x4_t inf = vdup_n_u16( 0x7c00 );
+    const uint16x4_t max_finite = vdup_n_u16( 0x7bff );
+    const uint16x4_t qnan = vdup_n_u16( 0x7e00 );
+    size_t i = 0;
+    for( ; i + 4 <= size; i += 4 )
+    {
+        /* Rounds to nearest even with the default FPCR */
+        uint16x4_t h = vreinterpret_u16_f16( vcvt_f16_f32( vld1q_f32( src + i ) ) );
+        uint16x4_t m = vand_u16( h, abs_mask );
+        uint16x4_t sign = vand_u16( h, sign_mask );
+        /* Saturate infinity, canonicalize NaN */
+        h = vbsl_u16( vceq_u16( m, inf ), vorr_u16( sign, max_finite ), h );
+        h = vbsl_u16( vcgt_u16( m, inf ), vorr_u16( sign, qnan ), h );
+        vst1_u16( dst + i, h );
+    }
+    _fp32_to_fp16_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _fp32_to_fp16_neon() */
+
+static void _bf16_to_fp32_neon
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const uint16_t * src = (const uint16_t *)in;
+    uint32_t * dst = (uint32_t *)out;
+    size_t i = 0;
+    for( ; i + 4 <= size; i += 4 )
+    {
+        vst1q_u32( dst + i, vshll_n_u16( vld1_u16( src + i ), 16 ) );
+    }
+    _bf16_to_fp32_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _bf16_to_fp32_neon() */
+
+static void _fp32_to_bf16_neon
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const float * src = (const float *)in;
+    uint16_t * dst = (uint16_t *)out;
+    const uint32x4_t one = vdupq_n_u32( 1 );
+    const uint32x4_t bias = vdupq_n_u32( 0x7fff );
+    const uint32x4_t abs_mask = vdupq_n_u32( 0x7fffffff );
+    const uint32x4_t inf = vdupq_n_u32( VSI_NN_FLOAT32_INF );
+    const uint32x4_t quiet = vdupq_n_u32( 0x0040 );
+    size_t i = 0;
+    for( ; i + 4 <= size; i += 4 )
+    {
+        uint32x4_t u = vreinterpretq_u32_f32( vld1q_f32( src + i ) );
+        uint32x4_t hi = vshrq_n_u32( u, 16 );
+        uint32x4_t r = vaddq_u32( u, vaddq_u32( bias, vandq_u32( hi, one ) ) );
+        uint32x4_t is_nan = vcgtq_u32( vandq_u32( u, abs_mask ), inf );
+        r = vshrq_n_u32( r, 16 );
+        r = vbslq_u32( is_nan, vorrq_u32( hi, quiet ), r );
+        vst1_u16( dst + i, vmovn_u32( r ) );
+    }
+    _fp32_to_bf16_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _fp32_to_bf16_neon() */
+
+static void _dequantize_u8_neon
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const uint8_t * src = (const uint8_t *)in;
+    float * dst = (float *)out;
+    const int32x4_t zp = vdupq_n_s32( zero_point );
+    size_t i = 0;
+    for( ; i + 8 <= size; i += 8 )
+    {
+        uint16x8_t q = vmovl_u8( vld1_u8( src + i ) );
+        int32x4_t q0 = vreinterpretq_s32_u32( vmovl_u16( vget_low_u16( q ) ) );
+        int32x4_t q1 = vreinterpretq_s32_u32( vmovl_u16( vget_high_u16( q ) ) );
+        vst1q_f32( dst + i, vmulq_n_f32( vcvtq_f32_s32( vsubq_s32( q0, zp ) ), scale ) );
+        vst1q_f32( dst + i + 4, vmulq_n_f32( vcvtq_f32_s32( vsubq_s32( q1, zp ) ), scale ) );
+    }
+    _dequantize_u8_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _dequantize_u8_neon() */
+
+static void _dequantize_i8_neon
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const int8_t * src = (const int8_t *)in;
+    float * dst = (float *)out;
+    const int32x4_t zp = vdupq_n_s32( zero_point );
+    size_t i = 0;
+    for( ; i + 8 <= size; i += 8 )
+    {
+        int16x8_t q = vmovl_s8( vld1_s8( src + i ) );
+        int32x4_t q0 = vmovl_s16( vget_low_s16( q ) );
+        int32x4_t q1 = vmovl_s16( vget_high_s16( q ) );
+        vst1q_f32( dst + i, vmulq_n_f32( vcvtq_f32_s32( vsubq_s32( q0, zp ) ), scale ) );
+        vst1q_f32( dst + i + 4, vmulq_n_f32( vcvtq_f32_s32( vsubq_s32( q1, zp ) ), scale ) );
+    }
+    _dequantize_i8_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _dequantize_i8_neon() */
+
+static void _dequantize_i16_neon
+    (
+    const void * in, size_t size, float scale, int32_t zero_point, void * out
+    )
+{
+    const int16_t * src = (const int16_t *)in;
+    float * dst = (float *)out;
+    const int32x4_t zp = vdupq_n_s32( zero_point );
+    size_t i = 0;
+    for( ; i + 4 <= size; i += 4 )
+    {
+        int32x4_t q = vmovl_s16( vld1_s16( src + i ) );
+        vst1q_f32( dst + i, vmulq_n_f32( vcvtq_f32_s32( vsubq_s32( q, zp ) ), scale ) );
+    }
+    _dequantize_i16_scalar( src + i, size - i, scale, zero_point, dst + i );
+} /* _dequantize_i16_neon() */
+
+/* rint(x / scale) clamped to [lo, hi], then zero point added */
+static inline int32x4_t _quantize_4_neon
+    (
+    const float * src, float32x4_t s, float32x4_t lo, float32x4_t hi, int32x4_t zp
+    )
+{
+    float32x4_t r = vrndnq_f32( vdivq_f32( vld1q_f32( src ), s ) );
+    /* maxnm returns the number for NaN input, same as the scalar path */
+    r = vminq_f32( vmaxnmq_f32( r, lo ), hi );
+    return vaddq_s32( vcvtq_s32_f32( r ), zp );
+} /* _quantize_4_neon() */
+
+#define DEF_QUANTIZE_NEON( NAME, DST_DTYPE, MIN, MAX, STORE ) \
+static void _quantize_##NAME##_neon \
+    ( \
+    const void * in, size_t size, float scale, int32_t zero_point, void * out \
+    ) \
+{ \
+    const float * src = (const float *)in; \
+    DST_DTYPE * dst = (DST_DTYPE *)out; \
+    const float32x4_t s = vdupq_n_f32( scale ); \
+    const float32x4_t lo = vdupq_n_f32( (float)( (MIN) - zero_point ) ); \
+    const float32x4_t hi = vdupq_n_f32( (float)( (MAX) - zero_point ) ); \
+    const int32x4_t zp = vdupq_n_s32( zero_point ); \
+    size_t i = 0; \
+    for( ; i + 8 <= size; i += 8 ) \
+    { \
+        int16x8_t q = vcombine_s16( \
+                vqmovn_s32( _quantize_4_neon( src + i, s, lo, hi, zp ) ), \
+                vqmovn_s32( _quantize_4_neon( src + i + 4, s, lo, hi, zp ) ) ); \
+        STORE; \
+    } \
+    _quantize_##NAME##_scalar( src + i, size - i, scale, zero_point, dst + i ); \
+}
+
+/* Clamped values fit the target type, so saturating narrows are exact */
+DEF_QUANTIZE_NEON( u8,  uint8_t, 0,      255,   vst1_u8( dst + i, vqmovun_s16( q ) ) )
+DEF_QUANTIZE_NEON( i8,  int8_t,  -128,   127,   vst1_s8( dst + i, vqmovn_s16( q ) ) )
+DEF_QUANTIZE_NEON( i16, int16_t, -32768, 32767, vst1q_s16( dst + i, q ) )
+#undef DEF_QUANTIZE_NEON
+
+static const _bulk_func_t s_neon_funcs[_OP_NUM] =
+{
+    _fp16_to_fp32_neon,
+    _fp32_to_fp16_neon,
+    _bf16_to_fp32_neon,
+    _fp32_to_bf16_neon,
+    _dequantize_u8_neon,
+    _dequantize_i8_neon,
+    _dequantize_i16_neon,
+    _quantize_u8_neon,
+    _quantize_i8_neon,
+    _quantize_i16_neon,
+};
+
+#endif /* VSI_NN_DTYPE_BULK_NEON */
+
+static vsi_nn_dtype_bulk_isa_e s_isa = VSI_NN_DTYPE_BULK_ISA_SCALAR;
+static vsi_bool s_simd_enable = TRUE;
+#ifdef VSI_NN_DTYPE_BULK_ONCE
+static pthread_once_t s_isa_once = PTHREAD_ONCE_INIT;
+#else
+static int s_isa_ready = 0;
+#endif
+
+static void _detect_isa( void )
+{
+    char * env_s;
+
+#if defined(VSI_NN_DTYPE_BULK_AVX2)
+    if( _cpu_has_avx2_f16c() )
+    {
+        s_isa = VSI_NN_DTYPE_BULK_ISA_AVX2_F16C;
+    }
+#elif defined(VSI_NN_DTYPE_BULK_NEON)
+    s_isa = VSI_NN_DTYPE_BULK_ISA_NEON;
+#endif
+    env_s = getenv( "VSI_NN_DTYPE_SIMD" );
+    if( env_s && atoi( env_s ) == 0 )
+    {
+        s_simd_enable = FALSE;
+    }
+} /* _detect_isa() */
+
+/* Runs the detection once, before any converter reads s_isa */
+static void _init_isa( void )
+{
+#ifdef VSI_NN_DTYPE_BULK_ONCE
+    pthread_once( &s_isa_once, _detect_isa );
+#else
+    if( !s_isa_ready )
+    {
+        _detect_isa();
+        s_isa_ready = 1;
+    }
+#endif
+} /* _init_isa() */
+
+static _bulk_func_t _get_func
+    (
+    _bulk_op_e op
+    )
+{
+    _init_isa();
+    if( s_simd_enable )
+    {
+        switch( s_isa )
+        {
+#ifdef VSI_NN_DTYPE_BULK_AVX2
+            case VSI_NN_DTYPE_BULK_ISA_AVX2_F16C:
+                return s_avx2_funcs[op];
+#endif
+#ifdef VSI_NN_DTYPE_BULK_NEON
+            case VSI_NN_DTYPE_BULK_ISA_NEON:
+                return s_neon_funcs[op];
+#endif
+            default:
+                break;
+        }
+    }
+    return s_scalar_funcs[op];
+} /* _get_func() */
+
+static void _bulk_task_run
+    (
+    void * data,
+    size_t start,
+    size_t end
+    )
+{
+    _bulk_task_t * task = (_bulk_task_t *)data;
+    task->func( task->in + start * task->in_bytes, end - start,
+            task->scale, task->zero_point,
+            task->out + start * task->out_bytes );
+} /* _bulk_task_run() */
+
+static void _bulk_convert
+    (
+    _bulk_op_e op,
+    const void * in,
+    size_t size,
+    float scale,
+    int32_t zero_point,
+    void * out
+    )
+{
+    _bulk_task_t task;
+
+    if( !in || !out || 0 == size )
+    {
+        return;
+    }
+    task.func = _get_func( op );
+    if( size < VSI_NN_DTYPE_BULK_PARALLEL_SIZE )
+    {
+        task.func( in, size, scale, zero_point, out );
+        return;
+    }
+    task.in = (const uint8_t *)in;
+    task.in_bytes = s_in_bytes[op];
+    task.out = (uint8_t *)out;
+    task.out_bytes = s_out_bytes[op];
+    task.scale = scale;
+    task.zero_point = zero_point;
+    vsi_nn_parallel_for( size, _PARALLEL_GRAIN, _bulk_task_run, &task );
+} /* _bulk_convert() */
+
+vsi_nn_dtype_bulk_isa_e vsi_nn_dtype_bulk_get_isa
+    ( void )
+{
+    _init_isa();
+    return s_simd_enable ? s_isa : VSI_NN_DTYPE_BULK_ISA_SCALAR;
+} /* vsi_nn_dtype_bulk_get_isa() */
+
+void vsi_nn_dtype_bulk_set_simd_enable
+    (
+    vsi_bool enable
+    )
+{
+    _init_isa();
+    s_simd_enable = enable;
+} /* vsi_nn_dtype_bulk_set_simd_enable() */
+
+void vsi_nn_dtype_bulk_fp16_to_fp32
+    (
+    const uint16_t * buffer, size_t size,
+    float * out_buffer
+    )
+{
+    _bulk_convert( _FP16_TO_FP32, buffer, size, 0.0f, 0, out_buffer );
+} /* vsi_nn_dtype_bulk_fp16_to_fp32() */
+
+void vsi_nn_dtype_bulk_fp32_to_fp16
+    (
+    const float * buffer, size_t size,
+    uint16_t * out_buffer
+    )
+{
+    _bulk_convert( _FP32_TO_FP16, buffer, size, 0.0f, 0, out_buffer );
+} /* vsi_nn_dtype_bulk_fp32_to_fp16() */
+
+void vsi_nn_dtype_bulk_bf16_to_fp32
+    (
+    const uint16_t * buffer, size_t size,
+    float * out_buffer
+    )
+{
+    _bulk_convert( _BF16_TO_FP32, buffer, size, 0.0f, 0, out_buffer );
+} /* vsi_nn_dtype_bulk_bf16_to_fp32() */
+
+void vsi_nn_dtype_bulk_fp32_to_bf16
+    (
+    const float * buffer, size_t size,
+    uint16_t * out_buffer
+    )
+{
+    _bulk_convert( _FP32_TO_BF16, buffer, size, 0.0f, 0, out_buffer );
+} /* vsi_nn_dtype_bulk_fp32_to_bf16() */
+
+#define DEF_BULK_QUANTIZE_API( NAME, Q_DTYPE, DEQUANT_OP, QUANT_OP ) \
+void vsi_nn_dtype_bulk_dequantize_##NAME \
+    ( \
+    const Q_DTYPE * buffer, size_t size, \
+    float scale, int32_t zero_point, \
+    float * out_buffer \
+    ) \
+{ \
+    _bulk_convert( DEQUANT_OP, buffer, size, scale, zero_point, out_buffer ); \
+} \
+void vsi_nn_dtype_bulk_quantize_##NAME \
+    ( \
+    const float * buffer, size_t size, \
+    float scale, int32_t zero_point, \
+    Q_DTYPE * out_buffer \
+    ) \
+{ \
+    _bulk_convert( QUANT_OP, buffer, size, scale, zero_point, out_buffer ); \
+}
+
+DEF_BULK_QUANTIZE_API( u8,  uint8_t, _DEQUANTIZE_U8,  _QUANTIZE_U8 )
+DEF_BULK_QUANTIZE_API( i8,  int8_t,  _DEQUANTIZE_I8,  _QUANTIZE_I8 )
+DEF_BULK_QUANTIZE_API( i16, int16_t, _DEQUANTIZE_I16, _QUANTIZE_I16 )
+#undef DEF_BULK_QUANTIZE_API
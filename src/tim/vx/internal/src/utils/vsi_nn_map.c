@@ -31,6 +31,71 @@
 #include "vsi_nn_log.h"
 #include "vsi_nn_types.h"
 
+#define _DENSE_MIN_CAPACITY     (64)
+
+static vsi_bool _is_dense_key
+    (
+    vsi_nn_map_key_t key
+    )
+{
+    return ( key >= 0 && key < VSI_NN_MAP_DENSE_KEY_LIMIT );
+} /* _is_dense_key() */
+
+static vsi_bool _reserve_dense
+    (
+    vsi_nn_map_t     * map,
+    vsi_nn_map_key_t   key
+    )
+{
+    size_t capacity;
+    void ** items;
+
+    if( (size_t)key < map->dense.capacity )
+    {
+        return TRUE;
+    }
+    capacity = map->dense.capacity;
+    if( capacity < _DENSE_MIN_CAPACITY )
+    {
+        capacity = _DENSE_MIN_CAPACITY;
+    }
+    while( capacity <= (size_t)key )
+    {
+        capacity *= 2;
+    }
+    items = (void **)realloc( map->dense.items, capacity * sizeof( void * ) );
+    if( NULL == items )
+    {
+        VSILOGE( "Out of memory, map capacity %u", (uint32_t)capacity );
+        return FALSE;
+    }
+    memset( &items[map->dense.capacity], 0,
+        ( capacity - map->dense.capacity ) * sizeof( void * ) );
+    map->dense.items = items;
+    map->dense.capacity = capacity;
+    return TRUE;
+} /* _reserve_dense() */
+
+static vsi_nn_map_key_list_t * _find_sparse_key
+    (
+    vsi_nn_map_t      * map,
+    vsi_nn_map_key_t    key
+    )
+{
+    vsi_nn_map_key_list_t * key_iter;
+    key_iter = map->keys;
+    while( NULL != key_iter )
+    {
+        if( key_iter->val == key )
+        {
+            break;
+        }
+        key_iter = (vsi_nn_map_key_list_t *)vsi_nn_LinkListNext(
+                (vsi_nn_link_list_t *)key_iter );
+    }
+    return key_iter;
+} /* _find_sparse_key() */
+
 void vsi_nn_MapInit
     (
     vsi_nn_map_t * map
@@ -43,6 +108,31 @@ void vsi_nn_MapInit
     memset( map, 0, sizeof( vsi_nn_map_t ) );
 } /* vsi_nn_MapInit() */
 
+void vsi_nn_MapDeinit
+    (
+    vsi_nn_map_t * map
+    )
+{
+    vsi_nn_map_key_list_t * key_iter;
+    if( NULL == map )
+    {
+        return;
+    }
+    while( NULL != map->keys )
+    {
+        key_iter = map->keys;
+        vsi_nn_BinaryTreeRemoveNode( &map->values, key_iter->val );
+        vsi_nn_LinkListRemoveNode( (vsi_nn_link_list_t **)&map->keys,
+                (vsi_nn_link_list_t *)key_iter );
+        free( key_iter );
+    }
+    if( NULL != map->dense.items )
+    {
+        free( map->dense.items );
+    }
+    memset( map, 0, sizeof( vsi_nn_map_t ) );
+} /* vsi_nn_MapDeinit() */
+
 void * vsi_nn_MapGet
     (
     vsi_nn_map_t      * map,
@@ -53,6 +143,14 @@ void * vsi_nn_MapGet
     {
         return NULL;
     }
+    if( _is_dense_key( key ) )
+    {
+        if( (size_t)key < map->dense.capacity )
+        {
+            return map->dense.items[key];
+        }
+        return NULL;
+    }
     return vsi_nn_BinaryTreeGetNode( &map->values, key );
 } /* vsi_nn_MapGet() */
 
@@ -68,17 +166,26 @@ void vsi_nn_MapAdd
     {
         return;
     }
-    vsi_nn_BinaryTreeNewNode( &map->values, key, value );
-    key_iter = map->keys;
-    while( NULL != key_iter )
+    if( _is_dense_key( key ) )
     {
-        if( key_iter->val == key )
+        if( NULL == value )
         {
-            break;
+            vsi_nn_MapRemove( map, key );
+            return;
         }
-        key_iter = (vsi_nn_map_key_list_t *)vsi_nn_LinkListNext(
-                (vsi_nn_link_list_t *)key_iter );
+        if( !_reserve_dense( map, key ) )
+        {
+            return;
+        }
+        if( NULL == map->dense.items[key] )
+        {
+            map->size += 1;
+        }
+        map->dense.items[key] = value;
+        return;
     }
+    vsi_nn_BinaryTreeNewNode( &map->values, key, value );
+    key_iter = _find_sparse_key( map, key );
     if( NULL == key_iter )
     {
         key_iter = (vsi_nn_map_key_list_t *)vsi_nn_LinkListNewNode(
@@ -101,17 +208,18 @@ void vsi_nn_MapRemove
     {
         return;
     }
-    vsi_nn_BinaryTreeRemoveNode( &map->values, key );
-    key_iter = map->keys;
-    while( NULL != key_iter )
+    if( _is_dense_key( key ) )
     {
-        if( key_iter->val == key )
+        if( (size_t)key < map->dense.capacity
+            && NULL != map->dense.items[key] )
         {
-            break;
+            map->dense.items[key] = NULL;
+            map->size -= 1;
         }
-        key_iter = (vsi_nn_map_key_list_t *)vsi_nn_LinkListNext(
-                (vsi_nn_link_list_t *)key_iter );
+        return;
     }
+    vsi_nn_BinaryTreeRemoveNode( &map->values, key );
+    key_iter = _find_sparse_key( map, key );
     if( NULL != key_iter )
     {
         vsi_nn_LinkListRemoveNode( (vsi_nn_link_list_t **)&map->keys,
@@ -127,11 +235,7 @@ vsi_bool vsi_nn_MapHasKey
     vsi_nn_map_key_t    key
     )
 {
-    if( NULL == map )
-    {
-        return FALSE;
-    }
-    if( NULL == vsi_nn_BinaryTreeGetNode( &map->values, key ) )
+    if( NULL == vsi_nn_MapGet( map, key ) )
     {
         return FALSE;
     }
@@ -0,0 +1,111 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <stdlib.h>
+#include "vsi_nn_types.h"
+#include "utils/vsi_nn_mutex.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+struct _vsi_nn_mutex
+{
+#if defined(_WIN32)
+    CRITICAL_SECTION cs;
+#else
+    pthread_mutex_t m;
+#endif
+};
+
+vsi_nn_mutex_t vsi_nn_mutex_create
+    ( void )
+{
+    vsi_nn_mutex_t mutex = (vsi_nn_mutex_t)malloc( sizeof( struct _vsi_nn_mutex ) );
+    if( NULL == mutex )
+    {
+        return NULL;
+    }
+#if defined(_WIN32)
+    InitializeCriticalSection( &mutex->cs );
+#else
+    if( 0 != pthread_mutex_init( &mutex->m, NULL ) )
+    {
+        free( mutex );
+        return NULL;
+    }
+#endif
+    return mutex;
+} /* vsi_nn_mutex_create() */
+
+void vsi_nn_mutex_release
+    (
+    vsi_nn_mutex_t * mutex
+    )
+{
+    if( NULL == mutex || NULL == *mutex )
+    {
+        return;
+    }
+#if defined(_WIN32)
+    DeleteCriticalSection( &(*mutex)->cs );
+#else
+    pthread_mutex_destroy( &(*mutex)->m );
+#endif
+    free( *mutex );
+    *mutex = NULL;
+} /* vsi_nn_mutex_release() */
+
+void vsi_nn_mutex_lock
+    (
+    vsi_nn_mutex_t mutex
+    )
+{
+    if( NULL == mutex )
+    {
+        return;
+    }
+#if defined(_WIN32)
+    EnterCriticalSection( &mutex->cs );
+#else
+    pthread_mutex_lock( &mutex->m );
+#endif
+} /* vsi_nn_mutex_lock() */
+
+void vsi_nn_mutex_unlock
+    (
+    vsi_nn_mutex_t mutex
+    )
+{
+    if( NULL == mutex )
+    {
+        return;
+    }
+#if defined(_WIN32)
+    LeaveCriticalSection( &mutex->cs );
+#else
+    pthread_mutex_unlock( &mutex->m );
+#endif
+} /* vsi_nn_mutex_unlock() */
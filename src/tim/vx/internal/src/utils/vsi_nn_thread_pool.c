@@ -0,0 +1,240 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "vsi_nn_types.h"
+#include "vsi_nn_log.h"
+#include "utils/vsi_nn_thread_pool.h"
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#include <unistd.h>
+#define VSI_NN_PARALLEL_SUPPORT
+#endif
+
+#define VSI_NN_MAX_CPU_THREADS   (64)
+/* Chunks per thread, more chunks balance uneven work better */
+#define VSI_NN_CHUNKS_PER_THREAD (4)
+
+#ifdef VSI_NN_PARALLEL_SUPPORT
+
+typedef struct _vsi_nn_thread_pool
+{
+    /* Guards all fields below */
+    pthread_mutex_t lock;
+    /* Signaled when a task is posted */
+    pthread_cond_t task_cond;
+    /* Signaled when all items of a task are processed */
+    pthread_cond_t done_cond;
+    /* Held by the thread which posted the running task */
+    pthread_mutex_t busy;
+    uint32_t thread_num;
+    uint64_t task_id;
+    vsi_nn_parallel_func_t func;
+    void * data;
+    size_t total;
+    size_t chunk;
+    size_t next;
+    size_t done;
+} vsi_nn_thread_pool_t;
+
+static vsi_nn_thread_pool_t s_pool;
+static pthread_once_t s_pool_once = PTHREAD_ONCE_INIT;
+
+/* Process chunks of the current task, called with pool->lock held */
+static void _run_chunks
+    (
+    vsi_nn_thread_pool_t * pool
+    )
+{
+    while( pool->next < pool->total )
+    {
+        vsi_nn_parallel_func_t func = pool->func;
+        void * data = pool->data;
+        size_t start = pool->next;
+        size_t end = start + pool->chunk;
+
+        if( end > pool->total )
+        {
+            end = pool->total;
+        }
+        pool->next = end;
+
+        pthread_mutex_unlock( &pool->lock );
+        func( data, start, end );
+        pthread_mutex_lock( &pool->lock );
+
+        pool->done += end - start;
+        if( pool->done == pool->total )
+        {
+            pthread_cond_broadcast( &pool->done_cond );
+        }
+    }
+} /* _run_chunks() */
+
+static void * _worker
+    (
+    void * arg
+    )
+{
+    vsi_nn_thread_pool_t * pool = (vsi_nn_thread_pool_t *)arg;
+    uint64_t seen_task;
+
+    pthread_mutex_lock( &pool->lock );
+    seen_task = pool->task_id;
+    for( ;; )
+    {
+        while( pool->task_id == seen_task )
+        {
+            pthread_cond_wait( &pool->task_cond, &pool->lock );
+        }
+        seen_task = pool->task_id;
+        _run_chunks( pool );
+    }
+    return NULL;
+} /* _worker() */
+
+static uint32_t _get_thread_num( void )
+{
+    long num = 0;
+    char * env_s = getenv( "VSI_NN_CPU_THREADS" );
+
+    if( env_s )
+    {
+        num = atol( env_s );
+    }
+    else
+    {
+        num = sysconf( _SC_NPROCESSORS_ONLN );
+    }
+    if( num < 1 )
+    {
+        num = 1;
+    }
+    if( num > VSI_NN_MAX_CPU_THREADS )
+    {
+        num = VSI_NN_MAX_CPU_THREADS;
+    }
+    return (uint32_t)num;
+} /* _get_thread_num() */
+
+static void _init_pool( void )
+{
+    uint32_t i;
+
+    memset( &s_pool, 0, sizeof( s_pool ) );
+    pthread_mutex_init( &s_pool.lock, NULL );
+    pthread_mutex_init( &s_pool.busy, NULL );
+    pthread_cond_init( &s_pool.task_cond, NULL );
+    pthread_cond_init( &s_pool.done_cond, NULL );
+
+    /* The caller thread is one of the threads */
+    s_pool.thread_num = 1;
+    for( i = 1; i < _get_thread_num(); i++ )
+    {
+        pthread_t thread;
+        if( 0 != pthread_create( &thread, NULL, _worker, &s_pool ) )
+        {
+            VSILOGW( "Create cpu kernel thread fail, use %u threads.",
+                s_pool.thread_num );
+            break;
+        }
+        pthread_detach( thread );
+        s_pool.thread_num++;
+    }
+    VSILOGD( "Run cpu kernels with %u threads.", s_pool.thread_num );
+} /* _init_pool() */
+
+#endif
+
+void vsi_nn_parallel_for
+    (
+    size_t                  total,
+    size_t                  grain,
+    vsi_nn_parallel_func_t  func,
+    void                  * data
+    )
+{
+#ifdef VSI_NN_PARALLEL_SUPPORT
+    vsi_nn_thread_pool_t * pool = &s_pool;
+    size_t chunk;
+#endif
+
+    if( NULL == func || 0 == total )
+    {
+        return;
+    }
+    if( 0 == grain )
+    {
+        grain = 1;
+    }
+
+#ifdef VSI_NN_PARALLEL_SUPPORT
+    pthread_once( &s_pool_once, _init_pool );
+    if( total > grain && pool->thread_num > 1
+     && 0 == pthread_mutex_trylock( &pool->busy ) )
+    {
+        chunk = ( total + pool->thread_num * VSI_NN_CHUNKS_PER_THREAD - 1 )
+            / ( pool->thread_num * VSI_NN_CHUNKS_PER_THREAD );
+        if( chunk < grain )
+        {
+            chunk = grain;
+        }
+
+        pthread_mutex_lock( &pool->lock );
+        pool->func = func;
+        pool->data = data;
+        pool->total = total;
+        pool->chunk = chunk;
+        pool->next = 0;
+        pool->done = 0;
+        pool->task_id++;
+        pthread_cond_broadcast( &pool->task_cond );
+
+        _run_chunks( pool );
+        while( pool->done < pool->total )
+        {
+            pthread_cond_wait( &pool->done_cond, &pool->lock );
+        }
+        pool->func = NULL;
+        pool->data = NULL;
+        pthread_mutex_unlock( &pool->lock );
+        pthread_mutex_unlock( &pool->busy );
+        return;
+    }
+#endif
+
+    func( data, 0, total );
+} /* vsi_nn_parallel_for() */
+
+uint32_t vsi_nn_parallel_get_thread_num
+    ( void )
+{
+#ifdef VSI_NN_PARALLEL_SUPPORT
+    pthread_once( &s_pool_once, _init_pool );
+    return s_pool.thread_num;
+#else
+    return 1;
+#endif
+} /* vsi_nn_parallel_get_thread_num() */
@@ -22,10 +22,13 @@
 *
 *****************************************************************************/
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 #include "vsi_nn_types.h"
 #include "vsi_nn_test.h"
 #include "vsi_nn_context.h"
 #include "vsi_nn_platform.h"
+#include "kernel/vsi_nn_kernel.h"
 
 static vsi_status query_hardware_caps
     (
@@ -115,6 +118,155 @@ static vsi_status vsi_nn_initOptions
     return VSI_SUCCESS;
 }
 
+static vsi_status _init_program_cache
+    (
+    vsi_nn_program_cache_t *cache
+    )
+{
+    char* env_s = NULL;
+    size_t len = 0;
+
+    cache->programs = vsi_nn_hashmap_create();
+    if (NULL == cache->programs)
+    {
+        return VSI_FAILURE;
+    }
+
+    if (vsi_nn_getEnv("VSI_NN_PROGRAM_CACHE_DIR", &env_s) && env_s)
+    {
+        len = strlen(env_s);
+        cache->dir = (char*)malloc(len + 1);
+        if (cache->dir)
+        {
+            memcpy(cache->dir, env_s, len + 1);
+        }
+    }
+
+    return VSI_SUCCESS;
+}
+
+static void _deinit_program_cache
+    (
+    vsi_nn_program_cache_t *cache
+    )
+{
+    vsi_nn_hashmap_item_t* item = NULL;
+    vx_program program = NULL;
+
+    if (cache->programs)
+    {
+        VSILOGD("Program cache: %u hit, %u disk hit, %u miss.",
+            cache->hit, cache->disk_hit, cache->miss);
+        while ((item = vsi_nn_hashmap_iter(cache->programs, item)) != NULL)
+        {
+            program = (vx_program)item->data;
+            if (program)
+            {
+                vxReleaseProgram(&program);
+            }
+        }
+        vsi_nn_hashmap_release(&cache->programs);
+    }
+    if (cache->dir)
+    {
+        free(cache->dir);
+        cache->dir = NULL;
+    }
+}
+
+/*
+ * Each line of the tuning DB file is "<key> <kernel type> <kernel name>",
+ * later lines override earlier ones.
+ */
+static void _load_tuning_db
+    (
+    vsi_nn_tuning_db_t *db
+    )
+{
+    FILE* fp;
+    char line[256];
+    char key[VSI_NN_TUNING_DB_KEY_LEN];
+    char type_str[16];
+    int32_t type;
+
+    fp = fopen( db->path, "r" );
+    if( NULL == fp )
+    {
+        return;
+    }
+    while( fgets( line, sizeof( line ), fp ) )
+    {
+        if( 2 != sscanf( line, "%16s %15s", key, type_str ) )
+        {
+            continue;
+        }
+        for( type = 0; type < VSI_NN_KERNEL_TYPE_NUM; type ++ )
+        {
+            if( 0 == strcmp( type_str,
+                        vsi_nn_kernel_type_str( (vsi_nn_kernel_type_e)type ) ) )
+            {
+                vsi_nn_hashmap_add( db->entries, key,
+                        (void*)(uintptr_t)( type + 1 ) );
+                break;
+            }
+        }
+    }
+    fclose( fp );
+    VSILOGD("Load %u tuning DB entries from %s.",
+        (uint32_t)vsi_nn_hashmap_get_size( db->entries ), db->path);
+} /* _load_tuning_db() */
+
+static vsi_status _init_tuning_db
+    (
+    vsi_nn_tuning_db_t *db
+    )
+{
+    char* env_s = NULL;
+    size_t len = 0;
+
+    db->entries = vsi_nn_hashmap_create();
+    if (NULL == db->entries)
+    {
+        return VSI_FAILURE;
+    }
+
+    if (vsi_nn_getEnv("VSI_NN_ENABLE_AUTOTUNE", &env_s) && env_s)
+    {
+        db->enable_autotune = atoi(env_s);
+    }
+
+    env_s = NULL;
+    if (vsi_nn_getEnv("VSI_NN_TUNING_DB", &env_s) && env_s)
+    {
+        len = strlen(env_s);
+        db->path = (char*)malloc(len + 1);
+        if (db->path)
+        {
+            memcpy(db->path, env_s, len + 1);
+            _load_tuning_db(db);
+        }
+    }
+
+    return VSI_SUCCESS;
+}
+
+static void _deinit_tuning_db
+    (
+    vsi_nn_tuning_db_t *db
+    )
+{
+    if (db->entries)
+    {
+        VSILOGD("Tuning DB: %u hit, %u tuned.", db->hit, db->tuned);
+        vsi_nn_hashmap_release(&db->entries);
+    }
+    if (db->path)
+    {
+        free(db->path);
+        db->path = NULL;
+    }
+}
+
 vsi_nn_context_t vsi_nn_CreateContext
     ( void )
 {
@@ -147,6 +299,25 @@ vsi_nn_context_t vsi_nn_CreateContext
         return NULL;
     }
 
+    context->lock = vsi_nn_mutex_create();
+    if (NULL == context->lock)
+    {
+        vsi_nn_ReleaseContext(&context);
+        return NULL;
+    }
+
+    if (_init_program_cache(&context->program_cache) != VSI_SUCCESS)
+    {
+        vsi_nn_ReleaseContext(&context);
+        return NULL;
+    }
+
+    if (_init_tuning_db(&context->tuning_db) != VSI_SUCCESS)
+    {
+        vsi_nn_ReleaseContext(&context);
+        return NULL;
+    }
+
     return context;
 } /* vsi_nn_CreateContext() */
 
@@ -156,6 +327,9 @@ void vsi_nn_ReleaseContext
     if( NULL != ctx && NULL != *ctx )
     {
         vsi_nn_context_t context = *ctx;
+        _deinit_program_cache(&context->program_cache);
+        _deinit_tuning_db(&context->tuning_db);
+        vsi_nn_mutex_release(&context->lock);
         if(context->c)
         {
             vxReleaseContext( &context->c);
@@ -164,3 +338,54 @@ void vsi_nn_ReleaseContext
         *ctx = NULL;
     }
 } /* vsi_nn_ReleaseContext() */
+
+void vsi_nn_GetProgramCacheStats
+    (
+    vsi_nn_context_t ctx,
+    uint32_t * hit,
+    uint32_t * disk_hit,
+    uint32_t * miss
+    )
+{
+    if( NULL == ctx )
+    {
+        return;
+    }
+    vsi_nn_mutex_lock( ctx->lock );
+    if( hit )
+    {
+        *hit = ctx->program_cache.hit;
+    }
+    if( disk_hit )
+    {
+        *disk_hit = ctx->program_cache.disk_hit;
+    }
+    if( miss )
+    {
+        *miss = ctx->program_cache.miss;
+    }
+    vsi_nn_mutex_unlock( ctx->lock );
+} /* vsi_nn_GetProgramCacheStats() */
+
+void vsi_nn_GetTuningDBStats
+    (
+    vsi_nn_context_t ctx,
+    uint32_t * hit,
+    uint32_t * tuned
+    )
+{
+    if( NULL == ctx )
+    {
+        return;
+    }
+    vsi_nn_mutex_lock( ctx->lock );
+    if( hit )
+    {
+        *hit = ctx->tuning_db.hit;
+    }
+    if( tuned )
+    {
+        *tuned = ctx->tuning_db.tuned;
+    }
+    vsi_nn_mutex_unlock( ctx->lock );
+} /* vsi_nn_GetTuningDBStats() */
@@ -40,6 +40,347 @@
 #include "utils/vsi_nn_vdata.h"
 #include "utils/vsi_nn_map.h"
 #include "vsi_nn_graph_optimization.h"
+#include "kernel/vsi_nn_kernel.h"
+
+/*
+ * Tensor producer/consumer index, updated as nodes are added, removed or
+ * rewired instead of being rebuilt. Consumers of a tensor are kept in
+ * ascending node id order, a node is listed once per tensor even if it
+ * consumes the tensor several times. Each linked node keeps the io ids it
+ * was linked with, so it can be unlinked after its io changed.
+ */
+typedef struct _vsi_nn_tensor_links
+{
+    vsi_nn_node_id_t    producer;
+    uint32_t            consumer_num;
+    uint32_t            consumer_size;
+    vsi_nn_node_id_t  * consumers;
+} vsi_nn_tensor_links_t;
+
+typedef struct _vsi_nn_node_links
+{
+    vsi_bool             linked;
+    uint32_t             input_num;
+    uint32_t             output_num;
+    /* Inputs followed by outputs */
+    vsi_nn_tensor_id_t * tensors;
+} vsi_nn_node_links_t;
+
+typedef struct _vsi_nn_graph_adjacency
+{
+    uint32_t                tensor_size;
+    vsi_nn_tensor_links_t * tensors;
+    uint32_t                node_size;
+    vsi_nn_node_links_t   * nodes;
+    /* Nodes added from this id on are linked on the next query */
+    uint32_t                pending_node;
+} vsi_nn_graph_adjacency_t;
+
+static void _release_adjacency
+    (
+    vsi_nn_graph_adjacency_t ** adjacency
+    )
+{
+    uint32_t i;
+    vsi_nn_graph_adjacency_t * ptr;
+    if( NULL == adjacency || NULL == *adjacency )
+    {
+        return;
+    }
+    ptr = *adjacency;
+    for( i = 0; i < ptr->tensor_size; i++ )
+    {
+        vsi_nn_safe_free( ptr->tensors[i].consumers );
+    }
+    for( i = 0; i < ptr->node_size; i++ )
+    {
+        vsi_nn_safe_free( ptr->nodes[i].tensors );
+    }
+    vsi_nn_safe_free( ptr->tensors );
+    vsi_nn_safe_free( ptr->nodes );
+    free( ptr );
+    *adjacency = NULL;
+} /* _release_adjacency() */
+
+/* Return TRUE if input `j` of the node refers to a tensor already seen at a previous input. */
+static vsi_bool _is_duplicated_input
+    (
+    const vsi_nn_tensor_id_t * inputs,
+    uint32_t j
+    )
+{
+    uint32_t k;
+    for( k = 0; k < j; k++ )
+    {
+        if( inputs[k] == inputs[j] )
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+} /* _is_duplicated_input() */
+
+/* Grow an array of `*size` items of `item_size` bytes to hold index `need`. */
+static vsi_bool _reserve
+    (
+    void ** array,
+    uint32_t * size,
+    size_t item_size,
+    uint32_t need
+    )
+{
+    uint32_t new_size;
+    uint8_t * ptr;
+    if( need < *size )
+    {
+        return TRUE;
+    }
+    new_size = *size > 0 ? *size : 16;
+    while( new_size <= need )
+    {
+        new_size *= 2;
+    }
+    ptr = (uint8_t *)realloc( *array, new_size * item_size );
+    if( NULL == ptr )
+    {
+        return FALSE;
+    }
+    memset( ptr + *size * item_size, 0, ( new_size - *size ) * item_size );
+    *array = ptr;
+    *size = new_size;
+    return TRUE;
+} /* _reserve() */
+
+static vsi_nn_tensor_links_t * _get_tensor_links
+    (
+    vsi_nn_graph_adjacency_t * adjacency,
+    vsi_nn_tensor_id_t tensor_id
+    )
+{
+    uint32_t i;
+    uint32_t old_size = adjacency->tensor_size;
+    if( VSI_NN_TENSOR_ID_NA == tensor_id || VSI_NN_TENSOR_ID_AUTO == tensor_id )
+    {
+        return NULL;
+    }
+    if( !_reserve( (void **)&adjacency->tensors, &adjacency->tensor_size,
+            sizeof( vsi_nn_tensor_links_t ), tensor_id ) )
+    {
+        VSILOGE( "Out of memory, update tensor adjacency fail." );
+        return NULL;
+    }
+    for( i = old_size; i < adjacency->tensor_size; i++ )
+    {
+        adjacency->tensors[i].producer = VSI_NN_NODE_ID_NA;
+    }
+    return &adjacency->tensors[tensor_id];
+} /* _get_tensor_links() */
+
+static void _add_consumer
+    (
+    vsi_nn_tensor_links_t * links,
+    vsi_nn_node_id_t node_id
+    )
+{
+    uint32_t pos = links->consumer_num;
+    if( !_reserve( (void **)&links->consumers, &links->consumer_size,
+            sizeof( vsi_nn_node_id_t ), links->consumer_num ) )
+    {
+        VSILOGE( "Out of memory, update tensor adjacency fail." );
+        return;
+    }
+    /* Nodes are mostly linked in id order, search from the tail */
+    while( pos > 0 && links->consumers[pos - 1] > node_id )
+    {
+        pos--;
+    }
+    memmove( &links->consumers[pos + 1], &links->consumers[pos],
+        ( links->consumer_num - pos ) * sizeof( vsi_nn_node_id_t ) );
+    links->consumers[pos] = node_id;
+    links->consumer_num++;
+} /* _add_consumer() */
+
+static void _remove_consumer
+    (
+    vsi_nn_tensor_links_t * links,
+    vsi_nn_node_id_t node_id
+    )
+{
+    uint32_t i;
+    for( i = 0; i < links->consumer_num; i++ )
+    {
+        if( links->consumers[i] == node_id )
+        {
+            memmove( &links->consumers[i], &links->consumers[i + 1],
+                ( links->consumer_num - i - 1 ) * sizeof( vsi_nn_node_id_t ) );
+            links->consumer_num--;
+            return;
+        }
+    }
+} /* _remove_consumer() */
+
+static void _unlink_node
+    (
+    vsi_nn_graph_adjacency_t * adjacency,
+    vsi_nn_node_id_t node_id
+    )
+{
+    uint32_t j;
+    vsi_nn_node_links_t * node_links;
+    vsi_nn_tensor_links_t * links;
+    if( node_id >= adjacency->node_size || !adjacency->nodes[node_id].linked )
+    {
+        return;
+    }
+    node_links = &adjacency->nodes[node_id];
+    for( j = 0; j < node_links->input_num; j++ )
+    {
+        links = _get_tensor_links( adjacency, node_links->tensors[j] );
+        if( links && !_is_duplicated_input( node_links->tensors, j ) )
+        {
+            _remove_consumer( links, node_id );
+        }
+    }
+    for( j = 0; j < node_links->output_num; j++ )
+    {
+        links = _get_tensor_links( adjacency,
+            node_links->tensors[node_links->input_num + j] );
+        if( links && links->producer == node_id )
+        {
+            links->producer = VSI_NN_NODE_ID_NA;
+        }
+    }
+    vsi_nn_safe_free( node_links->tensors );
+    node_links->linked = FALSE;
+} /* _unlink_node() */
+
+static void _link_node
+    (
+    vsi_nn_graph_adjacency_t * adjacency,
+    vsi_nn_node_id_t node_id,
+    const vsi_nn_node_t * node
+    )
+{
+    uint32_t j;
+    uint32_t io_num;
+    vsi_nn_node_links_t * node_links;
+    vsi_nn_tensor_links_t * links;
+    if( !_reserve( (void **)&adjacency->nodes, &adjacency->node_size,
+            sizeof( vsi_nn_node_links_t ), node_id ) )
+    {
+        VSILOGE( "Out of memory, update tensor adjacency fail." );
+        return;
+    }
+    node_links = &adjacency->nodes[node_id];
+    io_num = node->input.num + node->output.num;
+    node_links->tensors = (vsi_nn_tensor_id_t *)malloc(
+        ( io_num + 1 ) * sizeof( vsi_nn_tensor_id_t ) );
+    if( NULL == node_links->tensors )
+    {
+        VSILOGE( "Out of memory, update tensor adjacency fail." );
+        return;
+    }
+    node_links->input_num = node->input.num;
+    node_links->output_num = node->output.num;
+    memcpy( node_links->tensors, node->input.tensors,
+        node->input.num * sizeof( vsi_nn_tensor_id_t ) );
+    memcpy( &node_links->tensors[node->input.num], node->output.tensors,
+        node->output.num * sizeof( vsi_nn_tensor_id_t ) );
+    node_links->linked = TRUE;
+
+    for( j = 0; j < node->input.num; j++ )
+    {
+        links = _get_tensor_links( adjacency, node->input.tensors[j] );
+        if( links && !_is_duplicated_input( node->input.tensors, j ) )
+        {
+            _add_consumer( links, node_id );
+        }
+    }
+    /* The provider is the first node writing the tensor */
+    for( j = 0; j < node->output.num; j++ )
+    {
+        links = _get_tensor_links( adjacency, node->output.tensors[j] );
+        if( links && ( VSI_NN_NODE_ID_NA == links->producer
+                    || node_id < links->producer ) )
+        {
+            links->producer = node_id;
+        }
+    }
+} /* _link_node() */
+
+/* Return TRUE if the node io changed since it was linked. */
+static vsi_bool _is_node_rewired
+    (
+    const vsi_nn_graph_adjacency_t * adjacency,
+    vsi_nn_node_id_t node_id,
+    const vsi_nn_node_t * node
+    )
+{
+    const vsi_nn_node_links_t * node_links = &adjacency->nodes[node_id];
+    return node_links->input_num != node->input.num
+        || node_links->output_num != node->output.num
+        || 0 != memcmp( node_links->tensors, node->input.tensors,
+                node->input.num * sizeof( vsi_nn_tensor_id_t ) )
+        || 0 != memcmp( &node_links->tensors[node->input.num], node->output.tensors,
+                node->output.num * sizeof( vsi_nn_tensor_id_t ) );
+} /* _is_node_rewired() */
+
+static vsi_nn_graph_adjacency_t * _get_adjacency
+    (
+    vsi_nn_graph_t * graph
+    )
+{
+    uint32_t i;
+    vsi_nn_node_t * node;
+    vsi_nn_graph_adjacency_t * adjacency = graph->adjacency;
+    if( NULL == adjacency )
+    {
+        adjacency = (vsi_nn_graph_adjacency_t *)malloc( sizeof( vsi_nn_graph_adjacency_t ) );
+        if( NULL == adjacency )
+        {
+            VSILOGE( "Out of memory, build tensor adjacency fail." );
+            return NULL;
+        }
+        memset( adjacency, 0, sizeof( vsi_nn_graph_adjacency_t ) );
+        graph->adjacency = adjacency;
+    }
+    /* Nodes are usually wired after vsi_nn_AddNode(), link them on first use */
+    for( i = adjacency->pending_node; i < graph->node_num; i++ )
+    {
+        node = vsi_nn_GetNode( graph, (vsi_nn_node_id_t)i );
+        if( NULL != node )
+        {
+            _link_node( adjacency, (vsi_nn_node_id_t)i, node );
+        }
+    }
+    adjacency->pending_node = graph->node_num;
+    return adjacency;
+} /* _get_adjacency() */
+
+/* Relink the nodes whose io was written directly since they were linked. */
+static void _sync_adjacency
+    (
+    vsi_nn_graph_t * graph
+    )
+{
+    uint32_t i;
+    vsi_nn_node_t * node;
+    vsi_nn_graph_adjacency_t * adjacency = graph->adjacency;
+    if( NULL == adjacency )
+    {
+        return;
+    }
+    for( i = 0; i < adjacency->pending_node && i < adjacency->node_size; i++ )
+    {
+        node = vsi_nn_GetNode( graph, (vsi_nn_node_id_t)i );
+        if( NULL != node && adjacency->nodes[i].linked
+            && _is_node_rewired( adjacency, (vsi_nn_node_id_t)i, node ) )
+        {
+            _unlink_node( adjacency, (vsi_nn_node_id_t)i );
+            _link_node( adjacency, (vsi_nn_node_id_t)i, node );
+        }
+    }
+} /* _sync_adjacency() */
 
 static vsi_status _set_reference_node_name
     (
@@ -623,6 +964,7 @@ void vsi_nn_ReleaseGraph
             {
                 vsi_nn_RemoveNode( *graph, (vsi_nn_node_id_t)i );
             }
+            vsi_nn_MapDeinit( (*graph)->node_table );
             free( (*graph)->node_table );
         }
         if( NULL != ptr->g )
@@ -635,6 +977,7 @@ void vsi_nn_ReleaseGraph
             {
                 vsi_nn_RemoveTensor( *graph, (vsi_nn_tensor_id_t)i );
             }
+            vsi_nn_MapDeinit( (*graph)->tensor_table );
             free( (*graph)->tensor_table );
         }
         if( ptr->complete_signal.exists
@@ -654,6 +997,8 @@ void vsi_nn_ReleaseGraph
         {
             vsi_nn_rnn_DeinitWksp( ptr );
         }
+        _release_adjacency( &ptr->adjacency );
+        vsi_nn_kernel_release_node_records( ptr );
         free( ptr );
         *graph = NULL;
     }
@@ -1145,6 +1490,7 @@ vsi_nn_node_t * vsi_nn_AddNode
         vsi_nn_MapAdd( graph->node_table, (vsi_nn_map_key_t)id, (void *)node );
         graph->cur_nid ++;
         graph->node_num = graph->cur_nid;
+        node->id = id;
     }
     else
     {
@@ -1183,6 +1529,10 @@ void vsi_nn_RemoveNode
         node = vsi_nn_GetNode( graph, id );
         if( NULL != node )
         {
+            if( NULL != graph->adjacency )
+            {
+                _unlink_node( graph->adjacency, id );
+            }
             vsi_nn_ReleaseNode( &node );
             vsi_nn_MapRemove( graph->node_table,
                     (vsi_nn_map_key_t)id );
@@ -1259,17 +1609,19 @@ vsi_nn_node_id_t * vsi_nn_SortGraphNode
     vsi_nn_graph_t * graph
     )
 {
-    uint32_t i,j;
-    uint32_t             count;
-    vsi_bool             dirty;
-    vsi_bool             all_tensor_processed;
+    uint32_t i,j,k;
+    uint32_t             head;
+    uint32_t             tail;
     vsi_bool           * tensors;
-    vsi_nn_node_id_t   * nodes;
+    uint32_t           * pending;
     vsi_nn_node_id_t   * sorted_nodes;
     vsi_nn_node_t      * node;
     vsi_nn_node_id_t     node_id;
+    vsi_nn_node_id_t     consumer_id;
     vsi_nn_tensor_id_t   tensor_id;
     vsi_nn_tensor_t    * tensor;
+    vsi_nn_graph_adjacency_t * adjacency;
+    vsi_nn_tensor_links_t * links;
 
     if( NULL == graph || NULL == graph->nodes
         || NULL == graph->tensors )
@@ -1278,27 +1630,30 @@ vsi_nn_node_id_t * vsi_nn_SortGraphNode
     }
 
     tensors      = NULL;
+    pending      = NULL;
     sorted_nodes = NULL;
-    nodes        = NULL;
-    node         = NULL;
-    node_id      = VSI_NN_NODE_ID_NA;
-
-    /* Init variables. */
-    tensors = (vsi_bool *)malloc(
-        graph->tensor_num * sizeof( vsi_bool ) );
 
-    if( NULL == tensors )
+    /* Nodes may be wired directly by the caller, the sort visits every
+     * node anyway so catch up with those first. */
+    _sync_adjacency( graph );
+    adjacency = _get_adjacency( graph );
+    if( NULL == adjacency )
     {
-        goto _SortGraphNodeFinally;
+        return NULL;
     }
 
+    /* Init variables. */
+    tensors = (vsi_bool *)malloc(
+        graph->tensor_num * sizeof( vsi_bool ) );
+    /* Number of unready input tensors of each node */
+    pending = (uint32_t *)malloc(
+        graph->node_num * sizeof( uint32_t ) );
     sorted_nodes = (vsi_nn_node_id_t *)malloc(
         graph->node_num * sizeof( vsi_nn_node_id_t ) );
-    nodes = (vsi_nn_node_id_t *)malloc(
-        graph->node_num * sizeof( vsi_nn_node_id_t ) );
 
-    if( NULL == sorted_nodes || NULL == nodes)
+    if( NULL == tensors || NULL == pending || NULL == sorted_nodes )
     {
+        vsi_nn_safe_free( sorted_nodes );
         goto _SortGraphNodeFinally;
     }
 
@@ -1319,70 +1674,81 @@ vsi_nn_node_id_t * vsi_nn_SortGraphNode
     for( i = 0; i < graph->input.num; i++ )
     {
         tensor_id = graph->input.tensors[i];
-        if( tensor_id != VSI_NN_TENSOR_ID_NA )
+        if( tensor_id < graph->tensor_num )
         {
             tensors[tensor_id] = TRUE;
         }
     }
 
+    /* Kahn's algorithm, sorted_nodes is used as the ready queue. */
+    tail = 0;
     for( i = 0; i < graph->node_num; i++ )
     {
-        nodes[i] = i;
-    }
-    count = graph->node_num;
-    do
-    {
-        dirty = FALSE;
-        all_tensor_processed = FALSE;
-        for( i = 0; i < count; i ++ )
+        pending[i] = 0;
+        node = vsi_nn_GetNode( graph, (vsi_nn_node_id_t)i );
+        if( NULL != node )
         {
-            node_id = nodes[i];
-            node = vsi_nn_GetNode( graph, node_id );
-            all_tensor_processed = TRUE;
             for( j = 0; j < node->input.num; j ++ )
             {
                 tensor_id = node->input.tensors[j];
-                if( VSI_NN_TENSOR_ID_NA == tensor_id )
+                if( tensor_id < graph->tensor_num
+                    && FALSE == tensors[tensor_id]
+                    && !_is_duplicated_input( node->input.tensors, j ) )
                 {
-                    continue;
-                }
-                if( FALSE == tensors[tensor_id] )
-                {
-                    all_tensor_processed = FALSE;
-                    break;
+                    pending[i] ++;
                 }
             }
-            if( TRUE == all_tensor_processed )
+        }
+        if( 0 == pending[i] )
+        {
+            sorted_nodes[tail++] = (vsi_nn_node_id_t)i;
+        }
+    }
+
+    for( head = 0; head < tail; head++ )
+    {
+        node_id = sorted_nodes[head];
+        node = vsi_nn_GetNode( graph, node_id );
+        if( NULL == node )
+        {
+            continue;
+        }
+        for( j = 0; j < node->output.num; j ++ )
+        {
+            tensor_id = node->output.tensors[j];
+            if( tensor_id >= graph->tensor_num || TRUE == tensors[tensor_id] )
+            {
+                continue;
+            }
+            tensors[tensor_id] = TRUE;
+            if( tensor_id >= adjacency->tensor_size )
             {
-                sorted_nodes[graph->node_num - count] = nodes[i];
-                nodes[i] = nodes[count - 1];
-                count --;
-                i --;
-                dirty = TRUE;
-                for( j = 0; j < node->output.num; j ++ )
+                continue;
+            }
+            links = &adjacency->tensors[tensor_id];
+            for( k = 0; k < links->consumer_num; k++ )
+            {
+                consumer_id = links->consumers[k];
+                pending[consumer_id] --;
+                if( 0 == pending[consumer_id] )
                 {
-                    tensor_id = node->output.tensors[j];
-                    if( VSI_NN_TENSOR_ID_NA == tensor_id )
-                    {
-                        continue;
-                    }
-                    tensors[tensor_id] = TRUE;
+                    sorted_nodes[tail++] = consumer_id;
                 }
             }
         }
-        if( FALSE == dirty )
+    }
+
+    if( tail != graph->node_num )
+    {
+        for( i = 0; i < graph->node_num; i++ )
         {
-            if( FALSE == all_tensor_processed )
+            if( 0 != pending[i] )
             {
                 // TODO: Log all unprocessed tensors
-                VSILOGW("Unprocessed node %u", node_id);
+                VSILOGW("Unprocessed node %u", i);
+                break;
             }
-            break;
         }
-    } while( count > 0 );
-
-    if( count != 0 )
-    {
         free( sorted_nodes );
         sorted_nodes = NULL;
     }
@@ -1390,8 +1756,8 @@ vsi_nn_node_id_t * vsi_nn_SortGraphNode
 _SortGraphNodeFinally:
 
     /* Release memory. */
-    free( tensors );
-    free( nodes );
+    vsi_nn_safe_free( tensors );
+    vsi_nn_safe_free( pending );
     return sorted_nodes;
 } /* vsi_nn_SortGraphNode() */
 
@@ -1969,22 +2335,19 @@ void  vsi_nn_get_tensor_consumers
     uint32_t* count
     )
 {
-    vsi_nn_node_t* node = NULL;
-    uint32_t i, j = 0;
+    uint32_t i;
     uint32_t nodes_count = 0;
-    for(i = 0; i < graph->node_num; i++)
+    vsi_nn_tensor_links_t * links;
+    vsi_nn_graph_adjacency_t * adjacency = _get_adjacency(graph);
+    if(adjacency != NULL && tensor_id < adjacency->tensor_size)
     {
-        node = vsi_nn_GetNode(graph, i);
-        for(j = 0; j < node->input.num; j++)
+        links = &adjacency->tensors[tensor_id];
+        nodes_count = links->consumer_num;
+        if(nodes != NULL)
         {
-            if(node->input.tensors[j] == tensor_id)
+            for(i = 0; i < nodes_count; i++)
             {
-                if(nodes != NULL)
-                {
-                    nodes[nodes_count] = node;
-                }
-                nodes_count += 1;
-                break;
+                nodes[i] = vsi_nn_GetNode(graph, links->consumers[i]);
             }
         }
     }
@@ -2001,22 +2364,46 @@ void vsi_nn_get_tensor_provider
     vsi_nn_node_t** node
     )
 {
-    vsi_nn_node_t* cur_node = NULL;
-    uint32_t i, j = 0;
-    for(i = 0; i < graph->node_num; i++)
+    vsi_nn_graph_adjacency_t * adjacency = _get_adjacency(graph);
+    if(adjacency != NULL && tensor_id < adjacency->tensor_size
+        && VSI_NN_NODE_ID_NA != adjacency->tensors[tensor_id].producer)
     {
-        cur_node = vsi_nn_GetNode(graph, i);
-        for(j = 0; j < cur_node->output.num; j++)
-        {
-            if(cur_node->output.tensors[j] == tensor_id)
-            {
-                *node = cur_node;
-                return;
-            }
-        }
+        *node = vsi_nn_GetNode(graph, adjacency->tensors[tensor_id].producer);
     }
 } /* vsi_nn_get_tensor_provider() */
 
+void vsi_nn_update_tensor_adjacency
+    (
+    vsi_nn_graph_t* graph,
+    vsi_nn_node_t* node
+    )
+{
+    vsi_nn_graph_adjacency_t * adjacency;
+    if(graph == NULL || node == NULL || graph->adjacency == NULL
+        || VSI_NN_NODE_ID_NA == node->id)
+    {
+        return;
+    }
+    adjacency = graph->adjacency;
+    /* Nodes not linked yet are linked with their io on the next query */
+    if(node->id < adjacency->pending_node)
+    {
+        _unlink_node(adjacency, node->id);
+        _link_node(adjacency, node->id, node);
+    }
+} /* vsi_nn_update_tensor_adjacency() */
+
+void vsi_nn_invalidate_tensor_adjacency
+    (
+    vsi_nn_graph_t* graph
+    )
+{
+    if(graph != NULL)
+    {
+        _release_adjacency(&graph->adjacency);
+    }
+} /* vsi_nn_invalidate_tensor_adjacency() */
+
 vsi_status vsi_nn_SetGraphPreloadSize
     (
     vsi_nn_graph_t* graph,
@@ -98,10 +98,12 @@ static vsi_status _add_forward_node
                 first_node[i]->input.tensors[j] = output;
             }
         }
+        vsi_nn_update_tensor_adjacency(graph, first_node[i]);
     }
 
     node->input.tensors[0] = input;
     node->output.tensors[0] = output;
+    vsi_nn_update_tensor_adjacency(graph, node);
 
     return VSI_SUCCESS;
 }/* _add_forward_node() */
@@ -126,9 +128,11 @@ static vsi_status _add_backward_node
             break;
         }
     }
+    vsi_nn_update_tensor_adjacency(graph, last_node);
 
     node->input.tensors[0] = input;
     node->output.tensors[0] = output;
+    vsi_nn_update_tensor_adjacency(graph, node);
 
     return VSI_SUCCESS;
 }/* _add_backward_node() */
@@ -82,6 +82,7 @@ vsi_nn_node_t * vsi_nn_NewNode
         vsi_nn_InitTensorsId( node->input.tensors, (uint32_t)input_num );
         node->attr.const_tensor_preload_type = VSI_NN_NODE_PRELOAD_NONE;
         node->attr.enable_op_constraint_check = TRUE;
+        node->id = VSI_NN_NODE_ID_NA;
     }
 
     node->uid = VSI_NN_NODE_UID_NA;
@@ -157,6 +158,7 @@ vsi_status vsi_nn_SetNodeInputsAndOutputs
             node->output.tensors[i] = id;
         }
     }
+    vsi_nn_update_tensor_adjacency(node->graph, node);
     return status;
 } /* vsi_nn_SetNodeInputsAndOutputs() */
 
@@ -551,6 +551,7 @@ vsi_status vsi_nn_add_single_preproc_node
                 break;
             }
         }
+        vsi_nn_update_tensor_adjacency(graph, first_node[i]);
     }
 
     for(i = 0; i < node_input_num; i++)
@@ -560,6 +561,7 @@ vsi_status vsi_nn_add_single_preproc_node
     _reconnect_graph_inputs(graph, org_input, input_idx, preproc_inputs, node_input_num);
 
     node->output.tensors[0] = preproc_output;
+    vsi_nn_update_tensor_adjacency(graph, node);
 
     status = VSI_SUCCESS;
 
@@ -649,6 +651,7 @@ vsi_status vsi_nn_add_single_postproc_node
                             break;
                         }
                     }
+                vsi_nn_update_tensor_adjacency(graph, consume_nodes[i]);
             }
     }
 
@@ -663,6 +666,8 @@ vsi_status vsi_nn_add_single_postproc_node
             break;
         }
     }
+    vsi_nn_update_tensor_adjacency(graph, last_node);
+    vsi_nn_update_tensor_adjacency(graph, node);
     graph->output.tensors[output_idx] = postproc_output;
 
 
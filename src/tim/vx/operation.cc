@@ -43,12 +43,15 @@ OperationImpl::OperationImpl(Graph* graph, uint32_t operation_id,
                            output_cnt_, NULL)) {
   SetRoundingPolicy();
   node_->uid = graph_->graph()->cur_nid;
+  const uint8_t* param = reinterpret_cast<const uint8_t*>(&node_->nn_param);
+  param_baseline_.assign(param, param + sizeof(node_->nn_param));
 }
 
 OperationImpl& OperationImpl::BindInput(const std::shared_ptr<Tensor>& tensor) {
   inputs_tensor_.push_back(tensor);
   uint32_t tensor_id = tensor->GetId();
   node_->input.tensors[input_tensor_index++] = tensor_id;
+  vsi_nn_update_tensor_adjacency(graph_->graph(), node_);
   if (tensor->GetSpec().attr_ & TensorAttribute::INPUT) {
     graph_->AddInput(tensor_id);
     graph_->AddInput(tensor);
@@ -61,6 +64,7 @@ OperationImpl& OperationImpl::BindOutput(
   outputs_tensor_.push_back(tensor);
   uint32_t tensor_id = tensor->GetId();
   node_->output.tensors[output_tensor_index++] = tensor_id;
+  vsi_nn_update_tensor_adjacency(graph_->graph(), node_);
   if (tensor->GetSpec().attr_ == TensorAttribute::OUTPUT) {
     graph_->AddOutput(tensor_id);
     graph_->AddOutput(tensor);
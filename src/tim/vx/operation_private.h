@@ -23,6 +23,9 @@
 *****************************************************************************/
 #ifndef TIM_VX_OPERATION_PRIVATE_H_
 #define TIM_VX_OPERATION_PRIVATE_H_
+#include <utility>
+#include <vector>
+
 #include "graph_private.h"
 #include "vsi_nn_pub.h"
 
@@ -46,6 +49,25 @@ class OperationImpl {
 
   vsi_nn_node_t* node() { return this->node_; }
 
+  /// Record an array referenced by a pointer in node()->nn_param so that
+  /// graph hashing covers its content instead of its address
+  template <typename T>
+  void RegisterParamArray(const std::vector<T>& array) {
+    RegisterParamArray(array, array);
+  }
+
+  /// As above for an array ovxlib rewrites in place during setup, `content`
+  /// holds what the array contains after setup and is hashed instead, so
+  /// the hash doesn't depend on whether the graph was set up already
+  template <typename T>
+  void RegisterParamArray(const std::vector<T>& array,
+                          const std::vector<T>& content) {
+    if (!array.empty()) {
+      param_arrays_.push_back(
+          {array.data(), content.data(), content.size() * sizeof(T)});
+    }
+  }
+
   std::vector<std::shared_ptr<Tensor>> InputsTensor() { return inputs_tensor_; }
   std::vector<std::shared_ptr<Tensor>> OutputsTensor() {
     return outputs_tensor_;
@@ -61,7 +83,14 @@ class OperationImpl {
   int32_t output_tensor_index{0};
   std::vector<std::shared_ptr<Tensor>> inputs_tensor_;
   std::vector<std::shared_ptr<Tensor>> outputs_tensor_;
-
+  /// nn_param right after node creation, i.e. the op's defaults
+  std::vector<uint8_t> param_baseline_;
+  struct ParamArray {
+    const void* address;
+    const void* content;
+    size_t bytes;
+  };
+  std::vector<ParamArray> param_arrays_;
 };
 
 }  // namespace vx
@@ -0,0 +1,93 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/axis_aligned_bbox_transform.h"
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+TEST(AxisAlignedBBoxTransform, shape_8_3_float_2_batches) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::TensorSpec rois_spec(tim::vx::DataType::FLOAT32,
+        {4, 3}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec deltas_spec(tim::vx::DataType::FLOAT32,
+        {8, 3}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec batch_spec(tim::vx::DataType::INT32,
+        {3}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec image_spec(tim::vx::DataType::FLOAT32,
+        {2, 2}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32,
+        {8, 3}, tim::vx::TensorAttribute::OUTPUT);
+
+    auto rois_tensor = graph->CreateTensor(rois_spec);
+    auto deltas_tensor = graph->CreateTensor(deltas_spec);
+    auto batch_tensor = graph->CreateTensor(batch_spec);
+    auto image_tensor = graph->CreateTensor(image_spec);
+    auto output_tensor = graph->CreateTensor(output_spec);
+
+    std::vector<float> rois_data = {
+        100, 150, 400, 430,
+        120, 60, 122, 61,
+        10, 20, 20, 50,
+        };
+    std::vector<float> deltas_data = {
+        0.2, 0.2, 0.1, 0.1, 0.3, -0.1, -0.2, 0.1,
+        -0.5, 0.1, -0.5, -0.1, 1.0, -0.2, 0.2, 0.5,
+        0.3, -0.1, -0.2, 0.1, -0.5, 0.1, -0.5, -0.1,
+        };
+    std::vector<int32_t> batch_data = {0, 0, 1};
+    std::vector<float> image_data = {512, 512, 128, 256};
+    // The last roi is clipped to the image of its own batch
+    std::vector<float> golden = {
+        144.2244, 191.2761, 475.7756, 500.7239,
+        217.1904, 107.2761, 462.8096, 416.7239,
+        119.3935, 60.1476, 120.6065, 61.0524,
+        121.7786, 59.4756, 124.2214, 61.1244,
+        13.9063, 15.4224, 22.0937, 48.5776,
+        6.9673, 24.4274, 13.0327, 51.5726,
+        };
+
+    EXPECT_TRUE(rois_tensor->CopyDataToTensor(
+        rois_data.data(), rois_data.size() * sizeof(float)));
+    EXPECT_TRUE(deltas_tensor->CopyDataToTensor(
+        deltas_data.data(), deltas_data.size() * sizeof(float)));
+    EXPECT_TRUE(batch_tensor->CopyDataToTensor(
+        batch_data.data(), batch_data.size() * sizeof(int32_t)));
+    EXPECT_TRUE(image_tensor->CopyDataToTensor(
+        image_data.data(), image_data.size() * sizeof(float)));
+
+    auto op = graph->CreateOperation<tim::vx::ops::AxisAlignedBBoxTransform>();
+    (*op).BindInputs({rois_tensor, deltas_tensor, batch_tensor, image_tensor})
+        .BindOutputs({output_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<float> output(golden.size());
+    EXPECT_TRUE(output_tensor->CopyDataFromTensor(output.data()));
+    EXPECT_TRUE(ArraysMatch(golden, output, 1e-3f));
+}
@@ -41,6 +41,7 @@ Batch2Space::Batch2Space(Graph* graph, const std::vector<int>& block_size,
   for (size_t i = 0; i < crop_.size(); i++) {
     this->impl()->node()->nn_param.batch2space.crop[i] = crop_[i];
   }
+  this->impl()->RegisterParamArray(block_size_);
 }
 
 std::shared_ptr<Operation> Batch2Space::Clone(
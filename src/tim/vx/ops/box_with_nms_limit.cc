@@ -0,0 +1,67 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/ops/box_with_nms_limit.h"
+
+#include "operation_private.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+BoxWithNmsLimit::BoxWithNmsLimit(Graph* graph, float score_threshold,
+                                 int32_t max_num_bbox,
+                                 int32_t nms_kernel_method,
+                                 float iou_threshold, float sigma,
+                                 float nms_score_threshold)
+    : Operation(graph, VSI_NN_OP_BOX_WITH_NMS_LIMIT, 3, 4),
+      score_threshold_(score_threshold),
+      max_num_bbox_(max_num_bbox),
+      nms_kernel_method_(nms_kernel_method),
+      iou_threshold_(iou_threshold),
+      sigma_(sigma),
+      nms_score_threshold_(nms_score_threshold) {
+  this->impl()->node()->nn_param.box_with_nms_limit.score_threshold =
+      score_threshold_;
+  this->impl()->node()->nn_param.box_with_nms_limit.max_num_bbox =
+      max_num_bbox_;
+  this->impl()->node()->nn_param.box_with_nms_limit.nms_kernel_method =
+      nms_kernel_method_;
+  this->impl()->node()->nn_param.box_with_nms_limit.iou_threshold =
+      iou_threshold_;
+  this->impl()->node()->nn_param.box_with_nms_limit.sigma = sigma_;
+  this->impl()->node()->nn_param.box_with_nms_limit.nms_score_threshold =
+      nms_score_threshold_;
+}
+
+std::shared_ptr<Operation> BoxWithNmsLimit::Clone(
+    std::shared_ptr<Graph>& graph) const {
+  return graph->CreateOperation<BoxWithNmsLimit>(
+      this->score_threshold_, this->max_num_bbox_, this->nms_kernel_method_,
+      this->iou_threshold_, this->sigma_, this->nms_score_threshold_);
+}
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,112 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/box_with_nms_limit.h"
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+TEST(BoxWithNmsLimit, shape_3_4_float_hard_nms) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::TensorSpec scores_spec(tim::vx::DataType::FLOAT32,
+        {3, 4}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec rois_spec(tim::vx::DataType::FLOAT32,
+        {12, 4}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec batch_spec(tim::vx::DataType::INT32,
+        {4}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec scores_out_spec(tim::vx::DataType::FLOAT32,
+        {4}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec rois_out_spec(tim::vx::DataType::FLOAT32,
+        {4, 4}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec classes_out_spec(tim::vx::DataType::INT32,
+        {4}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec batch_out_spec(tim::vx::DataType::INT32,
+        {4}, tim::vx::TensorAttribute::OUTPUT);
+
+    auto scores_tensor = graph->CreateTensor(scores_spec);
+    auto rois_tensor = graph->CreateTensor(rois_spec);
+    auto batch_tensor = graph->CreateTensor(batch_spec);
+    auto scores_out_tensor = graph->CreateTensor(scores_out_spec);
+    auto rois_out_tensor = graph->CreateTensor(rois_out_spec);
+    auto classes_out_tensor = graph->CreateTensor(classes_out_spec);
+    auto batch_out_tensor = graph->CreateTensor(batch_out_spec);
+
+    // Class 0 is the background and never selected
+    std::vector<float> scores_data = {
+        0.1, 0.9, 0.2,
+        0.1, 0.8, 0.7,
+        0.1, 0.5, 0.6,
+        0.1, 0.2, 0.95,
+        };
+    std::vector<float> rois_data = {
+        0, 0, 10, 10, 0, 0, 10, 10, 0, 0, 10, 10,
+        1, 1, 11, 11, 1, 1, 11, 11, 1, 1, 11, 11,
+        20, 20, 30, 30, 20, 20, 30, 30, 20, 20, 30, 30,
+        0, 0, 10, 10, 50, 50, 60, 60, 1, 1, 11, 11,
+        };
+    std::vector<int32_t> batch_data = {0, 0, 0, 0};
+    // Roi 1 overlaps roi 0 in class 1 and roi 3 in class 2 with IoU > 0.4,
+    // the outputs are sorted by class and then by score
+    std::vector<float> scores_golden = {0.9, 0.5, 0.95, 0.6};
+    std::vector<float> rois_golden = {
+        0, 0, 10, 10,
+        20, 20, 30, 30,
+        1, 1, 11, 11,
+        20, 20, 30, 30,
+        };
+    std::vector<int32_t> classes_golden = {1, 1, 2, 2};
+    std::vector<int32_t> batch_golden = {0, 0, 0, 0};
+
+    EXPECT_TRUE(scores_tensor->CopyDataToTensor(
+        scores_data.data(), scores_data.size() * sizeof(float)));
+    EXPECT_TRUE(rois_tensor->CopyDataToTensor(
+        rois_data.data(), rois_data.size() * sizeof(float)));
+    EXPECT_TRUE(batch_tensor->CopyDataToTensor(
+        batch_data.data(), batch_data.size() * sizeof(int32_t)));
+
+    auto op = graph->CreateOperation<tim::vx::ops::BoxWithNmsLimit>(
+        0.3f, -1, 0, 0.4f, 1.0f, 0.3f);
+    (*op).BindInputs({scores_tensor, rois_tensor, batch_tensor})
+        .BindOutputs({scores_out_tensor, rois_out_tensor, classes_out_tensor,
+                      batch_out_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<float> scores_out(scores_golden.size());
+    std::vector<float> rois_out(rois_golden.size());
+    std::vector<int32_t> classes_out(classes_golden.size());
+    std::vector<int32_t> batch_out(batch_golden.size());
+    EXPECT_TRUE(scores_out_tensor->CopyDataFromTensor(scores_out.data()));
+    EXPECT_TRUE(rois_out_tensor->CopyDataFromTensor(rois_out.data()));
+    EXPECT_TRUE(classes_out_tensor->CopyDataFromTensor(classes_out.data()));
+    EXPECT_TRUE(batch_out_tensor->CopyDataFromTensor(batch_out.data()));
+    EXPECT_TRUE(ArraysMatch(scores_golden, scores_out, 1e-5f));
+    EXPECT_TRUE(ArraysMatch(rois_golden, rois_out, 1e-5f));
+    EXPECT_EQ(classes_golden, classes_out);
+    EXPECT_EQ(batch_golden, batch_out);
+}
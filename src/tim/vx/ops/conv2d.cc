@@ -68,6 +68,24 @@ Conv2d::Conv2d(Graph* graph, int32_t weights, PadType padding,
       pad_(pad),
       multiplier_(multiplier),
       kernel_layout_(kernel_layout) {
+  Init();
+}
+
+Conv2d::Conv2d(Graph* graph, uint32_t operation_id, const Conv2d& conv)
+    : Operation(graph, operation_id, 0, 0, conv.impl_->layout_),
+      weights_(conv.weights_),
+      padding_(conv.padding_),
+      ksize_(conv.ksize_),
+      stride_(conv.stride_),
+      dilation_(conv.dilation_),
+      pad_(conv.pad_),
+      multiplier_(conv.multiplier_),
+      kernel_layout_(conv.kernel_layout_) {
+  this->impl()->node()->vx_param = conv.impl_->node()->vx_param;
+  Init();
+}
+
+void Conv2d::Init() {
   this->impl()->node()->nn_param.conv2d.stride[0] = stride_[0];
   this->impl()->node()->nn_param.conv2d.stride[1] = stride_[1];
   this->impl()->node()->nn_param.conv2d.pad_type = TranslatePadType(padding_);
@@ -0,0 +1,81 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/ops/detection_postprocess.h"
+
+#include "operation_private.h"
+#include "type_utils.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+DetectionPostprocess::DetectionPostprocess(
+    Graph* graph, float dy, float dx, float dh, float dw, int32_t nms_type,
+    int32_t max_num_detections, int32_t maximum_class_per_detection,
+    int32_t maximum_detection_per_class, float score_threshold,
+    float iou_threshold, bool is_bg_in_label)
+    : Operation(graph, VSI_NN_OP_DETECTION_POSTPROCESS, 3, 4),
+      dy_(dy),
+      dx_(dx),
+      dh_(dh),
+      dw_(dw),
+      nms_type_(nms_type),
+      max_num_detections_(max_num_detections),
+      maximum_class_per_detection_(maximum_class_per_detection),
+      maximum_detection_per_class_(maximum_detection_per_class),
+      score_threshold_(score_threshold),
+      iou_threshold_(iou_threshold),
+      is_bg_in_label_(is_bg_in_label) {
+  this->impl()->node()->nn_param.detection_postprocess.dy = dy_;
+  this->impl()->node()->nn_param.detection_postprocess.dx = dx_;
+  this->impl()->node()->nn_param.detection_postprocess.dh = dh_;
+  this->impl()->node()->nn_param.detection_postprocess.dw = dw_;
+  this->impl()->node()->nn_param.detection_postprocess.nms_type = nms_type_;
+  this->impl()->node()->nn_param.detection_postprocess.max_num_detections =
+      max_num_detections_;
+  this->impl()->node()->nn_param.detection_postprocess.maximum_class_per_detection =
+      maximum_class_per_detection_;
+  this->impl()->node()->nn_param.detection_postprocess.maximum_detection_per_class =
+      maximum_detection_per_class_;
+  this->impl()->node()->nn_param.detection_postprocess.score_threshold =
+      score_threshold_;
+  this->impl()->node()->nn_param.detection_postprocess.iou_threshold =
+      iou_threshold_;
+  this->impl()->node()->nn_param.detection_postprocess.is_bg_in_label =
+      ToVxBool(is_bg_in_label_);
+}
+
+std::shared_ptr<Operation> DetectionPostprocess::Clone(
+    std::shared_ptr<Graph>& graph) const {
+  return graph->CreateOperation<DetectionPostprocess>(
+      this->dy_, this->dx_, this->dh_, this->dw_, this->nms_type_,
+      this->max_num_detections_, this->maximum_class_per_detection_,
+      this->maximum_detection_per_class_, this->score_threshold_,
+      this->iou_threshold_, this->is_bg_in_label_);
+}
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,120 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/detection_postprocess.h"
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+TEST(DetectionPostprocess, shape_3_6_1_float_fast_nms) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::TensorSpec scores_spec(tim::vx::DataType::FLOAT32,
+        {3, 6, 1}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec deltas_spec(tim::vx::DataType::FLOAT32,
+        {4, 6, 1}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec anchors_spec(tim::vx::DataType::FLOAT32,
+        {4, 6}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec scores_out_spec(tim::vx::DataType::FLOAT32,
+        {3, 1}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec boxes_out_spec(tim::vx::DataType::FLOAT32,
+        {4, 3, 1}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec classes_out_spec(tim::vx::DataType::INT32,
+        {3, 1}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec num_out_spec(tim::vx::DataType::INT32,
+        {1}, tim::vx::TensorAttribute::OUTPUT);
+
+    auto scores_tensor = graph->CreateTensor(scores_spec);
+    auto deltas_tensor = graph->CreateTensor(deltas_spec);
+    auto anchors_tensor = graph->CreateTensor(anchors_spec);
+    auto scores_out_tensor = graph->CreateTensor(scores_out_spec);
+    auto boxes_out_tensor = graph->CreateTensor(boxes_out_spec);
+    auto classes_out_tensor = graph->CreateTensor(classes_out_spec);
+    auto num_out_tensor = graph->CreateTensor(num_out_spec);
+
+    std::vector<float> scores_data = {
+        0, 0.9, 0.8,
+        0, 0.75, 0.72,
+        0, 0.6, 0.5,
+        0, 0.93, 0.95,
+        0, 0.5, 0.4,
+        0, 0.3, 0.2,
+        };
+    std::vector<float> deltas_data = {
+        0, 0, 0, 0,
+        0, 1, 0, 0,
+        0, -1, 0, 0,
+        0, 0, 0, 0,
+        0, 1, 0, 0,
+        0, 0, 0, 0,
+        };
+    std::vector<float> anchors_data = {
+        0.5, 0.5, 1, 1,
+        0.5, 0.5, 1, 1,
+        0.5, 0.5, 1, 1,
+        0.5, 10.5, 1, 1,
+        0.5, 10.5, 1, 1,
+        0.5, 100.5, 1, 1,
+        };
+    // Anchors 1, 2 and 4 are shifted onto a better scoring box and suppressed
+    std::vector<float> scores_golden = {0.95, 0.9, 0.3};
+    std::vector<float> boxes_golden = {
+        0, 10, 1, 11,
+        0, 0, 1, 1,
+        0, 100, 1, 101,
+        };
+    std::vector<int32_t> classes_golden = {1, 0, 0};
+    std::vector<int32_t> num_golden = {3};
+
+    EXPECT_TRUE(scores_tensor->CopyDataToTensor(
+        scores_data.data(), scores_data.size() * sizeof(float)));
+    EXPECT_TRUE(deltas_tensor->CopyDataToTensor(
+        deltas_data.data(), deltas_data.size() * sizeof(float)));
+    EXPECT_TRUE(anchors_tensor->CopyDataToTensor(
+        anchors_data.data(), anchors_data.size() * sizeof(float)));
+
+    auto op = graph->CreateOperation<tim::vx::ops::DetectionPostprocess>(
+        10.0f, 10.0f, 5.0f, 5.0f, 0, 3, 1, 1, 0.0f, 0.5f, false);
+    (*op).BindInputs({scores_tensor, deltas_tensor, anchors_tensor})
+        .BindOutputs({scores_out_tensor, boxes_out_tensor, classes_out_tensor,
+                      num_out_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<float> scores_out(scores_golden.size());
+    std::vector<float> boxes_out(boxes_golden.size());
+    std::vector<int32_t> classes_out(classes_golden.size());
+    std::vector<int32_t> num_out(num_golden.size());
+    EXPECT_TRUE(scores_out_tensor->CopyDataFromTensor(scores_out.data()));
+    EXPECT_TRUE(boxes_out_tensor->CopyDataFromTensor(boxes_out.data()));
+    EXPECT_TRUE(classes_out_tensor->CopyDataFromTensor(classes_out.data()));
+    EXPECT_TRUE(num_out_tensor->CopyDataFromTensor(num_out.data()));
+    EXPECT_TRUE(ArraysMatch(scores_golden, scores_out, 1e-5f));
+    EXPECT_TRUE(ArraysMatch(boxes_golden, boxes_out, 1e-5f));
+    EXPECT_EQ(classes_golden, classes_out);
+    EXPECT_EQ(num_golden, num_out);
+}
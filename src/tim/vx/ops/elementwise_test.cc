@@ -131,6 +131,40 @@ TEST(FloorDiv, shape_5_1_broadcast_uint8) {
     EXPECT_EQ(golden, output);
 }
 
+TEST(FloorDiv, shape_6_uint8_zero_point) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({6});
+    tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 0.25, 128);
+    tim::vx::Quantization quant_out(tim::vx::QuantType::ASYMMETRIC, 1, 128);
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8,
+                            io_shape, tim::vx::TensorAttribute::INPUT, quant);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8,
+                            io_shape, tim::vx::TensorAttribute::OUTPUT, quant_out);
+
+    auto input_tensor_x = graph->CreateTensor(input_spec);
+    auto input_tensor_y = graph->CreateTensor(input_spec);
+    auto output_tensor = graph->CreateTensor(output_spec);
+
+    // x = { 7, -7, 7, -7, 6, 0 } / 4, y = { 2, 2, -2, -2, 3, 5 } / 4
+    std::vector<uint8_t> in_data_x = { 135, 121, 135, 121, 134, 128 };
+    std::vector<uint8_t> in_data_y = { 130, 130, 126, 126, 131, 133 };
+    std::vector<uint8_t> golden = { 131, 124, 124, 131, 130, 128 };
+
+    EXPECT_TRUE(input_tensor_x->CopyDataToTensor(in_data_x.data(), in_data_x.size()));
+    EXPECT_TRUE(input_tensor_y->CopyDataToTensor(in_data_y.data(), in_data_y.size()));
+    auto op = graph->CreateOperation<tim::vx::ops::FloorDiv>();
+    (*op).BindInputs({input_tensor_x, input_tensor_y}).BindOutputs({output_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+    std::vector<uint8_t> output(6);
+
+    EXPECT_TRUE(output_tensor->CopyDataFromTensor(output.data()));
+    EXPECT_EQ(golden, output);
+}
+
 TEST(Div, shape_1_fp32) {
     auto ctx = tim::vx::Context::Create();
     auto graph = ctx->CreateGraph();
@@ -40,6 +40,14 @@ FullyConnected::FullyConnected(Graph* graph, uint32_t axis, uint32_t weights)
   this->impl()->node()->nn_param.fcl.weights = weights;
 }
 
+FullyConnected::FullyConnected(Graph* graph, uint32_t operation_id,
+                               const FullyConnected& fc)
+    : Operation(graph, operation_id), axis_(fc.axis_), weights_(fc.weights_) {
+  this->impl()->node()->vx_param = fc.impl_->node()->vx_param;
+  this->impl()->node()->nn_param.fcl.axis = axis_;
+  this->impl()->node()->nn_param.fcl.weights = weights_;
+}
+
 std::shared_ptr<Operation> FullyConnected::Clone(
     std::shared_ptr<Graph>& graph) const {
   return graph->CreateOperation<FullyConnected>(this->axis_, this->weights_);
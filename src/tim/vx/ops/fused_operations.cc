@@ -0,0 +1,86 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/ops/fused_operations.h"
+
+#include <functional>
+
+#include "operation_private.h"
+#include "type_utils.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+Conv2dRelu::Conv2dRelu(Graph* graph, const Conv2d& conv)
+    : Conv2d(graph, VSI_NN_OP_CONV_RELU, conv) {
+  this->impl()->node()->vx_param.has_relu = TRUE;
+}
+
+std::shared_ptr<Operation> Conv2dRelu::Clone(
+    std::shared_ptr<Graph>& graph) const {
+  return graph->CreateOperation<Conv2dRelu>(std::cref(*this));
+}
+
+Conv2dReluPool2d::Conv2dReluPool2d(Graph* graph, const Conv2d& conv,
+                                   PoolType type,
+                                   const std::array<uint32_t, 2>& ksize,
+                                   const std::array<uint32_t, 2>& stride,
+                                   RoundType round_type)
+    : Conv2d(graph, VSI_NN_OP_CONV_RELU_POOL, conv),
+      pool_type_(type),
+      pool_ksize_(ksize),
+      pool_stride_(stride),
+      round_type_(round_type) {
+  this->impl()->node()->vx_param.has_relu = TRUE;
+  this->impl()->node()->nn_param.pool.type = TranslatePoolType(pool_type_);
+  this->impl()->node()->nn_param.pool.round_type =
+      TranslateRoundType(round_type_);
+  this->impl()->node()->nn_param.pool.ksize[0] = pool_ksize_[0];
+  this->impl()->node()->nn_param.pool.ksize[1] = pool_ksize_[1];
+  this->impl()->node()->nn_param.pool.stride[0] = pool_stride_[0];
+  this->impl()->node()->nn_param.pool.stride[1] = pool_stride_[1];
+  this->impl()->node()->nn_param.pool.pad_type = VSI_NN_PAD_VALID;
+}
+
+std::shared_ptr<Operation> Conv2dReluPool2d::Clone(
+    std::shared_ptr<Graph>& graph) const {
+  return graph->CreateOperation<Conv2dReluPool2d>(
+      std::cref(*this), this->pool_type_, this->pool_ksize_,
+      this->pool_stride_, this->round_type_);
+}
+
+FullyConnectedRelu::FullyConnectedRelu(Graph* graph, const FullyConnected& fc)
+    : FullyConnected(graph, VSI_NN_OP_FCL_RELU, fc) {
+  this->impl()->node()->vx_param.has_relu = TRUE;
+}
+
+std::shared_ptr<Operation> FullyConnectedRelu::Clone(
+    std::shared_ptr<Graph>& graph) const {
+  return graph->CreateOperation<FullyConnectedRelu>(std::cref(*this));
+}
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
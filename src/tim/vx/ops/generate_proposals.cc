@@ -0,0 +1,68 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/ops/generate_proposals.h"
+
+#include "operation_private.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+GenerateProposals::GenerateProposals(Graph* graph, float height_stride,
+                                     float width_stride, int32_t pre_nms_top_n,
+                                     int32_t post_nms_top_n,
+                                     float iou_threshold, float min_size,
+                                     DataLayout layout)
+    : Operation(graph, VSI_NN_OP_GENERATE_PROPOSALS, 4, 3, layout),
+      height_stride_(height_stride),
+      width_stride_(width_stride),
+      pre_nms_top_n_(pre_nms_top_n),
+      post_nms_top_n_(post_nms_top_n),
+      iou_threshold_(iou_threshold),
+      min_size_(min_size) {
+  this->impl()->node()->nn_param.generate_proposals.height_stride =
+      height_stride_;
+  this->impl()->node()->nn_param.generate_proposals.width_stride =
+      width_stride_;
+  this->impl()->node()->nn_param.generate_proposals.pre_nms_top_n =
+      pre_nms_top_n_;
+  this->impl()->node()->nn_param.generate_proposals.post_nms_top_n =
+      post_nms_top_n_;
+  this->impl()->node()->nn_param.generate_proposals.iou_threshold =
+      iou_threshold_;
+  this->impl()->node()->nn_param.generate_proposals.min_size = min_size_;
+}
+
+std::shared_ptr<Operation> GenerateProposals::Clone(
+    std::shared_ptr<Graph>& graph) const {
+  return graph->CreateOperation<GenerateProposals>(
+      this->height_stride_, this->width_stride_, this->pre_nms_top_n_,
+      this->post_nms_top_n_, this->iou_threshold_, this->min_size_,
+      this->impl_->layout_);
+}
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,106 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/generate_proposals.h"
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+TEST(GenerateProposals, shape_2_1_2_1_float_post_nms_3) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    const uint32_t post_nms_top_n = 3;
+    tim::vx::TensorSpec scores_spec(tim::vx::DataType::FLOAT32,
+        {2, 1, 2, 1}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec deltas_spec(tim::vx::DataType::FLOAT32,
+        {2, 1, 8, 1}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec anchors_spec(tim::vx::DataType::FLOAT32,
+        {4, 2}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec image_info_spec(tim::vx::DataType::FLOAT32,
+        {2, 1}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec out_scores_spec(tim::vx::DataType::FLOAT32,
+        {post_nms_top_n}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec out_rois_spec(tim::vx::DataType::FLOAT32,
+        {4, post_nms_top_n}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec out_batch_spec(tim::vx::DataType::INT32,
+        {post_nms_top_n}, tim::vx::TensorAttribute::OUTPUT);
+
+    auto scores_tensor = graph->CreateTensor(scores_spec);
+    auto deltas_tensor = graph->CreateTensor(deltas_spec);
+    auto anchors_tensor = graph->CreateTensor(anchors_spec);
+    auto image_info_tensor = graph->CreateTensor(image_info_spec);
+    auto out_scores_tensor = graph->CreateTensor(out_scores_spec);
+    auto out_rois_tensor = graph->CreateTensor(out_rois_spec);
+    auto out_batch_tensor = graph->CreateTensor(out_batch_spec);
+
+    // Anchor 1 overlaps anchor 0 at each position, the weaker box is dropped
+    std::vector<float> scores_data = {
+        0.9, 0.8,
+        0.95, 0.1,
+        };
+    std::vector<float> deltas_data(16, 0);
+    deltas_data[1] = 0.25;  // dx of anchor 0 at w = 1
+    std::vector<float> anchors_data = {
+        0, 0, 4, 4,
+        0, 0, 4, 3,
+        };
+    std::vector<float> image_info_data = {8, 8};
+    std::vector<float> scores_golden = {0.95, 0.8, 0};
+    std::vector<float> rois_golden = {
+        0, 0, 4, 3,
+        5, 0, 8, 4,
+        0, 0, 0, 0,
+        };
+    std::vector<int32_t> batch_golden = {0, 0, 0};
+
+    EXPECT_TRUE(scores_tensor->CopyDataToTensor(
+        scores_data.data(), scores_data.size() * sizeof(float)));
+    EXPECT_TRUE(deltas_tensor->CopyDataToTensor(
+        deltas_data.data(), deltas_data.size() * sizeof(float)));
+    EXPECT_TRUE(anchors_tensor->CopyDataToTensor(
+        anchors_data.data(), anchors_data.size() * sizeof(float)));
+    EXPECT_TRUE(image_info_tensor->CopyDataToTensor(
+        image_info_data.data(), image_info_data.size() * sizeof(float)));
+
+    auto op = graph->CreateOperation<tim::vx::ops::GenerateProposals>(
+        4.0f, 4.0f, -1, post_nms_top_n, 0.5f, 1.0f);
+    (*op).BindInputs({scores_tensor, deltas_tensor, anchors_tensor,
+                      image_info_tensor})
+        .BindOutputs({out_scores_tensor, out_rois_tensor, out_batch_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<float> out_scores(scores_golden.size());
+    std::vector<float> out_rois(rois_golden.size());
+    std::vector<int32_t> out_batch(batch_golden.size());
+    EXPECT_TRUE(out_scores_tensor->CopyDataFromTensor(out_scores.data()));
+    EXPECT_TRUE(out_rois_tensor->CopyDataFromTensor(out_rois.data()));
+    EXPECT_TRUE(out_batch_tensor->CopyDataFromTensor(out_batch.data()));
+    EXPECT_TRUE(ArraysMatch(scores_golden, out_scores, 1e-5f));
+    EXPECT_TRUE(ArraysMatch(rois_golden, out_rois, 1e-5f));
+    EXPECT_EQ(batch_golden, out_batch);
+}
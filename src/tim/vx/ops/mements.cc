@@ -35,6 +35,7 @@ Moments::Moments(Graph* graph, const std::vector<int32_t>& axes, bool keep_dims)
   this->impl()->node()->nn_param.moments.axis = axes_.data();
   this->impl()->node()->nn_param.moments.axis_num = axes_.size();
   this->impl()->node()->nn_param.moments.keep_dim = ToVxBool(keep_dims_);
+  this->impl()->RegisterParamArray(axes_);
 }
 
 std::shared_ptr<Operation> Moments::Clone(std::shared_ptr<Graph>& graph) const {
@@ -0,0 +1,56 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/ops/nms.h"
+
+#include "operation_private.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+NonMaxSuppression::NonMaxSuppression(Graph* graph, int32_t max_output_size,
+                                     float iou_threshold, float score_threshold,
+                                     float soft_nms_sigma)
+    : Operation(graph, VSI_NN_OP_NMS, 2, 3),
+      max_output_size_(max_output_size),
+      iou_threshold_(iou_threshold),
+      score_threshold_(score_threshold),
+      soft_nms_sigma_(soft_nms_sigma) {
+  this->impl()->node()->nn_param.nms.max_output_size = max_output_size_;
+  this->impl()->node()->nn_param.nms.iou_threshold = iou_threshold_;
+  this->impl()->node()->nn_param.nms.score_threshold = score_threshold_;
+  this->impl()->node()->nn_param.nms.soft_nms_sigma = soft_nms_sigma_;
+}
+
+std::shared_ptr<Operation> NonMaxSuppression::Clone(
+    std::shared_ptr<Graph>& graph) const {
+  return graph->CreateOperation<NonMaxSuppression>(
+      this->max_output_size_, this->iou_threshold_, this->score_threshold_,
+      this->soft_nms_sigma_);
+}
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
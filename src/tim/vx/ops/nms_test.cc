@@ -0,0 +1,89 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/nms.h"
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+TEST(NonMaxSuppression, shape_4_6_float_max_3) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    const uint32_t max_output_size = 3;
+    tim::vx::TensorSpec boxes_spec(tim::vx::DataType::FLOAT32,
+        {4, 6}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec scores_spec(tim::vx::DataType::FLOAT32,
+        {6}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec indices_spec(tim::vx::DataType::INT32,
+        {max_output_size}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec selected_scores_spec(tim::vx::DataType::FLOAT32,
+        {max_output_size}, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec valid_spec(tim::vx::DataType::INT32,
+        {1}, tim::vx::TensorAttribute::OUTPUT);
+
+    auto boxes_tensor = graph->CreateTensor(boxes_spec);
+    auto scores_tensor = graph->CreateTensor(scores_spec);
+    auto indices_tensor = graph->CreateTensor(indices_spec);
+    auto selected_scores_tensor = graph->CreateTensor(selected_scores_spec);
+    auto valid_tensor = graph->CreateTensor(valid_spec);
+
+    std::vector<float> boxes_data = {
+        0, 0, 1, 1,
+        0, 0.1, 1, 1.1,
+        0, -0.1, 1, 0.9,
+        0, 10, 1, 11,
+        0, 10.1, 1, 11.1,
+        0, 100, 1, 101,
+        };
+    std::vector<float> scores_data = {0.9, 0.75, 0.6, 0.95, 0.5, 0.3};
+    std::vector<int32_t> indices_golden = {3, 0, 5};
+    std::vector<float> selected_scores_golden = {0.95, 0.9, 0.3};
+    std::vector<int32_t> valid_golden = {3};
+
+    EXPECT_TRUE(boxes_tensor->CopyDataToTensor(
+        boxes_data.data(), boxes_data.size() * sizeof(float)));
+    EXPECT_TRUE(scores_tensor->CopyDataToTensor(
+        scores_data.data(), scores_data.size() * sizeof(float)));
+
+    auto op = graph->CreateOperation<tim::vx::ops::NonMaxSuppression>(
+        max_output_size, 0.5f, 0.0f);
+    (*op).BindInputs({boxes_tensor, scores_tensor})
+        .BindOutputs({indices_tensor, selected_scores_tensor, valid_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<int32_t> indices(indices_golden.size());
+    std::vector<float> selected_scores(selected_scores_golden.size());
+    std::vector<int32_t> valid(valid_golden.size());
+    EXPECT_TRUE(indices_tensor->CopyDataFromTensor(indices.data()));
+    EXPECT_TRUE(selected_scores_tensor->CopyDataFromTensor(
+        selected_scores.data()));
+    EXPECT_TRUE(valid_tensor->CopyDataFromTensor(valid.data()));
+    EXPECT_EQ(indices_golden, indices);
+    EXPECT_TRUE(ArraysMatch(selected_scores_golden, selected_scores, 1e-5f));
+    EXPECT_EQ(valid_golden, valid);
+}
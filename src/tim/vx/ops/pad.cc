@@ -40,6 +40,8 @@ Pad::Pad(Graph* graph, const std::vector<uint32_t>& front_size,
   this->impl()->node()->nn_param.pad.dim_num = front_size_.size();
   this->impl()->node()->nn_param.pad.const_val = const_val_;
   this->impl()->node()->nn_param.pad.mode = VSI_NN_PAD_MODE_CONSTANT;
+  this->impl()->RegisterParamArray(front_size_);
+  this->impl()->RegisterParamArray(back_size_);
 }
 
 std::shared_ptr<Operation> Pad::Clone(std::shared_ptr<Graph>& graph) const {
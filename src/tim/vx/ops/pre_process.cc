@@ -0,0 +1,118 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/ops/pre_process.h"
+
+#include "operation_private.h"
+#include "type_utils.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+namespace {
+// ovxlib computes WHCN and permutes it when perm is not the identity
+std::vector<uint32_t> OutputPerm(DataLayout layout) {
+  if (layout == DataLayout::CWHN) {
+    return {2, 0, 1, 3};
+  }
+  return {0, 1, 2, 3};
+}
+
+// Output size once ovxlib setup rewrote a CWHN size to WHCN in place
+std::vector<uint32_t> SetupOutputSize(DataLayout layout,
+                                      const std::vector<uint32_t>& shape) {
+  std::vector<uint32_t> size(shape);
+  if (layout == DataLayout::CWHN && size.size() >= 3) {
+    size[0] = shape[1];
+    size[1] = shape[2];
+    size[2] = shape[0];
+  }
+  return size;
+}
+}  // namespace
+
+PreProcess::PreProcess(Graph* graph, const PreProcessConfig& config,
+                       const std::vector<uint32_t>& output_shape)
+    : Operation(graph, VSI_NN_OP_PRE_PROCESS, InputShapes(config).size(), 1,
+                config.layout),
+      config_(config),
+      output_shape_(output_shape),
+      output_size_(output_shape),
+      setup_output_size_(SetupOutputSize(config.layout, output_shape)),
+      perm_(OutputPerm(config.layout)) {
+  auto& param = this->impl()->node()->nn_param.pre_process;
+  param.type = static_cast<vsi_nn_pre_process_type_e>(
+      TranslateImageFormat(config.format));
+  param.rect.left = config.crop_left;
+  param.rect.top = config.crop_top;
+  param.rect.width = config.crop_width ? config.crop_width
+                                       : config.width - config.crop_left;
+  param.rect.height = config.crop_height ? config.crop_height
+                                         : config.height - config.crop_top;
+  param.output_attr.size = output_size_.data();
+  param.output_attr.dim_num = output_size_.size();
+  param.perm = perm_.data();
+  param.dim_num = perm_.size();
+  for (int i = 0; i < 3; i++) {
+    param.norm.mean[i] = config.mean[i];
+  }
+  param.norm.scale = config.scale;
+  param.reverse_channel = ToVxBool(config.reverse_channel);
+  this->impl()->RegisterParamArray(output_size_, setup_output_size_);
+  this->impl()->RegisterParamArray(perm_);
+}
+
+std::shared_ptr<Operation> PreProcess::Clone(
+    std::shared_ptr<Graph>& graph) const {
+  return graph->CreateOperation<PreProcess>(this->config_,
+                                            this->output_shape_);
+}
+
+std::vector<ShapeType> PreProcess::InputShapes(
+    const PreProcessConfig& config) {
+  uint32_t w = config.width;
+  uint32_t h = config.height;
+  switch (config.format) {
+    case ImageFormat::GRAY:
+      return {{w, h, 1, 1}};
+    case ImageFormat::RGB:
+      return {{w * 3, h, 1, 1}};
+    case ImageFormat::RGB888_PLANAR:
+      return {{w, h, 3, 1}};
+    case ImageFormat::BGRA:
+      return {{w * 4, h, 1, 1}};
+    case ImageFormat::YUV420:
+      return {{w, h, 1, 1}, {w / 2, h / 2, 1, 1}, {w / 2, h / 2, 1, 1}};
+    case ImageFormat::YUV444:
+      return {{w, h, 1, 1}, {w, h, 1, 1}, {w, h, 1, 1}};
+    case ImageFormat::NV12:
+      return {{w, h, 1, 1}, {w, h / 2, 1, 1}};
+  }
+  return {};
+}
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
@@ -40,6 +40,7 @@ namespace ops {
     this->impl()->node()->nn_param.reduce.axis = axis_.data();               \
     this->impl()->node()->nn_param.reduce.axis_num = axis_.size();           \
     this->impl()->node()->nn_param.reduce.keep_dim = keep_dims_;             \
+    this->impl()->RegisterParamArray(axis_);                                 \
   }                                                                          \
   std::shared_ptr<Operation> Reduce##NAME::Clone(                            \
       std::shared_ptr<Graph>& graph) const {                                 \
@@ -34,6 +34,7 @@ Reshape::Reshape(Graph* graph, const std::vector<uint32_t>& size)
     : Operation(graph, VSI_NN_OP_RESHAPE), size_(std::move(size)) {
   this->impl()->node()->nn_param.reshape.size = size_.data();
   this->impl()->node()->nn_param.reshape.dim_num = size_.size();
+  this->impl()->RegisterParamArray(size_);
 }
 
 std::shared_ptr<Operation> Reshape::Clone(
@@ -34,6 +34,7 @@ Reverse::Reverse(Graph* graph, const std::vector<int32_t>& axis)
     : Operation(graph, VSI_NN_OP_REVERSE), axis_(axis) {
   this->impl()->node()->nn_param.reverse.axis = axis_.data();
   this->impl()->node()->nn_param.reverse.axis_num = axis_.size();
+  this->impl()->RegisterParamArray(axis_);
 }
 
 std::shared_ptr<Operation> Reverse::Clone(std::shared_ptr<Graph>& graph) const {
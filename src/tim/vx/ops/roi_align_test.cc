@@ -0,0 +1,87 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/roi_align.h"
+
+#include "gtest/gtest.h"
+#include "test_utils.h"
+
+TEST(RoiAlign, shape_4_4_1_1_float_4_rois) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32,
+        {4, 4, 1, 1}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec rois_spec(tim::vx::DataType::FLOAT32,
+        {4, 4}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec batch_spec(tim::vx::DataType::INT32,
+        {4}, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32,
+        {2, 2, 1, 4}, tim::vx::TensorAttribute::OUTPUT);
+
+    auto input_tensor = graph->CreateTensor(input_spec);
+    auto rois_tensor = graph->CreateTensor(rois_spec);
+    auto batch_tensor = graph->CreateTensor(batch_spec);
+    auto output_tensor = graph->CreateTensor(output_spec);
+
+    std::vector<float> in_data = {
+        -10, -1, 4, -5,
+        -8, -2, 9, 1,
+        7, -2, 3, -7,
+        -2, 10, -3, 5,
+        };
+    std::vector<float> rois_data = {
+        2, 2, 4, 4,
+        0, 0, 8, 8,
+        2, 0, 4, 8,
+        0, 2, 8, 4,
+        };
+    std::vector<int32_t> batch_data = {0, 0, 0, 0};
+    std::vector<float> golden = {
+        0.375, 5.125, -0.375, 2.875,
+        -0.5, -0.3125, 3.1875, 1.125,
+        0.25, 4.25, 4.875, 0.625,
+        -0.1875, 1.125, 0.9375, -2.625,
+        };
+
+    EXPECT_TRUE(input_tensor->CopyDataToTensor(
+        in_data.data(), in_data.size() * sizeof(float)));
+    EXPECT_TRUE(rois_tensor->CopyDataToTensor(
+        rois_data.data(), rois_data.size() * sizeof(float)));
+    EXPECT_TRUE(batch_tensor->CopyDataToTensor(
+        batch_data.data(), batch_data.size() * sizeof(int32_t)));
+
+    auto op = graph->CreateOperation<tim::vx::ops::RoiAlign>(
+        2, 2, 2.0f, 2.0f, 4, 4);
+    (*op).BindInputs({input_tensor, rois_tensor, batch_tensor})
+        .BindOutputs({output_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<float> output(golden.size());
+    EXPECT_TRUE(output_tensor->CopyDataFromTensor(output.data()));
+    EXPECT_TRUE(ArraysMatch(golden, output, 1e-5f));
+}
@@ -34,6 +34,7 @@ ScatterND::ScatterND(Graph* graph, const std::vector<uint32_t>& shape)
     : Operation(graph, VSI_NN_OP_SCATTER_ND), shape_(shape) {
   this->impl()->node()->nn_param.scatter_nd.dim_num = shape_.size();
   this->impl()->node()->nn_param.scatter_nd.shape = shape_.data();
+  this->impl()->RegisterParamArray(shape_);
 }
 
 std::shared_ptr<Operation> ScatterND::Clone(std::shared_ptr<Graph>& graph) const {
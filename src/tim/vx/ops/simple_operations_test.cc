@@ -83,3 +83,34 @@ TEST(Cast, shape_5_1_fp32_to_int32) {
     EXPECT_EQ(golden, output);
 }
 
+
+TEST(DataConvert, shape_4_1_fp32_to_int16_dfp) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({4, 1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32,
+                            io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::Quantization output_quant(
+        tim::vx::QuantType::DYNAMIC_FIXED_POINT, 8);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::INT16,
+                            io_shape, tim::vx::TensorAttribute::OUTPUT,
+                            output_quant);
+
+    auto input_tensor = graph->CreateTensor(input_spec);
+    auto output_tensor = graph->CreateTensor(output_spec);
+
+    std::vector<float> in_data = { -1.5, 0.25, 3, 100 };
+    std::vector<int16_t> golden = {-384, 64, 768, 25600};
+
+    EXPECT_TRUE(input_tensor->CopyDataToTensor(in_data.data(), in_data.size()*4));
+
+    auto convert = graph->CreateOperation<tim::vx::ops::DataConvert>();
+    (*convert).BindInputs({input_tensor}).BindOutputs({output_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+    std::vector<int16_t> output(4, 0);
+    EXPECT_TRUE(output_tensor->CopyDataFromTensor(output.data()));
+    EXPECT_EQ(golden, output);
+}
@@ -41,6 +41,8 @@ Slice::Slice(Graph* graph, uint32_t dims, const std::vector<int32_t>& start,
       reinterpret_cast<const uint32_t*>(start_.data());
   this->impl()->node()->nn_param.slice.length =
       reinterpret_cast<const uint32_t*>(length_.data());
+  this->impl()->RegisterParamArray(start_);
+  this->impl()->RegisterParamArray(length_);
 }
 
 std::shared_ptr<Operation> Slice::Clone(std::shared_ptr<Graph>& graph) const {
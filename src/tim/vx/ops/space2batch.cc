@@ -41,6 +41,7 @@ Space2Batch::Space2Batch(Graph* graph, const std::vector<int>& block_size,
   for (size_t i = 0; i < pad_.size(); i++) {
     this->impl()->node()->nn_param.space2batch.pad[i] = pad_[i];
   }
+  this->impl()->RegisterParamArray(block_size_);
 }
 
 std::shared_ptr<Operation> Space2Batch::Clone(
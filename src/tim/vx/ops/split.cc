@@ -37,6 +37,7 @@ Split::Split(Graph* graph, uint32_t axis, std::vector<uint32_t> slices)
   this->impl()->node()->nn_param.split.axis = axis_;
   this->impl()->node()->nn_param.split.slices = slices_.data();
   this->impl()->node()->nn_param.split.slices_num = slices_.size();
+  this->impl()->RegisterParamArray(slices_);
 }
 
 std::shared_ptr<Operation> Split::Clone(std::shared_ptr<Graph>& graph) const {
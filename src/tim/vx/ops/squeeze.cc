@@ -34,6 +34,7 @@ Squeeze::Squeeze(Graph* graph, std::vector<uint32_t> axis)
     : Operation(graph, VSI_NN_OP_SQUEEZE), axis_(axis) {
   this->impl()->node()->nn_param.squeeze.axis = axis_.data();
   this->impl()->node()->nn_param.squeeze.axis_num = axis_.size();
+  this->impl()->RegisterParamArray(axis_);
 }
 
 std::shared_ptr<Operation> Squeeze::Clone(std::shared_ptr<Graph>& graph) const {
@@ -55,6 +55,9 @@ StridedSlice::StridedSlice(Graph* graph, const std::vector<int32_t> begin_dims,
       stride_dims_.data();
   this->impl()->node()->nn_param.strided_slice.stride_dims_num =
       stride_dims_.size();
+  this->impl()->RegisterParamArray(begin_dims_);
+  this->impl()->RegisterParamArray(end_dims_);
+  this->impl()->RegisterParamArray(stride_dims_);
 }
 
 std::shared_ptr<Operation> StridedSlice::Clone(
@@ -34,6 +34,7 @@ Tile::Tile(Graph* graph, const std::vector<int32_t>& multiples)
     : Operation(graph, VSI_NN_OP_TILE, 1, 1), multiples_(multiples) {
   this->impl()->node()->nn_param.tile.multiples = multiples_.data();
   this->impl()->node()->nn_param.tile.multiples_num = multiples_.size();
+  this->impl()->RegisterParamArray(multiples_);
 }
 
 std::shared_ptr<Operation> Tile::Clone(std::shared_ptr<Graph>& graph) const {
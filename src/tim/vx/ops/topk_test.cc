@@ -0,0 +1,131 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/topk.h"
+
+#include <cfloat>
+
+#include "gtest/gtest.h"
+
+TEST(TopK, shape_4_2_2_float_k_2) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType input_shape({4, 2, 2});
+    tim::vx::ShapeType output_shape({2, 2, 2});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32,
+        input_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec values_spec(tim::vx::DataType::FLOAT32,
+        output_shape, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec indices_spec(tim::vx::DataType::INT32,
+        output_shape, tim::vx::TensorAttribute::OUTPUT);
+
+    auto input_tensor = graph->CreateTensor(input_spec);
+    auto values_tensor = graph->CreateTensor(values_spec);
+    auto indices_tensor = graph->CreateTensor(indices_spec);
+
+    std::vector<float> in_data = {
+        1, 4, 3, 2,
+        8, 5, 6, 7,
+        0, -1, -3, -2,
+        9, 9.5, 1, 0,
+        };
+    std::vector<float> values_golden = {
+        4, 3,
+        8, 7,
+        0, -1,
+        9.5, 9,
+        };
+    std::vector<int32_t> indices_golden = {
+        1, 2,
+        0, 3,
+        0, 1,
+        1, 0,
+        };
+
+    EXPECT_TRUE(input_tensor->CopyDataToTensor(
+        in_data.data(), in_data.size() * sizeof(float)));
+
+    auto op = graph->CreateOperation<tim::vx::ops::TopK>(2);
+    (*op).BindInputs({input_tensor}).BindOutputs({values_tensor, indices_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<float> values(values_golden.size());
+    std::vector<int32_t> indices(indices_golden.size());
+    EXPECT_TRUE(values_tensor->CopyDataFromTensor(values.data()));
+    EXPECT_TRUE(indices_tensor->CopyDataFromTensor(indices.data()));
+    EXPECT_EQ(values_golden, values);
+    EXPECT_EQ(indices_golden, indices);
+}
+
+TEST(TopK, shape_3_2_float_k_4) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType input_shape({3, 2});
+    tim::vx::ShapeType output_shape({4, 2});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32,
+        input_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec values_spec(tim::vx::DataType::FLOAT32,
+        output_shape, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec indices_spec(tim::vx::DataType::INT32,
+        output_shape, tim::vx::TensorAttribute::OUTPUT);
+
+    auto input_tensor = graph->CreateTensor(input_spec);
+    auto values_tensor = graph->CreateTensor(values_spec);
+    auto indices_tensor = graph->CreateTensor(indices_spec);
+
+    std::vector<float> in_data = {
+        1, 3, 2,
+        -5, -4, -6,
+        };
+    // k is larger than a row, the tail of each output row is padding
+    std::vector<float> values_golden = {
+        3, 2, 1, -FLT_MAX,
+        -4, -5, -6, -FLT_MAX,
+        };
+    std::vector<int32_t> indices_golden = {
+        1, 2, 0, 0,
+        1, 0, 2, 0,
+        };
+
+    EXPECT_TRUE(input_tensor->CopyDataToTensor(
+        in_data.data(), in_data.size() * sizeof(float)));
+
+    auto op = graph->CreateOperation<tim::vx::ops::TopK>(4);
+    (*op).BindInputs({input_tensor}).BindOutputs({values_tensor, indices_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<float> values(values_golden.size());
+    std::vector<int32_t> indices(indices_golden.size());
+    EXPECT_TRUE(values_tensor->CopyDataFromTensor(values.data()));
+    EXPECT_TRUE(indices_tensor->CopyDataFromTensor(indices.data()));
+    EXPECT_EQ(values_golden, values);
+    EXPECT_EQ(indices_golden, indices);
+}
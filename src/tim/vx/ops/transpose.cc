@@ -34,6 +34,7 @@ Transpose::Transpose(Graph* graph, const std::vector<uint32_t>& perm)
     : Operation(graph, VSI_NN_OP_PERMUTE), perm_(std::move(perm)) {
   this->impl()->node()->nn_param.permute.perm = perm_.data();
   this->impl()->node()->nn_param.permute.dim_num = perm_.size();
+  this->impl()->RegisterParamArray(perm_);
 }
 
 std::shared_ptr<Operation> Transpose::Clone(std::shared_ptr<Graph>& graph) const {
@@ -0,0 +1,107 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/profile.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+
+namespace {
+void AppendJsonString(std::string& out, const std::string& str) {
+  out += '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  out += '"';
+}
+
+/// Trace Event Format timestamps are in microseconds
+std::string Microseconds(uint64_t ns) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%" PRIu64 ".%03" PRIu64, ns / 1000, ns % 1000);
+  return buf;
+}
+}  // namespace
+
+namespace tim {
+namespace vx {
+
+std::vector<OpTypeProfile> GraphProfile::Histogram() const {
+  std::map<std::string, OpTypeProfile> per_type;
+  for (const auto& node : nodes) {
+    auto& entry = per_type[node.op_type];
+    entry.op_type = node.op_type;
+    entry.count++;
+    entry.total_ns += node.duration_ns;
+  }
+
+  std::vector<OpTypeProfile> histogram;
+  histogram.reserve(per_type.size());
+  for (const auto& entry : per_type) {
+    histogram.push_back(entry.second);
+  }
+  std::stable_sort(histogram.begin(), histogram.end(),
+                   [](const OpTypeProfile& a, const OpTypeProfile& b) {
+                     return a.total_ns > b.total_ns;
+                   });
+  return histogram;
+}
+
+std::string GraphProfile::ToChromeTrace() const {
+  std::string trace = "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& node : nodes) {
+    trace += first ? "\n" : ",\n";
+    first = false;
+    trace += "{\"name\":";
+    AppendJsonString(trace, node.op_type);
+    trace += ",\"cat\":";
+    AppendJsonString(trace, node.kernel_type);
+    trace += ",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":";
+    trace += Microseconds(node.start_ns);
+    trace += ",\"dur\":";
+    trace += Microseconds(node.duration_ns);
+    trace += ",\"args\":{\"uid\":" + std::to_string(node.uid) +
+             ",\"kernel\":";
+    AppendJsonString(trace, node.kernel_type);
+    trace += "}}";
+  }
+  trace += "\n],\"displayTimeUnit\":\"ns\",\"otherData\":{\"total_us\":";
+  trace += Microseconds(total_ns);
+  trace += "}}\n";
+  return trace;
+}
+
+}  // namespace vx
+}  // namespace tim
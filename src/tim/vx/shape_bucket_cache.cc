@@ -0,0 +1,399 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/shape_bucket_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "graph_private.h"
+#include "shape_bucket_cache_private.h"
+#include "tim/vx/context.h"
+#include "type_utils.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+
+namespace {
+uint64_t Volume(const ShapeType& shape) {
+  uint64_t volume = 1;
+  for (auto dim : shape) {
+    volume *= dim;
+  }
+  return volume;
+}
+
+bool Holds(const ShapeType& bucket, const ShapeType& shape) {
+  if (bucket.size() != shape.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < shape.size(); ++i) {
+    if (shape[i] > bucket[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t ElementBytes(const std::shared_ptr<Tensor>& tensor) {
+  return vsi_nn_TypeGetBytes(TranslateDataType(tensor->GetDataType()));
+}
+
+size_t TensorBytes(const std::shared_ptr<Tensor>& tensor) {
+  return Volume(tensor->GetShape()) * ElementBytes(tensor);
+}
+
+// Bytes of all tensors of the graph, the driver memory taken by the compiled
+// graph grows with it
+uint64_t GraphFootprint(const std::shared_ptr<Graph>& graph) {
+  vsi_nn_graph_t* g = std::static_pointer_cast<GraphImpl>(graph)->graph();
+  uint64_t bytes = 0;
+  for (uint32_t id = 0; id < g->cur_tid; ++id) {
+    vsi_nn_tensor_t* t = vsi_nn_GetTensor(g, id);
+    if (t) {
+      bytes += vsi_nn_GetTensorSize(t->attr.size, t->attr.dim_num,
+                                    t->attr.dtype.vx_type);
+    }
+  }
+  return bytes;
+}
+
+// Element offsets of `shape` in a buffer laid out as `layout`, dim 0 fastest
+std::vector<uint64_t> Strides(const ShapeType& layout) {
+  std::vector<uint64_t> strides(layout.size(), 1);
+  for (size_t i = 1; i < layout.size(); ++i) {
+    strides[i] = strides[i - 1] * layout[i - 1];
+  }
+  return strides;
+}
+}  // namespace
+
+std::shared_ptr<ShapeBucketCache> ShapeBucketCache::Create(
+    const std::shared_ptr<Context>& context, Builder builder,
+    std::vector<ShapeType> buckets, const ShapeBucketOptions& options) {
+  if (!context || !builder || buckets.empty()) {
+    VSILOGE("Invalid shape bucket cache arguments");
+    return nullptr;
+  }
+  for (const auto& bucket : buckets) {
+    if (bucket.empty() || bucket.size() != buckets[0].size() ||
+        Volume(bucket) == 0) {
+      VSILOGE("Shape buckets must be non-empty shapes of the same rank");
+      return nullptr;
+    }
+  }
+  return std::make_shared<ShapeBucketCacheImpl>(context, std::move(builder),
+                                                std::move(buckets), options);
+}
+
+ShapeBucketCacheImpl::ShapeBucketCacheImpl(
+    const std::shared_ptr<Context>& context, Builder builder,
+    std::vector<ShapeType> buckets, const ShapeBucketOptions& options)
+    : context_(context),
+      builder_(std::move(builder)),
+      buckets_(std::move(buckets)),
+      options_(options) {
+  if (options_.background_compile) {
+    worker_ = std::thread(&ShapeBucketCacheImpl::Worker, this);
+  }
+}
+
+ShapeBucketCacheImpl::~ShapeBucketCacheImpl() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    queue_cond_.notify_all();
+  }
+  // A compilation in progress is finished, queued ones are dropped
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+int32_t ShapeBucketCacheImpl::FindBucket(const ShapeType& input_shape) const {
+  int32_t best = -1;
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    if (Holds(buckets_[i], input_shape) &&
+        (best < 0 || Volume(buckets_[i]) < Volume(buckets_[best]))) {
+      best = static_cast<int32_t>(i);
+    }
+  }
+  return best;
+}
+
+bool ShapeBucketCacheImpl::Run(const ShapeType& input_shape, const void* input,
+                               Buffers* outputs, ShapeType* bucket_shape) {
+  int32_t index = FindBucket(input_shape);
+  if (index < 0 || Volume(input_shape) == 0 || !input || !outputs) {
+    VSILOGE("No shape bucket holds the input");
+    return false;
+  }
+  auto entry = Acquire(index, input_shape);
+  if (!entry) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(entry->run_mutex);
+  std::vector<uint8_t> data(entry->input_bytes);
+  FitInput(input_shape, input, entry->input, data.data());
+  if (!entry->input->CopyDataToTensor(data.data(), data.size())) {
+    VSILOGE("Copy input to bucket graph fail");
+    return false;
+  }
+  if (!entry->graph->Run()) {
+    return false;
+  }
+  const auto& output_tensors = entry->graph->OutputsTensor();
+  outputs->resize(output_tensors.size());
+  for (size_t i = 0; i < output_tensors.size(); ++i) {
+    (*outputs)[i].resize(entry->output_bytes[i]);
+    if (!output_tensors[i]->CopyDataFromTensor((*outputs)[i].data())) {
+      return false;
+    }
+  }
+  if (bucket_shape) {
+    *bucket_shape = entry->input->GetShape();
+  }
+  return true;
+}
+
+bool ShapeBucketCacheImpl::Prefetch(const ShapeType& input_shape) {
+  int32_t index = FindBucket(input_shape);
+  if (index < 0) {
+    VSILOGE("No shape bucket holds the input");
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (entries_.count(index)) {
+    return true;
+  }
+  if (options_.background_compile) {
+    if (compiling_.insert(index).second) {
+      queue_.push_back(index);
+      queue_cond_.notify_one();
+    }
+    return true;
+  }
+  return CompileNow(lock, index) != nullptr;
+}
+
+ShapeBucketMetrics ShapeBucketCacheImpl::GetMetrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return metrics_;
+}
+
+std::shared_ptr<ShapeBucketCacheImpl::Entry> ShapeBucketCacheImpl::FindCompiled(
+    const ShapeType& input_shape) {
+  int32_t best = -1;
+  for (const auto& entry : entries_) {
+    if (Holds(buckets_[entry.first], input_shape) &&
+        (best < 0 ||
+         Volume(buckets_[entry.first]) < Volume(buckets_[best]))) {
+      best = entry.first;
+    }
+  }
+  if (best < 0) {
+    return nullptr;
+  }
+  Touch(best);
+  return entries_[best];
+}
+
+std::shared_ptr<ShapeBucketCacheImpl::Entry> ShapeBucketCacheImpl::Acquire(
+    int32_t index, const ShapeType& input_shape) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = entries_.find(index);
+  if (it != entries_.end()) {
+    ++metrics_.hits;
+    Touch(index);
+    return it->second;
+  }
+  ++metrics_.misses;
+  if (options_.background_compile) {
+    if (compiling_.insert(index).second) {
+      queue_.push_back(index);
+      queue_cond_.notify_one();
+    }
+    auto fallback = FindCompiled(input_shape);
+    if (fallback) {
+      ++metrics_.fallbacks;
+      return fallback;
+    }
+  }
+  return CompileNow(lock, index);
+}
+
+std::shared_ptr<ShapeBucketCacheImpl::Entry> ShapeBucketCacheImpl::CompileNow(
+    std::unique_lock<std::mutex>& lock, int32_t index) {
+  if (!compiling_.insert(index).second) {
+    compiled_cond_.wait(
+        lock, [this, index]() { return compiling_.count(index) == 0; });
+    auto it = entries_.find(index);
+    return it == entries_.end() ? nullptr : it->second;
+  }
+  lock.unlock();
+  double compile_ms = 0;
+  auto entry = Compile(index, &compile_ms);
+  lock.lock();
+  compiling_.erase(index);
+  Insert(index, entry, compile_ms);
+  compiled_cond_.notify_all();
+  return entry;
+}
+
+std::shared_ptr<ShapeBucketCacheImpl::Entry> ShapeBucketCacheImpl::Compile(
+    int32_t index, double* compile_ms) {
+  auto start = std::chrono::steady_clock::now();
+  auto graph = builder_(context_, buckets_[index]);
+  if (!graph || graph->InputsTensor().size() != 1 ||
+      graph->InputsTensor()[0]->GetShape() != buckets_[index]) {
+    VSILOGE("Bucket %d graph must have one input of the bucket shape", index);
+    return nullptr;
+  }
+  if (!graph->Compile()) {
+    VSILOGE("Compile bucket %d graph fail", index);
+    return nullptr;
+  }
+  *compile_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+
+  auto entry = std::make_shared<Entry>();
+  entry->graph = graph;
+  entry->input = graph->InputsTensor()[0];
+  entry->input_bytes = TensorBytes(entry->input);
+  for (const auto& output : graph->OutputsTensor()) {
+    entry->output_bytes.push_back(TensorBytes(output));
+  }
+  entry->footprint = GraphFootprint(graph);
+  return entry;
+}
+
+void ShapeBucketCacheImpl::Insert(int32_t index, std::shared_ptr<Entry> entry,
+                                  double compile_ms) {
+  if (!entry) {
+    ++metrics_.compile_failures;
+    return;
+  }
+  ++metrics_.compiles;
+  metrics_.total_compile_ms += compile_ms;
+  metrics_.max_compile_ms = std::max(metrics_.max_compile_ms, compile_ms);
+
+  entries_[index] = entry;
+  lru_.push_front(index);
+  metrics_.memory_bytes += entry->footprint;
+  // Requests still running on an evicted graph keep it alive until they end
+  while (options_.memory_budget > 0 &&
+         metrics_.memory_bytes > options_.memory_budget && lru_.size() > 1) {
+    int32_t victim = lru_.back();
+    lru_.pop_back();
+    metrics_.memory_bytes -= entries_[victim]->footprint;
+    entries_.erase(victim);
+    ++metrics_.evictions;
+  }
+}
+
+void ShapeBucketCacheImpl::Touch(int32_t index) {
+  lru_.remove(index);
+  lru_.push_front(index);
+}
+
+void ShapeBucketCacheImpl::Worker() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queue_cond_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (stop_) {
+      break;
+    }
+    int32_t index = queue_.front();
+    queue_.pop_front();
+    lock.unlock();
+    double compile_ms = 0;
+    auto entry = Compile(index, &compile_ms);
+    lock.lock();
+    compiling_.erase(index);
+    Insert(index, entry, compile_ms);
+    compiled_cond_.notify_all();
+  }
+}
+
+void ShapeBucketCacheImpl::FitInput(const ShapeType& input_shape,
+                                    const void* input,
+                                    const std::shared_ptr<Tensor>& tensor,
+                                    uint8_t* dst) const {
+  const ShapeType& bucket = tensor->GetShape();
+  const size_t element_bytes = ElementBytes(tensor);
+  const uint8_t* src = static_cast<const uint8_t*>(input);
+  const auto src_strides = Strides(input_shape);
+  const auto dst_strides = Strides(bucket);
+  const size_t rank = bucket.size();
+
+  if (options_.fit_mode == BucketFitMode::RESIZE) {
+    // Nearest neighbor over every dimension, one element at a time
+    std::vector<uint32_t> pos(rank, 0);
+    for (uint64_t i = 0; i < Volume(bucket); ++i) {
+      uint64_t src_offset = 0;
+      for (size_t d = 0; d < rank; ++d) {
+        uint64_t s = static_cast<uint64_t>(pos[d]) * input_shape[d] / bucket[d];
+        src_offset += s * src_strides[d];
+      }
+      memcpy(dst + i * element_bytes, src + src_offset * element_bytes,
+             element_bytes);
+      for (size_t d = 0; d < rank && ++pos[d] == bucket[d]; ++d) {
+        pos[d] = 0;
+      }
+    }
+    return;
+  }
+
+  // Pad with the zero point, so quantized inputs are padded with real 0
+  const auto& quant = tensor->GetQuantization();
+  uint8_t pad = 0;
+  if (element_bytes == 1 && quant.Type() == QuantType::ASYMMETRIC &&
+      !quant.ZeroPoints().empty()) {
+    pad = static_cast<uint8_t>(quant.ZeroPoints()[0]);
+  }
+  memset(dst, pad, Volume(bucket) * element_bytes);
+
+  // Copy dim 0 rows of the input to the origin of the bucket
+  const size_t row_bytes = input_shape[0] * element_bytes;
+  std::vector<uint32_t> pos(rank, 0);
+  for (uint64_t row = 0; row < Volume(input_shape) / input_shape[0]; ++row) {
+    uint64_t src_offset = 0;
+    uint64_t dst_offset = 0;
+    for (size_t d = 1; d < rank; ++d) {
+      src_offset += pos[d] * src_strides[d];
+      dst_offset += pos[d] * dst_strides[d];
+    }
+    memcpy(dst + dst_offset * element_bytes, src + src_offset * element_bytes,
+           row_bytes);
+    for (size_t d = 1; d < rank && ++pos[d] == input_shape[d]; ++d) {
+      pos[d] = 0;
+    }
+  }
+}
+
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,106 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_SHAPE_BUCKET_CACHE_PRIVATE_H_
+#define TIM_VX_SHAPE_BUCKET_CACHE_PRIVATE_H_
+#include "tim/vx/shape_bucket_cache.h"
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "tim/vx/graph.h"
+#include "tim/vx/tensor.h"
+
+namespace tim {
+namespace vx {
+
+class ShapeBucketCacheImpl : public ShapeBucketCache {
+ public:
+  ShapeBucketCacheImpl(const std::shared_ptr<Context>& context,
+                       Builder builder, std::vector<ShapeType> buckets,
+                       const ShapeBucketOptions& options);
+  ~ShapeBucketCacheImpl();
+
+  int32_t FindBucket(const ShapeType& input_shape) const override;
+  bool Run(const ShapeType& input_shape, const void* input, Buffers* outputs,
+           ShapeType* bucket_shape) override;
+  bool Prefetch(const ShapeType& input_shape) override;
+  ShapeBucketMetrics GetMetrics() const override;
+
+ protected:
+  struct Entry {
+    std::shared_ptr<Graph> graph;
+    std::shared_ptr<Tensor> input;
+    size_t input_bytes;
+    std::vector<size_t> output_bytes;
+    uint64_t footprint;
+    /// Held from the input copy to the output copy of a request
+    std::mutex run_mutex;
+  };
+
+  /// Smallest compiled bucket holding `input_shape`, call with mutex_ held
+  std::shared_ptr<Entry> FindCompiled(const ShapeType& input_shape);
+  /// Compiled bucket `index` or a fallback, compile it if needed
+  std::shared_ptr<Entry> Acquire(int32_t index, const ShapeType& input_shape);
+  /// Compile bucket `index` on this thread, or wait for the thread already
+  /// compiling it. `lock` holds mutex_, it is released while compiling.
+  std::shared_ptr<Entry> CompileNow(std::unique_lock<std::mutex>& lock,
+                                    int32_t index);
+  /// Build and compile bucket `index` without holding mutex_
+  std::shared_ptr<Entry> Compile(int32_t index, double* compile_ms);
+  /// Publish a compilation and evict over budget, call with mutex_ held
+  void Insert(int32_t index, std::shared_ptr<Entry> entry, double compile_ms);
+  void Touch(int32_t index);
+  void Worker();
+  /// Copy `input` of `input_shape` into `dst` of the bucket shape
+  void FitInput(const ShapeType& input_shape, const void* input,
+                const std::shared_ptr<Tensor>& tensor, uint8_t* dst) const;
+
+  std::shared_ptr<Context> context_;
+  Builder builder_;
+  std::vector<ShapeType> buckets_;
+  ShapeBucketOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable compiled_cond_;
+  std::map<int32_t, std::shared_ptr<Entry>> entries_;
+  /// Bucket indices of entries_, most recently used first
+  std::list<int32_t> lru_;
+  /// Buckets being compiled, or queued for the worker
+  std::set<int32_t> compiling_;
+  std::deque<int32_t> queue_;
+  std::condition_variable queue_cond_;
+  std::thread worker_;
+  bool stop_{false};
+  ShapeBucketMetrics metrics_;
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_SHAPE_BUCKET_CACHE_PRIVATE_H_ */
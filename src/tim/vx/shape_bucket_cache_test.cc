@@ -0,0 +1,180 @@
+/****************************************************************************
+*
+*    Copyright (c) 2021 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/shape_bucket_cache.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+tim::vx::ShapeBucketCache::Builder ReluBuilder(std::atomic<int>* build_count) {
+    return [build_count](const std::shared_ptr<tim::vx::Context>& ctx,
+                         const tim::vx::ShapeType& shape) {
+        ++*build_count;
+        tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::INPUT);
+        tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape, tim::vx::TensorAttribute::OUTPUT);
+        auto graph = ctx->CreateGraph();
+        auto input = graph->CreateTensor(input_spec);
+        auto output = graph->CreateTensor(output_spec);
+        auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+        (*relu).BindInput(input).BindOutput(output);
+        return graph;
+    };
+}
+
+bool WaitForCompiles(const std::shared_ptr<tim::vx::ShapeBucketCache>& cache,
+                     uint64_t compiles) {
+    for (int i = 0; i < 1000; ++i) {
+        if (cache->GetMetrics().compiles >= compiles) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+}  // namespace
+
+TEST(shape_bucket_cache, find_smallest_bucket) {
+    auto ctx = tim::vx::Context::Create();
+    std::atomic<int> build_count(0);
+    auto cache = tim::vx::ShapeBucketCache::Create(
+        ctx, ReluBuilder(&build_count), {{8, 8, 1}, {16, 16, 1}, {16, 8, 1}});
+    ASSERT_NE(cache, nullptr);
+
+    EXPECT_EQ(cache->FindBucket({8, 8, 1}), 0);
+    EXPECT_EQ(cache->FindBucket({10, 6, 1}), 2);
+    EXPECT_EQ(cache->FindBucket({10, 12, 1}), 1);
+    EXPECT_EQ(cache->FindBucket({20, 8, 1}), -1);
+    EXPECT_EQ(cache->FindBucket({8, 8}), -1);
+    EXPECT_EQ(build_count.load(), 0) << "Buckets are compiled lazily";
+}
+
+TEST(shape_bucket_cache, pad_into_bucket) {
+    auto ctx = tim::vx::Context::Create();
+    std::atomic<int> build_count(0);
+    auto cache = tim::vx::ShapeBucketCache::Create(
+        ctx, ReluBuilder(&build_count), {{4, 3, 1}});
+    ASSERT_NE(cache, nullptr);
+
+    std::vector<float> input = {1, 2, 3, 4, 5, 6};
+    tim::vx::ShapeBucketCache::Buffers outputs;
+    tim::vx::ShapeType bucket_shape;
+    EXPECT_TRUE(cache->Run({3, 2, 1}, input.data(), &outputs, &bucket_shape));
+    EXPECT_TRUE(cache->Run({3, 2, 1}, input.data(), &outputs, &bucket_shape));
+    EXPECT_EQ(build_count.load(), 1);
+
+    auto metrics = cache->GetMetrics();
+    EXPECT_EQ(metrics.misses, 1u);
+    EXPECT_EQ(metrics.hits, 1u);
+    EXPECT_EQ(metrics.compiles, 1u);
+    EXPECT_DOUBLE_EQ(metrics.HitRate(), 0.5);
+    EXPECT_GT(metrics.memory_bytes, 0u);
+
+    ASSERT_EQ(outputs.size(), 1u);
+    ASSERT_EQ(outputs[0].size(), 12 * sizeof(float));
+    EXPECT_EQ(bucket_shape, tim::vx::ShapeType({4, 3, 1}));
+    std::vector<float> golden = {1, 2, 3, 0, 4, 5, 6, 0, 0, 0, 0, 0};
+    EXPECT_EQ(0, memcmp(outputs[0].data(), golden.data(), outputs[0].size()));
+}
+
+TEST(shape_bucket_cache, resize_into_bucket) {
+    auto ctx = tim::vx::Context::Create();
+    std::atomic<int> build_count(0);
+    tim::vx::ShapeBucketOptions options;
+    options.fit_mode = tim::vx::BucketFitMode::RESIZE;
+    auto cache = tim::vx::ShapeBucketCache::Create(
+        ctx, ReluBuilder(&build_count), {{4, 2}}, options);
+    ASSERT_NE(cache, nullptr);
+
+    std::vector<float> input = {1, 2, 3, 4};
+    tim::vx::ShapeBucketCache::Buffers outputs;
+    EXPECT_TRUE(cache->Run({2, 2}, input.data(), &outputs));
+    ASSERT_EQ(outputs.size(), 1u);
+    ASSERT_EQ(outputs[0].size(), 8 * sizeof(float));
+    std::vector<float> golden = {1, 1, 2, 2, 3, 3, 4, 4};
+    EXPECT_EQ(0, memcmp(outputs[0].data(), golden.data(), outputs[0].size()));
+}
+
+TEST(shape_bucket_cache, evict_least_recently_used) {
+    auto ctx = tim::vx::Context::Create();
+    std::atomic<int> build_count(0);
+    tim::vx::ShapeBucketOptions options;
+    // Room for a single graph
+    options.memory_budget = 1;
+    auto cache = tim::vx::ShapeBucketCache::Create(
+        ctx, ReluBuilder(&build_count), {{2, 2}, {4, 4}}, options);
+    ASSERT_NE(cache, nullptr);
+
+    std::vector<float> input(16, 1.0f);
+    tim::vx::ShapeBucketCache::Buffers outputs;
+    cache->Run({2, 2}, input.data(), &outputs);
+    cache->Run({4, 4}, input.data(), &outputs);
+    cache->Run({2, 2}, input.data(), &outputs);
+
+    auto metrics = cache->GetMetrics();
+    EXPECT_EQ(build_count.load(), 3);
+    EXPECT_EQ(metrics.compiles, 3u);
+    EXPECT_EQ(metrics.evictions, 2u);
+    EXPECT_EQ(metrics.hits, 0u);
+    EXPECT_EQ(metrics.memory_bytes, 2u * 2 * 2 * sizeof(float));
+}
+
+TEST(shape_bucket_cache, background_compile_with_fallback) {
+    auto ctx = tim::vx::Context::Create();
+    std::atomic<int> build_count(0);
+    tim::vx::ShapeBucketOptions options;
+    options.background_compile = true;
+    auto cache = tim::vx::ShapeBucketCache::Create(
+        ctx, ReluBuilder(&build_count), {{2, 2}, {4, 4}}, options);
+    ASSERT_NE(cache, nullptr);
+
+    EXPECT_TRUE(cache->Prefetch({4, 4}));
+    ASSERT_TRUE(WaitForCompiles(cache, 1));
+
+    // The 2x2 bucket is compiled behind the request, which runs on 4x4
+    std::vector<float> input(4, 1.0f);
+    tim::vx::ShapeBucketCache::Buffers outputs;
+    cache->Run({2, 2}, input.data(), &outputs);
+    EXPECT_EQ(cache->GetMetrics().fallbacks, 1u);
+    ASSERT_TRUE(WaitForCompiles(cache, 2));
+    EXPECT_EQ(build_count.load(), 2);
+
+    cache->Run({2, 2}, input.data(), &outputs);
+    EXPECT_EQ(cache->GetMetrics().hits, 1u);
+}
+
+TEST(shape_bucket_cache, invalid_arguments) {
+    auto ctx = tim::vx::Context::Create();
+    std::atomic<int> build_count(0);
+    EXPECT_EQ(tim::vx::ShapeBucketCache::Create(ctx, ReluBuilder(&build_count), {}), nullptr);
+    EXPECT_EQ(tim::vx::ShapeBucketCache::Create(ctx, nullptr, {{2, 2}}), nullptr);
+    EXPECT_EQ(tim::vx::ShapeBucketCache::Create(
+                  ctx, ReluBuilder(&build_count), {{2, 2}, {2, 2, 1}}), nullptr);
+}
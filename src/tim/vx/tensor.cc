@@ -26,6 +26,8 @@
 #include <VX/vx_khr_cnn.h>
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 #include "graph_private.h"
 #include "tensor_private.h"
@@ -33,47 +35,6 @@
 #include "type_utils.h"
 #include "vsi_nn_pub.h"
 
-namespace {
-
-void PackTensorDtype(tim::vx::TensorSpec& spec, vsi_nn_dtype_t* dtype) {
-  dtype->vx_type = TranslateDataType(spec.datatype_);
-  dtype->qnt_type = TranslateQuantType(spec.quantization_.Type());
-  switch (spec.quantization_.Type()) {
-    case tim::vx::QuantType::NONE:
-      break;
-    case tim::vx::QuantType::ASYMMETRIC:
-      dtype->scale = spec.quantization_.Scales()[0];
-      dtype->zero_point = spec.quantization_.ZeroPoints()[0];
-      //note:temporarily ignore the Uint8 weight case in conv.
-      // if (dtype->vx_type == VSI_NN_TYPE_UINT8 && dtype->zero_point == 0) {
-      //   dtype->vx_type = VSI_NN_TYPE_INT8;
-      // }
-      break;
-    case tim::vx::QuantType::SYMMETRIC_PER_CHANNEL: {
-      dtype->scales = spec.quantization_.Scales().data();
-      dtype->scale_dim = spec.quantization_.ZeroPoints().size();
-#if (VSI_NN_VERSION_MAJOR == 1 && VSI_NN_VERSION_MINOR == 1 && \
-     VSI_NN_VERSION_PATCH <= 18)
-      {
-        std::vector<float> zps(spec.quantization_.ZeroPoints().size());
-        std::transform(spec.quantization_.ZeroPoints().begin(),
-                       spec.quantization_.ZeroPoints().end(), zps.begin(),
-                       [](const int& it) { return static_cast<float>(it); });
-        dtype->zero_points = zps.data();
-      }
-#else
-      dtype->zero_points = spec.quantization_.ZeroPoints().data();
-#endif
-      dtype->zero_points_dim = spec.quantization_.ZeroPoints().size();
-      dtype->channel_dim = spec.quantization_.ChannelDim();
-      break;
-    }
-    default:
-      break;
-  }
-}
-
-}  // namespace
 namespace tim {
 namespace vx {
 
@@ -85,7 +46,11 @@ TensorImpl::TensorImpl(Graph* graph, const TensorSpec& spec, const void* data)
   Init();
 }
 
-TensorImpl::~TensorImpl() {}
+TensorImpl::~TensorImpl() {
+  if (internal_buffer_) {
+    vsi_nn_FreeAlignedBuffer(static_cast<uint8_t*>(internal_buffer_));
+  }
+}
 
 bool TensorImpl::CopyDataToTensor(const void* data, uint32_t size_in_bytes) {
   (void)size_in_bytes;
@@ -96,8 +61,33 @@ bool TensorImpl::CopyDataToTensor(const void* data, uint32_t size_in_bytes) {
   bool retn = true;
   if (data && VSI_NN_TENSOR_ID_NA != id_) {
     retn = false;
+    auto lock = graph_->WaitIdle();
     vsi_nn_tensor_t* tensor = vsi_nn_GetTensor(graph_->graph(), id_);
-    if (tensor) {
+    if (tensor && pooled_ && graph_->DetachPooledConstant(pool_key_)) {
+      // Nobody shares the device tensor, write it in place
+      pooled_ = false;
+    }
+    if (tensor && pooled_ && graph_->IoFrozen()) {
+      // The compiled nodes hold the shared device tensor, moving this
+      // constant to a tensor of its own would not reach them and writing
+      // the shared one would change the other users
+      VSILOGE("A pooled constant can not be written once its graph compiled,"
+              " disable the constant pool of the context to update it");
+    } else if (tensor && pooled_) {
+      // Other constants share the device tensor, write to a tensor of its own
+      vsi_nn_tensor_t* own = vsi_nn_CreateTensor(graph_->graph(), &tensor->attr);
+      if (own && own->t &&
+          VSI_SUCCESS == vsi_nn_CopyDataToTensor(graph_->graph(), own,
+                                                 const_cast<void*>(data))) {
+        vxReleaseTensor(&tensor->t);
+        tensor->t = own->t;
+        own->t = nullptr;
+        pooled_ = false;
+        graph_->ReleasePooledConstant(pool_key_);
+        retn = true;
+      }
+      vsi_nn_ReleaseTensor(&own);
+    } else if (tensor) {
       uint32_t tensor_bytes = vsi_nn_GetTensorSize(
       tensor->attr.size, tensor->attr.dim_num, tensor->attr.dtype.vx_type);
 
@@ -105,7 +95,9 @@ bool TensorImpl::CopyDataToTensor(const void* data, uint32_t size_in_bytes) {
         void *ptr = NULL;
         vsi_nn_GetTensorHandle(tensor, &ptr);
         if (ptr) {
-          memcpy(ptr, data, tensor_bytes);
+          if (ptr != data) {
+            memcpy(ptr, data, tensor_bytes);
+          }
           vsi_nn_FlushHandle(tensor);
           retn = true;
         } else {
@@ -114,14 +106,12 @@ bool TensorImpl::CopyDataToTensor(const void* data, uint32_t size_in_bytes) {
       }
       else {
         /*
-        argument `data` of vsi_nn_CopyDataToTensor is non-const
-        convert it from const data to non-const, will be fixed in ovxlib
+        argument `data` of vsi_nn_CopyDataToTensor is non-const, but it is
+        only read when writing to a tensor
         */
-        const uint8_t* end = static_cast<const uint8_t*>(data) + tensor_bytes;
-        std::vector<uint8_t> data_copy(static_cast<const uint8_t*>(data), end);
-
         retn = (VSI_SUCCESS ==
-             vsi_nn_CopyDataToTensor(graph_->graph(), tensor, data_copy.data()));
+             vsi_nn_CopyDataToTensor(graph_->graph(), tensor,
+                                     const_cast<void*>(data)));
       }
     }
   }
@@ -136,6 +126,7 @@ bool TensorImpl::CopyDataFromTensor(void* data) {
   bool retn = true;
   if (data && VSI_NN_TENSOR_ID_NA != id_) {
     retn = false;
+    auto lock = graph_->WaitIdle();
     vsi_nn_tensor_t* tensor = vsi_nn_GetTensor(graph_->graph(), id_);
 
     if (tensor) {
@@ -146,7 +137,9 @@ bool TensorImpl::CopyDataFromTensor(void* data) {
         void* ptr = NULL;
         vsi_nn_GetTensorHandle(tensor, &ptr);
         if (ptr) {
-          memcpy(data, ptr, tensor_bytes);
+          if (ptr != data) {
+            memcpy(data, ptr, tensor_bytes);
+          }
           retn = true;
         } else {
           VSILOGE("GetTensorHandle fail");
@@ -181,6 +174,9 @@ bool TensorImpl::Init() {
 
   PackTensorDtype(spec_, &attr.dtype);
 
+  if (attr.is_const && data_ && graph_->context()->ConstantPoolEnabled()) {
+    return InitPooledConstant(&attr);
+  }
   if ((spec_.attr_ & TensorAttribute::INPUT) ||
       (spec_.attr_ & TensorAttribute::OUTPUT)) {
     id_ = vsi_nn_AddTensorFromHandle(graph_->graph(), VSI_NN_TENSOR_ID_AUTO,
@@ -205,6 +201,121 @@ bool TensorImpl::Init() {
   return true;
 }
 
+bool TensorImpl::InitPooledConstant(vsi_nn_tensor_attr_t* attr) {
+  ContextImpl* context = graph_->context();
+  uint64_t bytes =
+      vsi_nn_GetTensorSize(attr->size, attr->dim_num, attr->dtype.vx_type);
+  pool_key_ = ContextImpl::HashConstant(spec_, data_, bytes);
+
+  id_ = vsi_nn_AddTensor(graph_->graph(), VSI_NN_TENSOR_ID_AUTO, attr,
+                         nullptr);
+  vsi_nn_tensor_t* tensor = VSI_NN_TENSOR_ID_NA == id_
+                                ? nullptr
+                                : vsi_nn_GetTensor(graph_->graph(), id_);
+  if (!tensor || !tensor->t) {
+    VSILOGE("Create tensor fail!");
+    return false;
+  }
+
+  // A hash hit only proposes a tensor, its bytes are read back and compared
+  vx_tensor own = tensor->t;
+  vx_tensor shared =
+      context->AcquireConstant(pool_key_, [&](vx_tensor candidate) {
+        tensor->t = candidate;
+        uint8_t* pooled_data =
+            vsi_nn_ConvertTensorToData(graph_->graph(), tensor);
+        tensor->t = own;
+        bool same = pooled_data && 0 == memcmp(pooled_data, data_, bytes);
+        free(pooled_data);
+        return same;
+      });
+  if (shared) {
+    // The tensor just created was never written, take the pooled one
+    vxReleaseTensor(&tensor->t);
+    tensor->t = shared;
+    graph_->AddPooledConstant(pool_key_);
+    pooled_ = true;
+    return true;
+  }
+
+  if (VSI_SUCCESS != vsi_nn_CopyDataToTensor(graph_->graph(), tensor,
+                                             const_cast<void*>(data_))) {
+    VSILOGE("Copy data to tensor fail!");
+    return false;
+  }
+  if (context->AddConstant(pool_key_, tensor->t)) {
+    graph_->AddPooledConstant(pool_key_);
+    pooled_ = true;
+  }
+  return true;
+}
+
+bool TensorImpl::BindUserBuffer(void* buffer, size_t size) {
+  return SwapHandle(buffer, size, nullptr);
+}
+
+bool TensorImpl::SwapHandle(void* buffer, size_t size, void** old_buffer) {
+  vsi_nn_tensor_t* tensor = VSI_NN_TENSOR_ID_NA == id_
+                                ? nullptr
+                                : vsi_nn_GetTensor(graph_->graph(), id_);
+  if (!tensor || !tensor->t || !tensor->attr.is_created_from_handle) {
+    VSILOGE("Only INPUT or OUTPUT tensor can be bound to user buffer");
+    return false;
+  }
+
+  void* handle = buffer;
+  if (buffer) {
+    const vsi_nn_handle_manager_t& manager = graph_->graph()->handle_manager;
+    vsi_size_t stride_size[VSI_NN_MAX_DIM_NUM];
+    vsi_size_t required = vsi_nn_GetStrideSize(&tensor->attr, stride_size);
+    required = (required + manager.align_block_size - 1) /
+               manager.align_block_size * manager.align_block_size;
+    if (!vsi_nn_IsBufferAligned(static_cast<uint8_t*>(buffer),
+                                manager.align_start_size)) {
+      VSILOGE("User buffer %p is not aligned to %u bytes", buffer,
+              manager.align_start_size);
+      return false;
+    }
+    if (size < required) {
+      VSILOGE("User buffer size %zu is less than %zu", size,
+              static_cast<size_t>(required));
+      return false;
+    }
+  } else if (!internal_buffer_) {
+    // Not bound, nothing to restore
+    if (old_buffer) {
+      *old_buffer = nullptr;
+    }
+    return true;
+  } else {
+    handle = internal_buffer_;
+  }
+
+  auto lock = graph_->WaitIdle();
+  void* prev_handle = nullptr;
+  if (VSI_SUCCESS != vsi_nn_SwapHandle(tensor, handle, &prev_handle)) {
+    VSILOGE("Swap tensor handle fail");
+    return false;
+  }
+  graph_->SwapIoHandle(id_, handle);
+
+  if (!internal_buffer_) {
+    // First binding, keep ovxlib's buffer so that it can be restored, and
+    // keep ovxlib from freeing the user buffer on release.
+    internal_buffer_ = prev_handle;
+    tensor->attr.is_handle_malloc_by_ovxlib = FALSE;
+  } else if (!buffer) {
+    internal_buffer_ = nullptr;
+    tensor->attr.is_handle_malloc_by_ovxlib = TRUE;
+  }
+
+  if (old_buffer) {
+    *old_buffer = user_buffer_;
+  }
+  user_buffer_ = buffer;
+  return true;
+}
+
 uint32_t TensorImpl::GetId() { return id_; }
 
 bool TensorImpl::IsWriteable() {
@@ -215,5 +326,26 @@ bool TensorImpl::IsReadable() {
   return spec_.attr_ != TensorAttribute::TRANSIENT;
 }
 
+constexpr size_t AlignedBuffer::kAddressAlignment;
+constexpr size_t AlignedBuffer::kSizeAlignment;
+
+AlignedBuffer::AlignedBuffer(size_t size)
+    : data_(nullptr),
+      size_((size + kSizeAlignment - 1) / kSizeAlignment * kSizeAlignment) {
+  if (size_ > 0) {
+    data_ = vsi_nn_MallocAlignedBuffer(size_, kAddressAlignment,
+                                       kSizeAlignment);
+  }
+  if (!data_) {
+    size_ = 0;
+  }
+}
+
+AlignedBuffer::~AlignedBuffer() {
+  if (data_) {
+    vsi_nn_FreeAlignedBuffer(static_cast<uint8_t*>(data_));
+  }
+}
+
 }  // namespace vx
 }  // namespace tim
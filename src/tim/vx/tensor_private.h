@@ -36,6 +36,9 @@ class TensorImpl : public Tensor {
   ~TensorImpl();
 
   bool Init();
+  /// Create the constant, sharing the device tensor of an identical one in
+  /// the context
+  bool InitPooledConstant(vsi_nn_tensor_attr_t* attr);
   bool IsWriteable();
   bool IsReadable();
 
@@ -51,11 +54,21 @@ class TensorImpl : public Tensor {
     return spec_.attr_ == tim::vx::TensorAttribute::CONSTANT;
   }
   const void* GetDataRef() const { return data_; }
+  bool BindUserBuffer(void* buffer, size_t size);
+  bool SwapHandle(void* buffer, size_t size, void** old_buffer);
 
   GraphImpl* graph_;
   vsi_nn_tensor_id_t id_;
   TensorSpec spec_;
   const void* data_;
+  /// Caller-owned memory the tensor is bound to
+  void* user_buffer_{nullptr};
+  /// Memory allocated by ovxlib for the tensor, owned here while a user
+  /// buffer is bound
+  void* internal_buffer_{nullptr};
+  /// The device tensor is shared through the constant pool of the context
+  bool pooled_{false};
+  ContextImpl::ConstantKey pool_key_;
 };
 
 class TensorPlaceholder : public Tensor {
@@ -81,6 +94,14 @@ class TensorPlaceholder : public Tensor {
     return spec_.attr_ == tim::vx::TensorAttribute::CONSTANT;
   }
   const void* GetDataRef() const { return nullptr; }
+  bool BindUserBuffer(void* buffer, size_t size) {
+    (void)buffer, void(size);
+    return false;
+  }
+  bool SwapHandle(void* buffer, size_t size, void** old_buffer) {
+    (void)buffer, void(size), void(old_buffer);
+    return false;
+  }
 
   vsi_nn_tensor_id_t id_;
   TensorSpec spec_;
@@ -0,0 +1,102 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/tensor.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+TEST(tensor, aligned_buffer) {
+    tim::vx::AlignedBuffer buf(100);
+    ASSERT_NE(buf.Data(), nullptr);
+    EXPECT_EQ(buf.Size(), tim::vx::AlignedBuffer::kSizeAlignment);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buf.Data()) %
+                  tim::vx::AlignedBuffer::kAddressAlignment, 0u);
+}
+
+TEST(tensor, bind_user_buffer) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({4, 2});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::CONSTANT);
+    std::vector<float> ones(8, 1.0f);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto const_t = graph->CreateTensor(const_spec, ones.data());
+    auto output_t = graph->CreateTensor(output_spec);
+
+    auto add = graph->CreateOperation<tim::vx::ops::Add>();
+    (*add).BindInputs({input_t, const_t}).BindOutputs({output_t});
+
+    tim::vx::AlignedBuffer in_buf(8 * sizeof(float));
+    tim::vx::AlignedBuffer out_buf(8 * sizeof(float));
+    EXPECT_FALSE(const_t->BindUserBuffer(in_buf.Data(), in_buf.Size()))
+        << "Constant tensor can not be bound to user buffer";
+    EXPECT_FALSE(input_t->BindUserBuffer(
+        static_cast<char*>(in_buf.Data()) + 4, in_buf.Size() - 64))
+        << "Misaligned user buffer";
+    EXPECT_FALSE(input_t->BindUserBuffer(in_buf.Data(), 8 * sizeof(float)))
+        << "User buffer size is not aligned";
+
+    EXPECT_TRUE(input_t->BindUserBuffer(in_buf.Data(), in_buf.Size()));
+    EXPECT_TRUE(output_t->BindUserBuffer(out_buf.Data(), out_buf.Size()));
+    EXPECT_TRUE(graph->Compile());
+
+    float* in = static_cast<float*>(in_buf.Data());
+    float* out = static_cast<float*>(out_buf.Data());
+    for (int i = 0; i < 8; ++i) {
+        in[i] = static_cast<float>(i);
+    }
+    EXPECT_TRUE(graph->Run());
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(out[i], i + 1.0f);
+    }
+
+    // Swap to a second input buffer
+    tim::vx::AlignedBuffer in_buf2(8 * sizeof(float));
+    void* old_buffer = nullptr;
+    EXPECT_TRUE(input_t->SwapHandle(in_buf2.Data(), in_buf2.Size(), &old_buffer));
+    EXPECT_EQ(old_buffer, in_buf.Data());
+    std::vector<float> in2(8, 3.0f);
+    EXPECT_TRUE(input_t->CopyDataToTensor(in2.data(), in2.size() * sizeof(float)));
+    EXPECT_EQ(0, memcmp(in_buf2.Data(), in2.data(), in2.size() * sizeof(float)));
+    EXPECT_TRUE(graph->Run());
+    EXPECT_EQ(out[0], 4.0f);
+
+    // Restore tensor's own memory
+    EXPECT_TRUE(input_t->BindUserBuffer(nullptr, 0));
+    EXPECT_TRUE(output_t->BindUserBuffer(nullptr, 0));
+    EXPECT_TRUE(input_t->CopyDataToTensor(ones.data(), ones.size() * sizeof(float)));
+    EXPECT_TRUE(graph->Run());
+    std::vector<float> output(8);
+    EXPECT_TRUE(output_t->CopyDataFromTensor(output.data()));
+    EXPECT_EQ(output, std::vector<float>(8, 2.0f));
+    EXPECT_EQ(out[0], 4.0f) << "Unbound user buffer is not written";
+}
@@ -23,6 +23,9 @@
 *****************************************************************************/
 #include "type_utils.h"
 
+#include <algorithm>
+#include <vector>
+
 namespace tim {
 namespace vx {
 vsi_nn_type_e TranslateDataType(DataType dtype) {
@@ -59,6 +62,8 @@ vsi_nn_qnt_type_e TranslateQuantType(QuantType qtype) {
       return VSI_NN_QNT_TYPE_AFFINE_ASYMMETRIC;
     case QuantType::SYMMETRIC_PER_CHANNEL:
       return VSI_NN_QNT_TYPE_AFFINE_PERCHANNEL_SYMMETRIC;
+    case QuantType::DYNAMIC_FIXED_POINT:
+      return VSI_NN_QNT_TYPE_DFP;
     default:
       break;
   }
@@ -158,7 +163,68 @@ vsi_enum TranslateResizeType(ResizeType type) {
   return VSI_NN_INTERPOLATION_NEAREST_NEIGHBOR;
 }
 
+vsi_enum TranslateImageFormat(ImageFormat format) {
+  switch (format) {
+    case ImageFormat::GRAY:
+      return VSI_NN_SOURCE_FORMAT_IMAGE_GRAY;
+    case ImageFormat::RGB:
+      return VSI_NN_SOURCE_FORMAT_IMAGE_RGB;
+    case ImageFormat::RGB888_PLANAR:
+      return VSI_NN_SOURCE_FORMAT_IMAGE_RGB888_PLANAR;
+    case ImageFormat::BGRA:
+      return VSI_NN_SOURCE_FORMAT_IMAGE_BGRA;
+    case ImageFormat::YUV420:
+      return VSI_NN_SOURCE_FORMAT_IMAGE_YUV420;
+    case ImageFormat::YUV444:
+      return VSI_NN_SOURCE_FORMAT_IMAGE_YUV444;
+    case ImageFormat::NV12:
+      return VSI_NN_SOURCE_FORMAT_IMAGE_NV12;
+  }
+  return VSI_NN_SOURCE_FORMAT_IMAGE_RGB;
+}
+
 vx_bool_e ToVxBool(bool val) { return val ? vx_true_e : vx_false_e; }
 
+void PackTensorDtype(TensorSpec& spec, vsi_nn_dtype_t* dtype) {
+  dtype->vx_type = TranslateDataType(spec.datatype_);
+  dtype->qnt_type = TranslateQuantType(spec.quantization_.Type());
+  switch (spec.quantization_.Type()) {
+    case QuantType::NONE:
+      break;
+    case QuantType::ASYMMETRIC:
+      dtype->scale = spec.quantization_.Scales()[0];
+      dtype->zero_point = spec.quantization_.ZeroPoints()[0];
+      //note:temporarily ignore the Uint8 weight case in conv.
+      // if (dtype->vx_type == VSI_NN_TYPE_UINT8 && dtype->zero_point == 0) {
+      //   dtype->vx_type = VSI_NN_TYPE_INT8;
+      // }
+      break;
+    case QuantType::SYMMETRIC_PER_CHANNEL: {
+      dtype->scales = spec.quantization_.Scales().data();
+      dtype->scale_dim = spec.quantization_.ZeroPoints().size();
+#if (VSI_NN_VERSION_MAJOR == 1 && VSI_NN_VERSION_MINOR == 1 && \
+     VSI_NN_VERSION_PATCH <= 18)
+      {
+        std::vector<float> zps(spec.quantization_.ZeroPoints().size());
+        std::transform(spec.quantization_.ZeroPoints().begin(),
+                       spec.quantization_.ZeroPoints().end(), zps.begin(),
+                       [](const int& it) { return static_cast<float>(it); });
+        dtype->zero_points = zps.data();
+      }
+#else
+      dtype->zero_points = spec.quantization_.ZeroPoints().data();
+#endif
+      dtype->zero_points_dim = spec.quantization_.ZeroPoints().size();
+      dtype->channel_dim = spec.quantization_.ChannelDim();
+      break;
+    }
+    case QuantType::DYNAMIC_FIXED_POINT:
+      dtype->fl = spec.quantization_.Fl();
+      break;
+    default:
+      break;
+  }
+}
+
 }  // namespace vx
 }  // namespace tim
@@ -24,6 +24,7 @@
 #ifndef TIM_VX_TYPE_UTILS_H_
 #define TIM_VX_TYPE_UTILS_H_
 
+#include "tim/vx/tensor.h"
 #include "tim/vx/types.h"
 #include "vsi_nn_pub.h"
 
@@ -38,7 +39,10 @@ vsi_enum TranslateOverflowPolicy(OverflowPolicy type);
 vsi_enum TranslateRoundingPolicy(RoundingPolicy type);
 vsi_enum TranslateDownScaleSizeRounding(RoundType type);
 vsi_enum TranslateResizeType(ResizeType type);
+vsi_enum TranslateImageFormat(ImageFormat format);
 vx_bool_e ToVxBool(bool val);
+/// Fill dtype from spec, quantization arrays point into spec
+void PackTensorDtype(TensorSpec& spec, vsi_nn_dtype_t* dtype);
 }  // namespace vx
 }  // namespace tim
 